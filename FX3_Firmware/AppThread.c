@@ -251,8 +251,13 @@ static void AdiAppInit ()
     	AdiAppErrorHandler(status);
     }
 
+#ifdef SUPERSPEED_MODE
+    /* Connect the USB Pins with super speed operation enabled. The USB driver falls back to high speed if the USB 3.0 link fails */
+    status = CyU3PConnectState (CyTrue, CyTrue);
+#else
     /* Connect the USB Pins with high speed operation enabled (USB 2.0 for better compatibility) */
     status = CyU3PConnectState (CyTrue, CyFalse);
+#endif
     if (status != CY_U3P_SUCCESS)
     {
     	AdiLogError(AppThread_c, __LINE__, status);
@@ -289,7 +294,13 @@ void AdiAppThreadEntry (uint32_t input)
     		ADI_TRANSFER_STREAM_STOP |
     		ADI_I2C_STREAM_DONE |
     		ADI_I2C_STREAM_START |
-    		ADI_I2C_STREAM_STOP;
+    		ADI_I2C_STREAM_STOP |
+    		ADI_BULK_COMMAND |
+    		ADI_SPI_PIPE_START |
+    		ADI_SPI_PIPE_DONE |
+    		ADI_LOGIC_STREAM_DONE |
+    		ADI_LOGIC_STREAM_START |
+    		ADI_LOGIC_STREAM_STOP;
 
     /* Event flags */
     uint32_t eventFlag;
@@ -305,26 +316,52 @@ void AdiAppThreadEntry (uint32_t input)
     	/* Wait for event handler flags to occur and handle them */
     	if (CyU3PEventGet(&EventHandler, eventMask, CYU3P_EVENT_OR_CLEAR, &eventFlag, CYU3P_WAIT_FOREVER) == CY_U3P_SUCCESS)
     	{
+    		/* Bulk command channel requests respond on ChannelToPC, so they run on the command worker thread */
+    		if (eventFlag & ADI_BULK_COMMAND)
+    		{
+    			if (AdiCommandPost(ADI_COMMAND_BULK, 0, 0) != CY_U3P_SUCCESS)
+    			{
+    				/* Drop the request, but keep the channel open for the next one */
+    				AdiBulkCommandArm();
+    			}
+    		}
+
+    		/* Handle SPI pipe commands */
+    		if (eventFlag & ADI_SPI_PIPE_START)
+    		{
+    			AdiSpiPipeStart();
+#ifdef VERBOSE_MODE
+    			ADI_LOG("SPI pipe start finished.\r\n");
+#endif
+    		}
+    		if (eventFlag & ADI_SPI_PIPE_DONE)
+    		{
+    			AdiSpiPipeFinished();
+#ifdef VERBOSE_MODE
+    			ADI_LOG("SPI pipe cleanup finished.\r\n");
+#endif
+    		}
+
     		/*Handle transfer stream commands */
 			if (eventFlag & ADI_TRANSFER_STREAM_START)
 			{
 				AdiTransferStreamStart();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Transfer stream start finished.\r\n");
+				ADI_LOG("Transfer stream start finished.\r\n");
 #endif
 			}
 			if (eventFlag & ADI_TRANSFER_STREAM_STOP)
 			{
 				AdiStopAnyDataStream();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Transfer stream stop finished.\r\n");
+				ADI_LOG("Transfer stream stop finished.\r\n");
 #endif
 			}
 			if (eventFlag & ADI_TRANSFER_STREAM_DONE)
 			{
 				AdiTransferStreamFinished();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Transfer stream cleanup finished.\r\n");
+				ADI_LOG("Transfer stream cleanup finished.\r\n");
 #endif
 			}
 
@@ -333,21 +370,21 @@ void AdiAppThreadEntry (uint32_t input)
 			{
 				AdiRealTimeStreamStart();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Real time stream start finished.\r\n");
+				ADI_LOG("Real time stream start finished.\r\n");
 #endif
 			}
 			if (eventFlag & ADI_RT_STREAM_STOP)
 			{
 				AdiStopAnyDataStream();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Real time stream stop finished.\r\n");
+				ADI_LOG("Real time stream stop finished.\r\n");
 #endif
 			}
 			if (eventFlag & ADI_RT_STREAM_DONE)
 			{
 				AdiRealTimeStreamFinished();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Real time stream cleanup finished.\r\n");
+				ADI_LOG("Real time stream cleanup finished.\r\n");
 #endif
 			}
 
@@ -356,21 +393,21 @@ void AdiAppThreadEntry (uint32_t input)
 			{
 				AdiGenericStreamStart();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Generic stream start command received.\r\n");
+				ADI_LOG("Generic stream start command received.\r\n");
 #endif
 			}
 			if (eventFlag & ADI_GENERIC_STREAM_STOP)
 			{
 				AdiStopAnyDataStream();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Generic stream stop finished.\r\n");
+				ADI_LOG("Generic stream stop finished.\r\n");
 #endif
 			}
 			if (eventFlag & ADI_GENERIC_STREAM_DONE)
 			{
 				AdiGenericStreamFinished();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Generic stream cleanup finished.\r\n");
+				ADI_LOG("Generic stream cleanup finished.\r\n");
 #endif
 			}
 
@@ -379,21 +416,21 @@ void AdiAppThreadEntry (uint32_t input)
 			{
 				AdiBurstStreamStart();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Burst stream start finished.\r\n");
+				ADI_LOG("Burst stream start finished.\r\n");
 #endif
 			}
 			if (eventFlag & ADI_BURST_STREAM_STOP)
 			{
 				AdiStopAnyDataStream();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Burst stream stop finished.\r\n");
+				ADI_LOG("Burst stream stop finished.\r\n");
 #endif
 			}
 			if (eventFlag & ADI_BURST_STREAM_DONE)
 			{
 				AdiBurstStreamFinished();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Burst stream cleanup finished.\r\n");
+				ADI_LOG("Burst stream cleanup finished.\r\n");
 #endif
 			}
 
@@ -402,21 +439,44 @@ void AdiAppThreadEntry (uint32_t input)
 			{
 				AdiI2CStreamStart();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "I2C stream start command finished.\r\n");
+				ADI_LOG("I2C stream start command finished.\r\n");
 #endif
 			}
 			if (eventFlag & ADI_I2C_STREAM_STOP)
 			{
 				AdiStopAnyDataStream();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "I2C stream stop command finished.\r\n");
+				ADI_LOG("I2C stream stop command finished.\r\n");
 #endif
 			}
 			if (eventFlag & ADI_I2C_STREAM_DONE)
 			{
 				AdiI2CStreamFinished();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "I2C stream cleanup finished.\r\n");
+				ADI_LOG("I2C stream cleanup finished.\r\n");
+#endif
+			}
+
+			/* Handle logic analyzer stream commands */
+			if (eventFlag & ADI_LOGIC_STREAM_START)
+			{
+				AdiLogicStreamStart();
+#ifdef VERBOSE_MODE
+				ADI_LOG("Logic analyzer stream start finished.\r\n");
+#endif
+			}
+			if (eventFlag & ADI_LOGIC_STREAM_STOP)
+			{
+				AdiStopAnyDataStream();
+#ifdef VERBOSE_MODE
+				ADI_LOG("Logic analyzer stream stop finished.\r\n");
+#endif
+			}
+			if (eventFlag & ADI_LOGIC_STREAM_DONE)
+			{
+				AdiLogicStreamFinished();
+#ifdef VERBOSE_MODE
+				ADI_LOG("Logic analyzer stream cleanup finished.\r\n");
 #endif
 			}
 
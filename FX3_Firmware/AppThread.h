@@ -98,4 +98,28 @@ void AdiAppThreadEntry(uint32_t input);
 /** I2C read stream enable */
 #define ADI_I2C_STREAM_ENABLE					(1 << 20)
 
+/** Data ready edge received by the GPIO ISR, for interrupt driven stream data ready waits */
+#define ADI_DATA_READY_INTERRUPT				(1 << 21)
+
+/** Bulk command request received on ChannelFromPC */
+#define ADI_BULK_COMMAND						(1 << 22)
+
+/** Event handler bit for SPI pipe start */
+#define ADI_SPI_PIPE_START						(1 << 23)
+
+/** Event handler bit for cleaning up (or cancelling) the SPI pipe */
+#define ADI_SPI_PIPE_DONE						(1 << 24)
+
+/** Logic analyzer stream start */
+#define ADI_LOGIC_STREAM_START					(1 << 25)
+
+/** Logic analyzer stream stop */
+#define ADI_LOGIC_STREAM_STOP					(1 << 26)
+
+/** Logic analyzer stream done */
+#define ADI_LOGIC_STREAM_DONE					(1 << 27)
+
+/** Logic analyzer stream enable */
+#define ADI_LOGIC_STREAM_ENABLE					(1 << 28)
+
 #endif
@@ -0,0 +1,258 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		BulkCommands.c
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		Batched register and pin commands over the general purpose bulk endpoints.
+ **/
+
+#include "BulkCommands.h"
+
+/* Private function prototypes */
+static CyU3PReturnStatus_t AdiBulkCommandRun(uint8_t opcode, uint16_t arg0, uint16_t arg1, uint8_t *responseData);
+
+/* Tell the compiler where to find the needed globals */
+extern BoardState FX3State;
+extern CyU3PEvent EventHandler;
+extern CyU3PDmaChannel ChannelFromPC;
+extern CyU3PDmaChannel ChannelToPC;
+
+/** Request transfer buffer, received on ChannelFromPC */
+static uint8_t BulkCommandRequest[ADI_BULK_CMD_BUFFER_SIZE] __attribute__((aligned(32)));
+
+/** Response transfer buffer, sent on ChannelToPC */
+static uint8_t BulkCommandResponse[ADI_BULK_CMD_BUFFER_SIZE] __attribute__((aligned(32)));
+
+/** Number of bytes in the last request transfer, set by the DMA callback */
+static volatile uint16_t BulkCommandRequestBytes;
+
+/**
+  * @brief Creates ChannelFromPC (PC to FX3 bulk endpoint) and waits for the first bulk command request.
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * Called when the application starts, and when the SPI pipe releases the PC to FX3 endpoint socket.
+ **/
+CyU3PReturnStatus_t AdiBulkCommandChannelCreate()
+{
+	CyU3PReturnStatus_t status;
+	CyU3PDmaChannelConfig_t dmaConfig;
+
+	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
+	dmaConfig.size 				= FX3State.UsbBufferSize;
+	dmaConfig.count 			= 0;
+	dmaConfig.prodSckId 		= CY_U3P_UIB_SOCKET_PROD_1;
+	dmaConfig.consSckId 		= CY_U3P_CPU_SOCKET_CONS;
+	dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
+	dmaConfig.notification 		= CY_U3P_DMA_CB_RECV_CPLT;
+	dmaConfig.cb 				= AdiBulkCommandDmaCallback;
+
+	status = CyU3PDmaChannelCreate(&ChannelFromPC, CY_U3P_DMA_TYPE_MANUAL_IN, &dmaConfig);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(BulkCommands_c, __LINE__, status);
+		return status;
+	}
+
+	/* Wait for the first bulk command request */
+	return AdiBulkCommandArm();
+}
+
+/**
+  * @brief Destroys ChannelFromPC, freeing the PC to FX3 endpoint socket.
+  *
+  * @return void
+  *
+  * Any bulk command request in progress is dropped.
+ **/
+void AdiBulkCommandChannelDestroy()
+{
+	CyU3PDmaChannelDestroy(&ChannelFromPC);
+}
+
+/**
+  * @brief Sets up ChannelFromPC to receive the next bulk command request.
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * Called once ChannelFromPC is created, and again after each request has been handled.
+ **/
+CyU3PReturnStatus_t AdiBulkCommandArm()
+{
+	CyU3PReturnStatus_t status;
+	CyU3PDmaBuffer_t requestBuffer;
+
+	requestBuffer.buffer = BulkCommandRequest;
+	requestBuffer.size = ADI_BULK_CMD_BUFFER_SIZE;
+	requestBuffer.count = 0;
+	requestBuffer.status = 0;
+	status = CyU3PDmaChannelSetupRecvBuffer(&ChannelFromPC, &requestBuffer);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(BulkCommands_c, __LINE__, status);
+	}
+	return status;
+}
+
+/**
+  * @brief ChannelFromPC DMA callback. Notifies the application thread that a bulk command request arrived.
+  *
+  * @param handle The DMA channel which generated the callback
+  *
+  * @param type The callback type
+  *
+  * @param input The DMA buffer which was received
+  *
+  * @return void
+  *
+  * Like the GPIO ISR, no work is done here. The commands are run by AdiBulkCommandHandler, which the application
+  * thread queues for the command worker thread.
+ **/
+void AdiBulkCommandDmaCallback(CyU3PDmaChannel *handle, CyU3PDmaCbType_t type, CyU3PDmaCBInput_t *input)
+{
+	if(type == CY_U3P_DMA_CB_RECV_CPLT)
+	{
+		BulkCommandRequestBytes = input->buffer_p.count;
+		CyU3PEventSet(&EventHandler, ADI_BULK_COMMAND, CYU3P_EVENT_OR);
+	}
+}
+
+/**
+  * @brief Runs all the commands in a bulk command request and sends the batched response to the PC.
+  *
+  * @return void
+  *
+  * The request is a list of 8 byte records: tag[0-1], opcode[2], reserved[3], arg0[4-5], arg1[6-7] (little endian).
+  * The records are run in order, until the end of the transfer or an ADI_BULK_CMD_END record. The response, sent
+  * on ChannelToPC, is status[0-3] (the first failing record status, or success), record count[4-7], then one 8 byte
+  * record per command: tag[0-1], opcode[2], status[3] (low byte of the CyU3P status code), data[4-7]. The tag is
+  * not interpreted, so the PC can use it to match responses to requests. The PC must read the response before
+  * sending the next request. Consecutive SPI records (register read, register write, transfer) are separated by
+  * the user stall time.
+ **/
+void AdiBulkCommandHandler()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	CyU3PReturnStatus_t recordStatus;
+	CyU3PDmaBuffer_t responseBuffer;
+	uint32_t numRecords, recordCount;
+	uint8_t *request;
+	uint8_t *response;
+	CyBool_t lastWasSpi = CyFalse, isSpi;
+
+	numRecords = BulkCommandRequestBytes / ADI_BULK_CMD_RECORD_SIZE;
+	if(numRecords > ADI_BULK_CMD_MAX_RECORDS)
+	{
+		numRecords = ADI_BULK_CMD_MAX_RECORDS;
+	}
+
+	request = BulkCommandRequest;
+	response = BulkCommandResponse + ADI_BULK_CMD_HEADER_SIZE;
+	for(recordCount = 0; recordCount < numRecords; recordCount++)
+	{
+		if(request[2] == ADI_BULK_CMD_END)
+		{
+			break;
+		}
+
+		/* Back to back DUT accesses need the stall time between them, which EP0 requests get from the USB round trip */
+		isSpi = (CyBool_t) ((request[2] == ADI_BULK_CMD_READ_REG) || (request[2] == ADI_BULK_CMD_WRITE_REG) || (request[2] == ADI_BULK_CMD_TRANSFER));
+		if(isSpi && lastWasSpi)
+		{
+			AdiSleepForMicroSeconds(FX3State.StallTime);
+		}
+		lastWasSpi = isSpi;
+
+		/* Copy the tag and opcode, then run the command */
+		response[0] = request[0];
+		response[1] = request[1];
+		response[2] = request[2];
+		response[4] = 0;
+		response[5] = 0;
+		response[6] = 0;
+		response[7] = 0;
+		recordStatus = AdiBulkCommandRun(request[2], request[4] | (request[5] << 8), request[6] | (request[7] << 8), response + 4);
+		response[3] = recordStatus & 0xFF;
+		if((recordStatus != CY_U3P_SUCCESS) && (status == CY_U3P_SUCCESS))
+		{
+			status = recordStatus;
+		}
+
+		request += ADI_BULK_CMD_RECORD_SIZE;
+		response += ADI_BULK_CMD_RECORD_SIZE;
+	}
+
+	/* Response header */
+	BulkCommandResponse[0] = status & 0xFF;
+	BulkCommandResponse[1] = (status & 0xFF00) >> 8;
+	BulkCommandResponse[2] = (status & 0xFF0000) >> 16;
+	BulkCommandResponse[3] = (status & 0xFF000000) >> 24;
+	BulkCommandResponse[4] = recordCount & 0xFF;
+	BulkCommandResponse[5] = (recordCount & 0xFF00) >> 8;
+	BulkCommandResponse[6] = (recordCount & 0xFF0000) >> 16;
+	BulkCommandResponse[7] = (recordCount & 0xFF000000) >> 24;
+
+#ifdef VERBOSE_MODE
+	ADI_LOG("Bulk command request: %d records, status 0x%x\r\n", recordCount, status);
+#endif
+
+	/* Send the response */
+	responseBuffer.buffer = BulkCommandResponse;
+	responseBuffer.size = ADI_BULK_CMD_BUFFER_SIZE;
+	responseBuffer.count = ADI_BULK_CMD_HEADER_SIZE + (recordCount * ADI_BULK_CMD_RECORD_SIZE);
+	responseBuffer.status = 0;
+	status = CyU3PDmaChannelSetupSendBuffer(&ChannelToPC, &responseBuffer);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(BulkCommands_c, __LINE__, status);
+	}
+
+	/* Wait for the next request */
+	AdiBulkCommandArm();
+}
+
+/**
+  * @brief Runs a single bulk command.
+  *
+  * @param opcode The command to run (ADI_BULK_CMD_*)
+  *
+  * @param arg0 The first command argument
+  *
+  * @param arg1 The second command argument
+  *
+  * @param responseData The response record data field (4 bytes, cleared)
+  *
+  * @return A status code indicating the success of the command.
+ **/
+static CyU3PReturnStatus_t AdiBulkCommandRun(uint8_t opcode, uint16_t arg0, uint16_t arg1, uint8_t *responseData)
+{
+	switch(opcode)
+	{
+		case ADI_BULK_CMD_READ_REG:
+			return AdiSpiReadReg(arg0, responseData);
+
+		case ADI_BULK_CMD_WRITE_REG:
+			return AdiSpiWriteReg(arg0, arg1 & 0xFF);
+
+		case ADI_BULK_CMD_TRANSFER:
+			return AdiSpiTransfer(arg0 | ((uint32_t) arg1 << 16), responseData);
+
+		case ADI_BULK_CMD_SET_PIN:
+			return AdiSetPin(arg0, (CyBool_t) arg1);
+
+		case ADI_BULK_CMD_DELAY:
+			return AdiSleepForMicroSeconds(arg0 | ((uint32_t) arg1 << 16));
+
+		default:
+			return CY_U3P_ERROR_BAD_ARGUMENT;
+	}
+}
@@ -0,0 +1,65 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		BulkCommands.h
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		Header file for the bulk endpoint command channel.
+ **/
+
+#ifndef BULK_COMMANDS_H
+#define BULK_COMMANDS_H
+
+/* Include the main header file */
+#include "main.h"
+
+/* Bulk command channel functions */
+CyU3PReturnStatus_t AdiBulkCommandChannelCreate();
+void AdiBulkCommandChannelDestroy();
+CyU3PReturnStatus_t AdiBulkCommandArm();
+void AdiBulkCommandDmaCallback(CyU3PDmaChannel *handle, CyU3PDmaCbType_t type, CyU3PDmaCBInput_t *input);
+void AdiBulkCommandHandler();
+
+/** Size of the bulk command request and response buffers, in bytes. A request transfer must not be larger */
+#define ADI_BULK_CMD_BUFFER_SIZE				(4096)
+
+/** Size of each bulk command request and response record, in bytes */
+#define ADI_BULK_CMD_RECORD_SIZE				(8)
+
+/** Size of the response header (status, record count) ahead of the first response record, in bytes */
+#define ADI_BULK_CMD_HEADER_SIZE				(8)
+
+/** Max number of records handled from one request transfer */
+#define ADI_BULK_CMD_MAX_RECORDS				((ADI_BULK_CMD_BUFFER_SIZE - ADI_BULK_CMD_HEADER_SIZE) / ADI_BULK_CMD_RECORD_SIZE)
+
+/*
+ * Bulk command opcodes (request record byte 2)
+ */
+
+/** End of the request. Any records after this one are ignored */
+#define ADI_BULK_CMD_END						(0x00)
+
+/** Read a 16 bit register word (arg0 = address). Response data = word, as ADI_READ_BYTES */
+#define ADI_BULK_CMD_READ_REG					(0x01)
+
+/** Write a register byte (arg0 = address, arg1 = data byte) */
+#define ADI_BULK_CMD_WRITE_REG					(0x02)
+
+/** Protocol agnostic SPI transfer (MOSI = arg0 | arg1 << 16). Response data = MISO, as ADI_TRANSFER_BYTES */
+#define ADI_BULK_CMD_TRANSFER					(0x03)
+
+/** Drive a GPIO pin (arg0 = pin, arg1 = level) */
+#define ADI_BULK_CMD_SET_PIN					(0x04)
+
+/** Stall before the next record (arg0 | arg1 << 16 = microseconds) */
+#define ADI_BULK_CMD_DELAY						(0x05)
+
+#endif
@@ -0,0 +1,295 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		CommandThread.c
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		Vendor command worker thread. Runs the long vendor commands, and every command which responds on the bulk endpoint.
+ **/
+
+#include "CommandThread.h"
+
+/* Private function prototypes */
+static CyU3PReturnStatus_t AdiCommandRun(CommandRequest *command);
+static CyU3PReturnStatus_t AdiCommandSend(CommandRequest *command);
+
+/* Tell the compiler where to find the needed globals */
+extern CyU3PQueue CommandQueue;
+extern CommandState CommandThreadState;
+extern uint8_t USBBuffer[4096];
+
+/**
+  * @brief The entry point function for the CommandThread. Runs the queued vendor commands in order.
+  *
+  * @param input Unused input required by the RTOS thread manager
+  *
+  * Each command is run to completion (or until cancelled) before the next is taken from CommandQueue.
+  * The commands send their results on the bulk endpoint, the same as when they were run from the
+  * control endpoint handler. Every ChannelToPC response is sent from this thread, so two responses
+  * never share BulkBuffer or the channel.
+ **/
+void AdiCommandThreadEntry(uint32_t input)
+{
+	CommandRequest command;
+	CyU3PReturnStatus_t status;
+
+	for(;;)
+	{
+		if(CyU3PQueueReceive(&CommandQueue, &command, CYU3P_WAIT_FOREVER) != CY_U3P_SUCCESS)
+		{
+			continue;
+		}
+
+		CommandThreadState.Cancel = CyFalse;
+		CommandThreadState.Running = command.Request;
+		ADI_TRACE(TraceCommandStart, command.Request, CommandThreadState.Completed);
+
+		status = AdiCommandRun(&command);
+		ADI_TRACE(TraceCommandDone, command.Request, status);
+
+#ifdef VERBOSE_MODE
+		ADI_LOG("Command 0x%x finished, status 0x%x\r\n", command.Request, status);
+#endif
+
+		if(command.Args != NULL)
+		{
+			CyU3PDmaBufferFree(command.Args);
+		}
+		CommandThreadState.Running = 0;
+		CommandThreadState.Completed++;
+	}
+}
+
+/**
+  * @brief Reads a vendor command's data from the control endpoint and queues it for the command worker thread.
+  *
+  * @param request The vendor request code
+  *
+  * @param value The setup packet value field
+  *
+  * @param index The setup packet index field
+  *
+  * @param length The number of data bytes to read from the control endpoint
+  *
+  * @return A status code indicating if the command was queued. On failure, the control request should be stalled.
+  *
+  * This is called from the control endpoint handler, which returns as soon as the command is queued. The
+  * request data is copied into its own DMA buffer (freed after the command runs), since USBBuffer is reused by
+  * the next control request. Bytes past the data actually sent by the PC are zero.
+ **/
+CyU3PReturnStatus_t AdiCommandQueue(uint8_t request, uint16_t value, uint16_t index, uint16_t length)
+{
+	CyU3PReturnStatus_t status;
+	CommandRequest command;
+	uint16_t bytesRead = 0;
+
+	command.Request = request;
+	command.ValueIndex = value | (index << 16);
+	command.Args = CyU3PDmaBufferAlloc(length + 4);
+	if(command.Args == NULL)
+	{
+		AdiLogError(CommandThread_c, __LINE__, CY_U3P_ERROR_MEMORY_ERROR);
+		return CY_U3P_ERROR_MEMORY_ERROR;
+	}
+	CyU3PMemSet(command.Args, 0, length + 4);
+
+	status = CyU3PUsbGetEP0Data(length, command.Args, &bytesRead);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(CommandThread_c, __LINE__, status);
+		CyU3PDmaBufferFree(command.Args);
+		return status;
+	}
+	command.Length = bytesRead;
+
+	status = AdiCommandSend(&command);
+	if(status != CY_U3P_SUCCESS)
+	{
+		CyU3PDmaBufferFree(command.Args);
+	}
+	return status;
+}
+
+/**
+  * @brief Queues a command with no control endpoint data for the command worker thread.
+  *
+  * @param request The vendor request code, or ADI_COMMAND_BULK for a bulk command channel request
+  *
+  * @param value The setup packet value field
+  *
+  * @param index The setup packet index field
+  *
+  * @return A status code indicating if the command was queued.
+  *
+  * Used for requests which only send data to the PC, once the control endpoint handler has sent its status.
+ **/
+CyU3PReturnStatus_t AdiCommandPost(uint16_t request, uint16_t value, uint16_t index)
+{
+	CommandRequest command;
+
+	command.Request = request;
+	command.ValueIndex = value | (index << 16);
+	command.Length = 0;
+	command.Args = NULL;
+	return AdiCommandSend(&command);
+}
+
+/**
+  * @brief Adds a command to CommandQueue.
+  *
+  * @param command The command to queue. The caller keeps ownership of its Args on failure.
+  *
+  * @return A status code indicating if the command was queued.
+ **/
+static CyU3PReturnStatus_t AdiCommandSend(CommandRequest *command)
+{
+	CyU3PReturnStatus_t status;
+
+	status = CyU3PQueueSend(&CommandQueue, command, CYU3P_NO_WAIT);
+	if(status != CY_U3P_SUCCESS)
+	{
+		/* Queue full */
+		AdiLogError(CommandThread_c, __LINE__, status);
+		return status;
+	}
+	CommandThreadState.Queued++;
+
+	return CY_U3P_SUCCESS;
+}
+
+/**
+  * @brief Handles ADI_COMMAND_CONTROL requests. Returns the command worker state, and can cancel the running command.
+  *
+  * @param action The action to perform (ADI_COMMAND_QUERY or ADI_COMMAND_CANCEL)
+  *
+  * @param length The number of bytes to send back on the control endpoint
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * The response is sent on the control endpoint, as 32-bit little endian words: status[0-3], the request code of
+  * the running command[4-7] (0 if idle, ADI_COMMAND_BULK for a bulk command request), the number of commands
+  * waiting to run[8-11] and the number of commands completed since boot[12-15]. A cancelled command stops at its
+  * next timeout check, and sends its usual bulk endpoint response with CY_U3P_ERROR_ABORTED. Commands already
+  * waiting in the queue still run.
+ **/
+CyU3PReturnStatus_t AdiCommandControl(uint16_t action, uint16_t length)
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	uint32_t running, waiting, completed;
+
+	if(action == ADI_COMMAND_CANCEL)
+	{
+		if(CommandThreadState.Running != 0)
+		{
+			CommandThreadState.Cancel = CyTrue;
+		}
+	}
+	else if(action != ADI_COMMAND_QUERY)
+	{
+		status = CY_U3P_ERROR_BAD_ARGUMENT;
+	}
+
+	running = CommandThreadState.Running;
+	completed = CommandThreadState.Completed;
+	waiting = CommandThreadState.Queued - completed;
+	/* The running command has been taken from the queue, but is not completed yet */
+	if((running != 0) && (waiting != 0))
+	{
+		waiting--;
+	}
+
+	USBBuffer[4] = running & 0xFF;
+	USBBuffer[5] = (running & 0xFF00) >> 8;
+	USBBuffer[6] = (running & 0xFF0000) >> 16;
+	USBBuffer[7] = (running & 0xFF000000) >> 24;
+	USBBuffer[8] = waiting & 0xFF;
+	USBBuffer[9] = (waiting & 0xFF00) >> 8;
+	USBBuffer[10] = (waiting & 0xFF0000) >> 16;
+	USBBuffer[11] = (waiting & 0xFF000000) >> 24;
+	USBBuffer[12] = completed & 0xFF;
+	USBBuffer[13] = (completed & 0xFF00) >> 8;
+	USBBuffer[14] = (completed & 0xFF0000) >> 16;
+	USBBuffer[15] = (completed & 0xFF000000) >> 24;
+	AdiSendStatus(status, length, CyTrue);
+
+	return status;
+}
+
+/**
+  * @brief Runs one queued vendor command.
+  *
+  * @param command The command to run
+  *
+  * @return The status returned by the command
+ **/
+static CyU3PReturnStatus_t AdiCommandRun(CommandRequest *command)
+{
+	CyU3PReturnStatus_t status;
+	uint16_t value = command->ValueIndex & 0xFFFF;
+
+	switch(command->Request)
+	{
+		case ADI_BUSY_MEASURE:
+			return AdiMeasureBusyPulse(command->Args);
+
+		case ADI_PULSE_WAIT:
+			return AdiPulseWait(command->Args);
+
+		case ADI_PIN_DELAY_MEASURE:
+			return AdiMeasurePinDelay(command->Args);
+
+		case ADI_MEASURE_DR:
+			return AdiMeasurePinFreq(command->Args);
+
+		case ADI_MEASURE_DR_PERIODS:
+			return AdiMeasurePinPeriods(command->Args);
+
+		case ADI_BITBANG_SPI:
+			return AdiBitBangSpiHandler(command->Args);
+
+		case ADI_RUN_SPI_SCRIPT:
+			return AdiRunSpiScript(command->Args, command->Length);
+
+		case ADI_READ_REG_LIST:
+			return AdiReadRegList(command->Args, command->Length, (CyBool_t) (value != 0));
+
+		case ADI_READ_TRACE:
+			AdiSendTrace(value);
+			return CY_U3P_SUCCESS;
+
+		case ADI_READ_DEBUG_LOG:
+			AdiSendDebugLog();
+			return CY_U3P_SUCCESS;
+
+		case ADI_I2C_READ_BYTES:
+			return AdiI2CReadHandler(command->Args, command->Length);
+
+		case ADI_I2C_WRITE_BYTES:
+			status = AdiI2CWriteHandler(command->Args, command->Length);
+			/* Send back status indicating operation is done */
+			AdiReturnBulkEndpointData(status, 4);
+			return status;
+
+		case ADI_PULSE_DRIVE:
+			status = AdiPulseDrive(command->Args);
+			/* Send back status over the BULK-In endpoint */
+			AdiReturnBulkEndpointData(status, 4);
+			return status;
+
+		case ADI_COMMAND_BULK:
+			AdiBulkCommandHandler();
+			return CY_U3P_SUCCESS;
+
+		default:
+			AdiLogError(CommandThread_c, __LINE__, CY_U3P_ERROR_BAD_ARGUMENT);
+			return CY_U3P_ERROR_BAD_ARGUMENT;
+	}
+}
@@ -0,0 +1,54 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		CommandThread.h
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		Header file for the vendor command worker thread
+ **/
+
+#ifndef COMMAND_THREAD_H
+#define COMMAND_THREAD_H
+
+/* Include the main header file */
+#include "main.h"
+
+/* Function definitions */
+void AdiCommandThreadEntry(uint32_t input);
+CyU3PReturnStatus_t AdiCommandQueue(uint8_t request, uint16_t value, uint16_t index, uint16_t length);
+CyU3PReturnStatus_t AdiCommandPost(uint16_t request, uint16_t value, uint16_t index);
+CyU3PReturnStatus_t AdiCommandControl(uint16_t action, uint16_t length);
+
+/** CommandThread allocated stack size (2KB) */
+#define COMMANDTHREAD_STACK						(0x0800)
+
+/** CommandThread execution priority. Lower than the app and stream threads, so a long command never holds them off */
+#define COMMANDTHREAD_PRIORITY					(10)
+
+/** Max number of commands waiting for the command worker thread */
+#define ADI_COMMAND_QUEUE_DEPTH					(8)
+
+/** Size of each CommandQueue message, in 32-bit words (one CommandRequest) */
+#define ADI_COMMAND_MSG_WORDS					(sizeof(CommandRequest) / 4)
+
+/** Command worker request code for a bulk command channel request. Outside the vendor request range */
+#define ADI_COMMAND_BULK						(0x100)
+
+/** ADI_COMMAND_CONTROL action (wValue): return the command worker state */
+#define ADI_COMMAND_QUERY						(0)
+
+/** ADI_COMMAND_CONTROL action (wValue): cancel the running command, then return the command worker state */
+#define ADI_COMMAND_CANCEL						(1)
+
+/** ADI_COMMAND_CONTROL response length (status, running request, commands waiting, commands completed) */
+#define ADI_COMMAND_CONTROL_LENGTH				(16)
+
+#endif
@@ -0,0 +1,280 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  * 
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  * 
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  * 
+  * @file		CpuLoad.c
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		This file contains the CPU load measurement (idle loop counter) and the per thread run time sampler.
+ **/
+
+#include "CpuLoad.h"
+
+/* Tell the compiler where to find the needed globals */
+extern uint8_t USBBuffer[4096];
+
+#ifdef CPU_LOAD_MODE
+
+/* Private function prototypes */
+static void AdiCpuCalibrate();
+static void AdiCpuIdleSpin(uint32_t durationMs);
+static void AdiCpuSampleCb(uint32_t nParam);
+
+/* Tell the compiler where to find the needed globals */
+extern StreamState StreamThreadState;
+extern CyU3PThread AppThread;
+extern CyU3PThread StreamThread;
+extern CyU3PThread CommandThread;
+extern CyU3PThread DebugLogThread;
+extern CyU3PThread CpuLoadThread;
+
+/** CPU load counters */
+static CpuLoad CpuLoadState;
+
+/** RTOS timer which samples the running context */
+static CyU3PTimer CpuSampleTimer;
+
+/**
+  * @brief This is the CPU load idle thread entry point.
+  *
+  * @param input Unused input argument required by the thread manager
+  *
+  * @return void
+  *
+  * The thread starts the run time sampler, then runs the idle loop forever at the lowest priority, so the
+  * loop only advances while no other thread or ISR needs the CPU. The fraction of the calibrated loop rate
+  * reached over a window is the idle fraction of that window. The loop rate is calibrated once, when the PC
+  * first clears the counters with no stream running (AdiGetCpuLoad), since calibrating holds off the other
+  * ADI threads.
+ **/
+void AdiCpuLoadThreadEntry(uint32_t input)
+{
+	CyU3PReturnStatus_t status;
+
+	/* Start sampling the running context */
+	status = CyU3PTimerCreate(&CpuSampleTimer, AdiCpuSampleCb, 0, ADI_CPU_SAMPLE_MS, ADI_CPU_SAMPLE_MS, CYU3P_AUTO_ACTIVATE);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(CpuLoad_c, __LINE__, status);
+	}
+
+	/* Spin for the max duration, so there is no tick alignment gap in the count (restarts after ~49 days).
+	 * The spin ends early when a calibration is requested */
+	while(1)
+	{
+		if(CpuLoadState.CalibratePending)
+		{
+			AdiCpuCalibrate();
+		}
+		AdiCpuIdleSpin(0xFFFFFFFF);
+	}
+}
+
+#endif
+
+/**
+  * @brief Sends the CPU load and per context run time to the PC.
+  *
+  * @param options ADI_GET_CPU_LOAD options (ADI_CPU_LOAD_CLEAR)
+  *
+  * @return void
+  *
+  * Everything is measured since the counters were last cleared (or since boot). The response is sent on the
+  * control endpoint: status[0-3], window length in ms[4-7], CPU load in 0.01% units[8-11], calibrated idle
+  * loops per ms[12-15], the run time in ms of each CpuLoadContext[16-39] (idle, app, stream, command, debug log,
+  * other), then the ISR time taken while no thread was running, in us[40-43].
+  *
+  * The CPU load comes from the idle loop count, so it includes all threads and ISRs. The per context times
+  * are statistical (one sample per ms from the RTOS timer interrupt, charged to the interrupted thread), so
+  * they need a window of at least a few seconds. ISR time spent while a thread was running is charged to
+  * that thread. Builds without CPU_LOAD_MODE return CY_U3P_ERROR_NOT_SUPPORTED.
+  *
+  * The idle loop rate is 0, and so is the CPU load, until the first ADI_CPU_LOAD_CLEAR sent while no stream is
+  * running. That request has the idle thread measure the loop rate once the response is sent, which holds off
+  * the other ADI threads for ADI_CPU_CALIBRATE_MS, then clears the counters again.
+ **/
+void AdiGetCpuLoad(uint16_t options)
+{
+#ifdef CPU_LOAD_MODE
+	uint32_t intMask, index, samples, load, isrUs;
+	uint32_t contextSamples[CPU_LOAD_NUM_CONTEXTS];
+	uint64_t idleLoops, expectedLoops, idleUs;
+
+	/* Snapshot the counters, since the sampler runs from an interrupt */
+	intMask = CyU3PVicDisableAllInterrupts();
+	samples = CpuLoadState.Samples;
+	idleLoops = CpuLoadState.IdleLoopTotal;
+	for(index = 0; index < CPU_LOAD_NUM_CONTEXTS; index++)
+	{
+		contextSamples[index] = CpuLoadState.ContextSamples[index];
+	}
+	if(options & ADI_CPU_LOAD_CLEAR)
+	{
+		CpuLoadState.Samples = 0;
+		CpuLoadState.IdleLoopTotal = 0;
+		for(index = 0; index < CPU_LOAD_NUM_CONTEXTS; index++)
+		{
+			CpuLoadState.ContextSamples[index] = 0;
+		}
+		if((CpuLoadState.IdleLoopsPerMs == 0) && !StreamThreadState.Stats.Active)
+		{
+			CpuLoadState.CalibratePending = CyTrue;
+		}
+	}
+	CyU3PVicEnableInterrupts(intMask);
+
+	/* Load is the part of the window the idle loop did not get */
+	load = 0;
+	isrUs = 0;
+	expectedLoops = (uint64_t) CpuLoadState.IdleLoopsPerMs * samples * ADI_CPU_SAMPLE_MS;
+	if((expectedLoops != 0) && (idleLoops < expectedLoops))
+	{
+		load = (uint32_t) (10000 - ((idleLoops * 10000) / expectedLoops));
+	}
+
+	/* ISR time while idle is the idle sample time the idle loop did not get */
+	if(CpuLoadState.IdleLoopsPerMs != 0)
+	{
+		idleUs = (idleLoops * 1000) / CpuLoadState.IdleLoopsPerMs;
+		if(((uint64_t) contextSamples[CpuContextIdle] * ADI_CPU_SAMPLE_MS * 1000) > idleUs)
+		{
+			isrUs = (uint32_t) (((uint64_t) contextSamples[CpuContextIdle] * ADI_CPU_SAMPLE_MS * 1000) - idleUs);
+		}
+	}
+
+	samples *= ADI_CPU_SAMPLE_MS;
+	USBBuffer[4] = samples & 0xFF;
+	USBBuffer[5] = (samples & 0xFF00) >> 8;
+	USBBuffer[6] = (samples & 0xFF0000) >> 16;
+	USBBuffer[7] = (samples & 0xFF000000) >> 24;
+	USBBuffer[8] = load & 0xFF;
+	USBBuffer[9] = (load & 0xFF00) >> 8;
+	USBBuffer[10] = (load & 0xFF0000) >> 16;
+	USBBuffer[11] = (load & 0xFF000000) >> 24;
+	USBBuffer[12] = CpuLoadState.IdleLoopsPerMs & 0xFF;
+	USBBuffer[13] = (CpuLoadState.IdleLoopsPerMs & 0xFF00) >> 8;
+	USBBuffer[14] = (CpuLoadState.IdleLoopsPerMs & 0xFF0000) >> 16;
+	USBBuffer[15] = (CpuLoadState.IdleLoopsPerMs & 0xFF000000) >> 24;
+	for(index = 0; index < CPU_LOAD_NUM_CONTEXTS; index++)
+	{
+		contextSamples[index] *= ADI_CPU_SAMPLE_MS;
+		USBBuffer[16 + (4 * index)] = contextSamples[index] & 0xFF;
+		USBBuffer[17 + (4 * index)] = (contextSamples[index] & 0xFF00) >> 8;
+		USBBuffer[18 + (4 * index)] = (contextSamples[index] & 0xFF0000) >> 16;
+		USBBuffer[19 + (4 * index)] = (contextSamples[index] & 0xFF000000) >> 24;
+	}
+	USBBuffer[40] = isrUs & 0xFF;
+	USBBuffer[41] = (isrUs & 0xFF00) >> 8;
+	USBBuffer[42] = (isrUs & 0xFF0000) >> 16;
+	USBBuffer[43] = (isrUs & 0xFF000000) >> 24;
+
+	AdiSendStatus(CY_U3P_SUCCESS, CPU_LOAD_LENGTH, CyTrue);
+#else
+	AdiSendStatus(CY_U3P_ERROR_NOT_SUPPORTED, 4, CyTrue);
+#endif
+}
+
+#ifdef CPU_LOAD_MODE
+
+/**
+  * @brief Measures the idle loop rate with nothing else running. Runs on the CPU load idle thread.
+  *
+  * @return void
+  *
+  * The idle thread raises itself above the app thread for ADI_CPU_CALIBRATE_MS, so only the SDK driver
+  * threads and ISRs can run. The counters are cleared afterwards, since the calibration time is not idle time.
+ **/
+static void AdiCpuCalibrate()
+{
+	uint32_t oldPriority, startLoops, intMask, index;
+
+	CpuLoadState.CalibratePending = CyFalse;
+
+	/* Measure the idle loop rate, holding off the other ADI threads */
+	CyU3PThreadPriorityChange(&CpuLoadThread, APPTHREAD_PRIORITY - 1, &oldPriority);
+	AdiCpuIdleSpin(1);
+	startLoops = CpuLoadState.IdleLoops;
+	AdiCpuIdleSpin(ADI_CPU_CALIBRATE_MS);
+	CpuLoadState.IdleLoopsPerMs = (CpuLoadState.IdleLoops - startLoops) / ADI_CPU_CALIBRATE_MS;
+	CyU3PThreadPriorityChange(&CpuLoadThread, oldPriority, &oldPriority);
+
+	intMask = CyU3PVicDisableAllInterrupts();
+	CpuLoadState.LastIdleLoops = CpuLoadState.IdleLoops;
+	CpuLoadState.Samples = 0;
+	CpuLoadState.IdleLoopTotal = 0;
+	for(index = 0; index < CPU_LOAD_NUM_CONTEXTS; index++)
+	{
+		CpuLoadState.ContextSamples[index] = 0;
+	}
+	CyU3PVicEnableInterrupts(intMask);
+}
+
+/**
+  * @brief Runs the idle loop for a number of RTOS ticks, or until a calibration is requested.
+  *
+  * @param durationMs The number of ms to run for. Starts from the next tick
+  *
+  * @return void
+  *
+  * Both the calibration and the idle thread use this loop, so the loop rates compare directly.
+ **/
+static void AdiCpuIdleSpin(uint32_t durationMs)
+{
+	uint32_t startTime;
+
+	/* Line up with a tick */
+	startTime = CyU3PGetTime();
+	while(CyU3PGetTime() == startTime);
+	startTime++;
+
+	while(((CyU3PGetTime() - startTime) < durationMs) && !CpuLoadState.CalibratePending)
+	{
+		CpuLoadState.IdleLoops++;
+	}
+}
+
+/**
+  * @brief Timer callback which samples the running context. Should not be called directly.
+  *
+  * @param nParam Callback argument, unused here.
+  *
+  * @return void
+  *
+  * Called by the RTOS every ADI_CPU_SAMPLE_MS, from the timer interrupt. CyU3PThreadIdentify returns the
+  * thread the interrupt was taken from (NULL if no thread was running), which is charged one sample.
+ **/
+static void AdiCpuSampleCb(uint32_t nParam)
+{
+	CyU3PThread *current;
+	uint32_t loops;
+	CpuLoadContext context;
+
+	current = CyU3PThreadIdentify();
+	if((current == NULL) || (current == &CpuLoadThread))
+		context = CpuContextIdle;
+	else if(current == &AppThread)
+		context = CpuContextApp;
+	else if(current == &StreamThread)
+		context = CpuContextStream;
+	else if(current == &CommandThread)
+		context = CpuContextCommand;
+	else if(current == &DebugLogThread)
+		context = CpuContextDebugLog;
+	else
+		context = CpuContextOther;
+	CpuLoadState.ContextSamples[context]++;
+	CpuLoadState.Samples++;
+
+	loops = CpuLoadState.IdleLoops;
+	CpuLoadState.IdleLoopTotal += (loops - CpuLoadState.LastIdleLoops);
+	CpuLoadState.LastIdleLoops = loops;
+}
+
+#endif
@@ -0,0 +1,98 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  * 
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  * 
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  * 
+  * @file		CpuLoad.h
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		Header file for the CPU load and per thread run time accounting.
+ **/
+
+#ifndef CPU_LOAD_H
+#define CPU_LOAD_H
+
+/* Include the main header file */
+#include "main.h"
+
+/** Enum for the execution contexts which CPU time is charged to */
+typedef enum CpuLoadContext
+{
+	/** No thread running, or the CPU load idle thread */
+	CpuContextIdle = 0,
+
+	/** AppThread (vendor request handling, stream start / stop) */
+	CpuContextApp = 1,
+
+	/** StreamThread (stream workers) */
+	CpuContextStream = 2,
+
+	/** CommandThread (long vendor commands) */
+	CpuContextCommand = 3,
+
+	/** DebugLogThread (UART debug printing) */
+	CpuContextDebugLog = 4,
+
+	/** FX3 SDK driver threads (USB, DMA, serial peripherals) */
+	CpuContextOther = 5
+
+}CpuLoadContext;
+
+/** Number of contexts in the CpuLoadContext enum */
+#define CPU_LOAD_NUM_CONTEXTS					(6)
+
+/** Number of bytes returned by the ADI_GET_CPU_LOAD vendor command */
+#define CPU_LOAD_LENGTH							(20 + (4 * CPU_LOAD_NUM_CONTEXTS))
+
+/** @brief Struct to store the CPU load counters */
+typedef struct CpuLoad
+{
+	/** Idle loop count with no other load, per ms. 0 until calibrated (AdiGetCpuLoad) */
+	uint32_t IdleLoopsPerMs;
+
+	/** Set when the idle thread should measure IdleLoopsPerMs */
+	volatile CyBool_t CalibratePending;
+
+	/** Idle loop passes since boot. Only written by the idle thread */
+	volatile uint32_t IdleLoops;
+
+	/** IdleLoops at the last sample */
+	uint32_t LastIdleLoops;
+
+	/** Idle loop passes since the counters were cleared */
+	uint64_t IdleLoopTotal;
+
+	/** Number of samples since the counters were cleared (one per ADI_CPU_SAMPLE_MS) */
+	uint32_t Samples;
+
+	/** Number of samples which found each context running */
+	uint32_t ContextSamples[CPU_LOAD_NUM_CONTEXTS];
+
+}CpuLoad;
+
+/* Public function prototypes */
+void AdiCpuLoadThreadEntry(uint32_t input);
+void AdiGetCpuLoad(uint16_t options);
+
+/** CpuLoadThread allocated stack size (1KB) */
+#define CPULOADTHREAD_STACK						(0x0400)
+
+/** CpuLoadThread execution priority. Must be the lowest priority thread, since it never blocks */
+#define CPULOADTHREAD_PRIORITY					(15)
+
+/** Sample period for the running context, in ms */
+#define ADI_CPU_SAMPLE_MS						(1)
+
+/** Time the idle loop rate is measured for, in ms */
+#define ADI_CPU_CALIBRATE_MS					(20)
+
+/** ADI_GET_CPU_LOAD option (wValue): clear the counters after they are read */
+#define ADI_CPU_LOAD_CLEAR						(1 << 0)
+
+#endif
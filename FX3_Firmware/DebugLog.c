@@ -0,0 +1,200 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  * 
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  * 
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  * 
+  * @file		DebugLog.c
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		This file contains the deferred debug log. Messages are stored raw, and printed to the UART by a low priority thread.
+ **/
+
+#include "DebugLog.h"
+#include <stdarg.h>
+
+/* Tell the compiler where to find the needed globals */
+extern uint8_t BulkBuffer[12288];
+
+/** Debug log ring. Message n is stored at n % ADI_LOG_RECORDS */
+static DebugLogRecord DebugLogRing[ADI_LOG_RECORDS];
+
+/** Number of messages logged since boot */
+static volatile uint32_t DebugLogWritten = 0;
+
+/** Number of messages printed to the UART. Messages between this and DebugLogWritten are never overwritten */
+static volatile uint32_t DebugLogPrinted = 0;
+
+/** Number of messages dropped because the ring was full of unprinted messages, or being read */
+static volatile uint32_t DebugLogDropped = 0;
+
+/** Set while the ring is copied out, so a message logged meanwhile does not tear the copy */
+static volatile CyBool_t DebugLogPaused = CyFalse;
+
+/**
+  * @brief This is the debug log thread entry point.
+  *
+  * @param input Unused input argument required by the thread manager
+  *
+  * @return void
+  *
+  * Prints the logged messages to the UART debug console, oldest first, then sleeps for ADI_LOG_IDLE_MS
+  * once the ring is empty. The UART wait happens here, at the lowest thread priority, instead of in the
+  * code which logged the message. A note with the number of dropped messages is printed after a gap.
+ **/
+void AdiDebugLogThreadEntry(uint32_t input)
+{
+	DebugLogRecord record;
+	uint32_t intMask, dropped, lastDropped;
+
+	lastDropped = 0;
+	while(1)
+	{
+		while(DebugLogPrinted != DebugLogWritten)
+		{
+			/* Copy the message out, so it can be printed with interrupts on */
+			intMask = CyU3PVicDisableAllInterrupts();
+			record = DebugLogRing[DebugLogPrinted & (ADI_LOG_RECORDS - 1)];
+			CyU3PVicEnableInterrupts(intMask);
+
+			CyU3PDebugPrint (4, (char *) record.Format, record.Args[0], record.Args[1], record.Args[2], record.Args[3], record.Args[4]);
+			DebugLogPrinted++;
+		}
+
+		dropped = DebugLogDropped;
+		if(dropped != lastDropped)
+		{
+			CyU3PDebugPrint (4, "Debug log full, %d messages dropped\r\n", dropped - lastDropped);
+			lastDropped = dropped;
+		}
+
+		CyU3PThreadSleep(ADI_LOG_IDLE_MS);
+	}
+}
+
+/**
+  * @brief Adds a message to the debug log ring. Call through ADI_LOG.
+  *
+  * @param numArgs The number of arguments following the format string (max ADI_LOG_MAX_ARGS)
+  *
+  * @param format The printf style format string. Must stay valid until the message is printed (string literal)
+  *
+  * @return void
+  *
+  * Safe to call from the threads and the ISRs. Only the format string address and the raw arguments are
+  * stored, with interrupts held off for the 32 byte store, so logging never waits on the UART. When the
+  * ring is full of messages not yet printed the new message is dropped and counted.
+ **/
+void AdiLogWrite(uint32_t numArgs, const char *format, ...)
+{
+	va_list argList;
+	uint32_t args[ADI_LOG_MAX_ARGS] = {0};
+	uint32_t intMask, index;
+	DebugLogRecord *record;
+
+	if(numArgs > ADI_LOG_MAX_ARGS)
+	{
+		numArgs = ADI_LOG_MAX_ARGS;
+	}
+	va_start(argList, format);
+	for(index = 0; index < numArgs; index++)
+	{
+		args[index] = va_arg(argList, uint32_t);
+	}
+	va_end(argList);
+
+	intMask = CyU3PVicDisableAllInterrupts();
+	if(DebugLogPaused || ((DebugLogWritten - DebugLogPrinted) >= ADI_LOG_RECORDS))
+	{
+		DebugLogDropped++;
+	}
+	else
+	{
+		record = &DebugLogRing[DebugLogWritten & (ADI_LOG_RECORDS - 1)];
+		record->Uptime = CyU3PGetTime();
+		record->Format = format;
+		record->NumArgs = numArgs;
+		for(index = 0; index < ADI_LOG_MAX_ARGS; index++)
+		{
+			record->Args[index] = args[index];
+		}
+		DebugLogWritten++;
+	}
+	CyU3PVicEnableInterrupts(intMask);
+}
+
+/**
+  * @brief Handles ADI_READ_DEBUG_LOG requests. Queues the debug log read for the command worker thread.
+  *
+  * @param length The number of status bytes to send on the control endpoint
+  *
+  * @return void
+  *
+  * The status is sent on the control endpoint, then AdiSendDebugLog sends the messages on the bulk endpoint.
+ **/
+void AdiReadDebugLog(uint16_t length)
+{
+	AdiSendStatus(AdiCommandPost(ADI_READ_DEBUG_LOG, 0, 0), length, CyTrue);
+}
+
+/**
+  * @brief Sends the most recent debug log messages to the PC. Runs on the command worker thread.
+  *
+  * @return void
+  *
+  * The messages are sent on the bulk endpoint (ChannelToPC): status[0-3], the number of messages sent[4-7], the
+  * number of messages logged since boot[8-11] and the number dropped[12-15]. The last ADI_LOG_RECORDS messages
+  * follow, oldest first, as DebugLogRecord (ADI_LOG_RECORD_BYTES each). The format ID is the format string address,
+  * which is resolved against the firmware image symbols by the host. Reading does not change what is printed to
+  * the UART.
+ **/
+void AdiSendDebugLog()
+{
+	uint32_t written, dropped, numRecords, first, index;
+	DebugLogRecord *record;
+	uint8_t *dest;
+
+	/* Hold off new messages while the ring is copied */
+	DebugLogPaused = CyTrue;
+
+	written = DebugLogWritten;
+	numRecords = written;
+	if(numRecords > ADI_LOG_RECORDS)
+	{
+		numRecords = ADI_LOG_RECORDS;
+	}
+	first = written - numRecords;
+	for(index = 0; index < numRecords; index++)
+	{
+		/* Copied field by field, so the format ID is the low 4 bytes of the address where pointers are wider */
+		record = &DebugLogRing[(first + index) & (ADI_LOG_RECORDS - 1)];
+		dest = BulkBuffer + ADI_LOG_HEADER_BYTES + (index * ADI_LOG_RECORD_BYTES);
+		CyU3PMemCopy(dest, (uint8_t *) &record->Uptime, 4);
+		CyU3PMemCopy(dest + 4, (uint8_t *) &record->Format, 4);
+		CyU3PMemCopy(dest + 8, (uint8_t *) &record->NumArgs, 4);
+		CyU3PMemCopy(dest + 12, (uint8_t *) record->Args, 4 * ADI_LOG_MAX_ARGS);
+	}
+
+	DebugLogPaused = CyFalse;
+	dropped = DebugLogDropped;
+
+	BulkBuffer[4] = numRecords & 0xFF;
+	BulkBuffer[5] = (numRecords & 0xFF00) >> 8;
+	BulkBuffer[6] = (numRecords & 0xFF0000) >> 16;
+	BulkBuffer[7] = (numRecords & 0xFF000000) >> 24;
+	BulkBuffer[8] = written & 0xFF;
+	BulkBuffer[9] = (written & 0xFF00) >> 8;
+	BulkBuffer[10] = (written & 0xFF0000) >> 16;
+	BulkBuffer[11] = (written & 0xFF000000) >> 24;
+	BulkBuffer[12] = dropped & 0xFF;
+	BulkBuffer[13] = (dropped & 0xFF00) >> 8;
+	BulkBuffer[14] = (dropped & 0xFF0000) >> 16;
+	BulkBuffer[15] = (dropped & 0xFF000000) >> 24;
+
+	AdiReturnBulkEndpointData(CY_U3P_SUCCESS, ADI_LOG_HEADER_BYTES + (numRecords * ADI_LOG_RECORD_BYTES));
+}
@@ -0,0 +1,84 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  * 
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  * 
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  * 
+  * @file		DebugLog.h
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		Header file for the deferred debug log.
+ **/
+
+#ifndef DEBUG_LOG_H
+#define DEBUG_LOG_H
+
+/* Include the main header file */
+#include "main.h"
+
+/**
+  * @brief Structure which holds one deferred debug message
+  *
+  * The format string is not copied, only its address. Each message is printed from the format string
+  * and the raw arguments by the debug log thread. The total size of this struct is 32 bytes, which is
+  * also its size on the wire (ADI_LOG_RECORD_BYTES)
+ **/
+typedef struct DebugLogRecord
+{
+	/** FX3 ThreadX RTOS uptime when the message was logged, in milliseconds (0-3) */
+	uint32_t Uptime;
+
+	/** Address of the format string in the firmware image. Used as the format ID (4-7) */
+	const char *Format;
+
+	/** Number of valid arguments (8-11) */
+	uint32_t NumArgs;
+
+	/** The raw format arguments (12-31) */
+	uint32_t Args[5];
+
+}DebugLogRecord;
+
+/* Function definitions */
+void AdiDebugLogThreadEntry(uint32_t input);
+void AdiLogWrite(uint32_t numArgs, const char *format, ...);
+void AdiReadDebugLog(uint16_t length);
+void AdiSendDebugLog();
+
+/** DebugLogThread allocated stack size (2KB). CyU3PDebugPrint formats the message on this stack */
+#define DEBUGLOGTHREAD_STACK					(0x0800)
+
+/** DebugLogThread execution priority. Above only the CPU load idle thread, so printing only uses otherwise idle time */
+#define DEBUGLOGTHREAD_PRIORITY					(14)
+
+/** Max number of arguments for one ADI_LOG message */
+#define ADI_LOG_MAX_ARGS						(5)
+
+/** Number of messages held in the debug log ring. Must be a power of 2 */
+#define ADI_LOG_RECORDS							(128)
+
+/** Time the debug log thread sleeps when there are no messages left to print, in ms */
+#define ADI_LOG_IDLE_MS							(10)
+
+/** Size of one ADI_READ_DEBUG_LOG message record on the bulk endpoint */
+#define ADI_LOG_RECORD_BYTES					(32)
+
+/** Size of the ADI_READ_DEBUG_LOG bulk endpoint response header (status, messages, messages logged, messages dropped) */
+#define ADI_LOG_HEADER_BYTES					(16)
+
+/** Counts the arguments after the format string (0 - ADI_LOG_MAX_ARGS) */
+#define ADI_LOG_NARGS(...)						ADI_LOG_NARGS_(__VA_ARGS__, 5, 4, 3, 2, 1, 0, 0)
+#define ADI_LOG_NARGS_(format, a0, a1, a2, a3, a4, n, ...)	n
+
+/**
+ * Logs a debug message (format, args) without formatting it or waiting on the UART. Drop in replacement for
+ * CyU3PDebugPrint (4, format, args). All arguments must be 32 bit integer values, and the format string must be a literal
+ */
+#define ADI_LOG(...)							AdiLogWrite(ADI_LOG_NARGS(__VA_ARGS__), __VA_ARGS__)
+
+#endif
@@ -160,7 +160,7 @@ static void WriteLogToFlash(ErrorMsg* msg)
 }
 
 /**
-  * @brief Prints an error log object to the debug console
+  * @brief Queues an error log object for the debug console (DebugLog.c), without waiting on the UART
   *
   * @param msg The error log object to print
   *
@@ -168,7 +168,7 @@ static void WriteLogToFlash(ErrorMsg* msg)
  **/
 static void WriteLogToDebug(ErrorMsg* msg)
 {
-	CyU3PDebugPrint (4, "Error code 0x%x occurred on line %d of file %d. System uptime: %dms\r\n", msg->ErrorCode, msg->Line, msg->File, msg->Uptime);
+	ADI_LOG("Error code 0x%x occurred on line %d of file %d. System uptime: %dms\r\n", msg->ErrorCode, msg->Line, msg->File, msg->Uptime);
 }
 
 /**
@@ -188,7 +188,7 @@ static uint32_t GetNewLogAddress(uint32_t* TotalLogCount)
 	uint32_t count = GetLogCount();
 
 #ifdef VERBOSE_MODE
-	CyU3PDebugPrint (4, "Current error log count: 0x%x\r\n", count);
+	ADI_LOG("Current error log count: 0x%x\r\n", count);
 #endif
 
 	/* Find location of "front" */
@@ -204,7 +204,7 @@ static uint32_t GetNewLogAddress(uint32_t* TotalLogCount)
 	*TotalLogCount = count;
 
 #ifdef VERBOSE_MODE
-	CyU3PDebugPrint (4, "New Log Address: 0x%x\r\n", addr);
+	ADI_LOG("New Log Address: 0x%x\r\n", addr);
 #endif
 
 	/* Return address to write the new log to */
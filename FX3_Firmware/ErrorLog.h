@@ -66,7 +66,19 @@ typedef enum FileIdentifier
 	I2cFunctions_c = 9,
 
 	/** Error originating from HelperFunctions.c */
-	HelperFunctions_c = 10
+	HelperFunctions_c = 10,
+
+	/** Error originating from BulkCommands.c */
+	BulkCommands_c = 11,
+
+	/** Error originating from SpiScript.c */
+	SpiScript_c = 12,
+
+	/** Error originating from CommandThread.c */
+	CommandThread_c = 13,
+
+	/** Error originating from CpuLoad.c */
+	CpuLoad_c = 14
 
 }FileIdentifier;
 
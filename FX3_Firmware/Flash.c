@@ -55,7 +55,7 @@ CyU3PReturnStatus_t AdiFlashInit()
     if (status != CY_U3P_SUCCESS)
     {
 #ifdef VERBOSE_MODE
-    	CyU3PDebugPrint (4, "I2C init failed! 0x%x\r\n", status);
+    	ADI_LOG("I2C init failed! 0x%x\r\n", status);
 #endif
         return status;
     }
@@ -71,7 +71,7 @@ CyU3PReturnStatus_t AdiFlashInit()
     if (status != CY_U3P_SUCCESS)
     {
 #ifdef VERBOSE_MODE
-    	CyU3PDebugPrint (4, "Setting I2C configuration failed! 0x%x\r\n", status);
+    	ADI_LOG("Setting I2C configuration failed! 0x%x\r\n", status);
 #endif
         return status;
     }
@@ -95,7 +95,7 @@ CyU3PReturnStatus_t AdiFlashInit()
     if (status != CY_U3P_SUCCESS)
     {
 #ifdef VERBOSE_MODE
-    	CyU3PDebugPrint (4, "Setting I2C Tx DMA channel failed! 0x%x\r\n", status);
+    	ADI_LOG("Setting I2C Tx DMA channel failed! 0x%x\r\n", status);
 #endif
         return status;
     }
@@ -107,7 +107,7 @@ CyU3PReturnStatus_t AdiFlashInit()
     if (status != CY_U3P_SUCCESS)
     {
 #ifdef VERBOSE_MODE
-    	CyU3PDebugPrint (4, "Setting I2C Rx DMA channel failed! 0x%x\r\n", status);
+    	ADI_LOG("Setting I2C Rx DMA channel failed! 0x%x\r\n", status);
 #endif
         return status;
     }
@@ -230,7 +230,7 @@ static CyU3PReturnStatus_t FlashTransfer(uint32_t Address, uint16_t NumBytes, ui
 {
     CyU3PDmaBuffer_t buf_p;
     CyU3PI2cPreamble_t preamble;
-    CyU3PReturnStatus_t status;
+    CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 
     uint16_t dmaCount;
     uint16_t lastCount;
@@ -271,7 +271,7 @@ static CyU3PReturnStatus_t FlashTransfer(uint32_t Address, uint16_t NumBytes, ui
     		dmaCount = lastCount;
 
 #ifdef VERBOSE_MODE
-    	CyU3PDebugPrint (4, "I2C access: Dev addr: 0x%x Byte Addr: 0x%x, size: 0x%x, pages: 0x%x read: %d\r\n", device_address, Address, dmaCount, pageCount, isRead);
+    	ADI_LOG("I2C access: Dev addr: 0x%x Byte Addr: 0x%x, size: 0x%x, pages: 0x%x read: %d\r\n", device_address, Address, dmaCount, pageCount, isRead);
 #endif
 
     	if(isRead)
@@ -291,13 +291,13 @@ static CyU3PReturnStatus_t FlashTransfer(uint32_t Address, uint16_t NumBytes, ui
             status = CyU3PI2cSendCommand(&preamble, dmaCount, CyTrue);
 #ifdef VERBOSE_MODE
             if(status != CY_U3P_SUCCESS)
-            	CyU3PDebugPrint (4, "I2C send read command failed: 0x%x\r\n", status);
+            	ADI_LOG("I2C send read command failed: 0x%x\r\n", status);
 #endif
             /* Set up DMA to receive read data */
             status = CyU3PDmaChannelSetupRecvBuffer (&flashRxHandle, &buf_p);
 #ifdef VERBOSE_MODE
             if(status != CY_U3P_SUCCESS)
-            	CyU3PDebugPrint (4, "I2C DMA Rx channel setup failed: 0x%x\r\n", status);
+            	ADI_LOG("I2C DMA Rx channel setup failed: 0x%x\r\n", status);
 #endif
     	}
     	else
@@ -316,13 +316,13 @@ static CyU3PReturnStatus_t FlashTransfer(uint32_t Address, uint16_t NumBytes, ui
             status = CyU3PDmaChannelSetupSendBuffer (&flashTxHandle, &buf_p);
 #ifdef VERBOSE_MODE
             if(status != CY_U3P_SUCCESS)
-            	CyU3PDebugPrint (4, "I2C DMA Tx channel setup failed: 0x%x\r\n", status);
+            	ADI_LOG("I2C DMA Tx channel setup failed: 0x%x\r\n", status);
 #endif
             /* Send write command */
             status = CyU3PI2cSendCommand (&preamble, dmaCount, CyFalse);
 #ifdef VERBOSE_MODE
             if(status != CY_U3P_SUCCESS)
-            	CyU3PDebugPrint (4, "I2C send write command failed: 0x%x\r\n", status);
+            	ADI_LOG("I2C send write command failed: 0x%x\r\n", status);
 #endif
     	}
         /* Stall for 20ms */
@@ -331,7 +331,7 @@ static CyU3PReturnStatus_t FlashTransfer(uint32_t Address, uint16_t NumBytes, ui
         status = CyU3PI2cWaitForBlockXfer(isRead);
 #ifdef VERBOSE_MODE
         if(status != CY_U3P_SUCCESS)
-        	CyU3PDebugPrint (4, "I2C DMA wait for completion failed: 0x%x\r\n", status);
+        	ADI_LOG("I2C DMA wait for completion failed: 0x%x\r\n", status);
 #endif
 
         /* decrement page count */
@@ -342,7 +342,7 @@ static CyU3PReturnStatus_t FlashTransfer(uint32_t Address, uint16_t NumBytes, ui
     }
 
 #ifdef VERBOSE_MODE
-    CyU3PDebugPrint (4, "Flash transfer complete!\r\n", status);
+    ADI_LOG("Flash transfer complete!\r\n", status);
 #endif
 
     /* De-Init flash */
@@ -104,9 +104,12 @@ CyU3PReturnStatus_t AdiSetDutSupply(DutVoltage SupplyMode)
 	gpioConfig.intrMode = CY_U3P_GPIO_NO_INTR;
 
 #ifdef VERBOSE_MODE
-	CyU3PDebugPrint (4, "Setting power supply mode %d\r\n", SupplyMode);
+	ADI_LOG("Setting power supply mode %d\r\n", SupplyMode);
 #endif
 
+	/* A power cycled DUT starts back on page 0, and an unpowered DUT has no page */
+	AdiInvalidatePageCache();
+
 	/* Check the DutVoltage value */
 	switch(SupplyMode)
 	{
@@ -237,7 +240,7 @@ void AdiConfigureWatchdog()
 	if(FX3State.WatchDogEnabled)
 	{
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "Enabling Watchdog Timer, period %d ms\r\n", FX3State.WatchDogPeriodMs);
+		ADI_LOG("Enabling Watchdog Timer, period %d ms\r\n", FX3State.WatchDogPeriodMs);
 #endif
 		/* Calculate the watchdog clear period - 5 seconds less than the watchdog timeout */
 		uint32_t clearPeriod = FX3State.WatchDogPeriodMs - 5000;
@@ -256,7 +259,7 @@ void AdiConfigureWatchdog()
 	else
 	{
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "Disabling Watchdog Timer\r\n");
+		ADI_LOG("Disabling Watchdog Timer\r\n");
 #endif
 		/* destroy timer */
 		status = CyU3PTimerDestroy(&WatchdogTimer);
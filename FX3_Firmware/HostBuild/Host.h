@@ -0,0 +1,152 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		Host.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Internal interfaces shared by the host build scheduler, register models, SDK stand-in and test harness.
+ **/
+
+#ifndef HOST_H
+#define HOST_H
+
+#include "cyu3types.h"
+#include "cyu3error.h"
+#include "cyu3os.h"
+#include "cyu3dma.h"
+#include "cyu3usb.h"
+
+/** Time value which never arrives */
+#define HOST_NS_NEVER							(0xFFFFFFFFFFFFFFFFull)
+
+/** Simulated time for one MMIO register access (APB access from the ARM9 at 201.6MHz) */
+#define HOST_REG_ACCESS_NS						(50)
+
+/** Simulated time for an RTOS or SDK call */
+#define HOST_SDK_CALL_NS						(500)
+
+/** FX3 system clock. Matches the 10.0784MHz GPIO timer rate the firmware uses (S_TO_TICKS_MULT) */
+#define HOST_SYS_CLK_HZ							(403136000)
+
+/** Pin level for a pin which is not driven */
+#define HOST_PIN_Z								(-1)
+
+/** Number of FX3 GPIOs */
+#define HOST_NUM_GPIO							(61)
+
+/** Simulated time since boot, in ns */
+extern uint64_t HostSimNs;
+
+/** Set by the -v option. Prints the firmware debug output */
+extern CyBool_t HostVerbose;
+
+/* HostOs.c: cooperative scheduler for the firmware threads */
+void HostOsStart(void);
+void HostSpend(uint64_t ns);
+void HostSafePoint(void);
+uint64_t HostDeadline(uint32_t waitMs);
+CyBool_t HostWait(void *waitObj, uint64_t deadlineNs);
+void HostWake(void *waitObj);
+CyBool_t HostInInterrupt(void);
+void HostInterruptEnter(void);
+void HostInterruptExit(void);
+const char *HostThreadName(void);
+void HostPrintThreads(void);
+void HostFatal(const char *fmt, ...);
+uint32_t HostDmaBuffersInUse(uint32_t *numBytes);
+
+/* HostRegs.c: GPIO and SPI register models */
+void HostRegsInit(void);
+void HostRegsUpdate(void);
+void HostRegsDispatchInterrupts(void);
+uint64_t HostRegsNextEventNs(void);
+CyBool_t HostIrqMasked(void);
+int HostPinLevel(uint8_t pin);
+void HostGpioSetCallback(void (*cb)(uint8_t), uint32_t fastClkHz, uint32_t slowClkHz);
+void HostGpioSetSimple(uint8_t pin, uint32_t status);
+void HostGpioSetComplex(uint8_t pin, uint32_t status, uint32_t timer, uint32_t period, uint32_t threshold);
+void HostGpioDisable(uint8_t pin);
+CyBool_t HostGpioIsComplex(uint8_t pin);
+uint32_t HostGpioTimerValue(uint8_t pin);
+void HostGpioSetTimer(uint8_t index, uint32_t value);
+void HostGpioMeasureStart(uint8_t pin, CyBool_t measureHigh);
+CyBool_t HostGpioMeasureResult(uint8_t pin, uint32_t *ticks, uint64_t *doneNs);
+void HostSpiSetConfig(uint32_t config, uint32_t sclkHz);
+uint64_t HostSpiRegisterTransfer(uint8_t *txBuf, uint8_t *rxBuf, uint32_t numBytes);
+CyBool_t HostSpiDmaDone(void);
+void HostSpiDmaAbort(void);
+CyU3PReturnStatus_t HostSpiDmaWait(uint32_t waitMs);
+uint32_t HostSpiStrayEnables(void);
+
+/* HostSdk.c: DMA channels and USB endpoints, for the peripheral models and harness */
+CyU3PDmaChannel *HostDmaProducer(uint16_t socket);
+CyU3PDmaChannel *HostDmaConsumer(uint16_t socket);
+uint32_t HostDmaProduceSpace(CyU3PDmaChannel *ch);
+uint32_t HostDmaProduce(CyU3PDmaChannel *ch, const uint8_t *data, uint32_t numBytes);
+void HostDmaProduceEnd(CyU3PDmaChannel *ch);
+uint32_t HostDmaConsumeAvail(CyU3PDmaChannel *ch);
+uint32_t HostDmaConsume(CyU3PDmaChannel *ch, uint8_t *data, uint32_t numBytes);
+void HostI2cUpdate(void);
+uint64_t HostI2cNextEventNs(void);
+
+/** Data received by the simulated PC on a bulk IN endpoint */
+typedef struct HostUsbInEndpoint
+{
+	uint8_t *Data;
+	uint32_t Bytes;
+	uint32_t Capacity;
+	uint32_t Transfers;
+	/* Length of each transfer, Transfers entries */
+	uint32_t *TransferBytes;
+	uint32_t TransferCapacity;
+	/* The PC is not reading the endpoint, so committed buffers stay in the DMA channel */
+	CyBool_t Paused;
+}HostUsbInEndpoint;
+
+/** Control transfer issued by the simulated PC */
+typedef struct HostControlTransfer
+{
+	CyBool_t Active;
+	CyBool_t Done;
+	CyBool_t Stalled;
+	uint32_t SetupDat0;
+	uint32_t SetupDat1;
+	const uint8_t *OutData;
+	uint16_t OutLength;
+	uint8_t InData[4096];
+	uint16_t InLength;
+}HostControlTransfer;
+
+extern HostUsbInEndpoint HostUsbIn[16];
+extern HostControlTransfer HostEp0;
+CyBool_t HostUsbConnected(void);
+void HostUsbConfigure(CyU3PUSBSpeed_t speed);
+void HostUsbLinkFail(void);
+const CyU3PEpConfig_t *HostUsbEpConfig(uint8_t ep);
+CyBool_t HostUsbSetup(uint32_t setupDat0, uint32_t setupDat1);
+void HostUsbBulkOut(uint8_t ep, const uint8_t *data, uint32_t numBytes);
+void HostUsbInClear(uint8_t ep);
+void HostUsbInPause(uint8_t ep, CyBool_t paused);
+void HostI2cEepromLoad(uint32_t address, const uint8_t *data, uint32_t numBytes);
+
+/* DUT connection (HostDut.c). The pins are FX3 GPIO numbers, and the SPI bits are in wire order, MSB first */
+void HostDutInit(void);
+int HostDutPinLevel(uint8_t pin, uint64_t ns);
+uint64_t HostDutNextEdge(uint8_t pin, uint64_t afterNs);
+void HostDutPinDriven(uint8_t pin, int level, uint64_t ns);
+void HostDutSpiSelect(uint64_t ns);
+void HostDutSpiShift(const uint8_t *mosi, uint8_t *miso, uint32_t numBits, uint64_t startNs, uint32_t sclkHz);
+void HostDutSpiDeselect(uint64_t ns);
+
+/* HostMain.c: the simulated PC, which runs as the highest priority thread */
+void HostPcEntry(uint32_t input);
+
+#endif
@@ -0,0 +1,545 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		HostDut.c
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build iSensor DUT model, connected to the simulated SPI bus and DIO pins.
+ **/
+
+
+/*
+ * The model decodes the iSensor SPI protocol bit by bit, so it works for any SPI word length and chip select mode.
+ * Each 16 bits clocked while chip select is low is one command: {0x80 | addr, data} writes a byte, {addr & 0x7F, x}
+ * reads a word, which the DUT clocks out during the next 16 bits (the next transaction). The register map is 16-bit
+ * words at even byte addresses, with PAGE_ID at 0x00 selecting one of 256 pages. Register values are arbitrary
+ * (written values read back), except for PAGE_ID, the data outputs and the registers defined in HostDut.h.
+ *
+ * IMU parts clock out a burst frame when the first word of a transaction is the burst command: DIAG_STAT, the data
+ * outputs, DATA_CNTR, then a checksum (the 16-bit sum of the frame bytes before it). ADcmXL parts enter real time
+ * mode when GLOB_CMD bit 11 is written, then pulse BUSY high once per frame. A transaction in real time mode clocks
+ * out the newest frame: the data words, then status, DATA_CNTR, 0 and the 16-bit byte sum, in 88, 152 or 200 bytes.
+ *
+ * Data ready is a square wave. Each rising edge is a new sample, which sets DATA_CNTR and the data outputs (see
+ * HostDutSampleWord), so a test can tell from the data which samples the firmware read or missed.
+ *
+ * A transaction which starts less than StallNs after the last one ended is a stall violation. The DUT ignores it
+ * and clocks out all ones. SCLK above the limit is an SCLK violation. Both set the DIAG_STAT SPI error bit, and are
+ * counted in HostDutStats.
+ */
+
+#include <string.h>
+#include "Host.h"
+#include "HostDut.h"
+
+#define HOST_DUT_WORDS_PER_PAGE					(64)
+#define HOST_DUT_MAX_FRAME_BYTES				(256)
+#define HOST_DUT_WRITE_BIT						(0x8000)
+#define HOST_DUT_FIRST_DATA_OUT					(0x04)
+#define HOST_DUT_LAST_DATA_OUT					(0x1E)
+#define HOST_DUT_RT_TRAILER_WORDS				(4)
+
+/** DUT model state */
+typedef struct HostDutState
+{
+	HostDutConfig Config;
+	HostDutStats Stats;
+	uint16_t Regs[HOST_DUT_NUM_PAGES][HOST_DUT_WORDS_PER_PAGE];
+	uint8_t Page;
+	CyBool_t InReset;
+	CyBool_t RealTime;
+
+	/* Data ready: low from DrLowNs, then rising edges at DrStartNs + k * period. DrIdleLevel when stopped */
+	CyBool_t DrRunning;
+	int DrIdleLevel;
+	uint64_t DrLowNs;
+	uint64_t DrStartNs;
+
+	/* Current transaction */
+	CyBool_t Selected;
+	CyBool_t Dropped;
+	CyBool_t SclkFlagged;
+	CyBool_t EverDeselected;
+	uint64_t DeselectNs;
+	uint32_t SclkHz;
+	uint32_t FrameBits;
+	uint32_t SegmentBits;
+	uint16_t InWord;
+	uint16_t OutWord;
+
+	/* Burst or real time frame being clocked out */
+	CyBool_t Burst;
+	CyBool_t RealTimeFrame;
+	uint8_t Frame[HOST_DUT_MAX_FRAME_BYTES];
+	uint32_t FrameBytes;
+}HostDutState;
+
+static HostDutState Dut;
+
+/* ---------------------------------------- Data ready ---------------------------------------- */
+
+static void HostDutStartDr(uint64_t ns)
+{
+	Dut.DrRunning = (CyBool_t) ((Dut.Config.DrPeriodNs != 0) && !Dut.InReset && ((Dut.Config.Type == HostDutImu) || Dut.RealTime));
+	/* IMU data ready idles low. ADcmXL BUSY idles high (ready), and drops while the first frame is captured */
+	Dut.DrIdleLevel = (Dut.Config.Type == HostDutImu) ? 0 : 1;
+	Dut.DrLowNs = ns;
+	Dut.DrStartNs = ns + Dut.Config.DrPeriodNs;
+}
+
+static int HostDutDrLevel(uint64_t ns)
+{
+	if(!Dut.DrRunning || (ns < Dut.DrLowNs))
+		return Dut.DrIdleLevel;
+	if(ns < Dut.DrStartNs)
+		return 0;
+	return (((ns - Dut.DrStartNs) % Dut.Config.DrPeriodNs) < Dut.Config.DrHighNs) ? 1 : 0;
+}
+
+static uint64_t HostDutDrNextEdge(uint64_t afterNs)
+{
+	uint64_t period = Dut.Config.DrPeriodNs, cycles, offset;
+
+	if(!Dut.DrRunning)
+		return HOST_NS_NEVER;
+	if((afterNs < Dut.DrLowNs) && Dut.DrIdleLevel)
+		return Dut.DrLowNs;
+	if(afterNs < Dut.DrStartNs)
+		return Dut.DrStartNs;
+	cycles = (afterNs - Dut.DrStartNs) / period;
+	offset = (afterNs - Dut.DrStartNs) % period;
+	if(offset < Dut.Config.DrHighNs)
+		return Dut.DrStartNs + (cycles * period) + Dut.Config.DrHighNs;
+	return Dut.DrStartNs + ((cycles + 1) * period);
+}
+
+/**
+  * @brief Number of data ready rising edges (samples) up to a time.
+ **/
+uint32_t HostDutSampleCount(uint64_t ns)
+{
+	if(!Dut.DrRunning || (ns < Dut.DrStartNs))
+		return 0;
+	return (uint32_t) (((ns - Dut.DrStartNs) / Dut.Config.DrPeriodNs) + 1);
+}
+
+/**
+  * @brief Value of data output word index for a sample. Burst and real time frames use the same values.
+ **/
+uint16_t HostDutSampleWord(uint32_t sample, uint32_t index)
+{
+	return (uint16_t) (((sample & 0xFFF) << 4) | (index & 0xF));
+}
+
+/* ---------------------------------------- Registers ---------------------------------------- */
+
+static void HostDutReset(uint64_t ns)
+{
+	memset(Dut.Regs, 0, sizeof(Dut.Regs));
+	Dut.Regs[0][HOST_DUT_PROD_ID >> 1] = (Dut.Config.Type == HostDutImu) ? 16465 : (1021 + (1000 * Dut.Config.Type));
+	Dut.Page = 0;
+	Dut.RealTime = CyFalse;
+	Dut.OutWord = 0;
+	HostDutStartDr(ns);
+}
+
+static void HostDutSpiError(void)
+{
+	Dut.Regs[0][HOST_DUT_DIAG_STAT >> 1] |= HOST_DUT_DIAG_SPI_ERROR;
+}
+
+/**
+  * @brief Register value seen over SPI. Reading DIAG_STAT clears it.
+ **/
+static uint16_t HostDutRegister(uint8_t page, uint8_t addr, uint64_t ns, CyBool_t clearOnRead)
+{
+	uint16_t value;
+
+	addr &= 0x7E;
+	if(addr == HOST_DUT_PAGE_ID)
+		return Dut.Page;
+	if(page == 0)
+	{
+		if(addr == HOST_DUT_DIAG_STAT)
+		{
+			value = Dut.Regs[0][addr >> 1];
+			if(clearOnRead)
+				Dut.Regs[0][addr >> 1] = 0;
+			return value;
+		}
+		if(addr == HOST_DUT_DATA_CNTR)
+			return (uint16_t) HostDutSampleCount(ns);
+		if((Dut.Config.Type == HostDutImu) && (addr >= HOST_DUT_FIRST_DATA_OUT) && (addr <= HOST_DUT_LAST_DATA_OUT))
+			return HostDutSampleWord(HostDutSampleCount(ns), (addr - HOST_DUT_FIRST_DATA_OUT) >> 1);
+	}
+	return Dut.Regs[page][addr >> 1];
+}
+
+static void HostDutWriteByte(uint8_t addr, uint8_t data, uint64_t ns)
+{
+	uint16_t *reg;
+
+	if(addr == HOST_DUT_PAGE_ID)
+	{
+		Dut.Page = data;
+		return;
+	}
+	if(addr == (HOST_DUT_PAGE_ID + 1))
+		return;
+
+	reg = &Dut.Regs[Dut.Page][addr >> 1];
+	if(addr & 1)
+		*reg = (uint16_t) ((*reg & 0x00FF) | (data << 8));
+	else
+		*reg = (uint16_t) ((*reg & 0xFF00) | data);
+
+	/* GLOB_CMD is a command register: act on the high byte write, and do not keep the bits */
+	if((Dut.Page == 0) && (addr == (HOST_DUT_GLOB_CMD + 1)))
+	{
+		if((Dut.Config.Type != HostDutImu) && ((data << 8) & HOST_DUT_GLOB_CMD_RT_START) && !Dut.RealTime)
+		{
+			Dut.RealTime = CyTrue;
+			HostDutStartDr(ns);
+		}
+		*reg = 0;
+	}
+}
+
+uint16_t HostDutReadReg(uint8_t page, uint8_t addr)
+{
+	return HostDutRegister(page, addr, HostSimNs, CyFalse);
+}
+
+void HostDutWriteReg(uint8_t page, uint8_t addr, uint16_t value)
+{
+	if((addr & 0x7E) == HOST_DUT_PAGE_ID)
+		Dut.Page = (uint8_t) value;
+	else
+		Dut.Regs[page][(addr & 0x7E) >> 1] = value;
+}
+
+/* ---------------------------------------- Frames ---------------------------------------- */
+
+static void HostDutFramePut(uint32_t word, uint16_t value)
+{
+	Dut.Frame[2 * word] = (uint8_t) (value >> 8);
+	Dut.Frame[(2 * word) + 1] = (uint8_t) value;
+}
+
+static uint16_t HostDutFrameSum(uint32_t numBytes)
+{
+	uint32_t i;
+	uint16_t sum = 0;
+
+	for(i = 0; i < numBytes; i++)
+		sum += Dut.Frame[i];
+	return sum;
+}
+
+uint32_t HostDutFrameBytes(HostDutType type)
+{
+	switch(type)
+	{
+	case HostDutADcmXL1021:
+		return 88;
+	case HostDutADcmXL2021:
+		return 152;
+	case HostDutADcmXL3021:
+		return 200;
+	default:
+		return 0;
+	}
+}
+
+static void HostDutBuildBurst(uint64_t ns)
+{
+	uint32_t numWords = Dut.Config.BurstWords, sample = HostDutSampleCount(ns), word;
+
+	if(numWords > (HOST_DUT_MAX_FRAME_BYTES / 2))
+		numWords = HOST_DUT_MAX_FRAME_BYTES / 2;
+	Dut.FrameBytes = 2 * numWords;
+	for(word = 0; word < numWords; word++)
+	{
+		if(word == 0)
+			HostDutFramePut(word, HostDutRegister(0, HOST_DUT_DIAG_STAT, ns, CyTrue));
+		else if(word == (numWords - 2))
+			HostDutFramePut(word, (uint16_t) sample);
+		else if(word == (numWords - 1))
+			HostDutFramePut(word, HostDutFrameSum(2 * word));
+		else
+			HostDutFramePut(word, HostDutSampleWord(sample, word - 1));
+	}
+	Dut.Burst = CyTrue;
+	Dut.Stats.Bursts++;
+}
+
+static void HostDutBuildRealTime(uint64_t ns)
+{
+	uint32_t numWords = HostDutFrameBytes(Dut.Config.Type) / 2, frame = HostDutSampleCount(ns), word;
+
+	Dut.FrameBytes = 2 * numWords;
+	for(word = 0; word < numWords - HOST_DUT_RT_TRAILER_WORDS; word++)
+	{
+		HostDutFramePut(word, HostDutSampleWord(frame, word));
+	}
+	HostDutFramePut(word++, HostDutRegister(0, HOST_DUT_DIAG_STAT, ns, CyTrue));
+	HostDutFramePut(word++, (uint16_t) frame);
+	HostDutFramePut(word++, 0);
+	HostDutFramePut(word, HostDutFrameSum(2 * word));
+	Dut.RealTimeFrame = CyTrue;
+}
+
+/* ---------------------------------------- SPI ---------------------------------------- */
+
+static void HostDutCheckSclk(void)
+{
+	uint32_t maxHz = Dut.Burst ? Dut.Config.BurstMaxSclkHz : Dut.Config.MaxSclkHz;
+
+	if(Dut.SclkHz > Dut.Stats.MaxSclkHz)
+		Dut.Stats.MaxSclkHz = Dut.SclkHz;
+	if((Dut.SclkHz > maxHz) && !Dut.SclkFlagged)
+	{
+		/* Counted once per transaction */
+		Dut.SclkFlagged = CyTrue;
+		Dut.Stats.SclkViolations++;
+		HostDutSpiError();
+	}
+}
+
+/**
+  * @brief Runs one 16-bit command, clocked in by the time given.
+ **/
+static void HostDutCommand(uint16_t cmd, uint64_t ns)
+{
+	if((Dut.FrameBits == 16) && (Dut.Config.Type == HostDutImu) && Dut.Config.BurstCmd && (cmd == Dut.Config.BurstCmd))
+	{
+		HostDutBuildBurst(ns);
+		HostDutCheckSclk();
+		return;
+	}
+
+	if(cmd & HOST_DUT_WRITE_BIT)
+	{
+		Dut.Stats.Writes++;
+		HostDutWriteByte((cmd >> 8) & 0x7F, cmd & 0xFF, ns);
+		Dut.OutWord = 0;
+	}
+	else
+	{
+		Dut.Stats.Reads++;
+		Dut.OutWord = HostDutRegister(Dut.Page, (cmd >> 8) & 0x7F, ns, CyTrue);
+	}
+}
+
+static uint32_t HostDutOutBit(void)
+{
+	uint32_t pos;
+
+	if(Dut.Dropped)
+		return 1;
+	if(Dut.RealTimeFrame)
+		pos = Dut.FrameBits;
+	else if(Dut.Burst)
+		pos = Dut.FrameBits - 16;
+	else
+		return (Dut.OutWord >> (15 - Dut.SegmentBits)) & 1;
+	if(pos >= (Dut.FrameBytes * 8))
+		return 0;
+	return (Dut.Frame[pos / 8] >> (7 - (pos % 8))) & 1;
+}
+
+void HostDutSpiSelect(uint64_t ns)
+{
+	uint64_t stall;
+
+	Dut.Selected = CyTrue;
+	Dut.Dropped = CyFalse;
+	Dut.SclkFlagged = CyFalse;
+	Dut.Burst = CyFalse;
+	Dut.RealTimeFrame = CyFalse;
+	Dut.FrameBits = 0;
+	Dut.SegmentBits = 0;
+	Dut.Stats.Transactions++;
+
+	if(Dut.EverDeselected)
+	{
+		stall = ns - Dut.DeselectNs;
+		if(stall < Dut.Stats.MinStallNs)
+			Dut.Stats.MinStallNs = stall;
+		if(stall < Dut.Config.StallNs)
+		{
+			Dut.Stats.StallViolations++;
+			HostDutSpiError();
+			Dut.Dropped = CyTrue;
+		}
+	}
+	if(Dut.InReset)
+		Dut.Dropped = CyTrue;
+
+	if(!Dut.Dropped && Dut.RealTime)
+		HostDutBuildRealTime(ns);
+}
+
+void HostDutSpiShift(const uint8_t *mosi, uint8_t *miso, uint32_t numBits, uint64_t startNs, uint32_t sclkHz)
+{
+	uint64_t bitNs = (1000000000ull + sclkHz - 1) / sclkHz;
+	uint32_t bit;
+
+	memset(miso, 0, (numBits + 7) / 8);
+	if(!Dut.Selected)
+		return;
+
+	Dut.SclkHz = sclkHz;
+	HostDutCheckSclk();
+
+	for(bit = 0; bit < numBits; bit++)
+	{
+		if(HostDutOutBit())
+			miso[bit / 8] |= (uint8_t) (0x80 >> (bit % 8));
+		Dut.InWord = (uint16_t) ((Dut.InWord << 1) | ((mosi[bit / 8] >> (7 - (bit % 8))) & 1));
+		Dut.FrameBits++;
+		if(Dut.Dropped || Dut.Burst || Dut.RealTimeFrame)
+			continue;
+		Dut.SegmentBits++;
+		if(Dut.SegmentBits == 16)
+		{
+			Dut.SegmentBits = 0;
+			HostDutCommand(Dut.InWord, startNs + ((bit + 1) * bitNs));
+		}
+	}
+}
+
+void HostDutSpiDeselect(uint64_t ns)
+{
+	if(!Dut.Selected)
+		return;
+	if(Dut.RealTimeFrame && (Dut.FrameBits >= (Dut.FrameBytes * 8)))
+		Dut.Stats.RealTimeFrames++;
+	if(Dut.Burst)
+		Dut.OutWord = 0;
+	Dut.Selected = CyFalse;
+	Dut.Burst = CyFalse;
+	Dut.RealTimeFrame = CyFalse;
+	Dut.EverDeselected = CyTrue;
+	Dut.DeselectNs = ns;
+}
+
+/* ---------------------------------------- Pins ---------------------------------------- */
+
+/**
+  * @brief Level the DUT drives on an FX3 pin, or HOST_PIN_Z.
+ **/
+int HostDutPinLevel(uint8_t pin, uint64_t ns)
+{
+	if(pin == Dut.Config.DrPin)
+		return HostDutDrLevel(ns);
+	if(Dut.Config.EventPin && (pin == Dut.Config.EventPin))
+		return (ns >= Dut.Config.EventNs) ? 1 : 0;
+	return HOST_PIN_Z;
+}
+
+/**
+  * @brief Time of the first DUT pin change after a time, or HOST_NS_NEVER.
+ **/
+uint64_t HostDutNextEdge(uint8_t pin, uint64_t afterNs)
+{
+	if(pin == Dut.Config.DrPin)
+		return HostDutDrNextEdge(afterNs);
+	if(Dut.Config.EventPin && (pin == Dut.Config.EventPin) && (afterNs < Dut.Config.EventNs))
+		return Dut.Config.EventNs;
+	return HOST_NS_NEVER;
+}
+
+/**
+  * @brief Called when the FX3 starts or stops driving a pin (level HOST_PIN_Z when released). RESET low holds
+  * the DUT in reset. RESET has a pull up in the DUT, so releasing it also ends the reset.
+ **/
+void HostDutPinDriven(uint8_t pin, int level, uint64_t ns)
+{
+	if(pin != HOST_DUT_PIN_RESET)
+		return;
+	if((level == 0) && !Dut.InReset)
+	{
+		Dut.InReset = CyTrue;
+		HostDutReset(ns);
+	}
+	else if((level != 0) && Dut.InReset)
+	{
+		Dut.InReset = CyFalse;
+		HostDutStartDr(ns);
+	}
+}
+
+/* ---------------------------------------- Configuration ---------------------------------------- */
+
+/**
+  * @brief Model settings for a part. Typical datasheet limits; check the datasheet of the part being tuned for.
+ **/
+void HostDutDefaults(HostDutConfig *config, HostDutType type)
+{
+	memset(config, 0, sizeof(HostDutConfig));
+	config->Type = type;
+	if(type == HostDutImu)
+	{
+		/* ADIS1646x: 2kHz data ready on DIO1, 16us stall, 2MHz SCLK, 1MHz SCLK for burst reads */
+		config->DrPin = HOST_DUT_PIN_DIO1;
+		config->DrPeriodNs = 500000;
+		config->DrHighNs = 250000;
+		config->StallNs = 16000;
+		config->MaxSclkHz = 2000000;
+		config->BurstMaxSclkHz = 1000000;
+		config->BurstCmd = 0x6800;
+		config->BurstWords = 10;
+	}
+	else
+	{
+		/* ADcmXL real time mode: BUSY on DIO2, 32 samples per axis per frame at 220kSPS */
+		config->DrPin = HOST_DUT_PIN_DIO2;
+		config->DrPeriodNs = 145455;
+		config->DrHighNs = 10000;
+		config->StallNs = 15000;
+		config->MaxSclkHz = 14000000;
+		config->BurstMaxSclkHz = 14000000;
+	}
+}
+
+/**
+  * @brief Replaces the DUT with a new one (power on state), and clears the statistics. Data ready starts now.
+ **/
+void HostDutConfigure(const HostDutConfig *config)
+{
+	/* Latch the pin edges of the old DUT first */
+	HostRegsUpdate();
+	Dut.Config = *config;
+	Dut.InReset = CyFalse;
+	Dut.Selected = CyFalse;
+	Dut.EverDeselected = CyFalse;
+	HostDutReset(HostSimNs);
+	HostDutClearStats();
+}
+
+const HostDutStats *HostDutGetStats(void)
+{
+	return &Dut.Stats;
+}
+
+void HostDutClearStats(void)
+{
+	memset(&Dut.Stats, 0, sizeof(Dut.Stats));
+	Dut.Stats.MinStallNs = HOST_NS_NEVER;
+}
+
+void HostDutInit(void)
+{
+	HostDutDefaults(&Dut.Config, HostDutImu);
+	HostDutReset(0);
+	HostDutClearStats();
+}
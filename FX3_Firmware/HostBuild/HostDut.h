@@ -0,0 +1,113 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		HostDut.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Simulated iSensor DUT for the host build: configuration, register access and bus statistics for the harness.
+ **/
+
+
+#ifndef HOST_DUT_H
+#define HOST_DUT_H
+
+#include "cyu3types.h"
+
+/* DUT pins on the iSensor FX3 rev C board (FX3 GPIO numbers) */
+#define HOST_DUT_PIN_RESET						(1)
+#define HOST_DUT_PIN_DIO1						(5)
+#define HOST_DUT_PIN_DIO2						(4)
+
+/* Register map. 16-bit words at even byte addresses, 128 byte addresses per page */
+#define HOST_DUT_NUM_PAGES						(256)
+#define HOST_DUT_PAGE_ID						(0x00)
+#define HOST_DUT_DIAG_STAT						(0x02)
+#define HOST_DUT_DATA_CNTR						(0x22)
+#define HOST_DUT_GLOB_CMD						(0x3E)
+#define HOST_DUT_PROD_ID						(0x72)
+
+/* DIAG_STAT SPI communication error bit (SCLK or stall violation). Cleared when DIAG_STAT is read */
+#define HOST_DUT_DIAG_SPI_ERROR					(1 << 3)
+
+/* GLOB_CMD bit which starts ADcmXL real time mode */
+#define HOST_DUT_GLOB_CMD_RT_START				(1 << 11)
+
+/** Simulated part families. The ADcmXL values match PartType in main.h */
+typedef enum HostDutType
+{
+	HostDutADcmXL1021 = 0,
+	HostDutADcmXL2021,
+	HostDutADcmXL3021,
+	HostDutImu
+}HostDutType;
+
+/** DUT model settings. Get the defaults for a part with HostDutDefaults, then change what the test needs */
+typedef struct HostDutConfig
+{
+	/** Part family. Sets the real time frame size for ADcmXL parts */
+	HostDutType Type;
+
+	/** FX3 GPIO driven with the data ready (IMU) or BUSY (ADcmXL) square wave */
+	uint8_t DrPin;
+
+	/** Data ready period in ns. 0 turns data ready off. Each rising edge is a new sample */
+	uint64_t DrPeriodNs;
+
+	/** Data ready high time in ns */
+	uint64_t DrHighNs;
+
+	/** Minimum chip select high time between SPI transactions, in ns */
+	uint64_t StallNs;
+
+	/** Maximum SCLK for register access */
+	uint32_t MaxSclkHz;
+
+	/** Maximum SCLK for burst reads */
+	uint32_t BurstMaxSclkHz;
+
+	/** Burst read command (IMU). 0 turns burst reads off */
+	uint16_t BurstCmd;
+
+	/** Number of 16-bit words clocked out after the burst command */
+	uint32_t BurstWords;
+
+	/** FX3 GPIO driven low, then high from EventNs on (an alarm or sync output). 0 turns the event pin off */
+	uint8_t EventPin;
+
+	/** Time of the event pin rising edge, in ns */
+	uint64_t EventNs;
+}HostDutConfig;
+
+/** DUT bus activity since the last HostDutConfigure or HostDutClearStats */
+typedef struct HostDutStats
+{
+	uint32_t Transactions;
+	uint32_t Reads;
+	uint32_t Writes;
+	uint32_t Bursts;
+	uint32_t RealTimeFrames;
+	uint32_t StallViolations;
+	uint32_t SclkViolations;
+	uint64_t MinStallNs;
+	uint32_t MaxSclkHz;
+}HostDutStats;
+
+void HostDutDefaults(HostDutConfig *config, HostDutType type);
+void HostDutConfigure(const HostDutConfig *config);
+uint32_t HostDutFrameBytes(HostDutType type);
+uint32_t HostDutSampleCount(uint64_t ns);
+uint16_t HostDutSampleWord(uint32_t sample, uint32_t index);
+uint16_t HostDutReadReg(uint8_t page, uint8_t addr);
+void HostDutWriteReg(uint8_t page, uint8_t addr, uint16_t value);
+const HostDutStats *HostDutGetStats(void);
+void HostDutClearStats(void);
+
+#endif
@@ -0,0 +1,2737 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		HostMain.c
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build entry point, and the simulated PC which runs vendor requests against the firmware.
+ **/
+
+/*
+ * The simulated PC is the highest priority thread. It enumerates the device, then runs each check in turn through
+ * the firmware's own control endpoint handler, the same as the PC driver would. The firmware output is printed with
+ * -v. The process exits with status 1 if any check failed.
+ *
+ * With -bench <file>, the simulated PC runs the stream worker benchmark instead of the checks, and writes one CSV row
+ * per worker, register list length and clock. The firmware must be built with STREAM_PROFILE_MODE (make bench).
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Host.h"
+#include "HostDut.h"
+#include "cyu3os.h"
+
+/* Vendor request codes used by the checks (main.h) */
+#define HOST_I2C_SET_BIT_RATE					(0x10)
+#define HOST_I2C_READ_STREAM					(0x13)
+#define HOST_FIRMWARE_ID_CHECK					(0xB0)
+#define HOST_SET_SPI_CONFIG						(0xB2)
+#define HOST_READ_SPI_CONFIG					(0xB3)
+#define HOST_GET_STATUS							(0xB4)
+#define HOST_SET_DUT_SUPPLY						(0xB7)
+#define HOST_GET_BOARD_TYPE						(0xBA)
+#define HOST_GET_STREAM_PROFILE					(0xBB)
+#define HOST_GET_DR_LATENCY						(0xBC)
+#define HOST_GET_STREAM_STATS					(0xBD)
+#define HOST_RUN_SPI_SCRIPT						(0xBE)
+#define HOST_READ_REG_LIST						(0xBF)
+#define HOST_STREAM_GENERIC_DATA				(0xC0)
+#define HOST_STREAM_BURST_DATA					(0xC1)
+#define HOST_SPI_PIPE							(0xC2)
+#define HOST_READ_TIMER_VALUE					(0xC4)
+#define HOST_PULSE_DRIVE						(0xC5)
+#define HOST_TRANSFER_STREAM					(0xCC)
+#define HOST_STREAM_REALTIME					(0xD0)
+#define HOST_TRIGGER_CAPTURE					(0xD3)
+#define HOST_LOGIC_ANALYZER_STREAM				(0xD4)
+#define HOST_MEASURE_DR_PERIODS					(0xD5)
+#define HOST_COMMAND_CONTROL					(0xD6)
+#define HOST_READ_TRACE							(0xD7)
+#define HOST_READ_DEBUG_LOG						(0xD8)
+#define HOST_GET_CPU_LOAD						(0xD9)
+#define HOST_READ_BYTES							(0xF0)
+#define HOST_WRITE_BYTE							(0xF1)
+
+/* ADI_SET_SPI_CONFIG indexes (AdiSpiUpdate) */
+#define HOST_SPI_CONFIG_SCLK					(0)
+#define HOST_SPI_CONFIG_STALL					(9)
+#define HOST_SPI_CONFIG_DUT_TYPE				(10)
+#define HOST_SPI_CONFIG_DR_POLARITY				(11)
+#define HOST_SPI_CONFIG_DR_ACTIVE				(12)
+#define HOST_SPI_CONFIG_DR_PIN					(13)
+#define HOST_SPI_CONFIG_DR_INTERRUPT			(16)
+#define HOST_SPI_CONFIG_TIMESTAMPS				(17)
+#define HOST_SPI_CONFIG_FRAME_MODE				(18)
+#define HOST_SPI_CONFIG_PAGE_CACHE				(19)
+#define HOST_SPI_CONFIG_BUFFER_PACKETS			(20)
+#define HOST_SPI_CONFIG_OVERFLOW_POLICY			(21)
+#define HOST_SPI_CONFIG_OVERFLOW_WAIT			(22)
+
+/* ADI_SET_DUT_SUPPLY setting (DutVoltage) */
+#define HOST_DUT_SUPPLY_3_3V					(1)
+
+/* Stream start, done and stop (StreamFunctions.h) */
+#define HOST_STREAM_DONE_CMD					(0)
+#define HOST_STREAM_START_CMD					(1)
+#define HOST_STREAM_STOP_CMD					(2)
+
+/* Stream frame headers (StreamFunctions.h) */
+#define HOST_STREAM_FRAME_OFF					(0)
+#define HOST_STREAM_FRAME_CRC					(2)
+#define HOST_STREAM_FRAME_HEADER_BYTES			(16)
+#define HOST_STREAM_FRAME_SYNC					(0xA55A)
+#define HOST_STREAM_FRAME_TYPE_BURST			(3)
+#define HOST_STREAM_FRAME_FLAG_CRC				(1 << 3)
+#define HOST_STREAM_FRAME_FLAG_LAST				(1 << 4)
+#define HOST_STREAM_FRAME_FLAG_GAP				(1 << 5)
+
+/* Stream overflow policies, and the overflow counters in the stream stats */
+#define HOST_STREAM_OVERFLOW_BLOCK				(0)
+#define HOST_STREAM_OVERFLOW_DROP_NEWEST		(1)
+#define HOST_STREAM_OVERFLOW_DROP_OLDEST		(2)
+#define HOST_STREAM_STATS_LENGTH				(132)
+#define HOST_STREAM_STATS_ACTIVE				(8)
+#define HOST_STREAM_STATS_SAMPLES				(12)
+#define HOST_STREAM_STATS_MISSED_DR				(28)
+#define HOST_STREAM_STATS_OVERFLOWS				(112)
+#define HOST_STREAM_STATS_DROPPED_SAMPLES		(120)
+#define HOST_STREAM_STATS_GAP_START				(124)
+#define HOST_STREAM_STATS_GAP_SAMPLES			(128)
+
+/* Bulk command channel record sizes and opcodes (BulkCommands.h) */
+#define HOST_BULK_CMD_RECORD_SIZE				(8)
+#define HOST_BULK_CMD_HEADER_SIZE				(8)
+#define HOST_BULK_CMD_END						(0x00)
+#define HOST_BULK_CMD_READ_REG					(0x01)
+#define HOST_BULK_CMD_WRITE_REG					(0x02)
+#define HOST_BULK_CMD_DELAY						(0x05)
+
+/* ADI_SPI_PIPE status index and response length (StreamFunctions.h) */
+#define HOST_SPI_PIPE_STATUS_CMD				(3)
+#define HOST_SPI_PIPE_STATUS_LENGTH				(12)
+
+/* ADI_TRIGGER_CAPTURE indexes and trigger sources (StreamFunctions.h) */
+#define HOST_CAPTURE_CONFIG_CMD					(0)
+#define HOST_CAPTURE_TRIGGER_CMD				(1)
+#define HOST_CAPTURE_STATUS_CMD					(2)
+#define HOST_CAPTURE_TRIGGER_HOST				(0)
+#define HOST_CAPTURE_TRIGGER_PIN				(1)
+#define HOST_CAPTURE_TRIGGER_THRESHOLD			(2)
+#define HOST_CAPTURE_STATE_OFF					(0)
+#define HOST_CAPTURE_STATE_DONE					(3)
+
+/* Capture trigger test: ring size, and the number of samples before the trigger (the ring wraps several times) */
+#define HOST_CAPTURE_PRE_SAMPLES				(8)
+#define HOST_CAPTURE_POST_SAMPLES				(6)
+#define HOST_CAPTURE_TRIGGER_SAMPLES			(60)
+
+/* USB endpoints (main.h) */
+#define HOST_FROM_PC_ENDPOINT					(0x01)
+#define HOST_STREAMING_ENDPOINT					(0x81)
+#define HOST_TO_PC_ENDPOINT						(0x82)
+
+/* High speed streaming endpoint buffer, one USB packet */
+#define HOST_STREAM_BUFFER_BYTES				(512)
+
+/* Longest register list read, in bytes (SpiFunctions.h), filling BulkBuffer with the 4 byte status */
+#define HOST_REG_LIST_MAX_LENGTH				(12288 - 4)
+
+/* Firmware stall time used outside of the stall checks (main.c default) */
+#define HOST_DEFAULT_STALL_US					(25)
+
+/* Burst read checked: 2 trigger bytes, then the 10 word IMU burst frame */
+#define HOST_BURST_BYTES						(22)
+#define HOST_NUM_BURSTS							(32)
+
+/* Overflow policy stream: 200ms of IMU samples, with the PC not reading for 150ms after the first two frames */
+#define HOST_OVERFLOW_BURSTS					(400)
+#define HOST_OVERFLOW_PAUSE_MS					(150)
+#define HOST_OVERFLOW_WAIT_MS					(10)
+
+#define HOST_NUM_RT_FRAMES						(16)
+
+/* Interrupt mode burst stream: bursts, and the data ready period (the 176us burst, the DUT stall and a little margin) */
+#define HOST_ISR_BURSTS							(500)
+#define HOST_ISR_DR_PERIOD_NS					(200000)
+#define HOST_ISR_OVER_RATE_NS					(123457)
+#define HOST_ISR_GENERIC_SAMPLES				(20)
+
+/* Interrupt mode generic stream: one USB buffer of {DATA_CNTR, PROD_ID} samples, and the data ready wait poll time */
+#define HOST_DR_WAIT_SAMPLES					(128)
+#define HOST_DR_INTERRUPT_POLL_MS				(10)
+
+/* Time stamped streams: samples of 8 time stamp bytes and 4 data bytes (the burst frame for burst streams), and the
+ * stream timer (ADI_TIMER_PIN_INDEX) start value, which rolls over about 10ms in */
+#define HOST_TIMESTAMP_SAMPLES					(40)
+#define HOST_TIMESTAMP_BYTES					(8)
+#define HOST_TIMESTAMP_DATA_BYTES				(4)
+#define HOST_TIMESTAMP_TIMER_INDEX				(0)
+#define HOST_TIMESTAMP_TIMER_START				(0xFFFFFFFF - 100000)
+#define HOST_TIMESTAMP_MAX_JITTER_TICKS			(5)
+
+/* Multi packet stream buffers. Neither sample size divides the 1KB USB buffers, and neither sample count fills the
+ * last buffer */
+#define HOST_EXACT_BUFFER_PACKETS				(2)
+#define HOST_EXACT_GENERIC_SAMPLES				(200)
+#define HOST_EXACT_GENERIC_WORDS				(7)
+#define HOST_EXACT_BURSTS						(80)
+
+/* Trace ring (TRACE_MODE builds): a read, then a short generic stream, must be traced event by event */
+#define HOST_TRACE_CLEAR						(1 << 0)
+#define HOST_TRACE_HEADER_BYTES					(16)
+#define HOST_TRACE_RECORD_BYTES					(16)
+#define HOST_TRACE_SAMPLES						(4)
+#define HOST_TRACE_VENDOR_REQUEST				(1)
+#define HOST_TRACE_DR_WAIT_START				(3)
+#define HOST_TRACE_SAMPLE_READY					(4)
+#define HOST_TRACE_USB_COMMIT					(7)
+#define HOST_TRACE_STREAM_START					(10)
+#define HOST_TRACE_COMMAND_START				(12)
+#define HOST_TRACE_COMMAND_DONE					(13)
+
+/* Debug log (ADI_READ_DEBUG_LOG): header, then up to 128 records of uptime, format ID, argument count and 5 arguments */
+#define HOST_LOG_HEADER_BYTES					(16)
+#define HOST_LOG_RECORD_BYTES					(32)
+#define HOST_LOG_RECORDS						(128)
+#define HOST_LOG_MAX_ARGS						(5)
+
+/* CPU load (CPU_LOAD_MODE builds): response layout, context indexes, idle and stream windows */
+#define HOST_CPU_LOAD_CLEAR						(1 << 0)
+#define HOST_CPU_LOAD_LENGTH					(44)
+#define HOST_CPU_LOAD_CONTEXTS					(6)
+#define HOST_CPU_CONTEXT_IDLE					(0)
+#define HOST_CPU_CONTEXT_STREAM					(2)
+#define HOST_CPU_LOAD_WINDOW_MS					(500)
+#define HOST_CPU_LOAD_SAMPLES					(500)
+
+/* Stream restarts: rounds of starting and stopping each benchmarked stream type, with 4 word samples at 1MHz */
+#define HOST_RESTART_ROUNDS						(200)
+#define HOST_RESTART_LIST_WORDS					(4)
+#define HOST_RESTART_CLOCK_HZ					(1000000)
+#define HOST_RESTART_STOP_MS					(100)
+
+/* SuperSpeed connect: the burst stream runs over several full endpoint burst DMA buffers */
+#define HOST_SPEED_BURSTS						(512)
+#define HOST_SPEED_SS_PACKET_BYTES				(1024)
+#define HOST_SPEED_HS_PACKET_BYTES				(512)
+#define HOST_SPEED_ENDPOINT_BURST				(8)
+#define HOST_SPEED_BUFFER_PACKETS				(8)
+#define HOST_SPEED_MIN_BUFFERS					(2)
+
+/* Logic analyzer stream: 1us samples of a 2kHz data ready with a 100us high time, for about 10 periods */
+#define HOST_LOGIC_PERIOD_TICKS					(10)
+#define HOST_LOGIC_SAMPLES						(5040)
+#define HOST_LOGIC_DR_HIGH_NS					(100000)
+#define HOST_LOGIC_RECORD_BYTES					(4)
+
+/* Period capture: request and transfer layout, and the allowed time stamp error (about one polling loop) */
+#define HOST_PERIOD_OPTION_STREAM				(1 << 0)
+#define HOST_PERIOD_XFER_LAST					(1 << 0)
+#define HOST_PERIOD_HEADER_BYTES				(12)
+#define HOST_PERIOD_HIST_BINS					(32)
+#define HOST_PERIOD_SUMMARY_BYTES				(36 + (4 * HOST_PERIOD_HIST_BINS))
+#define HOST_PERIOD_BIN_WIDTH					(2)
+#define HOST_PERIOD_MAX_ERROR_TICKS				(12)
+
+#define HOST_PIPE_BYTES							(64)
+
+/* Page cache check: repeated PAGE_ID writes, and the DUT reset pulse length in timer ticks (10us) */
+#define HOST_PAGE_WRITES						(8)
+#define HOST_RESET_PULSE_TICKS					(101)
+
+/* Generic stream page cache check: samples and register list captures per sample, filling HOST_STREAM_BUFFER_BYTES */
+#define HOST_PAGE_STREAM_SAMPLES				(32)
+#define HOST_PAGE_STREAM_CAPTURES				(2)
+
+/* SPI script stall check: ADI_SCRIPT_MAX_STALL_US, the command cancel action, and the time before the cancel */
+#define HOST_SCRIPT_MAX_STALL_US				(1000000)
+#define HOST_COMMAND_CANCEL						(1)
+#define HOST_SCRIPT_CANCEL_MS					(10)
+
+/* Serialized SPI check: list length, list reads, and a page 0 register which is not a data output */
+#define HOST_SERIAL_LIST_REGS					(64)
+#define HOST_SERIAL_LISTS						(16)
+#define HOST_SERIAL_REG							(0x40)
+
+/* Reconnect check: SET_CONFIGURATION events sent while the command worker reads a register list */
+#define HOST_RECONNECTS							(3)
+
+/* Benchmark: samples per run, the profile poll interval, the time with no stream data which ends a run, and
+ * the stream profile layout */
+#define HOST_BENCH_SAMPLES						(200)
+#define HOST_BENCH_POLL_MS						(5)
+#define HOST_BENCH_IDLE_MS						(20)
+#define HOST_BENCH_MAX_SCLK_HZ					(15000000)
+#define HOST_PROFILE_LENGTH						(76)
+#define HOST_PROFILE_DR_WAIT					(1)
+#define HOST_PROFILE_TRANSFER					(2)
+#define HOST_PROFILE_STALL						(3)
+#define HOST_PROFILE_DMA						(4)
+#define HOST_PROFILE_NUM_PHASES					(5)
+
+/* Expected firmware settings */
+#define HOST_BOARD_REV_C						(3)
+#define HOST_TIMER_HZ							(10078400)
+
+/* bmRequestType for vendor requests to the device */
+#define HOST_VENDOR_OUT							(0x40)
+#define HOST_VENDOR_IN							(0xC0)
+
+int AdiFirmwareMain(void);
+
+CyBool_t HostVerbose;
+
+/** Set by the -bench option. The benchmark CSV file */
+static const char *BenchFile;
+
+static uint32_t Checks;
+static uint32_t Failures;
+
+static void HostCheck(CyBool_t pass, const char *fmt, ...)
+{
+	va_list args;
+
+	Checks++;
+	if(!pass)
+		Failures++;
+	printf("%10.3f ms  %s  ", HostSimNs / 1e6, pass ? "PASS" : "FAIL");
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+	printf("\n");
+}
+
+static uint32_t HostU32(const uint8_t *buf)
+{
+	return buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t) buf[3] << 24);
+}
+
+static uint16_t HostU16(const uint8_t *buf)
+{
+	return (uint16_t) (buf[0] | (buf[1] << 8));
+}
+
+/**
+  * @brief Runs a vendor request with an IN data stage. The data is in HostEp0.InData.
+ **/
+static CyBool_t HostVendorIn(uint8_t request, uint16_t value, uint16_t index, uint16_t length)
+{
+	return HostUsbSetup(HOST_VENDOR_IN | (request << 8) | ((uint32_t) value << 16), index | ((uint32_t) length << 16));
+}
+
+/**
+  * @brief Runs a vendor request with an OUT data stage (or no data stage).
+ **/
+static CyBool_t HostVendorOut(uint8_t request, uint16_t value, uint16_t index, const uint8_t *data, uint16_t length)
+{
+	HostEp0.OutData = data;
+	HostEp0.OutLength = length;
+	return HostUsbSetup(HOST_VENDOR_OUT | (request << 8) | ((uint32_t) value << 16), index | ((uint32_t) length << 16));
+}
+
+/**
+  * @brief Waits for the firmware to send a number of bytes on a bulk IN endpoint.
+ **/
+static CyBool_t HostBulkWait(uint8_t ep, uint32_t numBytes, uint32_t waitMs)
+{
+	uint64_t deadline = HostDeadline(waitMs);
+
+	while(HostUsbIn[ep & 0xF].Bytes < numBytes)
+	{
+		if(!HostWait(&HostUsbIn[ep & 0xF], deadline))
+			return CyFalse;
+	}
+	return CyTrue;
+}
+
+static void HostCheckBoot(void)
+{
+	char id[33];
+	CyBool_t ok;
+
+	ok = HostVendorIn(HOST_FIRMWARE_ID_CHECK, 0, 0, 32);
+	memcpy(id, HostEp0.InData, 32);
+	id[32] = 0;
+	HostCheck(ok && (HostEp0.InLength == 32) && (id[0] != 0), "firmware ID \"%s\"", id);
+
+	ok = HostVendorIn(HOST_GET_STATUS, 0, 0, 5);
+	HostCheck(ok && (HostU32(HostEp0.InData) == CY_U3P_SUCCESS), "status 0x%x, verbose mode %d", HostU32(HostEp0.InData),
+			HostEp0.InData[4]);
+
+	ok = HostVendorIn(HOST_GET_BOARD_TYPE, 0, 0, 22);
+	HostCheck(ok && (HostU32(HostEp0.InData) == HOST_BOARD_REV_C) && (HostU16(HostEp0.InData + 4) == 1),
+			"board type %u (rev C), reset pin %u, DIO1 pin %u", HostU32(HostEp0.InData), HostU16(HostEp0.InData + 4),
+			HostU16(HostEp0.InData + 6));
+
+	ok = HostVendorIn(HOST_READ_SPI_CONFIG, 0, 0, 23);
+	HostCheck(ok && (HostU32(HostEp0.InData + 19) == HOST_TIMER_HZ), "SPI clock %u Hz, stall %u us, timer %u ticks/s",
+			HostU32(HostEp0.InData), HostU16(HostEp0.InData + 12), HostU32(HostEp0.InData + 19));
+}
+
+/**
+  * @brief Checks the complex GPIO timer rate against simulated time.
+ **/
+static void HostCheckTimer(void)
+{
+	uint32_t start, end, expected;
+	uint64_t startNs;
+	CyBool_t ok;
+
+	ok = HostVendorIn(HOST_READ_TIMER_VALUE, 0, 0, 8);
+	start = HostU32(HostEp0.InData + 4);
+	startNs = HostSimNs;
+	CyU3PThreadSleep(10);
+	ok &= HostVendorIn(HOST_READ_TIMER_VALUE, 0, 0, 8);
+	end = HostU32(HostEp0.InData + 4);
+
+	/* Both reads are the same time into their request, so the timer should match the time between the requests */
+	expected = (uint32_t) (((HostSimNs - startNs) * HOST_TIMER_HZ) / 1000000000ull);
+	HostCheck(ok && ((end - start) >= (expected - expected / 1000)) && ((end - start) <= (expected + expected / 1000)),
+			"timer advanced %u ticks in %.3f ms (expected %u)", end - start, (HostSimNs - startNs) / 1e6, expected);
+}
+
+/**
+  * @brief Register reads with no DUT attached. Profiles the firmware time per read. A register list which would not
+  * fit in BulkBuffer must be stalled, and the longest list must be read in full.
+ **/
+static void HostCheckRegisterReads(void)
+{
+	uint8_t addrList[8] = {0x00, 0, 0x02, 0, 0x04, 0, 0x06, 0};
+	static uint8_t longList[HOST_REG_LIST_MAX_LENGTH + 2];
+	uint64_t startNs;
+	CyBool_t ok, stalled;
+
+	startNs = HostSimNs;
+	ok = HostVendorIn(HOST_READ_BYTES, 0, 0x02, 6);
+	HostCheck(ok && (HostEp0.InLength == 6) && (HostU32(HostEp0.InData) == CY_U3P_SUCCESS),
+			"read register 0x02 = 0x%04x (%.1f us per request)", HostU16(HostEp0.InData + 4), (HostSimNs - startNs) / 1e3);
+
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	startNs = HostSimNs;
+	ok = HostVendorOut(HOST_READ_REG_LIST, 0, 0, addrList, sizeof(addrList));
+	ok &= HostBulkWait(HOST_TO_PC_ENDPOINT, 4 + 8, 1000);
+	HostCheck(ok && (HostU32(HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data) == CY_U3P_SUCCESS),
+			"register list read, %u bytes on the bulk endpoint (%.1f us for 4 registers)",
+			HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Bytes, (HostSimNs - startNs) / 1e3);
+
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	stalled = !HostVendorOut(HOST_READ_REG_LIST, 0, 0, longList, sizeof(longList));
+	CyU3PThreadSleep(10);
+	ok = HostVendorOut(HOST_READ_REG_LIST, 0, 0, longList, HOST_REG_LIST_MAX_LENGTH);
+	ok &= HostBulkWait(HOST_TO_PC_ENDPOINT, 4 + HOST_REG_LIST_MAX_LENGTH, 2000);
+	HostCheck(stalled && ok && (HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Bytes == 4 + HOST_REG_LIST_MAX_LENGTH) &&
+			(HostU32(HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data) == CY_U3P_SUCCESS),
+			"%u byte register list %s, %u byte list returns %u bytes", (uint32_t) sizeof(longList),
+			stalled ? "stalled" : "accepted", HOST_REG_LIST_MAX_LENGTH, HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Bytes);
+}
+
+static void HostPutU32(uint8_t *buf, uint32_t value)
+{
+	buf[0] = (uint8_t) value;
+	buf[1] = (uint8_t) (value >> 8);
+	buf[2] = (uint8_t) (value >> 16);
+	buf[3] = (uint8_t) (value >> 24);
+}
+
+/** Big endian 16-bit word, as clocked out by the DUT in a stream */
+static uint16_t HostWireWord(const uint8_t *buf)
+{
+	return (uint16_t) ((buf[0] << 8) | buf[1]);
+}
+
+static uint16_t HostByteSum(const uint8_t *buf, uint32_t numBytes)
+{
+	uint16_t sum = 0;
+
+	while(numBytes--)
+		sum += *buf++;
+	return sum;
+}
+
+static CyBool_t HostSpiConfig(uint16_t index, uint16_t value)
+{
+	return HostVendorOut(HOST_SET_SPI_CONFIG, value, index, NULL, 0);
+}
+
+static CyBool_t HostSetSclk(uint32_t sclkHz)
+{
+	/* Sent big endian */
+	uint8_t data[4] = {(uint8_t) (sclkHz >> 24), (uint8_t) (sclkHz >> 16), (uint8_t) (sclkHz >> 8), (uint8_t) sclkHz};
+
+	return HostVendorOut(HOST_SET_SPI_CONFIG, 0, HOST_SPI_CONFIG_SCLK, data, sizeof(data));
+}
+
+static CyBool_t HostWriteByte(uint8_t addr, uint8_t data)
+{
+	return HostVendorIn(HOST_WRITE_BYTE, data, addr, 4) && (HostU32(HostEp0.InData) == CY_U3P_SUCCESS);
+}
+
+static uint16_t HostReadWord(uint8_t addr)
+{
+	if(!HostVendorIn(HOST_READ_BYTES, 0, addr, 6) || (HostU32(HostEp0.InData) != CY_U3P_SUCCESS))
+		return 0;
+	return HostU16(HostEp0.InData + 4);
+}
+
+/**
+  * @brief Paged register writes and reads against the DUT model.
+ **/
+static void HostCheckDutRegisters(void)
+{
+	HostDutConfig config;
+	const HostDutStats *stats = HostDutGetStats();
+	uint8_t addrList[6] = {HOST_DUT_PROD_ID, 0, 0x10, 2, HOST_DUT_DATA_CNTR, 0};
+	uint16_t value;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+
+	ok = HostWriteByte(HOST_DUT_PAGE_ID, 2);
+	ok &= HostWriteByte(0x10, 0x34);
+	ok &= HostWriteByte(0x11, 0x12);
+	value = HostReadWord(0x10);
+	ok &= HostWriteByte(HOST_DUT_PAGE_ID, 0);
+	HostCheck(ok && (value == 0x1234) && (HostDutReadReg(2, 0x10) == 0x1234), "DUT page 2 register 0x10 written and read back as 0x%04x",
+			value);
+
+	value = HostReadWord(HOST_DUT_PROD_ID);
+	HostCheck(value == 16465, "DUT PROD_ID = %u", value);
+
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	ok = HostVendorOut(HOST_READ_REG_LIST, 1, 0, addrList, sizeof(addrList));
+	ok &= HostBulkWait(HOST_TO_PC_ENDPOINT, 4 + 6, 1000);
+	HostCheck(ok && (HostU16(HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data + 4) == 16465) &&
+			(HostU16(HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data + 6) == 0x1234) &&
+			(HostU16(HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data + 8) != 0),
+			"paged register list read: PROD_ID, page 2 register 0x10, DATA_CNTR %u",
+			HostU16(HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data + 8));
+
+	HostCheck((stats->StallViolations == 0) && (stats->SclkViolations == 0),
+			"%u DUT transactions with %u stall and %u SCLK violations, shortest stall %.1f us", stats->Transactions,
+			stats->StallViolations, stats->SclkViolations, stats->MinStallNs / 1e3);
+}
+
+/**
+  * @brief DUT page cache (ADI_SET_SPI_CONFIG index 19). Repeated PAGE_ID writes must reach the DUT once, and a DUT reset
+  * pulse or a supply change must make the next PAGE_ID write go out again.
+ **/
+static void HostCheckPageCache(void)
+{
+	HostDutConfig config;
+	const HostDutStats *stats = HostDutGetStats();
+	uint8_t pulseData[11] = {HOST_DUT_PIN_RESET, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	uint32_t i, repeatWrites, resetWrites, supplyWrites;
+	uint16_t page;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	ok = HostSpiConfig(HOST_SPI_CONFIG_PAGE_CACHE, 1);
+
+	HostDutClearStats();
+	for(i = 0; i < HOST_PAGE_WRITES; i++)
+	{
+		ok &= HostWriteByte(HOST_DUT_PAGE_ID, 3);
+	}
+	repeatWrites = stats->Transactions;
+
+	/* Active low reset pulse, which puts the DUT back on page 0 */
+	HostPutU32(pulseData + 3, HOST_RESET_PULSE_TICKS);
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	ok &= HostVendorOut(HOST_PULSE_DRIVE, 0, 0, pulseData, sizeof(pulseData));
+	ok &= HostBulkWait(HOST_TO_PC_ENDPOINT, 4, 1000) && (HostU32(HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data) == CY_U3P_SUCCESS);
+	HostDutClearStats();
+	ok &= HostWriteByte(HOST_DUT_PAGE_ID, 3);
+	resetWrites = stats->Transactions;
+
+	/* The DUT model has no supply, so move it to page 0 as a power cycle would */
+	ok &= HostVendorIn(HOST_SET_DUT_SUPPLY, HOST_DUT_SUPPLY_3_3V, 0, 4) && (HostU32(HostEp0.InData) == CY_U3P_SUCCESS);
+	HostDutWriteReg(0, HOST_DUT_PAGE_ID, 0);
+	HostDutClearStats();
+	ok &= HostWriteByte(HOST_DUT_PAGE_ID, 3);
+	supplyWrites = stats->Transactions;
+	page = HostDutReadReg(0, HOST_DUT_PAGE_ID);
+
+	ok &= HostWriteByte(HOST_DUT_PAGE_ID, 0);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_PAGE_CACHE, 0);
+	HostCheck(ok && (repeatWrites == 1) && (resetWrites == 1) && (supplyWrites == 1) && (page == 3),
+			"page cache: %u DUT transactions for %u PAGE_ID writes, %u after a reset pulse, %u after a supply change (DUT page %u)",
+			repeatWrites, HOST_PAGE_WRITES, resetWrites, supplyWrites, page);
+}
+
+/**
+  * @brief Generic stream register list with PAGE_ID writes, with the page cache off then on. The list selects page 3
+  * twice, then reads two page 3 registers. With the cache on, only the first page select of the stream may reach the
+  * DUT, the stream data must match the uncached stream, and the firmware must still know the page afterwards.
+ **/
+static void HostCheckStreamPageCache(void)
+{
+	static const uint8_t regList[8] = {3, 0x80, 3, 0x80, 0, 0x10, 0, 0x12};
+	static uint8_t uncached[HOST_STREAM_BUFFER_BYTES];
+	HostDutConfig config;
+	const HostDutStats *stats = HostDutGetStats();
+	uint8_t startData[8 + sizeof(regList)];
+	uint32_t transactions[2], pass, i, badWords = 0, afterWrites;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	HostDutWriteReg(3, 0x10, 0x1234);
+	HostDutWriteReg(3, 0x12, 0x5678);
+	ok = HostSetSclk(1000000);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, HOST_DUT_PIN_DIO1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_POLARITY, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+
+	/* Buffers[0-3], captures[4-7], then the register list */
+	HostPutU32(startData, HOST_PAGE_STREAM_SAMPLES);
+	HostPutU32(startData + 4, HOST_PAGE_STREAM_CAPTURES);
+	memcpy(startData + 8, regList, sizeof(regList));
+
+	for(pass = 0; pass < 2; pass++)
+	{
+		ok &= HostSpiConfig(HOST_SPI_CONFIG_PAGE_CACHE, pass);
+		ok &= HostWriteByte(HOST_DUT_PAGE_ID, 0);
+		HostDutClearStats();
+		HostUsbInClear(HOST_STREAMING_ENDPOINT);
+		ok &= HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+		ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, HOST_STREAM_BUFFER_BYTES, 1000);
+		ok &= HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+		transactions[pass] = stats->Transactions;
+		if(pass == 0)
+			memcpy(uncached, HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data, sizeof(uncached));
+		for(i = 0; (pass == 1) && (i < sizeof(uncached)); i += 2)
+		{
+			if(HostU16(HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data + i) != HostU16(uncached + i))
+				badWords++;
+		}
+	}
+	badWords += (HostU16(uncached + 4) != 0x1234) + (HostU16(uncached + 6) != 0x5678);
+
+	/* The stream left page 3 selected, so selecting it again is skipped */
+	HostDutClearStats();
+	ok &= HostWriteByte(HOST_DUT_PAGE_ID, 3);
+	afterWrites = stats->Transactions;
+	ok &= (HostDutReadReg(0, HOST_DUT_PAGE_ID) == 3);
+
+	ok &= HostWriteByte(HOST_DUT_PAGE_ID, 0);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_PAGE_CACHE, 0);
+	HostCheck(ok && (transactions[0] == 5 * HOST_PAGE_STREAM_SAMPLES * HOST_PAGE_STREAM_CAPTURES) &&
+			(transactions[1] == (3 * HOST_PAGE_STREAM_SAMPLES * HOST_PAGE_STREAM_CAPTURES) + 1) && (badWords == 0) && (afterWrites == 0),
+			"generic stream page cache: %u DUT transactions uncached, %u cached, %u bad words, %u transactions for a PAGE_ID write after",
+			transactions[0], transactions[1], badWords, afterWrites);
+}
+
+/**
+  * @brief Stall time enforcement. Finds the smallest firmware stall setting the DUT model accepts.
+ **/
+static void HostCheckDutStall(void)
+{
+	HostDutConfig config;
+	const HostDutStats *stats = HostDutGetStats();
+	uint16_t value, stallUs, minStallUs = 0;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+
+	HostSpiConfig(HOST_SPI_CONFIG_STALL, 2);
+	value = HostReadWord(HOST_DUT_PROD_ID);
+	HostCheck((value == 0xFFFF) && (stats->StallViolations == 1), "2us stall is flagged by the DUT (read 0x%04x, %u violations)",
+			value, stats->StallViolations);
+
+	HostSpiConfig(HOST_SPI_CONFIG_STALL, HOST_DEFAULT_STALL_US);
+	value = HostReadWord(HOST_DUT_DIAG_STAT);
+	HostCheck((value & HOST_DUT_DIAG_SPI_ERROR) && (HostReadWord(HOST_DUT_DIAG_STAT) == 0),
+			"DIAG_STAT SPI error bit set after the violation, and cleared by the read");
+
+	for(stallUs = 2; stallUs <= HOST_DEFAULT_STALL_US; stallUs++)
+	{
+		HostSpiConfig(HOST_SPI_CONFIG_STALL, stallUs);
+		HostDutClearStats();
+		if((HostReadWord(HOST_DUT_PROD_ID) == 16465) && (stats->StallViolations == 0))
+		{
+			minStallUs = stallUs;
+			break;
+		}
+	}
+	HostSpiConfig(HOST_SPI_CONFIG_STALL, HOST_DEFAULT_STALL_US);
+	HostCheck(minStallUs != 0, "smallest stall setting which meets the %.1f us DUT stall: %u us (measured %.1f us)",
+			config.StallNs / 1e3, minStallUs, stats->MinStallNs / 1e3);
+}
+
+/**
+  * @brief SPI register script, run by the command worker. A zero count loop (with a nested loop) must be skipped.
+ **/
+static void HostCheckSpiScript(void)
+{
+	/* LOOP 0 { LOOP 2 { READ DATA_CNTR } } LOOP 2 { READ PROD_ID, STALL } END. The script owns the stall between reads */
+	const uint8_t script[] = {0x06, 0, 0, 0x06, 2, 0, 0x01, HOST_DUT_DATA_CNTR, 0, 0x07, 0x07,
+			0x06, 2, 0, 0x01, HOST_DUT_PROD_ID, 0, 0x04, HOST_DEFAULT_STALL_US, 0, 0, 0, 0x07, 0x00};
+	const uint8_t *response = HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data;
+	HostDutConfig config;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	ok = HostVendorOut(HOST_RUN_SPI_SCRIPT, 0, 0, script, sizeof(script));
+	ok &= HostBulkWait(HOST_TO_PC_ENDPOINT, 8 + 4, 1000);
+	HostCheck(ok && (HostU32(response) == CY_U3P_SUCCESS) && (HostU16(response + 4) == sizeof(script) - 1) &&
+			(HostU16(response + 6) == 2) && (HostU16(response + 8) == 16465) && (HostU16(response + 10) == 16465),
+			"SPI script skipped its zero count loop, %u words read, stopped at offset %u", HostU16(response + 6),
+			HostU16(response + 4));
+}
+
+/**
+  * @brief SPI script stalls. A stall over ADI_SCRIPT_MAX_STALL_US must be refused, and a cancel request must end
+  * a long stall within a stall slice, without running the rest of the script.
+ **/
+static void HostCheckSpiScriptStall(void)
+{
+	/* STALL max + 1 us, READ PROD_ID, END */
+	uint8_t script[] = {0x04, 0, 0, 0, 0, 0x01, HOST_DUT_PROD_ID, 0, 0x00};
+	const uint8_t *response = HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data;
+	uint64_t cancelNs;
+	CyBool_t ok, cancelled;
+
+	HostPutU32(script + 1, HOST_SCRIPT_MAX_STALL_US + 1);
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	ok = HostVendorOut(HOST_RUN_SPI_SCRIPT, 0, 0, script, sizeof(script));
+	ok &= HostBulkWait(HOST_TO_PC_ENDPOINT, 8, 10);
+	HostCheck(ok && (HostU32(response) == CY_U3P_ERROR_BAD_ARGUMENT) && (HostU16(response + 4) == 0) &&
+			(HostU16(response + 6) == 0), "SPI script stall over the max refused with status 0x%x at offset %u",
+			HostU32(response), HostU16(response + 4));
+
+	/* Cancel a max length stall part way */
+	HostPutU32(script + 1, HOST_SCRIPT_MAX_STALL_US);
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	ok = HostVendorOut(HOST_RUN_SPI_SCRIPT, 0, 0, script, sizeof(script));
+	CyU3PThreadSleep(HOST_SCRIPT_CANCEL_MS);
+	cancelNs = HostSimNs;
+	cancelled = HostVendorIn(HOST_COMMAND_CONTROL, HOST_COMMAND_CANCEL, 0, 16) && (HostU32(HostEp0.InData) == CY_U3P_SUCCESS) &&
+			(HostU32(HostEp0.InData + 4) == HOST_RUN_SPI_SCRIPT);
+	ok &= HostBulkWait(HOST_TO_PC_ENDPOINT, 8, 1000);
+	HostCheck(ok && cancelled && (HostU32(response) == CY_U3P_ERROR_ABORTED) && (HostU16(response + 4) == 0) &&
+			(HostU16(response + 6) == 0) && (HostSimNs - cancelNs < 2000000ull),
+			"%u ms SPI script stall cancelled after %u ms with status 0x%x, response %.2f ms after the cancel",
+			HOST_SCRIPT_MAX_STALL_US / 1000, HOST_SCRIPT_CANCEL_MS, HostU32(response), (HostSimNs - cancelNs) / 1e6);
+}
+
+/**
+  * @brief Register reads on the control endpoint while the command worker reads register lists. Neither read may
+  * be split by the other's SPI transactions. A control read which finds the SPI bus busy is stalled rather than
+  * waiting on the list, but reads must still get through between the list's register reads.
+ **/
+static void HostCheckSpiSerialized(void)
+{
+	uint8_t addrList[2 * HOST_SERIAL_LIST_REGS];
+	const uint8_t *response = HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data;
+	const HostDutStats *stats = HostDutGetStats();
+	HostDutConfig config;
+	uint32_t i, list, reads = 0, stalledReads = 0, badReads = 0, badList = 0;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+
+	ok = HostWriteByte(HOST_DUT_PAGE_ID, 0);
+	ok &= HostWriteByte(HOST_SERIAL_REG, 0x34);
+	ok &= HostWriteByte(HOST_SERIAL_REG + 1, 0x12);
+	for(i = 0; i < HOST_SERIAL_LIST_REGS; i++)
+	{
+		addrList[2 * i] = HOST_DUT_PROD_ID;
+		addrList[(2 * i) + 1] = 0;
+	}
+
+	for(list = 0; list < HOST_SERIAL_LISTS; list++)
+	{
+		HostUsbInClear(HOST_TO_PC_ENDPOINT);
+		ok &= HostVendorOut(HOST_READ_REG_LIST, 0, 0, addrList, sizeof(addrList));
+		while(HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Bytes == 0)
+		{
+			if(!HostVendorIn(HOST_READ_BYTES, 0, HOST_SERIAL_REG, 6))
+				stalledReads++;
+			else if((HostU32(HostEp0.InData) != CY_U3P_SUCCESS) || (HostU16(HostEp0.InData + 4) != 0x1234))
+				badReads++;
+			reads++;
+			/* Paced, so VERBOSE_MODE builds don't drop log messages */
+			CyU3PThreadSleep(1);
+		}
+		ok &= HostBulkWait(HOST_TO_PC_ENDPOINT, 4 + sizeof(addrList), 1000);
+		for(i = 0; i < HOST_SERIAL_LIST_REGS; i++)
+		{
+			if(HostU16(response + 4 + (2 * i)) != 16465)
+				badList++;
+		}
+	}
+	HostCheck(ok && (reads > 1) && (4 * stalledReads < 3 * reads) && (badReads == 0) && (badList == 0) &&
+			(stats->StallViolations == 0),
+			"%u control endpoint reads during %u reads of a %u register list: %u stalled, %u bad reads, %u bad list words, "
+			"%u stall violations", reads, HOST_SERIAL_LISTS, HOST_SERIAL_LIST_REGS, stalledReads, badReads, badList, stats->StallViolations);
+}
+
+/**
+  * @brief USB reconnects (SET_CONFIGURATION, which stops and restarts the application) while the command worker
+  * holds the SPI lock. The firmware must not fail the restart, and the DUT must still be readable from both threads.
+ **/
+static void HostCheckReconnect(void)
+{
+	uint8_t addrList[2 * HOST_SERIAL_LIST_REGS];
+	const uint8_t *response = HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data;
+	HostDutConfig config;
+	uint32_t i, reconnect, badList = 0;
+	CyBool_t ok = CyTrue;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	for(i = 0; i < HOST_SERIAL_LIST_REGS; i++)
+	{
+		addrList[2 * i] = HOST_DUT_PROD_ID;
+		addrList[(2 * i) + 1] = 0;
+	}
+
+	for(reconnect = 0; reconnect < HOST_RECONNECTS; reconnect++)
+	{
+		ok &= HostVendorOut(HOST_READ_REG_LIST, 0, 0, addrList, sizeof(addrList));
+		CyU3PThreadSleep(1);
+		HostUsbConfigure(CY_U3P_HIGH_SPEED);
+		CyU3PThreadSleep(100);
+	}
+
+	ok &= (HostReadWord(HOST_DUT_PROD_ID) == 16465);
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	ok &= HostVendorOut(HOST_READ_REG_LIST, 0, 0, addrList, sizeof(addrList));
+	ok &= HostBulkWait(HOST_TO_PC_ENDPOINT, 4 + sizeof(addrList), 1000);
+	for(i = 0; i < HOST_SERIAL_LIST_REGS; i++)
+	{
+		if(HostU16(response + 4 + (2 * i)) != 16465)
+			badList++;
+	}
+	HostCheck(ok && (badList == 0), "%u reconnects during register list reads, then PROD_ID read and a %u register list read"
+			" with %u bad words", HOST_RECONNECTS, HOST_SERIAL_LIST_REGS, badList);
+}
+
+/**
+  * @brief Reads the debug log into a buffer of HOST_LOG_HEADER_BYTES + (HOST_LOG_RECORDS * HOST_LOG_RECORD_BYTES) bytes,
+  * and counts the messages which break the record layout: more than HOST_LOG_MAX_ARGS arguments, set arguments past the
+  * argument count, no format ID, or an uptime which goes backwards or is in the future.
+  *
+  * @return CyFalse if the read failed, or the header does not match the response length.
+ **/
+static CyBool_t HostReadDebugLog(uint8_t *log, uint32_t *badRecords)
+{
+	const uint8_t *record;
+	uint32_t numRecords, i, arg, lastUptime = 0;
+	CyBool_t ok;
+
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	ok = HostVendorIn(HOST_READ_DEBUG_LOG, 0, 0, 4) && (HostU32(HostEp0.InData) == CY_U3P_SUCCESS);
+	ok &= HostBulkWait(HOST_TO_PC_ENDPOINT, HOST_LOG_HEADER_BYTES, 100);
+	memcpy(log, HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data, HOST_LOG_HEADER_BYTES);
+	numRecords = HostU32(log + 4);
+	ok &= (HostU32(log) == CY_U3P_SUCCESS) && (numRecords <= HOST_LOG_RECORDS) && (HostU32(log + 12) == 0) &&
+			(numRecords == ((HostU32(log + 8) < HOST_LOG_RECORDS) ? HostU32(log + 8) : HOST_LOG_RECORDS)) &&
+			(HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Bytes == HOST_LOG_HEADER_BYTES + (numRecords * HOST_LOG_RECORD_BYTES));
+	if(!ok)
+		return CyFalse;
+	memcpy(log, HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data, HOST_LOG_HEADER_BYTES + (numRecords * HOST_LOG_RECORD_BYTES));
+
+	*badRecords = 0;
+	for(i = 0; i < numRecords; i++)
+	{
+		record = log + HOST_LOG_HEADER_BYTES + (i * HOST_LOG_RECORD_BYTES);
+		if((HostU32(record) < lastUptime) || (HostU32(record) > HostSimNs / 1000000) || (HostU32(record + 4) == 0) ||
+				(HostU32(record + 8) > HOST_LOG_MAX_ARGS))
+			(*badRecords)++;
+		for(arg = HostU32(record + 8); arg < HOST_LOG_MAX_ARGS; arg++)
+		{
+			if(HostU32(record + 12 + (4 * arg)) != 0)
+				(*badRecords)++;
+		}
+		lastUptime = HostU32(record);
+	}
+	return CyTrue;
+}
+
+/**
+  * @brief Debug log read (ADI_READ_DEBUG_LOG). Every USB reconnect logs the application stop, then the connection
+  * speed, with no arguments. After a reconnect the log must hold that pair once more, with the same format IDs as
+  * the last reconnect and the reconnect time as the uptime, and the messages read before must be unchanged.
+  * VERBOSE_MODE builds also log each vendor request, so each read ends with its own request number
+  * (ADI_READ_DEBUG_LOG); otherwise the pair must be the only new messages.
+ **/
+static void HostCheckDebugLog(void)
+{
+	static uint8_t before[HOST_LOG_HEADER_BYTES + (HOST_LOG_RECORDS * HOST_LOG_RECORD_BYTES)];
+	static uint8_t after[HOST_LOG_HEADER_BYTES + (HOST_LOG_RECORDS * HOST_LOG_RECORD_BYTES)];
+	const uint8_t *record;
+	uint32_t badBefore = 0, badAfter = 0, numBefore, numAfter, newRecords = 0, i, pairs = 0, changed = 0;
+	uint32_t stopFormat = 0, connectFormat = 0, reconnectMs;
+	CyBool_t ok;
+
+	ok = HostReadDebugLog(before, &badBefore);
+	numBefore = HostU32(before + 4);
+	/* The format IDs of the last stop and connect pair */
+	for(i = 1; ok && (i < numBefore); i++)
+	{
+		record = before + HOST_LOG_HEADER_BYTES + (i * HOST_LOG_RECORD_BYTES);
+		if((HostU32(record + 8) == 0) && (HostU32(record - HOST_LOG_RECORD_BYTES + 8) == 0))
+		{
+			stopFormat = HostU32(record - HOST_LOG_RECORD_BYTES + 4);
+			connectFormat = HostU32(record + 4);
+		}
+	}
+
+	reconnectMs = (uint32_t) (HostSimNs / 1000000);
+	HostUsbConfigure(CY_U3P_HIGH_SPEED);
+	CyU3PThreadSleep(100);
+	ok &= HostReadDebugLog(after, &badAfter);
+	numAfter = HostU32(after + 4);
+	if(ok)
+	{
+		newRecords = HostU32(after + 8) - HostU32(before + 8);
+		ok &= (newRecords <= numAfter);
+	}
+	for(i = 0; ok && (i < numAfter); i++)
+	{
+		record = after + HOST_LOG_HEADER_BYTES + (i * HOST_LOG_RECORD_BYTES);
+		if(i < numAfter - newRecords)
+		{
+			/* Read before, where it is still in the log */
+			if((i + newRecords + numBefore >= numAfter) &&
+					memcmp(record, before + HOST_LOG_HEADER_BYTES + ((i + newRecords + numBefore - numAfter) * HOST_LOG_RECORD_BYTES), HOST_LOG_RECORD_BYTES))
+				changed++;
+		}
+		else if((i != 0) && (HostU32(record + 4) == connectFormat) && (HostU32(record + 8) == 0) &&
+				(HostU32(record - HOST_LOG_RECORD_BYTES + 4) == stopFormat) && (HostU32(record - HOST_LOG_RECORD_BYTES + 8) == 0) &&
+				(HostU32(record) - reconnectMs <= 1) && (HostU32(record - HOST_LOG_RECORD_BYTES) - reconnectMs <= 1))
+		{
+			pairs++;
+		}
+	}
+#ifdef VERBOSE_MODE
+	/* Both reads end with their own vendor request */
+	record = before + HOST_LOG_HEADER_BYTES + ((numBefore - 1) * HOST_LOG_RECORD_BYTES);
+	ok &= (numBefore != 0) && (HostU32(record + 8) == 1) && (HostU32(record + 12) == HOST_READ_DEBUG_LOG);
+	ok &= (numAfter != 0) && !memcmp(record + 4, after + HOST_LOG_HEADER_BYTES + ((numAfter - 1) * HOST_LOG_RECORD_BYTES) + 4, 12);
+#else
+	ok &= (newRecords == 2);
+#endif
+
+	HostCheck(ok && (stopFormat != connectFormat) && (badBefore == 0) && (badAfter == 0) && (pairs == 1) && (changed == 0),
+			"debug log read: %u then %u messages, %u new, %u bad, %u reconnect message pairs, %u changed messages", numBefore, numAfter,
+			newRecords, badBefore + badAfter, pairs, changed);
+}
+
+/**
+  * @brief Counts the bad burst frames in burst stream data. Each burst must hold the next consecutive DUT sample.
+ **/
+static uint32_t HostBadBursts(const uint8_t *data, uint32_t numBursts)
+{
+	const uint8_t *frame;
+	uint32_t burst, word, firstSample = 0, badFrames = 0;
+
+	for(burst = 0; burst < numBursts; burst++)
+	{
+		frame = data + (burst * HOST_BURST_BYTES) + 2;
+		if(burst == 0)
+			firstSample = HostWireWord(frame + 16);
+		for(word = 1; word < 8; word++)
+		{
+			if(HostWireWord(frame + (2 * word)) != HostDutSampleWord(firstSample + burst, word - 1))
+				break;
+		}
+		if((word != 8) || (HostWireWord(frame + 16) != (uint16_t) (firstSample + burst)) || (HostWireWord(frame + 18) != HostByteSum(frame, 18)))
+			badFrames++;
+	}
+	return badFrames;
+}
+
+/** CRC32 (IEEE 802.3, as zlib), bit at a time */
+static uint32_t HostCrc32(const uint8_t *data, uint32_t numBytes)
+{
+	uint32_t crc = 0xFFFFFFFF, bit;
+
+	while(numBytes--)
+	{
+		crc ^= *data++;
+		for(bit = 0; bit < 8; bit++)
+			crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+	}
+	return ~crc;
+}
+
+/**
+  * @brief IMU burst stream, on the DIO1 data ready. Every burst frame must be checked out, and consecutive.
+ **/
+static void HostCheckBurstStream(uint32_t sclkHz, CyBool_t expectSclkViolations)
+{
+	HostDutConfig config;
+	const HostDutStats *stats = HostDutGetStats();
+	uint8_t startData[10];
+	uint32_t badFrames = 0;
+	uint64_t startNs;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	ok = HostSetSclk(sclkHz);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, HOST_DUT_PIN_DIO1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_POLARITY, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+
+	/* Number of bursts, bytes per burst, then the burst command */
+	HostPutU32(startData, HOST_NUM_BURSTS);
+	HostPutU32(startData + 4, HOST_BURST_BYTES);
+	startData[8] = (uint8_t) (config.BurstCmd >> 8);
+	startData[9] = (uint8_t) config.BurstCmd;
+
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	startNs = HostSimNs;
+	ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, HOST_NUM_BURSTS * HOST_BURST_BYTES, 1000);
+	ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+
+	if(ok)
+		badFrames = HostBadBursts(HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data, HOST_NUM_BURSTS);
+
+	HostCheck(ok && (badFrames == 0) && (stats->Bursts == HOST_NUM_BURSTS) && (stats->StallViolations == 0) &&
+			((stats->SclkViolations != 0) == expectSclkViolations),
+			"burst stream at %.1f MHz SCLK: %u bursts, %u bad, %u SCLK violations (%.1f us per burst)", sclkHz / 1e6, stats->Bursts,
+			badFrames, stats->SclkViolations, (HostSimNs - startNs) / 1e3 / HOST_NUM_BURSTS);
+}
+
+/**
+  * @brief Burst stream in data ready interrupt mode. The GPIO ISR starts armed bursts, racing the stream thread which
+  * arms them. At the fastest data ready rate the burst and DUT stall allow, every burst must be read once, in order.
+  * Faster than that, edges land at every point of the stream thread loop, including before the next burst is armed:
+  * samples are then skipped (and counted as missed data ready edges), but no sample may be read twice. In both cases
+  * the DUT must see no SPI transactions other than the bursts, which would be a burst started while unarmed. A
+  * generic stream then runs on the same data ready signal, where the ISR has no burst to start: the SPI block
+  * must never be enabled with nothing set up.
+ **/
+static void HostCheckBurstIsrStream(uint64_t drPeriodNs)
+{
+	HostDutConfig config;
+	const HostDutStats *stats = HostDutGetStats();
+	const uint8_t *frame;
+	uint8_t startData[10], genericData[10] = {0};
+	uint32_t burst, word, sample, lastSample = 0, badFrames = HOST_ISR_BURSTS, missed = 0xFFFFFFFF, samples = 0;
+	uint32_t badWords = HOST_ISR_GENERIC_SAMPLES, strayEnables = HostSpiStrayEnables(), transactions;
+	CyBool_t ok, overRate = (CyBool_t) (drPeriodNs < HOST_ISR_DR_PERIOD_NS);
+
+	HostDutDefaults(&config, HostDutImu);
+	config.DrPeriodNs = drPeriodNs;
+	config.DrHighNs = drPeriodNs / 2;
+	/* Over rate bursts run back to back, which only the stream thread loop time separates */
+	if(overRate)
+		config.StallNs = 1000;
+	HostDutConfigure(&config);
+	ok = HostSetSclk(1000000);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, HOST_DUT_PIN_DIO1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_POLARITY, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_INTERRUPT, 1);
+
+	HostPutU32(startData, HOST_ISR_BURSTS);
+	HostPutU32(startData + 4, HOST_BURST_BYTES);
+	startData[8] = (uint8_t) (config.BurstCmd >> 8);
+	startData[9] = (uint8_t) config.BurstCmd;
+
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, HOST_ISR_BURSTS * HOST_BURST_BYTES, 1000);
+	/* Any extra burst would show up after the stream */
+	CyU3PThreadSleep(10);
+	ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	ok &= (HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Bytes == HOST_ISR_BURSTS * HOST_BURST_BYTES);
+
+	/* Each burst must hold one whole DUT sample, later than the burst before it (consecutive at the max rate) */
+	if(ok)
+	{
+		badFrames = 0;
+		for(burst = 0; burst < HOST_ISR_BURSTS; burst++)
+		{
+			frame = HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data + (burst * HOST_BURST_BYTES) + 2;
+			sample = HostWireWord(frame + 16);
+			for(word = 1; word < 8; word++)
+			{
+				if(HostWireWord(frame + (2 * word)) != HostDutSampleWord(sample, word - 1))
+					break;
+			}
+			if((word != 8) || (HostWireWord(frame + 18) != HostByteSum(frame, 18)) ||
+					((burst != 0) && (overRate ? (sample <= lastSample) : (sample != lastSample + 1))))
+				badFrames++;
+			lastSample = sample;
+		}
+	}
+	if(HostVendorIn(HOST_GET_STREAM_STATS, 0, 0, HOST_STREAM_STATS_LENGTH))
+	{
+		samples = HostU32(HostEp0.InData + 12);
+		missed = HostU32(HostEp0.InData + HOST_STREAM_STATS_MISSED_DR);
+	}
+
+	transactions = stats->Transactions;
+
+	/* Generic stream of PROD_ID reads: buffers[0-3], captures[4-7], register list */
+	HostPutU32(genericData, HOST_ISR_GENERIC_SAMPLES);
+	HostPutU32(genericData + 4, 1);
+	genericData[9] = HOST_DUT_PROD_ID;
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok &= HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_START_CMD, genericData, sizeof(genericData));
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, HOST_STREAM_BUFFER_BYTES, 1000);
+	ok &= HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	if(ok)
+	{
+		badWords = 0;
+		for(word = 0; word < HOST_ISR_GENERIC_SAMPLES; word++)
+		{
+			if(HostU16(HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data + (2 * word)) != 16465)
+				badWords++;
+		}
+	}
+	strayEnables = HostSpiStrayEnables() - strayEnables;
+	HostSpiConfig(HOST_SPI_CONFIG_DR_INTERRUPT, 0);
+	HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 0);
+
+	HostCheck(ok && (badFrames == 0) && (stats->Bursts == HOST_ISR_BURSTS) && (transactions == HOST_ISR_BURSTS) &&
+			(samples == HOST_ISR_BURSTS) && (overRate ? (missed != 0) : (missed == 0)) && (stats->StallViolations == 0) &&
+			(badWords == 0) && (strayEnables == 0),
+			"interrupt mode burst stream at %.0f Hz data ready: %u bursts, %u bad, %u DUT transactions, %u missed data ready edges, "
+			"%u bad generic stream words, %u stray SPI enables",
+			1e9 / drPeriodNs, stats->Bursts, badFrames, transactions, missed, badWords, strayEnables);
+}
+
+/**
+  * @brief Generic stream in data ready interrupt mode. Each sample must be read once, after its own data ready
+  * edge (consecutive DATA_CNTR values), and ADI_GET_DR_LATENCY must count every sample with a non-zero latency.
+  * A stream stopped while it waits for a data ready edge which never comes must finish within the wait poll time.
+ **/
+static void HostCheckDrInterruptWait(void)
+{
+	HostDutConfig config;
+	const uint8_t *data;
+	uint8_t startData[12] = {0};
+	uint32_t sample, badSamples = HOST_DR_WAIT_SAMPLES, count = 0, minTicks = 0, maxTicks = 0;
+	uint64_t totalTicks = 0, stopNs, deadline;
+	CyBool_t ok, stopped, idleBeforeStop;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	ok = HostSetSclk(1000000);
+	ok &= HostWriteByte(HOST_DUT_PAGE_ID, 0);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, config.DrPin);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_POLARITY, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_INTERRUPT, 1);
+
+	/* Buffers[0-3], captures[4-7], then the register list */
+	HostPutU32(startData, HOST_DR_WAIT_SAMPLES);
+	HostPutU32(startData + 4, 1);
+	startData[9] = HOST_DUT_DATA_CNTR;
+	startData[11] = HOST_DUT_PROD_ID;
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok &= HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, HOST_STREAM_BUFFER_BYTES, 1000);
+	ok &= HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	if(ok)
+	{
+		badSamples = 0;
+		data = HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data;
+		for(sample = 0; sample < HOST_DR_WAIT_SAMPLES; sample++)
+		{
+			if(((sample != 0) && (HostU16(data + (4 * sample)) != (uint16_t) (HostU16(data + (4 * sample) - 4) + 1))) ||
+					(HostU16(data + (4 * sample) + 2) != 16465))
+				badSamples++;
+		}
+	}
+	if(HostVendorIn(HOST_GET_DR_LATENCY, 0, 0, 24))
+	{
+		count = HostU32(HostEp0.InData + 4);
+		minTicks = HostU32(HostEp0.InData + 8);
+		maxTicks = HostU32(HostEp0.InData + 12);
+		totalTicks = HostU32(HostEp0.InData + 16) | ((uint64_t) HostU32(HostEp0.InData + 20) << 32);
+	}
+	HostCheck(ok && (badSamples == 0) && (count == HOST_DR_WAIT_SAMPLES) && (minTicks != 0) && (maxTicks >= minTicks) &&
+			(totalTicks >= (uint64_t) minTicks * count) && (totalTicks <= (uint64_t) maxTicks * count),
+			"interrupt mode data ready waits: %u samples with %u bad, latency count %u, min %u, max %u, mean %.1f ticks",
+			HOST_DR_WAIT_SAMPLES, badSamples, count, minTicks, maxTicks, count ? (double) totalTicks / count : 0.0);
+
+	/* Stop a stream with data ready turned off, so it is always waiting for an edge */
+	config.DrPeriodNs = 0;
+	HostDutConfigure(&config);
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok = HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	CyU3PThreadSleep(5);
+	idleBeforeStop = HostVendorIn(HOST_GET_STREAM_STATS, 0, 0, HOST_STREAM_STATS_LENGTH) &&
+			(HostU32(HostEp0.InData + HOST_STREAM_STATS_ACTIVE) != 0) && (HostU32(HostEp0.InData + HOST_STREAM_STATS_SAMPLES) == 0);
+	stopNs = HostSimNs;
+	ok &= HostVendorIn(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_STOP_CMD, 4) && (HostU32(HostEp0.InData) == CY_U3P_SUCCESS);
+	deadline = HostSimNs + (2 * HOST_DR_INTERRUPT_POLL_MS * 1000000ull);
+	do
+	{
+		CyU3PThreadSleep(1);
+		stopped = HostVendorIn(HOST_GET_STREAM_STATS, 0, 0, HOST_STREAM_STATS_LENGTH) &&
+				(HostU32(HostEp0.InData + HOST_STREAM_STATS_ACTIVE) == 0);
+	} while(!stopped && (HostSimNs < deadline));
+	stopNs = HostSimNs - stopNs;
+	HostSpiConfig(HOST_SPI_CONFIG_DR_INTERRUPT, 0);
+	HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 0);
+	ok &= (HostReadWord(HOST_DUT_PROD_ID) == 16465);
+
+	HostCheck(ok && idleBeforeStop && stopped,
+			"interrupt mode data ready wait stopped %s after %.1f ms, register reads %s afterwards",
+			idleBeforeStop ? "while waiting" : "before waiting", stopNs / 1e6, ok ? "work" : "fail");
+}
+
+/**
+  * @brief 64-bit data ready time stamps. The stream timer is started close to its rollover, so the upper word must
+  * step from 0 to 1 during the stream, and the time stamps must increase by one DUT data ready period per sample.
+  * request picks the burst, generic, transfer or I2C stream. Each USB buffer holds as many whole samples as fit.
+ **/
+static void HostCheckTimestamps(uint8_t request)
+{
+	HostDutConfig config;
+	const uint8_t *sample;
+	uint8_t startData[20] = {0};
+	uint16_t length = 0;
+	uint32_t sampleBytes = HOST_TIMESTAMP_BYTES + HOST_TIMESTAMP_DATA_BYTES, samplesPerBuffer, i;
+	uint32_t badSpacing = HOST_TIMESTAMP_SAMPLES, rollovers = 0;
+	uint64_t timestamp, lastTimestamp = 0, expectedTicks;
+	int64_t error, maxError = 0;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	expectedTicks = (config.DrPeriodNs * HOST_TIMER_HZ) / 1000000000ULL;
+	ok = HostSetSclk(1000000);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, config.DrPin);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_POLARITY, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_TIMESTAMPS, 1);
+
+	switch(request)
+	{
+	case HOST_STREAM_BURST_DATA:
+		/* Bursts[0-3], burst bytes[4-7], burst command[8-9] */
+		sampleBytes = HOST_TIMESTAMP_BYTES + HOST_BURST_BYTES;
+		HostPutU32(startData, HOST_TIMESTAMP_SAMPLES);
+		HostPutU32(startData + 4, HOST_BURST_BYTES);
+		startData[8] = (uint8_t) (config.BurstCmd >> 8);
+		startData[9] = (uint8_t) config.BurstCmd;
+		length = 10;
+		break;
+	case HOST_STREAM_GENERIC_DATA:
+		/* Buffers[0-3], captures[4-7], then the register list */
+		HostPutU32(startData, HOST_TIMESTAMP_SAMPLES);
+		HostPutU32(startData + 4, 1);
+		startData[9] = HOST_DUT_DATA_CNTR;
+		startData[11] = HOST_DUT_PROD_ID;
+		length = 12;
+		break;
+	case HOST_TRANSFER_STREAM:
+		/* Captures[0-3], buffers[4-7], bytes per USB packet[8-11], MOSI byte count[12-13], MOSI data */
+		HostPutU32(startData, 1);
+		HostPutU32(startData + 4, HOST_TIMESTAMP_SAMPLES);
+		HostPutU32(startData + 8, (HOST_STREAM_BUFFER_BYTES / sampleBytes) * sampleBytes);
+		startData[12] = HOST_TIMESTAMP_DATA_BYTES;
+		startData[15] = HOST_DUT_DATA_CNTR;
+		startData[17] = HOST_DUT_PROD_ID;
+		length = 18;
+		break;
+	case HOST_I2C_READ_STREAM:
+		/* Bytes[0-3], timeout[4-7], preamble length[8], control mask[9-10] and a read from EEPROM address 0[11-14],
+		 * then buffers[15-18]. At 1MHz the read fits in a data ready period */
+		ok &= HostVendorIn(HOST_I2C_SET_BIT_RATE, (uint16_t) 1000000, (uint16_t) (1000000 >> 16), 4) &&
+				(HostU32(HostEp0.InData) == CY_U3P_SUCCESS);
+		HostPutU32(startData, HOST_TIMESTAMP_DATA_BYTES);
+		HostPutU32(startData + 4, 1000);
+		startData[8] = 4;
+		startData[9] = 0x04;
+		startData[11] = 0xA0;
+		startData[14] = 0xA1;
+		HostPutU32(startData + 15, HOST_TIMESTAMP_SAMPLES);
+		length = 19;
+		break;
+	}
+	samplesPerBuffer = HOST_STREAM_BUFFER_BYTES / sampleBytes;
+
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	HostGpioSetTimer(HOST_TIMESTAMP_TIMER_INDEX, HOST_TIMESTAMP_TIMER_START);
+	ok &= HostVendorOut(request, 0, HOST_STREAM_START_CMD, startData, length);
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT,
+			((HOST_TIMESTAMP_SAMPLES + samplesPerBuffer - 1) / samplesPerBuffer) * HOST_STREAM_BUFFER_BYTES, 1000);
+	ok &= HostVendorOut(request, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	if(ok)
+	{
+		badSpacing = 0;
+		for(i = 0; i < HOST_TIMESTAMP_SAMPLES; i++)
+		{
+			sample = HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data + ((i / samplesPerBuffer) * HOST_STREAM_BUFFER_BYTES) +
+					((i % samplesPerBuffer) * sampleBytes);
+			timestamp = HostU32(sample) | ((uint64_t) HostU32(sample + 4) << 32);
+			error = (int64_t) (timestamp - lastTimestamp) - (int64_t) expectedTicks;
+			if(error < 0)
+				error = -error;
+			if(i == 0)
+			{
+				rollovers = HostU32(sample + 4);
+			}
+			else if(timestamp <= lastTimestamp)
+			{
+				badSpacing++;
+			}
+			/* A burst stream starts at once if data ready is already asserted, so its first sample is not on an edge */
+			else if((i != 1) || (request != HOST_STREAM_BURST_DATA))
+			{
+				if(error > HOST_TIMESTAMP_MAX_JITTER_TICKS)
+					badSpacing++;
+				if(error > maxError)
+					maxError = error;
+			}
+			lastTimestamp = timestamp;
+		}
+		/* Rollovers now counts the upper word steps */
+		rollovers = (uint32_t) (lastTimestamp >> 32) - rollovers;
+	}
+	if(request == HOST_I2C_READ_STREAM)
+		HostVendorIn(HOST_I2C_SET_BIT_RATE, (uint16_t) 100000, 0, 4);
+	HostSpiConfig(HOST_SPI_CONFIG_TIMESTAMPS, 0);
+	HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 0);
+
+	HostCheck(ok && (badSpacing == 0) && (rollovers == 1) && ((lastTimestamp >> 32) == 1),
+			"%s stream time stamps: %u samples, %u rollover, last 0x%llx, %u bad spacings (worst %lld ticks from %llu)",
+			(request == HOST_STREAM_BURST_DATA) ? "burst" : (request == HOST_STREAM_GENERIC_DATA) ? "generic" :
+			(request == HOST_TRANSFER_STREAM) ? "transfer" : "I2C", HOST_TIMESTAMP_SAMPLES, rollovers,
+			(unsigned long long) lastTimestamp, badSpacing, (long long) maxError, (unsigned long long) expectedTicks);
+}
+
+/**
+  * @brief Multi packet stream buffers (ADI_SET_SPI_CONFIG index 20). Each USB transfer must hold only whole samples,
+  * so no sample straddles two transfers, every transfer but the last must hold as many samples as fit, and the short
+  * final buffer must be sent with its exact length. request picks the generic stream (DATA_CNTR then PROD_ID words)
+  * or the time stamped burst stream. The DATA_CNTR values must run on across the transfers.
+ **/
+static void HostCheckExactCommits(uint8_t request)
+{
+	HostDutConfig config;
+	const HostUsbInEndpoint *in = &HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF];
+	const uint8_t *sample;
+	uint8_t startData[8 + (2 * HOST_EXACT_GENERIC_WORDS)] = {0};
+	uint16_t length, counter, lastCounter = 0;
+	uint32_t sampleBytes, numSamples, fullBytes, lastBytes, numTransfers, transfer, i, word;
+	uint32_t badTransfers = 0, badSamples = 0, straddles = 0;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	ok = HostSetSclk(1000000);
+	ok &= HostWriteByte(HOST_DUT_PAGE_ID, 0);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, config.DrPin);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_POLARITY, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_BUFFER_PACKETS, HOST_EXACT_BUFFER_PACKETS);
+
+	if(request == HOST_STREAM_BURST_DATA)
+	{
+		/* Bursts[0-3], burst bytes[4-7], burst command[8-9] */
+		ok &= HostSpiConfig(HOST_SPI_CONFIG_TIMESTAMPS, 1);
+		sampleBytes = HOST_TIMESTAMP_BYTES + HOST_BURST_BYTES;
+		numSamples = HOST_EXACT_BURSTS;
+		HostPutU32(startData, HOST_EXACT_BURSTS);
+		HostPutU32(startData + 4, HOST_BURST_BYTES);
+		startData[8] = (uint8_t) (config.BurstCmd >> 8);
+		startData[9] = (uint8_t) config.BurstCmd;
+		length = 10;
+	}
+	else
+	{
+		/* Buffers[0-3], captures[4-7], then the register list */
+		sampleBytes = 2 * HOST_EXACT_GENERIC_WORDS;
+		numSamples = HOST_EXACT_GENERIC_SAMPLES;
+		HostPutU32(startData, HOST_EXACT_GENERIC_SAMPLES);
+		HostPutU32(startData + 4, 1);
+		startData[9] = HOST_DUT_DATA_CNTR;
+		for(word = 1; word < HOST_EXACT_GENERIC_WORDS; word++)
+			startData[9 + (2 * word)] = HOST_DUT_PROD_ID;
+		length = 8 + (2 * HOST_EXACT_GENERIC_WORDS);
+	}
+	fullBytes = ((HOST_EXACT_BUFFER_PACKETS * HOST_STREAM_BUFFER_BYTES) / sampleBytes) * sampleBytes;
+	numTransfers = ((numSamples * sampleBytes) + fullBytes - 1) / fullBytes;
+	lastBytes = (numSamples * sampleBytes) - ((numTransfers - 1) * fullBytes);
+
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok &= HostVendorOut(request, 0, HOST_STREAM_START_CMD, startData, length);
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, numSamples * sampleBytes, 1000);
+	ok &= HostVendorOut(request, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	for(transfer = 0; transfer < in->Transfers; transfer++)
+	{
+		if(in->TransferBytes[transfer] % sampleBytes)
+			straddles++;
+		if(in->TransferBytes[transfer] != ((transfer == numTransfers - 1) ? lastBytes : fullBytes))
+			badTransfers++;
+	}
+	ok &= (in->Transfers == numTransfers) && (in->Bytes == numSamples * sampleBytes);
+	if(ok)
+	{
+		for(i = 0; i < numSamples; i++)
+		{
+			sample = in->Data + (i * sampleBytes);
+			if(request == HOST_STREAM_BURST_DATA)
+			{
+				/* Time stamp, then the burst frame after its command word */
+				counter = HostWireWord(sample + HOST_TIMESTAMP_BYTES + 2 + 16);
+				if(HostWireWord(sample + HOST_TIMESTAMP_BYTES + 2 + 18) != HostByteSum(sample + HOST_TIMESTAMP_BYTES + 2, 18))
+					badSamples++;
+			}
+			else
+			{
+				counter = HostU16(sample);
+				for(word = 1; word < HOST_EXACT_GENERIC_WORDS; word++)
+				{
+					if(HostU16(sample + (2 * word)) != 16465)
+						break;
+				}
+				if(word != HOST_EXACT_GENERIC_WORDS)
+					badSamples++;
+			}
+			if((i != 0) && (counter != (uint16_t) (lastCounter + 1)))
+				badSamples++;
+			lastCounter = counter;
+		}
+	}
+	if(request == HOST_STREAM_BURST_DATA)
+		HostSpiConfig(HOST_SPI_CONFIG_TIMESTAMPS, 0);
+	HostSpiConfig(HOST_SPI_CONFIG_BUFFER_PACKETS, 1);
+	HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 0);
+
+	HostCheck(ok && (badTransfers == 0) && (straddles == 0) && (badSamples == 0),
+			"%s stream in %u packet buffers: %u transfers of %u bytes (%u expected, last %u of %u), %u straddled samples, "
+			"%u bad samples", (request == HOST_STREAM_BURST_DATA) ? "time stamped burst" : "generic", HOST_EXACT_BUFFER_PACKETS,
+			in->Transfers, in->Bytes, numTransfers, in->Transfers ? in->TransferBytes[in->Transfers - 1] : 0, lastBytes,
+			straddles, badSamples);
+}
+
+/**
+  * @brief Framed burst stream with payload CRCs (ADI_SET_SPI_CONFIG index 18). Every USB buffer must start with a valid
+  * header, in sequence, the payloads together must hold every burst once, and the stream must end with a last frame.
+ **/
+static void HostCheckFramedStream(void)
+{
+	HostDutConfig config;
+	const uint8_t *frame;
+	uint8_t startData[10];
+	uint8_t payload[HOST_NUM_BURSTS * HOST_BURST_BYTES];
+	uint32_t frames = 0, payloadBytes = 0, samples = 0, badHeaders = 0, badFrames = HOST_NUM_BURSTS, length;
+	CyBool_t ok, last = CyFalse;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	ok = HostSetSclk(1000000);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, HOST_DUT_PIN_DIO1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_FRAME_MODE, HOST_STREAM_FRAME_CRC);
+
+	HostPutU32(startData, HOST_NUM_BURSTS);
+	HostPutU32(startData + 4, HOST_BURST_BYTES);
+	startData[8] = (uint8_t) (config.BurstCmd >> 8);
+	startData[9] = (uint8_t) config.BurstCmd;
+
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	while(ok && !last && HostBulkWait(HOST_STREAMING_ENDPOINT, (frames + 1) * HOST_STREAM_BUFFER_BYTES, 1000))
+	{
+		frame = HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data + (frames * HOST_STREAM_BUFFER_BYTES);
+		length = HostU16(frame + 10);
+		if((HostU16(frame) != HOST_STREAM_FRAME_SYNC) || (frame[2] != HOST_STREAM_FRAME_TYPE_BURST) ||
+				!(frame[3] & HOST_STREAM_FRAME_FLAG_CRC) || (HostU32(frame + 4) != frames) ||
+				(length > HOST_STREAM_BUFFER_BYTES - HOST_STREAM_FRAME_HEADER_BYTES) || (payloadBytes + length > sizeof(payload)) ||
+				(HostU32(frame + 12) != HostCrc32(frame + HOST_STREAM_FRAME_HEADER_BYTES, length)))
+		{
+			badHeaders++;
+			break;
+		}
+		memcpy(payload + payloadBytes, frame + HOST_STREAM_FRAME_HEADER_BYTES, length);
+		payloadBytes += length;
+		samples += HostU16(frame + 8);
+		last = (CyBool_t) ((frame[3] & HOST_STREAM_FRAME_FLAG_LAST) != 0);
+		frames++;
+	}
+	ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_FRAME_MODE, HOST_STREAM_FRAME_OFF);
+
+	if(payloadBytes == sizeof(payload))
+		badFrames = HostBadBursts(payload, HOST_NUM_BURSTS);
+	HostCheck(ok && last && (badHeaders == 0) && (badFrames == 0) && (samples == HOST_NUM_BURSTS),
+			"framed burst stream: %u frames, %u bad headers, %u payload bytes, %u samples, %u bad bursts, %s last frame",
+			frames, badHeaders, payloadBytes, samples, badFrames, last ? "with a" : "no");
+}
+
+/**
+  * @brief Framed burst stream with the PC paused long enough to overflow the USB buffers. The overflow policy
+  * must drop whole frames, flag the first frame after the gap, and report the gap in the stream stats. The
+  * gap in the DUT sample counter also holds the data ready edges missed during the overflow wait, which the
+  * firmware only counts as a single miss.
+ **/
+static void HostCheckOverflowPolicy(uint16_t policy)
+{
+	HostDutConfig config;
+	const uint8_t *frame, *stats;
+	uint8_t startData[10];
+	uint32_t frames = 0, sequence = 0, samples = 0, badHeaders = 0, badBursts = 0, skipped = 0, gapFrames = 0;
+	uint32_t index, lastIndex = 0, gapStart = 0, gapSamples = 0, firstCounter = 0, missedEdges, length, count;
+	CyBool_t ok, last = CyFalse, gapFound = CyFalse;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	ok = HostSetSclk(1000000);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, HOST_DUT_PIN_DIO1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_FRAME_MODE, HOST_STREAM_FRAME_CRC);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_OVERFLOW_POLICY, policy);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_OVERFLOW_WAIT, HOST_OVERFLOW_WAIT_MS);
+
+	HostPutU32(startData, HOST_OVERFLOW_BURSTS);
+	HostPutU32(startData + 4, HOST_BURST_BYTES);
+	startData[8] = (uint8_t) (config.BurstCmd >> 8);
+	startData[9] = (uint8_t) config.BurstCmd;
+
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, 2 * HOST_STREAM_BUFFER_BYTES, 1000);
+	HostUsbInPause(HOST_STREAMING_ENDPOINT, CyTrue);
+	CyU3PThreadSleep(HOST_OVERFLOW_PAUSE_MS);
+	HostUsbInPause(HOST_STREAMING_ENDPOINT, CyFalse);
+
+	/* Each frame's bursts must be consecutive DUT samples. The DUT sample counter gives the stream sample index */
+	while(ok && !last && HostBulkWait(HOST_STREAMING_ENDPOINT, (frames + 1) * HOST_STREAM_BUFFER_BYTES, 1000))
+	{
+		frame = HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data + (frames * HOST_STREAM_BUFFER_BYTES);
+		length = HostU16(frame + 10);
+		count = HostU16(frame + 8);
+		if((HostU16(frame) != HOST_STREAM_FRAME_SYNC) || (HostU32(frame + 4) < sequence) || (length != count * HOST_BURST_BYTES) ||
+				(length > HOST_STREAM_BUFFER_BYTES - HOST_STREAM_FRAME_HEADER_BYTES) ||
+				(HostU32(frame + 12) != HostCrc32(frame + HOST_STREAM_FRAME_HEADER_BYTES, length)))
+		{
+			badHeaders++;
+			break;
+		}
+		skipped += HostU32(frame + 4) - sequence;
+		sequence = HostU32(frame + 4) + 1;
+		if(count != 0)
+		{
+			badBursts += HostBadBursts(frame + HOST_STREAM_FRAME_HEADER_BYTES, count);
+			if(samples == 0)
+				firstCounter = HostWireWord(frame + HOST_STREAM_FRAME_HEADER_BYTES + 18);
+			index = (uint16_t) (HostWireWord(frame + HOST_STREAM_FRAME_HEADER_BYTES + 18) - firstCounter);
+			if(frame[3] & HOST_STREAM_FRAME_FLAG_GAP)
+			{
+				gapFrames++;
+				gapStart = lastIndex;
+				gapSamples = index - lastIndex;
+			}
+			lastIndex = index + count;
+		}
+		samples += count;
+		last = (CyBool_t) ((frame[3] & HOST_STREAM_FRAME_FLAG_LAST) != 0);
+		frames++;
+	}
+	ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+
+	ok &= HostVendorIn(HOST_GET_STREAM_STATS, 0, 0, HOST_STREAM_STATS_LENGTH);
+	stats = HostEp0.InData;
+	missedEdges = gapSamples - HostU32(stats + HOST_STREAM_STATS_GAP_SAMPLES);
+	gapFound = (CyBool_t) ((gapFrames != 0) && (HostU32(stats + HOST_STREAM_STATS_GAP_SAMPLES) != 0) &&
+			(gapStart == HostU32(stats + HOST_STREAM_STATS_GAP_START)) && (gapSamples >= HostU32(stats + HOST_STREAM_STATS_GAP_SAMPLES)) &&
+			(missedEdges <= ((HOST_OVERFLOW_WAIT_MS * 1000000ULL) / config.DrPeriodNs) + 1) &&
+			((missedEdges == 0) || (HostU32(stats + HOST_STREAM_STATS_MISSED_DR) != 0)));
+
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_OVERFLOW_POLICY, HOST_STREAM_OVERFLOW_BLOCK);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_FRAME_MODE, HOST_STREAM_FRAME_OFF);
+
+	HostCheck(ok && last && gapFound && (badHeaders == 0) && (badBursts == 0) && (skipped != 0) && (HostU32(stats + HOST_STREAM_STATS_OVERFLOWS) != 0) &&
+			(samples + HostU32(stats + HOST_STREAM_STATS_DROPPED_SAMPLES) == HOST_OVERFLOW_BURSTS),
+			"%s overflow policy: %u frames, %u sequence numbers skipped, %u gap frames, gap of %u samples from %u (stats %u from %u, %u data ready misses), "
+			"%u samples received + %u dropped, %u bad headers, %u bad bursts",
+			(policy == HOST_STREAM_OVERFLOW_DROP_NEWEST) ? "drop newest" : "drop oldest", frames, skipped, gapFrames, gapSamples, gapStart,
+			HostU32(stats + HOST_STREAM_STATS_GAP_SAMPLES), HostU32(stats + HOST_STREAM_STATS_GAP_START), HostU32(stats + HOST_STREAM_STATS_MISSED_DR), samples,
+			HostU32(stats + HOST_STREAM_STATS_DROPPED_SAMPLES), badHeaders, badBursts);
+}
+
+/**
+  * @brief A burst stream capture triggered on its own data ready pin must fail the stream start, not stream without it.
+ **/
+static void HostCheckCaptureTriggerPin(void)
+{
+	HostDutConfig config;
+	const HostDutStats *stats = HostDutGetStats();
+	uint8_t captureData[16] = {0};
+	uint8_t startData[10];
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	ok = HostSetSclk(1000000);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, HOST_DUT_PIN_DIO1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+
+	/* 4 pre and 4 post trigger samples, triggered by a rising edge on the data ready pin */
+	HostPutU32(captureData, 4);
+	HostPutU32(captureData + 4, 4);
+	captureData[8] = HOST_CAPTURE_TRIGGER_PIN;
+	captureData[9] = HOST_DUT_PIN_DIO1;
+	captureData[10] = 1;
+	ok &= HostVendorOut(HOST_TRIGGER_CAPTURE, 0, HOST_CAPTURE_CONFIG_CMD, captureData, sizeof(captureData));
+
+	HostPutU32(startData, HOST_NUM_BURSTS);
+	HostPutU32(startData + 4, HOST_BURST_BYTES);
+	startData[8] = (uint8_t) (config.BurstCmd >> 8);
+	startData[9] = (uint8_t) config.BurstCmd;
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	/* Wait out the error log flash writes */
+	CyU3PThreadSleep(100);
+
+	ok &= HostVendorIn(HOST_TRIGGER_CAPTURE, 0, HOST_CAPTURE_STATUS_CMD, 28);
+	HostCheck(ok && (HostU32(HostEp0.InData) == CY_U3P_ERROR_BAD_ARGUMENT) && (HostU32(HostEp0.InData + 4) == HOST_CAPTURE_STATE_OFF) &&
+			(HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Bytes == 0) && (stats->Bursts == 0),
+			"capture triggered on the data ready pin fails the stream start (status 0x%x, %u bytes streamed)",
+			HostU32(HostEp0.InData), HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Bytes);
+
+	/* Turn the capture back off */
+	CyU3PMemSet(captureData, 0, sizeof(captureData));
+	HostVendorOut(HOST_TRIGGER_CAPTURE, 0, HOST_CAPTURE_CONFIG_CMD, captureData, sizeof(captureData));
+}
+
+/**
+  * @brief Burst stream capture for each trigger source, with the trigger well after the ring has wrapped. The PC must
+  * get exactly the pre and post trigger bursts, oldest first and consecutive, with the trigger burst the first one
+  * read after the trigger. Multi packet USB buffers are used, so the stream length shows the number of bursts sent.
+ **/
+static void HostCheckCapture(uint8_t source)
+{
+	static const char *sourceNames[] = {"host command", "pin edge", "register threshold"};
+	const uint32_t numBursts = HOST_CAPTURE_PRE_SAMPLES + HOST_CAPTURE_POST_SAMPLES;
+	HostDutConfig config;
+	uint8_t captureData[16] = {0};
+	uint8_t startData[10];
+	const uint8_t *data;
+	uint32_t triggerSample = 0, firstSample, badFrames = numBursts, triggerLag = 0;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	/* The pin trigger is an edge on DIO2, after HOST_CAPTURE_TRIGGER_SAMPLES data ready periods */
+	if(source == HOST_CAPTURE_TRIGGER_PIN)
+	{
+		config.EventPin = HOST_DUT_PIN_DIO2;
+		config.EventNs = HostSimNs + (HOST_CAPTURE_TRIGGER_SAMPLES * config.DrPeriodNs) + (config.DrPeriodNs / 3);
+	}
+	HostDutConfigure(&config);
+	ok = HostSetSclk(1000000);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, HOST_DUT_PIN_DIO1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_BUFFER_PACKETS, 2);
+
+	HostPutU32(captureData, HOST_CAPTURE_PRE_SAMPLES);
+	HostPutU32(captureData + 4, HOST_CAPTURE_POST_SAMPLES);
+	captureData[8] = source;
+	captureData[9] = HOST_DUT_PIN_DIO2;
+	captureData[10] = 1;
+	/* The threshold is the DATA_CNTR word of the burst (after the command word), crossed upwards, MSB first */
+	if(source == HOST_CAPTURE_TRIGGER_THRESHOLD)
+	{
+		triggerSample = HostDutSampleCount(HostSimNs) + HOST_CAPTURE_TRIGGER_SAMPLES;
+		captureData[12] = 18;
+		captureData[14] = (uint8_t) triggerSample;
+		captureData[15] = (uint8_t) (triggerSample >> 8);
+	}
+	ok &= HostVendorOut(HOST_TRIGGER_CAPTURE, 0, HOST_CAPTURE_CONFIG_CMD, captureData, sizeof(captureData));
+
+	HostPutU32(startData, HOST_NUM_BURSTS);
+	HostPutU32(startData + 4, HOST_BURST_BYTES);
+	startData[8] = (uint8_t) (config.BurstCmd >> 8);
+	startData[9] = (uint8_t) config.BurstCmd;
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+
+	if(source == HOST_CAPTURE_TRIGGER_HOST)
+	{
+		CyU3PThreadSleep(HOST_CAPTURE_TRIGGER_SAMPLES * config.DrPeriodNs / 1000000);
+		triggerSample = HostDutSampleCount(HostSimNs);
+		ok &= HostVendorOut(HOST_TRIGGER_CAPTURE, 0, HOST_CAPTURE_TRIGGER_CMD, NULL, 0);
+	}
+	else if(source == HOST_CAPTURE_TRIGGER_PIN)
+	{
+		triggerSample = HostDutSampleCount(config.EventNs);
+	}
+
+	/* Wait a while after the capture is sent, so any extra data shows up */
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, numBursts * HOST_BURST_BYTES, 1000);
+	CyU3PThreadSleep(20);
+	ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	ok &= (HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Bytes == numBursts * HOST_BURST_BYTES);
+
+	if(ok)
+	{
+		data = HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data;
+		badFrames = HostBadBursts(data, numBursts);
+		firstSample = HostWireWord(data + 2 + 16);
+		triggerLag = firstSample + HOST_CAPTURE_PRE_SAMPLES - triggerSample;
+	}
+	ok &= HostVendorIn(HOST_TRIGGER_CAPTURE, 0, HOST_CAPTURE_STATUS_CMD, 28);
+
+	/* The trigger burst is the one read for the next data ready (the burst in progress when the host command arrives
+	 * may also take it). A threshold crossing fires on the burst holding the threshold sample */
+	HostCheck(ok && (badFrames == 0) && (HostU32(HostEp0.InData + 4) == HOST_CAPTURE_STATE_DONE) &&
+			(HostU32(HostEp0.InData + 12) == HOST_CAPTURE_PRE_SAMPLES) && (HostU32(HostEp0.InData + 16) == HOST_CAPTURE_POST_SAMPLES) &&
+			(HostU32(HostEp0.InData + 20) >= 2 * numBursts) &&
+			((source == HOST_CAPTURE_TRIGGER_THRESHOLD) ? (triggerLag == 0) : (triggerLag <= 1)),
+			"%s capture trigger: %u pre and %u post trigger bursts, %u bad, trigger after %u stored bursts, %u samples after the trigger",
+			sourceNames[source], HostU32(HostEp0.InData + 12), HostU32(HostEp0.InData + 16), badFrames, HostU32(HostEp0.InData + 20),
+			triggerLag);
+
+	/* Turn the capture back off */
+	CyU3PMemSet(captureData, 0, sizeof(captureData));
+	HostVendorOut(HOST_TRIGGER_CAPTURE, 0, HOST_CAPTURE_CONFIG_CMD, captureData, sizeof(captureData));
+	HostSpiConfig(HOST_SPI_CONFIG_BUFFER_PACKETS, 1);
+	HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 0);
+}
+
+/**
+  * @brief SPI pipe. Streams must be refused while it runs, and it must be refused while a stream runs.
+ **/
+static void HostCheckSpiPipe(void)
+{
+	HostDutConfig config;
+	uint8_t pipeData[4], startData[10], mosi[HOST_PIPE_BYTES] = {0};
+	CyBool_t ok, streamRefused, pipeRefused;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	ok = HostSetSclk(1000000);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, HOST_DUT_PIN_DIO1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+
+	HostPutU32(startData, HOST_NUM_BURSTS);
+	HostPutU32(startData + 4, HOST_BURST_BYTES);
+	startData[8] = (uint8_t) (config.BurstCmd >> 8);
+	startData[9] = (uint8_t) config.BurstCmd;
+
+	/* A zero length pipe is refused, and the reason is in the pipe status */
+	HostPutU32(pipeData, 0);
+	ok &= HostVendorOut(HOST_SPI_PIPE, 0, HOST_STREAM_START_CMD, pipeData, sizeof(pipeData)) == CyFalse;
+	ok &= HostVendorIn(HOST_SPI_PIPE, 0, HOST_SPI_PIPE_STATUS_CMD, HOST_SPI_PIPE_STATUS_LENGTH);
+	HostCheck(ok && (HostU32(HostEp0.InData) == CY_U3P_ERROR_BAD_ARGUMENT) && (HostU32(HostEp0.InData + 4) == 0),
+			"zero length SPI pipe refused (pipe status 0x%x)", HostU32(HostEp0.InData));
+	/* Wait out the error log flash writes */
+	CyU3PThreadSleep(100);
+
+	HostPutU32(pipeData, HOST_PIPE_BYTES);
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok = HostVendorOut(HOST_SPI_PIPE, 0, HOST_STREAM_START_CMD, pipeData, sizeof(pipeData));
+	streamRefused = !HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	CyU3PThreadSleep(100);
+	HostUsbBulkOut(HOST_FROM_PC_ENDPOINT, mosi, sizeof(mosi));
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, HOST_PIPE_BYTES, 1000);
+	ok &= HostVendorIn(HOST_SPI_PIPE, 0, HOST_SPI_PIPE_STATUS_CMD, HOST_SPI_PIPE_STATUS_LENGTH);
+	ok &= (HostU32(HostEp0.InData) == CY_U3P_SUCCESS) && (HostU32(HostEp0.InData + 4) == 1) &&
+			(HostU32(HostEp0.InData + 8) == HOST_PIPE_BYTES);
+	ok &= HostVendorOut(HOST_SPI_PIPE, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	HostCheck(ok && streamRefused && (HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Bytes == HOST_PIPE_BYTES),
+			"SPI pipe returned %u of %u bytes, burst stream start refused while it ran",
+			HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Bytes, HOST_PIPE_BYTES);
+
+	/* The pipe start is refused while a stream runs, and the stream is not disturbed */
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok = HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	pipeRefused = !HostVendorOut(HOST_SPI_PIPE, 0, HOST_STREAM_START_CMD, pipeData, sizeof(pipeData));
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, HOST_NUM_BURSTS * HOST_BURST_BYTES, 1000);
+	ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	ok &= HostVendorIn(HOST_SPI_PIPE, 0, HOST_SPI_PIPE_STATUS_CMD, HOST_SPI_PIPE_STATUS_LENGTH);
+	HostCheck(ok && pipeRefused && (HostU32(HostEp0.InData + 4) == 0) &&
+			(HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Bytes == HOST_NUM_BURSTS * HOST_BURST_BYTES),
+			"SPI pipe start refused during a burst stream, which still sent %u bytes", HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Bytes);
+	/* Wait out the error log flash writes */
+	CyU3PThreadSleep(100);
+}
+
+/**
+  * @brief Writes a bulk command request record: tag[0-1], opcode[2], reserved[3], arg0[4-5], arg1[6-7].
+ **/
+static void HostBulkRecord(uint8_t *record, uint16_t tag, uint8_t opcode, uint16_t arg0, uint16_t arg1)
+{
+	record[0] = (uint8_t) tag;
+	record[1] = (uint8_t) (tag >> 8);
+	record[2] = opcode;
+	record[3] = 0;
+	record[4] = (uint8_t) arg0;
+	record[5] = (uint8_t) (arg0 >> 8);
+	record[6] = (uint8_t) arg1;
+	record[7] = (uint8_t) (arg1 >> 8);
+}
+
+/**
+  * @brief Bulk command channel request and response layout. One request writes a register, reads it back and
+  * PROD_ID, delays, and has an unknown opcode, then an end record followed by a read which must not run. The
+  * response must echo the tag and opcode of each record run, with its status and data, after a header with the
+  * first failing status and the record count, and the DUT stall must be met between records. A second
+  * request checks the channel is waiting again, after the SPI pipe has used the PC to FX3 endpoint.
+ **/
+static void HostCheckBulkCommands(void)
+{
+	/* Tag, opcode, arg0, arg1, then the expected response status and data word */
+	const struct
+	{
+		uint16_t Tag;
+		uint8_t Opcode;
+		uint16_t Arg0;
+		uint16_t Arg1;
+		uint8_t Status;
+		uint16_t Data;
+	}records[] = {
+		{0x1001, HOST_BULK_CMD_WRITE_REG, HOST_DUT_PAGE_ID, 0, CY_U3P_SUCCESS, 0},
+		{0x1002, HOST_BULK_CMD_WRITE_REG, HOST_SERIAL_REG, 0x78, CY_U3P_SUCCESS, 0},
+		{0x1003, HOST_BULK_CMD_WRITE_REG, HOST_SERIAL_REG + 1, 0x56, CY_U3P_SUCCESS, 0},
+		{0x1004, HOST_BULK_CMD_READ_REG, HOST_SERIAL_REG, 0, CY_U3P_SUCCESS, 0x5678},
+		{0x1005, HOST_BULK_CMD_DELAY, 100, 0, CY_U3P_SUCCESS, 0},
+		{0x1006, HOST_BULK_CMD_READ_REG, HOST_DUT_PROD_ID, 0, CY_U3P_SUCCESS, 16465},
+		{0x1007, 0x7F, 0, 0, (uint8_t) CY_U3P_ERROR_BAD_ARGUMENT, 0},
+	};
+	const uint32_t numRecords = sizeof(records) / sizeof(records[0]);
+	const HostDutStats *stats = HostDutGetStats();
+	const uint8_t *response, *record;
+	uint8_t request[(sizeof(records) / sizeof(records[0]) + 2) * HOST_BULK_CMD_RECORD_SIZE];
+	uint32_t i, badRecords = numRecords;
+	HostDutConfig config;
+	CyBool_t ok, secondOk;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	for(i = 0; i < numRecords; i++)
+		HostBulkRecord(request + (i * HOST_BULK_CMD_RECORD_SIZE), records[i].Tag, records[i].Opcode, records[i].Arg0, records[i].Arg1);
+	HostBulkRecord(request + (numRecords * HOST_BULK_CMD_RECORD_SIZE), 0x10FF, HOST_BULK_CMD_END, 0, 0);
+	HostBulkRecord(request + ((numRecords + 1) * HOST_BULK_CMD_RECORD_SIZE), 0x1100, HOST_BULK_CMD_READ_REG, HOST_DUT_PROD_ID, 0);
+
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	HostUsbBulkOut(HOST_FROM_PC_ENDPOINT, request, sizeof(request));
+	ok = HostBulkWait(HOST_TO_PC_ENDPOINT, HOST_BULK_CMD_HEADER_SIZE + (numRecords * HOST_BULK_CMD_RECORD_SIZE), 100);
+	/* Nothing past the last record run */
+	CyU3PThreadSleep(1);
+	response = HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data;
+	ok &= (HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Bytes == HOST_BULK_CMD_HEADER_SIZE + (numRecords * HOST_BULK_CMD_RECORD_SIZE));
+	if(ok)
+	{
+		badRecords = 0;
+		for(i = 0; i < numRecords; i++)
+		{
+			record = response + HOST_BULK_CMD_HEADER_SIZE + (i * HOST_BULK_CMD_RECORD_SIZE);
+			if((HostU16(record) != records[i].Tag) || (record[2] != records[i].Opcode) || (record[3] != records[i].Status) ||
+					(HostU32(record + 4) != records[i].Data))
+				badRecords++;
+		}
+	}
+	ok &= (HostU32(response) == CY_U3P_ERROR_BAD_ARGUMENT) && (HostU32(response + 4) == numRecords);
+	ok &= (HostDutReadReg(0, HOST_SERIAL_REG) == 0x5678);
+
+	/* The channel is waiting for the next request */
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	HostUsbBulkOut(HOST_FROM_PC_ENDPOINT, request + (5 * HOST_BULK_CMD_RECORD_SIZE), HOST_BULK_CMD_RECORD_SIZE);
+	secondOk = HostBulkWait(HOST_TO_PC_ENDPOINT, HOST_BULK_CMD_HEADER_SIZE + HOST_BULK_CMD_RECORD_SIZE, 100);
+	response = HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data;
+	secondOk &= (HostU32(response) == CY_U3P_SUCCESS) && (HostU32(response + 4) == 1) && (HostU16(response + 8) == 0x1006) &&
+			(HostU16(response + 12) == 16465);
+
+	HostCheck(ok && (badRecords == 0) && secondOk && (stats->StallViolations == 0), "bulk command request of %u records (end record, "
+			"then a read): %u bad response records, %u stall violations, second request %s", numRecords + 2, badRecords,
+			stats->StallViolations, secondOk ? "answered" : "not answered");
+}
+
+/**
+  * @brief Trace ring read (ADI_READ_TRACE). The ring is read and cleared, then a generic stream of
+  * HOST_TRACE_SAMPLES runs, and the next read must hold exactly what happened since: the end of the clearing
+  * read, the stream start request, a data ready wait and sample per sample, in order, one full USB buffer commit,
+  * then the read request itself. The header must count the records sent and give the timer rate. The stream restarts
+  * the timer for each sample, so ticks must only increase outside the stream, and each sample must be traced within
+  * a data ready period of its restart. Builds without TRACE_MODE must refuse the read and send nothing.
+ **/
+static void HostCheckTrace(void)
+{
+#ifndef TRACE_MODE
+	CyBool_t ok;
+
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	ok = HostVendorIn(HOST_READ_TRACE, HOST_TRACE_CLEAR, 0, 4) && (HostU32(HostEp0.InData) == CY_U3P_ERROR_NOT_SUPPORTED);
+	ok &= !HostBulkWait(HOST_TO_PC_ENDPOINT, 1, 10);
+	HostCheck(ok, "trace ring read refused without TRACE_MODE (status 0x%x, %u bytes on the bulk endpoint)",
+			HostU32(HostEp0.InData), HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Bytes);
+#else
+	HostDutConfig config;
+	const uint8_t *response, *record;
+	uint8_t startData[12] = {0};
+	uint32_t numRecords = 0, i, event, sample = 0, drWaits = 0, commits = 0, badRecords = 0, lastTick = 0;
+	uint32_t expectedTicks, badTicks = 0, startIndex = 0;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	expectedTicks = (uint32_t) ((config.DrPeriodNs * HOST_TIMER_HZ) / 1000000000ULL);
+	ok = HostSetSclk(1000000);
+	ok &= HostWriteByte(HOST_DUT_PAGE_ID, 0);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, config.DrPin);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_POLARITY, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	ok &= HostVendorIn(HOST_READ_TRACE, HOST_TRACE_CLEAR, 0, 4);
+	ok &= (HostU32(HostEp0.InData) == CY_U3P_SUCCESS) && HostBulkWait(HOST_TO_PC_ENDPOINT, HOST_TRACE_HEADER_BYTES, 100);
+
+	/* Buffers[0-3], captures[4-7], then the register list */
+	HostPutU32(startData, HOST_TRACE_SAMPLES);
+	HostPutU32(startData + 4, 1);
+	startData[9] = HOST_DUT_DATA_CNTR;
+	startData[11] = HOST_DUT_PROD_ID;
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok &= HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, HOST_STREAM_BUFFER_BYTES, 1000);
+
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	ok &= HostVendorIn(HOST_READ_TRACE, 0, 0, 4) && (HostU32(HostEp0.InData) == CY_U3P_SUCCESS);
+	ok &= HostBulkWait(HOST_TO_PC_ENDPOINT, HOST_TRACE_HEADER_BYTES, 100);
+	response = HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data;
+	numRecords = HostU32(response + 4);
+	ok &= (HostU32(response) == CY_U3P_SUCCESS) && (HostU32(response + 8) == numRecords) && (HostU32(response + 12) == HOST_TIMER_HZ) &&
+			(HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Bytes == HOST_TRACE_HEADER_BYTES + (numRecords * HOST_TRACE_RECORD_BYTES)) &&
+			(numRecords > 5);
+	HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 0);
+
+	for(i = 0; ok && (i < numRecords); i++)
+	{
+		record = response + HOST_TRACE_HEADER_BYTES + (i * HOST_TRACE_RECORD_BYTES);
+		event = HostU32(record + 4);
+		if(((i == 1) || (i == 2) || (i == numRecords - 1)) && (HostU32(record) <= lastTick))
+			badTicks++;
+		lastTick = HostU32(record);
+		if(i == 0)
+		{
+			/* The clearing read finished after the ring was copied */
+			if((event != HOST_TRACE_COMMAND_DONE) || (HostU32(record + 8) != HOST_READ_TRACE) || (HostU32(record + 12) != CY_U3P_SUCCESS))
+				badRecords++;
+		}
+		else if(i == 1)
+		{
+			if((event != HOST_TRACE_VENDOR_REQUEST) || (HostU32(record + 8) != HOST_STREAM_GENERIC_DATA) ||
+					(HostU32(record + 12) != ((uint32_t) HOST_STREAM_START_CMD << 16)))
+				badRecords++;
+		}
+		else if(i == numRecords - 2)
+		{
+			if((event != HOST_TRACE_VENDOR_REQUEST) || (HostU32(record + 8) != HOST_READ_TRACE) || (HostU32(record + 12) != 0))
+				badRecords++;
+		}
+		else if(i == numRecords - 1)
+		{
+			if((event != HOST_TRACE_COMMAND_START) || (HostU32(record + 8) != HOST_READ_TRACE))
+				badRecords++;
+		}
+		else if(event == HOST_TRACE_STREAM_START)
+		{
+			if((HostU32(record + 8) != 1) || (startIndex != 0))
+				badRecords++;
+			startIndex = i;
+		}
+		else if(event == HOST_TRACE_DR_WAIT_START)
+		{
+			if((startIndex == 0) || (HostU32(record + 8) != 1) || (HostU32(record + 12) != sample) || (drWaits++ != sample))
+				badRecords++;
+		}
+		else if(event == HOST_TRACE_SAMPLE_READY)
+		{
+			if((drWaits != sample + 1) || (HostU32(record + 8) != 1) || (HostU32(record + 12) != sample))
+				badRecords++;
+			if(HostU32(record) >= expectedTicks)
+				badTicks++;
+			sample++;
+		}
+		else if(event == HOST_TRACE_USB_COMMIT)
+		{
+			if((sample != HOST_TRACE_SAMPLES) || (HostU32(record + 8) != HOST_STREAM_BUFFER_BYTES) || (HostU32(record + 12) != 1))
+				badRecords++;
+			commits++;
+		}
+		else
+		{
+			badRecords++;
+		}
+	}
+
+	HostCheck(ok && (badRecords == 0) && (badTicks == 0) && (sample == HOST_TRACE_SAMPLES) && (commits == 1),
+			"trace ring read: %u records around a %u sample generic stream, %u bad, %u samples, %u commits, %u bad ticks",
+			numRecords, HOST_TRACE_SAMPLES, badRecords, sample, commits, badTicks);
+#endif
+}
+
+#ifdef CPU_LOAD_MODE
+/**
+  * @brief Reads the CPU load (ADI_GET_CPU_LOAD) into contextMs, and checks the response length and status, and
+  * that the context run times add up to the window length.
+  *
+  * @return The window length in ms, or 0 if the read failed.
+ **/
+static uint32_t HostReadCpuLoad(uint16_t options, uint32_t *load, uint32_t *loopsPerMs, uint32_t *contextMs)
+{
+	uint32_t context, totalMs = 0;
+
+	if(!HostVendorIn(HOST_GET_CPU_LOAD, options, 0, HOST_CPU_LOAD_LENGTH) || (HostEp0.InLength != HOST_CPU_LOAD_LENGTH) ||
+			(HostU32(HostEp0.InData) != CY_U3P_SUCCESS))
+		return 0;
+	*load = HostU32(HostEp0.InData + 8);
+	*loopsPerMs = HostU32(HostEp0.InData + 12);
+	for(context = 0; context < HOST_CPU_LOAD_CONTEXTS; context++)
+	{
+		contextMs[context] = HostU32(HostEp0.InData + 16 + (4 * context));
+		totalMs += contextMs[context];
+	}
+	if((totalMs != HostU32(HostEp0.InData + 4)) || (*load > 10000) ||
+			(HostU32(HostEp0.InData + 40) > contextMs[HOST_CPU_CONTEXT_IDLE] * 1000))
+		return 0;
+	return totalMs;
+}
+#endif
+
+/**
+  * @brief CPU load read (ADI_GET_CPU_LOAD). The idle loop rate must stay uncalibrated (0, with no load) until a
+  * counter clear with no stream running: a clear during an interrupt mode stream, where the idle thread runs between
+  * samples, must not calibrate or hold up the stream. After
+  * calibration, an idle window must read as mostly idle with a low load, and a window with a polled data ready
+  * generic stream must read as mostly stream thread time with a high load. Each window must be as long as the
+  * time between its clears. Builds without CPU_LOAD_MODE must refuse the read.
+ **/
+static void HostCheckCpuLoad(void)
+{
+#ifndef CPU_LOAD_MODE
+	CyBool_t ok;
+
+	ok = HostVendorIn(HOST_GET_CPU_LOAD, 0, 0, HOST_CPU_LOAD_LENGTH) && (HostEp0.InLength == 4) &&
+			(HostU32(HostEp0.InData) == CY_U3P_ERROR_NOT_SUPPORTED);
+	HostCheck(ok, "CPU load read refused without CPU_LOAD_MODE (status 0x%x, %u bytes)", HostU32(HostEp0.InData), HostEp0.InLength);
+#else
+	const HostDutStats *stats = HostDutGetStats();
+	HostDutConfig config;
+	uint8_t startData[12] = {0};
+	uint32_t load = 0, loopsPerMs = 0, contextMs[HOST_CPU_LOAD_CONTEXTS] = {0}, idleMs, idleLoad, streamMs, streamLoad;
+	uint32_t uncalibratedLoad, streamLoopsPerMs, idleContextMs, streamContextMs;
+	uint64_t startNs;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	HostDutConfigure(&config);
+	ok = HostSetSclk(1000000);
+	ok &= HostWriteByte(HOST_DUT_PAGE_ID, 0);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, config.DrPin);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_POLARITY, 1);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+
+	/* Not calibrated yet, so no load */
+	ok &= (HostReadCpuLoad(0, &uncalibratedLoad, &loopsPerMs, contextMs) != 0) && (loopsPerMs == 0) && (uncalibratedLoad == 0);
+
+	/* Buffers[0-3], captures[4-7], then the register list */
+	HostPutU32(startData, HOST_CPU_LOAD_SAMPLES);
+	HostPutU32(startData + 4, 1);
+	startData[9] = HOST_DUT_DATA_CNTR;
+	startData[11] = HOST_DUT_PROD_ID;
+
+	/* A clear during a stream must not calibrate, or hold up the stream. In interrupt mode the idle thread runs
+	 * between samples, so it would see a calibration request */
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_INTERRUPT, 1);
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	HostDutClearStats();
+	ok &= HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	CyU3PThreadSleep(10);
+	ok &= (HostReadCpuLoad(HOST_CPU_LOAD_CLEAR, &load, &loopsPerMs, contextMs) != 0);
+	CyU3PThreadSleep(5 * 20);
+	ok &= (HostReadCpuLoad(0, &load, &streamLoopsPerMs, contextMs) != 0);
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, 4 * HOST_CPU_LOAD_SAMPLES, 1000);
+	ok &= HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	ok &= HostVendorIn(HOST_GET_STREAM_STATS, 0, 0, HOST_STREAM_STATS_LENGTH) && (HostU32(HostEp0.InData + HOST_STREAM_STATS_MISSED_DR) == 0);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_INTERRUPT, 0);
+
+	/* Calibrate, then an idle window */
+	ok &= (HostReadCpuLoad(HOST_CPU_LOAD_CLEAR, &load, &loopsPerMs, contextMs) != 0);
+	CyU3PThreadSleep(50);
+	ok &= (HostReadCpuLoad(HOST_CPU_LOAD_CLEAR, &load, &loopsPerMs, contextMs) != 0) && (loopsPerMs != 0);
+	startNs = HostSimNs;
+	CyU3PThreadSleep(HOST_CPU_LOAD_WINDOW_MS);
+	idleMs = HostReadCpuLoad(HOST_CPU_LOAD_CLEAR, &idleLoad, &loopsPerMs, contextMs);
+	idleContextMs = contextMs[HOST_CPU_CONTEXT_IDLE];
+	ok &= (idleMs != 0) && (idleMs + 1 >= (HostSimNs - startNs) / 1000000) && (idleMs <= (HostSimNs - startNs) / 1000000 + 1);
+
+	/* A polled data ready stream spins on the pin, so it is all stream thread time */
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	startNs = HostSimNs;
+	ok &= HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, 4 * HOST_CPU_LOAD_SAMPLES, 1000);
+	streamMs = HostReadCpuLoad(HOST_CPU_LOAD_CLEAR, &streamLoad, &loopsPerMs, contextMs);
+	streamContextMs = contextMs[HOST_CPU_CONTEXT_STREAM];
+	ok &= (streamMs != 0) && (streamMs + 1 >= (HostSimNs - startNs) / 1000000) && (streamMs <= (HostSimNs - startNs) / 1000000 + 1);
+	ok &= HostVendorOut(HOST_STREAM_GENERIC_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 0);
+
+	HostCheck(ok && (streamLoopsPerMs == 0) && (stats->StallViolations == 0) && (idleContextMs * 10 >= idleMs * 9) && (idleLoad < 1000) &&
+			(streamContextMs * 10 >= streamMs * 9) && (streamLoad > 9000),
+			"CPU load: %u idle loops per ms (%u during a stream), idle window %u ms with %u ms idle and %.2f%% load, stream window %u ms "
+			"with %u ms in StreamThread and %.2f%% load", loopsPerMs, streamLoopsPerMs, idleMs, idleContextMs, idleLoad / 100.0, streamMs,
+			streamContextMs, streamLoad / 100.0);
+#endif
+}
+
+/**
+  * @brief Logic analyzer stream of the IMU data ready pin. The run records must add up to the sample count
+  * plus the sample times the firmware was late for, only hold the masked pin, and the runs between edges
+  * must match the data ready high and low times.
+ **/
+static void HostCheckLogicAnalyzer(void)
+{
+	HostDutConfig config;
+	const uint8_t *record;
+	uint8_t startData[12];
+	uint32_t buffers = 0, runs = 0, badRuns = 0, badStates = 0, samples = 0, missed = 0, expected[2], runLength, state, i;
+	int lastState = -1;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, HostDutImu);
+	config.DrHighNs = HOST_LOGIC_DR_HIGH_NS;
+	HostDutConfigure(&config);
+	expected[0] = (uint32_t) (((config.DrPeriodNs - config.DrHighNs) * (HOST_TIMER_HZ / 1000)) / (HOST_LOGIC_PERIOD_TICKS * 1000000ULL));
+	expected[1] = (uint32_t) ((config.DrHighNs * (HOST_TIMER_HZ / 1000)) / (HOST_LOGIC_PERIOD_TICKS * 1000000ULL));
+
+	HostPutU32(startData, HOST_LOGIC_PERIOD_TICKS);
+	HostPutU32(startData + 4, HOST_LOGIC_SAMPLES);
+	HostPutU32(startData + 8, 1 << HOST_DUT_PIN_DIO1);
+
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	ok = HostVendorOut(HOST_LOGIC_ANALYZER_STREAM, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	while(ok && (samples < HOST_LOGIC_SAMPLES) && HostBulkWait(HOST_STREAMING_ENDPOINT, (buffers + 1) * HOST_STREAM_BUFFER_BYTES, 1000))
+	{
+		record = HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data + (buffers * HOST_STREAM_BUFFER_BYTES);
+		for(i = 0; i < HOST_STREAM_BUFFER_BYTES; i += HOST_LOGIC_RECORD_BYTES)
+		{
+			state = HostU16(record + i);
+			runLength = HostU16(record + i + 2);
+			if(runLength == 0)
+				continue;
+			if(state & ~(1 << HOST_DUT_PIN_DIO1))
+				badStates++;
+			state = (state >> HOST_DUT_PIN_DIO1) & 1;
+			/* The first run starts part way through a level, and the last is cut off by the sample count */
+			if((lastState >= 0) && (samples + runLength < HOST_LOGIC_SAMPLES) &&
+					((state == (uint32_t) lastState) || (runLength + 1 < expected[state]) || (runLength > expected[state] + 1)))
+				badRuns++;
+			lastState = (int) state;
+			samples += runLength;
+			runs++;
+		}
+		buffers++;
+	}
+	ok &= HostVendorOut(HOST_LOGIC_ANALYZER_STREAM, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	ok &= HostVendorIn(HOST_GET_STREAM_STATS, 0, 0, HOST_STREAM_STATS_LENGTH);
+	if(ok)
+		missed = HostU32(HostEp0.InData + HOST_STREAM_STATS_MISSED_DR);
+
+	HostCheck(ok && (samples == HOST_LOGIC_SAMPLES + missed) && (runs > 10) && (badRuns == 0) && (badStates == 0),
+			"logic analyzer: %u samples (%u late) in %u runs over %u buffers, %u bad runs (%u low, %u high expected), %u bad pin states",
+			samples, missed, runs, buffers, badRuns, expected[0], expected[1], badStates);
+}
+
+/**
+  * @brief Per-period data ready capture on the command worker. Every raw period returned on the bulk endpoint
+  * must match the DUT data ready period, and the summary must agree with the raw periods.
+ **/
+static void HostCheckPeriodCapture(uint32_t drPeriodNs, uint32_t numPeriods, uint8_t options)
+{
+	HostDutConfig config;
+	const uint8_t *xfer, *summary = NULL;
+	uint8_t request[18] = {0};
+	uint32_t offset = 0, transfers = 0, periods = 0, badPeriods = 0, histCount = 0, expected, period, count, minPeriod = 0xFFFFFFFF, maxPeriod = 0, i;
+	uint64_t sum = 0;
+	CyBool_t ok, last = CyFalse, summaryOk = CyFalse;
+
+	HostDutDefaults(&config, HostDutImu);
+	config.DrPeriodNs = drPeriodNs;
+	config.DrHighNs = drPeriodNs / 5;
+	HostDutConfigure(&config);
+	expected = (uint32_t) (((uint64_t) drPeriodNs * HOST_TIMER_HZ) / 1000000000ULL);
+
+	/* DIO1 rising edges, 1 second timeout */
+	request[0] = HOST_DUT_PIN_DIO1;
+	request[2] = 1;
+	HostPutU32(request + 3, HOST_TIMER_HZ);
+	HostPutU32(request + 11, numPeriods);
+	request[15] = HOST_PERIOD_BIN_WIDTH;
+	request[17] = options;
+
+	HostUsbInClear(HOST_TO_PC_ENDPOINT);
+	ok = HostVendorOut(HOST_MEASURE_DR_PERIODS, 0, 0, request, sizeof(request));
+	while(ok && !last && HostBulkWait(HOST_TO_PC_ENDPOINT, offset + HOST_PERIOD_HEADER_BYTES, 2000))
+	{
+		xfer = HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data + offset;
+		count = HostU32(xfer + 8);
+		last = (CyBool_t) ((HostU32(xfer + 4) & HOST_PERIOD_XFER_LAST) != 0);
+		if((HostU32(xfer) != CY_U3P_SUCCESS) || !HostBulkWait(HOST_TO_PC_ENDPOINT, offset + HOST_PERIOD_HEADER_BYTES + (count * 4) +
+				(last ? HOST_PERIOD_SUMMARY_BYTES : 0), 1000))
+		{
+			ok = CyFalse;
+			break;
+		}
+		xfer = HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data + offset;
+		for(i = 0; i < count; i++)
+		{
+			period = HostU32(xfer + HOST_PERIOD_HEADER_BYTES + (4 * i));
+			if((period + HOST_PERIOD_MAX_ERROR_TICKS < expected) || (period > expected + HOST_PERIOD_MAX_ERROR_TICKS))
+				badPeriods++;
+			if(period < minPeriod)
+				minPeriod = period;
+			if(period > maxPeriod)
+				maxPeriod = period;
+			sum += period;
+		}
+		periods += count;
+		offset += HOST_PERIOD_HEADER_BYTES + (count * 4);
+		if(last)
+			summary = HostUsbIn[HOST_TO_PC_ENDPOINT & 0xF].Data + offset;
+		transfers++;
+	}
+
+	/* Summary: measured, returned, dropped, min, max, mean (1/256 tick), std dev, histogram start, bin width, bins */
+	if(ok && (summary != NULL) && (periods != 0))
+	{
+		for(i = 0; i < HOST_PERIOD_HIST_BINS; i++)
+			histCount += HostU32(summary + 36 + (4 * i));
+		summaryOk = (CyBool_t) ((HostU32(summary) == numPeriods) && (HostU32(summary + 4) == periods) && (HostU32(summary + 8) == 0) &&
+				(HostU32(summary + 12) == minPeriod) && (HostU32(summary + 16) == maxPeriod) &&
+				((HostU32(summary + 20) >> 8) == (uint32_t) (sum / periods)) && (HostU32(summary + 32) == HOST_PERIOD_BIN_WIDTH) &&
+				(histCount == numPeriods));
+	}
+
+	HostCheck(ok && last && summaryOk && (periods == numPeriods) && (badPeriods == 0),
+			"%u data ready periods of %u ticks%s: %u transfers, %u bad periods, min %u, max %u, summary %s",
+			periods, expected, (options & HOST_PERIOD_OPTION_STREAM) ? " streamed" : "", transfers, badPeriods,
+			minPeriod, maxPeriod, summaryOk ? "matches" : "does not match");
+}
+
+/**
+  * @brief ADcmXL real time stream, on the DIO2 BUSY signal, started by the GLOB_CMD write.
+ **/
+static void HostCheckRealTimeStream(HostDutType type)
+{
+	HostDutConfig config;
+	const HostDutStats *stats = HostDutGetStats();
+	uint32_t frameBytes = HostDutFrameBytes(type), numWords = frameBytes / 2, frameIndex, firstFrame, word, badFrames = 0;
+	uint8_t startData[5] = {0};
+	uint8_t *frame;
+	uint64_t startNs;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, type);
+	HostDutConfigure(&config);
+	ok = HostSetSclk(config.MaxSclkHz);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DUT_TYPE, type);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, HOST_DUT_PIN_DIO2);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_POLARITY, 1);
+
+	/* Number of frames, then pin start off (start with GLOB_CMD) */
+	HostPutU32(startData, HOST_NUM_RT_FRAMES);
+
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+	startNs = HostSimNs;
+	ok &= HostVendorOut(HOST_STREAM_REALTIME, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+	ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, HOST_NUM_RT_FRAMES * frameBytes, 1000);
+	ok &= HostVendorOut(HOST_STREAM_REALTIME, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+
+	firstFrame = 0;
+	for(frameIndex = 0; ok && (frameIndex < HOST_NUM_RT_FRAMES); frameIndex++)
+	{
+		frame = HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data + (frameIndex * frameBytes);
+		if(frameIndex == 0)
+			firstFrame = HostWireWord(frame + frameBytes - 6);
+		for(word = 0; word < numWords - 4; word++)
+		{
+			if(HostWireWord(frame + (2 * word)) != HostDutSampleWord(firstFrame + frameIndex, word))
+				break;
+		}
+		if((word != numWords - 4) || (HostWireWord(frame + frameBytes - 6) != (uint16_t) (firstFrame + frameIndex)) ||
+			(HostWireWord(frame + frameBytes - 2) != HostByteSum(frame, frameBytes - 2)))
+			badFrames++;
+	}
+
+	HostCheck(ok && (badFrames == 0) && (stats->RealTimeFrames == HOST_NUM_RT_FRAMES) && (stats->StallViolations == 0) &&
+			(stats->SclkViolations == 0), "ADcmXL real time stream, %u byte frames: %u frames, %u bad (%.1f us per frame)", frameBytes,
+			stats->RealTimeFrames, badFrames, (HostSimNs - startNs) / 1e3 / HOST_NUM_RT_FRAMES);
+}
+
+/** Stream workers run by the benchmark */
+typedef enum HostBenchWorker
+{
+	HostBenchGeneric = 0,
+	HostBenchTransfer,
+	HostBenchBurst,
+	HostBenchRealTime,
+	HostBenchI2c
+}HostBenchWorker;
+
+/** CSV name and vendor request of each benchmarked worker, in HostBenchWorker order */
+static const struct
+{
+	const char *Name;
+	uint8_t Request;
+}HostBenchWorkers[] = {
+	{"generic", HOST_STREAM_GENERIC_DATA},
+	{"transfer", HOST_TRANSFER_STREAM},
+	{"burst", HOST_STREAM_BURST_DATA},
+	{"realtime", HOST_STREAM_REALTIME},
+	{"i2c", HOST_I2C_READ_STREAM}
+};
+
+/**
+  * @brief Starts a benchmark stream of HOST_BENCH_SAMPLES samples. Only the real time stream waits for the DUT,
+  * the others run with data ready off, so each sample starts as soon as the worker is ready for it.
+  *
+  * listWords is the number of 16-bit words per sample (bytes for I2C), and clockHz the SCLK (I2C bit rate for I2C).
+ **/
+static CyBool_t HostBenchStart(HostBenchWorker worker, uint32_t listWords, uint32_t clockHz)
+{
+	HostDutConfig config;
+	uint8_t data[256] = {0};
+	uint16_t length = 0;
+	uint32_t i;
+	CyBool_t ok;
+
+	HostDutDefaults(&config, (worker == HostBenchRealTime) ? HostDutADcmXL3021 : HostDutImu);
+	if(worker == HostBenchRealTime)
+	{
+		/* The frame size picks the ADcmXL part */
+		config.Type = (listWords * 2 == HostDutFrameBytes(HostDutADcmXL1021)) ? HostDutADcmXL1021 :
+				(listWords * 2 == HostDutFrameBytes(HostDutADcmXL2021)) ? HostDutADcmXL2021 : HostDutADcmXL3021;
+	}
+	/* SCLK is swept past the part limits, which only affect the data the DUT model returns */
+	config.MaxSclkHz = HOST_BENCH_MAX_SCLK_HZ;
+	config.BurstMaxSclkHz = HOST_BENCH_MAX_SCLK_HZ;
+	HostDutConfigure(&config);
+	HostUsbInClear(HOST_STREAMING_ENDPOINT);
+
+	ok = HostSpiConfig(HOST_SPI_CONFIG_STALL, HOST_DEFAULT_STALL_US);
+	ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 0);
+	if(worker != HostBenchI2c)
+		ok &= HostSetSclk(clockHz);
+
+	switch(worker)
+	{
+	case HostBenchGeneric:
+		/* Buffers[0-3], captures[4-7], then the register list: {0, addr} reads of the data output registers */
+		HostPutU32(data, HOST_BENCH_SAMPLES);
+		HostPutU32(data + 4, 1);
+		for(i = 0; i < listWords; i++)
+			data[9 + (2 * i)] = (uint8_t) (0x04 + (2 * (i % 14)));
+		length = (uint16_t) (8 + (2 * listWords));
+		break;
+	case HostBenchTransfer:
+		/* Captures[0-3], buffers[4-7], bytes per USB packet[8-11], MOSI byte count[12-13], MOSI data */
+		HostPutU32(data, 1);
+		HostPutU32(data + 4, HOST_BENCH_SAMPLES);
+		HostPutU32(data + 8, HOST_STREAM_BUFFER_BYTES);
+		data[12] = (uint8_t) (2 * listWords);
+		for(i = 0; i < listWords; i++)
+			data[15 + (2 * i)] = (uint8_t) (0x04 + (2 * (i % 14)));
+		length = (uint16_t) (14 + (2 * listWords));
+		break;
+	case HostBenchBurst:
+		/* Bursts[0-3], burst bytes[4-7], burst command[8-9] */
+		HostPutU32(data, HOST_BENCH_SAMPLES);
+		HostPutU32(data + 4, 2 * listWords);
+		data[8] = (uint8_t) (config.BurstCmd >> 8);
+		data[9] = (uint8_t) config.BurstCmd;
+		length = 10;
+		break;
+	case HostBenchRealTime:
+		/* Frames[0-3], then pin start off (start with GLOB_CMD) */
+		ok &= HostSpiConfig(HOST_SPI_CONFIG_DUT_TYPE, config.Type);
+		ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, HOST_DUT_PIN_DIO2);
+		ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_POLARITY, 1);
+		HostPutU32(data, HOST_BENCH_SAMPLES);
+		length = 5;
+		break;
+	case HostBenchI2c:
+		/* Bytes[0-3], timeout[4-7], preamble length[8], control mask[9-10] and a read from EEPROM address 0[11-14],
+		 * then buffers[15-18] */
+		ok &= HostVendorIn(HOST_I2C_SET_BIT_RATE, (uint16_t) clockHz, (uint16_t) (clockHz >> 16), 4) &&
+				(HostU32(HostEp0.InData) == CY_U3P_SUCCESS);
+		HostPutU32(data, listWords);
+		HostPutU32(data + 4, 1000);
+		data[8] = 4;
+		data[9] = 0x04;
+		data[11] = 0xA0;
+		data[14] = 0xA1;
+		HostPutU32(data + 15, HOST_BENCH_SAMPLES);
+		length = 19;
+		break;
+	}
+	return ok && HostVendorOut(HostBenchWorkers[worker].Request, 0, HOST_STREAM_START_CMD, data, length);
+}
+
+/**
+  * @brief Starts and stops each benchmarked stream type in turn, HOST_RESTART_ROUNDS times. The streams keep their
+  * DMA channels in a pool, so after the first round the DMA buffer heap must be the same after every round, whichever
+  * stream ran last. Each stream is stopped while it runs, and must finish within HOST_RESTART_STOP_MS.
+ **/
+static void HostCheckStreamRestarts(void)
+{
+	uint32_t round, worker, buffers, bytes, startBuffers = 0, startBytes = 0, heapChanges = 0, failedStops = 0;
+	uint64_t deadline;
+	CyBool_t ok = CyTrue, stopped;
+
+	for(round = 0; round < HOST_RESTART_ROUNDS; round++)
+	{
+		for(worker = HostBenchGeneric; worker <= HostBenchI2c; worker++)
+		{
+			ok &= HostBenchStart((HostBenchWorker) worker, HOST_RESTART_LIST_WORDS, HOST_RESTART_CLOCK_HZ);
+			CyU3PThreadSleep(1);
+			ok &= HostVendorIn(HostBenchWorkers[worker].Request, 0, HOST_STREAM_STOP_CMD, 4) &&
+					(HostU32(HostEp0.InData) == CY_U3P_SUCCESS);
+			deadline = HostDeadline(HOST_RESTART_STOP_MS);
+			do
+			{
+				stopped = HostVendorIn(HOST_GET_STREAM_STATS, 0, 0, HOST_STREAM_STATS_LENGTH) &&
+						(HostU32(HostEp0.InData + HOST_STREAM_STATS_ACTIVE) == 0);
+				if(!stopped)
+					CyU3PThreadSleep(1);
+			} while(!stopped && (HostSimNs < deadline));
+			if(!stopped)
+				failedStops++;
+		}
+		buffers = HostDmaBuffersInUse(&bytes);
+		if(round == 0)
+		{
+			startBuffers = buffers;
+			startBytes = bytes;
+		}
+		else if((buffers != startBuffers) || (bytes != startBytes))
+		{
+			heapChanges++;
+		}
+	}
+	HostVendorIn(HOST_I2C_SET_BIT_RATE, (uint16_t) 100000, 0, 4);
+	buffers = HostDmaBuffersInUse(&bytes);
+
+	HostCheck(ok && (failedStops == 0) && (heapChanges == 0), "%u stream starts and stops: %u not stopped, DMA heap %u buffers "
+			"(%u bytes) after the first round, %u buffers (%u bytes) at the end, changed in %u rounds", HOST_RESTART_ROUNDS * (HostBenchI2c + 1),
+			failedStops, startBuffers, startBytes, buffers, bytes, heapChanges);
+}
+
+/**
+  * @brief Connects at SuperSpeed, then fails the link so the device falls back to high speed. At each speed the
+  * endpoints must use that speed's packet size, with full bursts on the streaming endpoint only at SuperSpeed. The
+  * burst stream DMA buffers must each hold one endpoint burst, with HOST_SPEED_BUFFER_PACKETS packets of buffering
+  * (at least HOST_SPEED_MIN_BUFFERS buffers), and every burst must still be read in order.
+ **/
+static void HostCheckSuperSpeed(void)
+{
+	static const CyU3PUSBSpeed_t speeds[2] = {CY_U3P_SUPER_SPEED, CY_U3P_HIGH_SPEED};
+	const HostDutStats *stats = HostDutGetStats();
+	const CyU3PDmaChannel *channel;
+	HostDutConfig config;
+	uint8_t startData[10];
+	uint32_t i, packetBytes, burstLen, bufferBytes, bufferCount, badConfig, badFrames;
+	uint64_t deadline;
+	CyBool_t ok, stopped;
+
+	for(i = 0; i < 2; i++)
+	{
+		if(speeds[i] == CY_U3P_SUPER_SPEED)
+		{
+			HostUsbConfigure(CY_U3P_SUPER_SPEED);
+			packetBytes = HOST_SPEED_SS_PACKET_BYTES;
+			burstLen = HOST_SPEED_ENDPOINT_BURST;
+		}
+		else
+		{
+			HostUsbLinkFail();
+			packetBytes = HOST_SPEED_HS_PACKET_BYTES;
+			burstLen = 1;
+		}
+		CyU3PThreadSleep(100);
+		bufferBytes = packetBytes * burstLen;
+		bufferCount = HOST_SPEED_BUFFER_PACKETS / burstLen;
+		if(bufferCount < HOST_SPEED_MIN_BUFFERS)
+			bufferCount = HOST_SPEED_MIN_BUFFERS;
+
+		badConfig = 0;
+		if((HostUsbEpConfig(HOST_STREAMING_ENDPOINT)->pcktSize != packetBytes) ||
+				(HostUsbEpConfig(HOST_STREAMING_ENDPOINT)->burstLen != burstLen))
+			badConfig++;
+		if((HostUsbEpConfig(HOST_FROM_PC_ENDPOINT)->pcktSize != packetBytes) || (HostUsbEpConfig(HOST_FROM_PC_ENDPOINT)->burstLen != 1))
+			badConfig++;
+		if((HostUsbEpConfig(HOST_TO_PC_ENDPOINT)->pcktSize != packetBytes) || (HostUsbEpConfig(HOST_TO_PC_ENDPOINT)->burstLen != 1))
+			badConfig++;
+
+		HostDutDefaults(&config, HostDutImu);
+		HostDutConfigure(&config);
+		ok = HostSetSclk(1000000);
+		ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_PIN, HOST_DUT_PIN_DIO1);
+		ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_POLARITY, 1);
+		ok &= HostSpiConfig(HOST_SPI_CONFIG_DR_ACTIVE, 1);
+		HostPutU32(startData, HOST_SPEED_BURSTS);
+		HostPutU32(startData + 4, HOST_BURST_BYTES);
+		startData[8] = (uint8_t) (config.BurstCmd >> 8);
+		startData[9] = (uint8_t) config.BurstCmd;
+
+		HostUsbInClear(HOST_STREAMING_ENDPOINT);
+		ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_START_CMD, startData, sizeof(startData));
+		ok &= HostBulkWait(HOST_STREAMING_ENDPOINT, HOST_SPEED_BURSTS * HOST_BURST_BYTES, 2000);
+		channel = HostDmaConsumer(CY_U3P_UIB_SOCKET_CONS_0 + (HOST_STREAMING_ENDPOINT & 0xF));
+		ok &= HostVendorOut(HOST_STREAM_BURST_DATA, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+		/* Let the stream finish before the link goes down */
+		deadline = HostDeadline(HOST_RESTART_STOP_MS);
+		do
+		{
+			stopped = HostVendorIn(HOST_GET_STREAM_STATS, 0, 0, HOST_STREAM_STATS_LENGTH) &&
+					(HostU32(HostEp0.InData + HOST_STREAM_STATS_ACTIVE) == 0);
+			if(!stopped)
+				CyU3PThreadSleep(1);
+		} while(!stopped && (HostSimNs < deadline));
+		ok &= stopped;
+		if((channel == NULL) || (channel->Config.size != bufferBytes) || (channel->Config.count != bufferCount))
+			badConfig++;
+
+		badFrames = HOST_SPEED_BURSTS;
+		if(ok)
+			badFrames = HostBadBursts(HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Data, HOST_SPEED_BURSTS);
+
+		HostCheck(ok && (badConfig == 0) && (badFrames == 0) && (stats->Bursts == HOST_SPEED_BURSTS) && (stats->StallViolations == 0),
+				"%s: %u byte packets, streaming endpoint burst %u, %u x %u byte stream DMA buffers, %u bad configs, %u bursts, %u bad",
+				(i == 0) ? "SuperSpeed connect" : "USB 3.0 link failure fallback", HostUsbEpConfig(HOST_STREAMING_ENDPOINT)->pcktSize,
+				HostUsbEpConfig(HOST_STREAMING_ENDPOINT)->burstLen, (channel == NULL) ? 0 : channel->Config.count,
+				(channel == NULL) ? 0 : channel->Config.size, badConfig, stats->Bursts, badFrames);
+	}
+}
+
+/**
+  * @brief Runs one benchmark stream and writes its CSV row, from the stream profile phase counters.
+  *
+  * @return CyFalse if the stream did not run all its samples, or the firmware has no stream profiler.
+  *
+  * The data ready wait phase is left out, so the costs are the worker's own. Per SPI word costs are the
+  * transfer and stall time spread over every word of every sample. The max DR rate is the rate the
+  * longest data ready period of the run (data ready wait excluded) could keep up with. The profile reads which
+  * wait for the last sample preempt the worker for a few microseconds each, which shows in the longest period.
+ **/
+static CyBool_t HostBenchRun(FILE *csv, HostBenchWorker worker, uint32_t listWords, uint32_t clockHz)
+{
+	uint32_t count[HOST_PROFILE_NUM_PHASES], phase, ticksPerSec, samples;
+	uint64_t ticks[HOST_PROFILE_NUM_PHASES], busyTicks = 0, deadline;
+	double nsPerTick, maxSampleNs;
+	CyBool_t ok;
+
+	ok = HostBenchStart(worker, listWords, clockHz);
+
+	/* The last sample has started once the profile counts every data ready wait, and the stream is done once
+	 * its data stops after that */
+	deadline = HostDeadline(600000);
+	while(ok && (HostSimNs < deadline) && HostVendorIn(HOST_GET_STREAM_PROFILE, 0, 0, HOST_PROFILE_LENGTH) &&
+			(HostU32(HostEp0.InData) == CY_U3P_SUCCESS) && (HostU32(HostEp0.InData + 16 + (12 * HOST_PROFILE_DR_WAIT)) < HOST_BENCH_SAMPLES))
+	{
+		CyU3PThreadSleep(HOST_BENCH_POLL_MS);
+	}
+	while(ok && (HostSimNs < deadline) && HostBulkWait(HOST_STREAMING_ENDPOINT, HostUsbIn[HOST_STREAMING_ENDPOINT & 0xF].Bytes + 1, HOST_BENCH_IDLE_MS));
+	ok &= HostVendorOut(HostBenchWorkers[worker].Request, 0, HOST_STREAM_DONE_CMD, NULL, 0);
+	ok &= HostVendorIn(HOST_GET_STREAM_PROFILE, 0, 0, HOST_PROFILE_LENGTH);
+	if(!ok || (HostU32(HostEp0.InData) != CY_U3P_SUCCESS))
+	{
+		fprintf(stderr, "%s stream profile not read (status 0x%x). Build with STREAM_PROFILE_MODE (make bench)\n",
+				HostBenchWorkers[worker].Name, HostU32(HostEp0.InData));
+		return CyFalse;
+	}
+
+	ticksPerSec = HostU32(HostEp0.InData + 8);
+	nsPerTick = 1e9 / ticksPerSec;
+	for(phase = 0; phase < HOST_PROFILE_NUM_PHASES; phase++)
+	{
+		count[phase] = HostU32(HostEp0.InData + 16 + (12 * phase));
+		ticks[phase] = HostU32(HostEp0.InData + 20 + (12 * phase)) | ((uint64_t) HostU32(HostEp0.InData + 24 + (12 * phase)) << 32);
+		if(phase != HOST_PROFILE_DR_WAIT)
+			busyTicks += ticks[phase];
+	}
+	samples = count[HOST_PROFILE_DR_WAIT];
+	maxSampleNs = HostU32(HostEp0.InData + 12) * nsPerTick;
+	if(samples == 0)
+		samples = 1;
+
+	fprintf(csv, "%s,%u,%u,%u,%u,%.1f,%.1f,%.1f,%u,%.1f,%.1f,%.1f,%.1f,%.1f,%.0f\n", HostBenchWorkers[worker].Name, listWords, clockHz,
+			HOST_DEFAULT_STALL_US, count[HOST_PROFILE_DR_WAIT], busyTicks * nsPerTick / samples,
+			(ticks[HOST_PROFILE_TRANSFER] + ticks[HOST_PROFILE_STALL]) * nsPerTick / ((double) samples * listWords),
+			count[HOST_PROFILE_DMA] ? ticks[HOST_PROFILE_DMA] * nsPerTick / count[HOST_PROFILE_DMA] : 0.0, count[HOST_PROFILE_DMA],
+			ticks[HOST_PROFILE_TRANSFER] * nsPerTick / samples, ticks[HOST_PROFILE_STALL] * nsPerTick / samples,
+			ticks[HOST_PROFILE_DMA] * nsPerTick / samples, ticks[0] * nsPerTick / samples, maxSampleNs,
+			(maxSampleNs > 0) ? 1e9 / maxSampleNs : 0.0);
+	fflush(csv);
+	printf("%10.3f ms  %-8s %4u %-5s %8.3f MHz: %9.1f ns per sample, max DR %.0f Hz\n", HostSimNs / 1e6, HostBenchWorkers[worker].Name,
+			listWords, (worker == HostBenchI2c) ? "bytes" : "words", clockHz / 1e6, busyTicks * nsPerTick / samples, (maxSampleNs > 0) ? 1e9 / maxSampleNs : 0.0);
+
+	return (CyBool_t) (count[HOST_PROFILE_DR_WAIT] == HOST_BENCH_SAMPLES);
+}
+
+/**
+  * @brief Stream worker benchmark. Sweeps each worker over register list lengths and clocks, one CSV row per run.
+ **/
+static uint32_t HostBench(const char *fileName)
+{
+	static const uint32_t listWords[] = {1, 8, 64};
+	static const uint32_t sclkHz[] = {2000000, 8000000};
+	static const uint32_t rtSclkHz[] = {4000000, 14000000};
+	static const HostDutType rtTypes[] = {HostDutADcmXL1021, HostDutADcmXL3021};
+	static const uint32_t i2cBytes[] = {2, 32};
+	static const uint32_t i2cHz[] = {400000, 1000000};
+	uint32_t i, j, failed = 0;
+	HostDutConfig config;
+	FILE *csv;
+
+	csv = fopen(fileName, "w");
+	if(csv == NULL)
+	{
+		fprintf(stderr, "can't write %s\n", fileName);
+		return 1;
+	}
+	fprintf(csv, "worker,list_words,clock_hz,stall_us,samples,ns_per_sample,ns_per_word,ns_per_dma_commit,dma_commits,"
+			"transfer_ns,stall_ns,dma_ns,other_ns,max_sample_ns,max_dr_hz\n");
+
+	HostDutDefaults(&config, HostDutImu);
+	for(i = 0; i < sizeof(listWords) / sizeof(listWords[0]); i++)
+	{
+		for(j = 0; j < sizeof(sclkHz) / sizeof(sclkHz[0]); j++)
+		{
+			failed += !HostBenchRun(csv, HostBenchGeneric, listWords[i], sclkHz[j]);
+			failed += !HostBenchRun(csv, HostBenchTransfer, listWords[i], sclkHz[j]);
+		}
+	}
+	for(j = 0; j < sizeof(sclkHz) / sizeof(sclkHz[0]); j++)
+		failed += !HostBenchRun(csv, HostBenchBurst, (2 + (2 * config.BurstWords)) / 2, sclkHz[j]);
+	for(i = 0; i < sizeof(rtTypes) / sizeof(rtTypes[0]); i++)
+	{
+		for(j = 0; j < sizeof(rtSclkHz) / sizeof(rtSclkHz[0]); j++)
+			failed += !HostBenchRun(csv, HostBenchRealTime, HostDutFrameBytes(rtTypes[i]) / 2, rtSclkHz[j]);
+	}
+	for(i = 0; i < sizeof(i2cBytes) / sizeof(i2cBytes[0]); i++)
+	{
+		for(j = 0; j < sizeof(i2cHz) / sizeof(i2cHz[0]); j++)
+			failed += !HostBenchRun(csv, HostBenchI2c, i2cBytes[i], i2cHz[j]);
+	}
+
+	fclose(csv);
+	printf("%u benchmark runs failed, %.3f ms simulated, results in %s\n", failed, HostSimNs / 1e6, fileName);
+	return failed;
+}
+
+/**
+  * @brief The simulated PC. Runs at the highest priority, like the USB driver thread.
+ **/
+void HostPcEntry(uint32_t input)
+{
+	HostUsbConfigure(CY_U3P_HIGH_SPEED);
+	/* Let the firmware finish starting the application */
+	CyU3PThreadSleep(100);
+
+	if(BenchFile != NULL)
+	{
+		Failures = HostBench(BenchFile);
+		fflush(stdout);
+		exit(Failures ? 1 : 0);
+	}
+
+	HostCheckBoot();
+	HostCheckTimer();
+	HostCheckRegisterReads();
+	HostCheckDutRegisters();
+	HostCheckDutStall();
+	HostCheckPageCache();
+	HostCheckSpiScript();
+	HostCheckSpiScriptStall();
+	HostCheckSpiSerialized();
+	HostCheckReconnect();
+	HostCheckDebugLog();
+	HostCheckStreamPageCache();
+	HostCheckBurstStream(1000000, CyFalse);
+	HostCheckBurstStream(2000000, CyTrue);
+	HostCheckBurstIsrStream(HOST_ISR_DR_PERIOD_NS);
+	HostCheckBurstIsrStream(HOST_ISR_OVER_RATE_NS);
+	HostCheckDrInterruptWait();
+	HostCheckTimestamps(HOST_STREAM_BURST_DATA);
+	HostCheckTimestamps(HOST_STREAM_GENERIC_DATA);
+	HostCheckTimestamps(HOST_TRANSFER_STREAM);
+	HostCheckTimestamps(HOST_I2C_READ_STREAM);
+	HostCheckExactCommits(HOST_STREAM_GENERIC_DATA);
+	HostCheckExactCommits(HOST_STREAM_BURST_DATA);
+	HostCheckFramedStream();
+	HostCheckOverflowPolicy(HOST_STREAM_OVERFLOW_DROP_NEWEST);
+	HostCheckOverflowPolicy(HOST_STREAM_OVERFLOW_DROP_OLDEST);
+	HostCheckCaptureTriggerPin();
+	HostCheckCapture(HOST_CAPTURE_TRIGGER_HOST);
+	HostCheckCapture(HOST_CAPTURE_TRIGGER_PIN);
+	HostCheckCapture(HOST_CAPTURE_TRIGGER_THRESHOLD);
+	HostCheckSpiPipe();
+	HostCheckBulkCommands();
+	HostCheckTrace();
+	HostCheckCpuLoad();
+	HostCheckLogicAnalyzer();
+	HostCheckPeriodCapture(500000, 100, 0);
+	HostCheckPeriodCapture(50000, 2000, HOST_PERIOD_OPTION_STREAM);
+	HostCheckRealTimeStream(HostDutADcmXL1021);
+	HostCheckRealTimeStream(HostDutADcmXL2021);
+	HostCheckRealTimeStream(HostDutADcmXL3021);
+	HostCheckStreamRestarts();
+	HostCheckSuperSpeed();
+
+	printf("%u checks, %u failed, %.3f ms simulated\n", Checks, Failures, HostSimNs / 1e6);
+	if(HostVerbose)
+		HostPrintThreads();
+	fflush(stdout);
+	exit(Failures ? 1 : 0);
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-v") == 0)
+		{
+			HostVerbose = CyTrue;
+		}
+		else if((strcmp(argv[i], "-bench") == 0) && (i + 1 < argc))
+		{
+			BenchFile = argv[++i];
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [-v] [-bench file.csv]\n", argv[0]);
+			return 2;
+		}
+	}
+	setvbuf(stdout, NULL, _IOLBF, 0);
+
+	HostRegsInit();
+	HostDutInit();
+	return AdiFirmwareMain();
+}
@@ -0,0 +1,762 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		HostOs.c
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 RTOS. Runs each firmware thread on its own pthread, one at a time, in simulated time.
+ **/
+
+/*
+ * Only the thread holding the CPU runs. A thread gives up the CPU when it blocks, relinquishes, or is preempted by a
+ * higher priority thread which became ready. Preemption is checked at every register access and SDK call, which are
+ * the only places simulated time moves forward. When no thread is ready, simulated time jumps to the next timer,
+ * timeout or register model event. This keeps every run deterministic and independent of the host machine load.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include "Host.h"
+
+/** Thread states */
+typedef enum HostThreadState
+{
+	HostThreadReady = 0,
+	HostThreadBlocked,
+	HostThreadDone
+}HostThreadState;
+
+/** Scheduler state for one firmware thread */
+typedef struct HostThread
+{
+	pthread_t Pthread;
+	pthread_cond_t Cond;
+	CyU3PThread *Handle;
+	char *Name;
+	uint32_t Priority;
+	CyU3PThreadEntry_t Entry;
+	uint32_t Input;
+	HostThreadState State;
+	uint64_t Seq;
+	void *WaitObj;
+	uint64_t WakeNs;
+	CyBool_t TimedOut;
+	uint64_t RunNs;
+	struct HostThread *Next;
+}HostThread;
+
+uint64_t HostSimNs;
+
+/* Held by whichever pthread owns the simulated CPU */
+static pthread_mutex_t CpuLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t BootCond = PTHREAD_COND_INITIALIZER;
+static HostThread *Threads;
+static HostThread *Current;
+static uint64_t SeqCounter;
+static uint32_t InterruptDepth;
+/* Set while every thread is blocked, so interrupts taken then have no thread to interrupt */
+static CyBool_t CpuIdle;
+static CyU3PTimer *Timers;
+static CyU3PThread PcThread;
+
+/* DMA buffers allocated and not freed, for the heap checks */
+static uint32_t DmaBuffersInUse;
+static uint32_t DmaBytesInUse;
+
+static void HostRunNext(HostThread *self);
+
+/**
+  * @brief Prints an error message and ends the simulation.
+ **/
+void HostFatal(const char *fmt, ...)
+{
+	va_list args;
+
+	fflush(stdout);
+	fprintf(stderr, "host: %.3f ms [%s]: ", HostSimNs / 1e6, HostThreadName());
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+	fprintf(stderr, "\n");
+	exit(2);
+}
+
+/**
+  * @brief Returns the name of the running thread, for messages.
+ **/
+const char *HostThreadName(void)
+{
+	if(InterruptDepth)
+		return "interrupt";
+	if(Current == NULL)
+		return "boot";
+	return Current->Name;
+}
+
+/**
+  * @brief Prints the simulated run time of each thread.
+ **/
+void HostPrintThreads(void)
+{
+	HostThread *t;
+
+	for(t = Threads; t != NULL; t = t->Next)
+	{
+		printf("  %-24s priority %2u  run time %10.3f ms  %s\n", t->Name, t->Priority, t->RunNs / 1e6,
+				(t->State == HostThreadDone) ? "exited" : (t->State == HostThreadBlocked) ? "blocked" : "ready");
+	}
+}
+
+CyBool_t HostInInterrupt(void)
+{
+	return (CyBool_t) (InterruptDepth != 0);
+}
+
+void HostInterruptEnter(void)
+{
+	InterruptDepth++;
+}
+
+void HostInterruptExit(void)
+{
+	InterruptDepth--;
+}
+
+/**
+  * @brief Advances simulated time by the cost of an operation on the running thread.
+ **/
+void HostSpend(uint64_t ns)
+{
+	HostSimNs += ns;
+	if(Current != NULL)
+	{
+		Current->RunNs += ns;
+	}
+}
+
+/**
+  * @brief Converts an RTOS wait option (ms) to an absolute simulated time.
+ **/
+uint64_t HostDeadline(uint32_t waitMs)
+{
+	if(waitMs == CYU3P_WAIT_FOREVER)
+		return HOST_NS_NEVER;
+	return HostSimNs + ((uint64_t) waitMs * 1000000ull);
+}
+
+/**
+  * @brief Returns the ready thread which should own the CPU, or NULL if every thread is blocked.
+ **/
+static HostThread *HostPickReady(void)
+{
+	HostThread *t, *best = NULL;
+
+	for(t = Threads; t != NULL; t = t->Next)
+	{
+		if(t->State != HostThreadReady)
+			continue;
+		if((best == NULL) || (t->Priority < best->Priority) || ((t->Priority == best->Priority) && (t->Seq < best->Seq)))
+			best = t;
+	}
+	return best;
+}
+
+static void HostMakeReady(HostThread *t, CyBool_t timedOut)
+{
+	t->State = HostThreadReady;
+	t->TimedOut = timedOut;
+	t->WaitObj = NULL;
+	t->WakeNs = HOST_NS_NEVER;
+	t->Seq = ++SeqCounter;
+}
+
+/**
+  * @brief Runs the timers, timeouts and interrupts which are due at the current simulated time.
+ **/
+static void HostProcessDue(void)
+{
+	HostThread *t;
+	CyU3PTimer *timer;
+	CyBool_t fired;
+
+	HostRegsUpdate();
+
+	/* Timer callbacks run in interrupt context */
+	do
+	{
+		fired = CyFalse;
+		for(timer = Timers; timer != NULL; timer = timer->Next)
+		{
+			if(timer->Active && (timer->ExpiryNs <= HostSimNs))
+			{
+				if(timer->RescheduleMs)
+					timer->ExpiryNs += (uint64_t) timer->RescheduleMs * 1000000ull;
+				else
+					timer->Active = CyFalse;
+				HostInterruptEnter();
+				timer->Callback(timer->Param);
+				HostInterruptExit();
+				/* The callback may have destroyed timers, so start the scan again */
+				fired = CyTrue;
+				break;
+			}
+		}
+	} while(fired);
+
+	for(t = Threads; t != NULL; t = t->Next)
+	{
+		if((t->State == HostThreadBlocked) && (t->WakeNs <= HostSimNs))
+		{
+			HostMakeReady(t, CyTrue);
+		}
+	}
+
+	HostRegsDispatchInterrupts();
+}
+
+/**
+  * @brief Moves simulated time to the next event when every thread is blocked.
+ **/
+static void HostIdle(void)
+{
+	HostThread *t;
+	CyU3PTimer *timer;
+	uint64_t next;
+
+	next = HostRegsNextEventNs();
+	for(t = Threads; t != NULL; t = t->Next)
+	{
+		if((t->State == HostThreadBlocked) && (t->WakeNs < next))
+			next = t->WakeNs;
+	}
+	for(timer = Timers; timer != NULL; timer = timer->Next)
+	{
+		if(timer->Active && (timer->ExpiryNs < next))
+			next = timer->ExpiryNs;
+	}
+	if(next == HOST_NS_NEVER)
+	{
+		HostPrintThreads();
+		HostFatal("deadlock: every thread is blocked with nothing left to wake them");
+	}
+	if(next > HostSimNs)
+	{
+		HostSimNs = next;
+	}
+	HostProcessDue();
+}
+
+/**
+  * @brief Hands the CPU to the best ready thread, and returns once self owns the CPU again.
+  *
+  * @param self The calling thread, or NULL for a context which does not wait for the CPU (boot, exiting thread).
+ **/
+static void HostRunNext(HostThread *self)
+{
+	HostThread *next;
+
+	while((next = HostPickReady()) == NULL)
+	{
+		CpuIdle = CyTrue;
+		HostIdle();
+		CpuIdle = CyFalse;
+	}
+
+	if(next == self)
+		return;
+
+	Current = next;
+	pthread_cond_signal(&next->Cond);
+
+	if(self != NULL)
+	{
+		while(Current != self)
+		{
+			pthread_cond_wait(&self->Cond, &CpuLock);
+		}
+	}
+}
+
+/**
+  * @brief Gives up the CPU if a higher priority thread is ready.
+ **/
+static void HostPreemptCheck(void)
+{
+	HostThread *best;
+
+	if((Current == NULL) || InterruptDepth || HostIrqMasked())
+		return;
+
+	best = HostPickReady();
+	if((best != NULL) && (best != Current) && (best->Priority < Current->Priority))
+	{
+		HostRunNext(Current);
+	}
+}
+
+/**
+  * @brief Called on every register access and SDK call. Brings the models up to date, runs anything which is due,
+  * and allows preemption.
+ **/
+void HostSafePoint(void)
+{
+	if(InterruptDepth || (Current == NULL) || HostIrqMasked())
+	{
+		HostRegsUpdate();
+		return;
+	}
+	HostProcessDue();
+	HostPreemptCheck();
+}
+
+/**
+  * @brief Blocks the running thread until woken or until the deadline.
+  *
+  * @return CyTrue if woken by HostWake, CyFalse on timeout.
+ **/
+CyBool_t HostWait(void *waitObj, uint64_t deadlineNs)
+{
+	HostThread *self = Current;
+
+	if((self == NULL) || InterruptDepth)
+	{
+		HostFatal("blocking RTOS call outside of a thread");
+	}
+
+	self->State = HostThreadBlocked;
+	self->WaitObj = waitObj;
+	self->WakeNs = deadlineNs;
+	self->TimedOut = CyFalse;
+	HostRunNext(self);
+	return (CyBool_t) !self->TimedOut;
+}
+
+/**
+  * @brief Readies every thread waiting on an object. The woken threads re-check their wait condition.
+ **/
+void HostWake(void *waitObj)
+{
+	HostThread *t;
+
+	for(t = Threads; t != NULL; t = t->Next)
+	{
+		if((t->State == HostThreadBlocked) && (t->WaitObj == waitObj) && (waitObj != NULL))
+		{
+			HostMakeReady(t, CyFalse);
+		}
+	}
+	HostPreemptCheck();
+}
+
+static void *HostThreadMain(void *arg)
+{
+	HostThread *self = (HostThread *) arg;
+
+	pthread_mutex_lock(&CpuLock);
+	while(Current != self)
+	{
+		pthread_cond_wait(&self->Cond, &CpuLock);
+	}
+
+	self->Entry(self->Input);
+
+	/* Thread entry returned. Give the CPU away for good */
+	self->State = HostThreadDone;
+	HostRunNext(NULL);
+	pthread_mutex_unlock(&CpuLock);
+	return NULL;
+}
+
+/**
+  * @brief Starts the scheduler. Runs the simulated PC as the highest priority thread, and never returns.
+ **/
+void HostOsStart(void)
+{
+	/* The boot context owns the CPU until the first thread runs */
+	pthread_mutex_lock(&CpuLock);
+	CyU3PThreadCreate(&PcThread, "00:HostPC", HostPcEntry, 0, NULL, 0, 1, 1, CYU3P_NO_TIME_SLICE, CYU3P_AUTO_START);
+	HostRunNext(NULL);
+	for(;;)
+	{
+		pthread_cond_wait(&BootCond, &CpuLock);
+	}
+}
+
+/* ---------------------------------------- Threads ---------------------------------------- */
+
+uint32_t CyU3PThreadCreate(CyU3PThread *thread_p, char *threadName, CyU3PThreadEntry_t entryFn, uint32_t entryInput, void *stackStart,
+		uint32_t stackSize, uint32_t priority, uint32_t preemptThreshold, uint32_t timeSlice, uint32_t autoStart)
+{
+	HostThread *t, **tail;
+	pthread_attr_t attr;
+
+	if((thread_p == NULL) || (entryFn == NULL))
+		return CY_U3P_ERROR_BAD_POINTER;
+	if(priority > 31)
+		return CY_U3P_ERROR_BAD_PRIORITY;
+
+	t = calloc(1, sizeof(HostThread));
+	t->Handle = thread_p;
+	t->Name = threadName;
+	t->Priority = priority;
+	t->Entry = entryFn;
+	t->Input = entryInput;
+	t->WakeNs = HOST_NS_NEVER;
+	t->State = autoStart ? HostThreadReady : HostThreadBlocked;
+	t->Seq = ++SeqCounter;
+	pthread_cond_init(&t->Cond, NULL);
+	thread_p->Host = t;
+	thread_p->Name = threadName;
+
+	for(tail = &Threads; *tail != NULL; tail = &(*tail)->Next);
+	*tail = t;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, 1024 * 1024);
+	if(pthread_create(&t->Pthread, &attr, HostThreadMain, t) != 0)
+	{
+		HostFatal("pthread_create failed for %s", threadName);
+	}
+	pthread_attr_destroy(&attr);
+
+	HostPreemptCheck();
+	return CY_U3P_SUCCESS;
+}
+
+/**
+  * @brief As ThreadX, an interrupt gets the thread it interrupted, or NULL if no thread was running.
+ **/
+CyU3PThread *CyU3PThreadIdentify(void)
+{
+	if((Current == NULL) || CpuIdle)
+		return NULL;
+	return Current->Handle;
+}
+
+uint32_t CyU3PThreadPriorityChange(CyU3PThread *thread_p, uint32_t newPriority, uint32_t *oldPriority)
+{
+	if((thread_p == NULL) || (thread_p->Host == NULL))
+		return CY_U3P_ERROR_BAD_THREAD;
+	if(newPriority > 31)
+		return CY_U3P_ERROR_BAD_PRIORITY;
+	if(oldPriority != NULL)
+		*oldPriority = thread_p->Host->Priority;
+	thread_p->Host->Priority = newPriority;
+	HostPreemptCheck();
+	return CY_U3P_SUCCESS;
+}
+
+void CyU3PThreadRelinquish(void)
+{
+	HostSpend(HOST_SDK_CALL_NS);
+	HostSafePoint();
+	if((Current == NULL) || InterruptDepth)
+		return;
+	/* Go to the back of the ready threads at this priority */
+	Current->Seq = ++SeqCounter;
+	HostRunNext(Current);
+}
+
+uint32_t CyU3PThreadSleep(uint32_t timerTicks)
+{
+	HostSpend(HOST_SDK_CALL_NS);
+	HostWait(NULL, HostDeadline(timerTicks));
+	return CY_U3P_SUCCESS;
+}
+
+/* ---------------------------------------- Events ---------------------------------------- */
+
+uint32_t CyU3PEventCreate(CyU3PEvent *event_p)
+{
+	if(event_p == NULL)
+		return CY_U3P_ERROR_BAD_POINTER;
+	event_p->Flags = 0;
+	event_p->Created = CyTrue;
+	return CY_U3P_SUCCESS;
+}
+
+uint32_t CyU3PEventDestroy(CyU3PEvent *event_p)
+{
+	if(event_p == NULL)
+		return CY_U3P_ERROR_BAD_POINTER;
+	event_p->Created = CyFalse;
+	HostWake(event_p);
+	return CY_U3P_SUCCESS;
+}
+
+uint32_t CyU3PEventSet(CyU3PEvent *event_p, uint32_t rqtFlag, uint32_t setOption)
+{
+	if((event_p == NULL) || !event_p->Created)
+		return CY_U3P_ERROR_BAD_POINTER;
+	HostSpend(HOST_SDK_CALL_NS);
+	if(setOption == CYU3P_EVENT_AND)
+		event_p->Flags &= rqtFlag;
+	else
+		event_p->Flags |= rqtFlag;
+	HostWake(event_p);
+	return CY_U3P_SUCCESS;
+}
+
+uint32_t CyU3PEventGet(CyU3PEvent *event_p, uint32_t rqtFlag, uint32_t getOption, uint32_t *flag_p, uint32_t waitOption)
+{
+	uint64_t deadline;
+	CyBool_t andMode, clear, satisfied;
+
+	if((event_p == NULL) || !event_p->Created || (flag_p == NULL))
+		return CY_U3P_ERROR_BAD_POINTER;
+
+	HostSpend(HOST_SDK_CALL_NS);
+	HostSafePoint();
+
+	andMode = (CyBool_t) ((getOption == CYU3P_EVENT_AND) || (getOption == CYU3P_EVENT_AND_CLEAR));
+	clear = (CyBool_t) ((getOption == CYU3P_EVENT_OR_CLEAR) || (getOption == CYU3P_EVENT_AND_CLEAR));
+	deadline = HostDeadline(waitOption);
+	for(;;)
+	{
+		if(andMode)
+			satisfied = (CyBool_t) ((event_p->Flags & rqtFlag) == rqtFlag);
+		else
+			satisfied = (CyBool_t) ((event_p->Flags & rqtFlag) != 0);
+		if(satisfied)
+		{
+			*flag_p = event_p->Flags;
+			if(clear)
+				event_p->Flags &= ~rqtFlag;
+			return CY_U3P_SUCCESS;
+		}
+		if((waitOption == CYU3P_NO_WAIT) || HostInInterrupt())
+			return CY_U3P_ERROR_NO_EVENTS;
+		if(!HostWait(event_p, deadline))
+		{
+			/* Check once more, in case the flag was set by the timeout's interrupt */
+			waitOption = CYU3P_NO_WAIT;
+		}
+	}
+}
+
+/* ---------------------------------------- Queues ---------------------------------------- */
+
+uint32_t CyU3PQueueCreate(CyU3PQueue *queue_p, uint32_t messageSize, void *bufferStart, uint32_t queueSize)
+{
+	if((queue_p == NULL) || (bufferStart == NULL) || (messageSize == 0))
+		return CY_U3P_ERROR_BAD_POINTER;
+	queue_p->Storage = (uint32_t *) bufferStart;
+	queue_p->MessageWords = messageSize;
+	queue_p->Capacity = queueSize / (messageSize * 4);
+	queue_p->Count = 0;
+	queue_p->Head = 0;
+	return CY_U3P_SUCCESS;
+}
+
+uint32_t CyU3PQueueSend(CyU3PQueue *queue_p, void *src_p, uint32_t waitOption)
+{
+	uint64_t deadline = HostDeadline(waitOption);
+	uint32_t tail;
+
+	HostSpend(HOST_SDK_CALL_NS);
+	while(queue_p->Count >= queue_p->Capacity)
+	{
+		if((waitOption == CYU3P_NO_WAIT) || HostInInterrupt() || !HostWait(queue_p, deadline))
+			return CY_U3P_ERROR_QUEUE_FULL;
+	}
+	tail = (queue_p->Head + queue_p->Count) % queue_p->Capacity;
+	memcpy(&queue_p->Storage[tail * queue_p->MessageWords], src_p, queue_p->MessageWords * 4);
+	queue_p->Count++;
+	HostWake(queue_p);
+	return CY_U3P_SUCCESS;
+}
+
+uint32_t CyU3PQueueReceive(CyU3PQueue *queue_p, void *dest_p, uint32_t waitOption)
+{
+	uint64_t deadline = HostDeadline(waitOption);
+
+	HostSpend(HOST_SDK_CALL_NS);
+	HostSafePoint();
+	while(queue_p->Count == 0)
+	{
+		if((waitOption == CYU3P_NO_WAIT) || HostInInterrupt() || !HostWait(queue_p, deadline))
+			return CY_U3P_ERROR_QUEUE_EMPTY;
+	}
+	memcpy(dest_p, &queue_p->Storage[queue_p->Head * queue_p->MessageWords], queue_p->MessageWords * 4);
+	queue_p->Head = (queue_p->Head + 1) % queue_p->Capacity;
+	queue_p->Count--;
+	HostWake(queue_p);
+	return CY_U3P_SUCCESS;
+}
+
+/* ---------------------------------------- Mutexes ---------------------------------------- */
+
+uint32_t CyU3PMutexCreate(CyU3PMutex *mutex_p, uint32_t priorityInherit)
+{
+	if(mutex_p == NULL)
+		return CY_U3P_ERROR_BAD_POINTER;
+	if(mutex_p->Created)
+		return CY_U3P_ERROR_MUTEX_FAILURE;
+	mutex_p->Owner = NULL;
+	mutex_p->Count = 0;
+	mutex_p->Created = CyTrue;
+	return CY_U3P_SUCCESS;
+}
+
+uint32_t CyU3PMutexDestroy(CyU3PMutex *mutex_p)
+{
+	if((mutex_p == NULL) || !mutex_p->Created)
+		return CY_U3P_ERROR_BAD_POINTER;
+	mutex_p->Owner = NULL;
+	mutex_p->Count = 0;
+	mutex_p->Created = CyFalse;
+	HostWake(mutex_p);
+	return CY_U3P_SUCCESS;
+}
+
+uint32_t CyU3PMutexGet(CyU3PMutex *mutex_p, uint32_t waitOption)
+{
+	uint64_t deadline = HostDeadline(waitOption);
+
+	HostSpend(HOST_SDK_CALL_NS);
+	if((mutex_p == NULL) || !mutex_p->Created)
+		return CY_U3P_ERROR_BAD_POINTER;
+	while((mutex_p->Count != 0) && (mutex_p->Owner != Current))
+	{
+		if((waitOption == CYU3P_NO_WAIT) || HostInInterrupt() || !HostWait(mutex_p, deadline) || !mutex_p->Created)
+			return CY_U3P_ERROR_MUTEX_FAILURE;
+	}
+	mutex_p->Owner = Current;
+	mutex_p->Count++;
+	return CY_U3P_SUCCESS;
+}
+
+uint32_t CyU3PMutexPut(CyU3PMutex *mutex_p)
+{
+	if((mutex_p == NULL) || !mutex_p->Created)
+		return CY_U3P_ERROR_BAD_POINTER;
+	if((mutex_p->Count == 0) || (mutex_p->Owner != Current))
+		return CY_U3P_ERROR_MUTEX_FAILURE;
+	mutex_p->Count--;
+	if(mutex_p->Count == 0)
+	{
+		mutex_p->Owner = NULL;
+		HostWake(mutex_p);
+	}
+	return CY_U3P_SUCCESS;
+}
+
+/* ---------------------------------------- Timers ---------------------------------------- */
+
+uint32_t CyU3PTimerCreate(CyU3PTimer *timer_p, CyU3PTimerCb_t expirationFunction, uint32_t expirationInput,
+		uint32_t initialTicks, uint32_t rescheduleTicks, uint32_t timerOption)
+{
+	if((timer_p == NULL) || (expirationFunction == NULL))
+		return CY_U3P_ERROR_BAD_POINTER;
+	timer_p->Callback = expirationFunction;
+	timer_p->Param = expirationInput;
+	timer_p->RescheduleMs = rescheduleTicks;
+	timer_p->ExpiryNs = HostDeadline(initialTicks);
+	timer_p->Active = (CyBool_t) (timerOption == CYU3P_AUTO_ACTIVATE);
+	timer_p->Next = Timers;
+	Timers = timer_p;
+	return CY_U3P_SUCCESS;
+}
+
+uint32_t CyU3PTimerDestroy(CyU3PTimer *timer_p)
+{
+	CyU3PTimer **link;
+
+	for(link = &Timers; *link != NULL; link = &(*link)->Next)
+	{
+		if(*link == timer_p)
+		{
+			*link = timer_p->Next;
+			timer_p->Active = CyFalse;
+			return CY_U3P_SUCCESS;
+		}
+	}
+	return CY_U3P_ERROR_BAD_POINTER;
+}
+
+uint32_t CyU3PGetTime(void)
+{
+	HostSpend(HOST_SDK_CALL_NS);
+	HostSafePoint();
+	return (uint32_t) (HostSimNs / 1000000ull);
+}
+
+/* ---------------------------------------- Memory ---------------------------------------- */
+
+void *CyU3PMemAlloc(uint32_t size)
+{
+	HostSpend(HOST_SDK_CALL_NS);
+	return malloc(size);
+}
+
+void CyU3PMemFree(void *mem_p)
+{
+	free(mem_p);
+}
+
+void CyU3PMemSet(uint8_t *ptr, uint8_t data, uint32_t count)
+{
+	memset(ptr, data, count);
+}
+
+void CyU3PMemCopy(uint8_t *dest, uint8_t *src, uint32_t count)
+{
+	memmove(dest, src, count);
+}
+
+int32_t CyU3PMemCmp(const void *s1, const void *s2, uint32_t n)
+{
+	return memcmp(s1, s2, n);
+}
+
+/**
+  * @brief DMA buffers are cache line aligned, and a multiple of the cache line size. The size is kept in the
+  * cache line before the buffer, so the buffers in use can be counted.
+ **/
+void *CyU3PDmaBufferAlloc(uint16_t size)
+{
+	uint8_t *buf = NULL;
+	uint32_t numBytes = ((uint32_t) size + 31) & ~31u;
+
+	HostSpend(HOST_SDK_CALL_NS);
+	if(posix_memalign((void **) &buf, 32, numBytes + 32) != 0)
+		return NULL;
+	memcpy(buf, &numBytes, sizeof(numBytes));
+	DmaBuffersInUse++;
+	DmaBytesInUse += numBytes;
+	return buf + 32;
+}
+
+int CyU3PDmaBufferFree(void *buffer)
+{
+	uint32_t numBytes;
+
+	if(buffer == NULL)
+		return 0;
+	memcpy(&numBytes, (uint8_t *) buffer - 32, sizeof(numBytes));
+	DmaBuffersInUse--;
+	DmaBytesInUse -= numBytes;
+	free((uint8_t *) buffer - 32);
+	return 0;
+}
+
+/**
+  * @brief Number of DMA buffers allocated and not freed, and their total size in bytes.
+ **/
+uint32_t HostDmaBuffersInUse(uint32_t *numBytes)
+{
+	if(numBytes)
+		*numBytes = DmaBytesInUse;
+	return DmaBuffersInUse;
+}
@@ -0,0 +1,1251 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		HostRegs.c
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build register models for the FX3 GPIO and SPI blocks, and the vectored interrupt controller.
+ **/
+
+/*
+ * The firmware reaches the GPIO and SPI registers through the GPIO and SPI macros, which call HostGpioRegs() and
+ * HostSpiRegs(). Both return a read only view of the register pages, after bringing the models up to the current
+ * simulated time. The model writes the same pages through a second, writable mapping. A firmware register write
+ * faults on the read only view. The fault handler opens the page for one instruction (x86 trap flag), and the
+ * trap handler logs the old and new register value and closes the page again. The log is processed on the next
+ * register access or SDK call, so write-one-to-clear bits, repeated writes of the same value and writes which start
+ * a transfer are all seen. The handlers only log: model updates and interrupts always run outside signal context.
+ *
+ * The GCTL pull up / pull down registers, and the GCTLAON block, are at fixed addresses in the firmware. They are
+ * mapped as plain memory at the same addresses.
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "Host.h"
+#include "gpio_regs.h"
+#include "spi_regs.h"
+#include "cyu3gpio.h"
+#include "cyu3spi.h"
+#include "cyu3vic.h"
+
+#if !defined(__x86_64__) || !defined(__linux__)
+#error "The host build register write trap needs x86-64 Linux"
+#endif
+
+#define HOST_PAGE_SIZE							(0x1000)
+#define HOST_SPI_OFFSET							(HOST_PAGE_SIZE)
+#define HOST_REGS_SIZE							(2 * HOST_PAGE_SIZE)
+#define HOST_WRITE_LOG_SIZE						(64)
+#define HOST_EFLAGS_TF							(0x100)
+
+/* Fixed address GCTL blocks used by the firmware (main.h, gctlaon_regs.h) */
+#define HOST_GCTL_BASE							(0xE0050000ul)
+#define HOST_GCTL_SIZE							(0x2000)
+#define HOST_GCTL_WPU_CFG						(*(uvint32_t *)(0xE0051020ul))
+#define HOST_GCTL_WPU_CFG_UPPR					(*(uvint32_t *)(0xE0051024ul))
+#define HOST_GCTL_WPD_CFG						(*(uvint32_t *)(0xE0051028ul))
+#define HOST_GCTL_WPD_CFG_UPPR					(*(uvint32_t *)(0xE005102Cul))
+
+/* iSensor FX3 Rev C board ID straps: ID1 (GPIO 15) pulled high, ID0 (GPIO 17) left open */
+#define HOST_BOARD_ID1_PIN						(15)
+
+#define HOST_GPIO_MODE(status)					(((status) & CY_U3P_LPP_GPIO_MODE_MASK) >> CY_U3P_LPP_GPIO_MODE_POS)
+#define HOST_GPIO_INTRMODE(status)				(((status) & CY_U3P_LPP_GPIO_INTRMODE_MASK) >> CY_U3P_LPP_GPIO_INTRMODE_POS)
+#define HOST_GPIO_TIMERMODE(status)				(((status) & CY_U3P_LPP_GPIO_TIMER_MODE_MASK) >> CY_U3P_LPP_GPIO_TIMER_MODE_POS)
+
+/** One logged register write */
+typedef struct HostRegWrite
+{
+	uint32_t Offset;
+	uint32_t Old;
+	uint32_t New;
+}HostRegWrite;
+
+/** Complex GPIO model state */
+typedef struct HostComplexPin
+{
+	uint8_t Owner;
+	uint64_t BaseNs;
+	uint32_t BaseValue;
+	CyBool_t MeasureActive;
+	CyBool_t MeasureHigh;
+	uint64_t MeasureArmNs;
+}HostComplexPin;
+
+/** SPI model state */
+typedef struct HostSpiModel
+{
+	uint32_t SclkHz;
+	uint64_t BusyUntilNs;
+	CyBool_t RxValid;
+	CyBool_t DmaActive;
+	CyBool_t DmaDone;
+	CyBool_t Selected;
+	uint32_t TxLeft;
+	uint32_t RxLeft;
+	uint32_t BytesLeft;
+	uint64_t NextNs;
+	uint32_t StrayEnables;
+}HostSpiModel;
+
+static uint8_t *RoBase;
+static uint8_t *RwBase;
+static PLPP_GPIO_REGS_T GpioRw;
+static PLPP_SPI_REGS_T SpiRw;
+
+static volatile uint32_t PendingOffset;
+static volatile uint32_t PendingOld;
+static volatile uint32_t PendingPage;
+static HostRegWrite WriteLog[HOST_WRITE_LOG_SIZE];
+static volatile uint32_t WriteCount;
+
+static void (*GpioCallback)(uint8_t);
+static uint32_t FastClkHz = HOST_SYS_CLK_HZ / 2;
+static uint32_t SlowClkHz = HOST_SYS_CLK_HZ / 40;
+static CyBool_t ComplexMode[HOST_NUM_GPIO];
+static HostComplexPin Complex[8];
+static int LastLevel[HOST_NUM_GPIO];
+static uint64_t LastUpdateNs;
+static CyBool_t VicGpioEnabled;
+static CyBool_t VicMasked;
+static CyBool_t Updating;
+static HostSpiModel Spi;
+
+static void HostSpiDmaUpdate(void);
+
+/* ---------------------------------------- Write trap ---------------------------------------- */
+
+static void HostSegvHandler(int sig, siginfo_t *info, void *context)
+{
+	ucontext_t *uc = (ucontext_t *) context;
+	uint8_t *addr = (uint8_t *) info->si_addr;
+
+	if((RoBase == NULL) || (addr < RoBase) || (addr >= (RoBase + HOST_REGS_SIZE)))
+	{
+		/* A real crash. Re-raise it with the default action */
+		signal(SIGSEGV, SIG_DFL);
+		return;
+	}
+
+	PendingOffset = (uint32_t) (addr - RoBase) & ~3u;
+	PendingOld = *(uint32_t *) (RwBase + PendingOffset);
+	PendingPage = PendingOffset & ~(HOST_PAGE_SIZE - 1);
+	mprotect(RoBase + PendingPage, HOST_PAGE_SIZE, PROT_READ | PROT_WRITE);
+	uc->uc_mcontext.gregs[REG_EFL] |= HOST_EFLAGS_TF;
+}
+
+static void HostTrapHandler(int sig, siginfo_t *info, void *context)
+{
+	ucontext_t *uc = (ucontext_t *) context;
+
+	uc->uc_mcontext.gregs[REG_EFL] &= ~HOST_EFLAGS_TF;
+	mprotect(RoBase + PendingPage, HOST_PAGE_SIZE, PROT_READ);
+	if(WriteCount >= HOST_WRITE_LOG_SIZE)
+	{
+		static const char msg[] = "host: register write log overflow\n";
+		write(2, msg, sizeof(msg) - 1);
+		_exit(2);
+	}
+	WriteLog[WriteCount].Offset = PendingOffset;
+	WriteLog[WriteCount].Old = PendingOld;
+	WriteLog[WriteCount].New = *(uint32_t *) (RwBase + PendingOffset);
+	WriteCount++;
+}
+
+/**
+  * @brief Maps the register pages and installs the write trap.
+ **/
+void HostRegsInit(void)
+{
+	struct sigaction sa;
+	void *gctl;
+	int fd;
+
+	fd = memfd_create("fx3regs", 0);
+	if((fd < 0) || (ftruncate(fd, HOST_REGS_SIZE) != 0))
+		HostFatal("memfd_create failed");
+	RwBase = mmap(NULL, HOST_REGS_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	RoBase = mmap(NULL, HOST_REGS_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+	if((RwBase == MAP_FAILED) || (RoBase == MAP_FAILED))
+		HostFatal("register page mmap failed");
+	close(fd);
+	GpioRw = (PLPP_GPIO_REGS_T) RwBase;
+	SpiRw = (PLPP_SPI_REGS_T) (RwBase + HOST_SPI_OFFSET);
+
+	gctl = mmap((void *) HOST_GCTL_BASE, HOST_GCTL_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	if(gctl != (void *) HOST_GCTL_BASE)
+		HostFatal("could not map the GCTL registers at 0x%lx", HOST_GCTL_BASE);
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_sigaction = HostSegvHandler;
+	sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+	sigaction(SIGSEGV, &sa, NULL);
+	sa.sa_sigaction = HostTrapHandler;
+	sigaction(SIGTRAP, &sa, NULL);
+
+	for(fd = 0; fd < 8; fd++)
+	{
+		memset(&Complex[fd], 0, sizeof(HostComplexPin));
+		Complex[fd].Owner = 0xFF;
+	}
+	for(fd = 0; fd < HOST_NUM_GPIO; fd++)
+	{
+		LastLevel[fd] = 0;
+	}
+
+	Spi.SclkHz = 1000000;
+	SpiRw->lpp_spi_status = CY_U3P_LPP_SPI_TX_DONE | CY_U3P_LPP_SPI_TX_SPACE | CY_U3P_LPP_SPI_RX_SPACE;
+}
+
+PLPP_GPIO_REGS_T HostGpioRegs(void)
+{
+	HostSpend(HOST_REG_ACCESS_NS);
+	HostSafePoint();
+	return (PLPP_GPIO_REGS_T) RoBase;
+}
+
+PLPP_SPI_REGS_T HostSpiRegs(void)
+{
+	HostSpend(HOST_REG_ACCESS_NS);
+	HostSafePoint();
+	return (PLPP_SPI_REGS_T) (RoBase + HOST_SPI_OFFSET);
+}
+
+/* ---------------------------------------- GPIO ---------------------------------------- */
+
+static uint64_t HostTicks(uint64_t ns, uint32_t hz)
+{
+	return (uint64_t) (((unsigned __int128) ns * hz) / 1000000000u);
+}
+
+static uint64_t HostTicksToNs(uint64_t ticks, uint32_t hz)
+{
+	/* Round up, so the event time is never before the tick */
+	return (uint64_t) ((((unsigned __int128) ticks * 1000000000u) + hz - 1) / hz);
+}
+
+static uint32_t HostTimerHz(uint32_t status)
+{
+	switch(HOST_GPIO_TIMERMODE(status))
+	{
+	case CY_U3P_GPIO_TIMER_HIGH_FREQ:
+		return FastClkHz;
+	case CY_U3P_GPIO_TIMER_LOW_FREQ:
+		return SlowClkHz;
+	case CY_U3P_GPIO_TIMER_STANDBY_FREQ:
+		return 32768;
+	default:
+		return 0;
+	}
+}
+
+/**
+  * @brief Complex GPIO timer value at a time. The timer counts from 0 to period, then wraps.
+ **/
+static uint32_t HostTimerAt(uint8_t index, uint64_t ns)
+{
+	LPP_GPIO_PIN_T *pin = &GpioRw->lpp_gpio_pin[index];
+	uint32_t hz = HostTimerHz(pin->status);
+	uint64_t count;
+
+	if((hz == 0) || !(pin->status & CY_U3P_LPP_GPIO_ENABLE) || (ns < Complex[index].BaseNs))
+		return Complex[index].BaseValue;
+	count = (uint64_t) Complex[index].BaseValue + HostTicks(ns, hz) - HostTicks(Complex[index].BaseNs, hz);
+	if(pin->period == 0xFFFFFFFF)
+		return (uint32_t) count;
+	return (uint32_t) (count % ((uint64_t) pin->period + 1));
+}
+
+/**
+  * @brief Restarts the timer calculation from the current time, before a timer setting changes.
+ **/
+static void HostTimerRebase(uint8_t index)
+{
+	Complex[index].BaseValue = HostTimerAt(index, HostSimNs);
+	Complex[index].BaseNs = HostSimNs;
+}
+
+uint32_t HostGpioTimerValue(uint8_t pin)
+{
+	HostRegsUpdate();
+	return HostTimerAt(pin % 8, HostSimNs);
+}
+
+/**
+  * @brief Sets a complex GPIO timer value, as a timer register write would. Lets the harness move a free running
+  * timer up to its rollover without simulating the minutes it takes to get there.
+ **/
+void HostGpioSetTimer(uint8_t index, uint32_t value)
+{
+	HostRegsUpdate();
+	Complex[index].BaseValue = value;
+	Complex[index].BaseNs = HostSimNs;
+	GpioRw->lpp_gpio_pin[index].timer = value;
+	HostRegsUpdate();
+}
+
+static int HostBoardStrap(uint8_t pin)
+{
+	if(pin == HOST_BOARD_ID1_PIN)
+		return 1;
+	return HOST_PIN_Z;
+}
+
+static CyBool_t HostPullUp(uint8_t pin)
+{
+	if(pin < 32)
+		return (CyBool_t) ((HOST_GCTL_WPU_CFG >> pin) & 1);
+	return (CyBool_t) ((HOST_GCTL_WPU_CFG_UPPR >> (pin - 32)) & 1);
+}
+
+/**
+  * @brief Level the FX3 drives on a pin, or HOST_PIN_Z.
+ **/
+static int HostFx3Drive(uint8_t pin, uint64_t ns)
+{
+	uint32_t status;
+	uint8_t index;
+
+	if(ComplexMode[pin])
+	{
+		index = pin % 8;
+		status = GpioRw->lpp_gpio_pin[index].status;
+		if(!(status & CY_U3P_LPP_GPIO_ENABLE))
+			return HOST_PIN_Z;
+		if(HOST_GPIO_MODE(status) == CY_U3P_GPIO_MODE_PWM)
+		{
+			/* Stand-in PWM: low until the timer reaches the threshold, then high until the period */
+			return (HostTimerAt(index, ns) >= GpioRw->lpp_gpio_pin[index].threshold) ? 1 : 0;
+		}
+	}
+	else
+	{
+		status = GpioRw->lpp_gpio_simple[pin];
+		if(!(status & CY_U3P_LPP_GPIO_ENABLE))
+			return HOST_PIN_Z;
+	}
+
+	if((status & CY_U3P_LPP_GPIO_OUT_VALUE) && (status & CY_U3P_LPP_GPIO_DRIVE_HI_EN))
+		return 1;
+	if(!(status & CY_U3P_LPP_GPIO_OUT_VALUE) && (status & CY_U3P_LPP_GPIO_DRIVE_LO_EN))
+		return 0;
+	return HOST_PIN_Z;
+}
+
+/**
+  * @brief Resolved level of a pin: FX3 drive, then the DUT, then the board, then the pull up. A pin with a pull down,
+  * or no pull at all, reads low.
+ **/
+static int HostPinLevelAt(uint8_t pin, uint64_t ns)
+{
+	int level;
+
+	level = HostFx3Drive(pin, ns);
+	if(level != HOST_PIN_Z)
+		return level;
+	level = HostDutPinLevel(pin, ns);
+	if(level != HOST_PIN_Z)
+		return level;
+	level = HostBoardStrap(pin);
+	if(level != HOST_PIN_Z)
+		return level;
+	if(HostPullUp(pin))
+		return 1;
+	return 0;
+}
+
+int HostPinLevel(uint8_t pin)
+{
+	HostRegsUpdate();
+	return HostPinLevelAt(pin, HostSimNs);
+}
+
+static uint32_t *HostPinStatus(uint8_t pin)
+{
+	if(ComplexMode[pin])
+		return (uint32_t *) &GpioRw->lpp_gpio_pin[pin % 8].status;
+	return (uint32_t *) &GpioRw->lpp_gpio_simple[pin];
+}
+
+/**
+  * @brief Latches the pin interrupt for a level change, if it matches the interrupt mode.
+ **/
+static void HostPinLevelChange(uint8_t pin, int level)
+{
+	uint32_t *status = HostPinStatus(pin);
+	uint32_t mode = HOST_GPIO_INTRMODE(*status);
+
+	if(level == LastLevel[pin])
+		return;
+	LastLevel[pin] = level;
+	if(!(*status & CY_U3P_LPP_GPIO_ENABLE))
+		return;
+	if(((mode == CY_U3P_GPIO_INTR_POS_EDGE) && level) || ((mode == CY_U3P_GPIO_INTR_NEG_EDGE) && !level) ||
+		(mode == CY_U3P_GPIO_INTR_BOTH_EDGE))
+	{
+		*status |= CY_U3P_LPP_GPIO_INTR;
+	}
+}
+
+static CyBool_t HostPinEdgeIntr(uint8_t pin)
+{
+	uint32_t status = *HostPinStatus(pin);
+	uint32_t mode = HOST_GPIO_INTRMODE(status);
+
+	return (CyBool_t) ((status & CY_U3P_LPP_GPIO_ENABLE) &&
+		((mode == CY_U3P_GPIO_INTR_POS_EDGE) || (mode == CY_U3P_GPIO_INTR_NEG_EDGE) || (mode == CY_U3P_GPIO_INTR_BOTH_EDGE)));
+}
+
+/**
+  * @brief Latches every pin interrupt between the last update and now.
+ **/
+static void HostGpioUpdate(void)
+{
+	uint64_t edge;
+	uint32_t *status, mode, v0, v1, thres;
+	uint8_t pin, index;
+	int level;
+
+	for(pin = 0; pin < HOST_NUM_GPIO; pin++)
+	{
+		status = HostPinStatus(pin);
+		if(HostPinEdgeIntr(pin))
+		{
+			/* DUT driven edges since the last update */
+			edge = LastUpdateNs;
+			while((edge = HostDutNextEdge(pin, edge)) <= HostSimNs)
+			{
+				HostPinLevelChange(pin, HostPinLevelAt(pin, edge));
+			}
+		}
+		level = HostPinLevelAt(pin, HostSimNs);
+		HostPinLevelChange(pin, level);
+
+		mode = HOST_GPIO_INTRMODE(*status);
+		if((*status & CY_U3P_LPP_GPIO_ENABLE) && (((mode == CY_U3P_GPIO_INTR_LOW_LEVEL) && !level) || ((mode == CY_U3P_GPIO_INTR_HIGH_LEVEL) && level)))
+		{
+			*status |= CY_U3P_LPP_GPIO_INTR;
+		}
+
+		if(level)
+			*status |= CY_U3P_LPP_GPIO_IN_VALUE;
+		else
+			*status &= ~CY_U3P_LPP_GPIO_IN_VALUE;
+	}
+
+	/* Timer threshold interrupts */
+	for(index = 0; index < 8; index++)
+	{
+		status = (uint32_t *) &GpioRw->lpp_gpio_pin[index].status;
+		if(!(*status & CY_U3P_LPP_GPIO_ENABLE) || (HOST_GPIO_INTRMODE(*status) != CY_U3P_GPIO_INTR_TIMER_THRES) || (HostTimerHz(*status) == 0))
+			continue;
+		thres = GpioRw->lpp_gpio_pin[index].threshold;
+		v0 = HostTimerAt(index, LastUpdateNs);
+		v1 = HostTimerAt(index, HostSimNs);
+		if(HostTicks(HostSimNs, HostTimerHz(*status)) - HostTicks(LastUpdateNs, HostTimerHz(*status)) > GpioRw->lpp_gpio_pin[index].period)
+			*status |= CY_U3P_LPP_GPIO_INTR;
+		else if((v0 <= v1) && (v0 < thres) && (thres <= v1))
+			*status |= CY_U3P_LPP_GPIO_INTR;
+		else if((v0 > v1) && ((thres > v0) || (thres <= v1)))
+			*status |= CY_U3P_LPP_GPIO_INTR;
+	}
+
+	/* Summary registers */
+	GpioRw->lpp_gpio_intr0 = 0;
+	GpioRw->lpp_gpio_intr1 = 0;
+	GpioRw->lpp_gpio_invalue0 = 0;
+	GpioRw->lpp_gpio_invalue1 = 0;
+	for(pin = 0; pin < HOST_NUM_GPIO; pin++)
+	{
+		status = HostPinStatus(pin);
+		if(ComplexMode[pin] && (Complex[pin % 8].Owner != pin))
+			continue;
+		if(*status & CY_U3P_LPP_GPIO_INTR)
+		{
+			if(pin < 32)
+				GpioRw->lpp_gpio_intr0 |= (1u << pin);
+			else
+				GpioRw->lpp_gpio_intr1 |= (1u << (pin - 32));
+		}
+		if(*status & CY_U3P_LPP_GPIO_IN_VALUE)
+		{
+			if(pin < 32)
+				GpioRw->lpp_gpio_invalue0 |= (1u << pin);
+			else
+				GpioRw->lpp_gpio_invalue1 |= (1u << (pin - 32));
+		}
+	}
+}
+
+/**
+  * @brief Time of the next GPIO event which raises an interrupt with the GPIO vector enabled.
+ **/
+static uint64_t HostGpioNextEventNs(void)
+{
+	uint64_t next = HOST_NS_NEVER, edge, ticks;
+	uint32_t status, hz, v1, period;
+	uint8_t pin, index;
+
+	if(!VicGpioEnabled)
+		return next;
+
+	for(pin = 0; pin < HOST_NUM_GPIO; pin++)
+	{
+		if(HostPinEdgeIntr(pin))
+		{
+			edge = HostDutNextEdge(pin, HostSimNs);
+			if(edge < next)
+				next = edge;
+		}
+	}
+
+	for(index = 0; index < 8; index++)
+	{
+		status = GpioRw->lpp_gpio_pin[index].status;
+		hz = HostTimerHz(status);
+		if(!(status & CY_U3P_LPP_GPIO_ENABLE) || (HOST_GPIO_INTRMODE(status) != CY_U3P_GPIO_INTR_TIMER_THRES) || (hz == 0))
+			continue;
+		period = GpioRw->lpp_gpio_pin[index].period;
+		v1 = HostTimerAt(index, HostSimNs);
+		if(period == 0xFFFFFFFF)
+			ticks = (uint32_t) (GpioRw->lpp_gpio_pin[index].threshold - v1);
+		else
+			ticks = ((uint64_t) GpioRw->lpp_gpio_pin[index].threshold + period + 1 - v1) % ((uint64_t) period + 1);
+		if(ticks == 0)
+			ticks = (uint64_t) period + 1;
+		edge = HostTicksToNs(HostTicks(HostSimNs, hz) + ticks, hz);
+		if(edge < next)
+			next = edge;
+	}
+	return next;
+}
+
+/**
+  * @brief Applies a firmware write to a GPIO status register.
+ **/
+static void HostGpioStatusWrite(uint32_t *reg, uint32_t oldValue, uint32_t newValue, int8_t index)
+{
+	uint32_t value;
+
+	/* INTR is write one to clear, IN_VALUE is read only */
+	value = newValue & ~(CY_U3P_LPP_GPIO_INTR | CY_U3P_LPP_GPIO_IN_VALUE);
+	value |= oldValue & CY_U3P_LPP_GPIO_IN_VALUE;
+	if((oldValue & CY_U3P_LPP_GPIO_INTR) && !(newValue & CY_U3P_LPP_GPIO_INTR))
+		value |= CY_U3P_LPP_GPIO_INTR;
+
+	if(index >= 0)
+	{
+		/* Sample now copies the timer to the threshold register. Other one shot modes finish at once */
+		if(HOST_GPIO_MODE(value) == CY_U3P_GPIO_MODE_SAMPLE_NOW)
+		{
+			GpioRw->lpp_gpio_pin[index].threshold = HostTimerAt(index, HostSimNs);
+			value &= ~CY_U3P_LPP_GPIO_MODE_MASK;
+		}
+		else if(HOST_GPIO_MODE(value) == CY_U3P_GPIO_MODE_PULSE_NOW)
+		{
+			value &= ~CY_U3P_LPP_GPIO_MODE_MASK;
+		}
+		/* Keep the timer continuous across a timer mode change */
+		if(((oldValue ^ value) & (CY_U3P_LPP_GPIO_TIMER_MODE_MASK | CY_U3P_LPP_GPIO_ENABLE)) != 0)
+		{
+			*reg = oldValue;
+			HostTimerRebase(index);
+		}
+	}
+	*reg = value;
+}
+
+static void HostGpioWrite(uint32_t offset, uint32_t oldValue, uint32_t newValue)
+{
+	uint32_t word = offset / 4;
+	uint8_t index, pin;
+	int level;
+
+	if(word < HOST_NUM_GPIO)
+	{
+		pin = (uint8_t) word;
+		HostGpioStatusWrite((uint32_t *) &GpioRw->lpp_gpio_simple[pin], oldValue, newValue, -1);
+		if(!ComplexMode[pin])
+		{
+			level = HostFx3Drive(pin, HostSimNs);
+			HostDutPinDriven(pin, level, HostSimNs);
+		}
+		return;
+	}
+
+	if((offset >= offsetof(LPP_GPIO_REGS_T, lpp_gpio_pin)) && (offset < offsetof(LPP_GPIO_REGS_T, reserved1)))
+	{
+		index = (uint8_t) ((offset - offsetof(LPP_GPIO_REGS_T, lpp_gpio_pin)) / sizeof(LPP_GPIO_PIN_T));
+		switch((offset - offsetof(LPP_GPIO_REGS_T, lpp_gpio_pin)) % sizeof(LPP_GPIO_PIN_T))
+		{
+		case offsetof(LPP_GPIO_PIN_T, status):
+			HostGpioStatusWrite((uint32_t *) &GpioRw->lpp_gpio_pin[index].status, oldValue, newValue, (int8_t) index);
+			if(Complex[index].Owner < HOST_NUM_GPIO)
+				HostDutPinDriven(Complex[index].Owner, HostFx3Drive(Complex[index].Owner, HostSimNs), HostSimNs);
+			break;
+		case offsetof(LPP_GPIO_PIN_T, timer):
+			Complex[index].BaseValue = newValue;
+			Complex[index].BaseNs = HostSimNs;
+			break;
+		case offsetof(LPP_GPIO_PIN_T, period):
+			GpioRw->lpp_gpio_pin[index].period = oldValue;
+			HostTimerRebase(index);
+			GpioRw->lpp_gpio_pin[index].period = newValue;
+			break;
+		default:
+			break;
+		}
+		return;
+	}
+
+	/* Summary registers are read only */
+	if(offset >= offsetof(LPP_GPIO_REGS_T, lpp_gpio_invalue0))
+	{
+		*(uint32_t *) (RwBase + offset) = oldValue;
+	}
+}
+
+void HostGpioSetCallback(void (*cb)(uint8_t), uint32_t fastClkHz, uint32_t slowClkHz)
+{
+	HostRegsUpdate();
+	GpioCallback = cb;
+	if(fastClkHz)
+		FastClkHz = fastClkHz;
+	if(slowClkHz)
+		SlowClkHz = slowClkHz;
+}
+
+void HostGpioSetSimple(uint8_t pin, uint32_t status)
+{
+	HostRegsUpdate();
+	if(ComplexMode[pin] && (Complex[pin % 8].Owner == pin))
+		Complex[pin % 8].Owner = 0xFF;
+	ComplexMode[pin] = CyFalse;
+	GpioRw->lpp_gpio_simple[pin] = status;
+	LastLevel[pin] = HostPinLevelAt(pin, HostSimNs);
+	HostDutPinDriven(pin, HostFx3Drive(pin, HostSimNs), HostSimNs);
+	HostRegsUpdate();
+}
+
+void HostGpioSetComplex(uint8_t pin, uint32_t status, uint32_t timer, uint32_t period, uint32_t threshold)
+{
+	uint8_t index = pin % 8;
+
+	HostRegsUpdate();
+	ComplexMode[pin] = CyTrue;
+	Complex[index].Owner = pin;
+	Complex[index].MeasureActive = CyFalse;
+	Complex[index].BaseValue = timer;
+	Complex[index].BaseNs = HostSimNs;
+	GpioRw->lpp_gpio_pin[index].timer = timer;
+	GpioRw->lpp_gpio_pin[index].period = period;
+	GpioRw->lpp_gpio_pin[index].threshold = threshold;
+	GpioRw->lpp_gpio_pin[index].status = status;
+	LastLevel[pin] = HostPinLevelAt(pin, HostSimNs);
+	HostDutPinDriven(pin, HostFx3Drive(pin, HostSimNs), HostSimNs);
+	HostRegsUpdate();
+}
+
+void HostGpioDisable(uint8_t pin)
+{
+	HostRegsUpdate();
+	if(ComplexMode[pin])
+	{
+		if(Complex[pin % 8].Owner == pin)
+		{
+			GpioRw->lpp_gpio_pin[pin % 8].status = 0;
+			Complex[pin % 8].Owner = 0xFF;
+			Complex[pin % 8].MeasureActive = CyFalse;
+		}
+		ComplexMode[pin] = CyFalse;
+	}
+	GpioRw->lpp_gpio_simple[pin] = 0;
+	HostDutPinDriven(pin, HOST_PIN_Z, HostSimNs);
+	HostRegsUpdate();
+}
+
+CyBool_t HostGpioIsComplex(uint8_t pin)
+{
+	return (CyBool_t) (ComplexMode[pin] && (Complex[pin % 8].Owner == pin));
+}
+
+void HostGpioMeasureStart(uint8_t pin, CyBool_t measureHigh)
+{
+	uint8_t index = pin % 8;
+
+	HostRegsUpdate();
+	Complex[index].MeasureActive = CyTrue;
+	Complex[index].MeasureHigh = measureHigh;
+	Complex[index].MeasureArmNs = HostSimNs;
+}
+
+/**
+  * @brief Finds the first complete pulse of the measured polarity after the measurement was started.
+  *
+  * @return CyTrue if the pulse has finished.
+ **/
+CyBool_t HostGpioMeasureResult(uint8_t pin, uint32_t *ticks, uint64_t *doneNs)
+{
+	uint8_t index = pin % 8;
+	uint64_t t, start = HOST_NS_NEVER;
+	uint32_t hz;
+	int active, level, prev;
+
+	HostRegsUpdate();
+	*doneNs = HOST_NS_NEVER;
+	if(!Complex[index].MeasureActive)
+		return CyFalse;
+
+	hz = HostTimerHz(GpioRw->lpp_gpio_pin[index].status);
+	active = Complex[index].MeasureHigh ? 1 : 0;
+	t = Complex[index].MeasureArmNs;
+	prev = HostPinLevelAt(pin, t);
+	/* Look ahead along the DUT edges. The pulse may end in the future, which gives the completion time */
+	while((t = HostDutNextEdge(pin, t)) != HOST_NS_NEVER)
+	{
+		level = HostPinLevelAt(pin, t);
+		if(level == prev)
+			continue;
+		if((level == active) && (start == HOST_NS_NEVER))
+		{
+			start = t;
+		}
+		else if((level != active) && (start != HOST_NS_NEVER))
+		{
+			*doneNs = t;
+			if(t > HostSimNs)
+				return CyFalse;
+			*ticks = (uint32_t) (HostTicks(t, hz) - HostTicks(start, hz));
+			GpioRw->lpp_gpio_pin[index].threshold = *ticks;
+			Complex[index].MeasureActive = CyFalse;
+			return CyTrue;
+		}
+		prev = level;
+	}
+	return CyFalse;
+}
+
+/* ---------------------------------------- VIC ---------------------------------------- */
+
+void CyU3PVicEnableInt(uint32_t vectorNum)
+{
+	if(vectorNum == CY_U3P_VIC_GPIO_CORE_VECTOR)
+	{
+		HostRegsUpdate();
+		VicGpioEnabled = CyTrue;
+		HostSafePoint();
+	}
+}
+
+void CyU3PVicDisableInt(uint32_t vectorNum)
+{
+	if(vectorNum == CY_U3P_VIC_GPIO_CORE_VECTOR)
+		VicGpioEnabled = CyFalse;
+}
+
+void CyU3PVicClearInt(void)
+{
+}
+
+uint32_t CyU3PVicDisableAllInterrupts(void)
+{
+	uint32_t oldMask = VicMasked ? 0 : 1;
+
+	VicMasked = CyTrue;
+	return oldMask;
+}
+
+void CyU3PVicEnableInterrupts(uint32_t mask)
+{
+	if(mask)
+	{
+		VicMasked = CyFalse;
+		HostSafePoint();
+	}
+}
+
+CyBool_t HostIrqMasked(void)
+{
+	return VicMasked;
+}
+
+/**
+  * @brief Runs the GPIO interrupt callback for every latched pin interrupt, like the SDK GPIO ISR.
+ **/
+void HostRegsDispatchInterrupts(void)
+{
+	uint32_t *status;
+	uint8_t pin;
+
+	if(!VicGpioEnabled || VicMasked || HostInInterrupt() || (GpioCallback == NULL))
+		return;
+
+	for(pin = 0; pin < HOST_NUM_GPIO; pin++)
+	{
+		if(ComplexMode[pin] && (Complex[pin % 8].Owner != pin))
+			continue;
+		status = HostPinStatus(pin);
+		if((*status & CY_U3P_LPP_GPIO_INTR) && (HOST_GPIO_INTRMODE(*status) != CY_U3P_GPIO_NO_INTR))
+		{
+			*status &= ~CY_U3P_LPP_GPIO_INTR;
+			HostInterruptEnter();
+			GpioCallback(pin);
+			HostInterruptExit();
+			/* The callback may have disabled the vector */
+			if(!VicGpioEnabled)
+				break;
+		}
+	}
+	HostRegsUpdate();
+}
+
+/* ---------------------------------------- SPI ---------------------------------------- */
+
+static uint32_t HostSpiWordBits(void)
+{
+	uint32_t bits = (SpiRw->lpp_spi_config & CY_U3P_LPP_SPI_WL_MASK) >> CY_U3P_LPP_SPI_WL_POS;
+	return bits ? bits : 8;
+}
+
+static uint64_t HostSpiBitNs(void)
+{
+	return 1000000000ull / Spi.SclkHz;
+}
+
+static uint64_t HostSpiLeadNs(void)
+{
+	return ((SpiRw->lpp_spi_config & CY_U3P_LPP_SPI_LEAD_MASK) >> CY_U3P_LPP_SPI_LEAD_POS) * HostSpiBitNs() / 2;
+}
+
+static uint64_t HostSpiLagNs(void)
+{
+	return ((SpiRw->lpp_spi_config & CY_U3P_LPP_SPI_LAG_MASK) >> CY_U3P_LPP_SPI_LAG_POS) * HostSpiBitNs() / 2;
+}
+
+/**
+  * @brief Chip select is toggled per word for the each word mode, and held for the transfer otherwise.
+ **/
+static CyBool_t HostSpiSelectEachWord(void)
+{
+	uint32_t ctrl = (SpiRw->lpp_spi_config & CY_U3P_LPP_SPI_SSNCTRL_MASK) >> CY_U3P_LPP_SPI_SSNCTRL_POS;
+	return (CyBool_t) ((ctrl == 1) || (ctrl == 2));
+}
+
+static void HostBitPut(uint8_t *bits, uint32_t pos, uint32_t value)
+{
+	if(value)
+		bits[pos / 8] |= (uint8_t) (0x80 >> (pos % 8));
+	else
+		bits[pos / 8] &= (uint8_t) ~(0x80 >> (pos % 8));
+}
+
+static uint32_t HostBitGet(const uint8_t *bits, uint32_t pos)
+{
+	return (bits[pos / 8] >> (7 - (pos % 8))) & 1;
+}
+
+/**
+  * @brief Shifts whole words through the DUT. The words are little endian in memory, and go out MSB first
+  * (or LSB first with the endian bit set).
+ **/
+static void HostSpiShiftWords(const uint8_t *tx, uint8_t *rx, uint32_t numWords, uint64_t startNs)
+{
+	static uint8_t mosi[8192], miso[8192];
+	uint32_t wordBits = HostSpiWordBits(), wordBytes = (wordBits + 7) / 8;
+	CyBool_t lsbFirst = (CyBool_t) ((SpiRw->lpp_spi_config & CY_U3P_LPP_SPI_ENDIAN) != 0);
+	uint32_t word, bit, pos, value, wirePos = 0;
+
+	if(numWords * wordBits > sizeof(mosi) * 8)
+		HostFatal("SPI chunk too long");
+
+	for(word = 0; word < numWords; word++)
+	{
+		value = 0;
+		for(pos = 0; pos < wordBytes; pos++)
+			value |= (uint32_t) (tx ? tx[word * wordBytes + pos] : 0) << (8 * pos);
+		for(bit = 0; bit < wordBits; bit++)
+			HostBitPut(mosi, wirePos++, (value >> (lsbFirst ? bit : (wordBits - 1 - bit))) & 1);
+	}
+
+	HostDutSpiShift(mosi, miso, numWords * wordBits, startNs, Spi.SclkHz);
+
+	wirePos = 0;
+	for(word = 0; word < numWords; word++)
+	{
+		value = 0;
+		for(bit = 0; bit < wordBits; bit++)
+			value |= HostBitGet(miso, wirePos++) << (lsbFirst ? bit : (wordBits - 1 - bit));
+		if(rx != NULL)
+		{
+			for(pos = 0; pos < wordBytes; pos++)
+				rx[word * wordBytes + pos] = (uint8_t) (value >> (8 * pos));
+		}
+	}
+}
+
+/**
+  * @brief Runs one register mode SPI transfer (CyU3PSpiTransmitWords and friends, or an egress write).
+  * The transfer starts now, and the SPI block reads busy until it finishes.
+  *
+  * @return The time at which the transfer finishes.
+ **/
+uint64_t HostSpiRegisterTransfer(uint8_t *txBuf, uint8_t *rxBuf, uint32_t numBytes)
+{
+	uint32_t wordBytes = (HostSpiWordBits() + 7) / 8, numWords = numBytes / wordBytes, word;
+	uint64_t t = HostSimNs, wordNs = HostSpiWordBits() * HostSpiBitNs();
+
+	if(t < Spi.BusyUntilNs)
+		t = Spi.BusyUntilNs;
+
+	if(HostSpiSelectEachWord())
+	{
+		for(word = 0; word < numWords; word++)
+		{
+			HostDutSpiSelect(t);
+			t += HostSpiLeadNs();
+			HostSpiShiftWords(txBuf ? txBuf + word * wordBytes : NULL, rxBuf ? rxBuf + word * wordBytes : NULL, 1, t);
+			t += wordNs + HostSpiLagNs();
+			HostDutSpiDeselect(t);
+			t += HostSpiBitNs();
+		}
+	}
+	else if(numWords)
+	{
+		HostDutSpiSelect(t);
+		t += HostSpiLeadNs();
+		HostSpiShiftWords(txBuf, rxBuf, numWords, t);
+		t += numWords * wordNs + HostSpiLagNs();
+		HostDutSpiDeselect(t);
+	}
+	Spi.BusyUntilNs = t;
+	return t;
+}
+
+void HostSpiSetConfig(uint32_t config, uint32_t sclkHz)
+{
+	HostRegsUpdate();
+	SpiRw->lpp_spi_config = config;
+	if(sclkHz)
+		Spi.SclkHz = sclkHz;
+}
+
+static void HostSpiDmaStart(void)
+{
+	uint32_t config = SpiRw->lpp_spi_config;
+
+	Spi.TxLeft = (config & CY_U3P_LPP_SPI_TX_ENABLE) ? SpiRw->lpp_spi_tx_byte_count : 0;
+	Spi.RxLeft = (config & CY_U3P_LPP_SPI_RX_ENABLE) ? SpiRw->lpp_spi_rx_byte_count : 0;
+	Spi.BytesLeft = (Spi.TxLeft > Spi.RxLeft) ? Spi.TxLeft : Spi.RxLeft;
+	Spi.NextNs = (HostSimNs > Spi.BusyUntilNs) ? HostSimNs : Spi.BusyUntilNs;
+	Spi.Selected = CyFalse;
+	Spi.DmaDone = CyFalse;
+	Spi.DmaActive = (CyBool_t) (Spi.BytesLeft != 0);
+	if(!Spi.DmaActive)
+		Spi.DmaDone = CyTrue;
+}
+
+static void HostSpiDmaFinish(void)
+{
+	CyU3PDmaChannel *rxChannel;
+
+	if(Spi.Selected)
+	{
+		Spi.NextNs += HostSpiLagNs();
+		HostDutSpiDeselect(Spi.NextNs);
+		Spi.Selected = CyFalse;
+	}
+	Spi.BusyUntilNs = Spi.NextNs;
+	Spi.DmaActive = CyFalse;
+	Spi.DmaDone = CyTrue;
+	SpiRw->lpp_spi_config &= ~CY_U3P_LPP_SPI_ENABLE;
+	rxChannel = HostDmaProducer(CY_U3P_LPP_SOCKET_SPI_PROD);
+	if((rxChannel != NULL) && (SpiRw->lpp_spi_config & CY_U3P_LPP_SPI_RX_ENABLE))
+		HostDmaProduceEnd(rxChannel);
+	HostWake(&Spi);
+}
+
+/**
+  * @brief Moves a DMA mode transfer forward to the current time, as far as the Tx data and Rx space allow.
+ **/
+static void HostSpiDmaUpdate(void)
+{
+	static uint8_t tx[8192], rx[8192];
+	CyU3PDmaChannel *txChannel, *rxChannel;
+	uint32_t wordBits = HostSpiWordBits(), wordBytes = (wordBits + 7) / 8, words, limit;
+	uint64_t wordNs = wordBits * HostSpiBitNs();
+
+	while(Spi.DmaActive)
+	{
+		if(Spi.NextNs > HostSimNs)
+			return;
+
+		txChannel = HostDmaConsumer(CY_U3P_LPP_SOCKET_SPI_CONS);
+		rxChannel = HostDmaProducer(CY_U3P_LPP_SOCKET_SPI_PROD);
+
+		/* Words which have finished shifting by now */
+		if(!Spi.Selected)
+			words = (uint32_t) ((HostSimNs - Spi.NextNs) / (HostSpiLeadNs() + wordNs + 1));
+		else
+			words = (uint32_t) ((HostSimNs - Spi.NextNs) / wordNs);
+		limit = (Spi.BytesLeft + wordBytes - 1) / wordBytes;
+		if(words > limit)
+			words = limit;
+		if(HostSpiSelectEachWord() && (words > 1))
+			words = 1;
+		if(words > sizeof(tx) / wordBytes)
+			words = sizeof(tx) / wordBytes;
+		if(Spi.TxLeft)
+		{
+			limit = (txChannel ? HostDmaConsumeAvail(txChannel) : 0) / wordBytes;
+			if((limit == 0) && txChannel && (HostDmaConsumeAvail(txChannel) >= Spi.TxLeft))
+				limit = 1;
+			if(words > limit)
+				words = limit;
+		}
+		if(Spi.RxLeft)
+		{
+			limit = (rxChannel ? HostDmaProduceSpace(rxChannel) : 0) / wordBytes;
+			if(words > limit)
+				words = limit;
+		}
+		if(words == 0)
+			return;
+
+		if(!Spi.Selected)
+		{
+			HostDutSpiSelect(Spi.NextNs);
+			Spi.Selected = CyTrue;
+			Spi.NextNs += HostSpiLeadNs();
+		}
+
+		memset(tx, 0, words * wordBytes);
+		if(Spi.TxLeft)
+		{
+			limit = (words * wordBytes < Spi.TxLeft) ? words * wordBytes : Spi.TxLeft;
+			HostDmaConsume(txChannel, tx, limit);
+			Spi.TxLeft -= limit;
+		}
+		HostSpiShiftWords(tx, rx, words, Spi.NextNs);
+		Spi.NextNs += words * wordNs;
+		if(Spi.RxLeft)
+		{
+			limit = (words * wordBytes < Spi.RxLeft) ? words * wordBytes : Spi.RxLeft;
+			HostDmaProduce(rxChannel, rx, limit);
+			Spi.RxLeft -= limit;
+		}
+		Spi.BytesLeft = (words * wordBytes < Spi.BytesLeft) ? Spi.BytesLeft - words * wordBytes : 0;
+
+		if(Spi.BytesLeft == 0)
+		{
+			HostSpiDmaFinish();
+		}
+		else if(HostSpiSelectEachWord())
+		{
+			Spi.NextNs += HostSpiLagNs();
+			HostDutSpiDeselect(Spi.NextNs);
+			Spi.Selected = CyFalse;
+			Spi.NextNs += HostSpiBitNs();
+		}
+	}
+}
+
+/**
+  * @brief Time at which the active DMA transfer finishes the data it has.
+ **/
+static uint64_t HostSpiNextEventNs(void)
+{
+	CyU3PDmaChannel *txChannel;
+	uint32_t wordBits = HostSpiWordBits(), wordBytes = (wordBits + 7) / 8, words;
+
+	if(!Spi.DmaActive)
+		return HOST_NS_NEVER;
+	words = (Spi.BytesLeft + wordBytes - 1) / wordBytes;
+	if(Spi.TxLeft)
+	{
+		txChannel = HostDmaConsumer(CY_U3P_LPP_SOCKET_SPI_CONS);
+		if((txChannel == NULL) || (HostDmaConsumeAvail(txChannel) == 0))
+			return HOST_NS_NEVER;
+		if(HostDmaConsumeAvail(txChannel) / wordBytes < words)
+			words = HostDmaConsumeAvail(txChannel) / wordBytes;
+		if(words == 0)
+			words = 1;
+	}
+	if(HostSpiSelectEachWord())
+		words = 1;
+	return Spi.NextNs + HostSpiLeadNs() + words * wordBits * HostSpiBitNs() + 1;
+}
+
+/**
+  * @brief Number of SPI enables written with neither Rx nor Tx enabled. The block has nothing to transfer
+  * then, so this is an enable the firmware did not set up (for example, an unarmed burst start).
+ **/
+uint32_t HostSpiStrayEnables(void)
+{
+	return Spi.StrayEnables;
+}
+
+CyBool_t HostSpiDmaDone(void)
+{
+	HostRegsUpdate();
+	return (CyBool_t) !Spi.DmaActive;
+}
+
+void HostSpiDmaAbort(void)
+{
+	HostRegsUpdate();
+	if(Spi.DmaActive)
+	{
+		if(Spi.Selected)
+			HostDutSpiDeselect(HostSimNs);
+		Spi.Selected = CyFalse;
+		Spi.DmaActive = CyFalse;
+		Spi.BusyUntilNs = HostSimNs;
+		HostWake(&Spi);
+	}
+	SpiRw->lpp_spi_config &= ~(CY_U3P_LPP_SPI_RX_ENABLE | CY_U3P_LPP_SPI_TX_ENABLE | CY_U3P_LPP_SPI_DMA_MODE | CY_U3P_LPP_SPI_ENABLE);
+}
+
+/**
+  * @brief Blocks until the SPI DMA transfer finishes.
+ **/
+CyU3PReturnStatus_t HostSpiDmaWait(uint32_t waitMs)
+{
+	uint64_t deadline = HostDeadline(waitMs);
+
+	while(!HostSpiDmaDone())
+	{
+		if(!HostWait(&Spi, deadline))
+			return CY_U3P_ERROR_TIMEOUT;
+	}
+	return CY_U3P_SUCCESS;
+}
+
+static void HostSpiWrite(uint32_t offset, uint32_t oldValue, uint32_t newValue)
+{
+	uint8_t tx[4], rx[4];
+	uint32_t value;
+
+	switch(offset)
+	{
+	case offsetof(LPP_SPI_REGS_T, lpp_spi_config):
+		if(newValue & CY_U3P_LPP_SPI_RX_CLEAR)
+			Spi.RxValid = CyFalse;
+		if((newValue & CY_U3P_LPP_SPI_ENABLE) && !(oldValue & CY_U3P_LPP_SPI_ENABLE) &&
+				!(newValue & (CY_U3P_LPP_SPI_RX_ENABLE | CY_U3P_LPP_SPI_TX_ENABLE)))
+			Spi.StrayEnables++;
+		if((newValue & CY_U3P_LPP_SPI_ENABLE) && !(oldValue & CY_U3P_LPP_SPI_ENABLE) && (newValue & CY_U3P_LPP_SPI_DMA_MODE))
+		{
+			HostSpiDmaStart();
+		}
+		else if(!(newValue & CY_U3P_LPP_SPI_ENABLE) && Spi.DmaActive)
+		{
+			HostSpiDmaAbort();
+			SpiRw->lpp_spi_config = newValue;
+		}
+		break;
+
+	case offsetof(LPP_SPI_REGS_T, lpp_spi_egress_data):
+		if(!(SpiRw->lpp_spi_config & CY_U3P_LPP_SPI_ENABLE) || (SpiRw->lpp_spi_config & CY_U3P_LPP_SPI_DMA_MODE))
+			break;
+		tx[0] = (uint8_t) newValue;
+		tx[1] = (uint8_t) (newValue >> 8);
+		tx[2] = (uint8_t) (newValue >> 16);
+		tx[3] = (uint8_t) (newValue >> 24);
+		memset(rx, 0, sizeof(rx));
+		HostSpiRegisterTransfer(tx, rx, (HostSpiWordBits() + 7) / 8);
+		value = rx[0] | (rx[1] << 8) | (rx[2] << 16) | ((uint32_t) rx[3] << 24);
+		SpiRw->lpp_spi_ingress_data = value;
+		Spi.RxValid = CyTrue;
+		break;
+
+	case offsetof(LPP_SPI_REGS_T, lpp_spi_status):
+	case offsetof(LPP_SPI_REGS_T, lpp_spi_ingress_data):
+		/* Read only */
+		*(uint32_t *) ((uint8_t *) SpiRw + offset) = oldValue;
+		break;
+
+	case offsetof(LPP_SPI_REGS_T, lpp_spi_intr):
+		/* Write one to clear */
+		SpiRw->lpp_spi_intr = oldValue & ~newValue;
+		break;
+
+	default:
+		break;
+	}
+}
+
+static void HostSpiStatusUpdate(void)
+{
+	uint32_t status = CY_U3P_LPP_SPI_RX_SPACE;
+	CyBool_t busy = (CyBool_t) (Spi.DmaActive || (HostSimNs < Spi.BusyUntilNs));
+
+	if(busy)
+		status |= CY_U3P_LPP_SPI_BUSY;
+	else
+		status |= CY_U3P_LPP_SPI_TX_DONE | CY_U3P_LPP_SPI_TX_SPACE;
+	if(Spi.RxValid && !busy)
+		status |= CY_U3P_LPP_SPI_RX_DATA;
+	SpiRw->lpp_spi_status = status;
+	SpiRw->lpp_spi_intr |= (status & (CY_U3P_LPP_SPI_TX_DONE | CY_U3P_LPP_SPI_RX_DATA));
+}
+
+/* ---------------------------------------- Model update ---------------------------------------- */
+
+/**
+  * @brief Processes the logged register writes and brings every model up to the current simulated time.
+ **/
+void HostRegsUpdate(void)
+{
+	uint32_t index;
+
+	if(Updating || (RwBase == NULL))
+		return;
+	Updating = CyTrue;
+	HostInterruptEnter();
+
+	for(index = 0; index < WriteCount; index++)
+	{
+		if(WriteLog[index].Offset < HOST_SPI_OFFSET)
+			HostGpioWrite(WriteLog[index].Offset, WriteLog[index].Old, WriteLog[index].New);
+		else
+			HostSpiWrite(WriteLog[index].Offset - HOST_SPI_OFFSET, WriteLog[index].Old, WriteLog[index].New);
+	}
+	WriteCount = 0;
+
+	HostGpioUpdate();
+	HostSpiDmaUpdate();
+	HostSpiStatusUpdate();
+	HostI2cUpdate();
+	LastUpdateNs = HostSimNs;
+
+	HostInterruptExit();
+	Updating = CyFalse;
+}
+
+uint64_t HostRegsNextEventNs(void)
+{
+	uint64_t next = HostGpioNextEventNs(), t;
+
+	t = HostSpiNextEventNs();
+	if(t < next)
+		next = t;
+	t = HostI2cNextEventNs();
+	if(t < next)
+		next = t;
+	return next;
+}
@@ -0,0 +1,1548 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		HostSdk.c
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK system, DMA, USB, GPIO, SPI, I2C and UART services.
+ **/
+
+/*
+ * Each SDK call costs HOST_SDK_CALL_NS of simulated time and is a preemption point, the same as a register access.
+ *
+ * DMA channels keep their buffers in a ring. A producer fills the buffer after the committed ones, and the consumer
+ * takes committed buffers from the head. USB IN sockets (UIB consumers) are drained as soon as a buffer is
+ * committed, into the HostUsbIn capture for the endpoint, so the simulated PC never stalls a stream. Peripheral
+ * sockets (SPI, I2C) are driven by the register models in HostRegs.c.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Host.h"
+#include "cyu3system.h"
+#include "cyu3gpio.h"
+#include "cyu3spi.h"
+#include "cyu3i2c.h"
+#include "cyu3uart.h"
+#include "cyu3pib.h"
+#include "cyu3vic.h"
+#include "gpio_regs.h"
+#include "spi_regs.h"
+
+/** Cost of an SDK call, and a preemption point */
+#define HOST_SDK_CALL()							do { HostSpend(HOST_SDK_CALL_NS); HostSafePoint(); } while(0)
+
+/** Exit code for a firmware requested device reset */
+#define HOST_EXIT_RESET							(3)
+
+/** Size of the I2C EEPROM (M24M02, four 64KB device addresses) */
+#define HOST_EEPROM_SIZE						(0x40000)
+
+/** Time allowed for a blocking SDK transfer before it reports a timeout */
+#define HOST_USB_MICROFRAME_NS					(125000)
+#define HOST_XFER_TIMEOUT_MS					(10000)
+
+HostUsbInEndpoint HostUsbIn[16];
+HostControlTransfer HostEp0;
+
+static CyU3PDmaChannel *Channels;
+
+static CyU3PUSBSetupCb_t UsbSetupCb;
+static CyU3PUSBEventCb_t UsbEventCb;
+static CyBool_t UsbConnected;
+static CyU3PUSBSpeed_t UsbSpeed;
+static CyU3PEpConfig_t UsbEpConfig[32];
+
+/** I2C controller state */
+static struct
+{
+	CyBool_t Configured;
+	uint32_t BitRate;
+	CyBool_t IsDma;
+	CyBool_t Active;
+	CyBool_t Done;
+	CyBool_t IsRead;
+	CyBool_t DmaWait;
+	CyU3PReturnStatus_t Status;
+	CyU3PI2cPreamble_t Preamble;
+	uint32_t Count;
+	uint64_t DoneNs;
+	uint32_t EepromPtr;
+}I2c;
+
+static uint8_t Eeprom[HOST_EEPROM_SIZE];
+static CyBool_t EepromInit;
+
+/* ---------------------------------------- System ---------------------------------------- */
+
+CyU3PReturnStatus_t CyU3PDeviceInit(CyU3PSysClockConfig_t *clkCfg_p)
+{
+	if(!EepromInit)
+	{
+		memset(Eeprom, 0xFF, sizeof(Eeprom));
+		EepromInit = CyTrue;
+	}
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDeviceCacheControl(CyBool_t isICacheEnable, CyBool_t isDCacheEnable, CyBool_t isDmaHandleDCache)
+{
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDeviceConfigureIOMatrix(CyU3PIoMatrixConfig_t *cfg_p)
+{
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDeviceGpioOverride(uint8_t gpioId, CyBool_t isSimple)
+{
+	HOST_SDK_CALL();
+	if(gpioId >= HOST_NUM_GPIO)
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDeviceGpioRestore(uint8_t gpioId)
+{
+	HOST_SDK_CALL();
+	return CY_U3P_SUCCESS;
+}
+
+void CyU3PDeviceReset(CyBool_t isWarmReset)
+{
+	fflush(stdout);
+	fprintf(stderr, "host: %.3f ms [%s]: device reset (%s)\n", HostSimNs / 1e6, HostThreadName(), isWarmReset ? "warm" : "cold");
+	exit(HOST_EXIT_RESET);
+}
+
+CyU3PReturnStatus_t CyU3PReadDeviceRegisters(uvint32_t *regAddr, uint8_t numRegs, uint32_t *dataBuf)
+{
+	/* Only the EFUSE die ID is read. Return a fixed ID, so the serial number is the same every run */
+	static const uint32_t dieId[2] = {0x12345678, 0x0000ADF3};
+	uint8_t i;
+
+	for(i = 0; i < numRegs; i++)
+	{
+		dataBuf[i] = (i < 2) ? dieId[i] : 0;
+	}
+	return CY_U3P_SUCCESS;
+}
+
+void CyU3PSysWatchDogConfigure(CyBool_t enable, uint32_t period)
+{
+}
+
+void CyU3PKernelEntry(void)
+{
+	CyFxApplicationDefine();
+	HostOsStart();
+}
+
+void CyFx3BusyWait(uint16_t usWait)
+{
+	HostSpend((uint64_t) usWait * 1000);
+	HostSafePoint();
+}
+
+CyU3PReturnStatus_t CyU3PPibDeInit(void)
+{
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDebugInit(uint16_t destSckId, uint8_t traceLevel)
+{
+	return CY_U3P_SUCCESS;
+}
+
+void CyU3PDebugPreamble(CyBool_t sendPreamble)
+{
+}
+
+CyU3PReturnStatus_t CyU3PDebugPrint(uint8_t priority, char *message, ...)
+{
+	char line[512];
+	char *src, *dst;
+	va_list args;
+
+	HOST_SDK_CALL();
+	if(!HostVerbose)
+		return CY_U3P_SUCCESS;
+
+	va_start(args, message);
+	vsnprintf(line, sizeof(line), message, args);
+	va_end(args);
+	/* Drop the carriage returns from the UART line endings */
+	for(src = dst = line; *src; src++)
+	{
+		if(*src != '\r')
+			*dst++ = *src;
+	}
+	*dst = 0;
+	printf("%10.3f ms  %s", HostSimNs / 1e6, line);
+	return CY_U3P_SUCCESS;
+}
+
+/* ---------------------------------------- UART ---------------------------------------- */
+
+CyU3PReturnStatus_t CyU3PUartInit(void)
+{
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PUartDeInit(void)
+{
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PUartSetConfig(CyU3PUartConfig_t *config, CyU3PUartIntrCb_t cb)
+{
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PUartTxSetBlockXfer(uint32_t txSize)
+{
+	return CY_U3P_SUCCESS;
+}
+
+/* ---------------------------------------- DMA ---------------------------------------- */
+
+static CyBool_t HostIsUsbIn(uint16_t socket)
+{
+	return (CyBool_t) ((socket & 0xFF00) == 0x0300);
+}
+
+static uint8_t HostUsbInEp(uint16_t socket)
+{
+	return (uint8_t) (socket & 0xF);
+}
+
+static CyBool_t HostIsCpu(uint16_t socket)
+{
+	return (CyBool_t) (socket == CY_U3P_CPU_SOCKET_CONS);
+}
+
+static void HostUsbInAppend(uint8_t ep, const uint8_t *data, uint32_t numBytes)
+{
+	HostUsbInEndpoint *in = &HostUsbIn[ep & 0xF];
+
+	if(in->Bytes + numBytes > in->Capacity)
+	{
+		in->Capacity = (in->Bytes + numBytes) * 2 + 4096;
+		in->Data = realloc(in->Data, in->Capacity);
+		if(in->Data == NULL)
+			HostFatal("out of memory for USB endpoint 0x%x data", 0x80 | ep);
+	}
+	memcpy(in->Data + in->Bytes, data, numBytes);
+	in->Bytes += numBytes;
+	if(in->Transfers == in->TransferCapacity)
+	{
+		in->TransferCapacity = in->TransferCapacity * 2 + 256;
+		in->TransferBytes = realloc(in->TransferBytes, in->TransferCapacity * sizeof(uint32_t));
+		if(in->TransferBytes == NULL)
+			HostFatal("out of memory for USB endpoint 0x%x transfers", 0x80 | ep);
+	}
+	in->TransferBytes[in->Transfers++] = numBytes;
+	HostWake(in);
+}
+
+void HostUsbInClear(uint8_t ep)
+{
+	HostUsbIn[ep & 0xF].Bytes = 0;
+	HostUsbIn[ep & 0xF].Transfers = 0;
+}
+
+static void HostDmaCallback(CyU3PDmaChannel *ch, CyU3PDmaCbType_t type, CyU3PDmaBuffer_t *buffer)
+{
+	CyU3PDmaCBInput_t input;
+
+	if((ch->Config.cb == NULL) || !(ch->Config.notification & type))
+		return;
+	if(buffer != NULL)
+		input.buffer_p = *buffer;
+	else
+		memset(&input, 0, sizeof(input));
+	HostInterruptEnter();
+	ch->Config.cb(ch, type, &input);
+	HostInterruptExit();
+}
+
+/**
+  * @brief Passes committed buffers to a USB IN endpoint, unless the PC has paused reading it.
+ **/
+static void HostDmaDeliver(CyU3PDmaChannel *ch)
+{
+	if(!HostIsUsbIn(ch->Config.consSckId))
+	{
+		HostWake(ch);
+		return;
+	}
+	while(ch->Full && !HostUsbIn[HostUsbInEp(ch->Config.consSckId)].Paused)
+	{
+		HostUsbInAppend(HostUsbInEp(ch->Config.consSckId), ch->Buffers[ch->Head], ch->Counts[ch->Head]);
+		ch->ConsXferCount += ch->Counts[ch->Head];
+		ch->Head = (ch->Head + 1) % ch->Config.count;
+		ch->Full--;
+	}
+	HostWake(ch);
+}
+
+/**
+  * @brief Stops or restarts the simulated PC reading a bulk IN endpoint. Restarting reads everything
+  * committed while the endpoint was paused.
+ **/
+void HostUsbInPause(uint8_t ep, CyBool_t paused)
+{
+	CyU3PDmaChannel *ch;
+
+	HostUsbIn[ep & 0xF].Paused = paused;
+	ch = HostDmaConsumer(CY_U3P_UIB_SOCKET_CONS_0 + (ep & 0xF));
+	if(!paused && (ch != NULL))
+		HostDmaDeliver(ch);
+}
+
+static void HostDmaCommit(CyU3PDmaChannel *ch, uint16_t count)
+{
+	uint32_t index = (ch->Head + ch->Full) % ch->Config.count;
+
+	ch->Counts[index] = count;
+	ch->Full++;
+	ch->Filled = 0;
+	ch->ProdXferCount += count;
+	HostDmaDeliver(ch);
+}
+
+static void HostDmaOverrideDone(CyU3PDmaChannel *ch, CyU3PDmaCbType_t type)
+{
+	ch->Override = CyFalse;
+	ch->OverrideDone = CyTrue;
+	ch->State = CY_U3P_DMA_CONFIGURED;
+	HostWake(ch);
+	HostDmaCallback(ch, type, &ch->OverrideBuffer);
+}
+
+CyU3PDmaChannel *HostDmaProducer(uint16_t socket)
+{
+	CyU3PDmaChannel *ch;
+
+	for(ch = Channels; ch != NULL; ch = ch->Next)
+	{
+		if(ch->Config.prodSckId == socket)
+			return ch;
+	}
+	return NULL;
+}
+
+CyU3PDmaChannel *HostDmaConsumer(uint16_t socket)
+{
+	CyU3PDmaChannel *ch;
+
+	for(ch = Channels; ch != NULL; ch = ch->Next)
+	{
+		if(ch->Config.consSckId == socket)
+			return ch;
+	}
+	return NULL;
+}
+
+/**
+  * @brief Number of bytes a peripheral producer can write to the channel now.
+ **/
+uint32_t HostDmaProduceSpace(CyU3PDmaChannel *ch)
+{
+	if(ch->Override)
+		return (ch->State == CY_U3P_DMA_PROD_OVERRIDE) ? 0 : ch->OverrideBuffer.size - ch->OverrideOffset;
+	if(ch->Config.count == 0)
+		return 0;
+	return (ch->Config.count - ch->Full) * ch->Config.size - ch->Filled;
+}
+
+uint32_t HostDmaProduce(CyU3PDmaChannel *ch, const uint8_t *data, uint32_t numBytes)
+{
+	uint32_t done = 0, chunk, index;
+
+	if(ch->Override)
+	{
+		chunk = HostDmaProduceSpace(ch);
+		if(chunk > numBytes)
+			chunk = numBytes;
+		memcpy(ch->OverrideBuffer.buffer + ch->OverrideOffset, data, chunk);
+		ch->OverrideOffset += chunk;
+		ch->ProdXferCount += chunk;
+		if(ch->OverrideOffset >= ch->OverrideBuffer.size)
+		{
+			ch->OverrideBuffer.count = (uint16_t) ch->OverrideOffset;
+			HostDmaOverrideDone(ch, CY_U3P_DMA_CB_RECV_CPLT);
+		}
+		return chunk;
+	}
+
+	while((done < numBytes) && (ch->Config.count != 0) && (ch->Full < ch->Config.count))
+	{
+		index = (ch->Head + ch->Full) % ch->Config.count;
+		chunk = ch->Config.size - ch->Filled;
+		if(chunk > numBytes - done)
+			chunk = numBytes - done;
+		memcpy(ch->Buffers[index] + ch->Filled, data + done, chunk);
+		ch->Filled += chunk;
+		done += chunk;
+		if(ch->Filled == ch->Config.size)
+			HostDmaCommit(ch, ch->Config.size);
+	}
+	return done;
+}
+
+/**
+  * @brief End of a peripheral transfer. Completes a receive override with the bytes received so far,
+  * or commits a partly filled buffer, as the producer socket does at the end of a transfer.
+ **/
+void HostDmaProduceEnd(CyU3PDmaChannel *ch)
+{
+	if(ch->Override && (ch->State != CY_U3P_DMA_PROD_OVERRIDE))
+	{
+		ch->OverrideBuffer.count = (uint16_t) ch->OverrideOffset;
+		HostDmaOverrideDone(ch, CY_U3P_DMA_CB_RECV_CPLT);
+	}
+	else if(!ch->Override && (ch->Filled != 0))
+	{
+		HostDmaCommit(ch, (uint16_t) ch->Filled);
+	}
+}
+
+/**
+  * @brief Number of bytes a peripheral consumer can read from the channel now.
+ **/
+uint32_t HostDmaConsumeAvail(CyU3PDmaChannel *ch)
+{
+	uint32_t bytes = 0, i;
+
+	if(ch->Override)
+		return (ch->State == CY_U3P_DMA_PROD_OVERRIDE) ? ch->OverrideBuffer.count - ch->OverrideOffset : 0;
+	for(i = 0; i < ch->Full; i++)
+		bytes += ch->Counts[(ch->Head + i) % ch->Config.count];
+	return bytes - ch->ConsOffset;
+}
+
+uint32_t HostDmaConsume(CyU3PDmaChannel *ch, uint8_t *data, uint32_t numBytes)
+{
+	uint32_t done = 0, chunk;
+
+	if(ch->Override)
+	{
+		chunk = HostDmaConsumeAvail(ch);
+		if(chunk > numBytes)
+			chunk = numBytes;
+		memcpy(data, ch->OverrideBuffer.buffer + ch->OverrideOffset, chunk);
+		ch->OverrideOffset += chunk;
+		ch->ConsXferCount += chunk;
+		if(ch->OverrideOffset >= ch->OverrideBuffer.count)
+			HostDmaOverrideDone(ch, CY_U3P_DMA_CB_SEND_CPLT);
+		return chunk;
+	}
+
+	while((done < numBytes) && ch->Full)
+	{
+		chunk = ch->Counts[ch->Head] - ch->ConsOffset;
+		if(chunk > numBytes - done)
+			chunk = numBytes - done;
+		memcpy(data + done, ch->Buffers[ch->Head] + ch->ConsOffset, chunk);
+		ch->ConsOffset += chunk;
+		done += chunk;
+		if(ch->ConsOffset == ch->Counts[ch->Head])
+		{
+			ch->ConsXferCount += ch->Counts[ch->Head];
+			ch->ConsOffset = 0;
+			ch->Head = (ch->Head + 1) % ch->Config.count;
+			ch->Full--;
+		}
+	}
+	if(done)
+		HostWake(ch);
+	return done;
+}
+
+static void HostDmaClear(CyU3PDmaChannel *ch)
+{
+	ch->Head = 0;
+	ch->Full = 0;
+	ch->Filled = 0;
+	ch->ConsOffset = 0;
+	ch->ProdXferCount = 0;
+	ch->ConsXferCount = 0;
+	ch->Override = CyFalse;
+	ch->OverrideDone = CyFalse;
+	ch->OverrideOffset = 0;
+}
+
+CyU3PReturnStatus_t CyU3PDmaChannelCreate(CyU3PDmaChannel *handle, CyU3PDmaType_t type, CyU3PDmaChannelConfig_t *config)
+{
+	uint32_t i;
+
+	HOST_SDK_CALL();
+	if((handle == NULL) || (config == NULL))
+		return CY_U3P_ERROR_NULL_POINTER;
+	if(handle->Created)
+		return CY_U3P_ERROR_ALREADY_STARTED;
+	if((config->count > HOST_DMA_MAX_BUFFERS) || ((config->count != 0) && (config->size == 0)))
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	if(((config->prodSckId != CY_U3P_CPU_SOCKET_PROD) && (HostDmaProducer(config->prodSckId) != NULL)) ||
+		((config->consSckId != CY_U3P_CPU_SOCKET_CONS) && (HostDmaConsumer(config->consSckId) != NULL)))
+	{
+		/* A peripheral socket can only belong to one channel */
+		return CY_U3P_ERROR_ALREADY_STARTED;
+	}
+
+	memset(handle, 0, sizeof(CyU3PDmaChannel));
+	handle->Type = type;
+	handle->Config = *config;
+	for(i = 0; i < config->count; i++)
+	{
+		handle->Buffers[i] = CyU3PDmaBufferAlloc(config->size);
+		if(handle->Buffers[i] == NULL)
+			return CY_U3P_ERROR_MEMORY_ERROR;
+	}
+	handle->State = CY_U3P_DMA_CONFIGURED;
+	handle->Created = CyTrue;
+	handle->Next = Channels;
+	Channels = handle;
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDmaChannelDestroy(CyU3PDmaChannel *handle)
+{
+	CyU3PDmaChannel **link;
+	uint32_t i;
+
+	HOST_SDK_CALL();
+	if((handle == NULL) || !handle->Created)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	for(link = &Channels; *link != NULL; link = &(*link)->Next)
+	{
+		if(*link == handle)
+		{
+			*link = handle->Next;
+			break;
+		}
+	}
+	for(i = 0; i < handle->Config.count; i++)
+		CyU3PDmaBufferFree(handle->Buffers[i]);
+	HostWake(handle);
+	memset(handle, 0, sizeof(CyU3PDmaChannel));
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDmaChannelReset(CyU3PDmaChannel *handle)
+{
+	HOST_SDK_CALL();
+	if((handle == NULL) || !handle->Created)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	HostDmaClear(handle);
+	handle->State = CY_U3P_DMA_CONFIGURED;
+	HostWake(handle);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDmaChannelSetXfer(CyU3PDmaChannel *handle, uint32_t count)
+{
+	HOST_SDK_CALL();
+	if((handle == NULL) || !handle->Created)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	if(handle->State == CY_U3P_DMA_ACTIVE)
+		return CY_U3P_ERROR_ALREADY_STARTED;
+	HostDmaClear(handle);
+	handle->XferSize = count;
+	handle->State = CY_U3P_DMA_ACTIVE;
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDmaChannelGetBuffer(CyU3PDmaChannel *handle, CyU3PDmaBuffer_t *buffer_p, uint32_t waitOption)
+{
+	uint64_t deadline;
+	uint32_t index;
+
+	HOST_SDK_CALL();
+	if((handle == NULL) || !handle->Created)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	if(handle->Config.count == 0)
+		return CY_U3P_ERROR_INVALID_SEQUENCE;
+
+	deadline = HostDeadline(waitOption);
+	for(;;)
+	{
+		if(HostIsCpu(handle->Config.prodSckId) && (handle->Full < handle->Config.count))
+		{
+			/* Empty buffer for the CPU to fill */
+			index = (handle->Head + handle->Full) % handle->Config.count;
+			buffer_p->buffer = handle->Buffers[index];
+			buffer_p->count = 0;
+			buffer_p->size = handle->Config.size;
+			buffer_p->status = 0;
+			return CY_U3P_SUCCESS;
+		}
+		if(HostIsCpu(handle->Config.consSckId) && handle->Full)
+		{
+			/* Full buffer for the CPU to read */
+			buffer_p->buffer = handle->Buffers[handle->Head];
+			buffer_p->count = handle->Counts[handle->Head];
+			buffer_p->size = handle->Config.size;
+			buffer_p->status = 0;
+			return CY_U3P_SUCCESS;
+		}
+		if((waitOption == CYU3P_NO_WAIT) || HostInInterrupt())
+			return CY_U3P_ERROR_TIMEOUT;
+		if(!HostWait(handle, deadline))
+			return CY_U3P_ERROR_TIMEOUT;
+		if(!handle->Created)
+			return CY_U3P_ERROR_ABORTED;
+	}
+}
+
+CyU3PReturnStatus_t CyU3PDmaChannelCommitBuffer(CyU3PDmaChannel *handle, uint16_t count, uint16_t bufStatus)
+{
+	HOST_SDK_CALL();
+	if((handle == NULL) || !handle->Created)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	if(!HostIsCpu(handle->Config.prodSckId) || (handle->Full >= handle->Config.count) || (count > handle->Config.size))
+		return CY_U3P_ERROR_INVALID_SEQUENCE;
+	HostDmaCommit(handle, count);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDmaChannelDiscardBuffer(CyU3PDmaChannel *handle)
+{
+	HOST_SDK_CALL();
+	if((handle == NULL) || !handle->Created)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	if(handle->Full == 0)
+		return CY_U3P_ERROR_INVALID_SEQUENCE;
+	handle->ConsXferCount += handle->Counts[handle->Head];
+	handle->Head = (handle->Head + 1) % handle->Config.count;
+	handle->Full--;
+	HostWake(handle);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDmaChannelSetupSendBuffer(CyU3PDmaChannel *handle, CyU3PDmaBuffer_t *buffer_p)
+{
+	HOST_SDK_CALL();
+	if((handle == NULL) || !handle->Created)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	if(handle->Override || (handle->State == CY_U3P_DMA_ACTIVE))
+		return CY_U3P_ERROR_ALREADY_STARTED;
+
+	handle->OverrideBuffer = *buffer_p;
+	handle->OverrideOffset = 0;
+	handle->OverrideDone = CyFalse;
+	handle->Override = CyTrue;
+	handle->State = CY_U3P_DMA_PROD_OVERRIDE;
+
+	if(HostIsUsbIn(handle->Config.consSckId))
+	{
+		/* The simulated PC always reads the endpoint */
+		HostUsbInAppend(HostUsbInEp(handle->Config.consSckId), buffer_p->buffer, buffer_p->count);
+		handle->ConsXferCount += buffer_p->count;
+		HostDmaOverrideDone(handle, CY_U3P_DMA_CB_SEND_CPLT);
+	}
+	else
+	{
+		HostRegsUpdate();
+	}
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDmaChannelSetupRecvBuffer(CyU3PDmaChannel *handle, CyU3PDmaBuffer_t *buffer_p)
+{
+	HOST_SDK_CALL();
+	if((handle == NULL) || !handle->Created)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	if(handle->Override || (handle->State == CY_U3P_DMA_ACTIVE))
+		return CY_U3P_ERROR_ALREADY_STARTED;
+
+	handle->OverrideBuffer = *buffer_p;
+	handle->OverrideBuffer.count = 0;
+	handle->OverrideOffset = 0;
+	handle->OverrideDone = CyFalse;
+	handle->Override = CyTrue;
+	handle->State = CY_U3P_DMA_CONS_OVERRIDE;
+	HostRegsUpdate();
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDmaChannelWaitForCompletion(CyU3PDmaChannel *handle, uint32_t waitOption)
+{
+	uint64_t deadline = HostDeadline(waitOption);
+
+	HOST_SDK_CALL();
+	if((handle == NULL) || !handle->Created)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	while(handle->Override)
+	{
+		if((waitOption == CYU3P_NO_WAIT) || HostInInterrupt())
+			return CY_U3P_ERROR_TIMEOUT;
+		if(!HostWait(handle, deadline))
+			return CY_U3P_ERROR_TIMEOUT;
+		if(!handle->Created)
+			return CY_U3P_ERROR_ABORTED;
+	}
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDmaChannelSetWrapUp(CyU3PDmaChannel *handle)
+{
+	HOST_SDK_CALL();
+	if((handle == NULL) || !handle->Created)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	if(!HostIsCpu(handle->Config.prodSckId) && !handle->Override && handle->Filled)
+		HostDmaCommit(handle, (uint16_t) handle->Filled);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PDmaChannelGetStatus(CyU3PDmaChannel *handle, CyU3PDmaState_t *state, uint32_t *prodXferCount, uint32_t *consXferCount)
+{
+	HOST_SDK_CALL();
+	if((handle == NULL) || !handle->Created)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	*state = handle->State;
+	*prodXferCount = handle->ProdXferCount;
+	*consXferCount = handle->ConsXferCount;
+	return CY_U3P_SUCCESS;
+}
+
+/* ---------------------------------------- USB ---------------------------------------- */
+
+CyU3PReturnStatus_t CyU3PUsbStart(void)
+{
+	HOST_SDK_CALL();
+	return CY_U3P_SUCCESS;
+}
+
+void CyU3PUsbRegisterSetupCallback(CyU3PUSBSetupCb_t callback, CyBool_t fastEnum)
+{
+	UsbSetupCb = callback;
+}
+
+void CyU3PUsbRegisterEventCallback(CyU3PUSBEventCb_t callback)
+{
+	UsbEventCb = callback;
+}
+
+void CyU3PUsbRegisterLPMRequestCallback(CyU3PUsbLPMReqCb_t cb)
+{
+}
+
+CyU3PReturnStatus_t CyU3PUsbSetDesc(CyU3PUSBSetDescType_t desc_type, uint8_t desc_index, uint8_t *desc)
+{
+	return (desc == NULL) ? CY_U3P_ERROR_NULL_POINTER : CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PConnectState(CyBool_t connect, CyBool_t ssEnable)
+{
+	HOST_SDK_CALL();
+	UsbConnected = connect;
+	HostWake(&UsbConnected);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PUSBSpeed_t CyU3PUsbGetSpeed(void)
+{
+	return UsbSpeed;
+}
+
+CyU3PReturnStatus_t CyU3PUsbLPMDisable(void)
+{
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PSetEpConfig(uint8_t ep, CyU3PEpConfig_t *epinfo)
+{
+	HOST_SDK_CALL();
+	if(epinfo == NULL)
+		return CY_U3P_ERROR_NULL_POINTER;
+	/* The endpoint has no hardware to set up, so the harness only keeps the configuration */
+	UsbEpConfig[((ep & 0x80) >> 3) | (ep & 0xF)] = *epinfo;
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PUsbFlushEp(uint8_t ep)
+{
+	/* Data the simulated PC has not read stays in the DMA channel, so the endpoint has nothing to flush */
+	HOST_SDK_CALL();
+	return CY_U3P_SUCCESS;
+}
+
+static void HostEp0Complete(void)
+{
+	HostEp0.Done = CyTrue;
+	HostWake(&HostEp0);
+}
+
+CyU3PReturnStatus_t CyU3PUsbStall(uint8_t ep, CyBool_t stall, CyBool_t toggle)
+{
+	HOST_SDK_CALL();
+	if((ep == 0) && stall && HostEp0.Active && !HostEp0.Done)
+	{
+		HostEp0.Stalled = CyTrue;
+		HostEp0Complete();
+	}
+	return CY_U3P_SUCCESS;
+}
+
+void CyU3PUsbAckSetup(void)
+{
+	HOST_SDK_CALL();
+	if(HostEp0.Active && !HostEp0.Done)
+		HostEp0Complete();
+}
+
+CyU3PReturnStatus_t CyU3PUsbGetEP0Data(uint16_t count, uint8_t *buffer, uint16_t *readCount)
+{
+	uint16_t bytes;
+
+	HOST_SDK_CALL();
+	if(!HostEp0.Active || HostEp0.Done || (HostEp0.SetupDat0 & 0x80))
+		return CY_U3P_ERROR_TIMEOUT;
+
+	bytes = (count < HostEp0.OutLength) ? count : HostEp0.OutLength;
+	if(bytes)
+		memcpy(buffer, HostEp0.OutData, bytes);
+	if(readCount != NULL)
+		*readCount = bytes;
+	/* Time for the data stage at high speed (64 byte packets, about 1us each) */
+	HostSpend(1000ull * ((bytes + 63) / 64 + 1));
+	HostEp0Complete();
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PUsbSendEP0Data(uint16_t count, uint8_t *buffer)
+{
+	HOST_SDK_CALL();
+	if(!HostEp0.Active || HostEp0.Done || !(HostEp0.SetupDat0 & 0x80))
+		return CY_U3P_ERROR_TIMEOUT;
+
+	if(count > sizeof(HostEp0.InData))
+		count = sizeof(HostEp0.InData);
+	memcpy(HostEp0.InData, buffer, count);
+	HostEp0.InLength = count;
+	HostSpend(1000ull * ((count + 63) / 64 + 1));
+	HostEp0Complete();
+	return CY_U3P_SUCCESS;
+}
+
+CyBool_t HostUsbConnected(void)
+{
+	return UsbConnected;
+}
+
+/**
+  * @brief Enumerates the device at a speed, then sends the SET_CONFIGURATION event. Called from the PC thread.
+ **/
+void HostUsbConfigure(CyU3PUSBSpeed_t speed)
+{
+	while(!UsbConnected)
+	{
+		if(!HostWait(&UsbConnected, HostDeadline(HOST_XFER_TIMEOUT_MS)))
+			HostFatal("the firmware never connected to USB");
+	}
+	UsbSpeed = speed;
+	HostSpend(1000000);
+	if(UsbEventCb != NULL)
+	{
+		UsbEventCb(CY_U3P_USB_EVENT_RESET, 0);
+		UsbEventCb(CY_U3P_USB_EVENT_SETCONF, 0);
+	}
+}
+
+/**
+  * @brief Fails a SuperSpeed link, then enumerates the device at high speed, like the USB driver fallback.
+  * Called from the PC thread.
+ **/
+void HostUsbLinkFail(void)
+{
+	if(UsbEventCb != NULL)
+		UsbEventCb(CY_U3P_USB_EVENT_USB3_LNKFAIL, 0);
+	HostUsbConfigure(CY_U3P_HIGH_SPEED);
+}
+
+/**
+  * @brief Gets the last configuration the firmware set for an endpoint (CyU3PSetEpConfig).
+ **/
+const CyU3PEpConfig_t *HostUsbEpConfig(uint8_t ep)
+{
+	return &UsbEpConfig[((ep & 0x80) >> 3) | (ep & 0xF)];
+}
+
+/**
+  * @brief Runs a control transfer, and waits for the firmware to finish it. Called from the PC thread.
+  *
+  * @return CyTrue if the request completed, CyFalse if it stalled or timed out.
+ **/
+CyBool_t HostUsbSetup(uint32_t setupDat0, uint32_t setupDat1)
+{
+	uint64_t deadline = HostDeadline(HOST_XFER_TIMEOUT_MS);
+	uint16_t wLength = (uint16_t) (setupDat1 >> 16);
+	CyBool_t handled;
+
+	HostEp0.Active = CyTrue;
+	HostEp0.Done = CyFalse;
+	HostEp0.Stalled = CyFalse;
+	HostEp0.SetupDat0 = setupDat0;
+	HostEp0.SetupDat1 = setupDat1;
+	HostEp0.InLength = 0;
+
+	/* The setup packet goes out at the start of the next microframe */
+	HostWait(NULL, ((HostSimNs / HOST_USB_MICROFRAME_NS) + 1) * HOST_USB_MICROFRAME_NS);
+	handled = (UsbSetupCb != NULL) ? UsbSetupCb(setupDat0, setupDat1) : CyFalse;
+	if(!handled)
+	{
+		HostEp0.Stalled = CyTrue;
+		HostEp0.Done = CyTrue;
+	}
+	else if((wLength == 0) && !HostEp0.Done)
+	{
+		/* The driver completes the status stage of a handled request with no data stage */
+		HostEp0.Done = CyTrue;
+	}
+
+	while(!HostEp0.Done)
+	{
+		if(!HostWait(&HostEp0, deadline))
+		{
+			fprintf(stderr, "host: control request 0x%02x was not completed by the firmware\n", (setupDat0 >> 8) & 0xFF);
+			HostEp0.Stalled = CyTrue;
+			break;
+		}
+	}
+	HostEp0.Active = CyFalse;
+	return (CyBool_t) !HostEp0.Stalled;
+}
+
+/**
+  * @brief Sends data on a bulk OUT endpoint, in USB packets. Waits while the firmware has no buffer for it.
+ **/
+void HostUsbBulkOut(uint8_t ep, const uint8_t *data, uint32_t numBytes)
+{
+	CyU3PDmaChannel *ch;
+	uint32_t packet, done = 0, chunk, space;
+	uint64_t deadline = HostDeadline(HOST_XFER_TIMEOUT_MS);
+	uint16_t socket = CY_U3P_UIB_SOCKET_PROD_0 + (ep & 0xF);
+
+	packet = (UsbSpeed == CY_U3P_SUPER_SPEED) ? 1024 : ((UsbSpeed == CY_U3P_HIGH_SPEED) ? 512 : 64);
+	while(done < numBytes)
+	{
+		ch = HostDmaProducer(socket);
+		space = (ch != NULL) ? HostDmaProduceSpace(ch) : 0;
+		if(space == 0)
+		{
+			/* NAK until the firmware has a buffer. Wake on channel activity, and poll for a new channel */
+			if(HostSimNs >= deadline)
+				HostFatal("bulk OUT endpoint 0x%02x was not read by the firmware", ep);
+			HostWait(ch, HostSimNs + 1000000);
+			continue;
+		}
+		chunk = numBytes - done;
+		if(chunk > packet)
+			chunk = packet;
+		if(chunk > space)
+			chunk = space;
+		HostSpend(chunk * 2);
+		HostDmaProduce(ch, data + done, chunk);
+		done += chunk;
+		/* A short packet ends the transfer, and commits a partly filled buffer */
+		if((chunk < packet) && ch->Override)
+			HostDmaProduceEnd(ch);
+		else if((chunk < packet) && ch->Filled)
+			HostDmaCommit(ch, (uint16_t) ch->Filled);
+		HostRegsUpdate();
+		HostSafePoint();
+	}
+}
+
+/* ---------------------------------------- GPIO ---------------------------------------- */
+
+CyU3PReturnStatus_t CyU3PGpioInit(CyU3PGpioClock_t *clk_p, CyU3PGpioIntrCb_t irq)
+{
+	uint32_t sysClk = HOST_SYS_CLK_HZ, fastClk;
+
+	HOST_SDK_CALL();
+	if((clk_p == NULL) || (clk_p->fastClkDiv < 2) || (clk_p->slowClkDiv == 0))
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+
+	switch(clk_p->clkSrc)
+	{
+	case CY_U3P_SYS_CLK_BY_16:
+		sysClk /= 16;
+		break;
+	case CY_U3P_SYS_CLK_BY_4:
+		sysClk /= 4;
+		break;
+	case CY_U3P_SYS_CLK_BY_2:
+		sysClk /= 2;
+		break;
+	default:
+		break;
+	}
+	fastClk = sysClk / clk_p->fastClkDiv;
+	HostGpioSetCallback(irq, fastClk, fastClk / clk_p->slowClkDiv);
+	if(irq != NULL)
+		CyU3PVicEnableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PGpioDeInit(void)
+{
+	HOST_SDK_CALL();
+	CyU3PVicDisableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+	HostGpioSetCallback(NULL, 0, 0);
+	return CY_U3P_SUCCESS;
+}
+
+static uint32_t HostGpioDriveBits(CyBool_t outValue, CyBool_t driveLowEn, CyBool_t driveHighEn, CyBool_t inputEn)
+{
+	uint32_t status = CY_U3P_LPP_GPIO_ENABLE;
+
+	if(outValue)
+		status |= CY_U3P_LPP_GPIO_OUT_VALUE;
+	if(driveLowEn)
+		status |= CY_U3P_LPP_GPIO_DRIVE_LO_EN;
+	if(driveHighEn)
+		status |= CY_U3P_LPP_GPIO_DRIVE_HI_EN;
+	if(inputEn)
+		status |= CY_U3P_LPP_GPIO_INPUT_EN;
+	return status;
+}
+
+CyU3PReturnStatus_t CyU3PGpioSetSimpleConfig(uint8_t gpioId, CyU3PGpioSimpleConfig_t *cfg_p)
+{
+	uint32_t status;
+
+	HOST_SDK_CALL();
+	if((gpioId >= HOST_NUM_GPIO) || (cfg_p == NULL))
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	status = HostGpioDriveBits(cfg_p->outValue, cfg_p->driveLowEn, cfg_p->driveHighEn, cfg_p->inputEn);
+	status |= ((uint32_t) cfg_p->intrMode << CY_U3P_LPP_GPIO_INTRMODE_POS) & CY_U3P_LPP_GPIO_INTRMODE_MASK;
+	HostGpioSetSimple(gpioId, status);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PGpioSetComplexConfig(uint8_t gpioId, CyU3PGpioComplexConfig_t *cfg_p)
+{
+	uint32_t status;
+
+	HOST_SDK_CALL();
+	if((gpioId >= HOST_NUM_GPIO) || (cfg_p == NULL))
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	status = HostGpioDriveBits(cfg_p->outValue, cfg_p->driveLowEn, cfg_p->driveHighEn, cfg_p->inputEn);
+	status |= ((uint32_t) cfg_p->pinMode << CY_U3P_LPP_GPIO_MODE_POS) & CY_U3P_LPP_GPIO_MODE_MASK;
+	status |= ((uint32_t) cfg_p->intrMode << CY_U3P_LPP_GPIO_INTRMODE_POS) & CY_U3P_LPP_GPIO_INTRMODE_MASK;
+	status |= ((uint32_t) cfg_p->timerMode << CY_U3P_LPP_GPIO_TIMER_MODE_POS) & CY_U3P_LPP_GPIO_TIMER_MODE_MASK;
+	HostGpioSetComplex(gpioId, status, cfg_p->timer, cfg_p->period, cfg_p->threshold);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PGpioDisable(uint8_t gpioId)
+{
+	HOST_SDK_CALL();
+	if(gpioId >= HOST_NUM_GPIO)
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	HostGpioDisable(gpioId);
+	return CY_U3P_SUCCESS;
+}
+
+static uvint32_t *HostGpioStatusReg(uint8_t gpioId)
+{
+	if(HostGpioIsComplex(gpioId))
+		return &GPIO->lpp_gpio_pin[gpioId % 8].status;
+	return &GPIO->lpp_gpio_simple[gpioId];
+}
+
+CyU3PReturnStatus_t CyU3PGpioSimpleGetValue(uint8_t gpioId, CyBool_t *value_p)
+{
+	HOST_SDK_CALL();
+	if((gpioId >= HOST_NUM_GPIO) || HostGpioIsComplex(gpioId))
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	if(!(GPIO->lpp_gpio_simple[gpioId] & CY_U3P_LPP_GPIO_ENABLE))
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	*value_p = (CyBool_t) ((GPIO->lpp_gpio_simple[gpioId] & CY_U3P_LPP_GPIO_IN_VALUE) != 0);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PGpioGetValue(uint8_t gpioId, CyBool_t *value_p)
+{
+	HOST_SDK_CALL();
+	if(gpioId >= HOST_NUM_GPIO)
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	*value_p = (CyBool_t) ((*HostGpioStatusReg(gpioId) & CY_U3P_LPP_GPIO_IN_VALUE) != 0);
+	return CY_U3P_SUCCESS;
+}
+
+static void HostGpioWriteOut(uvint32_t *reg, CyBool_t value)
+{
+	uint32_t status = *reg & ~(CY_U3P_LPP_GPIO_INTR | CY_U3P_LPP_GPIO_OUT_VALUE);
+
+	if(value)
+		status |= CY_U3P_LPP_GPIO_OUT_VALUE;
+	*reg = status;
+}
+
+CyU3PReturnStatus_t CyU3PGpioSimpleSetValue(uint8_t gpioId, CyBool_t value)
+{
+	HOST_SDK_CALL();
+	if((gpioId >= HOST_NUM_GPIO) || HostGpioIsComplex(gpioId))
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	if(!(GPIO->lpp_gpio_simple[gpioId] & CY_U3P_LPP_GPIO_ENABLE))
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	HostGpioWriteOut(&GPIO->lpp_gpio_simple[gpioId], value);
+	HostRegsUpdate();
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PGpioSetValue(uint8_t gpioId, CyBool_t value)
+{
+	HOST_SDK_CALL();
+	if(gpioId >= HOST_NUM_GPIO)
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	HostGpioWriteOut(HostGpioStatusReg(gpioId), value);
+	HostRegsUpdate();
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PGpioComplexSampleNow(uint8_t gpioId, uint32_t *value_p)
+{
+	uint32_t status;
+
+	HOST_SDK_CALL();
+	if(!HostGpioIsComplex(gpioId))
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	status = GPIO->lpp_gpio_pin[gpioId % 8].status & ~(CY_U3P_LPP_GPIO_INTR | CY_U3P_LPP_GPIO_MODE_MASK);
+	GPIO->lpp_gpio_pin[gpioId % 8].status = status | (CY_U3P_GPIO_MODE_SAMPLE_NOW << CY_U3P_LPP_GPIO_MODE_POS);
+	while(GPIO->lpp_gpio_pin[gpioId % 8].status & CY_U3P_LPP_GPIO_MODE_MASK);
+	*value_p = GPIO->lpp_gpio_pin[gpioId % 8].threshold;
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PGpioComplexMeasureOnce(uint8_t gpioId, CyU3PGpioComplexMode_t pinMode)
+{
+	HOST_SDK_CALL();
+	if(!HostGpioIsComplex(gpioId))
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	if((pinMode != CY_U3P_GPIO_MODE_MEASURE_LOW_ONCE) && (pinMode != CY_U3P_GPIO_MODE_MEASURE_HIGH_ONCE))
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	HostGpioMeasureStart(gpioId, (CyBool_t) (pinMode == CY_U3P_GPIO_MODE_MEASURE_HIGH_ONCE));
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PGpioComplexWaitForCompletion(uint8_t gpioId, uint32_t *threshold_p, CyBool_t isWait)
+{
+	static uint8_t measureWait;
+	uint64_t doneNs, deadline = HostDeadline(HOST_XFER_TIMEOUT_MS);
+
+	HOST_SDK_CALL();
+	if(!HostGpioIsComplex(gpioId))
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	while(!HostGpioMeasureResult(gpioId, threshold_p, &doneNs))
+	{
+		if(!isWait || HostInInterrupt())
+			return CY_U3P_ERROR_TIMEOUT;
+		if(HostSimNs >= deadline)
+			return CY_U3P_ERROR_TIMEOUT;
+		/* Sleep until the pulse ends (known from the DUT edges), or until the timeout */
+		if((doneNs == HOST_NS_NEVER) || (doneNs > deadline))
+			doneNs = deadline;
+		HostWait(&measureWait, doneNs);
+	}
+	return CY_U3P_SUCCESS;
+}
+
+CyBool_t CyU3PIsGpioValid(uint8_t gpioId)
+{
+	return (CyBool_t) (gpioId < HOST_NUM_GPIO);
+}
+
+/* ---------------------------------------- SPI ---------------------------------------- */
+
+static CyBool_t SpiInitDone;
+
+CyU3PReturnStatus_t CyU3PSpiInit(void)
+{
+	HOST_SDK_CALL();
+	if(SpiInitDone)
+		return CY_U3P_ERROR_ALREADY_STARTED;
+	SpiInitDone = CyTrue;
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PSpiDeInit(void)
+{
+	HOST_SDK_CALL();
+	if(!SpiInitDone)
+		return CY_U3P_ERROR_NOT_STARTED;
+	HostSpiDmaAbort();
+	SpiInitDone = CyFalse;
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PSpiSetConfig(CyU3PSpiConfig_t *config, CyU3PSpiIntrCb_t cb)
+{
+	uint32_t value, ssn;
+
+	HOST_SDK_CALL();
+	if(!SpiInitDone)
+		return CY_U3P_ERROR_NOT_STARTED;
+	if((config == NULL) || (config->clock < 10000) || (config->clock > 33000000) || (config->wordLen < 4) || (config->wordLen > 32))
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+
+	switch(config->ssnCtrl)
+	{
+	case CY_U3P_SPI_SSN_CTRL_HW_END_OF_XFER:
+		ssn = 0;
+		break;
+	case CY_U3P_SPI_SSN_CTRL_HW_EACH_WORD:
+		ssn = 1;
+		break;
+	case CY_U3P_SPI_SSN_CTRL_HW_CPHA_BASED:
+		ssn = 2;
+		break;
+	default:
+		ssn = 3;
+		break;
+	}
+
+	value = (ssn << CY_U3P_LPP_SPI_SSNCTRL_POS) & CY_U3P_LPP_SPI_SSNCTRL_MASK;
+	value |= ((uint32_t) config->leadTime << CY_U3P_LPP_SPI_LEAD_POS) & CY_U3P_LPP_SPI_LEAD_MASK;
+	value |= ((uint32_t) config->lagTime << CY_U3P_LPP_SPI_LAG_POS) & CY_U3P_LPP_SPI_LAG_MASK;
+	value |= ((uint32_t) config->wordLen << CY_U3P_LPP_SPI_WL_POS) & CY_U3P_LPP_SPI_WL_MASK;
+	if(config->isLsbFirst)
+		value |= CY_U3P_LPP_SPI_ENDIAN;
+	if(config->cpol)
+		value |= CY_U3P_LPP_SPI_CPOL;
+	if(config->cpha)
+		value |= CY_U3P_LPP_SPI_CPHA;
+	if(config->ssnPol)
+		value |= CY_U3P_LPP_SPI_SSPOL;
+	HostSpiSetConfig(value, config->clock);
+	return CY_U3P_SUCCESS;
+}
+
+/**
+  * @brief Blocks the caller for a register mode transfer, as the SDK does.
+ **/
+static void HostSpiBusyUntil(uint64_t endNs)
+{
+	if(endNs > HostSimNs)
+		HostSpend(endNs - HostSimNs);
+	HostSafePoint();
+}
+
+CyU3PReturnStatus_t CyU3PSpiTransmitWords(uint8_t *data, uint32_t byteCount)
+{
+	HOST_SDK_CALL();
+	if(!SpiInitDone)
+		return CY_U3P_ERROR_NOT_STARTED;
+	if(data == NULL)
+		return CY_U3P_ERROR_NULL_POINTER;
+	HostSpiBusyUntil(HostSpiRegisterTransfer(data, NULL, byteCount));
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PSpiReceiveWords(uint8_t *data, uint32_t byteCount)
+{
+	HOST_SDK_CALL();
+	if(!SpiInitDone)
+		return CY_U3P_ERROR_NOT_STARTED;
+	if(data == NULL)
+		return CY_U3P_ERROR_NULL_POINTER;
+	HostSpiBusyUntil(HostSpiRegisterTransfer(NULL, data, byteCount));
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PSpiTransferWords(uint8_t *txBuf, uint32_t txByteCount, uint8_t *rxBuf, uint32_t rxByteCount)
+{
+	uint8_t *tx, *rx;
+	uint32_t count = (txByteCount > rxByteCount) ? txByteCount : rxByteCount;
+
+	HOST_SDK_CALL();
+	if(!SpiInitDone)
+		return CY_U3P_ERROR_NOT_STARTED;
+	if(((txBuf == NULL) && txByteCount) || ((rxBuf == NULL) && rxByteCount))
+		return CY_U3P_ERROR_NULL_POINTER;
+
+	tx = calloc(1, count + 4);
+	rx = calloc(1, count + 4);
+	if((tx == NULL) || (rx == NULL))
+		HostFatal("out of memory");
+	if(txByteCount)
+		memcpy(tx, txBuf, txByteCount);
+	HostSpiBusyUntil(HostSpiRegisterTransfer(tx, rx, count));
+	if(rxByteCount)
+		memcpy(rxBuf, rx, rxByteCount);
+	free(tx);
+	free(rx);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PSpiSetBlockXfer(uint32_t txSize, uint32_t rxSize)
+{
+	uint32_t enables = 0;
+
+	HOST_SDK_CALL();
+	if(!SpiInitDone)
+		return CY_U3P_ERROR_NOT_STARTED;
+	if(txSize)
+		enables |= CY_U3P_LPP_SPI_TX_ENABLE;
+	if(rxSize)
+		enables |= CY_U3P_LPP_SPI_RX_ENABLE;
+	SPI->lpp_spi_config |= CY_U3P_LPP_SPI_DMA_MODE;
+	SPI->lpp_spi_tx_byte_count = txSize;
+	SPI->lpp_spi_rx_byte_count = rxSize;
+	SPI->lpp_spi_config |= enables;
+	SPI->lpp_spi_config |= CY_U3P_LPP_SPI_ENABLE;
+	HostRegsUpdate();
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PSpiWaitForBlockXfer(CyBool_t isRead)
+{
+	HOST_SDK_CALL();
+	if(!SpiInitDone)
+		return CY_U3P_ERROR_NOT_STARTED;
+	return HostSpiDmaWait(HOST_XFER_TIMEOUT_MS);
+}
+
+CyU3PReturnStatus_t CyU3PSpiDisableBlockXfer(CyBool_t rxDisable, CyBool_t txDisable)
+{
+	HOST_SDK_CALL();
+	if(!SpiInitDone)
+		return CY_U3P_ERROR_NOT_STARTED;
+	HostSpiDmaAbort();
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PSpiResetFifo(CyBool_t isTx, CyBool_t isRx)
+{
+	HOST_SDK_CALL();
+	if(!SpiInitDone)
+		return CY_U3P_ERROR_NOT_STARTED;
+	return CY_U3P_SUCCESS;
+}
+
+/* ---------------------------------------- I2C ---------------------------------------- */
+
+void HostI2cEepromLoad(uint32_t address, const uint8_t *data, uint32_t numBytes)
+{
+	if(!EepromInit)
+	{
+		memset(Eeprom, 0xFF, sizeof(Eeprom));
+		EepromInit = CyTrue;
+	}
+	if(address + numBytes > HOST_EEPROM_SIZE)
+		HostFatal("EEPROM image does not fit");
+	memcpy(Eeprom + address, data, numBytes);
+}
+
+/**
+  * @brief Decodes an I2C preamble for the EEPROM. Sets the EEPROM address pointer.
+  *
+  * @return CyFalse if the device does not acknowledge (not an EEPROM address).
+ **/
+static CyBool_t HostI2cPreamble(CyU3PI2cPreamble_t *preamble)
+{
+	uint8_t device = preamble->buffer[0];
+
+	if((device & 0xF0) != 0xA0)
+		return CyFalse;
+	if(preamble->length >= 3)
+	{
+		I2c.EepromPtr = ((uint32_t) ((device >> 1) & 0x3) << 16) | (preamble->buffer[1] << 8) | preamble->buffer[2];
+	}
+	return CyTrue;
+}
+
+static uint64_t HostI2cTimeNs(uint32_t numBytes)
+{
+	uint32_t rate = I2c.BitRate ? I2c.BitRate : 100000;
+	return ((uint64_t) numBytes * 9 + 2) * 1000000000ull / rate;
+}
+
+static void HostEepromRead(uint8_t *data, uint32_t numBytes)
+{
+	uint32_t i;
+
+	for(i = 0; i < numBytes; i++)
+	{
+		data[i] = Eeprom[I2c.EepromPtr];
+		I2c.EepromPtr = (I2c.EepromPtr + 1) % HOST_EEPROM_SIZE;
+	}
+}
+
+static void HostEepromWrite(const uint8_t *data, uint32_t numBytes)
+{
+	uint32_t i;
+
+	for(i = 0; i < numBytes; i++)
+	{
+		Eeprom[I2c.EepromPtr] = data[i];
+		I2c.EepromPtr = (I2c.EepromPtr + 1) % HOST_EEPROM_SIZE;
+	}
+}
+
+CyU3PReturnStatus_t CyU3PI2cInit(void)
+{
+	HOST_SDK_CALL();
+	if(I2c.Configured)
+		return CY_U3P_ERROR_ALREADY_STARTED;
+	I2c.Configured = CyTrue;
+	I2c.Active = CyFalse;
+	I2c.Done = CyFalse;
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PI2cDeInit(void)
+{
+	HOST_SDK_CALL();
+	if(!I2c.Configured)
+		return CY_U3P_ERROR_NOT_STARTED;
+	I2c.Configured = CyFalse;
+	I2c.Active = CyFalse;
+	HostWake(&I2c);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PI2cSetConfig(CyU3PI2cConfig_t *config, CyU3PI2cIntrCb_t cb)
+{
+	HOST_SDK_CALL();
+	if(!I2c.Configured)
+		return CY_U3P_ERROR_NOT_STARTED;
+	if((config == NULL) || (config->bitRate < 100000) || (config->bitRate > 1000000))
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	I2c.BitRate = config->bitRate;
+	I2c.IsDma = config->isDma;
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PI2cSetTimeout(uint32_t rxTimeout, uint32_t txTimeout, uint32_t preambleTimeout)
+{
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PI2cTransmitBytes(CyU3PI2cPreamble_t *preamble, uint8_t *data, uint32_t byteCount, uint32_t retryCount)
+{
+	HOST_SDK_CALL();
+	if(!I2c.Configured || I2c.IsDma)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	HostSpend(HostI2cTimeNs(preamble->length + byteCount));
+	HostSafePoint();
+	if(!HostI2cPreamble(preamble))
+		return CY_U3P_ERROR_FAILURE;
+	HostEepromWrite(data, byteCount);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PI2cReceiveBytes(CyU3PI2cPreamble_t *preamble, uint8_t *data, uint32_t byteCount, uint32_t retryCount)
+{
+	HOST_SDK_CALL();
+	if(!I2c.Configured || I2c.IsDma)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	HostSpend(HostI2cTimeNs(preamble->length + byteCount));
+	HostSafePoint();
+	if(!HostI2cPreamble(preamble))
+		return CY_U3P_ERROR_FAILURE;
+	HostEepromRead(data, byteCount);
+	return CY_U3P_SUCCESS;
+}
+
+CyU3PReturnStatus_t CyU3PI2cSendCommand(CyU3PI2cPreamble_t *preamble, uint32_t byteCount, CyBool_t isRead)
+{
+	HOST_SDK_CALL();
+	if(!I2c.Configured || !I2c.IsDma)
+		return CY_U3P_ERROR_NOT_CONFIGURED;
+	if(I2c.Active)
+		return CY_U3P_ERROR_ALREADY_STARTED;
+	I2c.Preamble = *preamble;
+	I2c.Count = byteCount;
+	I2c.IsRead = isRead;
+	I2c.Active = CyTrue;
+	I2c.Done = CyFalse;
+	I2c.DmaWait = CyFalse;
+	I2c.Status = CY_U3P_SUCCESS;
+	I2c.DoneNs = HostSimNs + HostI2cTimeNs(preamble->length + byteCount);
+	return CY_U3P_SUCCESS;
+}
+
+/**
+  * @brief Finishes a DMA mode I2C command once its bus time has passed, and the DMA channel can take (or supply)
+  * the data. Called from HostRegsUpdate.
+ **/
+void HostI2cUpdate(void)
+{
+	static uint8_t data[0x10000];
+	CyU3PDmaChannel *ch;
+	uint32_t count = I2c.Count;
+
+	if(!I2c.Active || (HostSimNs < I2c.DoneNs))
+		return;
+	I2c.DmaWait = CyTrue;
+	if(count > sizeof(data))
+		count = sizeof(data);
+
+	if(!HostI2cPreamble(&I2c.Preamble))
+	{
+		I2c.Status = CY_U3P_ERROR_FAILURE;
+	}
+	else if(I2c.IsRead)
+	{
+		ch = HostDmaProducer(CY_U3P_LPP_SOCKET_I2C_PROD);
+		if((ch == NULL) || (HostDmaProduceSpace(ch) < count))
+			return;
+		HostEepromRead(data, count);
+		HostDmaProduce(ch, data, count);
+		HostDmaProduceEnd(ch);
+	}
+	else
+	{
+		ch = HostDmaConsumer(CY_U3P_LPP_SOCKET_I2C_CONS);
+		if((ch == NULL) || (HostDmaConsumeAvail(ch) < count))
+			return;
+		HostDmaConsume(ch, data, count);
+		HostEepromWrite(data, count);
+	}
+	I2c.Active = CyFalse;
+	I2c.Done = CyTrue;
+	I2c.DmaWait = CyFalse;
+	HostWake(&I2c);
+}
+
+/**
+  * @brief Time at which the active command finishes. A command whose bus time passed between register updates
+  * is due now, unless it is waiting for DMA buffer space.
+ **/
+uint64_t HostI2cNextEventNs(void)
+{
+	if(!I2c.Active || I2c.DmaWait)
+		return HOST_NS_NEVER;
+	return I2c.DoneNs;
+}
+
+CyU3PReturnStatus_t CyU3PI2cWaitForBlockXfer(CyBool_t isRead)
+{
+	uint64_t deadline = HostDeadline(HOST_XFER_TIMEOUT_MS);
+
+	HOST_SDK_CALL();
+	if(!I2c.Configured)
+		return CY_U3P_ERROR_NOT_STARTED;
+	while(I2c.Active)
+	{
+		if(!HostWait(&I2c, deadline))
+			return CY_U3P_ERROR_TIMEOUT;
+	}
+	return I2c.Status;
+}
@@ -0,0 +1,26 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyfxversion.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK version header.
+ **/
+
+#ifndef _INCLUDED_CYFXVERSION_H_
+#define _INCLUDED_CYFXVERSION_H_
+
+#define CYFX_VERSION_MAJOR						(1)
+#define CYFX_VERSION_MINOR						(3)
+#define CYFX_VERSION_PATCH						(4)
+#define CYFX_VERSION_BUILD						(0)
+
+#endif
@@ -0,0 +1,161 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3dma.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK DMA channel services.
+ **/
+
+#ifndef _INCLUDED_CYU3DMA_H_
+#define _INCLUDED_CYU3DMA_H_
+
+#include "cyu3types.h"
+
+/** DMA socket id. The upper byte is the IP block, the lower byte the socket number */
+typedef uint16_t CyU3PDmaSocketId_t;
+
+#define CY_U3P_LPP_SOCKET_I2S_LEFT				(0x0100)
+#define CY_U3P_LPP_SOCKET_I2S_RIGHT				(0x0101)
+#define CY_U3P_LPP_SOCKET_I2C_CONS				(0x0102)
+#define CY_U3P_LPP_SOCKET_UART_CONS				(0x0103)
+#define CY_U3P_LPP_SOCKET_SPI_CONS				(0x0104)
+#define CY_U3P_LPP_SOCKET_I2C_PROD				(0x0105)
+#define CY_U3P_LPP_SOCKET_UART_PROD				(0x0106)
+#define CY_U3P_LPP_SOCKET_SPI_PROD				(0x0107)
+#define CY_U3P_UIB_SOCKET_CONS_0				(0x0300)
+#define CY_U3P_UIB_SOCKET_CONS_1				(0x0301)
+#define CY_U3P_UIB_SOCKET_CONS_2				(0x0302)
+#define CY_U3P_UIB_SOCKET_PROD_0				(0x0400)
+#define CY_U3P_UIB_SOCKET_PROD_1				(0x0401)
+#define CY_U3P_UIB_SOCKET_PROD_2				(0x0402)
+#define CY_U3P_CPU_SOCKET_CONS					(0x3F00)
+#define CY_U3P_CPU_SOCKET_PROD					(0x3F00)
+
+/** DMA channel types */
+typedef enum CyU3PDmaType_t
+{
+	CY_U3P_DMA_TYPE_AUTO = 0,
+	CY_U3P_DMA_TYPE_AUTO_SIGNAL,
+	CY_U3P_DMA_TYPE_MANUAL,
+	CY_U3P_DMA_TYPE_MANUAL_IN,
+	CY_U3P_DMA_TYPE_MANUAL_OUT
+}CyU3PDmaType_t;
+
+/** DMA transfer modes */
+typedef enum CyU3PDmaMode_t
+{
+	CY_U3P_DMA_MODE_BYTE = 0,
+	CY_U3P_DMA_MODE_BUFFER
+}CyU3PDmaMode_t;
+
+/** DMA channel states (CyU3PDmaChannelGetStatus) */
+typedef enum CyU3PDmaState_t
+{
+	CY_U3P_DMA_NOT_CONFIGURED = 0,
+	CY_U3P_DMA_CONFIGURED,
+	CY_U3P_DMA_ACTIVE,
+	CY_U3P_DMA_PROD_OVERRIDE,
+	CY_U3P_DMA_CONS_OVERRIDE,
+	CY_U3P_DMA_ERROR,
+	CY_U3P_DMA_IN_COMPLETION,
+	CY_U3P_DMA_ABORTED
+}CyU3PDmaState_t;
+
+/** DMA callback types */
+typedef enum CyU3PDmaCbType_t
+{
+	CY_U3P_DMA_CB_XFER_CPLT = (1 << 0),
+	CY_U3P_DMA_CB_SEND_CPLT = (1 << 1),
+	CY_U3P_DMA_CB_RECV_CPLT = (1 << 2),
+	CY_U3P_DMA_CB_PROD_EVENT = (1 << 3),
+	CY_U3P_DMA_CB_CONS_EVENT = (1 << 4),
+	CY_U3P_DMA_CB_ABORTED = (1 << 5),
+	CY_U3P_DMA_CB_ERROR = (1 << 6)
+}CyU3PDmaCbType_t;
+
+/** DMA buffer descriptor */
+typedef struct CyU3PDmaBuffer_t
+{
+	uint8_t *buffer;
+	uint16_t count;
+	uint16_t size;
+	uint16_t status;
+}CyU3PDmaBuffer_t;
+
+/** DMA callback input */
+typedef union CyU3PDmaCBInput_t
+{
+	CyU3PDmaBuffer_t buffer_p;
+}CyU3PDmaCBInput_t;
+
+struct CyU3PDmaChannel;
+typedef void (*CyU3PDmaCallback_t)(struct CyU3PDmaChannel *handle, CyU3PDmaCbType_t type, CyU3PDmaCBInput_t *input);
+
+/** DMA channel configuration */
+typedef struct CyU3PDmaChannelConfig_t
+{
+	uint16_t size;
+	uint16_t count;
+	CyU3PDmaSocketId_t prodSckId;
+	CyU3PDmaSocketId_t consSckId;
+	uint32_t prodAvailCount;
+	uint16_t prodHeader;
+	uint16_t prodFooter;
+	uint16_t consHeader;
+	CyU3PDmaMode_t dmaMode;
+	uint32_t notification;
+	CyU3PDmaCallback_t cb;
+}CyU3PDmaChannelConfig_t;
+
+/** Maximum number of buffers in a host build DMA channel */
+#define HOST_DMA_MAX_BUFFERS					(64)
+
+/**
+  * DMA channel. The host build keeps the buffer ring in the channel: buffers [Head, Head + Full) hold data
+  * for the consumer, and the producer fills buffer (Head + Full) % count.
+ **/
+typedef struct CyU3PDmaChannel
+{
+	CyBool_t Created;
+	CyU3PDmaType_t Type;
+	CyU3PDmaChannelConfig_t Config;
+	CyU3PDmaState_t State;
+	uint8_t *Buffers[HOST_DMA_MAX_BUFFERS];
+	uint16_t Counts[HOST_DMA_MAX_BUFFERS];
+	uint32_t Head;
+	uint32_t Full;
+	uint32_t Filled;
+	uint32_t ConsOffset;
+	uint32_t XferSize;
+	uint32_t ProdXferCount;
+	uint32_t ConsXferCount;
+	CyBool_t Override;
+	CyBool_t OverrideDone;
+	uint32_t OverrideOffset;
+	CyU3PDmaBuffer_t OverrideBuffer;
+	struct CyU3PDmaChannel *Next;
+}CyU3PDmaChannel;
+
+CyU3PReturnStatus_t CyU3PDmaChannelCreate(CyU3PDmaChannel *handle, CyU3PDmaType_t type, CyU3PDmaChannelConfig_t *config);
+CyU3PReturnStatus_t CyU3PDmaChannelDestroy(CyU3PDmaChannel *handle);
+CyU3PReturnStatus_t CyU3PDmaChannelReset(CyU3PDmaChannel *handle);
+CyU3PReturnStatus_t CyU3PDmaChannelSetXfer(CyU3PDmaChannel *handle, uint32_t count);
+CyU3PReturnStatus_t CyU3PDmaChannelGetBuffer(CyU3PDmaChannel *handle, CyU3PDmaBuffer_t *buffer_p, uint32_t waitOption);
+CyU3PReturnStatus_t CyU3PDmaChannelCommitBuffer(CyU3PDmaChannel *handle, uint16_t count, uint16_t bufStatus);
+CyU3PReturnStatus_t CyU3PDmaChannelDiscardBuffer(CyU3PDmaChannel *handle);
+CyU3PReturnStatus_t CyU3PDmaChannelSetupSendBuffer(CyU3PDmaChannel *handle, CyU3PDmaBuffer_t *buffer_p);
+CyU3PReturnStatus_t CyU3PDmaChannelSetupRecvBuffer(CyU3PDmaChannel *handle, CyU3PDmaBuffer_t *buffer_p);
+CyU3PReturnStatus_t CyU3PDmaChannelWaitForCompletion(CyU3PDmaChannel *handle, uint32_t waitOption);
+CyU3PReturnStatus_t CyU3PDmaChannelSetWrapUp(CyU3PDmaChannel *handle);
+CyU3PReturnStatus_t CyU3PDmaChannelGetStatus(CyU3PDmaChannel *handle, CyU3PDmaState_t *state, uint32_t *prodXferCount, uint32_t *consXferCount);
+
+#endif
@@ -0,0 +1,51 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3error.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK error codes.
+ **/
+
+#ifndef _INCLUDED_CYU3ERROR_H_
+#define _INCLUDED_CYU3ERROR_H_
+
+/** Error codes returned by the SDK services. The host build only relies on the names, not the values */
+typedef enum CyU3PErrorCode_t
+{
+	CY_U3P_SUCCESS = 0x00,
+	CY_U3P_ERROR_DELETED = 0x01,
+	CY_U3P_ERROR_BAD_POINTER = 0x03,
+	CY_U3P_ERROR_BAD_OPTION = 0x08,
+	CY_U3P_ERROR_QUEUE_EMPTY = 0x0A,
+	CY_U3P_ERROR_QUEUE_FULL = 0x0B,
+	CY_U3P_ERROR_BAD_THREAD = 0x0E,
+	CY_U3P_ERROR_BAD_PRIORITY = 0x0F,
+	CY_U3P_ERROR_MEMORY_ERROR = 0x10,
+	CY_U3P_ERROR_NO_EVENTS = 0x07,
+	CY_U3P_ERROR_MUTEX_FAILURE = 0x1D,
+	CY_U3P_ERROR_BAD_ARGUMENT = 0x40,
+	CY_U3P_ERROR_NULL_POINTER = 0x41,
+	CY_U3P_ERROR_NOT_CONFIGURED = 0x42,
+	CY_U3P_ERROR_NOT_STARTED = 0x43,
+	CY_U3P_ERROR_ALREADY_STARTED = 0x44,
+	CY_U3P_ERROR_NOT_SUPPORTED = 0x45,
+	CY_U3P_ERROR_INVALID_SEQUENCE = 0x46,
+	CY_U3P_ERROR_DMA_FAILURE = 0x49,
+	CY_U3P_ERROR_ABORTED = 0x4A,
+	CY_U3P_ERROR_TIMEOUT = 0x4B,
+	CY_U3P_ERROR_XFER_CANCELLED = 0x4C,
+	CY_U3P_ERROR_FAILURE = 0x4E,
+	CY_U3P_ERROR_MEDIA_FAILURE = 0x60
+
+}CyU3PErrorCode_t;
+
+#endif
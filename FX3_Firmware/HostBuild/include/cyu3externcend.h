@@ -0,0 +1 @@
+/* Host build stand-in: the FX3 SDK C++ linkage guard, not needed for the C only host build */
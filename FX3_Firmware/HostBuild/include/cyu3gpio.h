@@ -0,0 +1,131 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3gpio.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK GPIO services.
+ **/
+
+#ifndef _INCLUDED_CYU3GPIO_H_
+#define _INCLUDED_CYU3GPIO_H_
+
+#include "cyu3types.h"
+#include "cyu3system.h"
+
+/** GPIO interrupt modes */
+typedef enum CyU3PGpioIntrMode_t
+{
+	CY_U3P_GPIO_NO_INTR = 0,
+	CY_U3P_GPIO_INTR_POS_EDGE,
+	CY_U3P_GPIO_INTR_NEG_EDGE,
+	CY_U3P_GPIO_INTR_BOTH_EDGE,
+	CY_U3P_GPIO_INTR_LOW_LEVEL,
+	CY_U3P_GPIO_INTR_HIGH_LEVEL,
+	CY_U3P_GPIO_INTR_TIMER_THRES,
+	CY_U3P_GPIO_INTR_TIMER_ZERO
+}CyU3PGpioIntrMode_t;
+
+/** Complex GPIO pin modes */
+typedef enum CyU3PGpioComplexMode_t
+{
+	CY_U3P_GPIO_MODE_STATIC = 0,
+	CY_U3P_GPIO_MODE_TOGGLE,
+	CY_U3P_GPIO_MODE_SAMPLE_NOW,
+	CY_U3P_GPIO_MODE_PULSE_NOW,
+	CY_U3P_GPIO_MODE_PULSE,
+	CY_U3P_GPIO_MODE_PWM,
+	CY_U3P_GPIO_MODE_MEASURE_LOW,
+	CY_U3P_GPIO_MODE_MEASURE_HIGH,
+	CY_U3P_GPIO_MODE_MEASURE_LOW_ONCE,
+	CY_U3P_GPIO_MODE_MEASURE_HIGH_ONCE,
+	CY_U3P_GPIO_MODE_MEASURE_NEG,
+	CY_U3P_GPIO_MODE_MEASURE_POS,
+	CY_U3P_GPIO_MODE_MEASURE_ANY,
+	CY_U3P_GPIO_MODE_MEASURE_NEG_ONCE,
+	CY_U3P_GPIO_MODE_MEASURE_POS_ONCE,
+	CY_U3P_GPIO_MODE_MEASURE_ANY_ONCE
+}CyU3PGpioComplexMode_t;
+
+/** Complex GPIO timer clock */
+typedef enum CyU3PGpioTimerMode_t
+{
+	CY_U3P_GPIO_TIMER_SHUTDOWN = 0,
+	CY_U3P_GPIO_TIMER_HIGH_FREQ,
+	CY_U3P_GPIO_TIMER_LOW_FREQ,
+	CY_U3P_GPIO_TIMER_STANDBY_FREQ,
+	CY_U3P_GPIO_TIMER_POS_EDGE,
+	CY_U3P_GPIO_TIMER_NEG_EDGE,
+	CY_U3P_GPIO_TIMER_ANY_EDGE,
+	CY_U3P_GPIO_TIMER_RESERVED
+}CyU3PGpioTimerMode_t;
+
+/** Simple GPIO sampling clock divider */
+typedef enum CyU3PGpioSimpleClkDiv_t
+{
+	CY_U3P_GPIO_SIMPLE_DIV_BY_2 = 0,
+	CY_U3P_GPIO_SIMPLE_DIV_BY_4,
+	CY_U3P_GPIO_SIMPLE_DIV_BY_16,
+	CY_U3P_GPIO_SIMPLE_DIV_BY_64
+}CyU3PGpioSimpleClkDiv_t;
+
+/** GPIO block clock configuration */
+typedef struct CyU3PGpioClock_t
+{
+	uint8_t fastClkDiv;
+	uint8_t slowClkDiv;
+	CyBool_t halfDiv;
+	CyU3PGpioSimpleClkDiv_t simpleDiv;
+	CyU3PSysClockSrc_t clkSrc;
+}CyU3PGpioClock_t;
+
+/** Simple GPIO configuration */
+typedef struct CyU3PGpioSimpleConfig_t
+{
+	CyBool_t outValue;
+	CyBool_t driveLowEn;
+	CyBool_t driveHighEn;
+	CyBool_t inputEn;
+	CyU3PGpioIntrMode_t intrMode;
+}CyU3PGpioSimpleConfig_t;
+
+/** Complex GPIO configuration */
+typedef struct CyU3PGpioComplexConfig_t
+{
+	CyBool_t outValue;
+	CyBool_t driveLowEn;
+	CyBool_t driveHighEn;
+	CyBool_t inputEn;
+	CyU3PGpioComplexMode_t pinMode;
+	CyU3PGpioIntrMode_t intrMode;
+	CyU3PGpioTimerMode_t timerMode;
+	uint32_t timer;
+	uint32_t period;
+	uint32_t threshold;
+}CyU3PGpioComplexConfig_t;
+
+typedef void (*CyU3PGpioIntrCb_t)(uint8_t gpioId);
+
+CyU3PReturnStatus_t CyU3PGpioInit(CyU3PGpioClock_t *clk_p, CyU3PGpioIntrCb_t irq);
+CyU3PReturnStatus_t CyU3PGpioDeInit(void);
+CyU3PReturnStatus_t CyU3PGpioSetSimpleConfig(uint8_t gpioId, CyU3PGpioSimpleConfig_t *cfg_p);
+CyU3PReturnStatus_t CyU3PGpioSetComplexConfig(uint8_t gpioId, CyU3PGpioComplexConfig_t *cfg_p);
+CyU3PReturnStatus_t CyU3PGpioDisable(uint8_t gpioId);
+CyU3PReturnStatus_t CyU3PGpioSimpleGetValue(uint8_t gpioId, CyBool_t *value_p);
+CyU3PReturnStatus_t CyU3PGpioSimpleSetValue(uint8_t gpioId, CyBool_t value);
+CyU3PReturnStatus_t CyU3PGpioGetValue(uint8_t gpioId, CyBool_t *value_p);
+CyU3PReturnStatus_t CyU3PGpioSetValue(uint8_t gpioId, CyBool_t value);
+CyU3PReturnStatus_t CyU3PGpioComplexSampleNow(uint8_t gpioId, uint32_t *value_p);
+CyU3PReturnStatus_t CyU3PGpioComplexMeasureOnce(uint8_t gpioId, CyU3PGpioComplexMode_t pinMode);
+CyU3PReturnStatus_t CyU3PGpioComplexWaitForCompletion(uint8_t gpioId, uint32_t *threshold_p, CyBool_t isWait);
+CyBool_t CyU3PIsGpioValid(uint8_t gpioId);
+
+#endif
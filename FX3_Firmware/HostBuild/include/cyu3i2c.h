@@ -0,0 +1,51 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3i2c.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK I2C services.
+ **/
+
+#ifndef _INCLUDED_CYU3I2C_H_
+#define _INCLUDED_CYU3I2C_H_
+
+#include "cyu3types.h"
+
+/** I2C block configuration */
+typedef struct CyU3PI2cConfig_t
+{
+	uint32_t bitRate;
+	CyBool_t isDma;
+	uint32_t busTimeout;
+	uint16_t dmaTimeout;
+}CyU3PI2cConfig_t;
+
+/** I2C command preamble (address and register bytes sent ahead of the data phase) */
+typedef struct CyU3PI2cPreamble_t
+{
+	uint8_t buffer[8];
+	uint8_t length;
+	uint16_t ctrlMask;
+}CyU3PI2cPreamble_t;
+
+typedef void (*CyU3PI2cIntrCb_t)(uint32_t evt, uint32_t error);
+
+CyU3PReturnStatus_t CyU3PI2cInit(void);
+CyU3PReturnStatus_t CyU3PI2cDeInit(void);
+CyU3PReturnStatus_t CyU3PI2cSetConfig(CyU3PI2cConfig_t *config, CyU3PI2cIntrCb_t cb);
+CyU3PReturnStatus_t CyU3PI2cSetTimeout(uint32_t rxTimeout, uint32_t txTimeout, uint32_t preambleTimeout);
+CyU3PReturnStatus_t CyU3PI2cSendCommand(CyU3PI2cPreamble_t *preamble, uint32_t byteCount, CyBool_t isRead);
+CyU3PReturnStatus_t CyU3PI2cTransmitBytes(CyU3PI2cPreamble_t *preamble, uint8_t *data, uint32_t byteCount, uint32_t retryCount);
+CyU3PReturnStatus_t CyU3PI2cReceiveBytes(CyU3PI2cPreamble_t *preamble, uint8_t *data, uint32_t byteCount, uint32_t retryCount);
+CyU3PReturnStatus_t CyU3PI2cWaitForBlockXfer(CyBool_t isRead);
+
+#endif
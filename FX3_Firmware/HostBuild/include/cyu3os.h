@@ -0,0 +1,141 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3os.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK RTOS (ThreadX) services.
+ **/
+
+#ifndef _INCLUDED_CYU3OS_H_
+#define _INCLUDED_CYU3OS_H_
+
+#include "cyu3types.h"
+
+/* Wait options, in ms (timer ticks) */
+#define CYU3P_NO_WAIT							(0x00000000)
+#define CYU3P_WAIT_FOREVER						(0xFFFFFFFF)
+
+/* Thread options */
+#define CYU3P_NO_TIME_SLICE						(0)
+#define CYU3P_AUTO_START						(1)
+#define CYU3P_DONT_START						(0)
+
+/* Timer options */
+#define CYU3P_AUTO_ACTIVATE						(1)
+#define CYU3P_NO_ACTIVATE						(0)
+
+/* Event options */
+#define CYU3P_EVENT_AND							(2)
+#define CYU3P_EVENT_AND_CLEAR					(3)
+#define CYU3P_EVENT_OR							(0)
+#define CYU3P_EVENT_OR_CLEAR					(1)
+
+/* Mutex options */
+#define CYU3P_NO_INHERIT						(0)
+#define CYU3P_INHERIT							(1)
+
+/* Host scheduler state for a thread (HostOs.c) */
+struct HostThread;
+
+/** RTOS thread. The host build runs each thread on its own pthread, one at a time */
+typedef struct CyU3PThread
+{
+	struct HostThread *Host;
+	char *Name;
+}CyU3PThread;
+
+/** Event group */
+typedef struct CyU3PEvent
+{
+	volatile uint32_t Flags;
+	CyBool_t Created;
+}CyU3PEvent;
+
+/** Message queue of fixed size messages */
+typedef struct CyU3PQueue
+{
+	uint32_t *Storage;
+	uint32_t MessageWords;
+	uint32_t Capacity;
+	uint32_t Count;
+	uint32_t Head;
+}CyU3PQueue;
+
+/** Mutex. Like ThreadX, a mutex can only be created once until it is destroyed */
+typedef struct CyU3PMutex
+{
+	struct HostThread *Owner;
+	uint32_t Count;
+	CyBool_t Created;
+}CyU3PMutex;
+
+/** Application timer. The callback runs in the scheduler, outside of any thread */
+typedef struct CyU3PTimer
+{
+	void (*Callback)(uint32_t);
+	uint32_t Param;
+	uint32_t RescheduleMs;
+	uint64_t ExpiryNs;
+	CyBool_t Active;
+	struct CyU3PTimer *Next;
+}CyU3PTimer;
+
+/** Byte pool (only used by cyfxtx.c, which the host build replaces) */
+typedef struct CyU3PBytePool
+{
+	uint32_t Unused;
+}CyU3PBytePool;
+
+typedef void (*CyU3PThreadEntry_t)(uint32_t);
+typedef void (*CyU3PTimerCb_t)(uint32_t);
+
+/* Threads */
+uint32_t CyU3PThreadCreate(CyU3PThread *thread_p, char *threadName, CyU3PThreadEntry_t entryFn, uint32_t entryInput, void *stackStart,
+		uint32_t stackSize, uint32_t priority, uint32_t preemptThreshold, uint32_t timeSlice, uint32_t autoStart);
+CyU3PThread *CyU3PThreadIdentify(void);
+uint32_t CyU3PThreadPriorityChange(CyU3PThread *thread_p, uint32_t newPriority, uint32_t *oldPriority);
+void CyU3PThreadRelinquish(void);
+uint32_t CyU3PThreadSleep(uint32_t timerTicks);
+
+/* Events */
+uint32_t CyU3PEventCreate(CyU3PEvent *event_p);
+uint32_t CyU3PEventDestroy(CyU3PEvent *event_p);
+uint32_t CyU3PEventSet(CyU3PEvent *event_p, uint32_t rqtFlag, uint32_t setOption);
+uint32_t CyU3PEventGet(CyU3PEvent *event_p, uint32_t rqtFlag, uint32_t getOption, uint32_t *flag_p, uint32_t waitOption);
+
+/* Queues */
+uint32_t CyU3PQueueCreate(CyU3PQueue *queue_p, uint32_t messageSize, void *bufferStart, uint32_t queueSize);
+uint32_t CyU3PQueueSend(CyU3PQueue *queue_p, void *src_p, uint32_t waitOption);
+uint32_t CyU3PQueueReceive(CyU3PQueue *queue_p, void *dest_p, uint32_t waitOption);
+
+/* Mutexes */
+uint32_t CyU3PMutexCreate(CyU3PMutex *mutex_p, uint32_t priorityInherit);
+uint32_t CyU3PMutexDestroy(CyU3PMutex *mutex_p);
+uint32_t CyU3PMutexGet(CyU3PMutex *mutex_p, uint32_t waitOption);
+uint32_t CyU3PMutexPut(CyU3PMutex *mutex_p);
+
+/* Timers */
+uint32_t CyU3PTimerCreate(CyU3PTimer *timer_p, CyU3PTimerCb_t expirationFunction, uint32_t expirationInput,
+		uint32_t initialTicks, uint32_t rescheduleTicks, uint32_t timerOption);
+uint32_t CyU3PTimerDestroy(CyU3PTimer *timer_p);
+uint32_t CyU3PGetTime(void);
+
+/* Memory */
+void *CyU3PMemAlloc(uint32_t size);
+void CyU3PMemFree(void *mem_p);
+void CyU3PMemSet(uint8_t *ptr, uint8_t data, uint32_t count);
+void CyU3PMemCopy(uint8_t *dest, uint8_t *src, uint32_t count);
+int32_t CyU3PMemCmp(const void *s1, const void *s2, uint32_t n);
+void *CyU3PDmaBufferAlloc(uint16_t size);
+int CyU3PDmaBufferFree(void *buffer);
+
+#endif
@@ -0,0 +1,25 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3pib.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK processor interface block services.
+ **/
+
+#ifndef _INCLUDED_CYU3PIB_H_
+#define _INCLUDED_CYU3PIB_H_
+
+#include "cyu3types.h"
+
+CyU3PReturnStatus_t CyU3PPibDeInit(void);
+
+#endif
@@ -0,0 +1,71 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3spi.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK SPI services.
+ **/
+
+#ifndef _INCLUDED_CYU3SPI_H_
+#define _INCLUDED_CYU3SPI_H_
+
+#include "cyu3types.h"
+
+/** SPI chip select control */
+typedef enum CyU3PSpiSsnCtrl_t
+{
+	CY_U3P_SPI_SSN_CTRL_FW = 0,
+	CY_U3P_SPI_SSN_CTRL_HW_EACH_WORD,
+	CY_U3P_SPI_SSN_CTRL_HW_CPHA_BASED,
+	CY_U3P_SPI_SSN_CTRL_NONE,
+	CY_U3P_SPI_SSN_CTRL_HW_END_OF_XFER,
+	CY_U3P_SPI_NUM_SSN_CTRL
+}CyU3PSpiSsnCtrl_t;
+
+/** SPI chip select lead / lag time, in SCLK half cycles */
+typedef enum CyU3PSpiSsnLagLead_t
+{
+	CY_U3P_SPI_SSN_LAG_LEAD_ZERO_CLK = 0,
+	CY_U3P_SPI_SSN_LAG_LEAD_HALF_CLK,
+	CY_U3P_SPI_SSN_LAG_LEAD_ONE_CLK,
+	CY_U3P_SPI_SSN_LAG_LEAD_ONE_HALF_CLK,
+	CY_U3P_SPI_NUM_SSN_LAG_LEAD
+}CyU3PSpiSsnLagLead_t;
+
+/** SPI block configuration */
+typedef struct CyU3PSpiConfig_t
+{
+	CyBool_t isLsbFirst;
+	CyBool_t cpol;
+	CyBool_t cpha;
+	CyBool_t ssnPol;
+	CyU3PSpiSsnCtrl_t ssnCtrl;
+	CyU3PSpiSsnLagLead_t leadTime;
+	CyU3PSpiSsnLagLead_t lagTime;
+	uint32_t clock;
+	uint8_t wordLen;
+}CyU3PSpiConfig_t;
+
+typedef void (*CyU3PSpiIntrCb_t)(uint32_t evt, uint32_t error);
+
+CyU3PReturnStatus_t CyU3PSpiInit(void);
+CyU3PReturnStatus_t CyU3PSpiDeInit(void);
+CyU3PReturnStatus_t CyU3PSpiSetConfig(CyU3PSpiConfig_t *config, CyU3PSpiIntrCb_t cb);
+CyU3PReturnStatus_t CyU3PSpiTransmitWords(uint8_t *data, uint32_t byteCount);
+CyU3PReturnStatus_t CyU3PSpiReceiveWords(uint8_t *data, uint32_t byteCount);
+CyU3PReturnStatus_t CyU3PSpiTransferWords(uint8_t *txBuf, uint32_t txByteCount, uint8_t *rxBuf, uint32_t rxByteCount);
+CyU3PReturnStatus_t CyU3PSpiSetBlockXfer(uint32_t txSize, uint32_t rxSize);
+CyU3PReturnStatus_t CyU3PSpiWaitForBlockXfer(CyBool_t isRead);
+CyU3PReturnStatus_t CyU3PSpiDisableBlockXfer(CyBool_t rxDisable, CyBool_t txDisable);
+CyU3PReturnStatus_t CyU3PSpiResetFifo(CyBool_t isTx, CyBool_t isRx);
+
+#endif
@@ -0,0 +1,94 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3system.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK device, IO matrix and debug print services.
+ **/
+
+#ifndef _INCLUDED_CYU3SYSTEM_H_
+#define _INCLUDED_CYU3SYSTEM_H_
+
+#include "cyu3types.h"
+
+/** Clock source for the system and peripheral clocks */
+typedef enum CyU3PSysClockSrc_t
+{
+	CY_U3P_SYS_CLK_BY_16 = 0,
+	CY_U3P_SYS_CLK_BY_4,
+	CY_U3P_SYS_CLK_BY_2,
+	CY_U3P_SYS_CLK
+}CyU3PSysClockSrc_t;
+
+/** System clock configuration (CyU3PDeviceInit) */
+typedef struct CyU3PSysClockConfig_t
+{
+	CyBool_t setSysClk400;
+	uint8_t cpuClkDiv;
+	uint8_t dmaClkDiv;
+	uint8_t mmioClkDiv;
+	CyBool_t useStandbyClk;
+	CyU3PSysClockSrc_t clkSrc;
+}CyU3PSysClockConfig_t;
+
+/** Serial port (S0/S1) modes */
+typedef enum CyU3PSport_t
+{
+	CY_U3P_SPORT_INACTIVE = 0,
+	CY_U3P_SPORT_4BIT,
+	CY_U3P_SPORT_8BIT
+}CyU3PSport_t;
+
+/** Low performance peripheral IO matrix modes */
+typedef enum CyU3PIoMatrixLppMode_t
+{
+	CY_U3P_IO_MATRIX_LPP_DEFAULT = 0,
+	CY_U3P_IO_MATRIX_LPP_UART_ONLY,
+	CY_U3P_IO_MATRIX_LPP_SPI_ONLY,
+	CY_U3P_IO_MATRIX_LPP_I2S_ONLY
+}CyU3PIoMatrixLppMode_t;
+
+/** IO matrix configuration (CyU3PDeviceConfigureIOMatrix) */
+typedef struct CyU3PIoMatrixConfig_t
+{
+	CyBool_t isDQ32Bit;
+	CyBool_t useUart;
+	CyBool_t useI2C;
+	CyBool_t useI2S;
+	CyBool_t useSpi;
+	CyU3PIoMatrixLppMode_t lppMode;
+	uint32_t gpioSimpleEn[2];
+	uint32_t gpioComplexEn[2];
+	CyU3PSport_t s0Mode;
+	CyU3PSport_t s1Mode;
+}CyU3PIoMatrixConfig_t;
+
+CyU3PReturnStatus_t CyU3PDeviceInit(CyU3PSysClockConfig_t *clkCfg_p);
+CyU3PReturnStatus_t CyU3PDeviceCacheControl(CyBool_t isICacheEnable, CyBool_t isDCacheEnable, CyBool_t isDmaHandleDCache);
+CyU3PReturnStatus_t CyU3PDeviceConfigureIOMatrix(CyU3PIoMatrixConfig_t *cfg_p);
+CyU3PReturnStatus_t CyU3PDeviceGpioOverride(uint8_t gpioId, CyBool_t isSimple);
+CyU3PReturnStatus_t CyU3PDeviceGpioRestore(uint8_t gpioId);
+void CyU3PDeviceReset(CyBool_t isWarmReset);
+CyU3PReturnStatus_t CyU3PReadDeviceRegisters(uvint32_t *regAddr, uint8_t numRegs, uint32_t *dataBuf);
+void CyU3PSysWatchDogConfigure(CyBool_t enable, uint32_t period);
+void CyU3PKernelEntry(void);
+void CyFx3BusyWait(uint16_t usWait);
+
+/* Debug log (UART) */
+CyU3PReturnStatus_t CyU3PDebugInit(uint16_t destSckId, uint8_t traceLevel);
+void CyU3PDebugPreamble(CyBool_t sendPreamble);
+CyU3PReturnStatus_t CyU3PDebugPrint(uint8_t priority, char *message, ...);
+
+/* Application entry, called by CyU3PKernelEntry */
+void CyFxApplicationDefine(void);
+
+#endif
@@ -0,0 +1,37 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3types.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK base types.
+ **/
+
+#ifndef _INCLUDED_CYU3TYPES_H_
+#define _INCLUDED_CYU3TYPES_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int CyBool_t;
+#define CyTrue									(1)
+#define CyFalse									(0)
+
+typedef volatile uint32_t uvint32_t;
+typedef volatile uint16_t uvint16_t;
+typedef volatile uint8_t uvint8_t;
+
+typedef uint32_t CyU3PReturnStatus_t;
+
+#define CY_U3P_MIN(a,b)							(((a) < (b)) ? (a) : (b))
+#define CY_U3P_MAX(a,b)							(((a) > (b)) ? (a) : (b))
+
+#endif
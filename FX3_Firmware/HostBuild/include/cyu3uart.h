@@ -0,0 +1,62 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3uart.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK UART services.
+ **/
+
+#ifndef _INCLUDED_CYU3UART_H_
+#define _INCLUDED_CYU3UART_H_
+
+#include "cyu3types.h"
+
+typedef enum CyU3PUartBaudrate_t
+{
+	CY_U3P_UART_BAUDRATE_9600 = 9600,
+	CY_U3P_UART_BAUDRATE_115200 = 115200,
+	CY_U3P_UART_BAUDRATE_921600 = 921600
+}CyU3PUartBaudrate_t;
+
+typedef enum CyU3PUartStopBit_t
+{
+	CY_U3P_UART_ONE_STOP_BIT = 1,
+	CY_U3P_UART_TWO_STOP_BIT = 2
+}CyU3PUartStopBit_t;
+
+typedef enum CyU3PUartParity_t
+{
+	CY_U3P_UART_NO_PARITY = 0,
+	CY_U3P_UART_EVEN_PARITY,
+	CY_U3P_UART_ODD_PARITY
+}CyU3PUartParity_t;
+
+/** UART block configuration */
+typedef struct CyU3PUartConfig_t
+{
+	CyBool_t txEnable;
+	CyBool_t rxEnable;
+	CyBool_t flowCtrl;
+	CyBool_t isDma;
+	CyU3PUartBaudrate_t baudRate;
+	CyU3PUartStopBit_t stopBit;
+	CyU3PUartParity_t parity;
+}CyU3PUartConfig_t;
+
+typedef void (*CyU3PUartIntrCb_t)(uint32_t evt, uint32_t error);
+
+CyU3PReturnStatus_t CyU3PUartInit(void);
+CyU3PReturnStatus_t CyU3PUartDeInit(void);
+CyU3PReturnStatus_t CyU3PUartSetConfig(CyU3PUartConfig_t *config, CyU3PUartIntrCb_t cb);
+CyU3PReturnStatus_t CyU3PUartTxSetBlockXfer(uint32_t txSize);
+
+#endif
@@ -0,0 +1,116 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3usb.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK USB device services.
+ **/
+
+#ifndef _INCLUDED_CYU3USB_H_
+#define _INCLUDED_CYU3USB_H_
+
+#include "cyu3types.h"
+#include "cyu3usbconst.h"
+
+/** USB connection speed */
+typedef enum CyU3PUSBSpeed_t
+{
+	CY_U3P_NOT_CONNECTED = 0,
+	CY_U3P_FULL_SPEED,
+	CY_U3P_HIGH_SPEED,
+	CY_U3P_SUPER_SPEED
+}CyU3PUSBSpeed_t;
+
+/** USB events passed to the event callback */
+typedef enum CyU3PUsbEventType_t
+{
+	CY_U3P_USB_EVENT_CONNECT = 0,
+	CY_U3P_USB_EVENT_DISCONNECT,
+	CY_U3P_USB_EVENT_SUSPEND,
+	CY_U3P_USB_EVENT_RESUME,
+	CY_U3P_USB_EVENT_RESET,
+	CY_U3P_USB_EVENT_SETCONF,
+	CY_U3P_USB_EVENT_SPEED,
+	CY_U3P_USB_EVENT_SETINTF,
+	CY_U3P_USB_EVENT_USB3_LNKFAIL
+}CyU3PUsbEventType_t;
+
+/** USB 3.0 link power modes */
+typedef enum CyU3PUsbLinkPowerMode
+{
+	CyU3PUsbLPM_U0 = 0,
+	CyU3PUsbLPM_U1,
+	CyU3PUsbLPM_U2,
+	CyU3PUsbLPM_U3
+}CyU3PUsbLinkPowerMode;
+
+/** Endpoint event types */
+typedef enum CyU3PUsbEpEvtType
+{
+	CYU3P_USBEP_NAK_EVT = 1,
+	CYU3P_USBEP_ZLP_EVT = 2,
+	CYU3P_USBEP_SLP_EVT = 4
+}CyU3PUsbEpEvtType;
+
+/** Endpoint types */
+typedef enum CyU3PUsbEpType_t
+{
+	CY_U3P_USB_EP_CONTROL = 0,
+	CY_U3P_USB_EP_ISO,
+	CY_U3P_USB_EP_BULK,
+	CY_U3P_USB_EP_INTR
+}CyU3PUsbEpType_t;
+
+/** Descriptor types for CyU3PUsbSetDesc */
+typedef enum CyU3PUSBSetDescType_t
+{
+	CY_U3P_USB_SET_SS_DEVICE_DESCR = 0,
+	CY_U3P_USB_SET_HS_DEVICE_DESCR,
+	CY_U3P_USB_SET_DEVQUAL_DESCR,
+	CY_U3P_USB_SET_FS_CONFIG_DESCR,
+	CY_U3P_USB_SET_HS_CONFIG_DESCR,
+	CY_U3P_USB_SET_STRING_DESCR,
+	CY_U3P_USB_SET_SS_CONFIG_DESCR,
+	CY_U3P_USB_SET_SS_BOS_DESCR
+}CyU3PUSBSetDescType_t;
+
+/** Endpoint configuration */
+typedef struct CyU3PEpConfig_t
+{
+	CyBool_t enable;
+	CyU3PUsbEpType_t epType;
+	uint16_t streams;
+	uint16_t pcktSize;
+	uint8_t burstLen;
+	uint8_t isoPkts;
+}CyU3PEpConfig_t;
+
+typedef CyBool_t (*CyU3PUSBSetupCb_t)(uint32_t setupdat0, uint32_t setupdat1);
+typedef void (*CyU3PUSBEventCb_t)(CyU3PUsbEventType_t evtype, uint16_t evdata);
+typedef CyBool_t (*CyU3PUsbLPMReqCb_t)(CyU3PUsbLinkPowerMode link_mode);
+
+CyU3PReturnStatus_t CyU3PUsbStart(void);
+void CyU3PUsbRegisterSetupCallback(CyU3PUSBSetupCb_t callback, CyBool_t fastEnum);
+void CyU3PUsbRegisterEventCallback(CyU3PUSBEventCb_t callback);
+void CyU3PUsbRegisterLPMRequestCallback(CyU3PUsbLPMReqCb_t cb);
+CyU3PReturnStatus_t CyU3PUsbSetDesc(CyU3PUSBSetDescType_t desc_type, uint8_t desc_index, uint8_t *desc);
+CyU3PReturnStatus_t CyU3PConnectState(CyBool_t connect, CyBool_t ssEnable);
+CyU3PUSBSpeed_t CyU3PUsbGetSpeed(void);
+CyU3PReturnStatus_t CyU3PUsbLPMDisable(void);
+CyU3PReturnStatus_t CyU3PSetEpConfig(uint8_t ep, CyU3PEpConfig_t *epinfo);
+CyU3PReturnStatus_t CyU3PUsbFlushEp(uint8_t ep);
+CyU3PReturnStatus_t CyU3PUsbStall(uint8_t ep, CyBool_t stall, CyBool_t toggle);
+void CyU3PUsbAckSetup(void);
+CyU3PReturnStatus_t CyU3PUsbGetEP0Data(uint16_t count, uint8_t *buffer, uint16_t *readCount);
+CyU3PReturnStatus_t CyU3PUsbSendEP0Data(uint16_t count, uint8_t *buffer);
+
+#endif
@@ -0,0 +1,61 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3usbconst.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SDK USB constants.
+ **/
+
+#ifndef _INCLUDED_CYU3USBCONST_H_
+#define _INCLUDED_CYU3USBCONST_H_
+
+/* USB descriptor types */
+#define CY_U3P_USB_DEVICE_DESCR					(0x01)
+#define CY_U3P_USB_CONFIG_DESCR					(0x02)
+#define CY_U3P_USB_STRING_DESCR					(0x03)
+#define CY_U3P_USB_INTRFC_DESCR					(0x04)
+#define CY_U3P_USB_ENDPNT_DESCR					(0x05)
+#define CY_U3P_USB_DEVQUAL_DESCR				(0x06)
+#define CY_U3P_BOS_DESCR						(0x0F)
+#define CY_U3P_DEVICE_CAPB_DESCR				(0x10)
+#define CY_U3P_SS_EP_COMPN_DESCR				(0x30)
+
+/* Device capability types */
+#define CY_U3P_USB2_EXTN_CAPB_TYPE				(0x02)
+#define CY_U3P_SS_USB_CAPB_TYPE					(0x03)
+
+/* Setup packet fields. setupdat0 is bmRequestType, bRequest, wValue; setupdat1 is wIndex, wLength */
+#define CY_U3P_USB_REQUEST_TYPE_MASK			(0x000000FF)
+#define CY_U3P_USB_REQUEST_MASK					(0x0000FF00)
+#define CY_U3P_USB_REQUEST_POS					(8)
+#define CY_U3P_USB_VALUE_MASK					(0xFFFF0000)
+#define CY_U3P_USB_VALUE_POS					(16)
+#define CY_U3P_USB_INDEX_MASK					(0x0000FFFF)
+#define CY_U3P_USB_INDEX_POS					(0)
+#define CY_U3P_USB_LENGTH_MASK					(0xFFFF0000)
+#define CY_U3P_USB_LENGTH_POS					(16)
+
+/* bmRequestType fields */
+#define CY_U3P_USB_TYPE_MASK					(0x60)
+#define CY_U3P_USB_STANDARD_RQT					(0x00)
+#define CY_U3P_USB_CLASS_RQT					(0x20)
+#define CY_U3P_USB_VENDOR_RQT					(0x40)
+#define CY_U3P_USB_TARGET_MASK					(0x03)
+#define CY_U3P_USB_TARGET_DEVICE				(0x00)
+#define CY_U3P_USB_TARGET_INTF					(0x01)
+#define CY_U3P_USB_TARGET_ENDPT					(0x02)
+
+/* Standard requests */
+#define CY_U3P_USB_SC_CLEAR_FEATURE				(0x01)
+#define CY_U3P_USB_SC_SET_FEATURE				(0x03)
+
+#endif
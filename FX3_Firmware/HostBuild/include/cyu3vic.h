@@ -0,0 +1,32 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		cyu3vic.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 vectored interrupt controller services.
+ **/
+
+#ifndef _INCLUDED_CYU3VIC_H_
+#define _INCLUDED_CYU3VIC_H_
+
+#include "cyu3types.h"
+
+#define CY_U3P_VIC_GCTL_PWR_VECTOR				(4)
+#define CY_U3P_VIC_GPIO_CORE_VECTOR				(23)
+
+void CyU3PVicEnableInt(uint32_t vectorNum);
+void CyU3PVicDisableInt(uint32_t vectorNum);
+void CyU3PVicClearInt(void);
+uint32_t CyU3PVicDisableAllInterrupts(void);
+void CyU3PVicEnableInterrupts(uint32_t mask);
+
+#endif
@@ -0,0 +1,68 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		gpio_regs.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 GPIO register block. Accesses go through the host register model (HostRegs.c).
+ **/
+
+#ifndef _INCLUDED_GPIO_REGS_H_
+#define _INCLUDED_GPIO_REGS_H_
+
+#include "cyu3types.h"
+
+/** Complex GPIO pin registers */
+typedef struct
+{
+	uvint32_t status;
+	uvint32_t timer;
+	uvint32_t period;
+	uvint32_t threshold;
+}LPP_GPIO_PIN_T;
+
+/** GPIO register block */
+typedef struct
+{
+	uvint32_t lpp_gpio_simple[61];
+	uvint32_t reserved0[3];
+	LPP_GPIO_PIN_T lpp_gpio_pin[8];
+	uvint32_t reserved1[32];
+	uvint32_t lpp_gpio_invalue0;
+	uvint32_t lpp_gpio_invalue1;
+	uvint32_t reserved2[2];
+	uvint32_t lpp_gpio_intr0;
+	uvint32_t lpp_gpio_intr1;
+	uvint32_t reserved3[2];
+	uvint32_t lpp_gpio_power;
+}LPP_GPIO_REGS_T, *PLPP_GPIO_REGS_T;
+
+/* Returns the firmware (read only) view of the GPIO registers, after bringing the register model up to date */
+PLPP_GPIO_REGS_T HostGpioRegs(void);
+
+#define GPIO									(HostGpioRegs())
+
+/* Simple GPIO and complex GPIO status register fields */
+#define CY_U3P_LPP_GPIO_OUT_VALUE				(1u << 0)
+#define CY_U3P_LPP_GPIO_IN_VALUE				(1u << 1)
+#define CY_U3P_LPP_GPIO_TIMER_MODE_POS			(24)
+#define CY_U3P_LPP_GPIO_TIMER_MODE_MASK			(0x07000000u)
+#define CY_U3P_LPP_GPIO_DRIVE_LO_EN				(1u << 4)
+#define CY_U3P_LPP_GPIO_DRIVE_HI_EN				(1u << 5)
+#define CY_U3P_LPP_GPIO_INPUT_EN				(1u << 6)
+#define CY_U3P_LPP_GPIO_MODE_POS				(8)
+#define CY_U3P_LPP_GPIO_MODE_MASK				(0x00000F00u)
+#define CY_U3P_LPP_GPIO_INTRMODE_POS			(12)
+#define CY_U3P_LPP_GPIO_INTRMODE_MASK			(0x00007000u)
+#define CY_U3P_LPP_GPIO_INTR					(1u << 27)
+#define CY_U3P_LPP_GPIO_ENABLE					(1u << 31)
+
+#endif
@@ -0,0 +1,74 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		spi_regs.h
+  * @date		10/16/2026
+  * @author		agent (agent@local)
+  * @brief		Host build stand-in for the FX3 SPI register block. Accesses go through the host register model (HostRegs.c).
+ **/
+
+#ifndef _INCLUDED_SPI_REGS_H_
+#define _INCLUDED_SPI_REGS_H_
+
+#include "cyu3types.h"
+
+/** SPI register block */
+typedef struct
+{
+	uvint32_t lpp_spi_config;
+	uvint32_t lpp_spi_status;
+	uvint32_t lpp_spi_intr;
+	uvint32_t lpp_spi_intr_mask;
+	uvint32_t lpp_spi_rx_byte_count;
+	uvint32_t lpp_spi_tx_byte_count;
+	uvint32_t lpp_spi_socket;
+	uvint32_t reserved0;
+	uvint32_t lpp_spi_egress_data;
+	uvint32_t lpp_spi_ingress_data;
+	uvint32_t reserved1[6];
+	uvint32_t lpp_spi_power;
+}LPP_SPI_REGS_T, *PLPP_SPI_REGS_T;
+
+/* Returns the firmware (read only) view of the SPI registers, after bringing the register model up to date */
+PLPP_SPI_REGS_T HostSpiRegs(void);
+
+#define SPI										(HostSpiRegs())
+
+/* lpp_spi_config fields */
+#define CY_U3P_LPP_SPI_RX_ENABLE				(1u << 0)
+#define CY_U3P_LPP_SPI_TX_ENABLE				(1u << 1)
+#define CY_U3P_LPP_SPI_DMA_MODE					(1u << 2)
+#define CY_U3P_LPP_SPI_ENDIAN					(1u << 3)
+#define CY_U3P_LPP_SPI_SSNCTRL_POS				(4)
+#define CY_U3P_LPP_SPI_SSNCTRL_MASK				(0x00000030u)
+#define CY_U3P_LPP_SPI_LEAD_POS					(6)
+#define CY_U3P_LPP_SPI_LEAD_MASK				(0x000000C0u)
+#define CY_U3P_LPP_SPI_LAG_POS					(8)
+#define CY_U3P_LPP_SPI_LAG_MASK					(0x00000300u)
+#define CY_U3P_LPP_SPI_CPOL						(1u << 10)
+#define CY_U3P_LPP_SPI_CPHA						(1u << 11)
+#define CY_U3P_LPP_SPI_SSN_BIT					(1u << 12)
+#define CY_U3P_LPP_SPI_SSPOL					(1u << 16)
+#define CY_U3P_LPP_SPI_WL_POS					(17)
+#define CY_U3P_LPP_SPI_WL_MASK					(0x007E0000u)
+#define CY_U3P_LPP_SPI_TX_CLEAR					(1u << 29)
+#define CY_U3P_LPP_SPI_RX_CLEAR					(1u << 30)
+#define CY_U3P_LPP_SPI_ENABLE					(1u << 31)
+
+/* lpp_spi_status and lpp_spi_intr fields */
+#define CY_U3P_LPP_SPI_RX_DATA					(1u << 0)
+#define CY_U3P_LPP_SPI_RX_SPACE					(1u << 1)
+#define CY_U3P_LPP_SPI_TX_DATA					(1u << 2)
+#define CY_U3P_LPP_SPI_TX_SPACE					(1u << 3)
+#define CY_U3P_LPP_SPI_TX_DONE					(1u << 4)
+#define CY_U3P_LPP_SPI_BUSY						(1u << 28)
+
+#endif
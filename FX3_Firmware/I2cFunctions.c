@@ -18,7 +18,6 @@
 #include "I2cFunctions.h"
 
 /** Reference to needed globals (defined in main) */
-extern uint8_t USBBuffer[4096];
 extern uint8_t BulkBuffer[12288];
 extern CyU3PDmaBuffer_t ManualDMABuffer;
 extern CyU3PDmaChannel ChannelToPC;
@@ -27,7 +26,9 @@ extern BoardState FX3State;
 /**
   * @brief Handler for I2C read command from control endpoint
   *
-  * @param RequestLength Number of bytes received over control endpoint
+  * @param args The request data read from the control endpoint (see AdiCommandQueue)
+  *
+  * @param length Number of bytes received over control endpoint
   *
   * @return A status code indicating the success of the I2C read command
   *
@@ -35,20 +36,14 @@ extern BoardState FX3State;
   * single transfer. The number of bytes read in a single transfer
   * can be 0 bytes - 12KB.
  **/
-CyU3PReturnStatus_t AdiI2CReadHandler(uint16_t RequestLength)
+CyU3PReturnStatus_t AdiI2CReadHandler(uint8_t *args, uint16_t length)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-	uint16_t bytesRead = 0;
 	uint32_t timeout, numBytes;
 	CyU3PI2cPreamble_t preamble = {};
 
-	/* Get data from control endpoint */
-	status = CyU3PUsbGetEP0Data(RequestLength, USBBuffer, &bytesRead);
-	if(status != CY_U3P_SUCCESS)
-		return status;
-
-	/* Parse USB Buffer */
-	I2CParseUSBBuffer(&timeout, &numBytes, &preamble);
+	/* Parse request data */
+	I2CParseUSBBuffer(args, &timeout, &numBytes, &preamble);
 
 	/* Clamp numbytes */
 	if(numBytes > 12288)
@@ -80,7 +75,9 @@ CyU3PReturnStatus_t AdiI2CReadHandler(uint16_t RequestLength)
 /**
   * @brief Handler for I2C write command from control endpoint
   *
-  * @param RequestLength Number of bytes received over control endpoint
+  * @param args The request data read from the control endpoint (see AdiCommandQueue)
+  *
+  * @param length Number of bytes received over control endpoint
   *
   * @return A status code indicating the success of the I2C write command
   *
@@ -88,24 +85,22 @@ CyU3PReturnStatus_t AdiI2CReadHandler(uint16_t RequestLength)
   * single transfer. The number of bytes written in a single transfer is
   * limited to ~4070.
  **/
-CyU3PReturnStatus_t AdiI2CWriteHandler(uint16_t RequestLength)
+CyU3PReturnStatus_t AdiI2CWriteHandler(uint8_t *args, uint16_t length)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-	uint16_t bytesRead = 0;
 	uint32_t timeout, numBytes, index;
 	CyU3PI2cPreamble_t preamble = {};
 	uint8_t * bufIndex;
 
-	/* Get data from control endpoint */
-	status = CyU3PUsbGetEP0Data(RequestLength, USBBuffer, &bytesRead);
-	if(status != CY_U3P_SUCCESS)
-		return status;
+	/* Parse request data */
+	index = I2CParseUSBBuffer(args, &timeout, &numBytes, &preamble);
 
-	/* Parse USB Buffer */
-	index = I2CParseUSBBuffer(&timeout, &numBytes, &preamble);
+	/* The write data must all be in the request */
+	if((index + numBytes) > length)
+		return CY_U3P_ERROR_BAD_ARGUMENT;
 
-	/* Get index within USB buffer where write data starts */
-	bufIndex = USBBuffer + index;
+	/* Get index within request data where write data starts */
+	bufIndex = args + index;
 
 	/* Apply I2C timeout (arguments are in microseconds) */
 	timeout = timeout * 1000;
@@ -134,10 +129,14 @@ CyU3PReturnStatus_t AdiI2CInit(uint32_t BitRate, CyBool_t isDMA)
 
     /* Filter bit rate */
     if(BitRate < 100000)
+    {
     	BitRate = 100000;
+    }
 
     if(BitRate > 1000000)
+    {
     	BitRate = 1000000;
+    }
 
 	/* De-init */
 	CyU3PI2cDeInit();
@@ -168,41 +167,42 @@ CyU3PReturnStatus_t AdiI2CInit(uint32_t BitRate, CyBool_t isDMA)
 /**
   * @brief Parses I2C command data from the USB Buffer. Used for read/write/stream
   *
+  * @param buf The I2C command data (USBBuffer, or the queued request data)
+  *
   * @param timeout Timeout value for I2C transaction. Return by reference.
   *
-  * @param numBytes Number of bytes field in USBBuffer. Return by reference
+  * @param numBytes Number of bytes field in buf. Return by reference
   *
-  * @param preamble I2C preamble struct stored in USBBuffer. Return by reference
+  * @param preamble I2C preamble struct stored in buf. Return by reference
   *
   * @return Index for the start of the I2C transmit data (if it exists)
  **/
-uint32_t I2CParseUSBBuffer(uint32_t * timeout, uint32_t * numBytes, CyU3PI2cPreamble_t * preamble)
+uint32_t I2CParseUSBBuffer(uint8_t * buf, uint32_t * timeout, uint32_t * numBytes, CyU3PI2cPreamble_t * preamble)
 {
 	uint32_t index;
 
 	/* Parse num bytes */
-	*numBytes = USBBuffer[0];
-	*numBytes |= (USBBuffer[1] << 8);
-	*numBytes |= (USBBuffer[2] << 16);
-	*numBytes |= (USBBuffer[3] << 24);
+	*numBytes = buf[0];
+	*numBytes |= (buf[1] << 8);
+	*numBytes |= (buf[2] << 16);
+	*numBytes |= (buf[3] << 24);
 
 	/* Parse timeout */
-	*timeout = USBBuffer[4];
-	*timeout |= (USBBuffer[5] << 8);
-	*timeout |= (USBBuffer[6] << 16);
-	*timeout |= (USBBuffer[7] << 24);
+	*timeout = buf[4];
+	*timeout |= (buf[5] << 8);
+	*timeout |= (buf[6] << 16);
+	*timeout |= (buf[7] << 24);
 
 	/* Parse pre-amble */
-	preamble->length = USBBuffer[8];
-	preamble->ctrlMask = USBBuffer[9];
-	preamble->ctrlMask |= (USBBuffer[10] << 8);
+	preamble->length = buf[8];
+	preamble->ctrlMask = buf[9];
+	preamble->ctrlMask |= (buf[10] << 8);
 	for(int i = 0; i < preamble->length; i++)
 	{
-		index = 11 + i;
-		preamble->buffer[i] = USBBuffer[index];
+		preamble->buffer[i] = buf[11 + i];
 	}
-	/* Increment index to point at first write data */
-	index++;
+	/* The write data starts after the pre-amble (at 11 when there is no pre-amble) */
+	index = 11 + preamble->length;
 
 	return index;
 }
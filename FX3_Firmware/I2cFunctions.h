@@ -21,9 +21,9 @@
 #include "main.h"
 
 /* Public functions */
-CyU3PReturnStatus_t AdiI2CReadHandler(uint16_t RequestLength);
-CyU3PReturnStatus_t AdiI2CWriteHandler(uint16_t RequestLength);
+CyU3PReturnStatus_t AdiI2CReadHandler(uint8_t *args, uint16_t length);
+CyU3PReturnStatus_t AdiI2CWriteHandler(uint8_t *args, uint16_t length);
 CyU3PReturnStatus_t AdiI2CInit(uint32_t BitRate, CyBool_t isDMA);
-uint32_t I2CParseUSBBuffer(uint32_t * timeout, uint32_t * numBytes, CyU3PI2cPreamble_t * preamble);
+uint32_t I2CParseUSBBuffer(uint8_t * buf, uint32_t * timeout, uint32_t * numBytes, CyU3PI2cPreamble_t * preamble);
 
 #endif /* I2CFUNCTIONS_H_ */
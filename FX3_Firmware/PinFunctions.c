@@ -18,12 +18,21 @@
 
 #include "PinFunctions.h"
 
+/* Private function prototypes */
+static CyU3PReturnStatus_t AdiPeriodSendTransfer(uint8_t *buf, uint32_t flags, uint32_t numPeriods, uint32_t length, CyU3PReturnStatus_t status);
+static uint32_t AdiSqrt64(uint64_t value);
+
 /* Tell the compiler where to find the needed globals */
 extern BoardState FX3State;
+extern CommandState CommandThreadState;
 extern CyU3PEvent GpioHandler;
+extern CyU3PDmaChannel ChannelToPC;
 extern uint8_t USBBuffer[4096];
 extern uint8_t BulkBuffer[12288];
 
+/** DMA buffer descriptor for the per-period capture transfers (points into BulkBuffer) */
+static CyU3PDmaBuffer_t PeriodXferBuffer;
+
 /**
   * @brief Gets the programmed board type and pin mapping info
   *
@@ -155,7 +164,7 @@ CyU3PReturnStatus_t AdiSetPinResistor(uint16_t pin, PinResistorSetting setting)
 		return CY_U3P_ERROR_BAD_ARGUMENT;
 
 #ifdef VERBOSE_MODE
-	CyU3PDebugPrint (4, "Starting GPIO Resistor Config for pin: %d with setting: %d\r\n", pin, setting);
+	ADI_LOG("Starting GPIO Resistor Config for pin: %d with setting: %d\r\n", pin, setting);
 #endif
 
 	/* If pin is in lower 32 bits */
@@ -262,7 +271,7 @@ CyBool_t AdiIsValidGPIO(uint16_t GpioId)
 /**
   * @brief Measures the delay from a trigger pin edge (sync) to a busy pin edge.
   *
-  * @param transferLength The amount of data (in bytes) to read from the USB buffer
+  * @param args The request data read from the control endpoint (see AdiCommandQueue)
   *
   * @return A status code indicating the success of the pin delay measure operation
   *
@@ -272,34 +281,24 @@ CyBool_t AdiIsValidGPIO(uint16_t GpioId)
   * intended to be used for measuring the latency between a sync edge and data ready toggle on the
   * ADIS IMU series of products.
  **/
-CyU3PReturnStatus_t AdiMeasurePinDelay(uint16_t transferLength)
+CyU3PReturnStatus_t AdiMeasurePinDelay(uint8_t *args)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-	uint16_t *bytesRead = 0;
 	uint16_t busyPin, triggerPin;
 	CyBool_t busyInitialValue, busyCurrentValue, triggerDrivePolarity, exitCondition;
 	uint32_t currentTime, lastTime, timeout, rollOverCount;
 	CyU3PGpioSimpleConfig_t gpioConfig;
 
-	/* Read config data into USBBuffer */
-	status = CyU3PUsbGetEP0Data(transferLength, USBBuffer, bytesRead);
-	if(status != CY_U3P_SUCCESS)
-	{
-		AdiLogError(PinFunctions_c, __LINE__, status);
-		/* Return error code up - timeout will occur on PC side */
-		return CY_U3P_ERROR_INVALID_SEQUENCE;
-	}
-
 	/* Parse config */
-	triggerPin = USBBuffer[0];
-	triggerPin = triggerPin + (USBBuffer[1] << 8);
-	triggerDrivePolarity = (CyBool_t) USBBuffer[2];
-	busyPin = USBBuffer[3];
-	busyPin = busyPin + (USBBuffer[4] << 8);
-	timeout = USBBuffer[5];
-	timeout = timeout + (USBBuffer[6] << 8);
-	timeout = timeout + (USBBuffer[7] << 16);
-	timeout = timeout + (USBBuffer[8] << 24);
+	triggerPin = args[0];
+	triggerPin = triggerPin + (args[1] << 8);
+	triggerDrivePolarity = (CyBool_t) args[2];
+	busyPin = args[3];
+	busyPin = busyPin + (args[4] << 8);
+	timeout = args[5];
+	timeout = timeout + (args[6] << 8);
+	timeout = timeout + (args[7] << 16);
+	timeout = timeout + (args[8] << 24);
 
 	/* Convert ms to timer ticks */
 	timeout = timeout * MS_TO_TICKS_MULT;
@@ -385,6 +384,9 @@ CyU3PReturnStatus_t AdiMeasurePinDelay(uint16_t transferLength)
 		{
 			exitCondition |= (currentTime >= timeout);
 		}
+
+		/* Stop early if the command was cancelled */
+		exitCondition |= CommandThreadState.Cancel;
 	}
 
 	/*Restore trigger pin GPIO value*/
@@ -393,6 +395,11 @@ CyU3PReturnStatus_t AdiMeasurePinDelay(uint16_t transferLength)
 	else
 		CyU3PGpioSetValue(triggerPin, CyTrue);
 
+	if(CommandThreadState.Cancel)
+	{
+		status = CY_U3P_ERROR_ABORTED;
+	}
+
 	/*Add 0.5us (calibrated using DSLogic Pro)*/
 	if(currentTime < (0xFFFFFFFF - 5))
 	{
@@ -423,7 +430,7 @@ CyU3PReturnStatus_t AdiMeasurePinDelay(uint16_t transferLength)
 /**
   * @brief Sets a user configurable trigger condition and then measures the following GPIO pulse.
   *
-  * @param transferLength The amount of data (in bytes) to read from the USB buffer
+  * @param args The request data read from the control endpoint (see AdiCommandQueue)
   *
   * @return A status code indicating the success of the measure pulse operation
   *
@@ -435,10 +442,9 @@ CyU3PReturnStatus_t AdiMeasurePinDelay(uint16_t transferLength)
   * does limit which pins can perform a busy pulse measurement, if there are PWM signals being driven
   * which also use the complex GPIO block.
  **/
-CyU3PReturnStatus_t AdiMeasureBusyPulse(uint16_t transferLength)
+CyU3PReturnStatus_t AdiMeasureBusyPulse(uint8_t *args)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-	uint16_t *bytesRead = 0;
 	uint8_t * spiBuf;
 	uint16_t busyPin, triggerPin, SpiTriggerWordCount;
 	CyBool_t exitCondition, SpiTriggerMode, busyPolarity, triggerPolarity;
@@ -446,22 +452,14 @@ CyU3PReturnStatus_t AdiMeasureBusyPulse(uint16_t transferLength)
 	CyU3PGpioSimpleConfig_t gpioConfig;
 	CyU3PGpioComplexConfig_t busyPinConfig;
 
-	/* Read config data into USBBuffer */
-	status = CyU3PUsbGetEP0Data(transferLength, USBBuffer, bytesRead);
-	if(status != CY_U3P_SUCCESS)
-	{
-		AdiLogError(PinFunctions_c, __LINE__, status);
-		return status;
-	}
-
-	/* Parse general request data from USBBuffer */
-	busyPin = USBBuffer[0];
-	busyPin |= (USBBuffer[1] << 8);
-	busyPolarity = (CyBool_t) USBBuffer[2];
-	timeout = USBBuffer[3];
-	timeout |= (USBBuffer[4] << 8);
-	timeout |= (USBBuffer[5] << 16);
-	timeout |= (USBBuffer[6] << 24);
+	/* Parse general request data */
+	busyPin = args[0];
+	busyPin |= (args[1] << 8);
+	busyPolarity = (CyBool_t) args[2];
+	timeout = args[3];
+	timeout |= (args[4] << 8);
+	timeout |= (args[5] << 16);
+	timeout |= (args[6] << 24);
 
 	/* Check that busy pin is valid GPIO */
 	if(!AdiIsValidGPIO(busyPin))
@@ -473,7 +471,7 @@ CyU3PReturnStatus_t AdiMeasureBusyPulse(uint16_t transferLength)
 	}
 
 	/* Get the trigger mode */
-	SpiTriggerMode = USBBuffer[7];
+	SpiTriggerMode = args[7];
 
 	/* Convert timeout (in ms) to timer ticks */
 	if((timeout == 0) || (timeout > 426000))
@@ -528,29 +526,36 @@ CyU3PReturnStatus_t AdiMeasureBusyPulse(uint16_t transferLength)
 	if(SpiTriggerMode)
 	{
 		/* Get the SPI trigger word count */
-		SpiTriggerWordCount = USBBuffer[8];
-		SpiTriggerWordCount |= (USBBuffer[9] << 8);
+		SpiTriggerWordCount = args[8];
+		SpiTriggerWordCount |= (args[9] << 8);
 
 		/* Set the SPI buffer */
-		spiBuf = USBBuffer + 10;
+		spiBuf = args + 10;
+
+		/* No trigger pin is driven */
+		triggerPin = 0;
+		triggerPolarity = CyFalse;
+		driveTime = 0;
 
 		/* Transmit the SPI words */
+		AdiSpiLock();
 		CyU3PSpiTransmitWords(spiBuf, SpiTriggerWordCount);
+		AdiSpiUnlock();
 	}
 	else
 	{
-		/* parse parameters from USB Buffer */
-		triggerPin = USBBuffer[8];
-		triggerPin = triggerPin + (USBBuffer[9] << 8);
+		/* parse trigger pin parameters */
+		triggerPin = args[8];
+		triggerPin = triggerPin + (args[9] << 8);
 
 		/* Get drive polarity */
-		triggerPolarity = USBBuffer[10];
+		triggerPolarity = args[10];
 
 		/* Get drive time (in ms) */
-		driveTime = USBBuffer[11];
-		driveTime = driveTime + (USBBuffer[12] << 8);
-		driveTime = driveTime + (USBBuffer[13] << 16);
-		driveTime = driveTime + (USBBuffer[14] << 24);
+		driveTime = args[11];
+		driveTime = driveTime + (args[12] << 8);
+		driveTime = driveTime + (args[13] << 16);
+		driveTime = driveTime + (args[14] << 24);
 
 		/* convert drive time (ms) to ticks */
 		driveTime = driveTime * MS_TO_TICKS_MULT;
@@ -607,7 +612,7 @@ CyU3PReturnStatus_t AdiMeasureBusyPulse(uint16_t transferLength)
 		status = CyU3PGpioComplexWaitForCompletion(busyPin, &result, CyFalse);
 
 		/* update the exit condition */
-		exitCondition = ((currentTime >= timeout) || (status == CY_U3P_SUCCESS));
+		exitCondition = ((currentTime >= timeout) || (status == CY_U3P_SUCCESS) || CommandThreadState.Cancel);
 
 		/* Check if the pin drive can stop */
 		if(!SpiTriggerMode)
@@ -625,6 +630,8 @@ CyU3PReturnStatus_t AdiMeasureBusyPulse(uint16_t transferLength)
 	/* Add 0.1us onto measured time (calibrated using DSLogic Pro) */
 	if(status == CY_U3P_SUCCESS)
 		result += 1;
+	else if(CommandThreadState.Cancel)
+		status = CY_U3P_ERROR_ABORTED;
 
 	/* Reset busy pin to simple input */
 	gpioConfig.outValue = CyFalse;
@@ -697,7 +704,7 @@ CyU3PReturnStatus_t AdiConfigurePWM(CyBool_t EnablePWM)
 		threshold |= (USBBuffer[9] << 24);
 
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "Setting up PWM with period %d, threshold %d, for pin %d\r\n", period, threshold, pinNumber);
+		ADI_LOG("Setting up PWM with period %d, threshold %d, for pin %d\r\n", period, threshold, pinNumber);
 #endif
 
 		/* Override the selected pin to run as a complex GPIO */
@@ -770,41 +777,49 @@ CyU3PReturnStatus_t AdiConfigurePWM(CyBool_t EnablePWM)
 /**
   * @brief This function drives a GPIO pin for a specified number of milliseconds, then returns it to the starting polarity.
   *
+  * @param args The request data read from the control endpoint (see AdiCommandQueue)
+  *
   * @return A status code indicating the success of the function.
   *
   * If the selected GPIO pin is not configured as an output, this function configures the pin. If you want the pin to stay at a
-  * given logic level, use AdiSetPin() instead. The arguments to this function are passed in through USBBuffer.
+  * given logic level, use AdiSetPin() instead. The arguments to this function are passed in through args.
   * pin: The GPIO pin number to drive
   * polarity: The polarity of the pin (True - High, False - Low)
   * driveTime: The number of milliseconds to drive the pin for
  **/
-CyU3PReturnStatus_t AdiPulseDrive()
+CyU3PReturnStatus_t AdiPulseDrive(uint8_t *args)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 	uint16_t pinNumber;
 	CyBool_t polarity, exit;
 	uint32_t timerTicks, timerRollovers, rolloverCount, currentTime, lastTime;
 
-	/* Parse request data from USBBuffer */
-	pinNumber = USBBuffer[0];
-	pinNumber = pinNumber + (USBBuffer[1] << 8);
-	polarity = (CyBool_t) USBBuffer[2];
-	timerTicks = USBBuffer[3];
-	timerTicks = timerTicks + (USBBuffer[4] << 8);
-	timerTicks = timerTicks + (USBBuffer[5] << 16);
-	timerTicks = timerTicks + (USBBuffer[6] << 24);
-	timerRollovers = USBBuffer[7];
-	timerRollovers = timerRollovers + (USBBuffer[8] << 8);
-	timerRollovers = timerRollovers + (USBBuffer[9] << 16);
-	timerRollovers = timerRollovers + (USBBuffer[10] << 24);
+	/* Parse request data */
+	pinNumber = args[0];
+	pinNumber = pinNumber + (args[1] << 8);
+	polarity = (CyBool_t) args[2];
+	timerTicks = args[3];
+	timerTicks = timerTicks + (args[4] << 8);
+	timerTicks = timerTicks + (args[5] << 16);
+	timerTicks = timerTicks + (args[6] << 24);
+	timerRollovers = args[7];
+	timerRollovers = timerRollovers + (args[8] << 8);
+	timerRollovers = timerRollovers + (args[9] << 16);
+	timerRollovers = timerRollovers + (args[10] << 24);
 
 	/*Verify the pin number */
 	if(!AdiIsValidGPIO(pinNumber))
 	{
-		CyU3PDebugPrint (4, "Error! Invalid GPIO pin number: %d\r\n", pinNumber);
+		ADI_LOG("Error! Invalid GPIO pin number: %d\r\n", pinNumber);
 		return CY_U3P_ERROR_BAD_ARGUMENT;
 	}
 
+	/* Pulsing the reset pin resets the DUT page */
+	if(pinNumber == FX3State.PinMap.ADI_PIN_RESET)
+	{
+		AdiInvalidatePageCache();
+	}
+
 	/* Configure the GPIO pin as a driven output */
 	CyU3PGpioSimpleConfig_t gpioConfig;
 	gpioConfig.outValue = polarity;
@@ -881,10 +896,9 @@ CyU3PReturnStatus_t AdiPulseDrive()
 }
 
 /**
-  * @brief This function waits for a pin to reach a selected logic level. The PulseWait parameters
-  * are passed in the USB buffer, and are retrieved with a call to GetEP0Data.
+  * @brief This function waits for a pin to reach a selected logic level.
   *
-  * @param transferLength How many bytes to read from the USBBuffer.
+  * @param args The request data read from the control endpoint (see AdiCommandQueue)
   *
   * @return A status code indicating the success of the function.
   *
@@ -896,11 +910,10 @@ CyU3PReturnStatus_t AdiPulseDrive()
   * delay is the wait time (in ms) from when the function starts before pin polling starts
   * timeout is the time (in ms) to wait for the pin level before exiting
  **/
-CyU3PReturnStatus_t AdiPulseWait(uint16_t transferLength)
+CyU3PReturnStatus_t AdiPulseWait(uint8_t *args)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 	uint16_t pin;
-    uint16_t *bytesRead = 0;
 	CyBool_t polarity, pinValue, exitCondition;
 	uint32_t currentTime, lastTime, delay, timeoutTicks, timeoutRollover, rollOverCount;
 
@@ -911,25 +924,22 @@ CyU3PReturnStatus_t AdiPulseWait(uint16_t transferLength)
 	/* Reset the pin timer register to 0 */
 	GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].timer = 0;
 
-	/* Read config data into USBBuffer */
-	CyU3PUsbGetEP0Data(transferLength, USBBuffer, bytesRead);
-
-	/* Parse request data from USBBuffer */
-	pin = USBBuffer[0];
-	pin = pin + (USBBuffer[1] << 8);
-	polarity = (CyBool_t) USBBuffer[2];
-	delay = USBBuffer[3];
-	delay = delay + (USBBuffer[4] << 8);
-	delay = delay + (USBBuffer[5] << 16);
-	delay = delay + (USBBuffer[6] << 24);
-	timeoutTicks = USBBuffer[7];
-	timeoutTicks = timeoutTicks + (USBBuffer[8] << 8);
-	timeoutTicks = timeoutTicks + (USBBuffer[9] << 16);
-	timeoutTicks = timeoutTicks + (USBBuffer[10] << 24);
-	timeoutRollover = USBBuffer[11];
-	timeoutRollover = timeoutRollover + (USBBuffer[12] << 8);
-	timeoutRollover = timeoutRollover + (USBBuffer[13] << 16);
-	timeoutRollover = timeoutRollover + (USBBuffer[14] << 24);
+	/* Parse request data */
+	pin = args[0];
+	pin = pin + (args[1] << 8);
+	polarity = (CyBool_t) args[2];
+	delay = args[3];
+	delay = delay + (args[4] << 8);
+	delay = delay + (args[5] << 16);
+	delay = delay + (args[6] << 24);
+	timeoutTicks = args[7];
+	timeoutTicks = timeoutTicks + (args[8] << 8);
+	timeoutTicks = timeoutTicks + (args[9] << 16);
+	timeoutTicks = timeoutTicks + (args[10] << 24);
+	timeoutRollover = args[11];
+	timeoutRollover = timeoutRollover + (args[12] << 8);
+	timeoutRollover = timeoutRollover + (args[13] << 16);
+	timeoutRollover = timeoutRollover + (args[14] << 24);
 
 	/* Convert ms to timer ticks */
 	delay = delay * MS_TO_TICKS_MULT;
@@ -966,7 +976,7 @@ CyU3PReturnStatus_t AdiPulseWait(uint16_t transferLength)
 	exitCondition = CyFalse;
 	if(delay > 0)
 	{
-		while(currentTime < delay)
+		while((currentTime < delay) && !CommandThreadState.Cancel)
 		{
 			/* Set the pin config for sample now mode */
 			GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status = (FX3State.TimerPinConfig | (CY_U3P_GPIO_MODE_SAMPLE_NOW << CY_U3P_LPP_GPIO_MODE_POS));
@@ -1002,6 +1012,12 @@ CyU3PReturnStatus_t AdiPulseWait(uint16_t transferLength)
 		/* update the exit condition (will always have valid timeout)
 		 * exits when pin reaches the desired polarity or timer reaches timeout */
 		exitCondition = ((pinValue == polarity) || ((currentTime >= timeoutTicks) && (rollOverCount >= timeoutRollover)));
+		exitCondition |= CommandThreadState.Cancel;
+	}
+
+	if(CommandThreadState.Cancel)
+	{
+		status = CY_U3P_ERROR_ABORTED;
 	}
 
 	/* Catch potential out of bounds status code */
@@ -1053,9 +1069,15 @@ CyU3PReturnStatus_t AdiSetPin(uint16_t pinNumber, CyBool_t polarity)
 		polarity = CyFalse;
 
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "Setting pin %d to %d\r\n", pinNumber, polarity);
+		ADI_LOG("Setting pin %d to %d\r\n", pinNumber, polarity);
 #endif
 
+	/* Driving the reset pin resets the DUT page */
+	if(pinNumber == FX3State.PinMap.ADI_PIN_RESET)
+	{
+		AdiInvalidatePageCache();
+	}
+
 	/* Configure pin as output and set the drive value */
 	CyU3PGpioSimpleConfig_t gpioConfig;
 	gpioConfig.outValue = polarity;
@@ -1183,7 +1205,7 @@ CyU3PReturnStatus_t AdiPinRead(uint16_t pin)
 	}
 
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "Pin %d value: %d\r\n", pin, pinValue);
+		ADI_LOG("Pin %d value: %d\r\n", pin, pinValue);
 #endif
 
 	/* Put pin register value in output buffer */
@@ -1239,6 +1261,8 @@ CyU3PReturnStatus_t AdiReadTimerValue()
 /**
   * @brief Measure the data ready frequency for a user specified pin
   *
+  * @param args The request data read from the control endpoint (see AdiCommandQueue)
+  *
   * @return The status of the pin drive operation
   *
   * This function measures two data ready pulses on a user-specified pin and reports
@@ -1251,27 +1275,27 @@ CyU3PReturnStatus_t AdiReadTimerValue()
   * polarity: The polarity of the pin (1 - Low-to-High, 0 - High-to-Low)
   * timeoutInMs: The specified timeout in milliseconds
  **/
-CyU3PReturnStatus_t AdiMeasurePinFreq()
+CyU3PReturnStatus_t AdiMeasurePinFreq(uint8_t *args)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 	CyBool_t polarity, timeoutOccurred, interruptTriggered, exitCondition;
 	uint16_t pin, numPeriods, periodCount;
 	uint32_t timeoutTicks, timeoutRollovers, currentTime, lastTime, rollovers;
 
-	/* Parse data from the USB Buffer */
-	pin = USBBuffer[0];
-	pin |= (USBBuffer[1] << 8);
-	polarity = USBBuffer[2];
-	timeoutTicks = USBBuffer[3];
-	timeoutTicks |= (USBBuffer[4] << 8);
-	timeoutTicks |= (USBBuffer[5] << 16);
-	timeoutTicks |= (USBBuffer[6] << 24);
-	timeoutRollovers = USBBuffer[7];
-	timeoutRollovers |= (USBBuffer[8] << 8);
-	timeoutRollovers |= (USBBuffer[9] << 16);
-	timeoutRollovers |= (USBBuffer[10] << 24);
-	numPeriods = USBBuffer[11];
-	numPeriods |= (USBBuffer[12] << 8);
+	/* Parse the request data */
+	pin = args[0];
+	pin |= (args[1] << 8);
+	polarity = args[2];
+	timeoutTicks = args[3];
+	timeoutTicks |= (args[4] << 8);
+	timeoutTicks |= (args[5] << 16);
+	timeoutTicks |= (args[6] << 24);
+	timeoutRollovers = args[7];
+	timeoutRollovers |= (args[8] << 8);
+	timeoutRollovers |= (args[9] << 16);
+	timeoutRollovers |= (args[10] << 24);
+	numPeriods = args[11];
+	numPeriods |= (args[12] << 8);
 
 	/* Disable relevant interrupts */
 	CyU3PVicDisableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
@@ -1323,7 +1347,7 @@ CyU3PReturnStatus_t AdiMeasurePinFreq()
 			}
 
 			/* Determine if a timeout has occurred */
-			timeoutOccurred = (currentTime >= timeoutTicks) && (rollovers >= timeoutRollovers);
+			timeoutOccurred = ((currentTime >= timeoutTicks) && (rollovers >= timeoutRollovers)) || CommandThreadState.Cancel;
 		}
 	}
 
@@ -1364,7 +1388,7 @@ CyU3PReturnStatus_t AdiMeasurePinFreq()
 		}
 
 		/* Determine if a timeout has occurred */
-		timeoutOccurred = (currentTime >= timeoutTicks) && (rollovers >= timeoutRollovers);
+		timeoutOccurred = ((currentTime >= timeoutTicks) && (rollovers >= timeoutRollovers)) || CommandThreadState.Cancel;
 
 		/* Determine the exit condition */
 		exitCondition = timeoutOccurred || (periodCount >= numPeriods);
@@ -1386,6 +1410,10 @@ CyU3PReturnStatus_t AdiMeasurePinFreq()
 	{
 		status = CY_U3P_ERROR_TIMEOUT;
 	}
+	if(CommandThreadState.Cancel)
+	{
+		status = CY_U3P_ERROR_ABORTED;
+	}
 
 	/* Disable interrupt mode on the pin */
 	CyU3PGpioSimpleConfig_t gpioConfig;
@@ -1417,6 +1445,403 @@ CyU3PReturnStatus_t AdiMeasurePinFreq()
 	return status;
 }
 
+/**
+  * @brief Records the period between every edge on a user specified pin, with on-device jitter statistics
+  *
+  * @param args The request data read from the control endpoint (see AdiCommandQueue)
+  *
+  * @return The status of the capture
+  *
+  * The request data is little endian: pin[0-1], polarity[2] (1 - Low-to-High,
+  * 0 - High-to-Low), timeout ticks[3-6] and timeout rollovers[7-10] (as ADI_MEASURE_DR, but for the whole capture),
+  * number of periods[11-14], histogram bin width in ticks[15-16] (0 is 1 tick) and options[17] (ADI_PERIOD_OPTION_*).
+  * Each edge is time stamped with the 10MHz complex GPIO timer, and the period since the previous edge is added to
+  * the statistics and stored as a raw 32-bit tick count.
+  *
+  * Results are sent on the bulk endpoint. Every transfer starts with status[0-3], flags[4-7] (ADI_PERIOD_XFER_*) and
+  * the number of raw periods in the transfer[8-11], followed by the raw periods. The last transfer then has the summary
+  * (ADI_PERIOD_SUMMARY_BYTES), as 32-bit words: periods measured, raw periods returned, raw periods dropped, min, max,
+  * mean and standard deviation (both in 1/256 tick units), histogram start and bin width (ticks), then the
+  * ADI_PERIOD_HIST_BINS histogram counts. The histogram is centered on the first period measured, and periods outside
+  * it are counted in the first or last bin.
+  *
+  * By default there is a single transfer, which holds as many raw periods as fit in BulkBuffer. With
+  * ADI_PERIOD_OPTION_STREAM set, BulkBuffer is split in two halves of ADI_PERIOD_CHUNK_BYTES, and each full half is
+  * sent as soon as it is filled while the other half is filled, so the PC should keep reading ADI_PERIOD_CHUNK_BYTES
+  * transfers until one is flagged as the last. If the PC has not read the previous chunk by the time the next one is
+  * full, raw periods are dropped until it has (the statistics still include them). The chunk is sent right after an
+  * edge is recorded, so the send does not delay the next time stamp.
+ **/
+CyU3PReturnStatus_t AdiMeasurePinPeriods(uint8_t *args)
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	CyBool_t polarity, streamMode, sawEdge;
+	uint16_t pin, binWidth;
+	uint32_t numPeriods, periodCount, rawCount, rawReturned, rawDropped, chunkPeriods, flags;
+	uint32_t currentTime, lastTime, edgeTime, period, firstPeriod, minPeriod, maxPeriod, histStart, bin;
+	uint32_t index, value, offset;
+	uint32_t summary[9];
+	uint32_t histogram[ADI_PERIOD_HIST_BINS];
+	uint64_t elapsed, timeout, sumSqDev, varianceQ16;
+	int64_t sumDev, meanQ8;
+	int32_t deviation;
+	uint8_t *xferBuf;
+
+	/* Parse the request data */
+	pin = args[0];
+	pin |= (args[1] << 8);
+	polarity = args[2];
+	timeout = args[3];
+	timeout |= (args[4] << 8);
+	timeout |= (args[5] << 16);
+	timeout |= ((uint32_t) args[6] << 24);
+	value = args[7];
+	value |= (args[8] << 8);
+	value |= (args[9] << 16);
+	value |= (args[10] << 24);
+	timeout |= ((uint64_t) value << 32);
+	numPeriods = args[11];
+	numPeriods |= (args[12] << 8);
+	numPeriods |= (args[13] << 16);
+	numPeriods |= (args[14] << 24);
+	binWidth = args[15];
+	binWidth |= (args[16] << 8);
+	streamMode = (CyBool_t) ((args[17] & ADI_PERIOD_OPTION_STREAM) != 0);
+
+	if(binWidth == 0)
+	{
+		binWidth = 1;
+	}
+	if(streamMode)
+	{
+		chunkPeriods = (ADI_PERIOD_CHUNK_BYTES - ADI_PERIOD_HEADER_BYTES) / 4;
+	}
+	else
+	{
+		chunkPeriods = (sizeof(BulkBuffer) - ADI_PERIOD_HEADER_BYTES - ADI_PERIOD_SUMMARY_BYTES) / 4;
+	}
+
+	/* Clear the results */
+	periodCount = 0;
+	rawCount = 0;
+	rawReturned = 0;
+	rawDropped = 0;
+	firstPeriod = 0;
+	minPeriod = 0xFFFFFFFF;
+	maxPeriod = 0;
+	histStart = 0;
+	sumDev = 0;
+	sumSqDev = 0;
+	for(index = 0; index < ADI_PERIOD_HIST_BINS; index++)
+	{
+		histogram[index] = 0;
+	}
+	xferBuf = BulkBuffer;
+
+	if(numPeriods == 0)
+	{
+		status = CY_U3P_ERROR_BAD_ARGUMENT;
+	}
+
+	/* Disable relevant interrupts */
+	CyU3PVicDisableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+	CyU3PVicDisableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+
+	/* Configure pin as an input, with interrupts set on the desired polarity */
+	if(status == CY_U3P_SUCCESS)
+	{
+		status = AdiConfigurePinInterrupt(pin, polarity);
+	}
+
+	if(status == CY_U3P_SUCCESS)
+	{
+		/* Free run the timer over the full 32 bit range, so periods survive a rollover */
+		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status &= ~(CY_U3P_LPP_GPIO_INTRMODE_MASK);
+		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].period = 0xFFFFFFFF;
+
+		/* Clear any edge seen before the capture started */
+		GPIO->lpp_gpio_simple[pin] |= CY_U3P_LPP_GPIO_INTR;
+
+		elapsed = 0;
+		edgeTime = 0;
+		sawEdge = CyFalse;
+		lastTime = AdiReadTimerRegValue();
+		while(periodCount < numPeriods)
+		{
+			currentTime = AdiReadTimerRegValue();
+			elapsed += (currentTime - lastTime);
+			lastTime = currentTime;
+
+			if(!(GPIO->lpp_gpio_intr0 & (1 << pin)))
+			{
+				if(elapsed >= timeout)
+				{
+					status = CY_U3P_ERROR_TIMEOUT;
+					break;
+				}
+				if(CommandThreadState.Cancel)
+				{
+					status = CY_U3P_ERROR_ABORTED;
+					break;
+				}
+				continue;
+			}
+
+			/* Time stamp the edge and clear the interrupt bit */
+			GPIO->lpp_gpio_simple[pin] |= CY_U3P_LPP_GPIO_INTR;
+			period = currentTime - edgeTime;
+			edgeTime = currentTime;
+			if(!sawEdge)
+			{
+				/* First edge only starts the first period */
+				sawEdge = CyTrue;
+				continue;
+			}
+
+			/* Statistics. Deviations are from the first period, which keeps the sums small */
+			if(periodCount == 0)
+			{
+				firstPeriod = period;
+				if(firstPeriod > ((ADI_PERIOD_HIST_BINS / 2) * binWidth))
+				{
+					histStart = firstPeriod - ((ADI_PERIOD_HIST_BINS / 2) * binWidth);
+				}
+			}
+			periodCount++;
+			if(period < minPeriod)
+			{
+				minPeriod = period;
+			}
+			if(period > maxPeriod)
+			{
+				maxPeriod = period;
+			}
+			deviation = (int32_t) (period - firstPeriod);
+			sumDev += deviation;
+			sumSqDev += (uint64_t) ((int64_t) deviation * deviation);
+			bin = 0;
+			if(period > histStart)
+			{
+				bin = (period - histStart) / binWidth;
+				if(bin >= ADI_PERIOD_HIST_BINS)
+				{
+					bin = ADI_PERIOD_HIST_BINS - 1;
+				}
+			}
+			histogram[bin]++;
+
+			/* Send the full chunk, if the PC has read the previous one */
+			if(streamMode && (rawCount == chunkPeriods))
+			{
+				if(CyU3PDmaChannelWaitForCompletion(&ChannelToPC, CYU3P_NO_WAIT) == CY_U3P_SUCCESS)
+				{
+					flags = (rawDropped != 0) ? ADI_PERIOD_XFER_DROPPED : 0;
+					AdiPeriodSendTransfer(xferBuf, flags, rawCount, ADI_PERIOD_HEADER_BYTES + (rawCount * 4), CY_U3P_SUCCESS);
+					rawReturned += rawCount;
+					rawCount = 0;
+					xferBuf = (xferBuf == BulkBuffer) ? (BulkBuffer + ADI_PERIOD_CHUNK_BYTES) : BulkBuffer;
+				}
+			}
+
+			/* Store the raw period */
+			if(rawCount < chunkPeriods)
+			{
+				offset = ADI_PERIOD_HEADER_BYTES + (rawCount * 4);
+				xferBuf[offset] = period & 0xFF;
+				xferBuf[offset + 1] = (period & 0xFF00) >> 8;
+				xferBuf[offset + 2] = (period & 0xFF0000) >> 16;
+				xferBuf[offset + 3] = (period & 0xFF000000) >> 24;
+				rawCount++;
+			}
+			else
+			{
+				rawDropped++;
+			}
+		}
+	}
+
+	/* Disable interrupt mode on the pin */
+	CyU3PGpioSimpleConfig_t gpioConfig;
+	gpioConfig.outValue = CyTrue;
+	gpioConfig.inputEn = CyTrue;
+	gpioConfig.driveLowEn = CyFalse;
+	gpioConfig.driveHighEn = CyFalse;
+	gpioConfig.intrMode = CY_U3P_GPIO_NO_INTR;
+	CyU3PGpioSetSimpleConfig(pin, &gpioConfig);
+
+	/* Re-enable relevant ISRs */
+	CyU3PVicEnableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+	CyU3PVicEnableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+
+	flags = (rawDropped != 0) ? ADI_PERIOD_XFER_DROPPED : 0;
+	if(streamMode)
+	{
+		/* Wait for the last chunk to be read before reusing the channel */
+		if(CyU3PDmaChannelWaitForCompletion(&ChannelToPC, ADI_PERIOD_SEND_TIMEOUT_MS) != CY_U3P_SUCCESS)
+		{
+			AdiLogError(PinFunctions_c, __LINE__, CY_U3P_ERROR_TIMEOUT);
+		}
+
+		/* The summary has to fit after the raw periods, so send a full half on its own first */
+		if((ADI_PERIOD_HEADER_BYTES + (rawCount * 4) + ADI_PERIOD_SUMMARY_BYTES) > ADI_PERIOD_CHUNK_BYTES)
+		{
+			AdiPeriodSendTransfer(xferBuf, flags, rawCount, ADI_PERIOD_HEADER_BYTES + (rawCount * 4), status);
+			rawReturned += rawCount;
+			rawCount = 0;
+			xferBuf = (xferBuf == BulkBuffer) ? (BulkBuffer + ADI_PERIOD_CHUNK_BYTES) : BulkBuffer;
+			if(CyU3PDmaChannelWaitForCompletion(&ChannelToPC, ADI_PERIOD_SEND_TIMEOUT_MS) != CY_U3P_SUCCESS)
+			{
+				AdiLogError(PinFunctions_c, __LINE__, CY_U3P_ERROR_TIMEOUT);
+			}
+		}
+	}
+	rawReturned += rawCount;
+
+	/* Mean and standard deviation, from the sums of the deviations from the first period */
+	meanQ8 = 0;
+	varianceQ16 = 0;
+	if(periodCount)
+	{
+		meanQ8 = ((int64_t) firstPeriod * 256) + ((sumDev * 256) / (int64_t) periodCount);
+		if(meanQ8 < 0)
+		{
+			meanQ8 = 0;
+		}
+		else if(meanQ8 > 0xFFFFFFFF)
+		{
+			meanQ8 = 0xFFFFFFFF;
+		}
+		/* E[d^2] - E[d]^2, in 1/65536 tick^2 units */
+		varianceQ16 = ((sumSqDev / periodCount) << 16) + (((sumSqDev % periodCount) << 16) / periodCount);
+		value = (uint32_t) ((((sumDev < 0) ? -sumDev : sumDev) << 8) / (int64_t) periodCount);
+		if(varianceQ16 > ((uint64_t) value * value))
+		{
+			varianceQ16 -= ((uint64_t) value * value);
+		}
+		else
+		{
+			varianceQ16 = 0;
+		}
+	}
+	else
+	{
+		minPeriod = 0;
+	}
+
+	summary[0] = periodCount;
+	summary[1] = rawReturned;
+	summary[2] = rawDropped;
+	summary[3] = minPeriod;
+	summary[4] = maxPeriod;
+	summary[5] = (uint32_t) meanQ8;
+	summary[6] = AdiSqrt64(varianceQ16);
+	summary[7] = histStart;
+	summary[8] = binWidth;
+
+	offset = ADI_PERIOD_HEADER_BYTES + (rawCount * 4);
+	for(index = 0; index < (9 + ADI_PERIOD_HIST_BINS); index++)
+	{
+		if(index < 9)
+		{
+			value = summary[index];
+		}
+		else
+		{
+			value = histogram[index - 9];
+		}
+		xferBuf[offset] = value & 0xFF;
+		xferBuf[offset + 1] = (value & 0xFF00) >> 8;
+		xferBuf[offset + 2] = (value & 0xFF0000) >> 16;
+		xferBuf[offset + 3] = (value & 0xFF000000) >> 24;
+		offset += 4;
+	}
+
+#ifdef VERBOSE_MODE
+	ADI_LOG("Period capture: %d periods, %d dropped, min %d, max %d, status 0x%x\r\n", periodCount, rawDropped, minPeriod, maxPeriod, status);
+#endif
+
+	/* Send the last transfer to the PC */
+	AdiPeriodSendTransfer(xferBuf, flags | ADI_PERIOD_XFER_LAST, rawCount, offset, status);
+
+	return status;
+}
+
+/**
+  * @brief Sends one per-period capture transfer on the bulk endpoint
+  *
+  * @param buf The transfer buffer (BulkBuffer or its second half). The header is written at buf[0-11].
+  *
+  * @param flags The transfer flags (ADI_PERIOD_XFER_*)
+  *
+  * @param numPeriods The number of raw periods in the transfer
+  *
+  * @param length The total transfer length, in bytes
+  *
+  * @param status The status code to place in the transfer header
+  *
+  * @return The status of the DMA send
+ **/
+static CyU3PReturnStatus_t AdiPeriodSendTransfer(uint8_t *buf, uint32_t flags, uint32_t numPeriods, uint32_t length, CyU3PReturnStatus_t status)
+{
+	CyU3PReturnStatus_t sendStatus;
+
+	buf[0] = status & 0xFF;
+	buf[1] = (status & 0xFF00) >> 8;
+	buf[2] = (status & 0xFF0000) >> 16;
+	buf[3] = (status & 0xFF000000) >> 24;
+	buf[4] = flags & 0xFF;
+	buf[5] = (flags & 0xFF00) >> 8;
+	buf[6] = (flags & 0xFF0000) >> 16;
+	buf[7] = (flags & 0xFF000000) >> 24;
+	buf[8] = numPeriods & 0xFF;
+	buf[9] = (numPeriods & 0xFF00) >> 8;
+	buf[10] = (numPeriods & 0xFF0000) >> 16;
+	buf[11] = (numPeriods & 0xFF000000) >> 24;
+
+	PeriodXferBuffer.buffer = buf;
+	PeriodXferBuffer.size = (buf == BulkBuffer) ? sizeof(BulkBuffer) : ADI_PERIOD_CHUNK_BYTES;
+	PeriodXferBuffer.count = length;
+	PeriodXferBuffer.status = 0;
+	sendStatus = CyU3PDmaChannelSetupSendBuffer(&ChannelToPC, &PeriodXferBuffer);
+	if(sendStatus != CY_U3P_SUCCESS)
+	{
+		AdiLogError(PinFunctions_c, __LINE__, sendStatus);
+	}
+	return sendStatus;
+}
+
+/**
+  * @brief Integer square root, rounded down
+  *
+  * @param value The value to take the square root of
+  *
+  * @return The square root of value
+ **/
+static uint32_t AdiSqrt64(uint64_t value)
+{
+	uint64_t result = 0;
+	uint64_t bit = (uint64_t) 1 << 62;
+
+	while(bit > value)
+	{
+		bit >>= 2;
+	}
+	while(bit != 0)
+	{
+		if(value >= (result + bit))
+		{
+			value -= (result + bit);
+			result = (result >> 1) + bit;
+		}
+		else
+		{
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (uint32_t) result;
+}
+
 /**
   * @brief configures the selected pin as an interrupt with edge triggering based on polarity
   *
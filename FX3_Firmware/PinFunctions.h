@@ -50,17 +50,18 @@ typedef enum PinState
 }PinState;
 
 /* Function definitions */
-CyU3PReturnStatus_t AdiPulseDrive();
-CyU3PReturnStatus_t AdiPulseWait(uint16_t transferLength);
+CyU3PReturnStatus_t AdiPulseDrive(uint8_t *args);
+CyU3PReturnStatus_t AdiPulseWait(uint8_t *args);
 CyU3PReturnStatus_t AdiSetPin(uint16_t pinNumber, CyBool_t polarity);
-CyU3PReturnStatus_t AdiMeasurePinFreq();
+CyU3PReturnStatus_t AdiMeasurePinFreq(uint8_t *args);
+CyU3PReturnStatus_t AdiMeasurePinPeriods(uint8_t *args);
 CyU3PReturnStatus_t AdiWaitForPin(uint32_t pinNumber, CyU3PGpioIntrMode_t interruptSetting, uint32_t timeoutTicks);
 CyU3PReturnStatus_t AdiPinRead(uint16_t pin);
 CyU3PReturnStatus_t AdiReadTimerValue();
 CyU3PReturnStatus_t AdiConfigurePWM(CyBool_t EnablePWM);
-CyU3PReturnStatus_t AdiMeasureBusyPulse(uint16_t transferLength);
+CyU3PReturnStatus_t AdiMeasureBusyPulse(uint8_t *args);
 CyU3PReturnStatus_t AdiConfigurePinInterrupt(uint16_t pin, CyBool_t polarity);
-CyU3PReturnStatus_t AdiMeasurePinDelay(uint16_t transferLength);
+CyU3PReturnStatus_t AdiMeasurePinDelay(uint8_t *args);
 CyU3PReturnStatus_t AdiSetPinResistor(uint16_t pin, PinResistorSetting setting);
 uint32_t AdiMStoTicks(uint32_t desiredStallTime);
 uint32_t AdiReadTimerRegValue();
@@ -130,4 +131,32 @@ void AdiGetBoardPinInfo(uint8_t * outBuf);
 /** Event flag indicating a GPIO interrupt has triggered on FX3_GPIO4 */
 #define FX3_GPIO4_INTERRUPT_FLAG					(1 << 7)
 
+/*
+ * Per-period edge capture (ADI_MEASURE_DR_PERIODS) definitions
+ */
+
+/** Option bit: send the raw periods in chunks while the capture runs, instead of only the periods which fit in BulkBuffer */
+#define ADI_PERIOD_OPTION_STREAM				(1 << 0)
+
+/** Transfer flag: this is the last transfer of the capture, and carries the summary */
+#define ADI_PERIOD_XFER_LAST					(1 << 0)
+
+/** Transfer flag: raw periods were dropped (BulkBuffer full, or the PC did not read a chunk in time) */
+#define ADI_PERIOD_XFER_DROPPED					(1 << 1)
+
+/** Transfer header size (status, flags, period count) */
+#define ADI_PERIOD_HEADER_BYTES					(12)
+
+/** Number of histogram bins in the capture summary */
+#define ADI_PERIOD_HIST_BINS					(32)
+
+/** Capture summary size (9 words, then the histogram) */
+#define ADI_PERIOD_SUMMARY_BYTES				(36 + (4 * ADI_PERIOD_HIST_BINS))
+
+/** Size of each half of BulkBuffer used for the chunked transfers */
+#define ADI_PERIOD_CHUNK_BYTES					(6144)
+
+/** Time to wait for the PC to read the previous chunk before sending the last transfer, in ms */
+#define ADI_PERIOD_SEND_TIMEOUT_MS				(2000)
+
 #endif
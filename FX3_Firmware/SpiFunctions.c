@@ -22,14 +22,20 @@
 static void AdiBitBangSpiTransfer(uint8_t * MOSI, uint8_t* MISO, uint32_t BitCount, BitBangSpiConf config);
 static CyU3PReturnStatus_t AdiBitBangSpiSetup(BitBangSpiConf config);
 static void AdiWaitForSpiNotBusy();
+static CyBool_t AdiSpiTakeOwnership();
 
 /* Tell the compiler where to find the needed globals */
 extern BoardState FX3State;
 extern StreamState StreamThreadState;
+extern CommandState CommandThreadState;
 extern CyU3PDmaBuffer_t ManualDMABuffer;
 extern CyU3PDmaChannel ChannelToPC;
 extern uint8_t USBBuffer[4096];
 extern uint8_t BulkBuffer[12288];
+extern CyU3PMutex SpiMutex;
+
+/** Thread which made the last DUT access (see AdiSpiLock) */
+static CyU3PThread *SpiOwner = NULL;
 
 /** Pointer to bit bang SPI SCLK pin */
 static uvint32_t *SCLKPin;
@@ -172,6 +178,7 @@ CyU3PReturnStatus_t AdiRestartSpi()
 {
 	/* Status code for SPI init */
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	AdiSpiLock();
 	/* Deactivate SPI controller */
 	CyU3PSpiDeInit();
 	/* Restore pins */
@@ -183,6 +190,7 @@ CyU3PReturnStatus_t AdiRestartSpi()
 	CyU3PSpiInit();
 	/* Set the prior config */
 	status = CyU3PSpiSetConfig(&FX3State.SpiConfig, NULL);
+	AdiSpiUnlock();
 	if(status != CY_U3P_SUCCESS)
 	{
 		AdiLogError(SpiFunctions_c, __LINE__, status);
@@ -194,6 +202,8 @@ CyU3PReturnStatus_t AdiRestartSpi()
 /**
   * @brief This function handles bit bang SPI requests from the control endpoint.
   *
+  * @param args The request data read from the control endpoint (see AdiCommandQueue)
+  *
   * @returns A status code indicating the success of the SPI bitbang operation.
   *
   * This function requires all data to have been retrieved from the control endpoint before being
@@ -201,7 +211,7 @@ CyU3PReturnStatus_t AdiRestartSpi()
   * the transaction. The pins/timing/config is sent from the FX3 API to the firmware with each
   * bitbang SPI transaction.
  **/
-CyU3PReturnStatus_t AdiBitBangSpiHandler()
+CyU3PReturnStatus_t AdiBitBangSpiHandler(uint8_t *args)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 	BitBangSpiConf config;
@@ -215,31 +225,34 @@ CyU3PReturnStatus_t AdiBitBangSpiHandler()
 	uint8_t * MOSIPtr;
 	uint8_t * MISOPtr;
 
-	/* Parse data from the USB buffer */
-	config.SCLK = USBBuffer[0];
-	config.CS = USBBuffer[1];
-	config.MOSI = USBBuffer[2];
-	config.MISO = USBBuffer[3];
-	config.HalfClockDelay = USBBuffer[4];
-	config.HalfClockDelay |= (USBBuffer[5] << 8);
-	config.HalfClockDelay |= (USBBuffer[6] << 16);
-	config.HalfClockDelay |= (USBBuffer[7] << 24);
-	config.CSLeadDelay = USBBuffer[8];
-	config.CSLeadDelay |= (USBBuffer[9] << 8);
-	config.CSLagDelay = USBBuffer[10];
-	config.CSLagDelay |= (USBBuffer[11] << 8);
-	bitBangStallTime = USBBuffer[12];
-	bitBangStallTime |= (USBBuffer[13] << 8);
-	bitBangStallTime |= (USBBuffer[14] << 16);
-	bitBangStallTime |= (USBBuffer[15] << 24);
-	bitsPerTransfer = USBBuffer[16];
-	bitsPerTransfer |= (USBBuffer[17] << 8);
-	bitsPerTransfer |= (USBBuffer[18] << 16);
-	bitsPerTransfer |= (USBBuffer[19] << 24);
-	numTransfers = USBBuffer[20];
-	numTransfers |= (USBBuffer[21] << 8);
-	numTransfers |= (USBBuffer[22] << 16);
-	numTransfers |= (USBBuffer[23] << 24);
+	/* The bit bang transfers are not decoded, so the DUT page is no longer known */
+	AdiInvalidatePageCache();
+
+	/* Parse the request data */
+	config.SCLK = args[0];
+	config.CS = args[1];
+	config.MOSI = args[2];
+	config.MISO = args[3];
+	config.HalfClockDelay = args[4];
+	config.HalfClockDelay |= (args[5] << 8);
+	config.HalfClockDelay |= (args[6] << 16);
+	config.HalfClockDelay |= (args[7] << 24);
+	config.CSLeadDelay = args[8];
+	config.CSLeadDelay |= (args[9] << 8);
+	config.CSLagDelay = args[10];
+	config.CSLagDelay |= (args[11] << 8);
+	bitBangStallTime = args[12];
+	bitBangStallTime |= (args[13] << 8);
+	bitBangStallTime |= (args[14] << 16);
+	bitBangStallTime |= (args[15] << 24);
+	bitsPerTransfer = args[16];
+	bitsPerTransfer |= (args[17] << 8);
+	bitsPerTransfer |= (args[18] << 16);
+	bitsPerTransfer |= (args[19] << 24);
+	numTransfers = args[20];
+	numTransfers |= (args[21] << 8);
+	numTransfers |= (args[22] << 16);
+	numTransfers |= (args[23] << 24);
 
 	/* apply offset to stall */
 	if(bitBangStallTime > STALL_COUNT_OFFSET)
@@ -253,19 +266,23 @@ CyU3PReturnStatus_t AdiBitBangSpiHandler()
 	/* Start MISO pointer at bulk buffer */
 	MISOPtr = BulkBuffer;
 
-	/* Start MOSI pointer at USBBuffer[22] */
-	MOSIPtr = USBBuffer;
+	/* Start MOSI pointer at args[24] */
+	MOSIPtr = args;
 	MOSIPtr += 24;
 
-	/* Setup the GPIO selected */
+	/* Setup the GPIO selected. The pins are not given back to the SPI controller until ADI_RESET_SPI */
+	AdiSpiLock();
 	status = AdiBitBangSpiSetup(config);
+	AdiSpiUnlock();
 	if(status == CY_U3P_SUCCESS)
 	{
 		/* Perform transfers */
-		for(transferCounter = 0; transferCounter < numTransfers; transferCounter++)
+		for(transferCounter = 0; (transferCounter < numTransfers) && !CommandThreadState.Cancel; transferCounter++)
 		{
-			/* Transfer data */
+			/* Transfer data. The SPI mutex is taken per transfer, not for the whole request */
+			AdiSpiLock();
 			AdiBitBangSpiTransfer(MOSIPtr, MISOPtr, bitsPerTransfer, config);
+			AdiSpiUnlock();
 			/* Update buffer pointers */
 			MOSIPtr += bitsPerTransfer;
 			MISOPtr += bitsPerTransfer;
@@ -547,15 +564,15 @@ CyU3PSpiConfig_t AdiGetSpiConfig()
  **/
 void AdiPrintSpiConfig(CyU3PSpiConfig_t config)
 {
-	CyU3PDebugPrint (4, "SPI Config: \r\nSCLK Freq: %d\r\n", config.clock);
-	CyU3PDebugPrint (4, "CPHA: %d\r\n", config.cpha);
-	CyU3PDebugPrint (4, "CPOL: %d\r\n", config.cpol);
-	CyU3PDebugPrint (4, "LSB First: %d\r\n", config.isLsbFirst);
-	CyU3PDebugPrint (4, "CS Lag Time: %d\r\n", config.lagTime);
-	CyU3PDebugPrint (4, "CS Lead Time: %d\r\n", config.leadTime);
-	CyU3PDebugPrint (4, "CS Control Mode: %d\r\n", config.ssnCtrl);
-	CyU3PDebugPrint (4, "CS Polarity: %d\r\n", config.ssnPol);
-	CyU3PDebugPrint (4, "Word Length: %d\r\n", config.wordLen);
+	ADI_LOG("SPI Config: \r\nSCLK Freq: %d\r\n", config.clock);
+	ADI_LOG("CPHA: %d\r\n", config.cpha);
+	ADI_LOG("CPOL: %d\r\n", config.cpol);
+	ADI_LOG("LSB First: %d\r\n", config.isLsbFirst);
+	ADI_LOG("CS Lag Time: %d\r\n", config.lagTime);
+	ADI_LOG("CS Lead Time: %d\r\n", config.leadTime);
+	ADI_LOG("CS Control Mode: %d\r\n", config.ssnCtrl);
+	ADI_LOG("CS Polarity: %d\r\n", config.ssnPol);
+	ADI_LOG("Word Length: %d\r\n", config.wordLen);
 }
 
 /**
@@ -572,10 +589,227 @@ void AdiPrintSpiConfig(CyU3PSpiConfig_t config)
 CyU3PReturnStatus_t AdiTransferBytes(uint32_t writeData)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-	uint8_t writeBuffer[4];
 	uint8_t readBuffer[4];
+
+	/* perform SPI transfer */
+	status = AdiSpiTransfer(writeData, readBuffer);
+
+	/* Load read data to be sent back via control endpoint */
+	USBBuffer[4] = readBuffer[0];
+	USBBuffer[5] = readBuffer[1];
+	USBBuffer[6] = readBuffer[2];
+	USBBuffer[7] = readBuffer[3];
+
+	/* Return status code  */
+	return status;
+}
+
+/**
+  * @brief This function reads a single 16 bit SPI word from a slave device.
+  *
+  * @param addr The address to send to the DUT in the first SPI transaction.
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * This function reads a single word over SPI. Note that reads are not "full duplex"
+  * and will require a discrete read to set the address to be read from (two 16 bit transactions per read).
+ **/
+CyU3PReturnStatus_t AdiReadRegBytes(uint16_t addr)
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	uint8_t tempBuffer[2];
+
+	/* Perform the register read */
+	status = AdiSpiReadReg(addr, tempBuffer);
+
+	/* Send status and data back via control endpoint */
+	USBBuffer[0] = status & 0xFF;
+	USBBuffer[1] = (status & 0xFF00) >> 8;
+	USBBuffer[2] = (status & 0xFF0000) >> 16;
+	USBBuffer[3] = (status & 0xFF000000) >> 24;
+	USBBuffer[4] = tempBuffer[0];
+	USBBuffer[5] = tempBuffer[1];
+	CyU3PUsbSendEP0Data (6, USBBuffer);
+
+	return status;
+}
+
+/**
+  * @brief Reads a list of register words from an iSensor DUT using full duplex SPI transfers, and sends them to the PC.
+  *
+  * @param addrList The address list read from the control endpoint (see AdiCommandQueue)
+  *
+  * @param length The length of the address list (sent in the control endpoint data stage), in bytes (max
+  * ADI_REG_LIST_MAX_LENGTH, longer lists are cut short).
+  *
+  * @param isPaged If the DUT has a paged register map, selected with PAGE_ID (address 0x00).
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * The address list is 2 bytes per register: address[0], page[1]. Each read word is clocked out by the DUT during
+  * the following SPI transaction, so each transaction sends the next address while receiving the previous data. This
+  * takes one transaction (and stall) per register, instead of the two used by AdiReadRegBytes. For a paged DUT, a
+  * PAGE_ID write is inserted whenever the page changes (starting from the cached page when the page cache is
+  * enabled), which also clocks out the previous read. The page byte is
+  * ignored for a DUT without pages. The data is sent to the PC over the bulk endpoint as status[0-3], then one word
+  * per address (in the same byte order as ADI_READ_BYTES). On an SPI error the read stops, and the words read
+  * before the error are still returned. The SPI mutex is taken per register, so the control endpoint handler can
+  * read registers during a long list. A register whose data was clocked out by another thread is read again.
+ **/
+CyU3PReturnStatus_t AdiReadRegList(uint8_t *addrList, uint16_t length, CyBool_t isPaged)
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	uint32_t numRegs, numRead, regIndex, currentPage;
+	uint8_t txBuffer[2];
+	uint8_t rxBuffer[2];
+	uint8_t *pendingData;
+	CyBool_t interrupted;
+
+	/* The words read go to BulkBuffer after the status */
+	if(length > ADI_REG_LIST_MAX_LENGTH)
+	{
+		length = ADI_REG_LIST_MAX_LENGTH;
+	}
+	numRegs = length / 2;
+
+	currentPage = ADI_PAGE_UNKNOWN;
+	pendingData = NULL;
+	numRead = 0;
+	for(regIndex = 0; (regIndex < numRegs) || (pendingData != NULL); regIndex++)
+	{
+		/* The mutex is held for one register at a time. If another thread accessed the DUT in between, its
+		 * transactions clocked out the pending data, so read that register again */
+		interrupted = AdiSpiLock();
+		if(interrupted || (regIndex == 0))
+		{
+			/* Start from the cached page. If it is unknown, the next register always selects its page */
+			currentPage = FX3State.PageCacheEnabled ? FX3State.CurrentPage : ADI_PAGE_UNKNOWN;
+			if(pendingData != NULL)
+			{
+				regIndex--;
+				pendingData = NULL;
+			}
+		}
+
+		txBuffer[0] = 0;
+		txBuffer[1] = 0;
+		if(regIndex < numRegs)
+		{
+			/* Switch pages if needed. The PAGE_ID write returns the data for the previous read */
+			if(isPaged && (addrList[(regIndex * 2) + 1] != currentPage))
+			{
+				currentPage = addrList[(regIndex * 2) + 1];
+				txBuffer[0] = currentPage;
+				txBuffer[1] = 0x80;
+				status = CyU3PSpiTransferWords(txBuffer, 2, rxBuffer, 2);
+				if(status != CY_U3P_SUCCESS)
+				{
+					AdiLogError(SpiFunctions_c, __LINE__, status);
+					FX3State.CurrentPage = ADI_PAGE_UNKNOWN;
+					AdiSpiUnlock();
+					break;
+				}
+				FX3State.CurrentPage = currentPage;
+				if(pendingData != NULL)
+				{
+					pendingData[0] = rxBuffer[0];
+					pendingData[1] = rxBuffer[1];
+					pendingData = NULL;
+					numRead++;
+				}
+				AdiSleepForMicroSeconds(FX3State.StallTime);
+			}
+
+			/* Send the read address, and receive the data for the previous read */
+			txBuffer[0] = 0;
+			txBuffer[1] = addrList[regIndex * 2] & 0x7F;
+		}
+		/* Otherwise clock out the data for the last read with a read of address 0 */
+		status = CyU3PSpiTransferWords(txBuffer, 2, rxBuffer, 2);
+		if(status != CY_U3P_SUCCESS)
+		{
+			AdiLogError(SpiFunctions_c, __LINE__, status);
+			if(isPaged)
+			{
+				FX3State.CurrentPage = ADI_PAGE_UNKNOWN;
+			}
+			AdiSpiUnlock();
+			break;
+		}
+		AdiSpiUnlock();
+
+		if(pendingData != NULL)
+		{
+			pendingData[0] = rxBuffer[0];
+			pendingData[1] = rxBuffer[1];
+			numRead++;
+		}
+		pendingData = (regIndex < numRegs) ? BulkBuffer + 4 + (regIndex * 2) : NULL;
+		if(pendingData != NULL)
+		{
+			AdiSleepForMicroSeconds(FX3State.StallTime);
+		}
+	}
+
+	/* Send the words read to the PC */
+	AdiReturnBulkEndpointData(status, 4 + (numRead * 2));
+
+	return status;
+}
+
+/**
+  * @brief This function writes a single byte of data over the SPI bus
+  *
+  * @param addr The DUT address to write data to (7 bits).
+  *
+  * @param data The byte of data to write to the address
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * This function uses  the standard iSensor SPI protocol to issue a write command.
+  * For the standard iSensor SPI parts, a write is performed in a single 16 bit command,
+  * where the first bit clocked out is the write bit (high) followed by the address and data.
+ **/
+CyU3PReturnStatus_t AdiWriteRegByte(uint16_t addr, uint8_t data)
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+
+	/* Perform the register write */
+	status = AdiSpiWriteReg(addr, data);
+
+	/* Send write status over the control endpoint */
+	USBBuffer[0] = status & 0xFF;
+	USBBuffer[1] = (status & 0xFF00) >> 8;
+	USBBuffer[2] = (status & 0xFF0000) >> 16;
+	USBBuffer[3] = (status & 0xFF000000) >> 24;
+	CyU3PUsbSendEP0Data (4, USBBuffer);
+
+	return status;
+}
+
+/**
+  * @brief Performs a protocol agnostic SPI transfer of (1, 2, 4) bytes, without sending anything to the PC.
+  *
+  * @param writeData The data to transmit on the MOSI line.
+  *
+  * @param readData Buffer (4 bytes) to place the data received on the MISO line in.
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * The transfer length is determined by the current SPI config word length setting. Used by the
+  * ADI_TRANSFER_BYTES vendor command and the bulk command channel.
+ **/
+CyU3PReturnStatus_t AdiSpiTransfer(uint32_t writeData, uint8_t *readData)
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	uint8_t writeBuffer[4];
 	uint32_t transferSize;
 
+	AdiSpiLock();
+
+	/* The transfer may change the DUT page */
+	AdiInvalidatePageCache();
+
 	/* populate the writebuffer */
 	writeBuffer[0] = writeData & 0xFF;
 	writeBuffer[1] = (writeData & 0xFF00) >> 8;
@@ -586,43 +820,41 @@ CyU3PReturnStatus_t AdiTransferBytes(uint32_t writeData)
 	transferSize = FX3State.SpiConfig.wordLen / 8;
 
 	/* perform SPI transfer */
-	status = CyU3PSpiTransferWords(writeBuffer, transferSize, readBuffer, transferSize);
+	status = CyU3PSpiTransferWords(writeBuffer, transferSize, readData, transferSize);
+	AdiSpiUnlock();
 	if(status != CY_U3P_SUCCESS)
 	{
 		AdiLogError(SpiFunctions_c, __LINE__, status);
 	}
 
-	/* Load read data to be sent back via control endpoint */
-	USBBuffer[4] = readBuffer[0];
-	USBBuffer[5] = readBuffer[1];
-	USBBuffer[6] = readBuffer[2];
-	USBBuffer[7] = readBuffer[3];
-
-	/* Return status code  */
 	return status;
 }
 
 /**
-  * @brief This function reads a single 16 bit SPI word from a slave device.
+  * @brief Reads a single 16 bit register word from an iSensor DUT, without sending anything to the PC.
   *
   * @param addr The address to send to the DUT in the first SPI transaction.
   *
+  * @param readData Buffer (2 bytes) to place the register word in.
+  *
   * @return A status code indicating the success of the function.
   *
-  * This function reads a single word over SPI. Note that reads are not "full duplex"
-  * and will require a discrete read to set the address to be read from (two 16 bit transactions per read).
+  * The address word is sent, followed by the user stall time, then a second word which clocks out
+  * the register contents. Used by the ADI_READ_BYTES vendor command and the bulk command channel.
  **/
-CyU3PReturnStatus_t AdiReadRegBytes(uint16_t addr)
+CyU3PReturnStatus_t AdiSpiReadReg(uint16_t addr, uint8_t *readData)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-	uint8_t tempBuffer[2];
+
+	/* The address word and the data word must not be split by another DUT access */
+	AdiSpiLock();
 
 	/* Set the second byte to 0's */
-	tempBuffer[0] = 0;
+	readData[0] = 0;
 	/* Set the address to read from */
-	tempBuffer[1] = (0x7F) & addr;
+	readData[1] = (0x7F) & addr;
 	/* Send SPI Read command */
-	status = CyU3PSpiTransmitWords(tempBuffer, 2);
+	status = CyU3PSpiTransmitWords(readData, 2);
 	/* Check that the transfer was successful and end function if failed */
 	if (status != CY_U3P_SUCCESS)
 	{
@@ -633,27 +865,19 @@ CyU3PReturnStatus_t AdiReadRegBytes(uint16_t addr)
 	AdiSleepForMicroSeconds(FX3State.StallTime);
 
 	/* Receive the data requested */
-	status = CyU3PSpiReceiveWords(tempBuffer, 2);
+	status = CyU3PSpiReceiveWords(readData, 2);
+	AdiSpiUnlock();
 	/* Check that the transfer was successful and end function if failed */
 	if (status != CY_U3P_SUCCESS)
 	{
 		AdiLogError(SpiFunctions_c, __LINE__, status);
 	}
 
-	/* Send status and data back via control endpoint */
-	USBBuffer[0] = status & 0xFF;
-	USBBuffer[1] = (status & 0xFF00) >> 8;
-	USBBuffer[2] = (status & 0xFF0000) >> 16;
-	USBBuffer[3] = (status & 0xFF000000) >> 24;
-	USBBuffer[4] = tempBuffer[0];
-	USBBuffer[5] = tempBuffer[1];
-	CyU3PUsbSendEP0Data (6, USBBuffer);
-
 	return status;
 }
 
 /**
-  * @brief This function writes a single byte of data over the SPI bus
+  * @brief Writes a single register byte to an iSensor DUT, without sending anything to the PC.
   *
   * @param addr The DUT address to write data to (7 bits).
   *
@@ -661,14 +885,24 @@ CyU3PReturnStatus_t AdiReadRegBytes(uint16_t addr)
   *
   * @return A status code indicating the success of the function.
   *
-  * This function uses  the standard iSensor SPI protocol to issue a write command.
-  * For the standard iSensor SPI parts, a write is performed in a single 16 bit command,
-  * where the first bit clocked out is the write bit (high) followed by the address and data.
+  * Used by the ADI_WRITE_BYTE vendor command and the bulk command channel. When the page cache is enabled,
+  * a PAGE_ID write which selects the page the DUT is already on is skipped.
  **/
-CyU3PReturnStatus_t AdiWriteRegByte(uint16_t addr, uint8_t data)
+CyU3PReturnStatus_t AdiSpiWriteReg(uint16_t addr, uint8_t data)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 	uint8_t tempBuffer[2];
+
+	/* The cached page is only valid while no other thread can change it */
+	AdiSpiLock();
+
+	/* Skip redundant page selects */
+	if(FX3State.PageCacheEnabled && (addr == ADI_PAGE_ID_ADDR) && (data == FX3State.CurrentPage))
+	{
+		AdiSpiUnlock();
+		return CY_U3P_SUCCESS;
+	}
+
 	tempBuffer[0] = data;
 	tempBuffer[1] = 0x80 | addr;
 	status = CyU3PSpiTransmitWords (tempBuffer, 2);
@@ -677,16 +911,95 @@ CyU3PReturnStatus_t AdiWriteRegByte(uint16_t addr, uint8_t data)
 	{
 		AdiLogError(SpiFunctions_c, __LINE__, status);
 	}
-	/* Send write status over the control endpoint */
-	USBBuffer[0] = status & 0xFF;
-	USBBuffer[1] = (status & 0xFF00) >> 8;
-	USBBuffer[2] = (status & 0xFF0000) >> 16;
-	USBBuffer[3] = (status & 0xFF000000) >> 24;
-	CyU3PUsbSendEP0Data (4, USBBuffer);
+
+	/* Track the selected page */
+	if(addr == ADI_PAGE_ID_ADDR)
+	{
+		FX3State.CurrentPage = (status == CY_U3P_SUCCESS) ? data : ADI_PAGE_UNKNOWN;
+	}
+	AdiSpiUnlock();
 
 	return status;
 }
 
+/**
+  * @brief Drops the cached DUT page, so the next PAGE_ID write is always sent.
+  *
+  * @return void
+  *
+  * Called when the DUT page is no longer known: a DUT reset or power cycle, or an SPI
+  * transfer which the firmware does not decode (protocol agnostic transfers and streams).
+ **/
+void AdiInvalidatePageCache()
+{
+	FX3State.CurrentPage = ADI_PAGE_UNKNOWN;
+}
+
+/**
+  * @brief Takes the SPI mutex, waiting for any DUT access running on another thread to finish.
+  *
+  * @return CyTrue if another thread has accessed the DUT since the calling thread last held the mutex.
+  *
+  * The register helpers run from the control endpoint handler, the command worker and the AppThread. A register
+  * read is two transactions with a stall between them, so an access from another thread must not land in the
+  * middle of it. The mutex is held for one DUT access, not for a whole command, so a long command on one thread does
+  * not hold off the others. It is recursive, so a helper can be called with it already held. When another thread
+  * made the last access, its last transaction may have just ended, so the user stall time is applied first.
+ **/
+CyBool_t AdiSpiLock()
+{
+	CyU3PMutexGet(&SpiMutex, CYU3P_WAIT_FOREVER);
+	return AdiSpiTakeOwnership();
+}
+
+/**
+  * @brief Takes the SPI mutex if no other thread holds it.
+  *
+  * @return A status code indicating if the mutex was taken.
+  *
+  * Used by the control endpoint handler, which must not block the USB thread behind a DUT access on another
+  * thread. The request is stalled instead, and the PC can retry it.
+ **/
+CyU3PReturnStatus_t AdiSpiTryLock()
+{
+	CyU3PReturnStatus_t status;
+
+	status = CyU3PMutexGet(&SpiMutex, CYU3P_NO_WAIT);
+	if(status == CY_U3P_SUCCESS)
+	{
+		AdiSpiTakeOwnership();
+	}
+	return status;
+}
+
+/**
+  * @brief Records the thread holding the SPI mutex as the last to access the DUT.
+  *
+  * @return CyTrue if the last DUT access was made by another thread.
+ **/
+static CyBool_t AdiSpiTakeOwnership()
+{
+	CyU3PThread *thread = CyU3PThreadIdentify();
+
+	if(thread == SpiOwner)
+	{
+		return CyFalse;
+	}
+	SpiOwner = thread;
+	AdiSleepForMicroSeconds(FX3State.StallTime);
+	return CyTrue;
+}
+
+/**
+  * @brief Releases the SPI mutex taken by AdiSpiLock.
+  *
+  * @return void
+ **/
+void AdiSpiUnlock()
+{
+	CyU3PMutexPut(&SpiMutex);
+}
+
 /**
   * @brief Sets the SPI controller word length (4 - 32 bits)
   *
@@ -859,7 +1172,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 			FX3State.SpiConfig.clock = clockFrequency;
 			status = CyU3PSpiSetConfig (&FX3State.SpiConfig, NULL);
 #ifdef VERBOSE_MODE
-			CyU3PDebugPrint (4, "SCLK = %d\r\n", clockFrequency);
+			ADI_LOG("SCLK = %d\r\n", clockFrequency);
 #endif
 		}
 		break;
@@ -869,7 +1182,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		FX3State.SpiConfig.cpol = (CyBool_t) value;
 		status = CyU3PSpiSetConfig (&FX3State.SpiConfig, NULL);
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "cpol = %d\r\n", value);
+		ADI_LOG("cpol = %d\r\n", value);
 #endif
 		break;
 
@@ -878,7 +1191,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		FX3State.SpiConfig.cpha = (CyBool_t) value;
 		status = CyU3PSpiSetConfig (&FX3State.SpiConfig, NULL);
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "cpha = %d\r\n", value);
+		ADI_LOG("cpha = %d\r\n", value);
 #endif
 		break;
 
@@ -887,7 +1200,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		FX3State.SpiConfig.ssnPol = (CyBool_t) value;
 		status = CyU3PSpiSetConfig (&FX3State.SpiConfig, NULL);
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "ssnPol = %d\r\n", value);
+		ADI_LOG("ssnPol = %d\r\n", value);
 #endif
 		break;
 
@@ -896,7 +1209,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		FX3State.SpiConfig.ssnCtrl = (CyU3PSpiSsnCtrl_t) value;
 		status = CyU3PSpiSetConfig (&FX3State.SpiConfig, NULL);
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "ssnCtrl = %d\r\n", value);
+		ADI_LOG("ssnCtrl = %d\r\n", value);
 #endif
 		break;
 
@@ -905,7 +1218,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		FX3State.SpiConfig.leadTime = (CyU3PSpiSsnLagLead_t) value;
 		status = CyU3PSpiSetConfig (&FX3State.SpiConfig, NULL);
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "leadTime = %d\r\n", value);
+		ADI_LOG("leadTime = %d\r\n", value);
 #endif
 		break;
 
@@ -914,7 +1227,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		FX3State.SpiConfig.lagTime = (CyU3PSpiSsnLagLead_t) value;
 		status = CyU3PSpiSetConfig (&FX3State.SpiConfig, NULL);
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "lagTime = %d\r\n", value);
+		ADI_LOG("lagTime = %d\r\n", value);
 #endif
 		break;
 
@@ -923,7 +1236,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		FX3State.SpiConfig.isLsbFirst = (CyBool_t) value;
 		status = CyU3PSpiSetConfig (&FX3State.SpiConfig, NULL);
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "isLsbFirst = %d\r\n", value);
+		ADI_LOG("isLsbFirst = %d\r\n", value);
 #endif
 		break;
 
@@ -932,7 +1245,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		FX3State.SpiConfig.wordLen = value & 0xFF;
 		status = CyU3PSpiSetConfig (&FX3State.SpiConfig, NULL);
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "wordLen = %d\r\n", value);
+		ADI_LOG("wordLen = %d\r\n", value);
 #endif
 		break;
 
@@ -940,7 +1253,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		/* Stall time in ticks (received in ticks from the PC, each tick = 1us) */
 		FX3State.StallTime = value;
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "stallTime = %d\r\n", value);
+		ADI_LOG("stallTime = %d\r\n", value);
 #endif
 		break;
 
@@ -970,7 +1283,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 			break;
 		}
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "bytesPerFrame = %d\r\n", StreamThreadState.BytesPerFrame);
+		ADI_LOG("bytesPerFrame = %d\r\n", StreamThreadState.BytesPerFrame);
 #endif
 		break;
 
@@ -978,7 +1291,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		/* DR polarity */
 		FX3State.DrPolarity = (CyBool_t) value;
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "DrPolarity = %d\r\n", value);
+		ADI_LOG("DrPolarity = %d\r\n", value);
 #endif
 		break;
 
@@ -986,7 +1299,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		/* DR active */
 		FX3State.DrActive = (CyBool_t) value;
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "DrActive = %d\r\n", value);
+		ADI_LOG("DrActive = %d\r\n", value);
 #endif
 		break;
 
@@ -994,7 +1307,7 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		/* Ready pin */
 		FX3State.DrPin = value;
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "DrPin = %d\r\n", value);
+		ADI_LOG("DrPin = %d\r\n", value);
 #endif
 		break;
 
@@ -1012,11 +1325,77 @@ CyBool_t AdiSpiUpdate(uint16_t index, uint16_t value, uint16_t length)
 		AdiConfigureWatchdog();
 		break;
 
+	case 16:
+		/* DR interrupt mode */
+		FX3State.DrInterruptMode = (CyBool_t) value;
+#ifdef VERBOSE_MODE
+		ADI_LOG("DrInterruptMode = %d\r\n", value);
+#endif
+		break;
+
+	case 17:
+		/* Stream sample time stamps */
+		FX3State.StreamTimestamps = (CyBool_t) value;
+#ifdef VERBOSE_MODE
+		ADI_LOG("StreamTimestamps = %d\r\n", value);
+#endif
+		break;
+
+	case 18:
+		/* Stream frame headers */
+		FX3State.StreamFrameMode = value;
+#ifdef VERBOSE_MODE
+		ADI_LOG("StreamFrameMode = %d\r\n", value);
+#endif
+		break;
+
+	case 19:
+		/* Page cache for paged DUTs. Also drops the cached page */
+		FX3State.PageCacheEnabled = (CyBool_t) value;
+		AdiInvalidatePageCache();
+#ifdef VERBOSE_MODE
+		ADI_LOG("PageCacheEnabled = %d\r\n", value);
+#endif
+		break;
+
+	case 20:
+		/* USB packets per CPU filled stream DMA buffer. Capped when the stream starts */
+		if(value == 0)
+		{
+			value = 1;
+		}
+		FX3State.StreamBufferPackets = value;
+#ifdef VERBOSE_MODE
+		ADI_LOG("StreamBufferPackets = %d\r\n", value);
+#endif
+		break;
+
+	case 21:
+		/* Stream overflow policy */
+		if(value > ADI_STREAM_OVERFLOW_DROP_OLDEST)
+		{
+			isHandled = CyFalse;
+			break;
+		}
+		FX3State.StreamOverflowPolicy = value;
+#ifdef VERBOSE_MODE
+		ADI_LOG("StreamOverflowPolicy = %d\r\n", value);
+#endif
+		break;
+
+	case 22:
+		/* Stream overflow wait time (ms) */
+		FX3State.StreamOverflowWaitMs = value;
+#ifdef VERBOSE_MODE
+		ADI_LOG("StreamOverflowWaitMs = %d\r\n", value);
+#endif
+		break;
+
 	default:
 		/* Invalid Command */
 		isHandled = CyFalse;
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "ERROR: Invalid SPI config command!\r\n");
+		ADI_LOG("ERROR: Invalid SPI config command!\r\n");
 #endif
 		break;
 	}
@@ -61,9 +61,26 @@ void AdiSpiTransferWord(uint8_t *txBuf, uint8_t *rxBuf, uint32_t numBytes);
 CyU3PReturnStatus_t AdiTransferBytes(uint32_t writeData);
 CyU3PReturnStatus_t AdiWriteRegByte(uint16_t addr, uint8_t data);
 CyU3PReturnStatus_t AdiReadRegBytes(uint16_t addr);
+CyU3PReturnStatus_t AdiReadRegList(uint8_t *addrList, uint16_t length, CyBool_t isPaged);
+CyU3PReturnStatus_t AdiSpiTransfer(uint32_t writeData, uint8_t *readData);
+CyU3PReturnStatus_t AdiSpiReadReg(uint16_t addr, uint8_t *readData);
+CyU3PReturnStatus_t AdiSpiWriteReg(uint16_t addr, uint8_t data);
+void AdiInvalidatePageCache();
+CyBool_t AdiSpiLock();
+CyU3PReturnStatus_t AdiSpiTryLock();
+void AdiSpiUnlock();
 
 /* Bitbang SPI functions */
-CyU3PReturnStatus_t AdiBitBangSpiHandler();
+CyU3PReturnStatus_t AdiBitBangSpiHandler(uint8_t *args);
+
+/** iSensor PAGE_ID register address, on every page of a paged DUT */
+#define ADI_PAGE_ID_ADDR 0x00
+
+/** Cached page value when the DUT page is not known */
+#define ADI_PAGE_UNKNOWN 0xFFFF
+
+/** Longest ADI_READ_REG_LIST address list, in bytes. The 4 byte status and one word per address fill BulkBuffer */
+#define ADI_REG_LIST_MAX_LENGTH (12288 - 4)
 
 /** Offset to make the short side of the bitbang SPI match long side. Approx. 62ns per tick */
 #define BITBANG_HALFCLOCK_OFFSET 8
@@ -0,0 +1,331 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		SpiScript.c
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		On-device SPI register script engine. Runs register sequences without a USB round trip per access.
+ **/
+
+#include "SpiScript.h"
+
+/* Private function prototypes */
+static CyU3PReturnStatus_t AdiScriptWaitEdge(uint8_t pin, CyBool_t polarity, uint16_t timeoutMs);
+static CyU3PReturnStatus_t AdiScriptStall(uint32_t microSeconds);
+static CyU3PReturnStatus_t AdiScriptSkipLoop(uint8_t *script, uint32_t length, uint32_t *pc);
+
+/* Tell the compiler where to find the needed globals */
+extern uint8_t BulkBuffer[12288];
+extern CommandState CommandThreadState;
+
+/** Number of operand bytes following each opcode, indexed by opcode */
+static const uint8_t ScriptOperandBytes[] = {0, 2, 2, 3, 4, 4, 2, 0, 6, 6};
+
+/**
+  * @brief Runs an SPI register script sent on the control endpoint, and returns the results on the bulk endpoint.
+  *
+  * @param script The script, read from the control endpoint data stage (see AdiCommandQueue)
+  *
+  * @param length The script length, in bytes (max ADI_SCRIPT_MAX_LENGTH).
+  *
+  * @return A status code indicating the success of the script.
+  *
+  * The script (opcodes ADI_SCRIPT_*) is run start to finish by the command worker thread. The response sent on
+  * ChannelToPC is status[0-3], the script byte offset execution stopped at[4-5], the number of register words
+  * read[6-7], then each word read by ADI_SCRIPT_READ_REG (2 bytes, in the same byte order as ADI_READ_BYTES). On a
+  * failure the script stops at the failing instruction, and the words read before it are still returned. A script
+  * cancelled with ADI_COMMAND_CANCEL stops before its next instruction (or during an edge wait or stall) with
+  * CY_U3P_ERROR_ABORTED.
+ **/
+CyU3PReturnStatus_t AdiRunSpiScript(uint8_t *script, uint16_t length)
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	uint32_t pc, nextPc, steps, numResults, maxResults;
+	uint32_t loopStart[ADI_SCRIPT_MAX_LOOP_DEPTH];
+	uint16_t loopCount[ADI_SCRIPT_MAX_LOOP_DEPTH];
+	uint32_t loopDepth;
+	uint16_t lastValue, mask, value;
+	uint8_t opcode;
+	uint8_t pollData[2];
+	uint8_t *operands;
+	uint8_t *results;
+
+	pc = 0;
+	steps = 0;
+	loopDepth = 0;
+	lastValue = 0;
+	numResults = 0;
+	maxResults = (sizeof(BulkBuffer) - ADI_SCRIPT_RESULT_OFFSET) / 2;
+	results = BulkBuffer + ADI_SCRIPT_RESULT_OFFSET;
+
+	while((status == CY_U3P_SUCCESS) && (pc < length))
+	{
+		opcode = script[pc];
+		if(opcode == ADI_SCRIPT_END)
+		{
+			break;
+		}
+
+		/* Validate the opcode and its operands */
+		if((opcode >= sizeof(ScriptOperandBytes)) || ((pc + 1 + ScriptOperandBytes[opcode]) > length))
+		{
+			status = CY_U3P_ERROR_BAD_ARGUMENT;
+			break;
+		}
+		if(++steps > ADI_SCRIPT_MAX_STEPS)
+		{
+			status = CY_U3P_ERROR_TIMEOUT;
+			break;
+		}
+		if(CommandThreadState.Cancel)
+		{
+			status = CY_U3P_ERROR_ABORTED;
+			break;
+		}
+		operands = script + pc + 1;
+		nextPc = pc + 1 + ScriptOperandBytes[opcode];
+
+		switch(opcode)
+		{
+			case ADI_SCRIPT_READ_REG:
+				if(numResults >= maxResults)
+				{
+					status = CY_U3P_ERROR_MEMORY_ERROR;
+					break;
+				}
+				status = AdiSpiReadReg(operands[0] | (operands[1] << 8), results);
+				lastValue = results[0] | (results[1] << 8);
+				results += 2;
+				numResults++;
+				break;
+
+			case ADI_SCRIPT_POLL_REG:
+				status = AdiSpiReadReg(operands[0] | (operands[1] << 8), pollData);
+				lastValue = pollData[0] | (pollData[1] << 8);
+				break;
+
+			case ADI_SCRIPT_WRITE_REG:
+				status = AdiSpiWriteReg(operands[0] | (operands[1] << 8), operands[2]);
+				break;
+
+			case ADI_SCRIPT_STALL:
+				status = AdiScriptStall(operands[0] | (operands[1] << 8) | (operands[2] << 16) | (operands[3] << 24));
+				break;
+
+			case ADI_SCRIPT_WAIT_EDGE:
+				status = AdiScriptWaitEdge(operands[0], (CyBool_t) (operands[1] != 0), operands[2] | (operands[3] << 8));
+				break;
+
+			case ADI_SCRIPT_LOOP:
+				if(loopDepth >= ADI_SCRIPT_MAX_LOOP_DEPTH)
+				{
+					status = CY_U3P_ERROR_INVALID_SEQUENCE;
+					break;
+				}
+				loopCount[loopDepth] = operands[0] | (operands[1] << 8);
+				if(loopCount[loopDepth] == 0)
+				{
+					/* Zero count loop body never runs */
+					status = AdiScriptSkipLoop(script, length, &nextPc);
+					break;
+				}
+				loopStart[loopDepth] = nextPc;
+				loopDepth++;
+				break;
+
+			case ADI_SCRIPT_END_LOOP:
+				if(loopDepth == 0)
+				{
+					status = CY_U3P_ERROR_INVALID_SEQUENCE;
+					break;
+				}
+				if(loopCount[loopDepth - 1] > 1)
+				{
+					loopCount[loopDepth - 1]--;
+					nextPc = loopStart[loopDepth - 1];
+				}
+				else
+				{
+					loopDepth--;
+				}
+				break;
+
+			case ADI_SCRIPT_BRANCH_EQ:
+			case ADI_SCRIPT_BRANCH_NE:
+				mask = operands[0] | (operands[1] << 8);
+				value = operands[2] | (operands[3] << 8);
+				if(((lastValue & mask) == value) == (opcode == ADI_SCRIPT_BRANCH_EQ))
+				{
+					nextPc = operands[4] | (operands[5] << 8);
+				}
+				break;
+
+			default:
+				status = CY_U3P_ERROR_BAD_ARGUMENT;
+				break;
+		}
+
+		if(status == CY_U3P_SUCCESS)
+		{
+			pc = nextPc;
+		}
+	}
+
+#ifdef VERBOSE_MODE
+	ADI_LOG("SPI script: %d bytes, %d steps, %d reads, stopped at %d, status 0x%x\r\n", length, steps, numResults, pc, status);
+#endif
+
+	/* Catch potential out of bounds status code */
+	if(status > CY_U3P_ERROR_MEDIA_FAILURE)
+	{
+		status = CY_U3P_ERROR_NOT_SUPPORTED;
+	}
+
+	/* Populate the response header and send everything to the PC */
+	BulkBuffer[4] = pc & 0xFF;
+	BulkBuffer[5] = (pc & 0xFF00) >> 8;
+	BulkBuffer[6] = numResults & 0xFF;
+	BulkBuffer[7] = (numResults & 0xFF00) >> 8;
+	AdiReturnBulkEndpointData(status, ADI_SCRIPT_RESULT_OFFSET + (numResults * 2));
+
+	return status;
+}
+
+/**
+  * @brief Waits for an edge on a GPIO pin, for the ADI_SCRIPT_WAIT_EDGE instruction.
+  *
+  * @param pin The GPIO pin number to poll.
+  *
+  * @param polarity The edge to wait for. True waits for a rising edge, false waits for a falling edge.
+  *
+  * @param timeoutMs The max time to wait for the edge, in ms.
+  *
+  * @return A status code indicating the success of the function. CY_U3P_ERROR_TIMEOUT if there was no edge.
+  *
+  * The pin must first be seen at the opposite level, so a pin already at the selected level waits
+  * for the next edge instead of returning right away. Times out using the elapsed time between 10MHz
+  * timer reads, so the timer configuration is left alone.
+ **/
+static CyU3PReturnStatus_t AdiScriptWaitEdge(uint8_t pin, CyBool_t polarity, uint16_t timeoutMs)
+{
+	CyU3PReturnStatus_t status;
+	CyBool_t pinValue, sawOpposite;
+	uint32_t lastTime, currentTime, elapsed, timeoutTicks;
+
+	/* Check that the pin is configured as an input */
+	status = CyU3PGpioSimpleGetValue(pin, &pinValue);
+	if(status != CY_U3P_SUCCESS)
+	{
+		return status;
+	}
+
+	timeoutTicks = timeoutMs * MS_TO_TICKS_MULT;
+	elapsed = 0;
+	lastTime = AdiReadTimerRegValue();
+	sawOpposite = CyFalse;
+	while(elapsed < timeoutTicks)
+	{
+		currentTime = AdiReadTimerRegValue();
+		elapsed += (currentTime - lastTime);
+		lastTime = currentTime;
+
+		pinValue = ((GPIO->lpp_gpio_simple[pin] & CY_U3P_LPP_GPIO_IN_VALUE) >> 1);
+		if(pinValue != polarity)
+		{
+			sawOpposite = CyTrue;
+		}
+		else if(sawOpposite)
+		{
+			return CY_U3P_SUCCESS;
+		}
+
+		if(CommandThreadState.Cancel)
+		{
+			return CY_U3P_ERROR_ABORTED;
+		}
+	}
+	return CY_U3P_ERROR_TIMEOUT;
+}
+
+/**
+  * @brief Stalls for the ADI_SCRIPT_STALL instruction.
+  *
+  * @param microSeconds The stall time, in microseconds (max ADI_SCRIPT_MAX_STALL_US).
+  *
+  * @return A status code indicating the success of the function. CY_U3P_ERROR_BAD_ARGUMENT if the stall is too long.
+  *
+  * The stall is waited in slices of ADI_SCRIPT_STALL_SLICE_US, so a cancel request ends it within one slice.
+ **/
+static CyU3PReturnStatus_t AdiScriptStall(uint32_t microSeconds)
+{
+	uint32_t sliceTime;
+
+	if(microSeconds > ADI_SCRIPT_MAX_STALL_US)
+	{
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	}
+
+	while(microSeconds > 0)
+	{
+		if(CommandThreadState.Cancel)
+		{
+			return CY_U3P_ERROR_ABORTED;
+		}
+		sliceTime = microSeconds;
+		if(sliceTime > ADI_SCRIPT_STALL_SLICE_US)
+		{
+			sliceTime = ADI_SCRIPT_STALL_SLICE_US;
+		}
+		AdiSleepForMicroSeconds(sliceTime);
+		microSeconds -= sliceTime;
+	}
+	return CY_U3P_SUCCESS;
+}
+
+/**
+  * @brief Finds the end of a loop body, for an ADI_SCRIPT_LOOP with a count of 0.
+  *
+  * @param script The script being run
+  *
+  * @param length The script length, in bytes
+  *
+  * @param pc The script offset of the loop body. Set to the offset after its matching ADI_SCRIPT_END_LOOP.
+  *
+  * @return A status code indicating the success of the function. CY_U3P_ERROR_INVALID_SEQUENCE if the loop has no end.
+  *
+  * Nested loops in the skipped body are matched with their own ADI_SCRIPT_END_LOOP.
+ **/
+static CyU3PReturnStatus_t AdiScriptSkipLoop(uint8_t *script, uint32_t length, uint32_t *pc)
+{
+	uint32_t offset = *pc;
+	uint32_t depth = 1;
+	uint8_t opcode;
+
+	while(offset < length)
+	{
+		opcode = script[offset];
+		if((opcode == ADI_SCRIPT_END) || (opcode >= sizeof(ScriptOperandBytes)))
+		{
+			break;
+		}
+		offset += 1 + ScriptOperandBytes[opcode];
+		if(opcode == ADI_SCRIPT_LOOP)
+		{
+			depth++;
+		}
+		else if((opcode == ADI_SCRIPT_END_LOOP) && (--depth == 0))
+		{
+			*pc = offset;
+			return CY_U3P_SUCCESS;
+		}
+	}
+	return CY_U3P_ERROR_INVALID_SEQUENCE;
+}
@@ -0,0 +1,79 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  *
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  *
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  *
+  * @file		SpiScript.h
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		Header file for the on-device SPI register script engine.
+ **/
+
+#ifndef SPI_SCRIPT_H
+#define SPI_SCRIPT_H
+
+/* Include the main header file */
+#include "main.h"
+
+/* Script engine functions */
+CyU3PReturnStatus_t AdiRunSpiScript(uint8_t *script, uint16_t length);
+
+/** Max script length, in bytes. Longer scripts are stalled on the control endpoint */
+#define ADI_SCRIPT_MAX_LENGTH					(4096)
+
+/** Max number of nested loops in a script */
+#define ADI_SCRIPT_MAX_LOOP_DEPTH				(4)
+
+/** Max number of instructions executed by one script. Bounds scripts which branch backwards forever */
+#define ADI_SCRIPT_MAX_STEPS					(1000000)
+
+/** Max ADI_SCRIPT_STALL time, in microseconds (1 second). Longer stalls end the script with a bad argument error */
+#define ADI_SCRIPT_MAX_STALL_US					(1000000)
+
+/** ADI_SCRIPT_STALL is waited in slices of this many microseconds, with a cancel check between them */
+#define ADI_SCRIPT_STALL_SLICE_US				(1000)
+
+/** Offset of the first read result in the script response (after status, exit offset, result count) */
+#define ADI_SCRIPT_RESULT_OFFSET				(8)
+
+/*
+ * Script opcodes. Each instruction is an opcode byte followed by its little endian operands.
+ */
+
+/** End of the script (no operands) */
+#define ADI_SCRIPT_END							(0x00)
+
+/** Read a 16 bit register word (addr[2]). The word is appended to the results and held for SCRIPT_BRANCH */
+#define ADI_SCRIPT_READ_REG						(0x01)
+
+/** Read a 16 bit register word (addr[2]) for SCRIPT_BRANCH only, without appending it to the results */
+#define ADI_SCRIPT_POLL_REG						(0x02)
+
+/** Write a register byte (addr[2], data[1]) */
+#define ADI_SCRIPT_WRITE_REG					(0x03)
+
+/** Stall (microseconds[4], max ADI_SCRIPT_MAX_STALL_US) */
+#define ADI_SCRIPT_STALL						(0x04)
+
+/** Wait for an edge on a pin (pin[1], polarity[1], timeout ms[2]). Ends the script with a timeout error if no edge */
+#define ADI_SCRIPT_WAIT_EDGE					(0x05)
+
+/** Start of a loop body which runs count[2] times */
+#define ADI_SCRIPT_LOOP							(0x06)
+
+/** End of the innermost loop body (no operands) */
+#define ADI_SCRIPT_END_LOOP						(0x07)
+
+/** Jump to script byte offset target[2] if (last read value & mask[2]) == value[2] */
+#define ADI_SCRIPT_BRANCH_EQ					(0x08)
+
+/** Jump to script byte offset target[2] if (last read value & mask[2]) != value[2] */
+#define ADI_SCRIPT_BRANCH_NE					(0x09)
+
+#endif
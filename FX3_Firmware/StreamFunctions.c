@@ -18,11 +18,27 @@
 
 #include "StreamFunctions.h"
 
+/* Private function prototypes */
+static void AdiStreamRxCopyDisable();
+static void AdiStreamDmaChannelDestroy(uint8_t entry);
+static CyBool_t AdiStreamDmaSocketsShared(StreamDmaPoolEntry *poolEntry, CyU3PDmaChannelConfig_t *config);
+static uint32_t AdiLogicMappedPins();
+static CyU3PReturnStatus_t AdiBurstTxChainInit();
+static CyU3PReturnStatus_t AdiStreamStartCheck(CyBool_t ep0Pending);
+
+/** CRC32 (IEEE 802.3, reflected) lookup table, one entry per nibble to keep the table small */
+static const uint32_t StreamCrc32Table[16] = {
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+	0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
 /* Tell the compiler where to find the needed globals */
 extern CyU3PEvent EventHandler;
 extern CyU3PDmaChannel StreamingChannel;
 extern CyU3PDmaChannel MemoryToSPI;
+extern CyU3PDmaChannel StreamRxChannel;
 extern CyU3PDmaBuffer_t SpiDmaBuffer;
+extern CyU3PDmaBuffer_t StreamRxDmaBuffer;
 extern BoardState FX3State;
 extern volatile CyBool_t KillStreamEarly;
 extern StreamState StreamThreadState;
@@ -33,453 +49,1806 @@ extern uint8_t USBBuffer[4096];
 /** Global USB Buffer (Bulk Endpoints) */
 extern uint8_t BulkBuffer[12288];
 
+/** Stream DMA channels, kept created between streams (indexed by ADI_STREAM_DMA_*) */
+static StreamDmaPoolEntry StreamDmaPool[ADI_STREAM_DMA_POOL_SIZE] = {
+	{&StreamingChannel},
+	{&StreamRxChannel},
+	{&MemoryToSPI},
+	{0},
+	{0}
+};
+
+/** Track if the SPI pipe owns the PC to FX3 endpoint (True) or the bulk command channel does (False) */
+static CyBool_t SpiPipeActive = CyFalse;
+
+/** Length of the requested SPI pipe, in bytes */
+static uint32_t SpiPipeLength = 0;
+
+/** Status of the last SPI pipe start, returned by ADI_SPI_PIPE_STATUS_CMD */
+static CyU3PReturnStatus_t SpiPipeStatus = CY_U3P_SUCCESS;
+
 /**
   * @brief Configures 10MHz timer to control stall time for generic or transfer streams.
   *
   * @return void
   *
   * This function sets the timer period and enables the timer interrupt as required for the stream. For
-  * stall times less than the min (5 microseconds) the timer threshold is set to one timer tick.
+  * stall times less than the min (5 microseconds) the timer threshold is set to one timer tick. If the
+  * stream time stamps data ready edges (StreamThreadState.TimerFreeRun), the timer is left running free,
+  * so the time stamps share a time base with the timer read vendor commands.
  **/
 void AdiConfigStreamStallTimer()
 {
+	/* Calculate the stall time in timer ticks */
+	if((FX3State.StallTime * 10) < ADI_GENERIC_STALL_OFFSET)
+	{
+		StreamThreadState.StallTicks = 1;
+	}
+	else
+	{
+		StreamThreadState.StallTicks = (FX3State.StallTime * 10) - ADI_GENERIC_STALL_OFFSET;
+	}
+
 	/* Enable timer interrupts */
 	GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status &= (~CY_U3P_LPP_GPIO_INTRMODE_MASK);
 	GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status |= CY_U3P_GPIO_INTR_TIMER_THRES << CY_U3P_LPP_GPIO_INTRMODE_POS;
 
-	/* Set the timer pin threshold to correspond with the stall time */
-	if((FX3State.StallTime * 10) < ADI_GENERIC_STALL_OFFSET)
+	if(StreamThreadState.TimerFreeRun)
 	{
-		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].threshold = 1;
-		/* Set the timer pin period (useful for error case, timer register is manually reset) */
-		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].period = 2;
+		/* Let the timer run free for the time stamps. AdiRestartStreamStallTimer moves the threshold */
+		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].period = 0xFFFFFFFF;
+		AdiRestartStreamStallTimer();
 	}
 	else
 	{
-		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].threshold = (FX3State.StallTime * 10) - ADI_GENERIC_STALL_OFFSET;
+		/* Set the timer pin threshold to correspond with the stall time */
+		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].threshold = StreamThreadState.StallTicks;
 		/* Set the timer pin period (useful for error case, timer register is manually reset) */
-		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].period = (FX3State.StallTime * 10) - ADI_GENERIC_STALL_OFFSET + 1;
+		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].period = StreamThreadState.StallTicks + 1;
 	}
 }
 
 /**
-  * @brief This function sets a flag to notify the streaming thread that the user requested to cancel streaming.
+  * @brief Starts a new stall time period for generic or transfer streams.
   *
-  * @return A status code indicating the success of the function.
+  * @return void
   *
-  * This function can be used to stop any stream operation. The variable KillStreamEarly is defined as
-  * volatile to prevent any compiler optimizations which may remove it.
+  * This function is called after each SPI word. Normally the timer is reset to 0, so the threshold set
+  * in AdiConfigStreamStallTimer is reached once the stall time has passed. For streams which time stamp data
+  * ready edges (StreamThreadState.TimerFreeRun) the timer must keep counting, so the threshold is moved to one
+  * stall time past the current timer value instead.
  **/
-CyU3PReturnStatus_t AdiStopAnyDataStream()
+void AdiRestartStreamStallTimer()
 {
-	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-
-	/* Set the event mask to the stream enable events */
-	uint32_t eventMask = ADI_GENERIC_STREAM_ENABLE|ADI_RT_STREAM_ENABLE|ADI_BURST_STREAM_ENABLE|ADI_TRANSFER_STREAM_ENABLE|ADI_I2C_STREAM_ENABLE;
-
-	/* Variable to receive the event arguments into */
-	uint32_t eventFlags;
+	uint32_t intMask;
+	uint32_t stallTicks = StreamThreadState.StallTicks;
 
-	/* Check if any streams are enabled */
-	CyU3PEventGet (&EventHandler, eventMask, CYU3P_EVENT_OR, &eventFlags, CYU3P_NO_WAIT);
+	if(!StreamThreadState.TimerFreeRun)
+	{
+		/* Set the pin timer to 0 */
+		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].timer = 0;
+		/* clear interrupt flag */
+		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status |= CY_U3P_LPP_GPIO_INTR;
+		return;
+	}
 
-	/* If no events are set eventFlags will be 0 */
-	if(eventFlags == 0)
+	/* The threshold must not be passed before it is written */
+	if(stallTicks < ADI_TIMER_REARM_MARGIN)
 	{
-		status = CY_U3P_ERROR_NOT_STARTED;
+		stallTicks = ADI_TIMER_REARM_MARGIN;
 	}
 
-	/* Set kill stream early flag */
-	KillStreamEarly = CyTrue;
+	intMask = CyU3PVicDisableAllInterrupts();
+	/* Sample the timer into the threshold register, leaving the interrupt mode unchanged */
+	GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status = (GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status & ~(CY_U3P_LPP_GPIO_INTR | CY_U3P_LPP_GPIO_MODE_MASK)) | (CY_U3P_GPIO_MODE_SAMPLE_NOW << CY_U3P_LPP_GPIO_MODE_POS);
+	while (GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status & CY_U3P_LPP_GPIO_MODE_MASK);
+	/* Set the next threshold one stall time out */
+	GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].threshold += stallTicks;
+	/* clear interrupt flag */
+	GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status |= CY_U3P_LPP_GPIO_INTR;
+	CyU3PVicEnableInterrupts(intMask);
+}
 
-	/* Return status over USB */
-	AdiSendStatus(status, 4, CyTrue);
+/**
+  * @brief Reads the 10MHz timer while a stream is running.
+  *
+  * @return The current timer value
+  *
+  * Sampling the timer overwrites the threshold register, which holds the stall time during generic and
+  * transfer streams. The threshold is restored after the sample. If the stall time ran out (or is about
+  * to) while the sample was taken, the threshold is placed just past the current timer value so the
+  * stall timer interrupt is still generated. The sample itself matches the threshold, so the interrupt
+  * flag it raises is cleared again unless the flag was already set.
+ **/
+uint32_t AdiReadStreamTimer()
+{
+	uint32_t intMask, threshold, timerValue;
+	CyBool_t intrSet;
+
+	intMask = CyU3PVicDisableAllInterrupts();
+	threshold = GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].threshold;
+	intrSet = (CyBool_t) ((GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status & CY_U3P_LPP_GPIO_INTR) != 0);
+	/* Sample the timer into the threshold register, leaving the interrupt mode unchanged */
+	GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status = (GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status & ~(CY_U3P_LPP_GPIO_INTR | CY_U3P_LPP_GPIO_MODE_MASK)) | (CY_U3P_GPIO_MODE_SAMPLE_NOW << CY_U3P_LPP_GPIO_MODE_POS);
+	while (GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status & CY_U3P_LPP_GPIO_MODE_MASK);
+	timerValue = GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].threshold;
+	/* Restore the threshold */
+	if(((GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status & CY_U3P_LPP_GPIO_INTRMODE_MASK) == (CY_U3P_GPIO_INTR_TIMER_THRES << CY_U3P_LPP_GPIO_INTRMODE_POS))
+		&& ((int32_t)(threshold - timerValue) < ADI_TIMER_REARM_MARGIN))
+	{
+		threshold = timerValue + ADI_TIMER_REARM_MARGIN;
+	}
+	GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].threshold = threshold;
+	/* Clear the interrupt raised by the sample */
+	if(!intrSet)
+	{
+		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status |= CY_U3P_LPP_GPIO_INTR;
+	}
+	CyU3PVicEnableInterrupts(intMask);
 
-	/* return status code */
-	return status;
+	return timerValue;
 }
 
 /**
-  * @brief This function prints all the stream state variables to the terminal if VERBOSE_MODE is defined
+  * @brief Selects the data ready wait and time stamp modes for a new stream and clears the latency counters.
   *
-  * @return A status code indicating if the print occurred (returns false if VERBOSE_MODE is not defined).
+  * @return void
   *
-  * This function prints a significant amount of data, and as such is fairly slow in VERBOSE_MODE. The return value of
-  * this function can be used to determine if the running application firmware is set to verbose mode.
+  * Interrupt driven data ready waits are used when both FX3State.DrActive and FX3State.DrInterruptMode
+  * are set. Time stamps are added when FX3State.StreamTimestamps is set. The settings are latched for the
+  * duration of the stream. Must be called before the stream buffer sizes are calculated and before the
+  * stall timer is configured.
  **/
-CyBool_t AdiPrintStreamState()
+void AdiStreamDataReadyInit()
 {
-	CyBool_t verboseMode = CyFalse;
-
-#ifdef VERBOSE_MODE
-	verboseMode = CyTrue;
-	CyU3PDebugPrint (4, "Endpoint Transfer Size: %d\r\n", StreamThreadState.TransferByteLength);
-	CyU3PDebugPrint (4, "NumCaptures: %d NumBuffers: %d Bytes Per USB Packet: %d\r\n", StreamThreadState.NumCaptures, StreamThreadState.NumBuffers, StreamThreadState.BytesPerUsbPacket);
-	CyU3PDebugPrint (4, "DrActive is %d, with the data ready pin set to GPIO[%d]. DrPolarity is %d\r\n", FX3State.DrActive, FX3State.DrPin, FX3State.DrPolarity);
-	AdiPrintSpiConfig(AdiGetSpiConfig());
+	StreamThreadState.DrInterruptWait = (CyBool_t) (FX3State.DrActive && FX3State.DrInterruptMode);
+	StreamThreadState.TimestampsEnabled = FX3State.StreamTimestamps;
+#ifdef STREAM_PROFILE_MODE
+	StreamThreadState.TimerFreeRun = CyTrue;
+#else
+	StreamThreadState.TimerFreeRun = (CyBool_t) (StreamThreadState.DrInterruptWait || StreamThreadState.TimestampsEnabled);
 #endif
-
-	return verboseMode;
+	StreamThreadState.TimestampRollovers = 0;
+	StreamThreadState.LastTimestamp = 0;
+	StreamThreadState.DrEdgeTime = 0;
+	StreamThreadState.DrLatencyCount = 0;
+	StreamThreadState.DrLatencyMin = 0xFFFFFFFF;
+	StreamThreadState.DrLatencyMax = 0;
+	StreamThreadState.DrLatencyTotal = 0;
 }
 
 /**
-  * @brief Starts an I2C read stream.
+  * @brief Blocks the stream thread until the next data ready edge, using the GPIO ISR.
   *
-  * @return A status code indicating the success of the I2C stream start.
+  * @return A status code indicating if a data ready edge was received.
   *
-  * This function reads the I2C stream start request in from the control
-  * endpoint. It parses out the stream parameters from the buffer and
-  * configures the Stream DMA channel for I2C -> USB, with an infinite
-  * transfer.
+  * The GPIO interrupt vector is only enabled while waiting, since the GPIO ISR clears the pin interrupt
+  * flags, including the stall timer flag the stream workers poll. The wait times out every
+  * ADI_DR_INTERRUPT_POLL_MS to check for a stream cancel, so a stream with no data ready edges can still
+  * be stopped. Returns CY_U3P_ERROR_TIMEOUT if the stream was cancelled before an edge was received.
  **/
-CyU3PReturnStatus_t AdiI2CStreamStart()
+CyU3PReturnStatus_t AdiWaitForStreamDataReady()
 {
-	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-	uint32_t timeout, index;
-	uint16_t bytesRead;
-	CyU3PDmaChannelConfig_t i2cDmaConfig;
+	CyU3PReturnStatus_t status = CY_U3P_ERROR_TIMEOUT;
+	uint32_t eventFlag;
 
-	/* Get USB Data */
-	CyU3PUsbGetEP0Data(StreamThreadState.TransferByteLength, USBBuffer, &bytesRead);
+	/* Clear any stale edge, then wait for the next one */
+	CyU3PEventGet(&EventHandler, ADI_DATA_READY_INTERRUPT, CYU3P_EVENT_OR_CLEAR, &eventFlag, CYU3P_NO_WAIT);
+	GPIO->lpp_gpio_simple[FX3State.DrPin] |= CY_U3P_LPP_GPIO_INTR;
+	CyU3PVicEnableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
 
-	/* Parse USB data (number of bytes placed in numcaptures) */
-	index = I2CParseUSBBuffer(&timeout, &StreamThreadState.NumCaptures, &StreamThreadState.I2CStreamPreamble);
+	while((status != CY_U3P_SUCCESS) && !KillStreamEarly)
+	{
+		status = CyU3PEventGet(&EventHandler, ADI_DATA_READY_INTERRUPT, CYU3P_EVENT_OR_CLEAR, &eventFlag, ADI_DR_INTERRUPT_POLL_MS);
+	}
 
-	/* Number of buffers to capture follows after I2C read stream request data */
-	StreamThreadState.NumBuffers = USBBuffer[index];
-	StreamThreadState.NumBuffers |= (USBBuffer[index + 1] << 8);
-	StreamThreadState.NumBuffers |= (USBBuffer[index + 2] << 16);
-	StreamThreadState.NumBuffers |= (USBBuffer[index + 3] << 24);
+	CyU3PVicDisableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+	return status;
+}
 
-	/* Disable VBUS ISR */
-	CyU3PVicDisableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+/**
+  * @brief Records the time from the last data ready edge to the start of the SPI (or I2C) transfer.
+  *
+  * @return void
+  *
+  * Stream workers call this just before starting the first transfer after an interrupt driven data ready
+  * wait. The timer sample adds well under a microsecond to the measured latency.
+ **/
+void AdiRecordDataReadyLatency()
+{
+	uint32_t latency;
 
-	/* Disable GPIO interrupt before attaching interrupt to pin */
-	CyU3PVicDisableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+	latency = AdiReadStreamTimer() - StreamThreadState.DrEdgeTime;
+	StreamThreadState.DrLatencyCount++;
+	StreamThreadState.DrLatencyTotal += latency;
+	if(latency < StreamThreadState.DrLatencyMin)
+	{
+		StreamThreadState.DrLatencyMin = latency;
+	}
+	if(latency > StreamThreadState.DrLatencyMax)
+	{
+		StreamThreadState.DrLatencyMax = latency;
+	}
+}
 
-	/* Re-init I2C block in DMA mode */
-	AdiI2CInit(FX3State.I2CBitRate, CyTrue);
+/**
+  * @brief Sends the data ready latency counters for the last interrupt driven stream to the PC.
+  *
+  * @return void
+  *
+  * All values are little endian 10MHz timer ticks. USBBuffer[0-3] holds the status, [4-7] the number
+  * of samples, [8-11] the minimum latency, [12-15] the maximum latency and [16-23] the sum of all samples.
+  * The minimum is 0xFFFFFFFF if no samples were recorded.
+ **/
+void AdiGetDataReadyLatency()
+{
+	USBBuffer[4] = StreamThreadState.DrLatencyCount & 0xFF;
+	USBBuffer[5] = (StreamThreadState.DrLatencyCount & 0xFF00) >> 8;
+	USBBuffer[6] = (StreamThreadState.DrLatencyCount & 0xFF0000) >> 16;
+	USBBuffer[7] = (StreamThreadState.DrLatencyCount & 0xFF000000) >> 24;
+	USBBuffer[8] = StreamThreadState.DrLatencyMin & 0xFF;
+	USBBuffer[9] = (StreamThreadState.DrLatencyMin & 0xFF00) >> 8;
+	USBBuffer[10] = (StreamThreadState.DrLatencyMin & 0xFF0000) >> 16;
+	USBBuffer[11] = (StreamThreadState.DrLatencyMin & 0xFF000000) >> 24;
+	USBBuffer[12] = StreamThreadState.DrLatencyMax & 0xFF;
+	USBBuffer[13] = (StreamThreadState.DrLatencyMax & 0xFF00) >> 8;
+	USBBuffer[14] = (StreamThreadState.DrLatencyMax & 0xFF0000) >> 16;
+	USBBuffer[15] = (StreamThreadState.DrLatencyMax & 0xFF000000) >> 24;
+	USBBuffer[16] = StreamThreadState.DrLatencyTotal & 0xFF;
+	USBBuffer[17] = (StreamThreadState.DrLatencyTotal >> 8) & 0xFF;
+	USBBuffer[18] = (StreamThreadState.DrLatencyTotal >> 16) & 0xFF;
+	USBBuffer[19] = (StreamThreadState.DrLatencyTotal >> 24) & 0xFF;
+	USBBuffer[20] = (StreamThreadState.DrLatencyTotal >> 32) & 0xFF;
+	USBBuffer[21] = (StreamThreadState.DrLatencyTotal >> 40) & 0xFF;
+	USBBuffer[22] = (StreamThreadState.DrLatencyTotal >> 48) & 0xFF;
+	USBBuffer[23] = (StreamThreadState.DrLatencyTotal >> 56) & 0xFF;
+	AdiSendStatus(CY_U3P_SUCCESS, 24, CyTrue);
+}
 
-	/* Configure data ready interrupts */
-	if(FX3State.DrActive)
-		AdiConfigureDrPin();
+/**
+  * @brief Gets the 64-bit time stamp for the most recent data ready edge.
+  *
+  * @return The complex GPIO timer value at the data ready edge, extended to 64 bits
+  *
+  * For interrupt driven data ready waits this is the timer value sampled in the GPIO ISR. Otherwise the
+  * timer is sampled when this function is called, so stream workers call it as soon as the data ready
+  * wait finishes. The lower 32 bits are the raw timer value (same time base as the timer read vendor
+  * commands) and the upper 32 bits count the timer rollovers since the stream started. The timer rolls
+  * over about every seven minutes, so at least one sample must be taken in that time.
+ **/
+uint64_t AdiGetStreamTimestamp()
+{
+	uint32_t timerValue;
 
-	/* Configure StreamChannel for I2C to USB automatic DMA */
-    CyU3PMemSet ((uint8_t *)&i2cDmaConfig, 0, sizeof(i2cDmaConfig));
-    i2cDmaConfig.size           = StreamThreadState.NumCaptures;
-    i2cDmaConfig.count          = 16;
-    i2cDmaConfig.prodAvailCount = 0;
-    i2cDmaConfig.dmaMode        = CY_U3P_DMA_MODE_BYTE;
-    i2cDmaConfig.prodHeader     = 0;
-    i2cDmaConfig.prodFooter     = 0;
-    i2cDmaConfig.consHeader     = 0;
-    i2cDmaConfig.notification   = 0;
-    i2cDmaConfig.cb             = NULL;
-    i2cDmaConfig.prodSckId = CY_U3P_LPP_SOCKET_I2C_PROD;
-    i2cDmaConfig.consSckId = CY_U3P_UIB_SOCKET_CONS_1;
-    status = CyU3PDmaChannelCreate(&StreamingChannel, CY_U3P_DMA_TYPE_AUTO, &i2cDmaConfig);
-	if(status != CY_U3P_SUCCESS)
+	if(StreamThreadState.DrInterruptWait)
 	{
-		AdiLogError(StreamFunctions_c, __LINE__, status);
-		AdiAppErrorHandler(status);
+		timerValue = StreamThreadState.DrEdgeTime;
+	}
+	else
+	{
+		timerValue = AdiReadStreamTimer();
 	}
 
-	/* Log stream state in vebose mode */
-	AdiPrintStreamState();
+	/* Track timer rollover */
+	if(timerValue < StreamThreadState.LastTimestamp)
+	{
+		StreamThreadState.TimestampRollovers++;
+	}
+	StreamThreadState.LastTimestamp = timerValue;
 
-	/* Flush streaming endpoint */
-	CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+	return (((uint64_t) StreamThreadState.TimestampRollovers) << 32) | timerValue;
+}
 
-	/* Enable an infinite DMA transfer on the streaming channel */
-	status = CyU3PDmaChannelSetXfer(&StreamingChannel, 0);
-	if(status != CY_U3P_SUCCESS)
+/**
+  * @brief Finds the number of bytes to place in each USB buffer for a stream.
+  *
+  * @param bytesPerBuffer The number of bytes produced per stream "buffer" (one data ready)
+  *
+  * @return The largest whole number of stream buffers which fit in a USB buffer, in bytes.
+  *
+  * If a single stream buffer is larger than a USB buffer, the stream buffers are split across
+  * USB buffers, and the full USB buffer size is returned. The space reserved for the frame header
+  * is not available for stream data, and the USB buffer size is set by the stream buffer packet count
+  * (StreamThreadState.UsbBufferBytes), so AdiStreamFrameInit must be called first.
+ **/
+uint32_t AdiStreamBytesPerUsbPacket(uint32_t bytesPerBuffer)
+{
+	uint32_t usbBytes = StreamThreadState.UsbBufferBytes - StreamThreadState.FrameHeaderBytes;
+
+	if(bytesPerBuffer > usbBytes)
 	{
-		AdiLogError(StreamFunctions_c, __LINE__, status);
-		AdiAppErrorHandler(status);
+		return usbBytes;
 	}
+	return ((usbBytes / bytesPerBuffer) * bytesPerBuffer);
+}
 
-	/* Set the burst stream flag to notify the streaming thread it should take over */
-	CyU3PEventSet (&EventHandler, ADI_I2C_STREAM_ENABLE, CYU3P_EVENT_OR);
+/**
+  * @brief Finds the number of streaming DMA buffers to allocate for a CPU filled stream.
+  *
+  * @param singlePacketCount The number of buffers the stream uses with single packet USB buffers
+  *
+  * @return The buffer count for the current USB buffer size (StreamThreadState.UsbBufferBytes).
+  *
+  * Multi packet buffers keep about the same total buffer memory as the single packet case, with
+  * at least ADI_STREAM_MIN_USB_BUFFER_COUNT buffers so the CPU can fill one while others are sent.
+ **/
+uint16_t AdiStreamUsbBufferCount(uint16_t singlePacketCount)
+{
+	uint32_t count;
 
-	return status;
+	if(!StreamThreadState.ExactCommits)
+	{
+		return singlePacketCount;
+	}
+	count = (singlePacketCount * FX3State.UsbBufferSize) / StreamThreadState.UsbBufferBytes;
+	if(count < ADI_STREAM_MIN_USB_BUFFER_COUNT)
+	{
+		count = ADI_STREAM_MIN_USB_BUFFER_COUNT;
+	}
+	return (uint16_t) count;
 }
 
 /**
-  * @brief Cleans up an I2C read stream.
+  * @brief Finds the number of streaming DMA buffers to allocate for an auto DMA stream.
   *
-  * @return A status code indicating the success of the I2C stream clean up.
+  * @param usbPacketCount The number of USB packets of buffering the stream uses
   *
-  * This function detroys the StreamingChannel DMA which was set up to allow
-  * I2C -> USB DMA. It also flushes the relevant endpoint and reconfigures the
-  * I2C to operate in register mode.
+  * @return The buffer count for the current streaming DMA buffer size (FX3State.StreamDmaBufferSize).
+  *
+  * At SuperSpeed each buffer holds a full endpoint burst, so the count drops to keep the same
+  * total buffer memory, with at least ADI_STREAM_MIN_DMA_BUFFER_COUNT buffers to double buffer.
  **/
-CyU3PReturnStatus_t AdiI2CStreamFinished()
+uint16_t AdiStreamDmaBufferCount(uint16_t usbPacketCount)
 {
-	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-
-    /* Destroy the stream DMA channel */
-    status = CyU3PDmaChannelDestroy(&StreamingChannel);
+	uint32_t count;
 
-	/* Flush the streaming end point */
-	status |= CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+	count = (usbPacketCount * FX3State.UsbBufferSize) / FX3State.StreamDmaBufferSize;
+	if(count < ADI_STREAM_MIN_DMA_BUFFER_COUNT)
+	{
+		count = ADI_STREAM_MIN_DMA_BUFFER_COUNT;
+	}
+	return (uint16_t) count;
+}
 
-	/* Re-init I2C in register mode */
-	AdiI2CInit(FX3State.I2CBitRate, CyFalse);
+/**
+  * @brief Sets up a DMA channel to receive stream data from a peripheral into CPU memory.
+  *
+  * @param prodSocket The peripheral producer socket (SPI or I2C)
+  *
+  * @param numBytes The number of bytes received per transfer
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * This is used by streams where the CPU must handle the data before it is sent to the PC (time stamped
+  * or framed burst, I2C and real time streams). The receive buffer is StreamRxDmaBuffer.
+  * The channel and buffer come from the stream DMA channel pool, and must be released with
+  * AdiStreamRxChannelRelease when the stream is finished.
+ **/
+CyU3PReturnStatus_t AdiStreamRxChannelSetup(CyU3PDmaSocketId_t prodSocket, uint32_t numBytes)
+{
+	CyU3PDmaChannelConfig_t dmaConfig;
+	uint32_t roundedBytes;
 
-	/* Clear all interrupt flags */
-	CyU3PVicClearInt();
+	/* Calculate the required memory block (in bytes) to be a multiple of 16 */
+	roundedBytes = numBytes;
+	if(roundedBytes % 16)
+	{
+		roundedBytes += 16 - (roundedBytes % 16);
+	}
+	if(roundedBytes > ADI_STREAM_DMA_MAX_BYTES)
+	{
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	}
 
-	/* Re-enable relevant ISRs */
-	CyU3PVicEnableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
-	CyU3PVicEnableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+	/* Get the receive buffer */
+	CyU3PMemSet ((uint8_t *)&StreamRxDmaBuffer, 0, sizeof(StreamRxDmaBuffer));
+	StreamRxDmaBuffer.buffer = AdiStreamDmaBufferGet(ADI_STREAM_DMA_RX, roundedBytes);
+	if(StreamRxDmaBuffer.buffer == 0)
+	{
+		return CY_U3P_ERROR_MEMORY_ERROR;
+	}
+	StreamRxDmaBuffer.size = roundedBytes;
 
-	/* Clear stream kill flag */
-	KillStreamEarly = CyFalse;
+	/* Configure the peripheral to memory (Rx) channel */
+	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
+	dmaConfig.size 				= roundedBytes;
+	dmaConfig.count 			= 0;
+	dmaConfig.prodSckId 		= prodSocket;
+	dmaConfig.consSckId 		= CY_U3P_CPU_SOCKET_CONS;
+	dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
+	return AdiStreamDmaChannelGet(ADI_STREAM_DMA_RX, CY_U3P_DMA_TYPE_MANUAL_IN, &dmaConfig);
+}
 
-	return status;
+/**
+  * @brief Releases the stream receive DMA channel and buffer back to the stream DMA channel pool.
+  *
+  * @return void
+ **/
+void AdiStreamRxChannelRelease()
+{
+	AdiStreamDmaChannelRelease(ADI_STREAM_DMA_RX);
+	StreamRxDmaBuffer.buffer = 0;
 }
 
 /**
-  * @brief Starts a protocol agnostic SPI transfer stream.
+  * @brief Gets a stream DMA channel from the stream DMA channel pool, ready for a new transfer.
   *
-  * @return A status code indicating the success of the transfer stream start.
+  * @param entry The pool entry (ADI_STREAM_DMA_*) for the channel
   *
-  * This is used to implement the ISpi32Interface. The stream info is read in from EP0 into
-  * the USBBuffer. This includes stream parameters and the MOSI data. Any error encountered
-  * during stream setup will result in a system reboot, after the error data is logged
-  * to flash memory.
+  * @param type The DMA channel type
+  *
+  * @param config The DMA channel configuration. Callbacks are not supported.
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * Each stream DMA channel is kept created when a stream finishes. If the next stream asks for the same
+  * channel type, sockets, buffer size and buffer count, the existing channel is reset and reused, which
+  * avoids the DMA buffer heap allocations in CyU3PDmaChannelCreate on every stream start. Otherwise the
+  * channel is destroyed and created again with the new configuration. A peripheral socket can only be
+  * attached to one channel, so any other pooled channel sharing a socket with the new configuration is
+  * destroyed first. If the DMA buffer heap is too fragmented to create the channel, the whole pool is
+  * released and the create is retried once.
  **/
-CyU3PReturnStatus_t AdiTransferStreamStart()
+CyU3PReturnStatus_t AdiStreamDmaChannelGet(uint8_t entry, CyU3PDmaType_t type, CyU3PDmaChannelConfig_t *config)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-	uint16_t bytesRead;
-
-	/* Get the data from the control endpoint */
-	status = CyU3PUsbGetEP0Data(StreamThreadState.TransferByteLength, USBBuffer, &bytesRead);
-	if(status != CY_U3P_SUCCESS)
+	StreamDmaPoolEntry *poolEntry = &StreamDmaPool[entry];
+	uint8_t index;
+
+	/* Reuse the channel if it matches the requested configuration */
+	if(poolEntry->Created &&
+		(poolEntry->Type == type) &&
+		(poolEntry->ProdSckId == config->prodSckId) &&
+		(poolEntry->ConsSckId == config->consSckId) &&
+		(poolEntry->Size == config->size) &&
+		(poolEntry->Count == config->count))
 	{
+		status = CyU3PDmaChannelReset(poolEntry->Channel);
+		if(status == CY_U3P_SUCCESS)
+		{
+			return status;
+		}
 		AdiLogError(StreamFunctions_c, __LINE__, status);
-		AdiAppErrorHandler(status);
 	}
 
-	/* Parse control endpoint data. The data is formatted as follows
-	 * NumCaptures[0-3], NumBuffers[4-7], BytesPerUSBBuffer[8-11], MOSIData.Count()[12-13], MOSIData[14 - ...] */
+	/* Free the sockets for the new channel */
+	for(index = 0; index < ADI_STREAM_DMA_POOL_SIZE; index++)
+	{
+		if((index == entry) || AdiStreamDmaSocketsShared(&StreamDmaPool[index], config))
+		{
+			AdiStreamDmaChannelDestroy(index);
+		}
+	}
 
-	/* Number of times to transfer the MOSI data list per data ready*/
-	StreamThreadState.NumCaptures = USBBuffer[0];
-	StreamThreadState.NumCaptures |= (USBBuffer[1] << 8);
-	StreamThreadState.NumCaptures |= (USBBuffer[2] << 16);
-	StreamThreadState.NumCaptures |= (USBBuffer[3] << 24);
+	status = CyU3PDmaChannelCreate(poolEntry->Channel, type, config);
+	if(status != CY_U3P_SUCCESS)
+	{
+		/* Release all the pooled channels (but not the buffers in use) and try again */
+		for(index = 0; index < ADI_STREAM_DMA_POOL_SIZE; index++)
+		{
+			AdiStreamDmaChannelDestroy(index);
+		}
+		status = CyU3PDmaChannelCreate(poolEntry->Channel, type, config);
+		if(status != CY_U3P_SUCCESS)
+		{
+			return status;
+		}
+	}
 
-	/* Total number of buffers to transfer (one buffer is going through MOSIData numCaptures times)*/
-	StreamThreadState.NumBuffers = USBBuffer[4];
-	StreamThreadState.NumBuffers |= (USBBuffer[5] << 8);
-	StreamThreadState.NumBuffers |= (USBBuffer[6] << 16);
-	StreamThreadState.NumBuffers |= (USBBuffer[7] << 24);
-
-	/* Number of bytes to place in a single USB packet before transmitting */
-	StreamThreadState.BytesPerUsbPacket = USBBuffer[8];
-	StreamThreadState.BytesPerUsbPacket |= (USBBuffer[9] << 8);
-	StreamThreadState.BytesPerUsbPacket |= (USBBuffer[10] << 16);
-	StreamThreadState.BytesPerUsbPacket |= (USBBuffer[11] << 24);
-
-	/* This is just the number of bytes in MOSI data */
-	StreamThreadState.BytesPerBuffer = USBBuffer[12];
-	StreamThreadState.BytesPerBuffer |= (USBBuffer[13] << 8);
-
-	AdiPrintStreamState();
+	poolEntry->Created = CyTrue;
+	poolEntry->Type = type;
+	poolEntry->ProdSckId = config->prodSckId;
+	poolEntry->ConsSckId = config->consSckId;
+	poolEntry->Size = config->size;
+	poolEntry->Count = config->count;
+	return status;
+}
 
-	/* Disable VBUS ISR */
-	CyU3PVicDisableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+/**
+  * @brief Returns a stream DMA channel to the stream DMA channel pool at the end of a stream.
+  *
+  * @param entry The pool entry (ADI_STREAM_DMA_*) for the channel
+  *
+  * @return void
+  *
+  * The channel is reset, which aborts any transfer in progress, but is not destroyed. Channels attached to
+  * the I2C sockets are destroyed, since the flash memory interface creates its own I2C channels, as are
+  * channels attached to the PC to FX3 endpoint socket, which belongs to the bulk command channel outside
+  * of the SPI pipe. The buffer owned by the entry is always kept.
+ **/
+void AdiStreamDmaChannelRelease(uint8_t entry)
+{
+	CyU3PReturnStatus_t status;
+	StreamDmaPoolEntry *poolEntry = &StreamDmaPool[entry];
 
-	/* Disable GPIO interrupt before attaching interrupt to pin */
-	CyU3PVicDisableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+	if(!poolEntry->Created)
+	{
+		return;
+	}
 
-	/* If using DR triggering configure the selected pin as an input with the correct polarity */
-	if(FX3State.DrActive)
+	if((poolEntry->ProdSckId == CY_U3P_LPP_SOCKET_I2C_PROD) || (poolEntry->ConsSckId == CY_U3P_LPP_SOCKET_I2C_CONS) ||
+		(poolEntry->ProdSckId == CY_U3P_UIB_SOCKET_PROD_1))
 	{
-		/* Configure the pin as an input with interrupts enabled on the selected edge */
-		AdiConfigureDrPin();
+		AdiStreamDmaChannelDestroy(entry);
+		return;
 	}
 
-	/* Flush the streaming endpoint */
-	status = CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+	status = CyU3PDmaChannelReset(poolEntry->Channel);
 	if(status != CY_U3P_SUCCESS)
 	{
 		AdiLogError(StreamFunctions_c, __LINE__, status);
-		AdiAppErrorHandler(status);
+		AdiStreamDmaChannelDestroy(entry);
 	}
+}
 
-	/* Configure the StreamingChannel DMA (SPI to PC) */
-	CyU3PDmaChannelConfig_t dmaConfig;
-	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
-	dmaConfig.size 				= FX3State.UsbBufferSize;
-	dmaConfig.count 			= 8;
-	dmaConfig.prodSckId 		= CY_U3P_CPU_SOCKET_PROD;
-	dmaConfig.consSckId 		= CY_U3P_UIB_SOCKET_CONS_1;
-	dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
-	dmaConfig.prodHeader    	= 0;
-	dmaConfig.prodFooter    	= 0;
-	dmaConfig.consHeader    	= 0;
-	dmaConfig.notification  	= 0;
-	dmaConfig.cb            	= NULL;
-	dmaConfig.prodAvailCount	= 0;
+/**
+  * @brief Gets the CPU side DMA buffer owned by a stream DMA channel pool entry.
+  *
+  * @param entry The pool entry (ADI_STREAM_DMA_*)
+  *
+  * @param numBytes The required buffer size. Must be a multiple of 16, and fit the 16 bit DMA buffer allocator size.
+  *
+  * @return Pointer to the buffer, or 0 if it could not be allocated.
+  *
+  * The buffer is only re-allocated when a stream needs a larger buffer than any previous stream, so
+  * repeated stream starts do not allocate from (or fragment) the DMA buffer heap.
+ **/
+uint8_t *AdiStreamDmaBufferGet(uint8_t entry, uint32_t numBytes)
+{
+	StreamDmaPoolEntry *poolEntry = &StreamDmaPool[entry];
 
-	CyU3PDmaChannelDestroy(&StreamingChannel);
-	status = CyU3PDmaChannelCreate(&StreamingChannel, CY_U3P_DMA_TYPE_MANUAL_OUT, &dmaConfig);
-	if(status != CY_U3P_SUCCESS)
+	if(numBytes > 0xFFFF)
 	{
-		AdiLogError(StreamFunctions_c, __LINE__, status);
-		AdiAppErrorHandler(status);
+		return 0;
 	}
 
-	/* Set DMA transfer mode */
-	status = CyU3PDmaChannelSetXfer(&StreamingChannel, 0);
-	if(status != CY_U3P_SUCCESS)
+	if(poolEntry->BufferBytes < numBytes)
 	{
-		AdiLogError(StreamFunctions_c, __LINE__, status);
-		AdiAppErrorHandler(status);
+		if(poolEntry->Buffer)
+		{
+			CyU3PDmaBufferFree(poolEntry->Buffer);
+		}
+		poolEntry->BufferBytes = 0;
+		poolEntry->Buffer = CyU3PDmaBufferAlloc(numBytes);
+		if(poolEntry->Buffer == 0)
+		{
+			return 0;
+		}
+		poolEntry->BufferBytes = numBytes;
 	}
+	return poolEntry->Buffer;
+}
 
-	/* Enable timer hardware for stall */
-	AdiConfigStreamStallTimer();
+/**
+  * @brief Destroys all the stream DMA channels and frees their buffers.
+  *
+  * @return void
+  *
+  * This must only be called while no stream is running. It is used when the USB connection is torn down.
+ **/
+void AdiStreamDmaPoolFlush()
+{
+	uint8_t index;
 
-	/* Enable generic data capture thread */
-	status = CyU3PEventSet(&EventHandler, ADI_TRANSFER_STREAM_ENABLE, CYU3P_EVENT_OR);
+	for(index = 0; index < ADI_STREAM_DMA_POOL_SIZE; index++)
+	{
+		AdiStreamDmaChannelDestroy(index);
+		if(StreamDmaPool[index].Buffer)
+		{
+			CyU3PDmaBufferFree(StreamDmaPool[index].Buffer);
+		}
+		StreamDmaPool[index].Buffer = 0;
+		StreamDmaPool[index].BufferBytes = 0;
+	}
+	StreamRxDmaBuffer.buffer = 0;
+	SpiDmaBuffer.buffer = 0;
+}
 
-	/* Return status code */
-	return status;
+/**
+  * @brief Destroys the DMA channel for a stream DMA channel pool entry, if it is created.
+  *
+  * @param entry The pool entry (ADI_STREAM_DMA_*)
+  *
+  * @return void
+ **/
+static void AdiStreamDmaChannelDestroy(uint8_t entry)
+{
+	if(StreamDmaPool[entry].Created)
+	{
+		CyU3PDmaChannelDestroy(StreamDmaPool[entry].Channel);
+		StreamDmaPool[entry].Created = CyFalse;
+	}
 }
 
 /**
-  * @brief Cleans up a protocol agnostic transfer stream.
+  * @brief Checks if a pooled channel uses a peripheral socket required by a new channel configuration.
   *
-  * @return A status code indicating the success of the function.
+  * @param poolEntry The pool entry to check
   *
-  * Resets the streaming endpoint, destroys the DMA channel, and restores the interrupt
-  * source states to their standard operating condition. Must be explicitly invoked via a
-  * vendor command when all "buffers" or captured, or indirectly via a TransferStream cancel.
-  * This function currently just calls the GenericStreamFinished implementation.
+  * @param config The new channel configuration
+  *
+  * @return CyTrue if the pooled channel must be destroyed before the new channel is created.
  **/
-CyU3PReturnStatus_t AdiTransferStreamFinished()
+static CyBool_t AdiStreamDmaSocketsShared(StreamDmaPoolEntry *poolEntry, CyU3PDmaChannelConfig_t *config)
 {
-	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	if(!poolEntry->Created)
+	{
+		return CyFalse;
+	}
 
-	/* Call generic stream finished, since the same resources are used */
-	status = AdiGenericStreamFinished();
+	if((poolEntry->ProdSckId != CY_U3P_CPU_SOCKET_PROD) && (poolEntry->ProdSckId == config->prodSckId))
+	{
+		return CyTrue;
+	}
 
-	/* Return status code */
-	return status;
+	if((poolEntry->ConsSckId != CY_U3P_CPU_SOCKET_CONS) && (poolEntry->ConsSckId == config->consSckId))
+	{
+		return CyTrue;
+	}
+
+	return CyFalse;
 }
 
 /**
-  * @brief Starts a real time stream for ADcmXLx021 DUTs
+  * @brief Falls back to a direct peripheral to USB DMA stream when the receive channel can't be set up.
   *
-  * @return The status of starting a real-time stream.
+  * @return void
   *
-  * This function kicks off a real-time stream by configuring interrupts, SPI, and end points.
-  * It also optionally toggles the SYNC/RTS pin if requested. At the end of the function, the
-  * bit assigned to enable the capture thread is toggled to signal the streaming thread to start producing data.
+  * Time stamps, frame headers, dropping samples on overflow and the pre-trigger capture all need the CPU
+  * to handle the stream data, so they are all disabled.
  **/
-CyU3PReturnStatus_t AdiRealTimeStreamStart()
+static void AdiStreamRxCopyDisable()
 {
-	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-	uint16_t bytesRead;
-	uint8_t tempWriteBuffer[2];
-	uint8_t tempReadBuffer[2];
+	StreamThreadState.RxCopyMode = CyFalse;
+	StreamThreadState.OverflowPolicy = ADI_STREAM_OVERFLOW_BLOCK;
+	StreamThreadState.CaptureActive = CyFalse;
+	StreamThreadState.TimestampsEnabled = CyFalse;
+	StreamThreadState.FramingEnabled = CyFalse;
+	StreamThreadState.FrameCrcEnabled = CyFalse;
+	StreamThreadState.FrameHeaderBytes = 0;
+	StreamThreadState.UsbAutoDma = CyTrue;
+}
 
-	/* Disable GPIO ISR (Interrupt functionality still active) */
-	CyU3PVicDisableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+/**
+  * @brief Selects the frame header mode for a new stream and clears the frame and statistics counters.
+  *
+  * @param streamType The stream type reported in each frame header (ADI_STREAM_FRAME_TYPE_*)
+  *
+  * @return void
+  *
+  * The frame mode is latched from FX3State.StreamFrameMode for the duration of the stream. Must be
+  * called after AdiStreamDataReadyInit and before the stream buffer sizes are calculated. Burst, I2C and
+  * real time streams normally DMA straight from the peripheral to USB, so when they need to be framed or
+  * time stamped (RxCopyMode) the data is received to CPU memory and copied to the USB buffers instead.
+  * Real time streams are not time stamped. The overflow policy is also latched here, and any policy
+  * other than block uses RxCopyMode, since only the stream thread can drop samples.
+ **/
+void AdiStreamFrameInit(uint8_t streamType)
+{
+	uint32_t packets;
 
-	/* Disable VBUS ISR */
-	CyU3PVicDisableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+	StreamThreadState.FramingEnabled = (CyBool_t) (FX3State.StreamFrameMode != ADI_STREAM_FRAME_OFF);
+	StreamThreadState.FrameCrcEnabled = (CyBool_t) (FX3State.StreamFrameMode == ADI_STREAM_FRAME_CRC);
+	StreamThreadState.FrameHeaderBytes = 0;
+	if(StreamThreadState.FramingEnabled)
+	{
+		StreamThreadState.FrameHeaderBytes = ADI_STREAM_FRAME_HEADER_BYTES;
+	}
 
-	/* Clear all interrupt flags */
-	CyU3PVicClearInt();
+	/* Burst and generic streams store their samples in the capture ring when a capture is set up */
+	StreamThreadState.CaptureActive = (CyBool_t) ((FX3State.Capture.PostSamples != 0) &&
+			((streamType == ADI_STREAM_FRAME_TYPE_BURST) || (streamType == ADI_STREAM_FRAME_TYPE_GENERIC)));
+	StreamThreadState.CaptureError = CY_U3P_SUCCESS;
+	StreamThreadState.CaptureTriggered = CyFalse;
+	StreamThreadState.CaptureDone = CyFalse;
+	StreamThreadState.CaptureHostTrigger = CyFalse;
+	StreamThreadState.CaptureEdgeSeen = CyFalse;
+	StreamThreadState.CaptureHaveLast = CyFalse;
+	StreamThreadState.CaptureWriteSlot = 0;
+	StreamThreadState.CaptureStored = 0;
+	StreamThreadState.CapturePostStored = 0;
+	StreamThreadState.CaptureTriggerSample = 0;
+
+	/* Samples can only be dropped or stored by the stream thread, so overflow policies other than block and
+	 * captures copy through CPU memory */
+	StreamThreadState.OverflowPolicy = FX3State.StreamOverflowPolicy;
+	StreamThreadState.RxCopyMode = (CyBool_t) (StreamThreadState.FramingEnabled || StreamThreadState.CaptureActive ||
+			(StreamThreadState.OverflowPolicy != ADI_STREAM_OVERFLOW_BLOCK));
+	if(streamType != ADI_STREAM_FRAME_TYPE_REAL_TIME)
+	{
+		StreamThreadState.RxCopyMode |= StreamThreadState.TimestampsEnabled;
+	}
 
-	/* Make sure the BUSY pin is configured as input (DIO2) */
-	CyU3PGpioSimpleConfig_t gpioConfig;
-	gpioConfig.outValue = CyFalse;
-	gpioConfig.inputEn = CyTrue;
-	gpioConfig.driveLowEn = CyFalse;
-	gpioConfig.driveHighEn = CyFalse;
-	gpioConfig.intrMode = CY_U3P_GPIO_INTR_POS_EDGE;
-	CyU3PGpioSetSimpleConfig(FX3State.DrPin, &gpioConfig);
+	/* Generic and transfer streams always fill the USB buffers from the CPU */
+	StreamThreadState.UsbAutoDma = (CyBool_t) (!StreamThreadState.RxCopyMode && ((streamType == ADI_STREAM_FRAME_TYPE_REAL_TIME)
+			|| (streamType == ADI_STREAM_FRAME_TYPE_BURST) || (streamType == ADI_STREAM_FRAME_TYPE_I2C)));
 
-	/* Get number of frames to capture from control endpoint */
-	CyU3PUsbGetEP0Data(5, USBBuffer, &bytesRead);
-	StreamThreadState.NumRealTimeCaptures = USBBuffer[0];
-	StreamThreadState.NumRealTimeCaptures += (USBBuffer[1] << 8);
-	StreamThreadState.NumRealTimeCaptures += (USBBuffer[2] << 16);
-	StreamThreadState.NumRealTimeCaptures += (USBBuffer[3] << 24);
+	/* Real time streams always wait on the BUSY pin, the other streams only if data ready is enabled */
+	StreamThreadState.DrMissCheck = (CyBool_t) ((streamType == ADI_STREAM_FRAME_TYPE_REAL_TIME) || FX3State.DrActive);
 
-	/* Get pin start setting */
-	StreamThreadState.PinStartEnable = (CyBool_t) USBBuffer[4];
+	/* Size the CPU filled USB buffers. Multi packet buffers are committed with only their valid bytes */
+	packets = FX3State.StreamBufferPackets;
+	if(packets > (ADI_STREAM_MAX_USB_BUFFER_BYTES / FX3State.UsbBufferSize))
+	{
+		packets = ADI_STREAM_MAX_USB_BUFFER_BYTES / FX3State.UsbBufferSize;
+	}
+	if(packets == 0)
+	{
+		packets = 1;
+	}
+	StreamThreadState.UsbBufferBytes = packets * FX3State.UsbBufferSize;
+	StreamThreadState.ExactCommits = (CyBool_t) (packets > 1);
 
-	/* Flush streaming end point */
-	CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+	/* The drop newest policy fills a discard buffer until the PC frees a USB buffer */
+	StreamThreadState.Discarding = CyFalse;
+	StreamThreadState.DiscardBuffer = 0;
+	if(StreamThreadState.OverflowPolicy == ADI_STREAM_OVERFLOW_DROP_NEWEST)
+	{
+		StreamThreadState.DiscardBuffer = AdiStreamDmaBufferGet(ADI_STREAM_DMA_DISCARD, StreamThreadState.UsbBufferBytes);
+		if(StreamThreadState.DiscardBuffer == 0)
+		{
+			AdiLogError(StreamFunctions_c, __LINE__, CY_U3P_ERROR_MEMORY_ERROR);
+			StreamThreadState.OverflowPolicy = ADI_STREAM_OVERFLOW_BLOCK;
+		}
+	}
+	StreamThreadState.SamplesAtCommit = 0;
+	StreamThreadState.CommitCount = 0;
+	StreamThreadState.CommitBytesTotal = 0;
+
+	StreamThreadState.FrameStreamType = streamType;
+	StreamThreadState.FrameFlags = 0;
+	ADI_TRACE(TraceStreamStart, streamType, FX3State.DrActive);
+	StreamThreadState.FrameSamples = 0;
+	StreamThreadState.FrameSequence = 0;
+
+	CyU3PMemSet ((uint8_t *)&StreamThreadState.Stats, 0, sizeof(StreamThreadState.Stats));
+	StreamThreadState.Stats.Active = CyTrue;
+}
 
-	/* Configure RTS channel DMA */
-	CyU3PDmaChannelConfig_t dmaConfig;
-	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
-	dmaConfig.size 				= FX3State.UsbBufferSize;
-	dmaConfig.count 			= 64;
-	dmaConfig.prodSckId 		= CY_U3P_LPP_SOCKET_SPI_PROD;
-	dmaConfig.consSckId 		= CY_U3P_UIB_SOCKET_CONS_1;
-	dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
-	dmaConfig.prodHeader    	= 0;
-	dmaConfig.prodFooter    	= 0;
-	dmaConfig.consHeader    	= 0;
-	dmaConfig.notification  	= 0;
-	dmaConfig.cb            	= NULL;
-	dmaConfig.prodAvailCount	= 0;
 
-    /* Configure DMA for RealTimeStreamingChannel */
-    status = CyU3PDmaChannelCreate(&StreamingChannel, CY_U3P_DMA_TYPE_AUTO, &dmaConfig);
-	if(status != CY_U3P_SUCCESS)
+/**
+  * @brief Writes the frame header for a USB buffer which is ready to be committed, and starts the next frame.
+  *
+  * @param frame Pointer to the start of the USB buffer
+  *
+  * @param payloadBytes The number of stream data bytes placed after the frame header
+  *
+  * @return void
+  *
+  * The header is ADI_STREAM_FRAME_HEADER_BYTES long, little endian: [0-1] sync word (ADI_STREAM_FRAME_SYNC),
+  * [2] stream type, [3] flags, [4-7] frame sequence number, [8-9] number of samples started in the frame,
+  * [10-11] payload bytes, [12-15] CRC32 of the payload (0 if CRC is disabled). Bytes in the USB buffer past
+  * the payload are not valid.
+ **/
+void AdiStreamCloseFrame(uint8_t *frame, uint32_t payloadBytes)
+{
+	uint32_t crc = 0;
+
+	if(StreamThreadState.FrameCrcEnabled)
 	{
-		AdiLogError(StreamFunctions_c, __LINE__, status);
-		AdiAppErrorHandler(status);
+		crc = AdiStreamCrc32(frame + ADI_STREAM_FRAME_HEADER_BYTES, payloadBytes);
+		StreamThreadState.FrameFlags |= ADI_STREAM_FRAME_FLAG_CRC;
 	}
 
-	/* Clear the DMA buffers */
-	CyU3PDmaChannelReset(&StreamingChannel);
+	frame[0] = ADI_STREAM_FRAME_SYNC & 0xFF;
+	frame[1] = (ADI_STREAM_FRAME_SYNC & 0xFF00) >> 8;
+	frame[2] = StreamThreadState.FrameStreamType;
+	frame[3] = StreamThreadState.FrameFlags;
+	frame[4] = StreamThreadState.FrameSequence & 0xFF;
+	frame[5] = (StreamThreadState.FrameSequence & 0xFF00) >> 8;
+	frame[6] = (StreamThreadState.FrameSequence & 0xFF0000) >> 16;
+	frame[7] = (StreamThreadState.FrameSequence & 0xFF000000) >> 24;
+	frame[8] = StreamThreadState.FrameSamples & 0xFF;
+	frame[9] = (StreamThreadState.FrameSamples & 0xFF00) >> 8;
+	frame[10] = payloadBytes & 0xFF;
+	frame[11] = (payloadBytes & 0xFF00) >> 8;
+	frame[12] = crc & 0xFF;
+	frame[13] = (crc & 0xFF00) >> 8;
+	frame[14] = (crc & 0xFF0000) >> 16;
+	frame[15] = (crc & 0xFF000000) >> 24;
+
+	/* Start the next frame */
+	StreamThreadState.FrameSequence++;
+	StreamThreadState.FrameSamples = 0;
+	StreamThreadState.FrameFlags = 0;
+}
 
-	if(StreamThreadState.PinExitEnable)
+/**
+  * @brief Calculates the CRC32 (IEEE 802.3, same as zlib) of a block of stream data.
+  *
+  * @param data Pointer to the data
+  *
+  * @param numBytes The number of bytes to include in the CRC
+  *
+  * @return The CRC32 value
+  *
+  * Uses a 16 entry table (two lookups per byte), which costs a few hundred microseconds for a full 1KB
+  * USB buffer. Only enable frame CRCs when the stream rate leaves time for this.
+ **/
+uint32_t AdiStreamCrc32(uint8_t *data, uint32_t numBytes)
+{
+	uint32_t crc = 0xFFFFFFFF;
+
+	while(numBytes)
 	{
-		/* Disable starting the capture by raising SYNC/RTS
-		 * If this is not done before setting SYNC/RTS high, things will break */
+		crc ^= *data;
+		crc = (crc >> 4) ^ StreamCrc32Table[crc & 0xF];
+		crc = (crc >> 4) ^ StreamCrc32Table[crc & 0xF];
+		data++;
+		numBytes--;
+	}
+	return ~crc;
+}
 
-		/* If pin start is disabled (we're starting the capture with GLOB_CMD) */
-		if(!StreamThreadState.PinStartEnable)
-		{
-			/* Read MSC_CTRL register */
-			tempReadBuffer[1] = (0x64);
-			tempReadBuffer[0] = (0x00);
-			status = CyU3PSpiTransmitWords(tempReadBuffer, 2);
-			if (status != CY_U3P_SUCCESS)
-			{
-				AdiLogError(StreamFunctions_c, __LINE__, status);
-				AdiAppErrorHandler(status);
-			}
-			AdiSleepForMicroSeconds(FX3State.StallTime);
-			status = CyU3PSpiReceiveWords(tempReadBuffer, 2);
-			AdiSleepForMicroSeconds(FX3State.StallTime);
+/**
+  * @brief Checks for a data ready edge which arrived while the previous sample was being processed.
+  *
+  * @return void
+  *
+  * Stream workers call this before each data ready wait. AdiStreamSampleReady clears the pin interrupt
+  * flag once the previous edge has been seen, so if the flag is set again here an edge was missed.
+ **/
+void AdiStreamSampleStart()
+{
+	ADI_TRACE(TraceDrWaitStart, StreamThreadState.FrameStreamType, StreamThreadState.Stats.Samples);
 
-			/* Clear bit 12 (bit enables/disables starting a capture using SYNC pin) */
-			tempReadBuffer[1] = tempReadBuffer[1] & (0xEF);
+	if(StreamThreadState.DrMissCheck && StreamThreadState.Stats.Samples && (GPIO->lpp_gpio_intr0 & (1 << FX3State.DrPin)))
+	{
+		StreamThreadState.FrameFlags |= ADI_STREAM_FRAME_FLAG_DR_MISSED;
+		StreamThreadState.Stats.DrMissed++;
+	}
+}
 
-			/* Write modified buffer to MSC_CTRL */
-			tempWriteBuffer[1] = (0x80) | (0x64);
-			tempWriteBuffer[0] = tempReadBuffer[0];
-			status = CyU3PSpiTransmitWords(tempWriteBuffer, 2);
-			AdiSleepForMicroSeconds(FX3State.StallTime);
-			tempWriteBuffer[1] = (0x80) | (0x65);
-			tempWriteBuffer[0] = tempReadBuffer[0];
-			status = CyU3PSpiTransmitWords(tempWriteBuffer, 2);
-			AdiSleepForMicroSeconds(FX3State.StallTime);
+/**
+  * @brief Counts a new sample for the stream statistics and the current frame.
+  *
+  * @return void
+  *
+  * Stream workers call this after each data ready wait, before any sample data is placed in the USB buffer.
+  * For automatic DMA streams the stream thread never handles the USB buffers, so the USB buffer occupancy
+  * is sampled here every ADI_STREAM_OCCUPANCY_INTERVAL samples instead.
+ **/
+void AdiStreamSampleReady()
+{
+	/* Clear the edge which started this sample, so the next edge can be checked for */
+	if(StreamThreadState.DrMissCheck)
+	{
+		GPIO->lpp_gpio_simple[FX3State.DrPin] |= CY_U3P_LPP_GPIO_INTR;
+	}
 
-			/* Configure SYNC/RTS as an output and set high */
+	if(StreamThreadState.UsbAutoDma && ((StreamThreadState.Stats.Samples % ADI_STREAM_OCCUPANCY_INTERVAL) == 0))
+	{
+		AdiStreamSampleOccupancy();
+	}
+
+	ADI_TRACE(TraceSampleReady, StreamThreadState.FrameStreamType, StreamThreadState.Stats.Samples);
+
+	StreamThreadState.FrameSamples++;
+	StreamThreadState.Stats.Samples++;
+}
+
+/**
+  * @brief Records an SPI, I2C or DMA transfer error in the stream statistics and the current frame.
+  *
+  * @return void
+ **/
+void AdiStreamTransferError()
+{
+	StreamThreadState.FrameFlags |= ADI_STREAM_FRAME_FLAG_XFER_ERROR;
+	StreamThreadState.Stats.XferErrors++;
+	ADI_TRACE(TraceXferError, StreamThreadState.Stats.XferErrors, 0);
+}
+
+/**
+  * @brief Adds the number of USB buffers waiting to be read by the PC to the occupancy histogram.
+  *
+  * @return void
+  *
+  * The occupancy is the difference between the bytes produced and consumed on the streaming DMA
+  * channel, in USB buffers. A stream where the low bins dominate is limited by the DUT or SPI, while
+  * a stream where the occupancy reaches the DMA buffer count is limited by the PC. For automatic DMA
+  * streams the committed buffer count is also updated from the bytes produced.
+ **/
+void AdiStreamSampleOccupancy()
+{
+	CyU3PDmaState_t state;
+	uint32_t prodXferCount, consXferCount, occupancy;
+
+	if(CyU3PDmaChannelGetStatus(&StreamingChannel, &state, &prodXferCount, &consXferCount) != CY_U3P_SUCCESS)
+	{
+		return;
+	}
+
+	occupancy = (prodXferCount - consXferCount) / StreamDmaPool[ADI_STREAM_DMA_USB].Size;
+	if(occupancy >= ADI_STREAM_OCCUPANCY_BINS)
+	{
+		occupancy = ADI_STREAM_OCCUPANCY_BINS - 1;
+	}
+	StreamThreadState.Stats.Occupancy[occupancy]++;
+
+	if(StreamThreadState.UsbAutoDma)
+	{
+		StreamThreadState.Stats.BuffersCommitted = prodXferCount / StreamDmaPool[ADI_STREAM_DMA_USB].Size;
+	}
+}
+
+/**
+  * @brief Sends the runtime counters for the active or last stream to the PC.
+  *
+  * @return void
+  *
+  * The counters are only read, so this can be used while a stream is running. Each value is a 32-bit
+  * little endian word. USBBuffer[0-3] holds the status, then: [4] stream type (ADI_STREAM_FRAME_TYPE_*,
+  * 0 if no stream has run), [8] stream active, [12] samples, [16] USB buffers committed, [20] number of
+  * waits for a free USB buffer, [24] total wait time (ms), [28] missed data ready edges, [32] transfer
+  * errors, [36] data ready latency sample count, [40] max data ready latency, [44] mean data ready
+  * latency, then ADI_STREAM_OCCUPANCY_BINS words of USB buffer occupancy histogram starting at [48].
+  * The data ready latency (timer ticks) is only measured for interrupt driven data ready waits. The
+  * histogram is followed by the overflow policy counters: number of overflow events, USB buffers dropped,
+  * samples dropped, then the index of the first sample and the number of samples in the most recent gap.
+ **/
+void AdiGetStreamStats()
+{
+	uint32_t stats[11];
+	uint32_t overflowStats[ADI_STREAM_OVERFLOW_STATS];
+	uint32_t index, value, offset;
+
+	stats[0] = StreamThreadState.FrameStreamType;
+	stats[1] = StreamThreadState.Stats.Active;
+	stats[2] = StreamThreadState.Stats.Samples;
+	stats[3] = StreamThreadState.Stats.BuffersCommitted;
+	stats[4] = StreamThreadState.Stats.BufferWaits;
+	stats[5] = StreamThreadState.Stats.BufferWaitMs;
+	stats[6] = StreamThreadState.Stats.DrMissed;
+	stats[7] = StreamThreadState.Stats.XferErrors;
+	stats[8] = StreamThreadState.DrLatencyCount;
+	stats[9] = StreamThreadState.DrLatencyMax;
+	stats[10] = 0;
+	if(StreamThreadState.DrLatencyCount)
+	{
+		stats[10] = (uint32_t) (StreamThreadState.DrLatencyTotal / StreamThreadState.DrLatencyCount);
+	}
+
+	overflowStats[0] = StreamThreadState.Stats.OverflowEvents;
+	overflowStats[1] = StreamThreadState.Stats.DroppedBuffers;
+	overflowStats[2] = StreamThreadState.Stats.DroppedSamples;
+	overflowStats[3] = StreamThreadState.Stats.LastGapStart;
+	overflowStats[4] = StreamThreadState.Stats.LastGapSamples;
+
+	for(index = 0; index < (11 + ADI_STREAM_OCCUPANCY_BINS + ADI_STREAM_OVERFLOW_STATS); index++)
+	{
+		if(index < 11)
+		{
+			value = stats[index];
+		}
+		else if(index < (11 + ADI_STREAM_OCCUPANCY_BINS))
+		{
+			value = StreamThreadState.Stats.Occupancy[index - 11];
+		}
+		else
+		{
+			value = overflowStats[index - 11 - ADI_STREAM_OCCUPANCY_BINS];
+		}
+		offset = 4 + (4 * index);
+		USBBuffer[offset] = value & 0xFF;
+		USBBuffer[offset + 1] = (value & 0xFF00) >> 8;
+		USBBuffer[offset + 2] = (value & 0xFF0000) >> 16;
+		USBBuffer[offset + 3] = (value & 0xFF000000) >> 24;
+	}
+
+	AdiSendStatus(CY_U3P_SUCCESS, ADI_STREAM_STATS_LENGTH, CyTrue);
+}
+
+/**
+  * @brief Sets the pre-trigger capture settings used by the next burst or generic stream.
+  *
+  * @param length The number of control endpoint data bytes (ADI_CAPTURE_CONFIG_LENGTH)
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * The settings are read from the control endpoint into USBBuffer, little endian: pre trigger samples[0-3],
+  * post trigger samples[4-7], trigger source[8] (ADI_CAPTURE_TRIGGER_*), trigger pin[9], trigger polarity[10],
+  * threshold options[11] (ADI_CAPTURE_THRESHOLD_*), threshold word byte offset[12-13] and threshold value[14-15].
+  * The trigger sample is the first post trigger sample. Setting 0 post trigger samples turns the capture off,
+  * and invalid settings also leave it off.
+ **/
+CyU3PReturnStatus_t AdiCaptureConfigure(uint16_t length)
+{
+	CyU3PReturnStatus_t status;
+	uint16_t bytesRead = 0;
+	uint32_t postSamples;
+	CaptureConfig *config = &FX3State.Capture;
+
+	if(length > sizeof(USBBuffer))
+	{
+		length = sizeof(USBBuffer);
+	}
+	status = CyU3PUsbGetEP0Data(length, USBBuffer, &bytesRead);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		return status;
+	}
+
+	config->PostSamples = 0;
+	if(bytesRead < ADI_CAPTURE_CONFIG_LENGTH)
+	{
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	}
+
+	config->PreSamples = USBBuffer[0] | (USBBuffer[1] << 8) | (USBBuffer[2] << 16) | (USBBuffer[3] << 24);
+	postSamples = USBBuffer[4] | (USBBuffer[5] << 8) | (USBBuffer[6] << 16) | (USBBuffer[7] << 24);
+	config->TriggerSource = USBBuffer[8];
+	config->TriggerPin = USBBuffer[9];
+	config->TriggerPolarity = (CyBool_t) (USBBuffer[10] != 0);
+	config->ThresholdFlags = USBBuffer[11];
+	config->ThresholdOffset = USBBuffer[12] | (USBBuffer[13] << 8);
+	config->ThresholdValue = USBBuffer[14] | (USBBuffer[15] << 8);
+
+	if((config->TriggerSource > ADI_CAPTURE_TRIGGER_THRESHOLD) || ((config->TriggerSource == ADI_CAPTURE_TRIGGER_PIN) &&
+			(!AdiIsValidGPIO(config->TriggerPin) || (config->TriggerPin == ADI_TIMER_PIN))))
+	{
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	}
+	config->PostSamples = postSamples;
+
+#ifdef VERBOSE_MODE
+	ADI_LOG("Capture: %d pre, %d post samples, trigger source %d\r\n", config->PreSamples, config->PostSamples, config->TriggerSource);
+#endif
+
+	return CY_U3P_SUCCESS;
+}
+
+/**
+  * @brief Sets up the pre-trigger capture ring for a burst or generic stream which is starting.
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * Must be called once the stream sample size (StreamThreadState.BytesPerBuffer) is known, and does nothing
+  * unless AdiStreamFrameInit selected a capture. Each sample is stored in its own ring slot, with no frame
+  * header, and the stream runs until the post trigger samples are stored (NumBuffers is not used). The
+  * samples are only sent to the PC once the capture is done. The ring is the ADI_STREAM_DMA_CAPTURE pool
+  * buffer. If the ring can't be set up the caller must not start the stream, and the error is returned in
+  * the ADI_CAPTURE_STATUS_CMD response. The trigger pin can't be the data ready pin or the timer pin.
+ **/
+CyU3PReturnStatus_t AdiCaptureInit()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	CaptureConfig *config = &FX3State.Capture;
+	uint32_t dataBytes, ringBytes;
+
+	if(!StreamThreadState.CaptureActive)
+	{
+		return CY_U3P_SUCCESS;
+	}
+
+	dataBytes = StreamThreadState.BytesPerBuffer;
+	if(StreamThreadState.TimestampsEnabled)
+	{
+		dataBytes -= ADI_STREAM_TIMESTAMP_BYTES;
+	}
+
+	/* Check the ring fits, and that the threshold word is in the sample data */
+	StreamThreadState.CaptureSlots = config->PreSamples + config->PostSamples;
+	if((StreamThreadState.BytesPerBuffer == 0) ||
+			(config->PreSamples > ADI_CAPTURE_MAX_BYTES) || (config->PostSamples > ADI_CAPTURE_MAX_BYTES) ||
+			(StreamThreadState.CaptureSlots > (ADI_CAPTURE_MAX_BYTES / StreamThreadState.BytesPerBuffer)))
+	{
+		status = CY_U3P_ERROR_BAD_ARGUMENT;
+	}
+	else if((config->TriggerSource == ADI_CAPTURE_TRIGGER_THRESHOLD) && ((config->ThresholdOffset + 2) > dataBytes))
+	{
+		status = CY_U3P_ERROR_BAD_ARGUMENT;
+	}
+	else if((config->TriggerSource == ADI_CAPTURE_TRIGGER_PIN) &&
+			((config->TriggerPin == ADI_TIMER_PIN) || (FX3State.DrActive && (config->TriggerPin == FX3State.DrPin))))
+	{
+		/* The GPIO ISR would take trigger edges as data ready, and the timer pin is the stream time base */
+		status = CY_U3P_ERROR_BAD_ARGUMENT;
+	}
+	else
+	{
+		/* Calculate the required memory block (in bytes) to be a multiple of 16 */
+		ringBytes = StreamThreadState.CaptureSlots * StreamThreadState.BytesPerBuffer;
+		if(ringBytes % 16)
+		{
+			ringBytes += 16 - (ringBytes % 16);
+		}
+		StreamThreadState.CaptureRing = AdiStreamDmaBufferGet(ADI_STREAM_DMA_CAPTURE, ringBytes);
+		if(StreamThreadState.CaptureRing == 0)
+		{
+			status = CY_U3P_ERROR_MEMORY_ERROR;
+		}
+	}
+
+	/* Latch trigger pin edges in the GPIO interrupt status, so edges between samples are not missed */
+	if((status == CY_U3P_SUCCESS) && (config->TriggerSource == ADI_CAPTURE_TRIGGER_PIN))
+	{
+		status = AdiConfigurePinInterrupt(config->TriggerPin, config->TriggerPolarity);
+		GPIO->lpp_gpio_simple[config->TriggerPin] |= CY_U3P_LPP_GPIO_INTR;
+	}
+
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		StreamThreadState.CaptureError = status;
+		AdiCaptureRelease();
+		return status;
+	}
+
+	/* One sample per ring slot */
+	StreamThreadState.BytesPerUsbPacket = StreamThreadState.BytesPerBuffer;
+	StreamThreadState.NumBuffers = 0xFFFFFFFF;
+
+#ifdef VERBOSE_MODE
+	ADI_LOG("Capture ring: %d samples of %d bytes\r\n", StreamThreadState.CaptureSlots, StreamThreadState.BytesPerBuffer);
+#endif
+
+	return status;
+}
+
+/**
+  * @brief Releases the pre-trigger capture ring, and removes the trigger pin edge detection.
+  *
+  * @return void
+  *
+  * The ring buffer stays with its stream DMA pool entry for the next capture. The capture progress
+  * counters are kept, so the capture status can still be read after the stream.
+ **/
+void AdiCaptureRelease()
+{
+	CyU3PGpioSimpleConfig_t gpioConfig;
+
+	if(StreamThreadState.CaptureRing)
+	{
+		StreamThreadState.CaptureRing = 0;
+
+		if(FX3State.Capture.TriggerSource == ADI_CAPTURE_TRIGGER_PIN)
+		{
+			gpioConfig.outValue = CyTrue;
+			gpioConfig.inputEn = CyTrue;
+			gpioConfig.driveLowEn = CyFalse;
+			gpioConfig.driveHighEn = CyFalse;
+			gpioConfig.intrMode = CY_U3P_GPIO_NO_INTR;
+			CyU3PGpioSetSimpleConfig(FX3State.Capture.TriggerPin, &gpioConfig);
+		}
+	}
+	StreamThreadState.CaptureActive = CyFalse;
+}
+
+/**
+  * @brief Sends the pre-trigger capture status for the running or last stream to the PC.
+  *
+  * @return void
+  *
+  * Each value is a 32-bit little endian word. USBBuffer[0-3] holds the status, then: [4] capture state
+  * (ADI_CAPTURE_STATE_*), [8] samples stored, [12] pre trigger samples kept, [16] post trigger samples stored,
+  * [20] trigger sample index (number of samples stored before it), [24] bytes per sample. Once the capture is
+  * done, the pre and post trigger samples are sent on the streaming endpoint, oldest first.
+ **/
+void AdiGetCaptureStatus()
+{
+	uint32_t values[6];
+	uint32_t index, offset;
+
+	values[0] = ADI_CAPTURE_STATE_OFF;
+	if(StreamThreadState.CaptureDone)
+	{
+		values[0] = ADI_CAPTURE_STATE_DONE;
+	}
+	else if(StreamThreadState.CaptureTriggered)
+	{
+		values[0] = ADI_CAPTURE_STATE_TRIGGERED;
+	}
+	else if(StreamThreadState.CaptureActive)
+	{
+		values[0] = ADI_CAPTURE_STATE_ARMED;
+	}
+
+	values[1] = StreamThreadState.CaptureStored;
+	values[2] = StreamThreadState.CaptureTriggered ? StreamThreadState.CaptureTriggerSample : StreamThreadState.CaptureStored;
+	if(values[2] > FX3State.Capture.PreSamples)
+	{
+		values[2] = FX3State.Capture.PreSamples;
+	}
+	values[3] = StreamThreadState.CapturePostStored;
+	values[4] = StreamThreadState.CaptureTriggerSample;
+	values[5] = StreamThreadState.BytesPerBuffer;
+
+	for(index = 0; index < 6; index++)
+	{
+		offset = 4 + (4 * index);
+		USBBuffer[offset] = values[index] & 0xFF;
+		USBBuffer[offset + 1] = (values[index] & 0xFF00) >> 8;
+		USBBuffer[offset + 2] = (values[index] & 0xFF0000) >> 16;
+		USBBuffer[offset + 3] = (values[index] & 0xFF000000) >> 24;
+	}
+
+	/* A stream which was not started because its capture could not be set up reports the error */
+	AdiSendStatus(StreamThreadState.CaptureError, ADI_CAPTURE_STATUS_LENGTH, CyTrue);
+}
+
+/**
+  * @brief Checks if a stream or the SPI pipe is running, or has a start waiting for the AppThread.
+  *
+  * @return True if a new stream or SPI pipe start must be refused.
+  *
+  * Streams and the SPI pipe share the SPI block, the streaming endpoint and the stream DMA pool, so only one
+  * can run at a time. A stream counts as running from its start request until its done command, since the
+  * stream statistics stay active until then. The SPI pipe runs until its done or stop command.
+ **/
+CyBool_t AdiStreamBusy()
+{
+	uint32_t eventMask = ADI_GENERIC_STREAM_START|ADI_RT_STREAM_START|ADI_BURST_STREAM_START|ADI_TRANSFER_STREAM_START|ADI_I2C_STREAM_START|ADI_LOGIC_STREAM_START|ADI_SPI_PIPE_START|
+			ADI_GENERIC_STREAM_ENABLE|ADI_RT_STREAM_ENABLE|ADI_BURST_STREAM_ENABLE|ADI_TRANSFER_STREAM_ENABLE|ADI_I2C_STREAM_ENABLE|ADI_LOGIC_STREAM_ENABLE;
+	uint32_t eventFlags = 0;
+
+	CyU3PEventGet(&EventHandler, eventMask, CYU3P_EVENT_OR, &eventFlags, CYU3P_NO_WAIT);
+	return (CyBool_t) (SpiPipeActive || StreamThreadState.Stats.Active || (eventFlags != 0));
+}
+
+/**
+  * @brief Refuses a stream start on the AppThread while another stream or the SPI pipe is running.
+  *
+  * @param ep0Pending True if the start request has not read its control endpoint data yet
+  *
+  * @return CY_U3P_SUCCESS if the stream can start, otherwise CY_U3P_ERROR_ALREADY_STARTED.
+  *
+  * The vendor request handler checks AdiStreamBusy before it sets a start event, and stalls a refused
+  * request. This repeats the check before a start touches the SPI block or the stream DMA pool, in case
+  * another start was accepted while this one waited for the AppThread. A refused start which has not read
+  * its control data yet is stalled, so the PC still sees it fail.
+ **/
+static CyU3PReturnStatus_t AdiStreamStartCheck(CyBool_t ep0Pending)
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+
+	if(AdiStreamBusy())
+	{
+		status = CY_U3P_ERROR_ALREADY_STARTED;
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		if(ep0Pending)
+		{
+			CyU3PUsbStall(0, CyTrue, CyFalse);
+		}
+	}
+	return status;
+}
+
+/**
+  * @brief This function sets a flag to notify the streaming thread that the user requested to cancel streaming.
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * This function can be used to stop any stream operation. The variable KillStreamEarly is defined as
+  * volatile to prevent any compiler optimizations which may remove it.
+ **/
+CyU3PReturnStatus_t AdiStopAnyDataStream()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+
+	/* Set the event mask to the stream enable events */
+	uint32_t eventMask = ADI_GENERIC_STREAM_ENABLE|ADI_RT_STREAM_ENABLE|ADI_BURST_STREAM_ENABLE|ADI_TRANSFER_STREAM_ENABLE|ADI_I2C_STREAM_ENABLE|ADI_LOGIC_STREAM_ENABLE;
+
+	/* Variable to receive the event arguments into */
+	uint32_t eventFlags;
+
+	/* Check if any streams are enabled */
+	CyU3PEventGet (&EventHandler, eventMask, CYU3P_EVENT_OR, &eventFlags, CYU3P_NO_WAIT);
+
+	/* If no events are set eventFlags will be 0. The logic analyzer worker holds its enable event for a full
+	 * USB buffer, so a running stream (active statistics) also counts */
+	if((eventFlags == 0) && !StreamThreadState.Stats.Active)
+	{
+		status = CY_U3P_ERROR_NOT_STARTED;
+	}
+
+	/* Set kill stream early flag */
+	KillStreamEarly = CyTrue;
+	ADI_TRACE(TraceStreamStop, status, 0);
+
+	/* Return status over USB */
+	AdiSendStatus(status, 4, CyTrue);
+
+	/* return status code */
+	return status;
+}
+
+/**
+  * @brief This function prints all the stream state variables to the terminal if VERBOSE_MODE is defined
+  *
+  * @return A status code indicating if the print occurred (returns false if VERBOSE_MODE is not defined).
+  *
+  * This function prints a significant amount of data, and as such is fairly slow in VERBOSE_MODE. The return value of
+  * this function can be used to determine if the running application firmware is set to verbose mode.
+ **/
+CyBool_t AdiPrintStreamState()
+{
+	CyBool_t verboseMode = CyFalse;
+
+#ifdef VERBOSE_MODE
+	verboseMode = CyTrue;
+	ADI_LOG("Endpoint Transfer Size: %d\r\n", StreamThreadState.TransferByteLength);
+	ADI_LOG("NumCaptures: %d NumBuffers: %d Bytes Per USB Packet: %d\r\n", StreamThreadState.NumCaptures, StreamThreadState.NumBuffers, StreamThreadState.BytesPerUsbPacket);
+	ADI_LOG("DrActive is %d, with the data ready pin set to GPIO[%d]. DrPolarity is %d\r\n", FX3State.DrActive, FX3State.DrPin, FX3State.DrPolarity);
+	AdiPrintSpiConfig(AdiGetSpiConfig());
+#endif
+
+	return verboseMode;
+}
+
+/**
+  * @brief Starts an I2C read stream.
+  *
+  * @return A status code indicating the success of the I2C stream start.
+  *
+  * This function reads the I2C stream start request in from the control
+  * endpoint. It parses out the stream parameters from the buffer and
+  * configures the Stream DMA channel for I2C -> USB, with an infinite
+  * transfer.
+ **/
+CyU3PReturnStatus_t AdiI2CStreamStart()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	uint32_t timeout, index;
+	uint16_t bytesRead;
+	CyU3PDmaChannelConfig_t i2cDmaConfig;
+	CyU3PDmaType_t i2cDmaType = CY_U3P_DMA_TYPE_AUTO;
+
+	/* Don't take the SPI block and stream DMA channels from a running stream or SPI pipe */
+	status = AdiStreamStartCheck(CyTrue);
+	if(status != CY_U3P_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Get USB Data */
+	CyU3PUsbGetEP0Data(StreamThreadState.TransferByteLength, USBBuffer, &bytesRead);
+
+	/* Parse USB data (number of bytes placed in numcaptures) */
+	index = I2CParseUSBBuffer(USBBuffer, &timeout, &StreamThreadState.NumCaptures, &StreamThreadState.I2CStreamPreamble);
+
+	/* Number of buffers to capture follows after I2C read stream request data */
+	StreamThreadState.NumBuffers = USBBuffer[index];
+	StreamThreadState.NumBuffers |= (USBBuffer[index + 1] << 8);
+	StreamThreadState.NumBuffers |= (USBBuffer[index + 2] << 16);
+	StreamThreadState.NumBuffers |= (USBBuffer[index + 3] << 24);
+
+	/* Disable VBUS ISR */
+	CyU3PVicDisableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+
+	/* Disable GPIO interrupt before attaching interrupt to pin */
+	CyU3PVicDisableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+
+	/* Re-init I2C block in DMA mode */
+	AdiI2CInit(FX3State.I2CBitRate, CyTrue);
+
+	/* Configure data ready interrupts */
+	if(FX3State.DrActive)
+		AdiConfigureDrPin();
+
+	/* Select the data ready wait, time stamp and frame modes for the stream workers */
+	AdiStreamDataReadyInit();
+	AdiStreamFrameInit(ADI_STREAM_FRAME_TYPE_I2C);
+
+	/* Time stamped or framed reads are received to CPU memory, so the CPU can add to the stream data */
+	if(StreamThreadState.RxCopyMode)
+	{
+		status = AdiStreamRxChannelSetup(CY_U3P_LPP_SOCKET_I2C_PROD, StreamThreadState.NumCaptures);
+		if(status != CY_U3P_SUCCESS)
+		{
+			/* Fall back to a stream without time stamps or framing */
+			AdiLogError(StreamFunctions_c, __LINE__, status);
+			AdiStreamRxCopyDisable();
+		}
+	}
+
+	/* Configure StreamChannel for I2C to USB automatic DMA */
+    CyU3PMemSet ((uint8_t *)&i2cDmaConfig, 0, sizeof(i2cDmaConfig));
+    i2cDmaConfig.size           = StreamThreadState.NumCaptures;
+    i2cDmaConfig.count          = 16;
+    i2cDmaConfig.prodAvailCount = 0;
+    i2cDmaConfig.dmaMode        = CY_U3P_DMA_MODE_BYTE;
+    i2cDmaConfig.prodHeader     = 0;
+    i2cDmaConfig.prodFooter     = 0;
+    i2cDmaConfig.consHeader     = 0;
+    i2cDmaConfig.notification   = 0;
+    i2cDmaConfig.cb             = NULL;
+    i2cDmaConfig.prodSckId = CY_U3P_LPP_SOCKET_I2C_PROD;
+    i2cDmaConfig.consSckId = CY_U3P_UIB_SOCKET_CONS_1;
+    if(StreamThreadState.RxCopyMode)
+    {
+    	/* CPU to USB, packing as many reads as fit in each USB buffer */
+    	StreamThreadState.BytesPerBuffer = StreamThreadState.NumCaptures;
+    	if(StreamThreadState.TimestampsEnabled)
+    	{
+    		StreamThreadState.BytesPerBuffer += ADI_STREAM_TIMESTAMP_BYTES;
+    	}
+    	StreamThreadState.BytesPerUsbPacket = AdiStreamBytesPerUsbPacket(StreamThreadState.BytesPerBuffer);
+    	i2cDmaConfig.size = StreamThreadState.UsbBufferBytes;
+    	i2cDmaConfig.count = AdiStreamUsbBufferCount(16);
+    	i2cDmaConfig.prodSckId = CY_U3P_CPU_SOCKET_PROD;
+    	i2cDmaType = CY_U3P_DMA_TYPE_MANUAL_OUT;
+    }
+    status = AdiStreamDmaChannelGet(ADI_STREAM_DMA_USB, i2cDmaType, &i2cDmaConfig);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+
+	/* Log stream state in vebose mode */
+	AdiPrintStreamState();
+
+	/* Flush streaming endpoint */
+	CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+
+	/* Enable an infinite DMA transfer on the streaming channel */
+	status = CyU3PDmaChannelSetXfer(&StreamingChannel, 0);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+
+	/* Clear the profile counters for the new stream */
+	ADI_PROFILE_START(ADI_I2C_STREAM_ENABLE);
+
+	/* Set the burst stream flag to notify the streaming thread it should take over */
+	CyU3PEventSet (&EventHandler, ADI_I2C_STREAM_ENABLE, CYU3P_EVENT_OR);
+
+	return status;
+}
+
+/**
+  * @brief Cleans up an I2C read stream.
+  *
+  * @return A status code indicating the success of the I2C stream clean up.
+  *
+  * This function detroys the StreamingChannel DMA which was set up to allow
+  * I2C -> USB DMA. It also flushes the relevant endpoint and reconfigures the
+  * I2C to operate in register mode.
+ **/
+CyU3PReturnStatus_t AdiI2CStreamFinished()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+
+	/* Return the stream DMA channel to the pool */
+	AdiStreamDmaChannelRelease(ADI_STREAM_DMA_USB);
+
+	/* Release the I2C receive channel used for time stamped or framed streams */
+	if(StreamThreadState.RxCopyMode)
+	{
+		AdiStreamRxChannelRelease();
+	}
+
+	/* Flush the streaming end point */
+	status |= CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+
+	/* Re-init I2C in register mode */
+	AdiI2CInit(FX3State.I2CBitRate, CyFalse);
+
+	/* Clear all interrupt flags */
+	CyU3PVicClearInt();
+
+	/* Re-enable relevant ISRs */
+	CyU3PVicEnableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+	CyU3PVicEnableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+
+	/* Stop waking the stream thread on data ready edges */
+	StreamThreadState.DrInterruptWait = CyFalse;
+
+	/* Keep the statistics for the finished stream readable */
+	StreamThreadState.Stats.Active = CyFalse;
+
+	/* Clear stream kill flag */
+	KillStreamEarly = CyFalse;
+
+	return status;
+}
+
+/**
+  * @brief Starts a protocol agnostic SPI transfer stream.
+  *
+  * @return A status code indicating the success of the transfer stream start.
+  *
+  * This is used to implement the ISpi32Interface. The stream info is read in from EP0 into
+  * the USBBuffer. This includes stream parameters and the MOSI data. Any error encountered
+  * during stream setup will result in a system reboot, after the error data is logged
+  * to flash memory.
+ **/
+CyU3PReturnStatus_t AdiTransferStreamStart()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	uint16_t bytesRead;
+
+	/* Don't take the SPI block and stream DMA channels from a running stream or SPI pipe */
+	status = AdiStreamStartCheck(CyTrue);
+	if(status != CY_U3P_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Get the data from the control endpoint */
+	status = CyU3PUsbGetEP0Data(StreamThreadState.TransferByteLength, USBBuffer, &bytesRead);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+
+	/* The transfer stream MOSI data is not decoded, so the DUT page is no longer known */
+	AdiInvalidatePageCache();
+
+	/* Parse control endpoint data. The data is formatted as follows
+	 * NumCaptures[0-3], NumBuffers[4-7], BytesPerUSBBuffer[8-11], MOSIData.Count()[12-13], MOSIData[14 - ...] */
+
+	/* Number of times to transfer the MOSI data list per data ready*/
+	StreamThreadState.NumCaptures = USBBuffer[0];
+	StreamThreadState.NumCaptures |= (USBBuffer[1] << 8);
+	StreamThreadState.NumCaptures |= (USBBuffer[2] << 16);
+	StreamThreadState.NumCaptures |= (USBBuffer[3] << 24);
+
+	/* Total number of buffers to transfer (one buffer is going through MOSIData numCaptures times)*/
+	StreamThreadState.NumBuffers = USBBuffer[4];
+	StreamThreadState.NumBuffers |= (USBBuffer[5] << 8);
+	StreamThreadState.NumBuffers |= (USBBuffer[6] << 16);
+	StreamThreadState.NumBuffers |= (USBBuffer[7] << 24);
+
+	/* Number of bytes to place in a single USB packet before transmitting */
+	StreamThreadState.BytesPerUsbPacket = USBBuffer[8];
+	StreamThreadState.BytesPerUsbPacket |= (USBBuffer[9] << 8);
+	StreamThreadState.BytesPerUsbPacket |= (USBBuffer[10] << 16);
+	StreamThreadState.BytesPerUsbPacket |= (USBBuffer[11] << 24);
+
+	/* This is just the number of bytes in MOSI data */
+	StreamThreadState.BytesPerBuffer = USBBuffer[12];
+	StreamThreadState.BytesPerBuffer |= (USBBuffer[13] << 8);
+
+	AdiPrintStreamState();
+
+	/* Disable VBUS ISR */
+	CyU3PVicDisableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+
+	/* Disable GPIO interrupt before attaching interrupt to pin */
+	CyU3PVicDisableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+
+	/* If using DR triggering configure the selected pin as an input with the correct polarity */
+	if(FX3State.DrActive)
+	{
+		/* Configure the pin as an input with interrupts enabled on the selected edge */
+		AdiConfigureDrPin();
+	}
+
+	/* Select the data ready wait, time stamp and frame modes for the stream workers */
+	AdiStreamDataReadyInit();
+	AdiStreamFrameInit(ADI_STREAM_FRAME_TYPE_TRANSFER);
+
+	/* The packet size is set by the PC, make sure it leaves room for the frame header. Multi packet
+	 * USB buffers carry as many whole PC packets as fit, so the PC framing is kept */
+	if(StreamThreadState.ExactCommits && (StreamThreadState.BytesPerUsbPacket != 0))
+	{
+		StreamThreadState.BytesPerUsbPacket = AdiStreamBytesPerUsbPacket(StreamThreadState.BytesPerUsbPacket);
+	}
+	if(StreamThreadState.BytesPerUsbPacket > (StreamThreadState.UsbBufferBytes - StreamThreadState.FrameHeaderBytes))
+	{
+		StreamThreadState.BytesPerUsbPacket = StreamThreadState.UsbBufferBytes - StreamThreadState.FrameHeaderBytes;
+	}
+
+	/* Flush the streaming endpoint */
+	status = CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+
+	/* Configure the StreamingChannel DMA (SPI to PC) */
+	CyU3PDmaChannelConfig_t dmaConfig;
+	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
+	dmaConfig.size 				= StreamThreadState.UsbBufferBytes;
+	dmaConfig.count 			= AdiStreamUsbBufferCount(8);
+	dmaConfig.prodSckId 		= CY_U3P_CPU_SOCKET_PROD;
+	dmaConfig.consSckId 		= CY_U3P_UIB_SOCKET_CONS_1;
+	dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
+	dmaConfig.prodHeader    	= 0;
+	dmaConfig.prodFooter    	= 0;
+	dmaConfig.consHeader    	= 0;
+	dmaConfig.notification  	= 0;
+	dmaConfig.cb            	= NULL;
+	dmaConfig.prodAvailCount	= 0;
+
+	status = AdiStreamDmaChannelGet(ADI_STREAM_DMA_USB, CY_U3P_DMA_TYPE_MANUAL_OUT, &dmaConfig);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+
+	/* Set DMA transfer mode */
+	status = CyU3PDmaChannelSetXfer(&StreamingChannel, 0);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+
+	/* Enable timer hardware for stall */
+	AdiConfigStreamStallTimer();
+
+	/* Clear the profile counters for the new stream */
+	ADI_PROFILE_START(ADI_TRANSFER_STREAM_ENABLE);
+
+	/* Enable generic data capture thread */
+	status = CyU3PEventSet(&EventHandler, ADI_TRANSFER_STREAM_ENABLE, CYU3P_EVENT_OR);
+
+	/* Return status code */
+	return status;
+}
+
+/**
+  * @brief Cleans up a protocol agnostic transfer stream.
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * Resets the streaming endpoint, destroys the DMA channel, and restores the interrupt
+  * source states to their standard operating condition. Must be explicitly invoked via a
+  * vendor command when all "buffers" or captured, or indirectly via a TransferStream cancel.
+  * This function currently just calls the GenericStreamFinished implementation.
+ **/
+CyU3PReturnStatus_t AdiTransferStreamFinished()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+
+	/* Call generic stream finished, since the same resources are used */
+	status = AdiGenericStreamFinished();
+
+	/* Return status code */
+	return status;
+}
+
+/**
+  * @brief Starts a real time stream for ADcmXLx021 DUTs
+  *
+  * @return The status of starting a real-time stream.
+  *
+  * This function kicks off a real-time stream by configuring interrupts, SPI, and end points.
+  * It also optionally toggles the SYNC/RTS pin if requested. At the end of the function, the
+  * bit assigned to enable the capture thread is toggled to signal the streaming thread to start producing data.
+ **/
+CyU3PReturnStatus_t AdiRealTimeStreamStart()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	CyU3PDmaType_t rtDmaType = CY_U3P_DMA_TYPE_AUTO;
+	uint16_t bytesRead;
+	uint8_t tempWriteBuffer[2];
+	uint8_t tempReadBuffer[2];
+
+	/* Don't take the SPI block and stream DMA channels from a running stream or SPI pipe */
+	status = AdiStreamStartCheck(CyTrue);
+	if(status != CY_U3P_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Disable GPIO ISR (Interrupt functionality still active) */
+	CyU3PVicDisableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+
+	/* Disable VBUS ISR */
+	CyU3PVicDisableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+
+	/* Clear all interrupt flags */
+	CyU3PVicClearInt();
+
+	/* Make sure the BUSY pin is configured as input (DIO2) */
+	CyU3PGpioSimpleConfig_t gpioConfig;
+	gpioConfig.outValue = CyFalse;
+	gpioConfig.inputEn = CyTrue;
+	gpioConfig.driveLowEn = CyFalse;
+	gpioConfig.driveHighEn = CyFalse;
+	gpioConfig.intrMode = CY_U3P_GPIO_INTR_POS_EDGE;
+	CyU3PGpioSetSimpleConfig(FX3State.DrPin, &gpioConfig);
+
+	/* Select the data ready wait, time stamp and frame modes for the stream workers */
+	AdiStreamDataReadyInit();
+	AdiStreamFrameInit(ADI_STREAM_FRAME_TYPE_REAL_TIME);
+
+	/* Get number of frames to capture from control endpoint */
+	CyU3PUsbGetEP0Data(5, USBBuffer, &bytesRead);
+	StreamThreadState.NumRealTimeCaptures = USBBuffer[0];
+	StreamThreadState.NumRealTimeCaptures += (USBBuffer[1] << 8);
+	StreamThreadState.NumRealTimeCaptures += (USBBuffer[2] << 16);
+	StreamThreadState.NumRealTimeCaptures += (USBBuffer[3] << 24);
+
+	/* Get pin start setting */
+	StreamThreadState.PinStartEnable = (CyBool_t) USBBuffer[4];
+
+	/* Flush streaming end point */
+	CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+
+	/* Framed real time streams are received to CPU memory, so the CPU can add the frame headers */
+	if(StreamThreadState.RxCopyMode)
+	{
+		status = AdiStreamRxChannelSetup(CY_U3P_LPP_SOCKET_SPI_PROD, StreamThreadState.BytesPerFrame);
+		if(status != CY_U3P_SUCCESS)
+		{
+			/* Fall back to a stream without framing */
+			AdiLogError(StreamFunctions_c, __LINE__, status);
+			AdiStreamRxCopyDisable();
+			status = CY_U3P_SUCCESS;
+		}
+	}
+
+	/* Configure RTS channel DMA (64 USB packets of buffering, in full streaming endpoint bursts) */
+	CyU3PDmaChannelConfig_t dmaConfig;
+	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
+	dmaConfig.size 				= FX3State.StreamDmaBufferSize;
+	dmaConfig.count 			= AdiStreamDmaBufferCount(64);
+	dmaConfig.prodSckId 		= CY_U3P_LPP_SOCKET_SPI_PROD;
+	dmaConfig.consSckId 		= CY_U3P_UIB_SOCKET_CONS_1;
+	dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
+	dmaConfig.prodHeader    	= 0;
+	dmaConfig.prodFooter    	= 0;
+	dmaConfig.consHeader    	= 0;
+	dmaConfig.notification  	= 0;
+	dmaConfig.cb            	= NULL;
+	dmaConfig.prodAvailCount	= 0;
+	if(StreamThreadState.RxCopyMode)
+	{
+		/* CPU to USB, packing as many real time frames as fit in each USB buffer */
+		StreamThreadState.BytesPerUsbPacket = AdiStreamBytesPerUsbPacket(StreamThreadState.BytesPerFrame);
+		dmaConfig.size = StreamThreadState.UsbBufferBytes;
+		dmaConfig.count = AdiStreamUsbBufferCount(64);
+		dmaConfig.prodSckId = CY_U3P_CPU_SOCKET_PROD;
+		rtDmaType = CY_U3P_DMA_TYPE_MANUAL_OUT;
+	}
+
+	/* Configure DMA for RealTimeStreamingChannel (reset, with the DMA buffers cleared) */
+	status = AdiStreamDmaChannelGet(ADI_STREAM_DMA_USB, rtDmaType, &dmaConfig);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+
+	/* The DUT setup and SPI reconfiguration must not be split by a register access on another thread */
+	AdiSpiLock();
+
+	if(StreamThreadState.PinExitEnable)
+	{
+		/* Disable starting the capture by raising SYNC/RTS
+		 * If this is not done before setting SYNC/RTS high, things will break */
+
+		/* If pin start is disabled (we're starting the capture with GLOB_CMD) */
+		if(!StreamThreadState.PinStartEnable)
+		{
+			/* Read MSC_CTRL register */
+			tempReadBuffer[1] = (0x64);
+			tempReadBuffer[0] = (0x00);
+			status = CyU3PSpiTransmitWords(tempReadBuffer, 2);
+			if (status != CY_U3P_SUCCESS)
+			{
+				AdiLogError(StreamFunctions_c, __LINE__, status);
+				AdiAppErrorHandler(status);
+			}
+			AdiSleepForMicroSeconds(FX3State.StallTime);
+			status = CyU3PSpiReceiveWords(tempReadBuffer, 2);
+			AdiSleepForMicroSeconds(FX3State.StallTime);
+
+			/* Clear bit 12 (bit enables/disables starting a capture using SYNC pin) */
+			tempReadBuffer[1] = tempReadBuffer[1] & (0xEF);
+
+			/* Write modified buffer to MSC_CTRL */
+			tempWriteBuffer[1] = (0x80) | (0x64);
+			tempWriteBuffer[0] = tempReadBuffer[0];
+			status = CyU3PSpiTransmitWords(tempWriteBuffer, 2);
+			AdiSleepForMicroSeconds(FX3State.StallTime);
+			tempWriteBuffer[1] = (0x80) | (0x65);
+			tempWriteBuffer[0] = tempReadBuffer[0];
+			status = CyU3PSpiTransmitWords(tempWriteBuffer, 2);
+			AdiSleepForMicroSeconds(FX3State.StallTime);
+
+			/* Configure SYNC/RTS as an output and set high */
 			CyU3PGpioSimpleConfig_t gpioConfig;
 			gpioConfig.outValue = CyTrue;
 			gpioConfig.inputEn = CyFalse;
@@ -505,373 +1874,865 @@ CyU3PReturnStatus_t AdiRealTimeStreamStart()
 		}
 	}
 
-	/* If pin start is enabled, set bit 12 in MISC_CTRL and toggle SYNC, otherwise send 0x0800 to COMMAND */
-	if(StreamThreadState.PinStartEnable)
+	/* If pin start is enabled, set bit 12 in MISC_CTRL and toggle SYNC, otherwise send 0x0800 to COMMAND */
+	if(StreamThreadState.PinStartEnable)
+	{
+		/* Read MSC_CTRL register */
+		tempReadBuffer[1] = (0x64);
+		tempReadBuffer[0] = (0x00);
+		status = CyU3PSpiTransmitWords(tempReadBuffer, 2);
+		AdiSleepForMicroSeconds(FX3State.StallTime);
+		status = CyU3PSpiReceiveWords(tempReadBuffer, 2);
+		AdiSleepForMicroSeconds(FX3State.StallTime);
+
+		/* Set bit 12 (bit enables/disables starting a capture using SYNC pin) */
+		tempReadBuffer[1] = tempReadBuffer[1] | (0x10);
+
+		/* Write modified buffer to MSC_CTRL */
+		tempWriteBuffer[1] = (0x80) | (0x64);
+		tempWriteBuffer[0] = tempReadBuffer[0];
+		status = CyU3PSpiTransmitWords(tempWriteBuffer, 2);
+		AdiSleepForMicroSeconds(FX3State.StallTime);
+		tempWriteBuffer[1] = (0x80) | (0x65);
+		tempWriteBuffer[0] = tempReadBuffer[1];
+		status = CyU3PSpiTransmitWords(tempWriteBuffer, 2);
+		AdiSleepForMicroSeconds(FX3State.StallTime);
+
+		/* Configure SYNC/RTS as an output and set high */
+		CyU3PGpioSimpleConfig_t gpioConfig;
+		gpioConfig.outValue = CyTrue;
+		gpioConfig.inputEn = CyFalse;
+		gpioConfig.driveLowEn = CyTrue;
+		gpioConfig.driveHighEn = CyTrue;
+		gpioConfig.intrMode = CY_U3P_GPIO_NO_INTR;
+		status = CyU3PGpioSetSimpleConfig(FX3State.BusyPin, &gpioConfig);
+
+		/* If config fails try to override and reconfigure */
+		if(status != CY_U3P_SUCCESS)
+		{
+			status = CyU3PDeviceGpioOverride (FX3State.BusyPin, CyTrue);
+			status = CyU3PGpioSetSimpleConfig(FX3State.BusyPin, &gpioConfig);
+		}
+
+		/* Check that the pin is configured to act as an output, return if not */
+		status = CyU3PGpioSimpleSetValue(FX3State.BusyPin, CyTrue);
+		if(status != CY_U3P_SUCCESS)
+		{
+			AdiLogError(StreamFunctions_c, __LINE__, status);
+			AdiAppErrorHandler(status);
+		}
+	}
+	else
+	{
+		/* Send COMMAND 0x800
+		 * Command is Page 0, Address 62 */
+		tempWriteBuffer[1] = (0x80) | (0x3E);
+		tempWriteBuffer[0] = 0;
+		status = CyU3PSpiTransmitWords(tempWriteBuffer, 2);
+		AdiSleepForMicroSeconds(FX3State.StallTime);
+		tempWriteBuffer[1] = (0x80) | (0x3F);
+		tempWriteBuffer[0] = 0x08;
+		status = CyU3PSpiTransmitWords(tempWriteBuffer, 2);
+		AdiSleepForMicroSeconds(FX3State.StallTime);
+	}
+
+	/* Manually reset SPI Rx/Tx FIFO */
+	AdiSpiResetFifo(CyTrue, CyTrue);
+
+	/* Set the SPI config for streaming mode (8 bit transactions) */
+	AdiSetSpiWordLength(8);
+	AdiSpiUnlock();
+
+	/* Print the stream state if in verbose mode */
+#ifdef VERBOSE_MODE
+	AdiPrintStreamState();
+#endif
+
+	/* Set infinite DMA transfer on streaming channel */
+	CyU3PDmaChannelSetXfer(&StreamingChannel, 0);
+
+	/* Clear the profile counters for the new stream */
+	ADI_PROFILE_START(ADI_RT_STREAM_ENABLE);
+
+	/* Set the real-time data capture thread flag */
+	CyU3PEventSet (&EventHandler, ADI_RT_STREAM_ENABLE, CYU3P_EVENT_OR);
+
+	return status;
+}
+
+/**
+  * @brief This function cleans up resources allocated for a real time stream.
+  *
+  * @return The status of the cancel operation.
+  *
+  * This function cleans up after a real-time stream by resetting the SPI port, triggering the
+  * SYNC/RTS pin (if asked to do so), and notifying the host that the cancel operation was successful.
+ **/
+CyU3PReturnStatus_t AdiRealTimeStreamFinished()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+
+	/* Pull SYNC/RTS pin low to force x021 out of RT mode */
+	if(StreamThreadState.PinExitEnable || StreamThreadState.PinStartEnable)
+	{
+		/* Configure SYNC/RTS as an output and set high */
+		CyU3PGpioSimpleConfig_t gpioConfig;
+		gpioConfig.outValue = CyFalse;
+		gpioConfig.inputEn = CyFalse;
+		gpioConfig.driveLowEn = CyTrue;
+		gpioConfig.driveHighEn = CyTrue;
+		gpioConfig.intrMode = CY_U3P_GPIO_NO_INTR;
+		CyU3PGpioSetSimpleConfig(FX3State.BusyPin, &gpioConfig);
+
+		/* Reset flag for next run */
+		StreamThreadState.PinExitEnable = CyFalse;
+	}
+
+	/* Stop pin output drive and enable as input */
+	CyU3PGpioSimpleConfig_t gpioConfig;
+	gpioConfig.inputEn = CyTrue;
+	gpioConfig.driveLowEn = CyFalse;
+	gpioConfig.driveHighEn = CyFalse;
+	CyU3PGpioSetSimpleConfig(FX3State.BusyPin, &gpioConfig);
+
+	/* Hold off register accesses on other threads until the SPI state is restored */
+	AdiSpiLock();
+
+	/* Disable SPI DMA mode */
+	CyU3PSpiDisableBlockXfer(CyTrue, CyTrue);
+
+	/* Reset the SPI controller */
+	SPI->lpp_spi_config &= ~(CY_U3P_LPP_SPI_RX_ENABLE | CY_U3P_LPP_SPI_TX_ENABLE | CY_U3P_LPP_SPI_DMA_MODE | CY_U3P_LPP_SPI_ENABLE);
+	while ((SPI->lpp_spi_config & CY_U3P_LPP_SPI_ENABLE) != 0);
+
+	/* Return the RT streaming channel to the pool */
+	AdiStreamDmaChannelRelease(ADI_STREAM_DMA_USB);
+
+	/* Release the SPI receive channel used for framed streams */
+	if(StreamThreadState.RxCopyMode)
+	{
+		AdiStreamRxChannelRelease();
+	}
+
+	/* Flush streaming end point */
+	CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+
+	/* Clear all interrupt flags */
+	CyU3PVicClearInt();
+
+	/* Re-enable relevant ISRs */
+	CyU3PVicEnableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+	CyU3PVicEnableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+
+	/* Restore the SPI state */
+	status = CyU3PSpiSetConfig(&FX3State.SpiConfig, NULL);
+	AdiSpiUnlock();
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+	}
+
+	/* Stop waking the stream thread on data ready edges */
+	StreamThreadState.DrInterruptWait = CyFalse;
+
+	/* Keep the statistics for the finished stream readable */
+	StreamThreadState.Stats.Active = CyFalse;
+
+	/* Reset KillStreamEarly flag in case the user wants to capture data again */
+	KillStreamEarly = CyFalse;
+
+	/* Return status code */
+	return status;
+}
+
+/**
+  * @brief Starts a burst stream for IMU products.
+  *
+  * @return The status of starting a real-time stream.
+  *
+  * This function kicks off a burst stream by configuring a pin interrupt on a user-specified pin, configuring
+  * the SPI and USB DMAs to handle the incoming data, and enabling the streaming function.It can be configured
+  * for "Blackfin" or "ADuC" burst using vendor requests.
+ **/
+CyU3PReturnStatus_t AdiBurstStreamStart()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	uint16_t bytesRead;
+	uint16_t triggerLength;
+	CyU3PDmaType_t streamDmaType = CY_U3P_DMA_TYPE_AUTO;
+
+	/* Don't take the SPI block and stream DMA channels from a running stream or SPI pipe */
+	status = AdiStreamStartCheck(CyTrue);
+	if(status != CY_U3P_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Disable VBUS ISR */
+	CyU3PVicDisableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+
+	/* Disable GPIO interrupt before attaching interrupt to pin */
+	CyU3PVicDisableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+
+	/* Make sure the global data ready pin is configured as an input and attach the interrupt to the correct edge */
+	if(FX3State.DrActive)
+		AdiConfigureDrPin();
+
+	/* Select the data ready wait, time stamp and frame modes for the stream workers */
+	AdiStreamDataReadyInit();
+	AdiStreamFrameInit(ADI_STREAM_FRAME_TYPE_BURST);
+
+	/* Get the number of buffers, trigger word, and transfer length from the control endpoint */
+	CyU3PUsbGetEP0Data(StreamThreadState.TransferWordLength, USBBuffer, &bytesRead);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+
+	/* Parse number of buffers */
+	StreamThreadState.NumBuffers = USBBuffer[0];
+	StreamThreadState.NumBuffers |= (USBBuffer[1] << 8);
+	StreamThreadState.NumBuffers |= (USBBuffer[2] << 16);
+	StreamThreadState.NumBuffers |= (USBBuffer[3] << 24);
+
+	/* Parse transfer byte length */
+	StreamThreadState.TransferByteLength = USBBuffer[4];
+	StreamThreadState.TransferByteLength |= (USBBuffer[5] << 8);
+	StreamThreadState.TransferByteLength |= (USBBuffer[6] << 16);
+	StreamThreadState.TransferByteLength |= (USBBuffer[7] << 24);
+
+	/* Calculate the required memory block (in bytes) to be a multiple of 16 */
+	uint16_t remainder = StreamThreadState.TransferByteLength % 16;
+	if (remainder == 0)
+	{
+		StreamThreadState.RoundedByteTransferLength = StreamThreadState.TransferByteLength;
+	}
+	else
+	{
+		StreamThreadState.RoundedByteTransferLength = StreamThreadState.TransferByteLength + 16 - remainder;
+	}
+
+	/* Set regList memory to correct length plus trigger word. This is the pooled SPI Tx buffer, which is kept between streams */
+	StreamThreadState.RegList = AdiStreamDmaBufferGet(ADI_STREAM_DMA_TX, StreamThreadState.RoundedByteTransferLength);
+	if(StreamThreadState.RegList == 0)
 	{
-		/* Read MSC_CTRL register */
-		tempReadBuffer[1] = (0x64);
-		tempReadBuffer[0] = (0x00);
-		status = CyU3PSpiTransmitWords(tempReadBuffer, 2);
-		AdiSleepForMicroSeconds(FX3State.StallTime);
-		status = CyU3PSpiReceiveWords(tempReadBuffer, 2);
-		AdiSleepForMicroSeconds(FX3State.StallTime);
+		status = CY_U3P_ERROR_MEMORY_ERROR;
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
 
-		/* Set bit 12 (bit enables/disables starting a capture using SYNC pin) */
-		tempReadBuffer[1] = tempReadBuffer[1] | (0x10);
+	/* Clear (zero) contents of regList memory. Burst transfers are DNC, so we're sending zeros */
+	CyU3PMemSet(StreamThreadState.RegList, 0, sizeof(uint8_t) * StreamThreadState.RoundedByteTransferLength);
 
-		/* Write modified buffer to MSC_CTRL */
-		tempWriteBuffer[1] = (0x80) | (0x64);
-		tempWriteBuffer[0] = tempReadBuffer[0];
-		status = CyU3PSpiTransmitWords(tempWriteBuffer, 2);
-		AdiSleepForMicroSeconds(FX3State.StallTime);
-		tempWriteBuffer[1] = (0x80) | (0x65);
-		tempWriteBuffer[0] = tempReadBuffer[1];
-		status = CyU3PSpiTransmitWords(tempWriteBuffer, 2);
-		AdiSleepForMicroSeconds(FX3State.StallTime);
+	/* Calculate trigger length (USB transfer length - header size) */
+	triggerLength = bytesRead - 8;
 
-		/* Configure SYNC/RTS as an output and set high */
-		CyU3PGpioSimpleConfig_t gpioConfig;
-		gpioConfig.outValue = CyTrue;
-		gpioConfig.inputEn = CyFalse;
-		gpioConfig.driveLowEn = CyTrue;
-		gpioConfig.driveHighEn = CyTrue;
-		gpioConfig.intrMode = CY_U3P_GPIO_NO_INTR;
-		status = CyU3PGpioSetSimpleConfig(FX3State.BusyPin, &gpioConfig);
+	/* Append burst trigger word to the first two bytes of regList */
+	for(int i = 0; i< triggerLength; i++)
+	{
+		StreamThreadState.RegList[i] = USBBuffer[i + 8];
+	}
 
-		/* If config fails try to override and reconfigure */
+#ifdef VERBOSE_MODE
+	 ADI_LOG("Starting burst stream!\r\n");
+	 ADI_LOG("burstTriggerUpper:  %d\r\n", StreamThreadState.RegList[0]);
+	 ADI_LOG("burstTriggerLower:  %d\r\n", StreamThreadState.RegList[1]);
+	 ADI_LOG("roundedTransferLength:  %d\r\n", StreamThreadState.RoundedByteTransferLength);
+	 ADI_LOG("transferByteLength:  %d\r\n", StreamThreadState.TransferByteLength);
+	 ADI_LOG("numBuffers:  %d\r\n", StreamThreadState.NumBuffers);
+	 ADI_LOG("USB Buffer Size:  %d\r\n", FX3State.UsbBufferSize);
+#endif
+
+	/* Time stamped or framed bursts are received to CPU memory, so the CPU can add to the stream data */
+	if(StreamThreadState.RxCopyMode)
+	{
+		status = AdiStreamRxChannelSetup(CY_U3P_LPP_SOCKET_SPI_PROD, StreamThreadState.TransferByteLength);
+		if((status != CY_U3P_SUCCESS) && StreamThreadState.CaptureActive)
+		{
+			/* A capture can't run without the CPU copy, so don't start the stream */
+			AdiLogError(StreamFunctions_c, __LINE__, status);
+			StreamThreadState.CaptureError = status;
+			AdiBurstStreamFinished();
+			return status;
+		}
 		if(status != CY_U3P_SUCCESS)
 		{
-			status = CyU3PDeviceGpioOverride (FX3State.BusyPin, CyTrue);
-			status = CyU3PGpioSetSimpleConfig(FX3State.BusyPin, &gpioConfig);
+			/* Fall back to a stream without time stamps or framing */
+			AdiLogError(StreamFunctions_c, __LINE__, status);
+			AdiStreamRxCopyDisable();
+			status = CY_U3P_SUCCESS;
 		}
+	}
 
-		/* Check that the pin is configured to act as an output, return if not */
-		status = CyU3PGpioSimpleSetValue(FX3State.BusyPin, CyTrue);
+	/* Configure the Burst DMA Streaming Channel (SPI to PC) for Auto DMA, in full streaming endpoint bursts */
+	CyU3PDmaChannelConfig_t dmaConfig;
+	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
+	dmaConfig.size 				= FX3State.StreamDmaBufferSize;
+	dmaConfig.count 			= AdiStreamDmaBufferCount(8);
+	dmaConfig.prodSckId 		= CY_U3P_LPP_SOCKET_SPI_PROD;
+	dmaConfig.consSckId 		= CY_U3P_UIB_SOCKET_CONS_1;
+	dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
+	dmaConfig.prodHeader    	= 0;
+	dmaConfig.prodFooter    	= 0;
+	dmaConfig.consHeader    	= 0;
+	dmaConfig.notification  	= 0;
+	dmaConfig.cb            	= NULL;
+	dmaConfig.prodAvailCount	= 0;
+	if(StreamThreadState.RxCopyMode)
+	{
+		/* CPU to USB, packing as many bursts as fit in each USB buffer */
+		StreamThreadState.BytesPerBuffer = StreamThreadState.TransferByteLength;
+		if(StreamThreadState.TimestampsEnabled)
+		{
+			StreamThreadState.BytesPerBuffer += ADI_STREAM_TIMESTAMP_BYTES;
+		}
+		StreamThreadState.BytesPerUsbPacket = AdiStreamBytesPerUsbPacket(StreamThreadState.BytesPerBuffer);
+		status = AdiCaptureInit();
 		if(status != CY_U3P_SUCCESS)
 		{
-			AdiLogError(StreamFunctions_c, __LINE__, status);
-			AdiAppErrorHandler(status);
+			/* Don't run the stream without the requested capture */
+			AdiBurstStreamFinished();
+			return status;
 		}
+		dmaConfig.size = StreamThreadState.UsbBufferBytes;
+		dmaConfig.count = AdiStreamUsbBufferCount(8);
+		dmaConfig.prodSckId = CY_U3P_CPU_SOCKET_PROD;
+		streamDmaType = CY_U3P_DMA_TYPE_MANUAL_OUT;
 	}
-	else
+
+	/* Get the streaming DMA channel from the pool */
+	status = AdiStreamDmaChannelGet(ADI_STREAM_DMA_USB, streamDmaType, &dmaConfig);
+	if(status != CY_U3P_SUCCESS)
 	{
-		/* Send COMMAND 0x800
-		 * Command is Page 0, Address 62 */
-		tempWriteBuffer[1] = (0x80) | (0x3E);
-		tempWriteBuffer[0] = 0;
-		status = CyU3PSpiTransmitWords(tempWriteBuffer, 2);
-		AdiSleepForMicroSeconds(FX3State.StallTime);
-		tempWriteBuffer[1] = (0x80) | (0x3F);
-		tempWriteBuffer[0] = 0x08;
-		status = CyU3PSpiTransmitWords(tempWriteBuffer, 2);
-		AdiSleepForMicroSeconds(FX3State.StallTime);
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
 	}
 
-	/* Manually reset SPI Rx/Tx FIFO */
-	AdiSpiResetFifo(CyTrue, CyTrue);
+	/* Configure SPI TX DMA (CPU memory to SPI for burst mode)
+	 * Transfer length must equal length of message to be sent
+	 * Each buffer holds one burst, and ADI_BURST_TX_CHAIN bursts are kept queued on the SPI socket */
+	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
+    dmaConfig.size 				= StreamThreadState.RoundedByteTransferLength;
+    dmaConfig.count 			= ADI_BURST_TX_CHAIN;
+    dmaConfig.prodSckId 		= CY_U3P_CPU_SOCKET_PROD;
+    dmaConfig.consSckId 		= CY_U3P_LPP_SOCKET_SPI_CONS;
+    dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
+    dmaConfig.prodHeader     	= 0;
+    dmaConfig.prodFooter     	= 0;
+    dmaConfig.consHeader     	= 0;
+    dmaConfig.notification   	= 0;
+    dmaConfig.cb             	= NULL;
+    dmaConfig.prodAvailCount 	= 0;
 
-	/* Set the SPI config for streaming mode (8 bit transactions) */
+	/* Get the memory to SPI (Tx) channel from the pool */
+	status = AdiStreamDmaChannelGet(ADI_STREAM_DMA_TX, CY_U3P_DMA_TYPE_MANUAL_OUT, &dmaConfig);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+
+	/* Flush the streaming endpoint */
+	status = CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+
+	/* Manually reset the SPI Rx/Tx FIFO, and set the SPI config for streaming mode (8 bit transactions) */
+	AdiSpiLock();
+	AdiSpiResetFifo(CyTrue, CyTrue);
 	AdiSetSpiWordLength(8);
+	AdiSpiUnlock();
+
+	/* Fill the Tx DMA buffers with regList and queue them all on the SPI socket */
+	status = AdiBurstTxChainInit();
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+	StreamThreadState.BurstArmed = CyFalse;
+
+	/* Enable an infinite DMA transfer on the streaming channel */
+	status = CyU3PDmaChannelSetXfer(&StreamingChannel, 0);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+
+	/* Clear the profile counters for the new stream */
+	ADI_PROFILE_START(ADI_BURST_STREAM_ENABLE);
+
+	/* Set the burst stream flag to notify the streaming thread it should take over */
+	status = CyU3PEventSet(&EventHandler, ADI_BURST_STREAM_ENABLE, CYU3P_EVENT_OR);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		AdiAppErrorHandler(status);
+	}
+
+	return status;
+}
+
+/**
+  * @brief Cleans up resources allocated for a IMU burst stream.
+  *
+  * @return The status of the cancel operation.
+  *
+  * This function cleans up after a burst stream by resetting the SPI port and notifying the host
+  * that the cancel operation was successful.
+ **/
+CyU3PReturnStatus_t AdiBurstStreamFinished()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+
+	/* Hold off register accesses on other threads until the SPI state is restored */
+	AdiSpiLock();
+
+	/* Reset the SPI controller */
+	SPI->lpp_spi_config &= ~(CY_U3P_LPP_SPI_RX_ENABLE | CY_U3P_LPP_SPI_TX_ENABLE | CY_U3P_LPP_SPI_DMA_MODE | CY_U3P_LPP_SPI_ENABLE);
+	while ((SPI->lpp_spi_config & CY_U3P_LPP_SPI_ENABLE) != 0);
+
+	/* Remove the interrupt from the global data ready pin */
+	CyU3PGpioSimpleConfig_t gpioConfig;
+	gpioConfig.outValue = CyTrue;
+	gpioConfig.inputEn = CyTrue;
+	gpioConfig.driveLowEn = CyFalse;
+	gpioConfig.driveHighEn = CyFalse;
+	gpioConfig.intrMode = CY_U3P_GPIO_NO_INTR;
+	CyU3PGpioSetSimpleConfig(FX3State.DrPin, &gpioConfig);
+
+	/* The SPI controller is reset, so there is no burst left for the GPIO ISR to start */
+	StreamThreadState.BurstArmed = CyFalse;
+
+	/* Return the MemoryToSpi and burst DMA channels to the pool */
+	AdiStreamDmaChannelRelease(ADI_STREAM_DMA_TX);
+	AdiStreamDmaChannelRelease(ADI_STREAM_DMA_USB);
+
+	/* Release the SPI receive channel used for time stamped or framed streams */
+	if(StreamThreadState.RxCopyMode)
+	{
+		AdiStreamRxChannelRelease();
+	}
+
+	/* Free the capture ring */
+	AdiCaptureRelease();
+
+	/* Flush the streaming end point */
+	CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+
+	/* Clear all interrupt flags */
+	CyU3PVicClearInt();
+
+	/* Re-enable relevant ISRs */
+	CyU3PVicEnableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+	CyU3PVicEnableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
+
+	/* Restore the SPI state */
+	AdiSetSpiWordLength(FX3State.SpiConfig.wordLen);
+	AdiSpiUnlock();
+
+	/* Stop waking the stream thread on data ready edges */
+	StreamThreadState.DrInterruptWait = CyFalse;
+
+	/* Keep the statistics for the finished stream readable */
+	StreamThreadState.Stats.Active = CyFalse;
+
+	/* Reset KillStreamEarly flag in case the user wants to capture data again */
+	KillStreamEarly = CyFalse;
+
+	return status;
+}
+
+/**
+  * @brief Accepts an SPI pipe start request. Called from the vendor request handler.
+  *
+  * @param length The length of the control endpoint data, in bytes
+  *
+  * @return A status code indicating the success of the function. CY_U3P_ERROR_ALREADY_STARTED if a pipe or stream is running.
+  *
+  * The total pipe length in bytes[0-3] is read from the control endpoint, and the pipe start is handed to
+  * the AppThread. A pipe which can not run is refused here, before the control data is read, so the request
+  * stalls and the PC knows not to send the MOSI data. Errors found once the data is read (a zero length) and
+  * errors setting the pipe up on the AppThread are returned by ADI_SPI_PIPE_STATUS_CMD.
+ **/
+CyU3PReturnStatus_t AdiSpiPipeRequest(uint16_t length)
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	uint16_t bytesRead = 0;
+
+	/* The pipe needs the SPI block, streaming endpoint and stream DMA pool to itself */
+	if(AdiStreamBusy())
+	{
+		return CY_U3P_ERROR_ALREADY_STARTED;
+	}
+
+	/* Get the pipe length from the control endpoint */
+	status = CyU3PUsbGetEP0Data(length, USBBuffer, &bytesRead);
+	if(status != CY_U3P_SUCCESS)
+	{
+		return status;
+	}
+	SpiPipeLength = USBBuffer[0];
+	SpiPipeLength |= (USBBuffer[1] << 8);
+	SpiPipeLength |= (USBBuffer[2] << 16);
+	SpiPipeLength |= (USBBuffer[3] << 24);
+	if((bytesRead < 4) || (SpiPipeLength == 0))
+	{
+		SpiPipeStatus = CY_U3P_ERROR_BAD_ARGUMENT;
+		return SpiPipeStatus;
+	}
+
+	SpiPipeStatus = CY_U3P_SUCCESS;
+	return CyU3PEventSet(&EventHandler, ADI_SPI_PIPE_START, CYU3P_EVENT_OR);
+}
+
+/**
+  * @brief Starts the SPI pipe, which bridges the PC to FX3 bulk endpoint to the SPI bus without CPU copies.
+  *
+  * @return A status code indicating the success of the function. CY_U3P_ERROR_ALREADY_STARTED if a pipe or stream is running.
+  *
+  * Runs on the AppThread, after AdiSpiPipeRequest accepted the pipe. Bytes written by the PC to endpoint
+  * 0x01 are sent to the SPI consumer socket by an auto DMA channel, and the bytes clocked in on MISO are sent
+  * from the SPI producer socket to the streaming endpoint (0x81) by a second auto DMA channel. The SPI block
+  * runs one 8 bit DMA block transfer of the full pipe length, so chip select follows the SSN control in the
+  * SPI config for the whole pipe. ChannelFromPC (bulk commands) is destroyed while the pipe owns endpoint 0x01.
+  * If the pipe DMA can not be set up, the pipe keeps endpoint 0x01 anyway (so the MOSI data is never run as
+  * bulk commands) until the PC ends it. The PC ends the pipe with ADI_STREAM_DONE_CMD once all the MISO data
+  * has been read, or with ADI_STREAM_STOP_CMD. The start status is kept for ADI_SPI_PIPE_STATUS_CMD.
+ **/
+CyU3PReturnStatus_t AdiSpiPipeStart()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	CyU3PDmaChannelConfig_t dmaConfig;
+
+	/* A stream may have been accepted while the pipe start waited for the AppThread */
+	if(AdiStreamBusy())
+	{
+		status = CY_U3P_ERROR_ALREADY_STARTED;
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		SpiPipeStatus = status;
+		return status;
+	}
+	StreamThreadState.TransferByteLength = SpiPipeLength;
 
-	/* Print the stream state if in verbose mode */
 #ifdef VERBOSE_MODE
-	AdiPrintStreamState();
+	ADI_LOG("Starting SPI pipe, %d bytes\r\n", StreamThreadState.TransferByteLength);
 #endif
 
-	/* Set infinite DMA transfer on streaming channel */
-	CyU3PDmaChannelSetXfer(&StreamingChannel, 0);
+	/* The pipe takes over the PC to FX3 endpoint socket from the bulk command channel */
+	AdiBulkCommandChannelDestroy();
+	SpiPipeActive = CyTrue;
+
+	/* The MOSI data is not decoded, so the DUT page is no longer known */
+	AdiInvalidatePageCache();
+
+	/* PC to SPI auto DMA channel */
+	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
+	dmaConfig.size 				= FX3State.UsbBufferSize;
+	dmaConfig.count 			= 8;
+	dmaConfig.prodSckId 		= CY_U3P_UIB_SOCKET_PROD_1;
+	dmaConfig.consSckId 		= CY_U3P_LPP_SOCKET_SPI_CONS;
+	dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
+	status = AdiStreamDmaChannelGet(ADI_STREAM_DMA_TX, CY_U3P_DMA_TYPE_AUTO, &dmaConfig);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		SpiPipeStatus = status;
+		return status;
+	}
+
+	/* SPI to PC auto DMA channel, in full streaming endpoint bursts */
+	dmaConfig.size 				= FX3State.StreamDmaBufferSize;
+	dmaConfig.count 			= AdiStreamDmaBufferCount(8);
+	dmaConfig.prodSckId 		= CY_U3P_LPP_SOCKET_SPI_PROD;
+	dmaConfig.consSckId 		= CY_U3P_UIB_SOCKET_CONS_1;
+	status = AdiStreamDmaChannelGet(ADI_STREAM_DMA_USB, CY_U3P_DMA_TYPE_AUTO, &dmaConfig);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		SpiPipeStatus = status;
+		return status;
+	}
+
+	/* Flush both endpoints */
+	CyU3PUsbFlushEp(ADI_FROM_PC_ENDPOINT);
+	CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+
+	/* Enable infinite DMA transfers on both channels. The SPI block sets the pipe length */
+	status = CyU3PDmaChannelSetXfer(&MemoryToSPI, 0);
+	status |= CyU3PDmaChannelSetXfer(&StreamingChannel, 0);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, status);
+		SpiPipeStatus = status;
+		return status;
+	}
+
+	/* Reset the SPI FIFOs and set 8 bit words, so the pipe length is in bytes */
+	AdiSpiLock();
+	AdiSpiResetFifo(CyTrue, CyTrue);
+	AdiSetSpiWordLength(8);
 
-	/* Set the real-time data capture thread flag */
-	CyU3PEventSet (&EventHandler, ADI_RT_STREAM_ENABLE, CYU3P_EVENT_OR);
+	/* Start the SPI DMA block transfer. It runs as fast as the PC supplies MOSI data */
+	SPI->lpp_spi_config |= CY_U3P_LPP_SPI_DMA_MODE;
+	SPI->lpp_spi_tx_byte_count = StreamThreadState.TransferByteLength;
+	SPI->lpp_spi_rx_byte_count = StreamThreadState.TransferByteLength;
+	SPI->lpp_spi_config |= (CY_U3P_LPP_SPI_RX_ENABLE | CY_U3P_LPP_SPI_TX_ENABLE);
+	SPI->lpp_spi_config |= CY_U3P_LPP_SPI_ENABLE;
+	AdiSpiUnlock();
 
 	return status;
 }
 
 /**
-  * @brief This function cleans up resources allocated for a real time stream.
+  * @brief Ends the SPI pipe, and gives endpoint 0x01 back to the bulk command channel.
   *
-  * @return The status of the cancel operation.
+  * @return A status code indicating the success of the function.
   *
-  * This function cleans up after a real-time stream by resetting the SPI port, triggering the
-  * SYNC/RTS pin (if asked to do so), and notifying the host that the cancel operation was successful.
+  * Aborts any pipe data still in flight, so this is also used to cancel a pipe early.
  **/
-CyU3PReturnStatus_t AdiRealTimeStreamFinished()
+CyU3PReturnStatus_t AdiSpiPipeFinished()
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 
-	/* Pull SYNC/RTS pin low to force x021 out of RT mode */
-	if(StreamThreadState.PinExitEnable || StreamThreadState.PinStartEnable)
+	if(!SpiPipeActive)
 	{
-		/* Configure SYNC/RTS as an output and set high */
-		CyU3PGpioSimpleConfig_t gpioConfig;
-		gpioConfig.outValue = CyFalse;
-		gpioConfig.inputEn = CyFalse;
-		gpioConfig.driveLowEn = CyTrue;
-		gpioConfig.driveHighEn = CyTrue;
-		gpioConfig.intrMode = CY_U3P_GPIO_NO_INTR;
-		CyU3PGpioSetSimpleConfig(FX3State.BusyPin, &gpioConfig);
-
-		/* Reset flag for next run */
-		StreamThreadState.PinExitEnable = CyFalse;
+		return CY_U3P_ERROR_NOT_STARTED;
 	}
 
-	/* Stop pin output drive and enable as input */
-	CyU3PGpioSimpleConfig_t gpioConfig;
-	gpioConfig.inputEn = CyTrue;
-	gpioConfig.driveLowEn = CyFalse;
-	gpioConfig.driveHighEn = CyFalse;
-	CyU3PGpioSetSimpleConfig(FX3State.BusyPin, &gpioConfig);
-
-	/* Disable SPI DMA mode */
+	/* Stop the SPI block transfer and reset the SPI controller. Register accesses on other threads are held off
+	 * until the SPI state is restored */
+	AdiSpiLock();
 	CyU3PSpiDisableBlockXfer(CyTrue, CyTrue);
-
-	/* Reset the SPI controller */
 	SPI->lpp_spi_config &= ~(CY_U3P_LPP_SPI_RX_ENABLE | CY_U3P_LPP_SPI_TX_ENABLE | CY_U3P_LPP_SPI_DMA_MODE | CY_U3P_LPP_SPI_ENABLE);
 	while ((SPI->lpp_spi_config & CY_U3P_LPP_SPI_ENABLE) != 0);
 
-    /* Tear down the RT streaming channel */
-    status = CyU3PDmaChannelDestroy(&StreamingChannel);
-	if(status != CY_U3P_SUCCESS)
-	{
-		AdiLogError(StreamFunctions_c, __LINE__, status);
-	}
+	/* Return the pipe channels to the pool. The PC to SPI channel is destroyed, since it holds the endpoint 0x01 socket */
+	AdiStreamDmaChannelRelease(ADI_STREAM_DMA_TX);
+	AdiStreamDmaChannelRelease(ADI_STREAM_DMA_USB);
 
-	/* Flush streaming end point */
+	/* Flush both endpoints */
+	CyU3PUsbFlushEp(ADI_FROM_PC_ENDPOINT);
 	CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
 
-	/* Clear all interrupt flags */
-	CyU3PVicClearInt();
-
-	/* Re-enable relevant ISRs */
-	CyU3PVicEnableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
-	CyU3PVicEnableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
-
 	/* Restore the SPI state */
-	status = CyU3PSpiSetConfig(&FX3State.SpiConfig, NULL);
+	AdiSetSpiWordLength(FX3State.SpiConfig.wordLen);
+	AdiSpiUnlock();
+
+	/* Give endpoint 0x01 back to the bulk command channel */
+	SpiPipeActive = CyFalse;
+	status = AdiBulkCommandChannelCreate();
 	if(status != CY_U3P_SUCCESS)
 	{
 		AdiLogError(StreamFunctions_c, __LINE__, status);
 	}
 
-	/* Reset KillStreamEarly flag in case the user wants to capture data again */
-	KillStreamEarly = CyFalse;
+#ifdef VERBOSE_MODE
+	ADI_LOG("SPI pipe finished\r\n");
+#endif
 
-	/* Return status code */
 	return status;
 }
 
 /**
-  * @brief Starts a burst stream for IMU products.
+  * @brief Sends the SPI pipe status to the PC over the control endpoint.
   *
-  * @return The status of starting a real-time stream.
+  * @return void
   *
-  * This function kicks off a burst stream by configuring a pin interrupt on a user-specified pin, configuring
-  * the SPI and USB DMAs to handle the incoming data, and enabling the streaming function.It can be configured
-  * for "Blackfin" or "ADuC" burst using vendor requests.
+  * All values are little endian: status[0-3] of the last pipe start (CY_U3P_SUCCESS while the pipe runs),
+  * pipe active flag[4-7] (the pipe owns endpoint 0x01 until it is ended) and the pipe length in bytes[8-11].
  **/
-CyU3PReturnStatus_t AdiBurstStreamStart()
+void AdiGetSpiPipeStatus()
 {
-	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
-	uint16_t bytesRead;
-	uint16_t triggerLength;
-
-	/* Disable VBUS ISR */
-	CyU3PVicDisableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
-
-	/* Disable GPIO interrupt before attaching interrupt to pin */
-	CyU3PVicDisableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
+	USBBuffer[4] = SpiPipeActive;
+	USBBuffer[5] = 0;
+	USBBuffer[6] = 0;
+	USBBuffer[7] = 0;
+	USBBuffer[8] = SpiPipeLength & 0xFF;
+	USBBuffer[9] = (SpiPipeLength & 0xFF00) >> 8;
+	USBBuffer[10] = (SpiPipeLength & 0xFF0000) >> 16;
+	USBBuffer[11] = (SpiPipeLength & 0xFF000000) >> 24;
+	AdiSendStatus(SpiPipeStatus, ADI_SPI_PIPE_STATUS_LENGTH, CyTrue);
+}
 
-	/* Make sure the global data ready pin is configured as an input and attach the interrupt to the correct edge */
-	if(FX3State.DrActive)
-		AdiConfigureDrPin();
+/**
+  * @brief Fills the burst stream Tx DMA buffers and queues them on the SPI consumer socket.
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * Every burst sends the same bytes (the burst trigger from regList, then zeros), so the buffers are only
+  * filled here. The stream thread puts each buffer back in the queue once the SPI block has sent it, so the
+  * next bursts always have their Tx data waiting on the socket and the DMA channel is never set up again
+  * while the stream runs.
+ **/
+static CyU3PReturnStatus_t AdiBurstTxChainInit()
+{
+	CyU3PReturnStatus_t status;
+	CyU3PDmaBuffer_t txBuffer;
+	uint32_t index;
 
-	/* Get the number of buffers, trigger word, and transfer length from the control endpoint */
-	CyU3PUsbGetEP0Data(StreamThreadState.TransferWordLength, USBBuffer, &bytesRead);
-	if(status != CY_U3P_SUCCESS)
+	status = CyU3PDmaChannelSetXfer(&MemoryToSPI, 0);
+	for(index = 0; (index < ADI_BURST_TX_CHAIN) && (status == CY_U3P_SUCCESS); index++)
 	{
-		AdiLogError(StreamFunctions_c, __LINE__, status);
-		AdiAppErrorHandler(status);
+		status = CyU3PDmaChannelGetBuffer(&MemoryToSPI, &txBuffer, CYU3P_NO_WAIT);
+		if(status == CY_U3P_SUCCESS)
+		{
+			CyU3PMemCopy(txBuffer.buffer, StreamThreadState.RegList, StreamThreadState.TransferByteLength);
+			status = CyU3PDmaChannelCommitBuffer(&MemoryToSPI, StreamThreadState.TransferByteLength, 0);
+		}
 	}
+	return status;
+}
 
-	/* Parse number of buffers */
-	StreamThreadState.NumBuffers = USBBuffer[0];
-	StreamThreadState.NumBuffers |= (USBBuffer[1] << 8);
-	StreamThreadState.NumBuffers |= (USBBuffer[2] << 16);
-	StreamThreadState.NumBuffers |= (USBBuffer[3] << 24);
-
-	/* Parse transfer byte length */
-	StreamThreadState.TransferByteLength = USBBuffer[4];
-	StreamThreadState.TransferByteLength |= (USBBuffer[5] << 8);
-	StreamThreadState.TransferByteLength |= (USBBuffer[6] << 16);
-	StreamThreadState.TransferByteLength |= (USBBuffer[7] << 24);
-
-	/* Set regList memory to correct length plus trigger word */
-	StreamThreadState.RegList = CyU3PDmaBufferAlloc(sizeof(uint8_t) * StreamThreadState.TransferByteLength);
-
-	/* Clear (zero) contents of regList memory. Burst transfers are DNC, so we're sending zeros */
-	CyU3PMemSet(StreamThreadState.RegList, 0, sizeof(uint8_t) * StreamThreadState.TransferByteLength);
-
-	/* Calculate trigger length (USB transfer length - header size) */
-	triggerLength = bytesRead - 8;
+/**
+  * @brief Starts a logic analyzer stream of the iSensor and FX3 GPIO pins.
+  *
+  * @return A status code indicating the success of the logic analyzer stream start.
+  *
+  * The stream settings are read from the control endpoint, little endian: sample period in 10MHz timer
+  * ticks[0-3], number of samples[4-7] (0 samples until the stream is stopped) and an FX3 GPIO bit mask
+  * of the pins to sample[8-11]. Only the pins in the board pin map (RESET, DIO1-4, FX3_GPIO1-4) can be
+  * sampled, and a mask of 0 samples all of them. The stream thread samples the pins each period, paced
+  * by the free running complex GPIO timer, and sends run length records on the streaming endpoint.
+ **/
+CyU3PReturnStatus_t AdiLogicStreamStart()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	CyU3PDmaChannelConfig_t dmaConfig;
+	uint32_t mappedPins;
+	uint16_t bytesRead = 0;
 
-	/* Append burst trigger word to the first two bytes of regList */
-	for(int i = 0; i< triggerLength; i++)
+	/* Don't take the SPI block and stream DMA channels from a running stream or SPI pipe */
+	status = AdiStreamStartCheck(CyTrue);
+	if(status != CY_U3P_SUCCESS)
 	{
-		StreamThreadState.RegList[i] = USBBuffer[i + 8];
+		return status;
 	}
 
-	/* Calculate the required memory block (in bytes) to be a multiple of 16 */
-	uint16_t remainder = StreamThreadState.TransferByteLength % 16;
-	if (remainder == 0)
-	{
-		StreamThreadState.RoundedByteTransferLength = StreamThreadState.TransferByteLength;
-	}
-	else
+	/* Get the stream settings from the control endpoint */
+	status = CyU3PUsbGetEP0Data(ADI_LOGIC_START_LENGTH, USBBuffer, &bytesRead);
+	if((status == CY_U3P_SUCCESS) && (bytesRead < ADI_LOGIC_START_LENGTH))
 	{
-		StreamThreadState.RoundedByteTransferLength = StreamThreadState.TransferByteLength + 16 - remainder;
+		status = CY_U3P_ERROR_BAD_ARGUMENT;
 	}
-
-#ifdef VERBOSE_MODE
-	 CyU3PDebugPrint (4, "Starting burst stream!\r\n");
-	 CyU3PDebugPrint (4, "burstTriggerUpper:  %d\r\n", StreamThreadState.RegList[0]);
-	 CyU3PDebugPrint (4, "burstTriggerLower:  %d\r\n", StreamThreadState.RegList[1]);
-	 CyU3PDebugPrint (4, "roundedTransferLength:  %d\r\n", StreamThreadState.RoundedByteTransferLength);
-	 CyU3PDebugPrint (4, "transferByteLength:  %d\r\n", StreamThreadState.TransferByteLength);
-	 CyU3PDebugPrint (4, "numBuffers:  %d\r\n", StreamThreadState.NumBuffers);
-	 CyU3PDebugPrint (4, "USB Buffer Size:  %d\r\n", FX3State.UsbBufferSize);
-#endif
-
-	/* Configure the Burst DMA Streaming Channel (SPI to PC) for Auto DMA */
-	CyU3PDmaChannelConfig_t dmaConfig;
-	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
-	dmaConfig.size 				= FX3State.UsbBufferSize;
-	dmaConfig.count 			= 8;
-	dmaConfig.prodSckId 		= CY_U3P_LPP_SOCKET_SPI_PROD;
-	dmaConfig.consSckId 		= CY_U3P_UIB_SOCKET_CONS_1;
-	dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
-	dmaConfig.prodHeader    	= 0;
-	dmaConfig.prodFooter    	= 0;
-	dmaConfig.consHeader    	= 0;
-	dmaConfig.notification  	= 0;
-	dmaConfig.cb            	= NULL;
-	dmaConfig.prodAvailCount	= 0;
-
-	/* Destroy and re-create streaming DMA channel */
-	CyU3PDmaChannelDestroy(&StreamingChannel);
-	status = CyU3PDmaChannelCreate(&StreamingChannel, CY_U3P_DMA_TYPE_AUTO, &dmaConfig);
 	if(status != CY_U3P_SUCCESS)
 	{
 		AdiLogError(StreamFunctions_c, __LINE__, status);
-		AdiAppErrorHandler(status);
+		return status;
 	}
-
-	/* Configure SPI TX DMA (CPU memory to SPI for burst mode)
-	 * Transfer length must equal length of message to be sent
-	 * Count not required since the DMA will be run in override mode */
-	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
-    dmaConfig.size 				= StreamThreadState.RoundedByteTransferLength;
-    dmaConfig.count 			= 0;
-    dmaConfig.prodSckId 		= CY_U3P_CPU_SOCKET_PROD;
-    dmaConfig.consSckId 		= CY_U3P_LPP_SOCKET_SPI_CONS;
-    dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
-    dmaConfig.prodHeader     	= 0;
-    dmaConfig.prodFooter     	= 0;
-    dmaConfig.consHeader     	= 0;
-    dmaConfig.notification   	= 0;
-    dmaConfig.cb             	= NULL;
-    dmaConfig.prodAvailCount 	= 0;
-
-    /* Destroy and re-create memory to SPI (Tx) channel */
-    CyU3PDmaChannelDestroy(&MemoryToSPI);
-    status = CyU3PDmaChannelCreate(&MemoryToSPI, CY_U3P_DMA_TYPE_MANUAL_OUT, &dmaConfig);
-	if(status != CY_U3P_SUCCESS)
+	StreamThreadState.LogicPeriodTicks = USBBuffer[0];
+	StreamThreadState.LogicPeriodTicks |= (USBBuffer[1] << 8);
+	StreamThreadState.LogicPeriodTicks |= (USBBuffer[2] << 16);
+	StreamThreadState.LogicPeriodTicks |= (USBBuffer[3] << 24);
+	StreamThreadState.NumCaptures = USBBuffer[4];
+	StreamThreadState.NumCaptures |= (USBBuffer[5] << 8);
+	StreamThreadState.NumCaptures |= (USBBuffer[6] << 16);
+	StreamThreadState.NumCaptures |= (USBBuffer[7] << 24);
+	StreamThreadState.LogicPinMask = USBBuffer[8];
+	StreamThreadState.LogicPinMask |= (USBBuffer[9] << 8);
+	StreamThreadState.LogicPinMask |= (USBBuffer[10] << 16);
+	StreamThreadState.LogicPinMask |= (USBBuffer[11] << 24);
+	if(StreamThreadState.LogicPeriodTicks < ADI_LOGIC_MIN_PERIOD_TICKS)
 	{
+		status = CY_U3P_ERROR_BAD_ARGUMENT;
 		AdiLogError(StreamFunctions_c, __LINE__, status);
-		AdiAppErrorHandler(status);
+		return status;
 	}
 
-	/* Flush the streaming endpoint */
-	status = CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
-	if(status != CY_U3P_SUCCESS)
+	/* Limit the sampled pins to the board pin map */
+	mappedPins = AdiLogicMappedPins();
+	StreamThreadState.LogicPinMask &= mappedPins;
+	if(StreamThreadState.LogicPinMask == 0)
 	{
-		AdiLogError(StreamFunctions_c, __LINE__, status);
-		AdiAppErrorHandler(status);
+		StreamThreadState.LogicPinMask = mappedPins;
 	}
 
-	/* Manually reset the SPI Rx/Tx FIFO */
-	AdiSpiResetFifo(CyTrue, CyTrue);
+	/* Disable VBUS ISR */
+	CyU3PVicDisableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
 
-	/* Set the SPI config for streaming mode (8 bit transactions) */
-	AdiSetSpiWordLength(8);
+	/* Disable the GPIO ISR, so it does not add jitter to the sample times */
+	CyU3PVicDisableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
 
-	/* Configure SpiDmaBuffer and feed it regList*/
-	CyU3PMemSet ((uint8_t *)&SpiDmaBuffer, 0, sizeof(SpiDmaBuffer));
-	SpiDmaBuffer.count = StreamThreadState.TransferByteLength;
-	SpiDmaBuffer.size = StreamThreadState.RoundedByteTransferLength;
-	SpiDmaBuffer.buffer = StreamThreadState.RegList;
-	SpiDmaBuffer.status = 0;
+	/* Samples are paced by the timer, not data ready, and are not time stamped */
+	AdiStreamDataReadyInit();
+	StreamThreadState.DrInterruptWait = CyFalse;
+	StreamThreadState.TimestampsEnabled = CyFalse;
+	AdiStreamFrameInit(ADI_STREAM_FRAME_TYPE_LOGIC);
+	StreamThreadState.DrMissCheck = CyFalse;
 
-	/* Enable an infinite DMA transfer on the streaming channel */
-	status = CyU3PDmaChannelSetXfer(&StreamingChannel, 0);
+	/* Pack as many run records as fit in each USB buffer */
+	StreamThreadState.BytesPerBuffer = ADI_LOGIC_RECORD_BYTES;
+	StreamThreadState.BytesPerUsbPacket = AdiStreamBytesPerUsbPacket(ADI_LOGIC_RECORD_BYTES);
+
+	/* Configure StreamChannel for CPU to USB manual DMA */
+	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
+	dmaConfig.size 				= StreamThreadState.UsbBufferBytes;
+	dmaConfig.count 			= AdiStreamUsbBufferCount(16);
+	dmaConfig.prodSckId 		= CY_U3P_CPU_SOCKET_PROD;
+	dmaConfig.consSckId 		= CY_U3P_UIB_SOCKET_CONS_1;
+	dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
+	status = AdiStreamDmaChannelGet(ADI_STREAM_DMA_USB, CY_U3P_DMA_TYPE_MANUAL_OUT, &dmaConfig);
 	if(status != CY_U3P_SUCCESS)
 	{
 		AdiLogError(StreamFunctions_c, __LINE__, status);
 		AdiAppErrorHandler(status);
 	}
 
-	/* Set the burst stream flag to notify the streaming thread it should take over */
-	status = CyU3PEventSet(&EventHandler, ADI_BURST_STREAM_ENABLE, CYU3P_EVENT_OR);
+	/* Log stream state in vebose mode */
+	AdiPrintStreamState();
+
+	/* Flush streaming endpoint */
+	CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+
+	/* Enable an infinite DMA transfer on the streaming channel */
+	status = CyU3PDmaChannelSetXfer(&StreamingChannel, 0);
 	if(status != CY_U3P_SUCCESS)
 	{
 		AdiLogError(StreamFunctions_c, __LINE__, status);
 		AdiAppErrorHandler(status);
 	}
 
+	/* Run the timer free, and start the first run at the current pin state */
+	GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].period = 0xFFFFFFFF;
+	StreamThreadState.LogicState = GPIO->lpp_gpio_invalue0 & StreamThreadState.LogicPinMask;
+	StreamThreadState.LogicRunLength = 0;
+	StreamThreadState.LogicBufferTime = CyU3PGetTime();
+	StreamThreadState.LogicNextSample = AdiReadTimerRegValue() + StreamThreadState.LogicPeriodTicks;
+
+#ifdef VERBOSE_MODE
+	ADI_LOG("Logic analyzer stream started. Period: %d ticks, samples: %d, pin mask: 0x%x\r\n", StreamThreadState.LogicPeriodTicks, StreamThreadState.NumCaptures, StreamThreadState.LogicPinMask);
+#endif
+
+	/* Set the logic stream flag to notify the streaming thread it should take over */
+	CyU3PEventSet (&EventHandler, ADI_LOGIC_STREAM_ENABLE, CYU3P_EVENT_OR);
+
 	return status;
 }
 
 /**
-  * @brief Cleans up resources allocated for a IMU burst stream.
-  *
-  * @return The status of the cancel operation.
+  * @brief Cleans up a logic analyzer stream.
   *
-  * This function cleans up after a burst stream by resetting the SPI port and notifying the host
-  * that the cancel operation was successful.
+  * @return A status code indicating the success of the logic analyzer stream clean up.
  **/
-CyU3PReturnStatus_t AdiBurstStreamFinished()
+CyU3PReturnStatus_t AdiLogicStreamFinished()
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 
-	/* Reset the SPI controller */
-	SPI->lpp_spi_config &= ~(CY_U3P_LPP_SPI_RX_ENABLE | CY_U3P_LPP_SPI_TX_ENABLE | CY_U3P_LPP_SPI_DMA_MODE | CY_U3P_LPP_SPI_ENABLE);
-	while ((SPI->lpp_spi_config & CY_U3P_LPP_SPI_ENABLE) != 0);
-
-	/* Remove the interrupt from the global data ready pin */
-	CyU3PGpioSimpleConfig_t gpioConfig;
-	gpioConfig.outValue = CyTrue;
-	gpioConfig.inputEn = CyTrue;
-	gpioConfig.driveLowEn = CyFalse;
-	gpioConfig.driveHighEn = CyFalse;
-	gpioConfig.intrMode = CY_U3P_GPIO_NO_INTR;
-	CyU3PGpioSetSimpleConfig(FX3State.DrPin, &gpioConfig);
-
-	/* Destroy MemoryToSpi DMA channel */
-    status = CyU3PDmaChannelDestroy(&MemoryToSPI);
-	if(status != CY_U3P_SUCCESS)
-	{
-		AdiLogError(StreamFunctions_c, __LINE__, status);
-	}
+	/* Return the stream DMA channel to the pool */
+	AdiStreamDmaChannelRelease(ADI_STREAM_DMA_USB);
 
-    /* Destroy the burst DMA channel (and recover a LOT of memory) */
-    status = CyU3PDmaChannelDestroy(&StreamingChannel);
+	/* Flush the streaming end point */
+	status = CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
 	if(status != CY_U3P_SUCCESS)
 	{
 		AdiLogError(StreamFunctions_c, __LINE__, status);
 	}
 
-	/* Flush the streaming end point */
-	CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
-
 	/* Clear all interrupt flags */
 	CyU3PVicClearInt();
 
@@ -879,15 +2740,33 @@ CyU3PReturnStatus_t AdiBurstStreamFinished()
 	CyU3PVicEnableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
 	CyU3PVicEnableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
 
-	/* Restore the SPI state */
-	AdiSetSpiWordLength(FX3State.SpiConfig.wordLen);
+	/* Keep the statistics for the finished stream readable */
+	StreamThreadState.Stats.Active = CyFalse;
 
-	/* Reset KillStreamEarly flag in case the user wants to capture data again */
+	/* Clear stream kill flag */
 	KillStreamEarly = CyFalse;
 
 	return status;
 }
 
+/**
+  * @brief Finds the FX3 GPIO bit mask of the pins in the board pin map.
+  *
+  * @return The pin mask, with bit n set for FX3 GPIO n.
+ **/
+static uint32_t AdiLogicMappedPins()
+{
+	return (1 << FX3State.PinMap.ADI_PIN_RESET) |
+			(1 << FX3State.PinMap.ADI_PIN_DIO1) |
+			(1 << FX3State.PinMap.ADI_PIN_DIO2) |
+			(1 << FX3State.PinMap.ADI_PIN_DIO3) |
+			(1 << FX3State.PinMap.ADI_PIN_DIO4) |
+			(1 << FX3State.PinMap.FX3_PIN_GPIO1) |
+			(1 << FX3State.PinMap.FX3_PIN_GPIO2) |
+			(1 << FX3State.PinMap.FX3_PIN_GPIO3) |
+			(1 << FX3State.PinMap.FX3_PIN_GPIO4);
+}
+
 /**
   * @brief Starts a register read/write stream, with options to trigger on a data ready.
   *
@@ -900,6 +2779,14 @@ CyU3PReturnStatus_t AdiBurstStreamFinished()
 CyU3PReturnStatus_t AdiGenericStreamStart()
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	uint32_t bufferBytes;
+
+	/* Don't take the SPI block and stream DMA channels from a running stream or SPI pipe */
+	status = AdiStreamStartCheck(CyFalse);
+	if(status != CY_U3P_SUCCESS)
+	{
+		return status;
+	}
 
 	/* Disable VBUS ISR */
 	CyU3PVicDisableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
@@ -916,6 +2803,10 @@ CyU3PReturnStatus_t AdiGenericStreamStart()
 		AdiLogError(StreamFunctions_c, __LINE__, status);
 	}
 
+	/* Select the data ready wait, time stamp and frame modes for the stream workers */
+	AdiStreamDataReadyInit();
+	AdiStreamFrameInit(ADI_STREAM_FRAME_TYPE_GENERIC);
+
 	/* Get the number of buffers (number of times to read each set of registers) */
 	StreamThreadState.NumBuffers = USBBuffer[0];
 	StreamThreadState.NumBuffers += (USBBuffer[1] << 8);
@@ -930,7 +2821,22 @@ CyU3PReturnStatus_t AdiGenericStreamStart()
 
 	/* Calculate the number of bytes per buffer */
 	/* Number of times to read each set of registers * (number of registers - control registers) */
-	StreamThreadState.BytesPerBuffer = StreamThreadState.NumCaptures * (StreamThreadState.TransferByteLength - 8);
+	bufferBytes = StreamThreadState.NumCaptures * (StreamThreadState.TransferByteLength - 8);
+
+	/* Each buffer is prefixed with the data ready time stamp, if enabled */
+	if(StreamThreadState.TimestampsEnabled)
+	{
+		bufferBytes += ADI_STREAM_TIMESTAMP_BYTES;
+	}
+
+	/* The buffer size is stored in 16 bits. Don't run the stream with a truncated size */
+	if((StreamThreadState.NumCaptures == 0) || (StreamThreadState.NumCaptures > 0xFFFF) || (bufferBytes > 0xFFFF))
+	{
+		AdiLogError(StreamFunctions_c, __LINE__, CY_U3P_ERROR_BAD_ARGUMENT);
+		AdiGenericStreamFinished();
+		return CY_U3P_ERROR_BAD_ARGUMENT;
+	}
+	StreamThreadState.BytesPerBuffer = bufferBytes;
 
 	/* Set the reglist (just use the Bulk buffer - gives defined behavior)*/
 	StreamThreadState.RegList = BulkBuffer;
@@ -943,13 +2849,14 @@ CyU3PReturnStatus_t AdiGenericStreamStart()
 	StreamThreadState.RegList[StreamThreadState.TransferByteLength - 8] = 0;
 
 	/* Find number of register "buffers" which fit in a USB buffer */
-	if(StreamThreadState.BytesPerBuffer > FX3State.UsbBufferSize)
-	{
-		StreamThreadState.BytesPerUsbPacket = FX3State.UsbBufferSize;
-	}
-	else
+	StreamThreadState.BytesPerUsbPacket = AdiStreamBytesPerUsbPacket(StreamThreadState.BytesPerBuffer);
+
+	/* Store the samples in the capture ring instead, if a capture is set up. Don't run the stream without it */
+	status = AdiCaptureInit();
+	if(status != CY_U3P_SUCCESS)
 	{
-		StreamThreadState.BytesPerUsbPacket = ((FX3State.UsbBufferSize / StreamThreadState.BytesPerBuffer) * StreamThreadState.BytesPerBuffer);
+		AdiGenericStreamFinished();
+		return status;
 	}
 
 	/* Flush the streaming endpoint */
@@ -963,8 +2870,8 @@ CyU3PReturnStatus_t AdiGenericStreamStart()
 	/* Configure the StreamingChannel DMA (SPI to PC) */
 	CyU3PDmaChannelConfig_t dmaConfig;
 	CyU3PMemSet ((uint8_t *)&dmaConfig, 0, sizeof(dmaConfig));
-	dmaConfig.size 				= FX3State.UsbBufferSize;
-	dmaConfig.count 			= 16;
+	dmaConfig.size 				= StreamThreadState.UsbBufferBytes;
+	dmaConfig.count 			= AdiStreamUsbBufferCount(16);
 	dmaConfig.prodSckId 		= CY_U3P_CPU_SOCKET_PROD;
 	dmaConfig.consSckId 		= CY_U3P_UIB_SOCKET_CONS_1;
 	dmaConfig.dmaMode 			= CY_U3P_DMA_MODE_BYTE;
@@ -975,7 +2882,7 @@ CyU3PReturnStatus_t AdiGenericStreamStart()
 	dmaConfig.cb            	= NULL;
 	dmaConfig.prodAvailCount	= 0;
 
-	status = CyU3PDmaChannelCreate(&StreamingChannel, CY_U3P_DMA_TYPE_MANUAL_OUT, &dmaConfig);
+	status = AdiStreamDmaChannelGet(ADI_STREAM_DMA_USB, CY_U3P_DMA_TYPE_MANUAL_OUT, &dmaConfig);
 	if(status != CY_U3P_SUCCESS)
 	{
 		AdiLogError(StreamFunctions_c, __LINE__, status);
@@ -998,6 +2905,9 @@ CyU3PReturnStatus_t AdiGenericStreamStart()
 	/* Enable timer for stall */
 	AdiConfigStreamStallTimer();
 
+	/* Clear the profile counters for the new stream */
+	ADI_PROFILE_START(ADI_GENERIC_STREAM_ENABLE);
+
 	/* Enable generic data capture thread */
 	status = CyU3PEventSet (&EventHandler, ADI_GENERIC_STREAM_ENABLE, CYU3P_EVENT_OR);
 
@@ -1025,12 +2935,11 @@ CyU3PReturnStatus_t AdiGenericStreamFinished()
 	gpioConfig.intrMode = CY_U3P_GPIO_NO_INTR;
 	CyU3PGpioSetSimpleConfig(FX3State.DrPin, &gpioConfig);
 
-    /* Destroy the StreamingChannel channel (and recover a LOT of memory) */
-    status = CyU3PDmaChannelDestroy(&StreamingChannel);
-	if(status != CY_U3P_SUCCESS)
-	{
-		AdiLogError(StreamFunctions_c, __LINE__, status);
-	}
+	/* Return the StreamingChannel channel to the pool */
+	AdiStreamDmaChannelRelease(ADI_STREAM_DMA_USB);
+
+	/* Free the capture ring */
+	AdiCaptureRelease();
 
 	/* Flush the streaming endpoint */
 	status = CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
@@ -1046,6 +2955,12 @@ CyU3PReturnStatus_t AdiGenericStreamFinished()
 	CyU3PVicEnableInt(CY_U3P_VIC_GPIO_CORE_VECTOR);
 	CyU3PVicEnableInt(CY_U3P_VIC_GCTL_PWR_VECTOR);
 
+	/* Stop waking the stream thread on data ready edges */
+	StreamThreadState.DrInterruptWait = CyFalse;
+
+	/* Keep the statistics for the finished stream readable */
+	StreamThreadState.Stats.Active = CyFalse;
+
 	/* Reset KillStreamEarly flag in case the user wants to capture data again */
 	KillStreamEarly = CyFalse;
 
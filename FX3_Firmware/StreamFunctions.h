@@ -22,6 +22,37 @@
 /* Include the main header file */
 #include "main.h"
 
+/** Structure to track one DMA channel (and its buffer) in the stream DMA channel pool */
+typedef struct StreamDmaPoolEntry
+{
+	/** The DMA channel handle managed by this entry */
+	CyU3PDmaChannel *Channel;
+
+	/** Set while the channel is created */
+	CyBool_t Created;
+
+	/** The DMA channel type the channel was created with */
+	CyU3PDmaType_t Type;
+
+	/** The producer socket the channel was created with */
+	CyU3PDmaSocketId_t ProdSckId;
+
+	/** The consumer socket the channel was created with */
+	CyU3PDmaSocketId_t ConsSckId;
+
+	/** The DMA buffer size the channel was created with */
+	uint16_t Size;
+
+	/** The DMA buffer count the channel was created with */
+	uint16_t Count;
+
+	/** CPU side DMA buffer owned by this entry (SPI/I2C Rx data or SPI Tx data) */
+	uint8_t *Buffer;
+
+	/** Allocated size of Buffer, in bytes */
+	uint32_t BufferBytes;
+}StreamDmaPoolEntry;
+
 /* Real-time data stream functions. */
 CyU3PReturnStatus_t AdiRealTimeStreamStart();
 CyU3PReturnStatus_t AdiRealTimeStreamFinished();
@@ -42,13 +73,64 @@ CyU3PReturnStatus_t AdiBurstStreamFinished();
 CyU3PReturnStatus_t AdiI2CStreamStart();
 CyU3PReturnStatus_t AdiI2CStreamFinished();
 
+/* SPI pipe functions */
+CyU3PReturnStatus_t AdiSpiPipeRequest(uint16_t length);
+CyU3PReturnStatus_t AdiSpiPipeStart();
+CyU3PReturnStatus_t AdiSpiPipeFinished();
+void AdiGetSpiPipeStatus();
+
+/* Logic analyzer stream functions */
+CyU3PReturnStatus_t AdiLogicStreamStart();
+CyU3PReturnStatus_t AdiLogicStreamFinished();
+
 /* General stream functions. */
+CyBool_t AdiStreamBusy();
 CyU3PReturnStatus_t AdiStopAnyDataStream();
 CyBool_t AdiPrintStreamState();
 CyU3PReturnStatus_t AdiConfigureDrPin();
 
 /* Config functions */
 void AdiConfigStreamStallTimer();
+void AdiRestartStreamStallTimer();
+uint32_t AdiReadStreamTimer();
+
+/* Data ready functions */
+void AdiStreamDataReadyInit();
+CyU3PReturnStatus_t AdiWaitForStreamDataReady();
+void AdiRecordDataReadyLatency();
+void AdiGetDataReadyLatency();
+uint64_t AdiGetStreamTimestamp();
+
+/* Stream buffer functions */
+uint32_t AdiStreamBytesPerUsbPacket(uint32_t bytesPerBuffer);
+uint16_t AdiStreamUsbBufferCount(uint16_t singlePacketCount);
+uint16_t AdiStreamDmaBufferCount(uint16_t usbPacketCount);
+CyU3PReturnStatus_t AdiStreamRxChannelSetup(CyU3PDmaSocketId_t prodSocket, uint32_t numBytes);
+void AdiStreamRxChannelRelease();
+
+/* Stream DMA channel pool functions */
+CyU3PReturnStatus_t AdiStreamDmaChannelGet(uint8_t entry, CyU3PDmaType_t type, CyU3PDmaChannelConfig_t *config);
+void AdiStreamDmaChannelRelease(uint8_t entry);
+uint8_t *AdiStreamDmaBufferGet(uint8_t entry, uint32_t numBytes);
+void AdiStreamDmaPoolFlush();
+
+/* Stream frame functions */
+void AdiStreamFrameInit(uint8_t streamType);
+void AdiStreamCloseFrame(uint8_t *frame, uint32_t payloadBytes);
+uint32_t AdiStreamCrc32(uint8_t *data, uint32_t numBytes);
+
+/* Pre-trigger capture functions */
+CyU3PReturnStatus_t AdiCaptureConfigure(uint16_t length);
+CyU3PReturnStatus_t AdiCaptureInit();
+void AdiCaptureRelease();
+void AdiGetCaptureStatus();
+
+/* Stream statistics functions */
+void AdiStreamSampleStart();
+void AdiStreamSampleReady();
+void AdiStreamTransferError();
+void AdiStreamSampleOccupancy();
+void AdiGetStreamStats();
 
 /*
  * Stream action commands
@@ -63,4 +145,200 @@ void AdiConfigStreamStallTimer();
 /** Control endpoint index value to asynchronously stop a stream. */
 #define ADI_STREAM_STOP_CMD						2
 
+/** ADI_SPI_PIPE control endpoint index value to read the pipe status */
+#define ADI_SPI_PIPE_STATUS_CMD					3
+
+/** Length of the ADI_SPI_PIPE_STATUS_CMD response, in bytes */
+#define ADI_SPI_PIPE_STATUS_LENGTH				(12)
+
+/** Largest stream receive DMA buffer, in bytes (DMA buffer size is 16 bits, multiple of 16) */
+#define ADI_STREAM_DMA_MAX_BYTES				(0xFFF0)
+
+/** Number of burst stream Tx DMA buffers queued ahead on the SPI consumer socket */
+#define ADI_BURST_TX_CHAIN						(4)
+
+/** Timeout (ms) for each interrupt driven data ready wait, before checking for a stream cancel */
+#define ADI_DR_INTERRUPT_POLL_MS				(10)
+
+/** Size of the data ready time stamp placed before each stream sample, in bytes */
+#define ADI_STREAM_TIMESTAMP_BYTES				(8)
+
+/** Max size of a multi packet streaming DMA buffer filled by the CPU, in bytes */
+#define ADI_STREAM_MAX_USB_BUFFER_BYTES			(16384)
+
+/** Min number of multi packet streaming DMA buffers allocated for a CPU filled stream */
+#define ADI_STREAM_MIN_USB_BUFFER_COUNT			(4)
+
+/** Min number of full burst streaming DMA buffers allocated for an auto DMA stream */
+#define ADI_STREAM_MIN_DMA_BUFFER_COUNT			(2)
+
+/** Number of samples between USB buffer occupancy samples for automatic DMA streams */
+#define ADI_STREAM_OCCUPANCY_INTERVAL			(64)
+
+/** Stream DMA channel pool entry for the streaming endpoint channel (StreamingChannel) */
+#define ADI_STREAM_DMA_USB						(0)
+
+/** Stream DMA channel pool entry for the peripheral to CPU memory channel (StreamRxChannel) */
+#define ADI_STREAM_DMA_RX						(1)
+
+/** Stream DMA channel pool entry for the CPU memory to SPI channel (MemoryToSPI) */
+#define ADI_STREAM_DMA_TX						(2)
+
+/** Stream DMA channel pool entry with no channel, which owns the buffer filled while samples are dropped */
+#define ADI_STREAM_DMA_DISCARD					(3)
+
+/** Stream DMA channel pool entry with no channel, which owns the pre-trigger capture ring */
+#define ADI_STREAM_DMA_CAPTURE					(4)
+
+/** Number of stream DMA channel pool entries */
+#define ADI_STREAM_DMA_POOL_SIZE				(5)
+
+/** Number of stream overflow counters at the end of the ADI_GET_STREAM_STATS response */
+#define ADI_STREAM_OVERFLOW_STATS				(5)
+
+/** Length of the ADI_GET_STREAM_STATS response, in bytes */
+#define ADI_STREAM_STATS_LENGTH					(48 + (4 * ADI_STREAM_OCCUPANCY_BINS) + (4 * ADI_STREAM_OVERFLOW_STATS))
+
+/*
+ * Stream overflow policy definitions
+ */
+
+/** Stream overflow policy: wait as long as needed for the PC to free a USB buffer (default) */
+#define ADI_STREAM_OVERFLOW_BLOCK				(0)
+
+/** Stream overflow policy: after the overflow wait, drop new samples until the PC frees a USB buffer */
+#define ADI_STREAM_OVERFLOW_DROP_NEWEST			(1)
+
+/** Stream overflow policy: after the overflow wait, drop the USB buffers the PC has not read yet */
+#define ADI_STREAM_OVERFLOW_DROP_OLDEST			(2)
+
+/** Default time to wait for a free USB buffer before the overflow policy drops samples, in ms */
+#define ADI_STREAM_OVERFLOW_WAIT_MS				(10)
+
+/*
+ * Pre-trigger capture definitions
+ */
+
+/** ADI_TRIGGER_CAPTURE index: set the capture settings from the control endpoint data */
+#define ADI_CAPTURE_CONFIG_CMD					(0)
+
+/** ADI_TRIGGER_CAPTURE index: fire the capture trigger now */
+#define ADI_CAPTURE_TRIGGER_CMD					(1)
+
+/** ADI_TRIGGER_CAPTURE index: return the capture status */
+#define ADI_CAPTURE_STATUS_CMD					(2)
+
+/** Capture trigger source: only the ADI_CAPTURE_TRIGGER_CMD command */
+#define ADI_CAPTURE_TRIGGER_HOST				(0)
+
+/** Capture trigger source: an edge on an FX3 GPIO pin */
+#define ADI_CAPTURE_TRIGGER_PIN					(1)
+
+/** Capture trigger source: a word in the sample data crossing a threshold */
+#define ADI_CAPTURE_TRIGGER_THRESHOLD			(2)
+
+/** Capture threshold option: compare the sample word as a signed (two's complement) value */
+#define ADI_CAPTURE_THRESHOLD_SIGNED			(1 << 0)
+
+/** Capture threshold option: the sample word is stored least significant byte first */
+#define ADI_CAPTURE_THRESHOLD_LSB_FIRST			(1 << 1)
+
+/** Length of the ADI_CAPTURE_CONFIG_CMD control endpoint data, in bytes */
+#define ADI_CAPTURE_CONFIG_LENGTH				(16)
+
+/** Max size of the capture ring buffer, in bytes. The DMA buffer allocator takes a 16 bit size */
+#define ADI_CAPTURE_MAX_BYTES					(0xFFF0)
+
+/** Length of the ADI_CAPTURE_STATUS_CMD response, in bytes */
+#define ADI_CAPTURE_STATUS_LENGTH				(28)
+
+/** Capture state: no capture configured for the running or last stream */
+#define ADI_CAPTURE_STATE_OFF					(0)
+
+/** Capture state: storing samples, waiting for the trigger */
+#define ADI_CAPTURE_STATE_ARMED					(1)
+
+/** Capture state: triggered, storing the post trigger samples */
+#define ADI_CAPTURE_STATE_TRIGGERED				(2)
+
+/** Capture state: all samples stored, and sent to the PC on the streaming endpoint */
+#define ADI_CAPTURE_STATE_DONE					(3)
+
+/*
+ * Logic analyzer stream definitions
+ */
+
+/** Length of the logic analyzer stream start control endpoint data, in bytes */
+#define ADI_LOGIC_START_LENGTH					(12)
+
+/** Shortest logic analyzer sample period, in 10MHz timer ticks */
+#define ADI_LOGIC_MIN_PERIOD_TICKS				(10)
+
+/** Size of each logic analyzer run record (pin state[0-1], run length[2-3]), in bytes */
+#define ADI_LOGIC_RECORD_BYTES					(4)
+
+/** Longest run held in one logic analyzer record, in samples. Longer runs are split across records */
+#define ADI_LOGIC_MAX_RUN						(0xFFFF)
+
+/** Max time a partially filled logic analyzer USB buffer is held before it is sent, in ms */
+#define ADI_LOGIC_FLUSH_MS						(100)
+
+/** Number of logic analyzer samples between checks of the USB buffer flush time (power of 2) */
+#define ADI_LOGIC_FLUSH_CHECK_SAMPLES			(1024)
+
+/*
+ * Stream frame header definitions
+ */
+
+/** Stream frame mode setting: no frame headers (default) */
+#define ADI_STREAM_FRAME_OFF					(0)
+
+/** Stream frame mode setting: frame header at the start of each USB buffer */
+#define ADI_STREAM_FRAME_ON						(1)
+
+/** Stream frame mode setting: frame header with a CRC32 of the frame payload */
+#define ADI_STREAM_FRAME_CRC					(2)
+
+/** Size of the frame header placed at the start of each USB buffer, in bytes */
+#define ADI_STREAM_FRAME_HEADER_BYTES			(16)
+
+/** Sync word at the start of each frame header */
+#define ADI_STREAM_FRAME_SYNC					(0xA55A)
+
+/** Frame header stream type for a generic register stream */
+#define ADI_STREAM_FRAME_TYPE_GENERIC			(1)
+
+/** Frame header stream type for a real time (ADcmXL) stream */
+#define ADI_STREAM_FRAME_TYPE_REAL_TIME			(2)
+
+/** Frame header stream type for a burst stream */
+#define ADI_STREAM_FRAME_TYPE_BURST				(3)
+
+/** Frame header stream type for a transfer (ISpi32) stream */
+#define ADI_STREAM_FRAME_TYPE_TRANSFER			(4)
+
+/** Frame header stream type for an I2C read stream */
+#define ADI_STREAM_FRAME_TYPE_I2C				(5)
+
+/** Frame header stream type for a logic analyzer stream */
+#define ADI_STREAM_FRAME_TYPE_LOGIC				(6)
+
+/** Frame flag: the stream waited for the PC to free a USB buffer while filling this frame */
+#define ADI_STREAM_FRAME_FLAG_OVERFLOW			(1 << 0)
+
+/** Frame flag: a data ready edge arrived while the previous sample was still being processed */
+#define ADI_STREAM_FRAME_FLAG_DR_MISSED			(1 << 1)
+
+/** Frame flag: an SPI, I2C or DMA transfer in this frame reported an error */
+#define ADI_STREAM_FRAME_FLAG_XFER_ERROR		(1 << 2)
+
+/** Frame flag: the CRC field holds a CRC32 of the frame payload */
+#define ADI_STREAM_FRAME_FLAG_CRC				(1 << 3)
+
+/** Frame flag: last frame of the stream */
+#define ADI_STREAM_FRAME_FLAG_LAST				(1 << 4)
+
+/** Frame flag: samples were dropped by the stream overflow policy before this frame */
+#define ADI_STREAM_FRAME_FLAG_GAP				(1 << 5)
+
 #endif
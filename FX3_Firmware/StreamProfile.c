@@ -0,0 +1,133 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  * 
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  * 
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  * 
+  * @file		StreamProfile.c
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		This file contains the stream worker profiling functions.
+ **/
+
+#include "StreamProfile.h"
+
+/* Tell the compiler where to find the needed globals */
+extern uint8_t USBBuffer[4096];
+
+/** Profile counters for the most recent stream */
+static StreamProfile ProfileState;
+
+/**
+  * @brief Clears the profile counters at the start of a stream.
+  *
+  * @param streamType The stream enable event flag of the stream being started
+  *
+  * @return void
+  *
+  * This function must be called after the stall timer is configured, since that resets the timer
+  * for generic and transfer streams.
+ **/
+void AdiStreamProfileStart(uint32_t streamType)
+{
+	CyU3PMemSet((uint8_t *)&ProfileState, 0, sizeof(ProfileState));
+	ProfileState.StreamType = streamType;
+	ProfileState.CurrentPhase = ProfilePhaseOther;
+	ProfileState.PhaseStartTime = AdiReadStreamTimer();
+}
+
+/**
+  * @brief Marks the start of a new phase in a stream worker.
+  *
+  * @param phase The phase the stream worker is entering
+  *
+  * @return void
+  *
+  * The time since the last mark is added to the phase which is being left. Each mark costs one timer
+  * sample (well under a microsecond), so stream workers call it through ADI_PROFILE_MARK, which compiles
+  * to nothing outside STREAM_PROFILE_MODE builds.
+ **/
+void AdiStreamProfileMark(StreamProfilePhase phase)
+{
+	uint32_t currentTime, sampleTicks;
+
+	currentTime = AdiReadStreamTimer();
+
+	/* Charge the elapsed time to the phase being left */
+	ProfileState.PhaseTicks[ProfileState.CurrentPhase] += (currentTime - ProfileState.PhaseStartTime);
+
+	/* A data ready period runs from the end of one data ready wait to the start of the next */
+	if(ProfileState.CurrentPhase == ProfilePhaseDrWait)
+	{
+		ProfileState.SampleStartTime = currentTime;
+	}
+	else if((phase == ProfilePhaseDrWait) && ProfileState.PhaseCount[ProfilePhaseDrWait])
+	{
+		sampleTicks = currentTime - ProfileState.SampleStartTime;
+		if(sampleTicks > ProfileState.MaxSampleTicks)
+		{
+			ProfileState.MaxSampleTicks = sampleTicks;
+		}
+	}
+
+	ProfileState.PhaseCount[phase]++;
+	ProfileState.CurrentPhase = phase;
+	ProfileState.PhaseStartTime = currentTime;
+}
+
+/**
+  * @brief Sends the stream profile counters to the PC over the control endpoint.
+  *
+  * @return void
+  *
+  * All values are little endian. USBBuffer[0-3] holds the status, [4-7] the profiled stream enable
+  * flag, [8-11] the timer ticks per second and [12-15] the longest data ready period. Each phase then
+  * has a 12 byte entry starting at 16 + (12 * phase), holding the entry count (4 bytes) followed by the
+  * total timer ticks (8 bytes). Read the profile once the stream is finished, since the counters are not
+  * updated atomically. Builds without STREAM_PROFILE_MODE return CY_U3P_ERROR_NOT_SUPPORTED.
+ **/
+void AdiGetStreamProfile()
+{
+#ifdef STREAM_PROFILE_MODE
+	uint32_t phase, offset;
+
+	USBBuffer[4] = ProfileState.StreamType & 0xFF;
+	USBBuffer[5] = (ProfileState.StreamType & 0xFF00) >> 8;
+	USBBuffer[6] = (ProfileState.StreamType & 0xFF0000) >> 16;
+	USBBuffer[7] = (ProfileState.StreamType & 0xFF000000) >> 24;
+	USBBuffer[8] = S_TO_TICKS_MULT & 0xFF;
+	USBBuffer[9] = (S_TO_TICKS_MULT & 0xFF00) >> 8;
+	USBBuffer[10] = (S_TO_TICKS_MULT & 0xFF0000) >> 16;
+	USBBuffer[11] = (S_TO_TICKS_MULT & 0xFF000000) >> 24;
+	USBBuffer[12] = ProfileState.MaxSampleTicks & 0xFF;
+	USBBuffer[13] = (ProfileState.MaxSampleTicks & 0xFF00) >> 8;
+	USBBuffer[14] = (ProfileState.MaxSampleTicks & 0xFF0000) >> 16;
+	USBBuffer[15] = (ProfileState.MaxSampleTicks & 0xFF000000) >> 24;
+
+	for(phase = 0; phase < STREAM_PROFILE_NUM_PHASES; phase++)
+	{
+		offset = 16 + (12 * phase);
+		USBBuffer[offset] = ProfileState.PhaseCount[phase] & 0xFF;
+		USBBuffer[offset + 1] = (ProfileState.PhaseCount[phase] & 0xFF00) >> 8;
+		USBBuffer[offset + 2] = (ProfileState.PhaseCount[phase] & 0xFF0000) >> 16;
+		USBBuffer[offset + 3] = (ProfileState.PhaseCount[phase] & 0xFF000000) >> 24;
+		USBBuffer[offset + 4] = ProfileState.PhaseTicks[phase] & 0xFF;
+		USBBuffer[offset + 5] = (ProfileState.PhaseTicks[phase] >> 8) & 0xFF;
+		USBBuffer[offset + 6] = (ProfileState.PhaseTicks[phase] >> 16) & 0xFF;
+		USBBuffer[offset + 7] = (ProfileState.PhaseTicks[phase] >> 24) & 0xFF;
+		USBBuffer[offset + 8] = (ProfileState.PhaseTicks[phase] >> 32) & 0xFF;
+		USBBuffer[offset + 9] = (ProfileState.PhaseTicks[phase] >> 40) & 0xFF;
+		USBBuffer[offset + 10] = (ProfileState.PhaseTicks[phase] >> 48) & 0xFF;
+		USBBuffer[offset + 11] = (ProfileState.PhaseTicks[phase] >> 56) & 0xFF;
+	}
+
+	AdiSendStatus(CY_U3P_SUCCESS, STREAM_PROFILE_LENGTH, CyTrue);
+#else
+	AdiSendStatus(CY_U3P_ERROR_NOT_SUPPORTED, 4, CyTrue);
+#endif
+}
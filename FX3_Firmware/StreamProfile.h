@@ -0,0 +1,90 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  * 
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  * 
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  * 
+  * @file		StreamProfile.h
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		Header file for the stream worker profiling functions.
+ **/
+
+#ifndef STREAM_PROFILE_H
+#define STREAM_PROFILE_H
+
+/* Include the main header file */
+#include "main.h"
+
+/** Enum for the phases of a stream worker which are timed by the stream profiler */
+typedef enum StreamProfilePhase
+{
+	/** Time not spent in any other phase (loop overhead, buffer pointer updates) */
+	ProfilePhaseOther = 0,
+
+	/** Waiting for a data ready edge. Entered once per data ready period */
+	ProfilePhaseDrWait = 1,
+
+	/** Transferring data with the DUT. Entered once per SPI word, or once per SPI/I2C DMA transaction */
+	ProfilePhaseTransfer = 2,
+
+	/** Waiting for the stall timer between SPI words */
+	ProfilePhaseStall = 3,
+
+	/** Committing a DMA buffer to the USB side and getting the next buffer */
+	ProfilePhaseDma = 4
+
+}StreamProfilePhase;
+
+/** Number of phases in the StreamProfilePhase enum */
+#define STREAM_PROFILE_NUM_PHASES				(5)
+
+/** Number of bytes returned by the ADI_GET_STREAM_PROFILE vendor command */
+#define STREAM_PROFILE_LENGTH					(16 + (12 * STREAM_PROFILE_NUM_PHASES))
+
+/** @brief Struct to store the stream profile counters */
+typedef struct StreamProfile
+{
+	/** The stream enable event flag of the stream being profiled (0 if no stream has been run) */
+	uint32_t StreamType;
+
+	/** The phase the stream worker is currently in */
+	StreamProfilePhase CurrentPhase;
+
+	/** Timer value when the current phase was entered */
+	uint32_t PhaseStartTime;
+
+	/** Timer value when the current data ready period started */
+	uint32_t SampleStartTime;
+
+	/** Longest time between data ready periods, excluding the data ready wait, in 10MHz timer ticks */
+	uint32_t MaxSampleTicks;
+
+	/** Number of times each phase was entered */
+	uint32_t PhaseCount[STREAM_PROFILE_NUM_PHASES];
+
+	/** Total time spent in each phase, in 10MHz timer ticks */
+	uint64_t PhaseTicks[STREAM_PROFILE_NUM_PHASES];
+
+}StreamProfile;
+
+/* Public function prototypes */
+void AdiStreamProfileStart(uint32_t streamType);
+void AdiStreamProfileMark(StreamProfilePhase phase);
+void AdiGetStreamProfile();
+
+/** Stream profiler hooks for the stream workers. Compile to nothing in builds without STREAM_PROFILE_MODE */
+#ifdef STREAM_PROFILE_MODE
+#define ADI_PROFILE_START(streamType)			AdiStreamProfileStart(streamType)
+#define ADI_PROFILE_MARK(phase)					AdiStreamProfileMark(phase)
+#else
+#define ADI_PROFILE_START(streamType)			((void) 0)
+#define ADI_PROFILE_MARK(phase)					((void) 0)
+#endif
+
+#endif
@@ -24,12 +24,40 @@ static CyU3PReturnStatus_t AdiRealTimeStreamWork();
 static CyU3PReturnStatus_t AdiBurstStreamWork();
 static CyU3PReturnStatus_t AdiTransferStreamWork();
 static CyU3PReturnStatus_t AdiI2CStreamWork();
+static CyU3PReturnStatus_t AdiLogicStreamWork();
+
+/* Private generic stream functions */
+static CyBool_t AdiGenericStreamPageSkip(const uint8_t *entry, CyBool_t noReadPending);
+
+/* Private burst stream functions */
+static void AdiBurstArm();
+static void AdiBurstStart();
+
+/* Private stream buffer helper functions */
+static void AdiStreamGetUsbBuffer(uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer);
+static void AdiStreamCommitUsbBuffer(uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer);
+static void AdiStreamCommitLastUsbBuffer(uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer);
+static void AdiStreamCopyToUsb(uint8_t *src, uint32_t numBytes, uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer);
+static void AdiWriteStreamTimestamp(uint64_t timestamp, uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer);
+static CyU3PReturnStatus_t AdiStreamOverflow(CyU3PDmaBuffer_t *channelBuffer);
+static void AdiStreamDropPendingBuffers();
+
+/* Private pre-trigger capture functions */
+static void AdiCaptureStoreSample();
+static CyBool_t AdiCaptureTriggerCheck(uint8_t *sample);
+static void AdiCaptureEnd(uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer);
+
+/* Private logic analyzer functions */
+static void AdiLogicWriteRun(uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer);
+static void AdiLogicFlush(uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer);
 
 /* Tell the compiler where to find the needed globals */
 extern CyU3PEvent EventHandler;
 extern CyU3PDmaChannel StreamingChannel;
 extern CyU3PDmaChannel MemoryToSPI;
+extern CyU3PDmaChannel StreamRxChannel;
 extern CyU3PDmaBuffer_t SpiDmaBuffer;
+extern CyU3PDmaBuffer_t StreamRxDmaBuffer;
 extern BoardState FX3State;
 extern volatile CyBool_t KillStreamEarly;
 extern StreamState StreamThreadState;
@@ -47,7 +75,7 @@ extern uint8_t USBBuffer[4096];
 void AdiStreamThreadEntry(uint32_t input)
 {
 	/* Set the event mask to the stream enable events */
-	uint32_t eventMask = ADI_GENERIC_STREAM_ENABLE|ADI_RT_STREAM_ENABLE|ADI_BURST_STREAM_ENABLE|ADI_TRANSFER_STREAM_ENABLE|ADI_I2C_STREAM_ENABLE;
+	uint32_t eventMask = ADI_GENERIC_STREAM_ENABLE|ADI_RT_STREAM_ENABLE|ADI_BURST_STREAM_ENABLE|ADI_TRANSFER_STREAM_ENABLE|ADI_I2C_STREAM_ENABLE|ADI_LOGIC_STREAM_ENABLE;
 
 	/* Variable to receive the event arguments into */
 	uint32_t eventFlag;
@@ -62,7 +90,7 @@ void AdiStreamThreadEntry(uint32_t input)
 			{
 				AdiRealTimeStreamWork();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Finished real time stream work\r\n");
+				ADI_LOG("Finished real time stream work\r\n");
 #endif
 			}
 			/* Transfer stream case */
@@ -70,7 +98,7 @@ void AdiStreamThreadEntry(uint32_t input)
 			{
 				AdiTransferStreamWork();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Finished transfer stream work\r\n");
+				ADI_LOG("Finished transfer stream work\r\n");
 #endif
 			}
 			/* Generic register stream case */
@@ -78,7 +106,7 @@ void AdiStreamThreadEntry(uint32_t input)
 			{
 				AdiGenericStreamWork();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Finished generic stream work\r\n");
+				ADI_LOG("Finished generic stream work\r\n");
 #endif
 			}
 			/* Burst stream case */
@@ -86,7 +114,7 @@ void AdiStreamThreadEntry(uint32_t input)
 			{
 				AdiBurstStreamWork();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Finished burst stream work\r\n");
+				ADI_LOG("Finished burst stream work\r\n");
 #endif
 			}
 			/* I2C stream case */
@@ -94,15 +122,20 @@ void AdiStreamThreadEntry(uint32_t input)
 			{
 				AdiI2CStreamWork();
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Finished I2C stream work\r\n");
+				ADI_LOG("Finished I2C stream work\r\n");
 #endif
 			}
+			/* Logic analyzer stream case */
+			else if (eventFlag & ADI_LOGIC_STREAM_ENABLE)
+			{
+				AdiLogicStreamWork();
+			}
 			else
 			{
 				/* Shouldnt be able to get here */
 				AdiLogError(StreamThread_c, __LINE__, eventFlag);
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "ERROR: Unhandled StreamThread event generated. eventFlag: 0x%x\r\n", eventFlag);
+				ADI_LOG("ERROR: Unhandled StreamThread event generated. eventFlag: 0x%x\r\n", eventFlag);
 #endif
 			}
 		}
@@ -122,12 +155,45 @@ void AdiStreamThreadEntry(uint32_t input)
 static CyU3PReturnStatus_t AdiI2CStreamWork()
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	uint64_t timestamp = 0;
 
 	/* Track the number of buffers read */
 	static uint32_t numBuffersRead = 0;
 
+	/* Track the current position within the streaming DMA buffer (time stamped or framed streams only) */
+	static uint8_t *bufPtr;
+
+	/* Track the number of bytes read into the current DMA buffer (time stamped or framed streams only) */
+	static uint32_t byteCounter;
+
+	/* DMA buffer structure for the active buffer for the streaming DMA channel (time stamped or framed streams only) */
+	static CyU3PDmaBuffer_t StreamChannelBuffer;
+
+	/* Time stamped or framed streams read to CPU memory first */
+	if(StreamThreadState.RxCopyMode)
+	{
+		status = CyU3PDmaChannelSetupRecvBuffer(&StreamRxChannel, &StreamRxDmaBuffer);
+		if(status != CY_U3P_SUCCESS)
+		{
+			AdiLogError(StreamThread_c, __LINE__, status);
+		}
+	}
+
+	ADI_PROFILE_MARK(ProfilePhaseDrWait);
+
+	/* Flag any data ready edge missed while the last sample was processed */
+	AdiStreamSampleStart();
+
 	/* Wait for DR if enabled */
-	if (FX3State.DrActive)
+	if (StreamThreadState.DrInterruptWait)
+	{
+		/* Block until the GPIO ISR signals a data ready edge */
+		if(AdiWaitForStreamDataReady() == CY_U3P_SUCCESS)
+		{
+			AdiRecordDataReadyLatency();
+		}
+	}
+	else if (FX3State.DrActive)
 	{
 		/* Clear GPIO interrupts */
 		GPIO->lpp_gpio_simple[FX3State.DrPin] |= CY_U3P_LPP_GPIO_INTR;
@@ -135,11 +201,44 @@ static CyU3PReturnStatus_t AdiI2CStreamWork()
 		while(!(GPIO->lpp_gpio_intr0 & (1 << FX3State.DrPin)));
 	}
 
+	/* Count the new sample */
+	AdiStreamSampleReady();
+
+	ADI_PROFILE_MARK(ProfilePhaseTransfer);
+
+	/* Time stamp the data ready edge */
+	if(StreamThreadState.TimestampsEnabled)
+	{
+		timestamp = AdiGetStreamTimestamp();
+	}
+
 	/* Start new I2C DMA transfer */
 	CyU3PI2cSendCommand(&StreamThreadState.I2CStreamPreamble, StreamThreadState.NumCaptures, CyTrue);
 
 	/* Wait for completion */
-	CyU3PI2cWaitForBlockXfer(CyTrue);
+	status = CyU3PI2cWaitForBlockXfer(CyTrue);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiStreamTransferError();
+	}
+
+	/* Copy the time stamp and read data to the streaming DMA buffer */
+	if(StreamThreadState.RxCopyMode)
+	{
+		status = CyU3PDmaChannelWaitForCompletion(&StreamRxChannel, CYU3P_WAIT_FOREVER);
+		if(status != CY_U3P_SUCCESS)
+		{
+			AdiLogError(StreamThread_c, __LINE__, status);
+			AdiStreamTransferError();
+		}
+		if(StreamThreadState.TimestampsEnabled)
+		{
+			AdiWriteStreamTimestamp(timestamp, &bufPtr, &byteCounter, &StreamChannelBuffer);
+		}
+		AdiStreamCopyToUsb(StreamRxDmaBuffer.buffer, StreamThreadState.NumCaptures, &bufPtr, &byteCounter, &StreamChannelBuffer);
+	}
+
+	ADI_PROFILE_MARK(ProfilePhaseOther);
 
 	/* Check to see if we've captured enough buffers or if we were asked to stop data capture early */
 	if ((numBuffersRead >= (StreamThreadState.NumBuffers - 1)) || KillStreamEarly)
@@ -147,8 +246,16 @@ static CyU3PReturnStatus_t AdiI2CStreamWork()
 		/* Reset values */
 		numBuffersRead = 0;
 
-		/* Set channel wrap up */
-		CyU3PDmaChannelSetWrapUp(&StreamingChannel);
+		if(StreamThreadState.RxCopyMode)
+		{
+			/* Commit the partial USB buffer */
+			AdiStreamCommitLastUsbBuffer(&bufPtr, &byteCounter, &StreamChannelBuffer);
+		}
+		else
+		{
+			/* Set channel wrap up */
+			CyU3PDmaChannelSetWrapUp(&StreamingChannel);
+		}
 
 		/* Set stream done flag if kill early event was processed (otherwise must be explicitly invoked by FX3 API) */
 		if(KillStreamEarly)
@@ -179,7 +286,8 @@ static CyU3PReturnStatus_t AdiI2CStreamWork()
 static CyU3PReturnStatus_t AdiGenericStreamWork()
 {
 	uint16_t regIndex, captureCount;
-	CyU3PReturnStatus_t status;
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	CyBool_t pageSkipped;
 
 	/* Track the current position within the MISO (streaming DMA) buffer*/
 	static uint8_t *MISOPtr;
@@ -199,16 +307,25 @@ static CyU3PReturnStatus_t AdiGenericStreamWork()
 	/* If the stream channel buffer has not been set, get a new buffer */
 	if (MISOPtr == 0)
 	{
-		status = CyU3PDmaChannelGetBuffer(&StreamingChannel, &StreamChannelBuffer, CYU3P_WAIT_FOREVER);
-		if (status != CY_U3P_SUCCESS)
-		{
-			AdiLogError(StreamThread_c, __LINE__, status);
-		}
-		MISOPtr = StreamChannelBuffer.buffer;
+		ADI_PROFILE_MARK(ProfilePhaseDma);
+		AdiStreamGetUsbBuffer(&MISOPtr, &byteCounter, &StreamChannelBuffer);
 	}
 
+	ADI_PROFILE_MARK(ProfilePhaseDrWait);
+
+	/* Flag any data ready edge missed while the last sample was processed */
+	AdiStreamSampleStart();
+
 	/* Wait for DR if enabled */
-	if (FX3State.DrActive)
+	if (StreamThreadState.DrInterruptWait)
+	{
+		/* Block until the GPIO ISR signals a data ready edge */
+		if(AdiWaitForStreamDataReady() == CY_U3P_SUCCESS)
+		{
+			AdiRecordDataReadyLatency();
+		}
+	}
+	else if (FX3State.DrActive)
 	{
 		/* Clear GPIO interrupts */
 		GPIO->lpp_gpio_simple[FX3State.DrPin] |= CY_U3P_LPP_GPIO_INTR;
@@ -216,36 +333,69 @@ static CyU3PReturnStatus_t AdiGenericStreamWork()
 		while(!(GPIO->lpp_gpio_intr0 & (1 << FX3State.DrPin)));
 	}
 
+	/* Count the new sample */
+	AdiStreamSampleReady();
+
+	/* Place the data ready time stamp at the start of the buffer */
+	if(StreamThreadState.TimestampsEnabled)
+	{
+		AdiWriteStreamTimestamp(AdiGetStreamTimestamp(), &MISOPtr, &byteCounter, &StreamChannelBuffer);
+	}
+
 	/* Run through the register list numCaptures times - this is one buffer */
 	for(captureCount = 0; captureCount < StreamThreadState.NumCaptures; captureCount++)
 	{
 		/* Set the MOSI pointer to the bottom of the register list */
 		MOSIPtr = StreamThreadState.RegList;
 
-		/* Transmit the first words without reading back */
-		CyU3PSpiTransmitWords(MOSIPtr, 2);
+		ADI_PROFILE_MARK(ProfilePhaseTransfer);
+		/* Transmit the first words without reading back, unless they only select the cached page */
+		pageSkipped = AdiGenericStreamPageSkip(MOSIPtr, CyTrue);
+		if(!pageSkipped)
+		{
+			CyU3PSpiTransmitWords(MOSIPtr, 2);
+
+			/* Start the stall time */
+			AdiRestartStreamStallTimer();
+		}
 
 		/* Increment the MOSI pointer*/
 		MOSIPtr += 2;
-
-		/* Set the timer value to 0 */
-		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].timer = 0;
-		/* clear interrupt flag */
-		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status |= CY_U3P_LPP_GPIO_INTR;
+		ADI_PROFILE_MARK(ProfilePhaseOther);
 
 		/* Iterate through the rest of the register list */
 		for(regIndex = 0; regIndex < (StreamThreadState.TransferByteLength - 8); regIndex += 2)
 		{
-			/* Wait for the complex GPIO timer to reach the stall time */
-			while(!(GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status & CY_U3P_LPP_GPIO_INTR));
+			/* A page select after a write has no read data to clock out, so it can be skipped. The
+			 * write's output word is zero, as is the word of the skipped page select */
+			if(AdiGenericStreamPageSkip(MOSIPtr, (CyBool_t) ((MOSIPtr[-1] & 0x80) != 0)))
+			{
+				MISOPtr[0] = 0;
+				MISOPtr[1] = 0;
+				pageSkipped = CyTrue;
+			}
+			else
+			{
+				ADI_PROFILE_MARK(ProfilePhaseStall);
+				/* Wait for the complex GPIO timer to reach the stall time */
+				while(!(GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status & CY_U3P_LPP_GPIO_INTR));
+				ADI_PROFILE_MARK(ProfilePhaseTransfer);
+
+				/* transfer words */
+				AdiSpiTransferWord(MOSIPtr, MISOPtr, 2);
 
-			/* transfer words */
-			AdiSpiTransferWord(MOSIPtr, MISOPtr, 2);
+				/* Start the stall time */
+				AdiRestartStreamStallTimer();
+				ADI_PROFILE_MARK(ProfilePhaseOther);
 
-			/* Set the pin timer to 0 */
-			GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].timer = 0;
-			/* clear interrupt flag */
-			GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status |= CY_U3P_LPP_GPIO_INTR;
+				/* Nothing was sent for a skipped page select, so the DUT output here is stale */
+				if(pageSkipped)
+				{
+					MISOPtr[0] = 0;
+					MISOPtr[1] = 0;
+					pageSkipped = CyFalse;
+				}
+			}
 
 			/* Check if a readback is needed for the last transfer */
 			if(regIndex == (StreamThreadState.TransferByteLength - 12))
@@ -268,50 +418,30 @@ static CyU3PReturnStatus_t AdiGenericStreamWork()
 			/* Check if a transmission is needed */
 			if (byteCounter >= (StreamThreadState.BytesPerUsbPacket - 1))
 			{
-				status = CyU3PDmaChannelCommitBuffer (&StreamingChannel, FX3State.UsbBufferSize, 0);
-				if (status != CY_U3P_SUCCESS)
-				{
-					AdiLogError(StreamThread_c, __LINE__, status);
-				}
-
-				status = CyU3PDmaChannelGetBuffer (&StreamingChannel, &StreamChannelBuffer, CYU3P_WAIT_FOREVER);
-				if (status != CY_U3P_SUCCESS)
-				{
-					AdiLogError(StreamThread_c, __LINE__, status);
-				}
-				MISOPtr = StreamChannelBuffer.buffer;
-				byteCounter = 0;
+				ADI_PROFILE_MARK(ProfilePhaseDma);
+				AdiStreamCommitUsbBuffer(&byteCounter, &StreamChannelBuffer);
+				AdiStreamGetUsbBuffer(&MISOPtr, &byteCounter, &StreamChannelBuffer);
+				ADI_PROFILE_MARK(ProfilePhaseOther);
 			}
 		}
 
+		ADI_PROFILE_MARK(ProfilePhaseStall);
 		/* Wait for the complex GPIO timer to reach the stall time */
 		while(!(GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status & CY_U3P_LPP_GPIO_INTR));
 
-		/* Set the pin timer to 0 */
-		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].timer = 0;
-		/* Clear interrupt flag */
-		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status |= CY_U3P_LPP_GPIO_INTR;
+		/* Start the stall time */
+		AdiRestartStreamStallTimer();
+		ADI_PROFILE_MARK(ProfilePhaseOther);
 	}
 
-	/* Check to see if we've captured enough buffers or if we were asked to stop data capture early */
-	if ((numBuffersRead >= (StreamThreadState.NumBuffers - 1)) || KillStreamEarly)
+	/* Check to see if we've captured enough buffers (or finished a capture) or if we were asked to stop data capture early */
+	if ((numBuffersRead >= (StreamThreadState.NumBuffers - 1)) || StreamThreadState.CaptureDone || KillStreamEarly)
 	{
 		/* Reset values */
 		numBuffersRead = 0;
-		/* Signal getting a new buffer */
-		MISOPtr = 0;
-		if (byteCounter)
-		{
-#ifdef VERBOSE_MODE
-			CyU3PDebugPrint (4, "Commiting last USB buffer with %d bytes.\r\n", byteCounter);
-#endif
-			status = CyU3PDmaChannelCommitBuffer (&StreamingChannel, FX3State.UsbBufferSize, 0);
-			if (status != CY_U3P_SUCCESS)
-			{
-				AdiLogError(StreamThread_c, __LINE__, status);
-			}
-			byteCounter = 0;
-		}
+		/* Send any captured samples, then commit the partial USB buffer and signal getting a new buffer */
+		AdiCaptureEnd(&MISOPtr, &byteCounter, &StreamChannelBuffer);
+		AdiStreamCommitLastUsbBuffer(&MISOPtr, &byteCounter, &StreamChannelBuffer);
 
 		/* Clear GPIO interrupts */
 		GPIO->lpp_gpio_simple[FX3State.DrPin] |= CY_U3P_LPP_GPIO_INTR;
@@ -327,7 +457,7 @@ static CyU3PReturnStatus_t AdiGenericStreamWork()
 		GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status &= ~(CY_U3P_LPP_GPIO_INTRMODE_MASK);
 
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "Exiting stream thread, %d generic stream buffers read.\r\n", numBuffersRead + 1);
+		ADI_LOG("Exiting stream thread, %d generic stream buffers read.\r\n", numBuffersRead + 1);
 #endif
 
 		/* Set stream done flag if kill early event was processed (otherwise must be explicitly invoked by FX3 API) */
@@ -343,6 +473,7 @@ static CyU3PReturnStatus_t AdiGenericStreamWork()
 		/* Wait for the complex GPIO timer to reach the stall time if no data ready */
 		if(!FX3State.DrActive)
 		{
+			ADI_PROFILE_MARK(ProfilePhaseStall);
 			while(!(GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status & CY_U3P_LPP_GPIO_INTR));
 		}
 		/* Reset flag */
@@ -368,15 +499,55 @@ static CyU3PReturnStatus_t AdiRealTimeStreamWork()
 	/* Static variables persist through function calls, are initialized to 0 */
 	static uint32_t numFramesCaptured;
 
-	/* Clear GPIO interrupts */
-	GPIO->lpp_gpio_simple[FX3State.DrPin] |= CY_U3P_LPP_GPIO_INTR;
-	/* Wait for GPIO interrupt flag to be set and pin to be positive (interrupt configured for positive edge) */
-	interruptTriggered = CyFalse;
-	while(!interruptTriggered)
+	/* Track the current position within the streaming DMA buffer (framed streams only) */
+	static uint8_t *bufPtr;
+
+	/* Track the number of bytes read into the current DMA buffer (framed streams only) */
+	static uint32_t byteCounter;
+
+	/* DMA buffer structure for the active buffer for the streaming DMA channel (framed streams only) */
+	static CyU3PDmaBuffer_t StreamChannelBuffer;
+
+	/* Framed streams read to CPU memory first */
+	if(StreamThreadState.RxCopyMode)
+	{
+		status = CyU3PDmaChannelSetupRecvBuffer(&StreamRxChannel, &StreamRxDmaBuffer);
+		if(status != CY_U3P_SUCCESS)
+		{
+			AdiLogError(StreamThread_c, __LINE__, status);
+		}
+	}
+
+	ADI_PROFILE_MARK(ProfilePhaseDrWait);
+
+	/* Flag any BUSY edge missed while the last frame was processed */
+	AdiStreamSampleStart();
+
+	if (StreamThreadState.DrInterruptWait)
+	{
+		/* Block until the GPIO ISR signals a BUSY edge (interrupt configured for positive edge) */
+		if(AdiWaitForStreamDataReady() == CY_U3P_SUCCESS)
+		{
+			AdiRecordDataReadyLatency();
+		}
+	}
+	else
 	{
-		interruptTriggered = ((CyBool_t)(GPIO->lpp_gpio_intr0 & (1 << FX3State.DrPin)) && (CyBool_t)(GPIO->lpp_gpio_simple[FX3State.DrPin] & CY_U3P_LPP_GPIO_IN_VALUE));
+		/* Clear GPIO interrupts */
+		GPIO->lpp_gpio_simple[FX3State.DrPin] |= CY_U3P_LPP_GPIO_INTR;
+		/* Wait for GPIO interrupt flag to be set and pin to be positive (interrupt configured for positive edge) */
+		interruptTriggered = CyFalse;
+		while(!interruptTriggered)
+		{
+			interruptTriggered = ((CyBool_t)(GPIO->lpp_gpio_intr0 & (1 << FX3State.DrPin)) && (CyBool_t)(GPIO->lpp_gpio_simple[FX3State.DrPin] & CY_U3P_LPP_GPIO_IN_VALUE));
+		}
 	}
 
+	/* Count the new sample */
+	AdiStreamSampleReady();
+
+	ADI_PROFILE_MARK(ProfilePhaseTransfer);
+
 	/* Set the config for DMA mode */
 	SPI->lpp_spi_config |= CY_U3P_LPP_SPI_DMA_MODE;
 
@@ -395,8 +566,23 @@ static CyU3PReturnStatus_t AdiRealTimeStreamWork()
 	if (status != CY_U3P_SUCCESS)
 	{
 		AdiLogError(StreamThread_c, __LINE__, status);
+		AdiStreamTransferError();
+	}
+
+	/* Copy the real time frame to the streaming DMA buffer */
+	if(StreamThreadState.RxCopyMode)
+	{
+		status = CyU3PDmaChannelWaitForCompletion(&StreamRxChannel, CYU3P_WAIT_FOREVER);
+		if(status != CY_U3P_SUCCESS)
+		{
+			AdiLogError(StreamThread_c, __LINE__, status);
+			AdiStreamTransferError();
+		}
+		AdiStreamCopyToUsb(StreamRxDmaBuffer.buffer, StreamThreadState.BytesPerFrame, &bufPtr, &byteCounter, &StreamChannelBuffer);
 	}
 
+	ADI_PROFILE_MARK(ProfilePhaseOther);
+
 	/* Check that we haven't captured the desired number of frames or were asked to kill the thread early */
 	if((numFramesCaptured >= (StreamThreadState.NumRealTimeCaptures - 1)) || KillStreamEarly)
 	{
@@ -410,10 +596,17 @@ static CyU3PReturnStatus_t AdiRealTimeStreamWork()
 		GPIO->lpp_gpio_simple[FX3State.DrPin] |= CY_U3P_LPP_GPIO_INTR;
 
 		/* Send whatever is in the buffer over to the PC */
-		status = CyU3PDmaChannelSetWrapUp(&StreamingChannel);
-		if(status != CY_U3P_SUCCESS)
+		if(StreamThreadState.RxCopyMode)
 		{
-			AdiLogError(StreamThread_c, __LINE__, status);
+			AdiStreamCommitLastUsbBuffer(&bufPtr, &byteCounter, &StreamChannelBuffer);
+		}
+		else
+		{
+			status = CyU3PDmaChannelSetWrapUp(&StreamingChannel);
+			if(status != CY_U3P_SUCCESS)
+			{
+				AdiLogError(StreamThread_c, __LINE__, status);
+			}
 		}
 
 		/* Reset frame counter */
@@ -426,7 +619,7 @@ static CyU3PReturnStatus_t AdiRealTimeStreamWork()
 		}
 
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "Exiting stream thread, %d real time frames read.\r\n", numFramesCaptured + 1);
+		ADI_LOG("Exiting stream thread, %d real time frames read.\r\n", numFramesCaptured + 1);
 #endif
 	}
 	else
@@ -446,29 +639,67 @@ static CyU3PReturnStatus_t AdiRealTimeStreamWork()
   *
   * This function performs all the SPI and USB transfers for a single burst in IMU
   * burst mode. It can be configured to transfer an arbitrary number of bytes in a single
-  * SPI transaction, with optional data ready triggering.
+  * SPI transaction, with optional data ready triggering. The next burst is armed (AdiBurstArm)
+  * before the data ready wait, so the edge only has to enable the SPI block.
  **/
 static CyU3PReturnStatus_t AdiBurstStreamWork()
 {
 	CyU3PReturnStatus_t status;
 	CyBool_t interruptTriggered;
+	uint64_t timestamp = 0;
 
 	/* Static variables persist through function calls, are initialized to 0*/
 	static uint32_t numBuffersRead;
 
+	/* Track the current position within the streaming DMA buffer (time stamped or framed streams only) */
+	static uint8_t *bufPtr;
+
+	/* Track the number of bytes read into the current DMA buffer (time stamped or framed streams only) */
+	static uint32_t byteCounter;
+
+	/* DMA buffer structure for the active buffer for the streaming DMA channel (time stamped or framed streams only) */
+	static CyU3PDmaBuffer_t StreamChannelBuffer;
+
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "Burst stream thread entered.\r\n");
+		ADI_LOG("Burst stream thread entered.\r\n");
 #endif
 
-	/* Set up DMA to read registers from CPU memory */
-	status = CyU3PDmaChannelSetupSendBuffer(&MemoryToSPI, &SpiDmaBuffer);
-	if(status != CY_U3P_SUCCESS)
+	ADI_PROFILE_MARK(ProfilePhaseDma);
+
+	/* Time stamped or framed streams read to CPU memory first */
+	if(StreamThreadState.RxCopyMode)
 	{
-		AdiLogError(StreamThread_c, __LINE__, status);
+		status = CyU3PDmaChannelSetupRecvBuffer(&StreamRxChannel, &StreamRxDmaBuffer);
+		if(status != CY_U3P_SUCCESS)
+		{
+			AdiLogError(StreamThread_c, __LINE__, status);
+		}
 	}
 
+	/* Queue the Tx data and set up the SPI block, so the data ready edge only has to enable it */
+	AdiBurstArm();
+
+	ADI_PROFILE_MARK(ProfilePhaseDrWait);
+
+	/* Flag any data ready edge missed while the last sample was processed */
+	AdiStreamSampleStart();
+
 	/* Wait for DR if enabled */
-	if (FX3State.DrActive)
+	if (StreamThreadState.DrInterruptWait)
+	{
+		/* Start the first burst right away if data ready is already asserted, otherwise block until the GPIO ISR
+		 * signals an edge. The ISR starts the armed burst itself, so the data ready latency is not recorded */
+		if((numBuffersRead == 0) && (GPIO->lpp_gpio_simple[FX3State.DrPin] & CY_U3P_LPP_GPIO_IN_VALUE))
+		{
+			/* No ISR edge time for this sample, so time stamp it from here */
+			StreamThreadState.DrEdgeTime = AdiReadStreamTimer();
+		}
+		else
+		{
+			AdiWaitForStreamDataReady();
+		}
+	}
+	else if (FX3State.DrActive)
 	{
 		/* Clear GPIO interrupts */
 		GPIO->lpp_gpio_simple[FX3State.DrPin] |= CY_U3P_LPP_GPIO_INTR;
@@ -480,43 +711,71 @@ static CyU3PReturnStatus_t AdiBurstStreamWork()
 		}
 	}
 
-	/* Set the config for DMA mode with RX and TX enabled */
-	SPI->lpp_spi_config |= CY_U3P_LPP_SPI_DMA_MODE;
+	/* Start the burst, if the GPIO ISR has not already */
+	AdiBurstStart();
 
-	/* Set the Tx/Rx count */
-	SPI->lpp_spi_tx_byte_count = StreamThreadState.TransferByteLength;
-	SPI->lpp_spi_rx_byte_count = StreamThreadState.TransferByteLength;
+	/* Count the new sample */
+	AdiStreamSampleReady();
 
-	/* Enable SPI Rx and Tx */
-	SPI->lpp_spi_config |= (CY_U3P_LPP_SPI_RX_ENABLE | CY_U3P_LPP_SPI_TX_ENABLE);
+	/* Time stamp the data ready edge */
+	if(StreamThreadState.TimestampsEnabled)
+	{
+		timestamp = AdiGetStreamTimestamp();
+	}
 
-	/* Enable the SPI block */
-	SPI->lpp_spi_config |= CY_U3P_LPP_SPI_ENABLE;
+	ADI_PROFILE_MARK(ProfilePhaseTransfer);
 
 	/* Wait for SPI transfer to finish */
 	status = CyU3PSpiWaitForBlockXfer(CyTrue);
 	if(status != CY_U3P_SUCCESS)
 	{
 		AdiLogError(StreamThread_c, __LINE__, status);
+		AdiStreamTransferError();
 	}
 
-	/* Check that we haven't captured the desired number of frames or that we were asked to kill the thread early */
-	if((numBuffersRead >= (StreamThreadState.NumBuffers - 1)) || KillStreamEarly)
+	/* Copy the time stamp and burst data to the streaming DMA buffer */
+	if(StreamThreadState.RxCopyMode)
 	{
-		/* Disable the SPI DMA transfer */
-		status = CyU3PSpiDisableBlockXfer(CyTrue, CyTrue);
+		status = CyU3PDmaChannelWaitForCompletion(&StreamRxChannel, CYU3P_WAIT_FOREVER);
 		if(status != CY_U3P_SUCCESS)
 		{
 			AdiLogError(StreamThread_c, __LINE__, status);
+			AdiStreamTransferError();
 		}
+		if(StreamThreadState.TimestampsEnabled)
+		{
+			AdiWriteStreamTimestamp(timestamp, &bufPtr, &byteCounter, &StreamChannelBuffer);
+		}
+		AdiStreamCopyToUsb(StreamRxDmaBuffer.buffer, StreamThreadState.TransferByteLength, &bufPtr, &byteCounter, &StreamChannelBuffer);
+	}
 
-		/* Send whatever is in the buffer over to the PC */
-		status = CyU3PDmaChannelSetWrapUp(&StreamingChannel);
+	ADI_PROFILE_MARK(ProfilePhaseOther);
+
+	/* Check that we haven't captured the desired number of frames (or finished a capture) or that we were asked to kill the thread early */
+	if((numBuffersRead >= (StreamThreadState.NumBuffers - 1)) || StreamThreadState.CaptureDone || KillStreamEarly)
+	{
+		/* Disable the SPI DMA transfer */
+		status = CyU3PSpiDisableBlockXfer(CyTrue, CyTrue);
 		if(status != CY_U3P_SUCCESS)
 		{
 			AdiLogError(StreamThread_c, __LINE__, status);
 		}
 
+		/* Send any captured samples and whatever is in the buffer over to the PC */
+		if(StreamThreadState.RxCopyMode)
+		{
+			AdiCaptureEnd(&bufPtr, &byteCounter, &StreamChannelBuffer);
+			AdiStreamCommitLastUsbBuffer(&bufPtr, &byteCounter, &StreamChannelBuffer);
+		}
+		else
+		{
+			status = CyU3PDmaChannelSetWrapUp(&StreamingChannel);
+			if(status != CY_U3P_SUCCESS)
+			{
+				AdiLogError(StreamThread_c, __LINE__, status);
+			}
+		}
+
 		/* Clear GPIO interrupts */
 		GPIO->lpp_gpio_simple[FX3State.DrPin] |= CY_U3P_LPP_GPIO_INTR;
 		/* Reset frame counter */
@@ -529,7 +788,7 @@ static CyU3PReturnStatus_t AdiBurstStreamWork()
 		}
 
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "Exiting stream thread, %d burst stream buffers read.\r\n", numBuffersRead + 1);
+		ADI_LOG("Exiting stream thread, %d burst stream buffers read.\r\n", numBuffersRead + 1);
 #endif
 
 	}
@@ -556,7 +815,7 @@ static CyU3PReturnStatus_t AdiTransferStreamWork()
 	/* The MOSI data is stored in USBBuffer[14 ...] prior to this function being called */
 
 	/* Return status code */
-	CyU3PReturnStatus_t status;
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 
 	/* Track index within the USBBuffer */
 	uint16_t MOSIDataCount;
@@ -585,23 +844,32 @@ static CyU3PReturnStatus_t AdiTransferStreamWork()
 	/* If the stream channel buffer has not been set, get a new buffer */
 	if (bufPtr == 0)
 	{
+		ADI_PROFILE_MARK(ProfilePhaseDma);
 		/* get the buffer */
-		status = CyU3PDmaChannelGetBuffer (&StreamingChannel, &StreamChannelBuffer, CYU3P_WAIT_FOREVER);
-		if (status != CY_U3P_SUCCESS)
-		{
-			AdiLogError(StreamThread_c, __LINE__, status);
-		}
-		bufPtr = StreamChannelBuffer.buffer;
+		AdiStreamGetUsbBuffer(&bufPtr, &byteCounter, &StreamChannelBuffer);
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "Got the first transfer stream DMA buffer, address = 0x%x\r\n", bufPtr);
+		ADI_LOG("Got the first transfer stream DMA buffer, address = 0x%x\r\n", bufPtr);
 #endif
 	}
 
 	/* Check the number of bytes per SPI transfer */
 	bytesPerSpiTransfer = FX3State.SpiConfig.wordLen >> 3;
 
+	ADI_PROFILE_MARK(ProfilePhaseDrWait);
+
+	/* Flag any data ready edge missed while the last sample was processed */
+	AdiStreamSampleStart();
+
 	/* Wait for DR if enabled */
-	if (FX3State.DrActive)
+	if (StreamThreadState.DrInterruptWait)
+	{
+		/* Block until the GPIO ISR signals a data ready edge */
+		if(AdiWaitForStreamDataReady() == CY_U3P_SUCCESS)
+		{
+			AdiRecordDataReadyLatency();
+		}
+	}
+	else if (FX3State.DrActive)
 	{
 		/* Clear GPIO interrupts */
 		GPIO->lpp_gpio_simple[FX3State.DrPin] |= CY_U3P_LPP_GPIO_INTR;
@@ -609,10 +877,18 @@ static CyU3PReturnStatus_t AdiTransferStreamWork()
 		while(!(GPIO->lpp_gpio_intr0 & (1 << FX3State.DrPin)));
 	}
 
-	/* Set the pin timer to 0 */
-	GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].timer = 0;
-	/* clear interrupt flag */
-	GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status |= CY_U3P_LPP_GPIO_INTR;
+	/* Count the new sample */
+	AdiStreamSampleReady();
+
+	/* Place the data ready time stamp ahead of the transfer data */
+	if(StreamThreadState.TimestampsEnabled)
+	{
+		AdiWriteStreamTimestamp(AdiGetStreamTimestamp(), &bufPtr, &byteCounter, &StreamChannelBuffer);
+	}
+
+	/* Start the stall time */
+	AdiRestartStreamStallTimer();
+	ADI_PROFILE_MARK(ProfilePhaseOther);
 
 	for(captureCount = 0; captureCount < StreamThreadState.NumCaptures; captureCount++)
 	{
@@ -622,17 +898,17 @@ static CyU3PReturnStatus_t AdiTransferStreamWork()
 		MOSIData += 14;
 		for(MOSIDataCount = 0; MOSIDataCount < StreamThreadState.BytesPerBuffer; MOSIDataCount += bytesPerSpiTransfer)
 		{
+			ADI_PROFILE_MARK(ProfilePhaseStall);
 			/* Wait for the complex GPIO timer to reach the stall time */
 			while(!(GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status & CY_U3P_LPP_GPIO_INTR));
+			ADI_PROFILE_MARK(ProfilePhaseTransfer);
 
 			/* Transfer data */
 			AdiSpiTransferWord(MOSIData, bufPtr, bytesPerSpiTransfer);
 
-			/* Set the pin timer to 0 */
-			GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].timer = 0;
-
-			/* clear timer interrupt flag */
-			GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status |= CY_U3P_LPP_GPIO_INTR;
+			/* Start the stall time */
+			AdiRestartStreamStallTimer();
+			ADI_PROFILE_MARK(ProfilePhaseOther);
 
 			/* Update counters and buffer pointers */
 			bufPtr += bytesPerSpiTransfer;
@@ -642,24 +918,16 @@ static CyU3PReturnStatus_t AdiTransferStreamWork()
 			/* Check if a transmission is needed */
 			if (byteCounter >= (StreamThreadState.BytesPerUsbPacket - 1))
 			{
+				ADI_PROFILE_MARK(ProfilePhaseDma);
 #ifdef VERBOSE_MODE
-				CyU3PDebugPrint (4, "Transfer steam DMA transmit started. Buffers Read = %d\r\n", numBuffersRead);
+				ADI_LOG("Transfer steam DMA transmit started. Buffers Read = %d\r\n", numBuffersRead);
 #endif
 				/* Commit DMA buffer */
-				status = CyU3PDmaChannelCommitBuffer (&StreamingChannel, FX3State.UsbBufferSize, 0);
-				if (status != CY_U3P_SUCCESS)
-				{
-					AdiLogError(StreamThread_c, __LINE__, status);
-				}
+				AdiStreamCommitUsbBuffer(&byteCounter, &StreamChannelBuffer);
 
 				/* Get new buffer */
-				status = CyU3PDmaChannelGetBuffer (&StreamingChannel, &StreamChannelBuffer, CYU3P_WAIT_FOREVER);
-				if (status != CY_U3P_SUCCESS)
-				{
-					AdiLogError(StreamThread_c, __LINE__, status);
-				}
-				bufPtr = StreamChannelBuffer.buffer;
-				byteCounter = 0;
+				AdiStreamGetUsbBuffer(&bufPtr, &byteCounter, &StreamChannelBuffer);
+				ADI_PROFILE_MARK(ProfilePhaseOther);
 			}
 		}
 	}
@@ -669,22 +937,13 @@ static CyU3PReturnStatus_t AdiTransferStreamWork()
 	{
 
 #ifdef VERBOSE_MODE
-		CyU3PDebugPrint (4, "Exiting stream thread, %d transfer stream buffers read.\r\n", numBuffersRead + 1);
+		ADI_LOG("Exiting stream thread, %d transfer stream buffers read.\r\n", numBuffersRead + 1);
 #endif
 
 		/* Reset values */
 		numBuffersRead = 0;
-		/* Signal getting a new buffer */
-		bufPtr = 0;
-		if (byteCounter)
-		{
-			status = CyU3PDmaChannelCommitBuffer (&StreamingChannel, FX3State.UsbBufferSize, 0);
-			if (status != CY_U3P_SUCCESS)
-			{
-				AdiLogError(StreamThread_c, __LINE__, status);
-			}
-			byteCounter = 0;
-		}
+		/* Commit the partial USB buffer and signal getting a new buffer */
+		AdiStreamCommitLastUsbBuffer(&bufPtr, &byteCounter, &StreamChannelBuffer);
 
 		/* Clear GPIO interrupts */
 		GPIO->lpp_gpio_simple[FX3State.DrPin] |= CY_U3P_LPP_GPIO_INTR;
@@ -712,6 +971,7 @@ static CyU3PReturnStatus_t AdiTransferStreamWork()
 		/* Wait for the complex GPIO timer to reach the stall time if no data ready */
 		if(!FX3State.DrActive)
 		{
+			ADI_PROFILE_MARK(ProfilePhaseStall);
 			while(!(GPIO->lpp_gpio_pin[ADI_TIMER_PIN_INDEX].status & CY_U3P_LPP_GPIO_INTR));
 		}
 		/* Reset flag */
@@ -720,4 +980,789 @@ static CyU3PReturnStatus_t AdiTransferStreamWork()
 	return status;
 }
 
+/**
+  * @brief Checks a generic stream register list entry for a PAGE_ID write which can be skipped.
+  *
+  * @param entry The register list entry: data, then 0x80 | address for a write
+  *
+  * @param noReadPending True if the transaction before the entry has no read data for it to clock out
+  *
+  * @return CyTrue if the entry can be skipped, CyFalse if it must be sent.
+  *
+  * With the page cache enabled, a PAGE_ID write which selects the page the DUT is already on is skipped.
+  * A PAGE_ID write which is sent updates the cached page, so it is still correct when the stream finishes.
+ **/
+static CyBool_t AdiGenericStreamPageSkip(const uint8_t *entry, CyBool_t noReadPending)
+{
+	if(entry[1] != (0x80 | ADI_PAGE_ID_ADDR))
+	{
+		return CyFalse;
+	}
+	if(FX3State.PageCacheEnabled && noReadPending && (entry[0] == FX3State.CurrentPage))
+	{
+		return CyTrue;
+	}
+	FX3State.CurrentPage = entry[0];
+	return CyFalse;
+}
+
+/**
+  * @brief Sets up the SPI block and Tx DMA for the next burst, leaving only the SPI enable to start it.
+  *
+  * @return void
+  *
+  * The Tx buffers sent by earlier bursts are put back in the queue on the SPI consumer socket first. Their
+  * contents never change, so this is only a commit per buffer, and the socket always has the next bursts
+  * waiting. Then the DMA mode, byte counts and Rx/Tx enables are written, and the burst is marked as armed.
+  * An armed burst is started by the GPIO ISR on the data ready edge (interrupt driven streams) or by
+  * AdiBurstStart, so the only register write between the edge and SCLK is the SPI enable.
+ **/
+static void AdiBurstArm()
+{
+	CyU3PReturnStatus_t status;
+	CyU3PDmaBuffer_t txBuffer;
+
+	/* Requeue every Tx buffer the SPI block has finished with */
+	while(CyU3PDmaChannelGetBuffer(&MemoryToSPI, &txBuffer, CYU3P_NO_WAIT) == CY_U3P_SUCCESS)
+	{
+		status = CyU3PDmaChannelCommitBuffer(&MemoryToSPI, StreamThreadState.TransferByteLength, 0);
+		if(status != CY_U3P_SUCCESS)
+		{
+			AdiLogError(StreamThread_c, __LINE__, status);
+			break;
+		}
+	}
+
+	/* Set the config for DMA mode with RX and TX enabled */
+	SPI->lpp_spi_config |= CY_U3P_LPP_SPI_DMA_MODE;
+
+	/* Set the Tx/Rx count */
+	SPI->lpp_spi_tx_byte_count = StreamThreadState.TransferByteLength;
+	SPI->lpp_spi_rx_byte_count = StreamThreadState.TransferByteLength;
+
+	/* Enable SPI Rx and Tx */
+	SPI->lpp_spi_config |= (CY_U3P_LPP_SPI_RX_ENABLE | CY_U3P_LPP_SPI_TX_ENABLE);
+
+	StreamThreadState.BurstArmed = CyTrue;
+}
 
+/**
+  * @brief Starts an armed burst from the stream thread.
+  *
+  * @return void
+  *
+  * Called after the data ready wait. The GPIO ISR only runs during interrupt driven data ready waits,
+  * so it can't start the burst at the same time.
+ **/
+static void AdiBurstStart()
+{
+	if(StreamThreadState.BurstArmed)
+	{
+		StreamThreadState.BurstArmed = CyFalse;
+		/* Enable the SPI block */
+		SPI->lpp_spi_config |= CY_U3P_LPP_SPI_ENABLE;
+	}
+}
+
+/**
+  * @brief This is the worker function for the logic analyzer stream.
+  *
+  * @return A status code representing the success of the logic analyzer stream operation.
+  *
+  * This function samples the logic analyzer pins until one USB buffer of run records has been sent. Each
+  * sample is taken when the free running 10MHz timer reaches the next sample time, so the sample rate does
+  * not drift with the time spent in the worker. A record is written when the pin state changes: pin state[0-1]
+  * (bit n is FX3 GPIO n) and the number of samples the state was held for[2-3]. If the worker falls behind
+  * (for example waiting on the PC for a USB buffer), the sample times it missed are added to the current run
+  * and counted as missed data ready edges in the stream statistics, so the run lengths stay on the timer
+  * time base. A partly filled USB buffer is sent after ADI_LOGIC_FLUSH_MS, so a slowly changing bus still
+  * reaches the PC. Records with a run length of 0 are padding and should be skipped.
+ **/
+static CyU3PReturnStatus_t AdiLogicStreamWork()
+{
+	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
+	uint32_t pinState, timerValue, lateSamples, buffersSent;
+
+	/* Track the current position within the streaming DMA buffer */
+	static uint8_t *bufPtr;
+
+	/* Track the number of bytes placed in the current DMA buffer */
+	static uint32_t byteCounter;
+
+	/* DMA buffer structure for the active buffer for the streaming DMA channel */
+	static CyU3PDmaBuffer_t StreamChannelBuffer;
+
+	buffersSent = StreamThreadState.Stats.BuffersCommitted + StreamThreadState.Stats.DroppedBuffers;
+	while((StreamThreadState.Stats.BuffersCommitted + StreamThreadState.Stats.DroppedBuffers) == buffersSent)
+	{
+		if(KillStreamEarly || (StreamThreadState.NumCaptures && (StreamThreadState.Stats.Samples >= StreamThreadState.NumCaptures)))
+		{
+			/* Send the last run, then commit the partial USB buffer with its unused end as padding records */
+			AdiLogicWriteRun(&bufPtr, &byteCounter, &StreamChannelBuffer);
+			if((bufPtr != 0) && byteCounter)
+			{
+				CyU3PMemSet(bufPtr, 0, StreamThreadState.UsbBufferBytes - StreamThreadState.FrameHeaderBytes - byteCounter);
+			}
+			AdiStreamCommitLastUsbBuffer(&bufPtr, &byteCounter, &StreamChannelBuffer);
+
+#ifdef VERBOSE_MODE
+			ADI_LOG("Exiting stream thread, %d logic analyzer samples taken.\r\n", StreamThreadState.Stats.Samples);
+#endif
+
+			/* Set stream done flag if kill early event was processed (otherwise must be explicitly invoked by FX3 API) */
+			if(KillStreamEarly)
+			{
+				CyU3PEventSet(&EventHandler, ADI_LOGIC_STREAM_DONE, CYU3P_EVENT_OR);
+			}
+			return status;
+		}
+
+		/* Wait for the sample time, then sample all the pins at once */
+		do
+		{
+			timerValue = AdiReadTimerRegValue();
+		}while((int32_t)(timerValue - StreamThreadState.LogicNextSample) < 0);
+		pinState = GPIO->lpp_gpio_invalue0 & StreamThreadState.LogicPinMask;
+
+		/* Sample times the worker was too late for are held at the current state */
+		lateSamples = (timerValue - StreamThreadState.LogicNextSample) / StreamThreadState.LogicPeriodTicks;
+		if(lateSamples)
+		{
+			StreamThreadState.FrameFlags |= ADI_STREAM_FRAME_FLAG_DR_MISSED;
+			StreamThreadState.Stats.DrMissed += lateSamples;
+			StreamThreadState.LogicRunLength += lateSamples;
+		}
+		StreamThreadState.LogicNextSample += (lateSamples + 1) * StreamThreadState.LogicPeriodTicks;
+		AdiStreamSampleReady();
+
+		/* A new pin state ends the current run */
+		if(pinState != StreamThreadState.LogicState)
+		{
+			AdiLogicWriteRun(&bufPtr, &byteCounter, &StreamChannelBuffer);
+			StreamThreadState.LogicState = pinState;
+		}
+		StreamThreadState.LogicRunLength++;
+		if(StreamThreadState.LogicRunLength >= ADI_LOGIC_MAX_RUN)
+		{
+			AdiLogicWriteRun(&bufPtr, &byteCounter, &StreamChannelBuffer);
+		}
+
+		/* Send a partly filled USB buffer once it has been held for the flush time */
+		if(((StreamThreadState.Stats.Samples & (ADI_LOGIC_FLUSH_CHECK_SAMPLES - 1)) == 0)
+				&& ((CyU3PGetTime() - StreamThreadState.LogicBufferTime) >= ADI_LOGIC_FLUSH_MS))
+		{
+			AdiLogicFlush(&bufPtr, &byteCounter, &StreamChannelBuffer);
+		}
+	}
+
+	/* A USB buffer was sent, so start timing the next one */
+	StreamThreadState.LogicBufferTime = CyU3PGetTime();
+
+	/* Reset flag */
+	CyU3PEventSet (&EventHandler, ADI_LOGIC_STREAM_ENABLE, CYU3P_EVENT_OR);
+
+	return status;
+}
+
+
+
+/**
+  * @brief Gets a new USB buffer from the streaming DMA channel.
+  *
+  * @param bufPtr Set to the position for the first stream data byte in the new buffer
+  *
+  * @param byteCounter The calling worker's count of bytes placed in the current streaming DMA buffer. Cleared.
+  *
+  * @param channelBuffer The calling worker's active streaming DMA buffer structure
+  *
+  * @return void
+  *
+  * Stream data is placed after the space reserved for the frame header. A USB buffer which is not
+  * immediately available (the PC is not keeping up with the stream) is counted in the stream statistics,
+  * along with the time spent waiting for it, and sets the overflow flag in the new frame. With the block
+  * overflow policy the wait has no limit. Otherwise, after FX3State.StreamOverflowWaitMs the overflow
+  * policy drops samples (AdiStreamOverflow). While the drop newest policy is dropping samples the stream
+  * data goes to the discard buffer, and a USB buffer is only taken once the PC has freed one.
+ **/
+static void AdiStreamGetUsbBuffer(uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer)
+{
+	CyU3PReturnStatus_t status;
+	uint32_t waitStart, waitOption;
+
+	/* Captures fill the next ring slot instead */
+	if(StreamThreadState.CaptureActive)
+	{
+		*bufPtr = StreamThreadState.CaptureRing + (StreamThreadState.CaptureWriteSlot * StreamThreadState.BytesPerBuffer);
+		*byteCounter = 0;
+		return;
+	}
+
+	AdiStreamSampleOccupancy();
+
+	status = CyU3PDmaChannelGetBuffer(&StreamingChannel, channelBuffer, CYU3P_NO_WAIT);
+	if(StreamThreadState.Discarding)
+	{
+		if(status == CY_U3P_SUCCESS)
+		{
+			/* The PC freed a USB buffer, so the gap ends before this frame */
+			StreamThreadState.Discarding = CyFalse;
+			StreamThreadState.FrameFlags |= ADI_STREAM_FRAME_FLAG_GAP;
+		}
+		else
+		{
+			/* Keep dropping samples, without waiting */
+			channelBuffer->buffer = StreamThreadState.DiscardBuffer;
+			channelBuffer->size = StreamThreadState.UsbBufferBytes;
+		}
+	}
+	else if(status != CY_U3P_SUCCESS)
+	{
+		StreamThreadState.FrameFlags |= ADI_STREAM_FRAME_FLAG_OVERFLOW;
+		StreamThreadState.Stats.BufferWaits++;
+		waitOption = CYU3P_WAIT_FOREVER;
+		if(StreamThreadState.OverflowPolicy != ADI_STREAM_OVERFLOW_BLOCK)
+		{
+			waitOption = FX3State.StreamOverflowWaitMs;
+		}
+		ADI_TRACE(TraceUsbWaitStart, waitOption, StreamThreadState.Stats.BufferWaits);
+		waitStart = CyU3PGetTime();
+		status = CyU3PDmaChannelGetBuffer(&StreamingChannel, channelBuffer, waitOption);
+		StreamThreadState.Stats.BufferWaitMs += CyU3PGetTime() - waitStart;
+		ADI_TRACE(TraceUsbWaitEnd, status, CyU3PGetTime() - waitStart);
+		if((status != CY_U3P_SUCCESS) && (StreamThreadState.OverflowPolicy != ADI_STREAM_OVERFLOW_BLOCK))
+		{
+			status = AdiStreamOverflow(channelBuffer);
+		}
+		if (status != CY_U3P_SUCCESS)
+		{
+			AdiLogError(StreamThread_c, __LINE__, status);
+		}
+	}
+
+	*bufPtr = channelBuffer->buffer + StreamThreadState.FrameHeaderBytes;
+	*byteCounter = 0;
+}
+
+/**
+  * @brief Sends the active USB buffer to the PC, adding the frame header for framed streams.
+  *
+  * @param byteCounter The calling worker's count of bytes placed in the current streaming DMA buffer. Cleared.
+  * With multi packet USB buffers this is also the number of payload bytes sent.
+  *
+  * @param channelBuffer The calling worker's active streaming DMA buffer structure
+  *
+  * @return void
+ **/
+static void AdiStreamCommitUsbBuffer(uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer)
+{
+	CyU3PReturnStatus_t status;
+	uint32_t commitBytes, droppedSamples, index;
+
+	/* Captures keep the sample in the ring */
+	if(StreamThreadState.CaptureActive)
+	{
+		AdiCaptureStoreSample();
+		*byteCounter = 0;
+		return;
+	}
+
+	if(StreamThreadState.Discarding)
+	{
+		/* Drop the discard buffer. The frame still uses up a sequence number, so the PC sees the gap */
+		droppedSamples = StreamThreadState.Stats.Samples - StreamThreadState.SamplesAtCommit;
+		StreamThreadState.Stats.DroppedBuffers++;
+		StreamThreadState.Stats.DroppedSamples += droppedSamples;
+		StreamThreadState.Stats.LastGapSamples += droppedSamples;
+		StreamThreadState.SamplesAtCommit = StreamThreadState.Stats.Samples;
+		if(StreamThreadState.FramingEnabled)
+		{
+			StreamThreadState.FrameSequence++;
+			StreamThreadState.FrameSamples = 0;
+			StreamThreadState.FrameFlags = 0;
+		}
+		*byteCounter = 0;
+		return;
+	}
+
+	if(StreamThreadState.FramingEnabled)
+	{
+		AdiStreamCloseFrame(channelBuffer->buffer, *byteCounter);
+	}
+
+	/* Multi packet buffers only send their valid bytes, single packet buffers are always sent full size */
+	commitBytes = FX3State.UsbBufferSize;
+	if(StreamThreadState.ExactCommits)
+	{
+		commitBytes = StreamThreadState.FrameHeaderBytes + *byteCounter;
+	}
+	status = CyU3PDmaChannelCommitBuffer (&StreamingChannel, commitBytes, 0);
+	if (status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamThread_c, __LINE__, status);
+	}
+	StreamThreadState.Stats.BuffersCommitted++;
+	ADI_TRACE(TraceUsbCommit, commitBytes, StreamThreadState.Stats.BuffersCommitted);
+
+	/* Track the channel byte count and first sample of the buffer, for the drop oldest overflow policy */
+	index = StreamThreadState.CommitCount % ADI_STREAM_COMMIT_HISTORY;
+	StreamThreadState.CommitBytesTotal += commitBytes;
+	StreamThreadState.CommitEndBytes[index] = StreamThreadState.CommitBytesTotal;
+	StreamThreadState.CommitStartSample[index] = StreamThreadState.SamplesAtCommit;
+	StreamThreadState.CommitCount++;
+	StreamThreadState.SamplesAtCommit = StreamThreadState.Stats.Samples;
+
+	*byteCounter = 0;
+}
+
+/**
+  * @brief Sends the partially filled USB buffer to the PC at the end of a stream.
+  *
+  * @param bufPtr The calling worker's current position within the streaming DMA buffer. Cleared, so the
+  * next stream gets a new buffer.
+  *
+  * @param byteCounter The calling worker's count of bytes placed in the current streaming DMA buffer. Cleared.
+  *
+  * @param channelBuffer The calling worker's active streaming DMA buffer structure
+  *
+  * @return void
+  *
+  * Framed streams always end with a frame flagged as the last frame, even if it carries no data. If the
+  * drop newest overflow policy is dropping samples, the PC is given the overflow wait time to free a USB
+  * buffer for the last frame.
+ **/
+static void AdiStreamCommitLastUsbBuffer(uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer)
+{
+	if((*bufPtr != 0) && (*byteCounter || StreamThreadState.FramingEnabled))
+	{
+#ifdef VERBOSE_MODE
+		ADI_LOG("Commiting last USB buffer with %d bytes.\r\n", *byteCounter);
+#endif
+		if(StreamThreadState.Discarding && StreamThreadState.FramingEnabled)
+		{
+			AdiStreamCommitUsbBuffer(byteCounter, channelBuffer);
+			if(CyU3PDmaChannelGetBuffer(&StreamingChannel, channelBuffer, FX3State.StreamOverflowWaitMs) == CY_U3P_SUCCESS)
+			{
+				StreamThreadState.Discarding = CyFalse;
+				StreamThreadState.FrameFlags |= ADI_STREAM_FRAME_FLAG_GAP;
+			}
+		}
+		StreamThreadState.FrameFlags |= ADI_STREAM_FRAME_FLAG_LAST;
+		AdiStreamCommitUsbBuffer(byteCounter, channelBuffer);
+	}
+	*bufPtr = 0;
+	*byteCounter = 0;
+}
+
+/**
+  * @brief Applies the stream overflow policy when the PC has not freed a USB buffer in the overflow wait time.
+  *
+  * @param channelBuffer The calling worker's streaming DMA buffer structure, set to the buffer to fill next
+  *
+  * @return A status code indicating the success of the function.
+  *
+  * Drop newest points the worker at the discard buffer, so samples are dropped until the PC frees a USB
+  * buffer. Drop oldest throws away the USB buffers the PC has not read yet, then takes a new one. Either
+  * way the next frame sent has the gap flag set, and the gap is counted in the stream statistics.
+ **/
+static CyU3PReturnStatus_t AdiStreamOverflow(CyU3PDmaBuffer_t *channelBuffer)
+{
+	StreamThreadState.Stats.OverflowEvents++;
+	ADI_TRACE(TraceUsbOverflow, StreamThreadState.OverflowPolicy, StreamThreadState.Stats.OverflowEvents);
+
+	if(StreamThreadState.OverflowPolicy == ADI_STREAM_OVERFLOW_DROP_NEWEST)
+	{
+		StreamThreadState.Discarding = CyTrue;
+		StreamThreadState.Stats.LastGapStart = StreamThreadState.SamplesAtCommit;
+		StreamThreadState.Stats.LastGapSamples = 0;
+		channelBuffer->buffer = StreamThreadState.DiscardBuffer;
+		channelBuffer->size = StreamThreadState.UsbBufferBytes;
+		return CY_U3P_SUCCESS;
+	}
+
+	AdiStreamDropPendingBuffers();
+	StreamThreadState.FrameFlags |= ADI_STREAM_FRAME_FLAG_GAP;
+	return CyU3PDmaChannelGetBuffer(&StreamingChannel, channelBuffer, CYU3P_NO_WAIT);
+}
+
+/**
+  * @brief Drops the USB buffers which the PC has not read yet, for the drop oldest overflow policy.
+  *
+  * @return void
+  *
+  * The dropped buffers are found by comparing the bytes the USB side has consumed against the byte count
+  * at the end of each recent commit. A buffer the PC was part way through reading is dropped as well. The
+  * streaming channel and endpoint are then reset, which frees every USB buffer.
+ **/
+static void AdiStreamDropPendingBuffers()
+{
+	CyU3PReturnStatus_t status;
+	CyU3PDmaState_t state;
+	uint32_t prodXferCount, consXferCount, numTracked, numDropped, firstDropped, index;
+
+	status = CyU3PDmaChannelGetStatus(&StreamingChannel, &state, &prodXferCount, &consXferCount);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamThread_c, __LINE__, status);
+		consXferCount = 0;
+	}
+
+	numTracked = StreamThreadState.CommitCount;
+	if(numTracked > ADI_STREAM_COMMIT_HISTORY)
+	{
+		numTracked = ADI_STREAM_COMMIT_HISTORY;
+	}
+
+	/* Walk back from the newest commit to the last buffer the PC has fully read */
+	numDropped = 0;
+	firstDropped = StreamThreadState.SamplesAtCommit;
+	while(numDropped < numTracked)
+	{
+		index = (StreamThreadState.CommitCount - 1 - numDropped) % ADI_STREAM_COMMIT_HISTORY;
+		if(StreamThreadState.CommitEndBytes[index] <= consXferCount)
+		{
+			break;
+		}
+		firstDropped = StreamThreadState.CommitStartSample[index];
+		numDropped++;
+	}
+
+	StreamThreadState.Stats.DroppedBuffers += numDropped;
+	StreamThreadState.Stats.DroppedSamples += StreamThreadState.SamplesAtCommit - firstDropped;
+	StreamThreadState.Stats.LastGapStart = firstDropped;
+	StreamThreadState.Stats.LastGapSamples = StreamThreadState.SamplesAtCommit - firstDropped;
+
+#ifdef VERBOSE_MODE
+	ADI_LOG("Stream overflow: dropped %d USB buffers, %d samples\r\n", numDropped, StreamThreadState.Stats.LastGapSamples);
+#endif
+
+	/* Reset the channel (byte counts restart from 0) and the endpoint */
+	status = CyU3PDmaChannelReset(&StreamingChannel);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamThread_c, __LINE__, status);
+	}
+	status = CyU3PUsbFlushEp(ADI_STREAMING_ENDPOINT);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamThread_c, __LINE__, status);
+	}
+	status = CyU3PDmaChannelSetXfer(&StreamingChannel, 0);
+	if(status != CY_U3P_SUCCESS)
+	{
+		AdiLogError(StreamThread_c, __LINE__, status);
+	}
+	StreamThreadState.CommitCount = 0;
+	StreamThreadState.CommitBytesTotal = 0;
+}
+
+/**
+  * @brief Stores the sample just written to the current capture ring slot, and checks the capture trigger.
+  *
+  * @return void
+  *
+  * Before the trigger the ring wraps, keeping the newest samples. From the trigger sample on, the samples
+  * are counted until all the post trigger samples are stored, which ends the capture.
+ **/
+static void AdiCaptureStoreSample()
+{
+	uint8_t *sample;
+
+	if(StreamThreadState.CaptureDone)
+	{
+		return;
+	}
+
+	sample = StreamThreadState.CaptureRing + (StreamThreadState.CaptureWriteSlot * StreamThreadState.BytesPerBuffer);
+	StreamThreadState.CaptureWriteSlot++;
+	if(StreamThreadState.CaptureWriteSlot >= StreamThreadState.CaptureSlots)
+	{
+		StreamThreadState.CaptureWriteSlot = 0;
+	}
+	StreamThreadState.CaptureStored++;
+
+	if(!StreamThreadState.CaptureTriggered && AdiCaptureTriggerCheck(sample))
+	{
+		StreamThreadState.CaptureTriggered = CyTrue;
+		StreamThreadState.CaptureTriggerSample = StreamThreadState.CaptureStored - 1;
+#ifdef VERBOSE_MODE
+		ADI_LOG("Capture triggered at sample %d\r\n", StreamThreadState.CaptureTriggerSample);
+#endif
+	}
+
+	if(StreamThreadState.CaptureTriggered)
+	{
+		StreamThreadState.CapturePostStored++;
+		if(StreamThreadState.CapturePostStored >= FX3State.Capture.PostSamples)
+		{
+			StreamThreadState.CaptureDone = CyTrue;
+		}
+	}
+}
+
+/**
+  * @brief Checks if a stored sample fires the capture trigger.
+  *
+  * @param sample Pointer to the sample in the capture ring (including any time stamp)
+  *
+  * @return CyTrue if the capture triggers on this sample.
+  *
+  * ADI_CAPTURE_TRIGGER_CMD fires the trigger whatever the trigger source. Pin edges are latched in the GPIO
+  * interrupt status (or by the GPIO ISR during interrupt driven streams), so an edge any time since the last
+  * sample triggers on this one. Threshold crossings compare the word at ThresholdOffset with the same word in
+  * the previous sample.
+ **/
+static CyBool_t AdiCaptureTriggerCheck(uint8_t *sample)
+{
+	CaptureConfig *config = &FX3State.Capture;
+	CyBool_t fired = StreamThreadState.CaptureHostTrigger;
+	int32_t value, threshold;
+
+	if(config->TriggerSource == ADI_CAPTURE_TRIGGER_PIN)
+	{
+		if(StreamThreadState.CaptureEdgeSeen || (GPIO->lpp_gpio_simple[config->TriggerPin] & CY_U3P_LPP_GPIO_INTR))
+		{
+			GPIO->lpp_gpio_simple[config->TriggerPin] |= CY_U3P_LPP_GPIO_INTR;
+			StreamThreadState.CaptureEdgeSeen = CyFalse;
+			fired = CyTrue;
+		}
+	}
+	else if(config->TriggerSource == ADI_CAPTURE_TRIGGER_THRESHOLD)
+	{
+		if(StreamThreadState.TimestampsEnabled)
+		{
+			sample += ADI_STREAM_TIMESTAMP_BYTES;
+		}
+		sample += config->ThresholdOffset;
+
+		if(config->ThresholdFlags & ADI_CAPTURE_THRESHOLD_LSB_FIRST)
+		{
+			value = sample[0] | (sample[1] << 8);
+		}
+		else
+		{
+			value = (sample[0] << 8) | sample[1];
+		}
+		threshold = config->ThresholdValue;
+		if(config->ThresholdFlags & ADI_CAPTURE_THRESHOLD_SIGNED)
+		{
+			value = (int16_t) value;
+			threshold = (int16_t) threshold;
+		}
+
+		if(StreamThreadState.CaptureHaveLast)
+		{
+			if(config->TriggerPolarity)
+			{
+				fired |= (CyBool_t) ((StreamThreadState.CaptureLastValue < threshold) && (value >= threshold));
+			}
+			else
+			{
+				fired |= (CyBool_t) ((StreamThreadState.CaptureLastValue > threshold) && (value <= threshold));
+			}
+		}
+		StreamThreadState.CaptureLastValue = value;
+		StreamThreadState.CaptureHaveLast = CyTrue;
+	}
+
+	return fired;
+}
+
+/**
+  * @brief Ends the capture phase of a stream, and sends the captured samples to the PC if the capture is done.
+  *
+  * @param bufPtr The calling worker's current position within the streaming DMA buffer. Moved to the USB buffers.
+  *
+  * @param byteCounter The calling worker's count of bytes placed in the current streaming DMA buffer
+  *
+  * @param channelBuffer The calling worker's active streaming DMA buffer structure
+  *
+  * @return void
+  *
+  * The kept pre trigger samples and the post trigger samples are sent oldest first, packed into the USB
+  * buffers the same way as a normal stream. The caller then commits the last USB buffer as usual. A capture
+  * stopped before it is done sends nothing.
+ **/
+static void AdiCaptureEnd(uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer)
+{
+	uint32_t preSamples, numSamples, slot;
+
+	if(!StreamThreadState.CaptureActive)
+	{
+		return;
+	}
+
+	/* Back to the streaming DMA channel */
+	StreamThreadState.CaptureActive = CyFalse;
+	*bufPtr = 0;
+	*byteCounter = 0;
+	if(!StreamThreadState.CaptureDone)
+	{
+		return;
+	}
+
+	preSamples = StreamThreadState.CaptureTriggerSample;
+	if(preSamples > FX3State.Capture.PreSamples)
+	{
+		preSamples = FX3State.Capture.PreSamples;
+	}
+	numSamples = preSamples + StreamThreadState.CapturePostStored;
+	slot = (StreamThreadState.CaptureWriteSlot + StreamThreadState.CaptureSlots - numSamples) % StreamThreadState.CaptureSlots;
+
+#ifdef VERBOSE_MODE
+	ADI_LOG("Sending capture: %d pre, %d post trigger samples\r\n", preSamples, StreamThreadState.CapturePostStored);
+#endif
+
+	StreamThreadState.BytesPerUsbPacket = AdiStreamBytesPerUsbPacket(StreamThreadState.BytesPerBuffer);
+	StreamThreadState.FrameSamples = 0;
+	while(numSamples)
+	{
+		StreamThreadState.FrameSamples++;
+		AdiStreamCopyToUsb(StreamThreadState.CaptureRing + (slot * StreamThreadState.BytesPerBuffer), StreamThreadState.BytesPerBuffer, bufPtr, byteCounter, channelBuffer);
+		slot++;
+		if(slot >= StreamThreadState.CaptureSlots)
+		{
+			slot = 0;
+		}
+		numSamples--;
+	}
+}
+
+/**
+  * @brief Writes the logic analyzer run being counted to the streaming DMA channel, and starts a new run.
+  *
+  * @param bufPtr The calling worker's current position within the streaming DMA buffer
+  *
+  * @param byteCounter The calling worker's count of bytes placed in the current streaming DMA buffer
+  *
+  * @param channelBuffer The calling worker's active streaming DMA buffer structure
+  *
+  * @return void
+  *
+  * Runs longer than ADI_LOGIC_MAX_RUN samples are split across several records with the same pin state.
+ **/
+static void AdiLogicWriteRun(uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer)
+{
+	uint8_t record[ADI_LOGIC_RECORD_BYTES];
+	uint32_t runLength;
+
+	while(StreamThreadState.LogicRunLength)
+	{
+		runLength = StreamThreadState.LogicRunLength;
+		if(runLength > ADI_LOGIC_MAX_RUN)
+		{
+			runLength = ADI_LOGIC_MAX_RUN;
+		}
+		record[0] = StreamThreadState.LogicState & 0xFF;
+		record[1] = (StreamThreadState.LogicState & 0xFF00) >> 8;
+		record[2] = runLength & 0xFF;
+		record[3] = (runLength & 0xFF00) >> 8;
+		AdiStreamCopyToUsb(record, ADI_LOGIC_RECORD_BYTES, bufPtr, byteCounter, channelBuffer);
+		StreamThreadState.LogicRunLength -= runLength;
+	}
+}
+
+/**
+  * @brief Sends the run being counted and the partly filled USB buffer to the PC, for a slowly changing bus.
+  *
+  * @param bufPtr The calling worker's current position within the streaming DMA buffer. Cleared, so the
+  * next record gets a new buffer.
+  *
+  * @param byteCounter The calling worker's count of bytes placed in the current streaming DMA buffer. Cleared.
+  *
+  * @param channelBuffer The calling worker's active streaming DMA buffer structure
+  *
+  * @return void
+  *
+  * The unused end of the USB buffer is zeroed, so it reads as padding records (run length 0). The run
+  * carries on in the next record, with the same pin state.
+ **/
+static void AdiLogicFlush(uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer)
+{
+	AdiLogicWriteRun(bufPtr, byteCounter, channelBuffer);
+	if((*bufPtr != 0) && *byteCounter)
+	{
+		CyU3PMemSet(*bufPtr, 0, StreamThreadState.UsbBufferBytes - StreamThreadState.FrameHeaderBytes - *byteCounter);
+		AdiStreamCommitUsbBuffer(byteCounter, channelBuffer);
+		*bufPtr = 0;
+	}
+}
+
+/**
+  * @brief Copies stream data into the streaming DMA channel, committing each USB buffer as it is filled.
+  *
+  * @param src Pointer to the data to copy
+  *
+  * @param numBytes The number of bytes to copy
+  *
+  * @param bufPtr The calling worker's current position within the streaming DMA buffer. A new buffer is requested if 0.
+  *
+  * @param byteCounter The calling worker's count of bytes placed in the current streaming DMA buffer
+  *
+  * @param channelBuffer The calling worker's active streaming DMA buffer structure
+  *
+  * @return void
+  *
+  * The USB buffers are filled up to StreamThreadState.BytesPerUsbPacket, and committed once they hold exactly
+  * that many bytes. The copy is byte exact, so unlike the 2 byte stride workers there is no one byte slack in
+  * the commit check, which would split an odd length sample across two USB buffers.
+ **/
+static void AdiStreamCopyToUsb(uint8_t *src, uint32_t numBytes, uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer)
+{
+	uint32_t copyBytes;
+
+	/* If the stream channel buffer has not been set, get a new buffer */
+	if(*bufPtr == 0)
+	{
+		AdiStreamGetUsbBuffer(bufPtr, byteCounter, channelBuffer);
+	}
+
+	while(numBytes)
+	{
+		copyBytes = StreamThreadState.BytesPerUsbPacket - *byteCounter;
+		if(copyBytes > numBytes)
+		{
+			copyBytes = numBytes;
+		}
+		CyU3PMemCopy(*bufPtr, src, copyBytes);
+		*bufPtr += copyBytes;
+		*byteCounter += copyBytes;
+		src += copyBytes;
+		numBytes -= copyBytes;
+
+		/* Check if a transmission is needed */
+		if (*byteCounter >= StreamThreadState.BytesPerUsbPacket)
+		{
+			ADI_PROFILE_MARK(ProfilePhaseDma);
+			AdiStreamCommitUsbBuffer(byteCounter, channelBuffer);
+			AdiStreamGetUsbBuffer(bufPtr, byteCounter, channelBuffer);
+			ADI_PROFILE_MARK(ProfilePhaseOther);
+		}
+	}
+}
+
+/**
+  * @brief Places a 64-bit data ready time stamp in the streaming DMA channel.
+  *
+  * @param timestamp The time stamp, from AdiGetStreamTimestamp
+  *
+  * @param bufPtr The calling worker's current position within the streaming DMA buffer
+  *
+  * @param byteCounter The calling worker's count of bytes placed in the current streaming DMA buffer
+  *
+  * @param channelBuffer The calling worker's active streaming DMA buffer structure
+  *
+  * @return void
+  *
+  * The time stamp is written little endian, in 10MHz timer ticks (see S_TO_TICKS_MULT).
+ **/
+static void AdiWriteStreamTimestamp(uint64_t timestamp, uint8_t **bufPtr, uint32_t *byteCounter, CyU3PDmaBuffer_t *channelBuffer)
+{
+	uint8_t timestampBytes[ADI_STREAM_TIMESTAMP_BYTES];
+	uint32_t i;
+
+	for(i = 0; i < ADI_STREAM_TIMESTAMP_BYTES; i++)
+	{
+		timestampBytes[i] = (timestamp >> (8 * i)) & 0xFF;
+	}
+	AdiStreamCopyToUsb(timestampBytes, ADI_STREAM_TIMESTAMP_BYTES, bufPtr, byteCounter, channelBuffer);
+}
@@ -0,0 +1,147 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  * 
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  * 
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  * 
+  * @file		Trace.c
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		This file contains the event trace ring buffer, used to time the stream and USB paths on a running board.
+ **/
+
+#include "Trace.h"
+
+/* Tell the compiler where to find the needed globals */
+extern uint8_t BulkBuffer[12288];
+
+#ifdef TRACE_MODE
+/** Trace ring. Record n is stored at n % ADI_TRACE_RECORDS */
+static TraceRecord TraceRing[ADI_TRACE_RECORDS];
+
+/** Number of records written since the ring was cleared */
+static volatile uint32_t TraceWritten = 0;
+
+/** Set while the ring is copied out, so a record written meanwhile does not tear the copy */
+static volatile CyBool_t TracePaused = CyFalse;
+#endif
+
+/**
+  * @brief Adds a record to the trace ring.
+  *
+  * @param event The event being recorded
+  *
+  * @param arg0 First event argument
+  *
+  * @param arg1 Second event argument
+  *
+  * @return void
+  *
+  * Safe to call from the threads and the ISRs. Interrupts are held off for one timer sample and a 16 byte
+  * store (well under a microsecond), so the ring can stay on in the stream loops. Call through ADI_TRACE,
+  * which compiles to nothing in builds without TRACE_MODE. Records written while the ring is being read
+  * are dropped. The timer is reset by some pin measurement functions, so ticks are only comparable
+  * between nearby records.
+ **/
+void AdiTraceWrite(TraceEvent event, uint32_t arg0, uint32_t arg1)
+{
+#ifdef TRACE_MODE
+	uint32_t intMask;
+	TraceRecord *record;
+
+	intMask = CyU3PVicDisableAllInterrupts();
+	if(!TracePaused)
+	{
+		record = &TraceRing[TraceWritten & (ADI_TRACE_RECORDS - 1)];
+		TraceWritten++;
+		record->Tick = AdiReadStreamTimer();
+		record->Event = event;
+		record->Arg0 = arg0;
+		record->Arg1 = arg1;
+	}
+	CyU3PVicEnableInterrupts(intMask);
+#endif
+}
+
+/**
+  * @brief Handles ADI_READ_TRACE requests. Queues the trace ring read for the command worker thread.
+  *
+  * @param options ADI_READ_TRACE options (ADI_TRACE_CLEAR)
+  *
+  * @param length The number of status bytes to send on the control endpoint
+  *
+  * @return void
+  *
+  * The status is sent on the control endpoint, then AdiSendTrace sends the ring on the bulk endpoint. Builds
+  * without TRACE_MODE return CY_U3P_ERROR_NOT_SUPPORTED on the control endpoint, and nothing on the bulk endpoint.
+ **/
+void AdiReadTrace(uint16_t options, uint16_t length)
+{
+#ifdef TRACE_MODE
+	AdiSendStatus(AdiCommandPost(ADI_READ_TRACE, options, 0), length, CyTrue);
+#else
+	AdiSendStatus(CY_U3P_ERROR_NOT_SUPPORTED, length, CyTrue);
+#endif
+}
+
+/**
+  * @brief Sends the trace ring to the PC. Runs on the command worker thread.
+  *
+  * @param options ADI_READ_TRACE options (ADI_TRACE_CLEAR)
+  *
+  * @return void
+  *
+  * The ring is sent on the bulk endpoint (ChannelToPC): status[0-3], the number of records sent[4-7], the number
+  * of records written since the ring was cleared[8-11] (more than the ring holds means the oldest were overwritten)
+  * and the timer ticks per second[12-15]. The records follow, oldest first, 16 bytes each: tick[0-3], event[4-7]
+  * (TraceEvent), arg0[8-11], arg1[12-15].
+ **/
+void AdiSendTrace(uint16_t options)
+{
+#ifdef TRACE_MODE
+	uint32_t written, numRecords, first, index, value;
+
+	/* Hold off new records while the ring is copied */
+	TracePaused = CyTrue;
+
+	written = TraceWritten;
+	numRecords = written;
+	if(numRecords > ADI_TRACE_RECORDS)
+	{
+		numRecords = ADI_TRACE_RECORDS;
+	}
+	first = written - numRecords;
+	for(index = 0; index < numRecords; index++)
+	{
+		CyU3PMemCopy(BulkBuffer + ADI_TRACE_HEADER_BYTES + (index * sizeof(TraceRecord)),
+				(uint8_t *) &TraceRing[(first + index) & (ADI_TRACE_RECORDS - 1)], sizeof(TraceRecord));
+	}
+	if(options & ADI_TRACE_CLEAR)
+	{
+		TraceWritten = 0;
+	}
+
+	TracePaused = CyFalse;
+
+	BulkBuffer[4] = numRecords & 0xFF;
+	BulkBuffer[5] = (numRecords & 0xFF00) >> 8;
+	BulkBuffer[6] = (numRecords & 0xFF0000) >> 16;
+	BulkBuffer[7] = (numRecords & 0xFF000000) >> 24;
+	BulkBuffer[8] = written & 0xFF;
+	BulkBuffer[9] = (written & 0xFF00) >> 8;
+	BulkBuffer[10] = (written & 0xFF0000) >> 16;
+	BulkBuffer[11] = (written & 0xFF000000) >> 24;
+	value = S_TO_TICKS_MULT;
+	BulkBuffer[12] = value & 0xFF;
+	BulkBuffer[13] = (value & 0xFF00) >> 8;
+	BulkBuffer[14] = (value & 0xFF0000) >> 16;
+	BulkBuffer[15] = (value & 0xFF000000) >> 24;
+
+	AdiReturnBulkEndpointData(CY_U3P_SUCCESS, ADI_TRACE_HEADER_BYTES + (numRecords * sizeof(TraceRecord)));
+#endif
+}
@@ -0,0 +1,107 @@
+/**
+  * Copyright (c) Analog Devices Inc, 2018 - 2020
+  * All Rights Reserved.
+  * 
+  * THIS SOFTWARE UTILIZES LIBRARIES DEVELOPED
+  * AND MAINTAINED BY CYPRESS INC. THE LICENSE INCLUDED IN
+  * THIS REPOSITORY DOES NOT EXTEND TO CYPRESS PROPERTY.
+  * 
+  * Use of this file is governed by the license agreement
+  * included in this repository.
+  * 
+  * @file		Trace.h
+  * @date		10/16/2026
+  * @author		A. Nolan (alex.nolan@analog.com)
+  * @brief		Header file for the event trace ring buffer.
+ **/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/* Include the main header file */
+#include "main.h"
+
+/** Enum for the events recorded in the trace ring. The meaning of the two arguments is listed for each event */
+typedef enum TraceEvent
+{
+	/** Vendor request received on the control endpoint (bRequest, wValue | wIndex << 16) */
+	TraceVendorRequest = 1,
+
+	/** Data ready edge in the GPIO ISR during an interrupt driven stream wait (GPIO id, burst was armed) */
+	TraceDrIsr = 2,
+
+	/** Stream worker starts waiting for a data ready edge (stream type, samples so far) */
+	TraceDrWaitStart = 3,
+
+	/** Stream worker has a data ready edge, and starts the sample (stream type, samples so far) */
+	TraceSampleReady = 4,
+
+	/** Stream worker waits for the PC to free a USB buffer (wait option, buffer waits so far) */
+	TraceUsbWaitStart = 5,
+
+	/** Stream worker done waiting for a USB buffer (status, wait time in ms) */
+	TraceUsbWaitEnd = 6,
+
+	/** USB buffer committed to the streaming endpoint (bytes, buffers committed so far) */
+	TraceUsbCommit = 7,
+
+	/** Stream overflow policy applied (policy, overflow events so far) */
+	TraceUsbOverflow = 8,
+
+	/** SPI, I2C or DMA transfer error in a stream (transfer errors so far, 0) */
+	TraceXferError = 9,
+
+	/** Stream set up (stream type, 0) */
+	TraceStreamStart = 10,
+
+	/** Stream stop requested (status, 0) */
+	TraceStreamStop = 11,
+
+	/** Command worker starts a queued command (request, commands completed so far) */
+	TraceCommandStart = 12,
+
+	/** Command worker finished a command (request, status) */
+	TraceCommandDone = 13
+
+}TraceEvent;
+
+/** @brief One trace ring record. Sent to the PC as is (16 bytes, little endian) */
+typedef struct TraceRecord
+{
+	/** 10MHz timer value when the record was written */
+	uint32_t Tick;
+
+	/** The event (TraceEvent) */
+	uint32_t Event;
+
+	/** First event argument */
+	uint32_t Arg0;
+
+	/** Second event argument */
+	uint32_t Arg1;
+
+}TraceRecord;
+
+/** Number of records in the trace ring. Must be a power of 2 */
+#define ADI_TRACE_RECORDS						(512)
+
+/** Size of the ADI_READ_TRACE bulk endpoint response header (status, records, records written, ticks per second) */
+#define ADI_TRACE_HEADER_BYTES					(16)
+
+/** ADI_READ_TRACE option (wValue): clear the trace ring after it is read */
+#define ADI_TRACE_CLEAR							(1 << 0)
+
+/* Public function prototypes */
+void AdiTraceWrite(TraceEvent event, uint32_t arg0, uint32_t arg1);
+void AdiReadTrace(uint16_t options, uint16_t length);
+void AdiSendTrace(uint16_t options);
+
+/** Adds a record to the trace ring. Compiles to nothing in builds without TRACE_MODE (the arguments are not
+ * evaluated, but still count as used, so a value kept only for the trace does not warn) */
+#ifdef TRACE_MODE
+#define ADI_TRACE(event, arg0, arg1)			AdiTraceWrite((event), (uint32_t) (arg0), (uint32_t) (arg1))
+#else
+#define ADI_TRACE(event, arg0, arg1)			((void) sizeof(arg0), (void) sizeof(arg1))
+#endif
+
+#endif
@@ -56,12 +56,29 @@ CyU3PThread StreamThread;
 /** RTOS thread handle for the main application */
 CyU3PThread AppThread;
 
+/** RTOS thread handle for the vendor command worker */
+CyU3PThread CommandThread;
+
+/** Queue of vendor commands (CommandRequest) for the command worker thread */
+CyU3PQueue CommandQueue;
+
+/** RTOS thread handle for the deferred debug log printer */
+CyU3PThread DebugLogThread;
+
+#ifdef CPU_LOAD_MODE
+/** RTOS thread handle for the CPU load idle thread */
+CyU3PThread CpuLoadThread;
+#endif
+
 /** ADI event structure */
 CyU3PEvent EventHandler;
 
 /** ADI GPIO event structure (RTOS handles GPIO ISR) */
 CyU3PEvent GpioHandler;
 
+/** SPI mutex. Serializes DUT access between the control endpoint handler, the command worker and the AppThread */
+CyU3PMutex SpiMutex;
+
 /*
  * DMA Channel Definitions
  */
@@ -78,6 +95,9 @@ CyU3PDmaChannel ChannelToPC;
 /** DMA channel for reading a memory location into a DMA consumer */
 CyU3PDmaChannel MemoryToSPI;
 
+/** DMA channel for writing peripheral (SPI or I2C) receive data to a memory location during a stream */
+CyU3PDmaChannel StreamRxChannel;
+
 /*
  * Buffer Definitions
  */
@@ -94,6 +114,9 @@ CyU3PDmaBuffer_t ManualDMABuffer;
 /** DMA buffer structure for SPI transmit */
 CyU3PDmaBuffer_t SpiDmaBuffer;
 
+/** DMA buffer structure for stream receive data (StreamRxChannel) */
+CyU3PDmaBuffer_t StreamRxDmaBuffer;
+
 /*
  * Application constants
  */
@@ -121,6 +144,9 @@ volatile CyBool_t KillStreamEarly = CyFalse;
 /** Struct of data used to synchronize the data streaming / app threads */
 StreamState StreamThreadState;
 
+/** Command worker thread state (running command, queue counters, cancel request) */
+CommandState CommandThreadState;
+
 /**
   * @brief This is the main entry point function for the iSensor FX3 application firmware.
   *
@@ -235,26 +261,49 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
     {
         isHandled = CyTrue;
 
+        ADI_TRACE(TraceVendorRequest, bRequest, wValue | (wIndex << 16));
+
 #ifdef VERBOSE_MODE
-        CyU3PDebugPrint (4, "Vendor request = 0x%x\r\n", bRequest);
+        ADI_LOG("Vendor request = 0x%x\r\n", bRequest);
 #endif
 
         switch (bRequest)
         {
         	/* Special command to trigger a data capture and measure the corresponding busy pulse. This
-        	 * feature is most useful for ADcmXL products, but can be used for any product */
+        	 * feature is most useful for ADcmXL products, but can be used for any product. Run by the
+        	 * command worker thread */
         	case ADI_BUSY_MEASURE:
-        		status = AdiMeasureBusyPulse(wLength);
+        		status = AdiCommandQueue(bRequest, wValue, wIndex, wLength);
         		break;
 
-        	/* Read single word for IRegInterface */
+        	/* Read single word for IRegInterface. Stalled if a DUT access is running on another thread */
         	case ADI_READ_BYTES:
-        		status = AdiReadRegBytes(wIndex);
+        		status = AdiSpiTryLock();
+        		if(status == CY_U3P_SUCCESS)
+        		{
+        			status = AdiReadRegBytes(wIndex);
+        			AdiSpiUnlock();
+        		}
+        		break;
+
+        	/* Read a list of registers (full duplex), wValue set for a paged DUT */
+        	case ADI_READ_REG_LIST:
+        		if(wLength > ADI_REG_LIST_MAX_LENGTH)
+        		{
+        			status = CY_U3P_ERROR_BAD_ARGUMENT;
+        			break;
+        		}
+        		status = AdiCommandQueue(bRequest, wValue, wIndex, wLength);
         		break;
 
-        	/* Write single byte for IRegInterface */
+        	/* Write single byte for IRegInterface. Stalled if a DUT access is running on another thread */
         	case ADI_WRITE_BYTE:
-        		status = AdiWriteRegByte(wIndex, wValue & 0xFF);
+        		status = AdiSpiTryLock();
+        		if(status == CY_U3P_SUCCESS)
+        		{
+        			status = AdiWriteRegByte(wIndex, wValue & 0xFF);
+        			AdiSpiUnlock();
+        		}
         		break;
 
         	/* Set the application boot time */
@@ -265,24 +314,19 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
         		FX3State.BootTime |= (USBBuffer[2] << 16);
         		FX3State.BootTime |= (USBBuffer[3] << 24);
 #ifdef VERBOSE_MODE
-            	CyU3PDebugPrint (4, "Boot Time Stamp: %d\r\n", FX3State.BootTime);
+            	ADI_LOG("Boot Time Stamp: %d\r\n", FX3State.BootTime);
 #endif
         		break;
 
         	/* Pulse drive for a specified amount of time */
         	case ADI_PULSE_DRIVE:
-        		/* Read config data into USBBuffer */
-        		status = CyU3PUsbGetEP0Data(wLength, USBBuffer, bytesRead);
-        		/* Run pulse drive function */
-        		status |= AdiPulseDrive();
-        		/* Send back status over the BULK-In endpoint */
-        		AdiSendStatus(status, 4, CyFalse);
+        		status = AdiCommandQueue(bRequest, wValue, wIndex, wLength);
         		break;
 
         	/* Wait on an edge, with timeout */
         	case ADI_PULSE_WAIT:
-        		/* Run pulse wait function */
-        		status = AdiPulseWait(wLength);
+        		/* Queue pulse wait function for the command worker thread */
+        		status = AdiCommandQueue(bRequest, wValue, wIndex, wLength);
         		break;
 
         	/* Set a pin value */
@@ -337,7 +381,13 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
 
             /* Set the SPI config */
             case ADI_SET_SPI_CONFIG:
-            	isHandled = AdiSpiUpdate(wIndex, wValue, wLength);
+            	/* Don't change the SPI config under a DUT access running on another thread (stalled instead) */
+            	status = AdiSpiTryLock();
+            	if(status == CY_U3P_SUCCESS)
+            	{
+            		isHandled = AdiSpiUpdate(wIndex, wValue, wLength);
+            		AdiSpiUnlock();
+            	}
             	break;
 
             /* Read a GPIO pin specified by index */
@@ -347,7 +397,7 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
 
             /* Measure pin delay */
             case ADI_PIN_DELAY_MEASURE:
-            	status = AdiMeasurePinDelay(wLength);
+            	status = AdiCommandQueue(bRequest, wValue, wIndex, wLength);
             	break;
 
             /* Read the current SPI config */
@@ -387,12 +437,43 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
             	status = CyU3PUsbSendEP0Data(wLength, USBBuffer);
             	break;
 
+            /* Get the stream profile counters */
+            case ADI_GET_STREAM_PROFILE:
+            	AdiGetStreamProfile();
+            	break;
+
+            /* Get the data ready latency for the last interrupt driven stream */
+            case ADI_GET_DR_LATENCY:
+            	AdiGetDataReadyLatency();
+            	break;
+
+            /* Get the runtime counters for the active or last stream */
+            case ADI_GET_STREAM_STATS:
+            	AdiGetStreamStats();
+            	break;
+
+            /* Run an SPI register script on the command worker thread */
+            case ADI_RUN_SPI_SCRIPT:
+            	if(wLength > ADI_SCRIPT_MAX_LENGTH)
+            	{
+            		status = CY_U3P_ERROR_BAD_ARGUMENT;
+            		break;
+            	}
+            	status = AdiCommandQueue(bRequest, wValue, wIndex, wLength);
+            	break;
+
             /* Generic stream is a register stream triggered on data ready */
             case ADI_STREAM_GENERIC_DATA:
             	/* Start, stop, async stop depending on index */
             	switch(wIndex)
             	{
             	case ADI_STREAM_START_CMD:
+            		/* Only one stream or SPI pipe can run at a time */
+            		if(AdiStreamBusy())
+            		{
+            			status = CY_U3P_ERROR_ALREADY_STARTED;
+            			break;
+            		}
             		/* Get the data from the control endpoint */
             		status = CyU3PUsbGetEP0Data(wLength, USBBuffer, bytesRead);
             		/* Set the generic stream start event */
@@ -425,6 +506,12 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
             	switch(wIndex)
             	{
             	case ADI_STREAM_START_CMD:
+            		/* Only one stream or SPI pipe can run at a time */
+            		if(AdiStreamBusy())
+            		{
+            			status = CY_U3P_ERROR_ALREADY_STARTED;
+            			break;
+            		}
             		/* Set USB transfer length */
             		StreamThreadState.TransferWordLength = wLength;
             		/* Set event handler */
@@ -456,6 +543,12 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
 				switch(wIndex)
 				{
 				case ADI_STREAM_START_CMD:
+					/* Only one stream or SPI pipe can run at a time */
+					if(AdiStreamBusy())
+					{
+						status = CY_U3P_ERROR_ALREADY_STARTED;
+						break;
+					}
 					StreamThreadState.PinExitEnable = (CyBool_t) wValue;
 					status = CyU3PEventSet(&EventHandler, ADI_RT_STREAM_START, CYU3P_EVENT_OR);
 					break;
@@ -484,6 +577,12 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
 				switch(wIndex)
 				{
 				case ADI_STREAM_START_CMD:
+					/* Only one stream or SPI pipe can run at a time */
+					if(AdiStreamBusy())
+					{
+						status = CY_U3P_ERROR_ALREADY_STARTED;
+						break;
+					}
 					status = CyU3PEventSet(&EventHandler, ADI_TRANSFER_STREAM_START, CYU3P_EVENT_OR);
 					StreamThreadState.TransferByteLength = wLength;
 					break;
@@ -507,12 +606,122 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
 				}
 				break;
 
+			/* SPI pipe, bulk endpoint to SPI to streaming endpoint */
+			case ADI_SPI_PIPE:
+				switch(wIndex)
+				{
+				case ADI_STREAM_START_CMD:
+					/* Refused starts stall, so the PC does not send the MOSI data */
+					status = AdiSpiPipeRequest(wLength);
+					break;
+				case ADI_SPI_PIPE_STATUS_CMD:
+					AdiGetSpiPipeStatus();
+					break;
+				case ADI_STREAM_DONE_CMD:
+				case ADI_STREAM_STOP_CMD:
+            		/* Get the data from the control endpoint */
+            		status = CyU3PUsbGetEP0Data(wLength, USBBuffer, bytesRead);
+            		/* Set pipe done event */
+					status |= CyU3PEventSet(&EventHandler, ADI_SPI_PIPE_DONE, CYU3P_EVENT_OR);
+					break;
+				default:
+					/* Shouldn't get here */
+					isHandled = CyFalse;
+					break;
+				}
+				if (status != CY_U3P_SUCCESS)
+				{
+					AdiLogError(Main_c, __LINE__, status);
+				}
+				break;
+
+			/* Pre-trigger capture for burst and generic streams */
+			case ADI_TRIGGER_CAPTURE:
+				switch(wIndex)
+				{
+				case ADI_CAPTURE_CONFIG_CMD:
+					status = AdiCaptureConfigure(wLength);
+					break;
+				case ADI_CAPTURE_TRIGGER_CMD:
+					StreamThreadState.CaptureHostTrigger = CyTrue;
+					AdiSendStatus(status, wLength, CyTrue);
+					break;
+				case ADI_CAPTURE_STATUS_CMD:
+					AdiGetCaptureStatus();
+					break;
+				default:
+					/* Shouldn't get here */
+					isHandled = CyFalse;
+					break;
+				}
+				if (status != CY_U3P_SUCCESS)
+				{
+					AdiLogError(Main_c, __LINE__, status);
+				}
+				break;
+
+			/* Logic analyzer stream start/done/cancel */
+			case ADI_LOGIC_ANALYZER_STREAM:
+				switch(wIndex)
+				{
+				case ADI_STREAM_START_CMD:
+					/* Only one stream or SPI pipe can run at a time */
+					if(AdiStreamBusy())
+					{
+						status = CY_U3P_ERROR_ALREADY_STARTED;
+						break;
+					}
+					status = CyU3PEventSet(&EventHandler, ADI_LOGIC_STREAM_START, CYU3P_EVENT_OR);
+					break;
+				case ADI_STREAM_DONE_CMD:
+					/* Get the data from the control endpoint */
+					status = CyU3PUsbGetEP0Data(wLength, USBBuffer, bytesRead);
+					/* Set stream done event */
+					status |= CyU3PEventSet(&EventHandler, ADI_LOGIC_STREAM_DONE, CYU3P_EVENT_OR);
+					break;
+				case ADI_STREAM_STOP_CMD:
+					status = CyU3PEventSet(&EventHandler, ADI_LOGIC_STREAM_STOP, CYU3P_EVENT_OR);
+					break;
+				default:
+					/* Shouldn't get here */
+					isHandled = CyFalse;
+					break;
+				}
+				if (status != CY_U3P_SUCCESS)
+				{
+					AdiLogError(Main_c, __LINE__, status);
+				}
+				break;
+
 			/* Get the measured DR frequency */
             case ADI_MEASURE_DR:
-            	/* Read config data into USBBuffer */
-				status = CyU3PUsbGetEP0Data(wLength, USBBuffer, bytesRead);
-				/* Run pulse drive function */
-				status |= AdiMeasurePinFreq();
+            	/* Queue the measurement for the command worker thread */
+				status = AdiCommandQueue(bRequest, wValue, wIndex, wLength);
+				break;
+
+			/* Get the period of every data ready edge */
+            case ADI_MEASURE_DR_PERIODS:
+				status = AdiCommandQueue(bRequest, wValue, wIndex, wLength);
+				break;
+
+			/* Command worker thread query / cancel */
+			case ADI_COMMAND_CONTROL:
+				status = AdiCommandControl(wValue, wLength);
+				break;
+
+			/* Read the event trace ring */
+			case ADI_READ_TRACE:
+				AdiReadTrace(wValue, wLength);
+				break;
+
+			/* Read the deferred debug log */
+			case ADI_READ_DEBUG_LOG:
+				AdiReadDebugLog(wLength);
+				break;
+
+			/* Get the CPU load and thread run times */
+			case ADI_GET_CPU_LOAD:
+				AdiGetCpuLoad(wValue);
 				break;
 
 			/* PWM configuration */
@@ -526,22 +735,35 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
             /* 1-4 byte single transfer */
             case ADI_TRANSFER_BYTES:
             	/* Call the transfer bytes function
-            	 * upper 2 write bytes are passed in wIndex, lower are passed in wValue */
+            	 * upper 2 write bytes are passed in wIndex, lower are passed in wValue. Stalled if a DUT access is
+            	 * running on another thread */
+            	status = AdiSpiTryLock();
+            	if(status != CY_U3P_SUCCESS)
+            	{
+            		break;
+            	}
             	status = AdiTransferBytes(wIndex << 16 | wValue);
+            	AdiSpiUnlock();
             	/* Send status and 4 bytes data back */
             	AdiSendStatus(status, 8, CyTrue);
             	break;
 
             /* Bit bang SPI transfer handler */
             case ADI_BITBANG_SPI:
-            	/* Call the handler function for the SPI bit bang. Returns data to PC over bulk endpoint */
-            	status = CyU3PUsbGetEP0Data(wLength, USBBuffer, bytesRead);
-            	status |= AdiBitBangSpiHandler();
+            	/* Queue the SPI bit bang for the command worker thread. Returns data to PC over bulk endpoint */
+            	status = AdiCommandQueue(bRequest, wValue, wIndex, wLength);
             	break;
 
             /* Reset SPI peripheral (to recover from using bit bang SPI) */
             case ADI_RESET_SPI:
+            	/* Stalled if a DUT access is running on another thread */
+            	status = AdiSpiTryLock();
+            	if(status != CY_U3P_SUCCESS)
+            	{
+            		break;
+            	}
             	status = AdiRestartSpi();
+            	AdiSpiUnlock();
             	/* Return the status over control endpoint */
             	AdiSendStatus(status, wLength, CyTrue);
             	break;
@@ -577,16 +799,10 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
 				AdiSendStatus(status, wLength, CyTrue);
 				break;
 
-			/* I2C single read */
+			/* I2C single read and write, run by the command worker thread */
 			case ADI_I2C_READ_BYTES:
-				status = AdiI2CReadHandler(wLength);
-				break;
-
-			/* I2C single write */
 			case ADI_I2C_WRITE_BYTES:
-				status = AdiI2CWriteHandler(wLength);
-				/* Send back status indicating operation is done */
-				AdiSendStatus(status, 4, CyFalse);
+				status = AdiCommandQueue(bRequest, wValue, wIndex, wLength);
 				break;
 
 			/* I2C read stream start/done/cancel */
@@ -594,6 +810,12 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
 				switch(wIndex)
 				{
 				case ADI_STREAM_START_CMD:
+					/* Only one stream or SPI pipe can run at a time */
+					if(AdiStreamBusy())
+					{
+						status = CY_U3P_ERROR_ALREADY_STARTED;
+						break;
+					}
 					status = CyU3PEventSet(&EventHandler, ADI_I2C_STREAM_START, CYU3P_EVENT_OR);
 					StreamThreadState.TransferByteLength = wLength;
 					break;
@@ -625,7 +847,7 @@ CyBool_t AdiControlEndpointHandler (uint32_t setupdat0, uint32_t setupdat1)
             default:
                 /* This is an unknown request */
 #ifdef VERBOSE_MODE
-            	CyU3PDebugPrint (4, "ERROR: Un-handled vendor command 0x%x\r\n", bRequest);
+            	ADI_LOG("ERROR: Un-handled vendor command 0x%x\r\n", bRequest);
 #endif
                 isHandled = CyFalse;
                 break;
@@ -705,6 +927,13 @@ void AdiUSBEventHandler (CyU3PUsbEventType_t evtype, uint16_t evdata)
         	AdiAppStart();
             break;
 
+        case CY_U3P_USB_EVENT_USB3_LNKFAIL:
+        	/* The USB driver retries the connection at high speed. The streams pick up the speed in AdiAppStart */
+#ifdef VERBOSE_MODE
+        	ADI_LOG("USB 3.0 link failed, falling back to USB 2.0\r\n");
+#endif
+            break;
+
         case CY_U3P_USB_EVENT_RESET:
         case CY_U3P_USB_EVENT_DISCONNECT:
         	/* Stop the application */
@@ -747,6 +976,33 @@ void AdiGPIOEventHandler(uint8_t gpioId)
 {
 	CyU3PReturnStatus_t status = CY_U3P_SUCCESS;
 	CyBool_t gpioValue = CyFalse;
+
+	/* Data ready edge during an interrupt driven stream wait. Time stamp it and wake the stream thread */
+	if(StreamThreadState.DrInterruptWait && (gpioId == FX3State.DrPin))
+	{
+		/* An armed burst only needs the SPI block enabled, so start it before anything else */
+		if(StreamThreadState.BurstArmed)
+		{
+			SPI->lpp_spi_config |= CY_U3P_LPP_SPI_ENABLE;
+			StreamThreadState.BurstArmed = CyFalse;
+			ADI_TRACE(TraceDrIsr, gpioId, CyTrue);
+		}
+		else
+		{
+			ADI_TRACE(TraceDrIsr, gpioId, CyFalse);
+		}
+		StreamThreadState.DrEdgeTime = AdiReadStreamTimer();
+		CyU3PEventSet(&EventHandler, ADI_DATA_READY_INTERRUPT, CYU3P_EVENT_OR);
+		return;
+	}
+
+	/* Capture trigger pin edge. The ISR clears the pin interrupt status, so latch the edge for the stream thread */
+	if(StreamThreadState.CaptureActive && (FX3State.Capture.TriggerSource == ADI_CAPTURE_TRIGGER_PIN) && (gpioId == FX3State.Capture.TriggerPin))
+	{
+		StreamThreadState.CaptureEdgeSeen = CyTrue;
+		return;
+	}
+
 	status = CyU3PGpioGetValue (gpioId, &gpioValue);
     if (status == CY_U3P_SUCCESS)
     {
@@ -817,11 +1073,14 @@ void AdiAppErrorHandler (CyU3PReturnStatus_t status)
  **/
 void AdiAppStop()
 {
-	CyU3PDebugPrint (4, "Application stopping!\r\n");
+	ADI_LOG("Application stopping!\r\n");
 
 	/* Signal that the app thread has been stopped */
 	FX3State.AppActive = CyFalse;
 
+	/* Stop any command worker operation early, since its endpoint is going away */
+	CommandThreadState.Cancel = CyTrue;
+
     /* De-init flash memory */
     AdiFlashDeInit();
 
@@ -844,8 +1103,9 @@ void AdiAppStop()
 	CyU3PUsbFlushEp(ADI_TO_PC_ENDPOINT);
 
 	/* Clean up DMAs */
-	CyU3PDmaChannelDestroy(&ChannelFromPC);
+	AdiBulkCommandChannelDestroy();
 	CyU3PDmaChannelDestroy(&ChannelToPC);
+	AdiStreamDmaPoolFlush();
 
 	/* Disable endpoints */
 	CyU3PEpConfig_t epConfig;
@@ -884,17 +1144,17 @@ void AdiAppStart()
     {
         case CY_U3P_FULL_SPEED:
         	FX3State.UsbBufferSize = 64;
-            CyU3PDebugPrint (4, "Connected at USB 1.0 speed.\r\n");
+            ADI_LOG("Connected at USB 1.0 speed.\r\n");
             break;
 
         case CY_U3P_HIGH_SPEED:
         	FX3State.UsbBufferSize = 512;
-            CyU3PDebugPrint (4, "Connected at USB 2.0 speed.\r\n");
+            ADI_LOG("Connected at USB 2.0 speed.\r\n");
             break;
 
         case  CY_U3P_SUPER_SPEED:
         	FX3State.UsbBufferSize = 1024;
-            CyU3PDebugPrint (4, "Connected at USB 3.0 speed.\r\n");
+            ADI_LOG("Connected at USB 3.0 speed.\r\n");
             break;
 
         default:
@@ -904,6 +1164,13 @@ void AdiAppStart()
             break;
     }
 
+    /* Streams which DMA straight to USB use buffers sized for a full streaming endpoint burst */
+    FX3State.StreamDmaBufferSize = FX3State.UsbBufferSize;
+    if(usbSpeed == CY_U3P_SUPER_SPEED)
+    {
+    	FX3State.StreamDmaBufferSize = FX3State.UsbBufferSize * CY_FX_BULK_BURST;
+    }
+
     /* Configure GPIO for ADI application */
 
 	/* SYS_CLK = 403.2MHz
@@ -1160,6 +1427,29 @@ void AdiAppStart()
     /* Set the data ready polarity */
     FX3State.DrPolarity = CyTrue;
 
+    /* Poll the data ready pin in the stream workers (lowest latency) */
+    FX3State.DrInterruptMode = CyFalse;
+
+    /* Stream output does not include sample time stamps */
+    FX3State.StreamTimestamps = CyFalse;
+
+    /* Stream output is not framed */
+    FX3State.StreamFrameMode = ADI_STREAM_FRAME_OFF;
+
+    /* Send every PAGE_ID write to the DUT */
+    FX3State.PageCacheEnabled = CyFalse;
+    FX3State.CurrentPage = ADI_PAGE_UNKNOWN;
+
+    /* Stream one USB packet per CPU filled DMA buffer */
+    FX3State.StreamBufferPackets = 1;
+
+    /* Streams wait for the PC to free USB buffers */
+    FX3State.StreamOverflowPolicy = ADI_STREAM_OVERFLOW_BLOCK;
+    FX3State.StreamOverflowWaitMs = ADI_STREAM_OVERFLOW_WAIT_MS;
+
+    /* No pre-trigger capture */
+    CyU3PMemSet((uint8_t *)&FX3State.Capture, 0, sizeof(FX3State.Capture));
+
     /* Configure default global SPI parameters */
     CyU3PMemSet ((uint8_t *)&FX3State.SpiConfig, 0, sizeof(FX3State.SpiConfig));
     FX3State.SpiConfig.isLsbFirst = CyFalse;
@@ -1222,13 +1512,18 @@ void AdiAppStart()
 	epConfig.pcktSize = FX3State.UsbBufferSize;
 	epConfig.streams = 0;
 
-	/* Set endpoint config for RTS endpoint */
+	/* Set endpoint config for RTS endpoint. Burst multiple packets on a SuperSpeed link */
+	if(usbSpeed == CY_U3P_SUPER_SPEED)
+	{
+		epConfig.burstLen = CY_FX_BULK_BURST;
+	}
 	status = CyU3PSetEpConfig(ADI_STREAMING_ENDPOINT, &epConfig);
     if (status != CY_U3P_SUCCESS)
     {
     	AdiLogError(Main_c, __LINE__, status);
     	AdiAppErrorHandler(status);
     }
+	epConfig.burstLen = 1;
 
 	/* Set endpoint config for the PC to FX3 endpoint */
 	status = CyU3PSetEpConfig(ADI_FROM_PC_ENDPOINT, &epConfig);
@@ -1264,11 +1559,8 @@ void AdiAppStart()
     dmaConfig.cb             	= NULL;
     dmaConfig.prodAvailCount 	= 0;
 
-    /* Configure DMA for ChannelFromPC */
-    dmaConfig.prodSckId = CY_U3P_UIB_SOCKET_PROD_1;
-    dmaConfig.consSckId = CY_U3P_CPU_SOCKET_CONS;
-
-    status = CyU3PDmaChannelCreate(&ChannelFromPC, CY_U3P_DMA_TYPE_MANUAL_IN, &dmaConfig);
+    /* Configure DMA for ChannelFromPC (bulk command requests) */
+    status = AdiBulkCommandChannelCreate();
     if (status != CY_U3P_SUCCESS)
     {
     	AdiLogError(Main_c, __LINE__, status);
@@ -1384,8 +1676,10 @@ FX3BoardType AdiGetFX3BoardType()
   * @brief This function is called by the RTOS kernel after booting and creates all the user threads.
   *
   * After the ThreadX kernel is started by a call to CyU3PKernelEntry() in main, this function is called.
-  * It creates the AppThread (for general execution / handling vendor requests) and the StreamThread for
-  * handling high throughput data streaming from a DUT.
+  * It creates the AppThread (for general execution / handling vendor requests), the StreamThread for
+  * handling high throughput data streaming from a DUT, the CommandThread (with its queue) for
+  * long vendor commands, the DebugLogThread which prints deferred debug messages, and (in CPU_LOAD_MODE
+  * builds) the CpuLoadThread which measures the CPU load.
  **/
 void CyFxApplicationDefine (void)
 {
@@ -1441,4 +1735,97 @@ void CyFxApplicationDefine (void)
     	/* Thread creation failed. Fatal error. Cannot continue. */
     	while(1);
     }
+
+    /* Create the command queue, before the thread which reads it */
+    ptr = CyU3PMemAlloc (ADI_COMMAND_QUEUE_DEPTH * sizeof(CommandRequest));
+    if (CyU3PQueueCreate (&CommandQueue, ADI_COMMAND_MSG_WORDS, ptr, ADI_COMMAND_QUEUE_DEPTH * sizeof(CommandRequest)) != CY_U3P_SUCCESS)
+    {
+    	/* Queue creation failed. Fatal error. Cannot continue. */
+    	while(1);
+    }
+
+    /* Create the SPI mutex once, before anything can access the DUT. It outlives AdiAppStop, which may run while
+     * the command worker holds it */
+    if (CyU3PMutexCreate (&SpiMutex, CYU3P_INHERIT) != CY_U3P_SUCCESS)
+    {
+    	/* Mutex creation failed. Fatal error. Cannot continue. */
+    	while(1);
+    }
+
+    /* Create the thread for long vendor commands */
+    ptr = CyU3PMemAlloc (COMMANDTHREAD_STACK);
+
+    /* Create the command worker thread */
+    retThrdCreate = CyU3PThreadCreate (&CommandThread, 	/* Thread structure. */
+            "23:CommandThread",                 		/* Thread ID and name. */
+            AdiCommandThreadEntry,              		/* Thread entry function. */
+            0,                                     		/* Thread input parameter. */
+            ptr,                                   		/* Pointer to the allocated thread stack. */
+            COMMANDTHREAD_STACK,                       	/* Allocated thread stack size. */
+            COMMANDTHREAD_PRIORITY,                    	/* Thread priority. */
+            COMMANDTHREAD_PRIORITY,                    	/* Thread pre-emption threshold: No preemption. */
+            CYU3P_NO_TIME_SLICE,                   		/* No time slice. Thread will run until task is
+                                                      	 completed or until the higher priority
+                                                      	 thread gets active. */
+            CYU3P_AUTO_START                      		/* Start the thread immediately. */
+            );
+
+    /* Check if creating thread succeeded */
+    if (retThrdCreate != CY_U3P_SUCCESS)
+    {
+    	/* Thread creation failed. Fatal error. Cannot continue. */
+    	while(1);
+    }
+
+    /* Create the thread which prints the deferred debug log */
+    ptr = CyU3PMemAlloc (DEBUGLOGTHREAD_STACK);
+
+    /* Create the debug log thread */
+    retThrdCreate = CyU3PThreadCreate (&DebugLogThread, 	/* Thread structure. */
+            "24:DebugLogThread",                 		/* Thread ID and name. */
+            AdiDebugLogThreadEntry,              		/* Thread entry function. */
+            0,                                     		/* Thread input parameter. */
+            ptr,                                   		/* Pointer to the allocated thread stack. */
+            DEBUGLOGTHREAD_STACK,                       	/* Allocated thread stack size. */
+            DEBUGLOGTHREAD_PRIORITY,                    	/* Thread priority. */
+            DEBUGLOGTHREAD_PRIORITY,                    	/* Thread pre-emption threshold: No preemption. */
+            CYU3P_NO_TIME_SLICE,                   		/* No time slice. Thread will run until task is
+                                                      	 completed or until the higher priority
+                                                      	 thread gets active. */
+            CYU3P_AUTO_START                      		/* Start the thread immediately. */
+            );
+
+    /* Check if creating thread succeeded */
+    if (retThrdCreate != CY_U3P_SUCCESS)
+    {
+    	/* Thread creation failed. Fatal error. Cannot continue. */
+    	while(1);
+    }
+
+#ifdef CPU_LOAD_MODE
+    /* Create the idle thread for CPU load measurement */
+    ptr = CyU3PMemAlloc (CPULOADTHREAD_STACK);
+
+    /* Create the CPU load thread */
+    retThrdCreate = CyU3PThreadCreate (&CpuLoadThread, 	/* Thread structure. */
+            "25:CpuLoadThread",                 		/* Thread ID and name. */
+            AdiCpuLoadThreadEntry,              		/* Thread entry function. */
+            0,                                     		/* Thread input parameter. */
+            ptr,                                   		/* Pointer to the allocated thread stack. */
+            CPULOADTHREAD_STACK,                       	/* Allocated thread stack size. */
+            CPULOADTHREAD_PRIORITY,                    	/* Thread priority. */
+            CPULOADTHREAD_PRIORITY,                    	/* Thread pre-emption threshold: No preemption. */
+            CYU3P_NO_TIME_SLICE,                   		/* No time slice. Thread will run until task is
+                                                      	 completed or until the higher priority
+                                                      	 thread gets active. */
+            CYU3P_AUTO_START                      		/* Start the thread immediately. */
+            );
+
+    /* Check if creating thread succeeded */
+    if (retThrdCreate != CY_U3P_SUCCESS)
+    {
+    	/* Thread creation failed. Fatal error. Cannot continue. */
+    	while(1);
+    }
+#endif
 }
@@ -25,6 +25,30 @@
  */
 //#define VERBOSE_MODE									(0)
 
+/*
+ * This macro is used to enable stream profiling (StreamProfile.c) during compile time.
+ * Adds timer samples to the stream workers. Ensure that it is commented out for release versions.
+ */
+//#define STREAM_PROFILE_MODE							(0)
+
+/*
+ * This macro is used to enable the event trace ring (Trace.c) during compile time.
+ * Adds a timer sample and a record store to each trace point. Ensure that it is commented out for release versions.
+ */
+//#define TRACE_MODE									(0)
+
+/*
+ * This macro is used to enable the CPU load measurement (CpuLoad.c) during compile time.
+ * Adds a lowest priority spinning idle thread and a 1ms sampling timer. Ensure that it is commented out for release versions.
+ */
+//#define CPU_LOAD_MODE									(0)
+
+/*
+ * This macro is used to enable USB 3.0 (SuperSpeed) connections during compile time.
+ * Without it the FX3 always connects at USB 2.0 high speed, for better compatibility.
+ */
+//#define SUPERSPEED_MODE								(0)
+
 /* Include all needed Cypress libraries */
 #include "cyu3types.h"
 #include "cyu3usbconst.h"
@@ -54,6 +78,13 @@
 #include "ErrorLog.h"
 #include "I2cFunctions.h"
 #include "HelperFunctions.h"
+#include "StreamProfile.h"
+#include "BulkCommands.h"
+#include "SpiScript.h"
+#include "CommandThread.h"
+#include "Trace.h"
+#include "DebugLog.h"
+#include "CpuLoad.h"
 
 /* Lower level register access includes */
 #include "gpio_regs.h"
@@ -143,6 +174,35 @@ typedef struct FX3PinMap
 	uint16_t FX3_PIN_GPIO4;
 }FX3PinMap;
 
+/** @brief Struct to store the pre-trigger capture settings for burst and generic streams */
+typedef struct CaptureConfig
+{
+	/** Number of samples kept from before the trigger sample */
+	uint32_t PreSamples;
+
+	/** Number of samples kept from the trigger sample on. Capture is disabled when 0 */
+	uint32_t PostSamples;
+
+	/** Capture trigger source (ADI_CAPTURE_TRIGGER_*) */
+	uint8_t TriggerSource;
+
+	/** FX3 GPIO number of the trigger pin, for ADI_CAPTURE_TRIGGER_PIN */
+	uint8_t TriggerPin;
+
+	/** Trigger direction. True fires on a rising edge or crossing, False on a falling edge or crossing */
+	CyBool_t TriggerPolarity;
+
+	/** Threshold word options (ADI_CAPTURE_THRESHOLD_*) */
+	uint8_t ThresholdFlags;
+
+	/** Byte offset of the threshold word within the sample data (after any time stamp) */
+	uint16_t ThresholdOffset;
+
+	/** Threshold the sample word must cross, for ADI_CAPTURE_TRIGGER_THRESHOLD */
+	uint16_t ThresholdValue;
+
+}CaptureConfig;
+
 /** @brief Struct to store the current board state (SPI config, USB speed, etc) */
 typedef struct BoardState
 {
@@ -155,6 +215,9 @@ typedef struct BoardState
 	/** Track the USB buffer size for the current USB speed setting*/
 	uint16_t UsbBufferSize;
 
+	/** DMA buffer size for streams which DMA straight to USB (one full streaming endpoint burst) */
+	uint16_t StreamDmaBufferSize;
+
 	/** Track main application execution state*/
 	CyBool_t AppActive;
 
@@ -176,6 +239,33 @@ typedef struct BoardState
 	/** Track data ready polarity (True = trigger on rising edge, False = trigger on falling edge) */
 	CyBool_t DrPolarity;
 
+	/** Track if stream workers wait for data ready using the GPIO ISR (True) or by polling the pin (False) */
+	CyBool_t DrInterruptMode;
+
+	/** Track if stream samples are prefixed with a 64-bit data ready time stamp (True) or not (False) */
+	CyBool_t StreamTimestamps;
+
+	/** Stream frame header mode (ADI_STREAM_FRAME_OFF, ADI_STREAM_FRAME_ON or ADI_STREAM_FRAME_CRC) */
+	uint16_t StreamFrameMode;
+
+	/** Track if redundant PAGE_ID writes to a paged DUT are skipped (True) or always sent (False) */
+	CyBool_t PageCacheEnabled;
+
+	/** Last page written to the DUT PAGE_ID register, or ADI_PAGE_UNKNOWN */
+	uint16_t CurrentPage;
+
+	/** Number of USB packets aggregated in each streaming DMA buffer filled by the CPU. 1 commits full size single packet buffers */
+	uint16_t StreamBufferPackets;
+
+	/** Stream behavior when the PC does not free USB buffers in time (ADI_STREAM_OVERFLOW_*) */
+	uint16_t StreamOverflowPolicy;
+
+	/** Time to wait for a free USB buffer before the stream overflow policy drops samples, in ms */
+	uint16_t StreamOverflowWaitMs;
+
+	/** Pre-trigger capture settings, applied to the next burst or generic stream */
+	CaptureConfig Capture;
+
 	/** Track if the watchdog timer is enabled */
 	CyBool_t WatchDogEnabled;
 
@@ -202,6 +292,56 @@ typedef struct BoardState
 
 }BoardState;
 
+/** Number of bins in the stream USB buffer occupancy histogram (last bin holds everything above) */
+#define ADI_STREAM_OCCUPANCY_BINS				(16)
+
+/** Number of committed USB buffers tracked for the drop oldest stream overflow policy */
+#define ADI_STREAM_COMMIT_HISTORY				(64)
+
+/** @brief Struct to store the runtime counters for the active (or last) data stream */
+typedef struct StreamStats
+{
+	/** Track if the counters are for a running stream (True) or the last stream, which has finished (False) */
+	CyBool_t Active;
+
+	/** Number of samples started (data ready edges, or stream buffers if data ready is not used) */
+	uint32_t Samples;
+
+	/** Number of USB buffers sent to the PC */
+	uint32_t BuffersCommitted;
+
+	/** Number of times the stream thread had to wait for the PC to free a USB buffer */
+	uint32_t BufferWaits;
+
+	/** Total time the stream thread spent waiting for the PC to free a USB buffer, in ms */
+	uint32_t BufferWaitMs;
+
+	/** Number of data ready edges which arrived while the previous sample was still being processed */
+	uint32_t DrMissed;
+
+	/** Number of SPI, I2C or DMA transfer errors */
+	uint32_t XferErrors;
+
+	/** Histogram of the number of USB buffers waiting to be read by the PC */
+	uint32_t Occupancy[ADI_STREAM_OCCUPANCY_BINS];
+
+	/** Number of times the stream overflow policy started dropping samples */
+	uint32_t OverflowEvents;
+
+	/** Number of USB buffers dropped by the stream overflow policy */
+	uint32_t DroppedBuffers;
+
+	/** Number of samples dropped by the stream overflow policy */
+	uint32_t DroppedSamples;
+
+	/** Index (count of samples before it) of the first sample in the most recent gap */
+	uint32_t LastGapStart;
+
+	/** Number of samples in the most recent gap */
+	uint32_t LastGapSamples;
+
+}StreamStats;
+
 /** @brief Struct to store the current data stream state information */
 typedef struct StreamState
 {
@@ -241,11 +381,204 @@ typedef struct StreamState
 	/** Number of bytes per USB packet in generic data stream mode */
 	uint16_t BytesPerUsbPacket;
 
+	/** Stall time between SPI words in generic and transfer stream mode, in 10MHz timer ticks */
+	uint32_t StallTicks;
+
+	/** Track if the SPI block is set up for the next burst, so only the SPI enable is needed to start it (GPIO ISR or stream thread) */
+	volatile CyBool_t BurstArmed;
+
+	/** Track if the active stream waits for data ready using the GPIO ISR. Latched from FX3State at stream start */
+	CyBool_t DrInterruptWait;
+
+	/** Timer value sampled by the GPIO ISR on the most recent data ready edge */
+	volatile uint32_t DrEdgeTime;
+
+	/** Track if the active stream prefixes each sample with a time stamp. Latched from FX3State at stream start */
+	CyBool_t TimestampsEnabled;
+
+	/** Track if the stall timer runs free (threshold moved after each word) instead of being reset to 0 */
+	CyBool_t TimerFreeRun;
+
+	/** Number of 32-bit timer rollovers seen by the active stream (upper word of the 64-bit time stamps) */
+	uint32_t TimestampRollovers;
+
+	/** Timer value of the previous time stamp, used to detect timer rollover */
+	uint32_t LastTimestamp;
+
+	/** Track if the active stream places a frame header at the start of each USB buffer. Latched from FX3State at stream start */
+	CyBool_t FramingEnabled;
+
+	/** Track if the frame headers for the active stream carry a CRC32 of the frame payload */
+	CyBool_t FrameCrcEnabled;
+
+	/** Track if an otherwise automatic DMA stream is received to CPU memory and copied to the USB buffers (time stamps or framing) */
+	CyBool_t RxCopyMode;
+
+	/** Track if the stream data goes straight from the peripheral to USB, without the stream thread handling the USB buffers */
+	CyBool_t UsbAutoDma;
+
+	/** Track if data ready edges which arrive while a sample is processed are checked for */
+	CyBool_t DrMissCheck;
+
+	/** Number of bytes reserved for the frame header at the start of each USB buffer (0 when framing is disabled) */
+	uint16_t FrameHeaderBytes;
+
+	/** Size of each streaming DMA buffer filled by the CPU, in bytes */
+	uint16_t UsbBufferBytes;
+
+	/** Track if CPU filled streaming DMA buffers are committed with only their valid bytes (multi packet buffers) */
+	CyBool_t ExactCommits;
+
+	/** Overflow policy for the active stream (ADI_STREAM_OVERFLOW_*) */
+	uint16_t OverflowPolicy;
+
+	/** Track if the stream thread is filling the discard buffer instead of a USB buffer (drop newest policy) */
+	CyBool_t Discarding;
+
+	/** Buffer filled while samples are dropped by the drop newest overflow policy */
+	uint8_t *DiscardBuffer;
+
+	/** Number of samples started before the last USB buffer commit (or discard) */
+	uint32_t SamplesAtCommit;
+
+	/** Number of USB buffers committed to the streaming channel since it was last reset */
+	uint32_t CommitCount;
+
+	/** Number of bytes committed to the streaming channel since it was last reset */
+	uint32_t CommitBytesTotal;
+
+	/** Streaming channel byte count at the end of each recent USB buffer, indexed by commit count */
+	uint32_t CommitEndBytes[ADI_STREAM_COMMIT_HISTORY];
+
+	/** Index of the first sample started in each recent USB buffer, indexed by commit count */
+	uint32_t CommitStartSample[ADI_STREAM_COMMIT_HISTORY];
+
+	/** Track if the stream is storing samples in the capture ring instead of sending them to the PC */
+	CyBool_t CaptureActive;
+
+	/** Track if the capture trigger has fired */
+	CyBool_t CaptureTriggered;
+
+	/** Track if the capture has stored all of its post trigger samples */
+	CyBool_t CaptureDone;
+
+	/** Set by ADI_CAPTURE_TRIGGER_CMD to fire the capture trigger from the PC */
+	volatile CyBool_t CaptureHostTrigger;
+
+	/** Set by the GPIO ISR when the capture trigger pin edge arrives during an interrupt driven stream */
+	volatile CyBool_t CaptureEdgeSeen;
+
+	/** Capture ring buffer, holding CaptureSlots samples of BytesPerBuffer bytes. Owned by the ADI_STREAM_DMA_CAPTURE pool entry */
+	uint8_t *CaptureRing;
+
+	/** Status of the last capture set up. A stream whose capture could not be set up is not started */
+	CyU3PReturnStatus_t CaptureError;
+
+	/** Number of samples the capture ring holds */
+	uint32_t CaptureSlots;
+
+	/** Next capture ring slot to fill */
+	uint32_t CaptureWriteSlot;
+
+	/** Number of samples stored in the capture ring since the stream started */
+	uint32_t CaptureStored;
+
+	/** Number of samples stored from the trigger sample on */
+	uint32_t CapturePostStored;
+
+	/** Index of the trigger sample (number of samples stored before it) */
+	uint32_t CaptureTriggerSample;
+
+	/** Threshold word of the previous sample, for crossing detection */
+	int32_t CaptureLastValue;
+
+	/** Track if CaptureLastValue holds a sample word */
+	CyBool_t CaptureHaveLast;
+
+	/** FX3 GPIO bit mask of the pins sampled by the logic analyzer stream */
+	uint32_t LogicPinMask;
+
+	/** Logic analyzer sample period, in 10MHz timer ticks */
+	uint32_t LogicPeriodTicks;
+
+	/** Timer value the next logic analyzer sample is due at */
+	uint32_t LogicNextSample;
+
+	/** Pin state of the logic analyzer run being counted */
+	uint32_t LogicState;
+
+	/** Number of samples in the logic analyzer run being counted */
+	uint32_t LogicRunLength;
+
+	/** OS time (ms) the current logic analyzer USB buffer was started */
+	uint32_t LogicBufferTime;
+
+	/** Stream type reported in the frame headers (ADI_STREAM_FRAME_TYPE_*) */
+	uint8_t FrameStreamType;
+
+	/** Flags for the frame currently being filled (ADI_STREAM_FRAME_FLAG_*) */
+	uint8_t FrameFlags;
+
+	/** Number of samples (data ready edges) started in the frame currently being filled */
+	uint16_t FrameSamples;
+
+	/** Sequence number of the frame currently being filled. Starts at 0 for each stream */
+	uint32_t FrameSequence;
+
+	/** Runtime counters for the active (or last) stream */
+	StreamStats Stats;
+
+	/** Number of data ready edge to first SCLK latency samples recorded for the active stream */
+	uint32_t DrLatencyCount;
+
+	/** Smallest data ready edge to first SCLK latency, in 10MHz timer ticks */
+	uint32_t DrLatencyMin;
+
+	/** Largest data ready edge to first SCLK latency, in 10MHz timer ticks */
+	uint32_t DrLatencyMax;
+
+	/** Sum of all data ready edge to first SCLK latency samples, in 10MHz timer ticks */
+	uint64_t DrLatencyTotal;
+
 	/** Preamble for I2C stream */
 	CyU3PI2cPreamble_t I2CStreamPreamble;
 
 }StreamState;
 
+/** @brief Vendor command queued for the command worker thread (one CommandQueue message) */
+typedef struct CommandRequest
+{
+	/** Vendor request code (bRequest) */
+	uint32_t Request;
+
+	/** Setup packet value (low 16 bits) and index (high 16 bits) */
+	uint32_t ValueIndex;
+
+	/** Number of request data bytes read from the control endpoint */
+	uint32_t Length;
+
+	/** Request data. Allocated when the command is queued, and freed once it has run */
+	uint8_t *Args;
+
+}CommandRequest;
+
+/** @brief Struct to store the command worker thread state */
+typedef struct CommandState
+{
+	/** Vendor request code of the running command (0 when idle) */
+	volatile uint32_t Running;
+
+	/** Number of commands queued since boot (only written by the control endpoint handler) */
+	volatile uint32_t Queued;
+
+	/** Number of commands run since boot (only written by the command worker thread) */
+	volatile uint32_t Completed;
+
+	/** Set by ADI_COMMAND_CONTROL to make the running command stop early */
+	volatile CyBool_t Cancel;
+
+}CommandState;
+
 /*
  * Vendor Command Request Code Definitions
  */
@@ -298,12 +631,30 @@ typedef struct StreamState
 /** Get the type of the programmed board */
 #define ADI_GET_BOARD_TYPE						(0xBA)
 
+/** Return the stream profile counters (STREAM_PROFILE_MODE builds only) */
+#define ADI_GET_STREAM_PROFILE					(0xBB)
+
+/** Return the data ready edge to first SCLK latency of the last interrupt driven stream */
+#define ADI_GET_DR_LATENCY						(0xBC)
+
+/** Return the runtime counters for the active or last stream */
+#define ADI_GET_STREAM_STATS					(0xBD)
+
+/** Run an SPI register script on the FX3, returning the results on the bulk endpoint */
+#define ADI_RUN_SPI_SCRIPT						(0xBE)
+
+/** Read a list of registers with full duplex SPI transfers, returning the data on the bulk endpoint */
+#define ADI_READ_REG_LIST						(0xBF)
+
 /** Start/stop a generic data stream */
 #define ADI_STREAM_GENERIC_DATA					(0xC0)
 
 /** Start/stop a burst data stream */
 #define ADI_STREAM_BURST_DATA					(0xC1)
 
+/** Start/stop the SPI pipe (bulk endpoint 0x01 to SPI to streaming endpoint, by DMA) */
+#define ADI_SPI_PIPE							(0xC2)
+
 /** Read the value of a user-specified GPIO */
 #define ADI_READ_PIN							(0xC3)
 
@@ -334,6 +685,27 @@ typedef struct StreamState
 /** Set GPIO resistor pull up or pull down */
 #define ADI_SET_PIN_RESISTOR					(0xD2)
 
+/** Configure, trigger or query the pre-trigger capture for burst and generic streams */
+#define ADI_TRIGGER_CAPTURE						(0xD3)
+
+/** Start, finish or cancel a logic analyzer stream of the iSensor and FX3 GPIO pins */
+#define ADI_LOGIC_ANALYZER_STREAM				(0xD4)
+
+/** Record the period between every edge on a user-specified pin, with jitter statistics and a histogram */
+#define ADI_MEASURE_DR_PERIODS					(0xD5)
+
+/** Query the command worker thread, or cancel the running command (wValue ADI_COMMAND_*) */
+#define ADI_COMMAND_CONTROL						(0xD6)
+
+/** Read (and optionally clear) the event trace ring. Only supported in TRACE_MODE builds */
+#define ADI_READ_TRACE							(0xD7)
+
+/** Read the most recent deferred debug log messages */
+#define ADI_READ_DEBUG_LOG						(0xD8)
+
+/** Get the CPU load and the run time of each thread. Only supported in CPU_LOAD_MODE builds */
+#define ADI_GET_CPU_LOAD						(0xD9)
+
 /** Read a word at a specified address and return the data over the control endpoint */
 #define ADI_READ_BYTES							(0xF0)
 
@@ -377,6 +749,9 @@ typedef struct StreamState
 /** Offset to take away from the timer period for generic stream stall time. In 10MHz timer ticks */
 #define ADI_GENERIC_STALL_OFFSET				(52)
 
+/** Minimum number of timer ticks between moving the stall timer threshold and the threshold being reached */
+#define ADI_TIMER_REARM_MARGIN					(5)
+
 /** Minimum possible sleep time  */
 #define ADI_MICROSECONDS_SLEEP_OFFSET			(14)
 
@@ -396,7 +771,7 @@ typedef struct StreamState
 /** BULK-IN endpoint (general data from FX3 to PC) */
 #define ADI_TO_PC_ENDPOINT						(0x82)
 
-/** Burst size for SS operation only */
+/** Streaming endpoint burst size (packets) for SS operation only */
 #define CY_FX_BULK_BURST               			(8)
 
 /*